@@ -12,6 +12,9 @@
  */
 #include "postgres.h"
 
+#include "cdb/cdbdisp.h"
+#include "cdb/cdbexplain.h"
+#include "cdb/cdbvars.h"
 #include "commands/explain.h"
 #include "executor/instrument.h"
 #include "utils/guc.h"
@@ -25,6 +28,7 @@ static bool auto_explain_log_verbose = false;
 static bool auto_explain_log_buffers = false;
 static int	auto_explain_log_format = EXPLAIN_FORMAT_TEXT;
 static bool auto_explain_log_nested_statements = false;
+static double auto_explain_sample_rate = 1.0;
 
 static const struct config_enum_entry format_options[] = {
 	{"text", EXPLAIN_FORMAT_TEXT, false},
@@ -37,6 +41,9 @@ static const struct config_enum_entry format_options[] = {
 /* Current nesting depth of ExecutorRun calls */
 static int	nesting_level = 0;
 
+/* Is the current top-level query to be sampled? */
+static bool current_query_sampled = true;
+
 /* Saved hook values in case of unload */
 static ExecutorStart_hook_type prev_ExecutorStart = NULL;
 static ExecutorRun_hook_type prev_ExecutorRun = NULL;
@@ -44,7 +51,8 @@ static ExecutorEnd_hook_type prev_ExecutorEnd = NULL;
 
 #define auto_explain_enabled() \
 	(auto_explain_log_min_duration >= 0 && \
-	 (nesting_level == 0 || auto_explain_log_nested_statements))
+	 (nesting_level == 0 || auto_explain_log_nested_statements) && \
+	 current_query_sampled)
 
 void		_PG_init(void);
 void		_PG_fini(void);
@@ -125,6 +133,18 @@ _PG_init(void)
 							 NULL,
 							 NULL);
 
+	DefineCustomRealVariable("auto_explain.sample_rate",
+							 "Fraction of queries to process.",
+							 NULL,
+							 &auto_explain_sample_rate,
+							 1.0,
+							 0.0,
+							 1.0,
+							 PGC_SUSET,
+							 0,
+							 NULL,
+							 NULL);
+
 	EmitWarningsOnPlaceholders("auto_explain");
 
 	/* Install hooks. */
@@ -154,6 +174,14 @@ _PG_fini(void)
 static void
 explain_ExecutorStart(QueryDesc *queryDesc, int eflags)
 {
+	/*
+	 * For ratelimiting, randomly choose top-level statement to log.  This
+	 * happens only once per statement, at its outermost invocation.
+	 */
+	if (nesting_level == 0)
+		current_query_sampled = (random() < auto_explain_sample_rate *
+								 MAX_RANDOM_VALUE);
+
 	if (auto_explain_enabled())
 	{
 		/* Enable per-node instrumentation iff log_analyze is required. */
@@ -162,6 +190,25 @@ explain_ExecutorStart(QueryDesc *queryDesc, int eflags)
 			queryDesc->instrument_options |= INSTRUMENT_TIMER;
 			if (auto_explain_log_buffers)
 				queryDesc->instrument_options |= INSTRUMENT_BUFFERS;
+
+			/*
+			 * On the dispatcher, also have the qExecs collect and ship back
+			 * their node stats, and set up the workarea that receives them,
+			 * the same way EXPLAIN ANALYZE does.
+			 */
+			if (Gp_role == GP_ROLE_DISPATCH)
+			{
+				instr_time	starttime;
+
+				queryDesc->instrument_options |= INSTRUMENT_CDB;
+
+				if (queryDesc->showstatctx == NULL)
+				{
+					INSTR_TIME_SET_CURRENT(starttime);
+					queryDesc->showstatctx =
+						cdbexplain_showExecStatsBegin(queryDesc, starttime);
+				}
+			}
 		}
 	}
 
@@ -239,9 +286,29 @@ explain_ExecutorEnd(QueryDesc *queryDesc)
 			es.buffers = (es.analyze && auto_explain_log_buffers);
 			es.format = auto_explain_log_format;
 
+			/*
+			 * Wait for the qExecs to finish, so that their stats can be
+			 * pulled into the PlanState tree by ExplainPrintPlan.  (EXPLAIN
+			 * ANALYZE does the same after running the plan; in our case the
+			 * plan has already been run to completion.)
+			 */
+			if (es.analyze && Gp_role == GP_ROLE_DISPATCH &&
+				queryDesc->estate->dispatcherState &&
+				queryDesc->estate->dispatcherState->primaryResults)
+				CdbCheckDispatchResult(queryDesc->estate->dispatcherState,
+									   DISPATCH_WAIT_NONE);
+
 			ExplainBeginOutput(&es);
 			ExplainQueryText(&es, queryDesc);
 			ExplainPrintPlan(&es, queryDesc);
+
+			/* On the dispatcher, append the per-slice statistics */
+			if (es.analyze && Gp_role == GP_ROLE_DISPATCH &&
+				queryDesc->showstatctx != NULL)
+				cdbexplain_showExecStatsEnd(queryDesc->plannedstmt,
+											queryDesc->showstatctx,
+											queryDesc->estate, &es);
+
 			ExplainEndOutput(&es);
 
 			/* Remove last line break */
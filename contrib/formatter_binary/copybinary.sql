@@ -0,0 +1,11 @@
+------------------------------------------------------------------
+-- COPY BINARY Formatters
+------------------------------------------------------------------
+
+CREATE OR REPLACE FUNCTION copybinary_in() RETURNS record
+AS '$libdir/copybinary.so', 'copybinary_in'
+LANGUAGE C STABLE;
+
+CREATE OR REPLACE FUNCTION copybinary_out(record) RETURNS bytea
+AS '$libdir/copybinary.so', 'copybinary_out'
+LANGUAGE C STABLE;
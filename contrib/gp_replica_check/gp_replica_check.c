@@ -340,7 +340,21 @@ retry:
 	 *
 	 * Note: if this is not the first attempt, we keep the block number across attempts,
 	 * rather than always starting from the beginning of the file.
+	 *
+	 * Seek to the resume position once, here; the reads below advance both
+	 * files in lockstep so there is no need to reposition on every block.
 	 */
+	if (FileSeek(primaryFile, (int64) blockno * BLCKSZ, SEEK_SET) < 0)
+	{
+		elog(NOTICE, "seek in file \"%s\" failed: %m", primaryfilepath);
+		goto retry;
+	}
+	if (FileSeek(mirrorFile, (int64) blockno * BLCKSZ, SEEK_SET) < 0)
+	{
+		elog(NOTICE, "seek in file \"%s\" failed: %m", mirrorfilepath);
+		goto retry;
+	}
+
 	while (true)
 	{
 		char		primaryFileBuf[BLCKSZ];
@@ -351,17 +365,6 @@ retry:
 
 		CHECK_FOR_INTERRUPTS();
 
-		if (FileSeek(primaryFile, (int64) blockno * BLCKSZ, SEEK_SET) < 0)
-		{
-			elog(NOTICE, "seek in file \"%s\" failed: %m", primaryfilepath);
-			goto retry;
-		}
-		if (FileSeek(mirrorFile, (int64) blockno * BLCKSZ, SEEK_SET) < 0)
-		{
-			elog(NOTICE, "seek in file \"%s\" failed: %m", mirrorFileBuf);
-			goto retry;
-		}
-
 		primaryFileBytesRead = FileRead(primaryFile, primaryFileBuf, sizeof(primaryFileBuf));
 		if (primaryFileBytesRead < 0)
 		{
@@ -26,6 +26,7 @@ gp_replica_check.py
 gp_replica_check.py -d "mydb1,mydb2,..."
 gp_replica_check.py -r "heap,ao,btree,..."
 gp_replica_check.py -d "mydb1,mydb2,..." -r "hash,bitmap,gist,..."
+gp_replica_check.py -w 16
 '''
 
 import argparse
@@ -35,8 +36,9 @@ import threading
 import Queue
 
 class ReplicaCheck(threading.Thread):
-    def __init__(self, segrow, datname, relation_types):
+    def __init__(self, segrow, datname, relation_types, pool_sema):
         super(ReplicaCheck, self).__init__()
+        self.pool_sema = pool_sema
         self.host = segrow[0]
         self.port = segrow[1]
         self.content = segrow[2]
@@ -54,21 +56,25 @@ Mirror Data Directory Location: %s' % (self.host, self.port, self.datname,
                                           self.ploc, self.mloc)
 
     def run(self):
-        print(self)
-        cmd = '''PGOPTIONS='-c gp_session_role=utility' psql -h %s -p %s -c "select * from gp_replica_check('%s', '%s', '%s')" %s''' % (self.host, self.port,
-                                                                                                                                        self.ploc, self.mloc,
-                                                                                                                                        self.relation_types,
-                                                                                                                                        self.datname)
-
-        if self.primary_status.strip() == 'd':
-            print "Primary segment for content %d is down" % self.content
-        else:
-            try:
-                res = subprocess.check_output(cmd, stderr=subprocess.STDOUT, shell=True)
-                print res
-                self.result = True if res.strip().split('\n')[-2].strip() == 't' else False
-            except subprocess.CalledProcessError, e:
-                print 'returncode: (%s), cmd: (%s), output: (%s)' % (e.returncode, e.cmd, e.output)
+        self.pool_sema.acquire()
+        try:
+            print(self)
+            cmd = '''PGOPTIONS='-c gp_session_role=utility' psql -h %s -p %s -c "select * from gp_replica_check('%s', '%s', '%s')" %s''' % (self.host, self.port,
+                                                                                                                                            self.ploc, self.mloc,
+                                                                                                                                            self.relation_types,
+                                                                                                                                            self.datname)
+
+            if self.primary_status.strip() == 'd':
+                print "Primary segment for content %d is down" % self.content
+            else:
+                try:
+                    res = subprocess.check_output(cmd, stderr=subprocess.STDOUT, shell=True)
+                    print res
+                    self.result = True if res.strip().split('\n')[-2].strip() == 't' else False
+                except subprocess.CalledProcessError, e:
+                    print 'returncode: (%s), cmd: (%s), output: (%s)' % (e.returncode, e.cmd, e.output)
+        finally:
+            self.pool_sema.release()
 
 def install_extension(databases):
     get_datname_sql = ''' SELECT datname FROM pg_database WHERE datname != 'template0' '''
@@ -122,15 +128,22 @@ SELECT datname FROM pg_catalog.pg_database WHERE datname != 'template0'
 
     return dblist
 
-def start_verification(segmap, dblist, relation_types):
+def start_verification(segmap, dblist, relation_types, max_workers):
+    # The checks are independent of each other, so run them through a
+    # bounded worker pool instead of one at a time. The semaphore caps the
+    # number of concurrent backend sessions; every (segment pair, database)
+    # combination gets its own worker slot.
+    pool_sema = threading.Semaphore(max_workers)
     replica_check_list = []
     for content, seglist in segmap.items():
         for segrow in seglist:
             for dbname in dblist:
-                replica_check = ReplicaCheck(segrow, dbname, relation_types)
+                replica_check = ReplicaCheck(segrow, dbname, relation_types, pool_sema)
                 replica_check_list.append(replica_check)
                 replica_check.start()
-                replica_check.join()
+
+    for replica_check in replica_check_list:
+        replica_check.join()
 
     for replica_check in replica_check_list:
         if not replica_check.result:
@@ -145,11 +158,18 @@ def defargs():
                         help='Database names to run replication check on')
     parser.add_argument('--relation-types', '-r', type=str, required=False, default='all',
                         help='Relation types to run replication check on')
+    parser.add_argument('--max-workers', '-w', type=int, required=False, default=8,
+                        help='Maximum number of concurrent check sessions')
 
     return parser.parse_args()
 
 if __name__ == '__main__':
     args = defargs()
 
+    if args.max_workers < 1:
+        print "invalid --max-workers value: %d" % args.max_workers
+        sys.exit(1)
+
     install_extension(args.databases)
-    start_verification(get_segments(), get_databases(args.databases), args.relation_types)
+    start_verification(get_segments(), get_databases(args.databases), args.relation_types,
+                       args.max_workers)
@@ -13,6 +13,8 @@
 #include "gpopt/utils/CCatalogUtils.h"
 #include "gpopt/utils/COptTasks.h"
 #include "gpopt/mdcache/CMDCache.h"
+#include "lib/stringinfo.h"
+#include "portability/instr_time.h"
 #include "utils/guc.h"
 #include "utils/snapmgr.h"
 
@@ -84,6 +86,10 @@ Datum Optimize(PG_FUNCTION_ARGS);
 
 PG_FUNCTION_INFO_V1(Optimize);
 
+Datum BenchmarkQuery(PG_FUNCTION_ARGS);
+
+PG_FUNCTION_INFO_V1(BenchmarkQuery);
+
 Datum EvalExprFromDXLFile(PG_FUNCTION_ARGS);
 Datum OptimizeMinidumpFromFile(PG_FUNCTION_ARGS);
 Datum ExecuteMinidumpFromFile(PG_FUNCTION_ARGS);
@@ -1069,3 +1075,102 @@ Optimize(PG_FUNCTION_ARGS)
 	PG_RETURN_TEXT_P(cstring_to_text(szOutput));
 }
 }
+
+//---------------------------------------------------------------------------
+//	@function:
+//		BenchmarkQuery
+//
+//	@doc:
+//		Plan the given query repeatedly with both the Postgres planner and
+//		ORCA and return a report with the optimization latency and resulting
+//		plan cost of each. The query is re-parsed before every run so each
+//		planner sees a pristine query tree, and parsing is excluded from the
+//		measured time. Run with different optimizer_* GUC settings to compare
+//		ORCA configurations; note that if ORCA falls back, the orca line
+//		reflects the fallback plan (check the log).
+//
+//---------------------------------------------------------------------------
+
+extern "C" {
+Datum
+BenchmarkQuery(PG_FUNCTION_ARGS)
+{
+	char *szSqlText = text_to_cstring(PG_GETARG_TEXT_P(0));
+	int iIterations = PG_GETARG_INT32(1);
+
+	if (0 >= iIterations)
+	{
+		elog(ERROR, "number of iterations must be positive");
+	}
+
+	bool fOptimizerSaved = optimizer;
+	StringInfoData report;
+	initStringInfo(&report);
+
+	PG_TRY();
+	{
+		for (int iUseOrca = 0; iUseOrca <= 1; iUseOrca++)
+		{
+			double dMinMs = 0.0;
+			double dTotalMs = 0.0;
+			double dCost = 0.0;
+
+			optimizer = (1 == iUseOrca);
+
+			for (int i = 0; i < iIterations; i++)
+			{
+				instr_time start;
+				instr_time duration;
+
+				List *plQueryTree = pg_parse_and_rewrite(szSqlText, NULL, 0);
+
+				if (1 != gpdb::UlListLength(plQueryTree))
+				{
+					elog(ERROR, "problem parsing query %s", szSqlText);
+				}
+
+				Query *pquery = (Query *) lfirst(gpdb::PlcListHead(plQueryTree));
+
+				INSTR_TIME_SET_CURRENT(start);
+				PlannedStmt *pplstmt = pg_plan_query(pquery, NULL);
+				INSTR_TIME_SET_CURRENT(duration);
+				INSTR_TIME_SUBTRACT(duration, start);
+
+				if (!pplstmt)
+				{
+					elog(ERROR, "problem planning query %s", szSqlText);
+				}
+
+				double dMs = INSTR_TIME_GET_MILLISEC(duration);
+				dTotalMs += dMs;
+				if (0 == i || dMs < dMinMs)
+				{
+					dMinMs = dMs;
+				}
+				dCost = pplstmt->planTree->total_cost;
+			}
+
+			appendStringInfo
+				(
+				&report,
+				"%s: min %.3f ms, avg %.3f ms over %d runs, plan cost %.2f\n",
+				(1 == iUseOrca) ? "orca" : "planner",
+				dMinMs,
+				dTotalMs / iIterations,
+				iIterations,
+				dCost
+				);
+		}
+	}
+	PG_CATCH();
+	{
+		optimizer = fOptimizerSaved;
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+
+	optimizer = fOptimizerSaved;
+
+	PG_RETURN_TEXT_P(cstring_to_text(report.data));
+}
+}
@@ -13,6 +13,7 @@ drop function gpoptutils.DumpQueryFromFileToDXLFile(text, text);
 --drop function gpoptutils.RestoreQueryDXL(text);
 --drop function gpoptutils.RestoreQueryFromDXLFile(text);
 drop function gpoptutils.Optimize(text);
+drop function gpoptutils.BenchmarkQuery(text, int);
 drop function gpoptutils.DumpMDObjDXL(Oid);
 drop function gpoptutils.DumpCatalogDXL(text);
 drop function gpoptutils.DumpRelStatsDXL(Oid);
@@ -38,6 +38,7 @@
 #include "portability/instr_time.h"
 
 #include <ctype.h>
+#include <math.h>
 
 #ifndef WIN32
 #include <sys/time.h>
@@ -228,14 +229,24 @@ static Command **sql_files[MAX_FILES];	/* SQL script files */
 static int	num_files;			/* number of script files */
 static int	debug = 0;			/* debug flag */
 
+/*
+ * Skew factor for \setrandom variables tagged "key" (-k).  1.0 keeps the
+ * uniform distribution; larger values concentrate key values, and hence
+ * Greenplum segments, toward the low end of the range.
+ */
+static double skew_factor = 1.0;
+
+/* print a per-segment dispatch latency breakdown at the end (-G)? */
+static bool report_per_segment = false;
+
 /* default scenario */
 static char *tpc_b = {
 	"\\set nbranches " CppAsString2(nbranches) " * :scale\n"
 	"\\set ntellers " CppAsString2(ntellers) " * :scale\n"
 	"\\set naccounts " CppAsString2(naccounts) " * :scale\n"
-	"\\setrandom aid 1 :naccounts\n"
-	"\\setrandom bid 1 :nbranches\n"
-	"\\setrandom tid 1 :ntellers\n"
+	"\\setrandom aid 1 :naccounts key\n"
+	"\\setrandom bid 1 :nbranches key\n"
+	"\\setrandom tid 1 :ntellers key\n"
 	"\\setrandom delta -5000 5000\n"
 	"BEGIN;\n"
 	"UPDATE pgbench_accounts SET abalance = abalance + :delta WHERE aid = :aid;\n"
@@ -251,9 +262,9 @@ static char *simple_update = {
 	"\\set nbranches " CppAsString2(nbranches) " * :scale\n"
 	"\\set ntellers " CppAsString2(ntellers) " * :scale\n"
 	"\\set naccounts " CppAsString2(naccounts) " * :scale\n"
-	"\\setrandom aid 1 :naccounts\n"
-	"\\setrandom bid 1 :nbranches\n"
-	"\\setrandom tid 1 :ntellers\n"
+	"\\setrandom aid 1 :naccounts key\n"
+	"\\setrandom bid 1 :nbranches key\n"
+	"\\setrandom tid 1 :ntellers key\n"
 	"\\setrandom delta -5000 5000\n"
 	"BEGIN;\n"
 	"UPDATE pgbench_accounts SET abalance = abalance + :delta WHERE aid = :aid;\n"
@@ -265,10 +276,39 @@ static char *simple_update = {
 /* -S case */
 static char *select_only = {
 	"\\set naccounts " CppAsString2(naccounts) " * :scale\n"
-	"\\setrandom aid 1 :naccounts\n"
+	"\\setrandom aid 1 :naccounts key\n"
 	"SELECT abalance FROM pgbench_accounts WHERE aid = :aid;\n"
 };
 
+/*
+ * -J case: joins on non-distribution keys, so every transaction moves
+ * tuples between segments (pgbench_history is distributed by tid and is
+ * redistributed to join on aid; pgbench_tellers likewise to join on bid).
+ */
+static char *motion_join = {
+	"\\set nbranches " CppAsString2(nbranches) " * :scale\n"
+	"\\set naccounts " CppAsString2(naccounts) " * :scale\n"
+	"\\setrandom bid 1 :nbranches key\n"
+	"\\setrandom aid 1 :naccounts key\n"
+	"SELECT count(*) FROM pgbench_accounts a JOIN pgbench_history h USING (aid) WHERE a.bid = :bid;\n"
+	"SELECT sum(t.tbalance) FROM pgbench_tellers t JOIN pgbench_branches b USING (bid) WHERE b.bid = :bid;\n"
+};
+
+/*
+ * -I mix-in: insert-only load on pgbench_history, run alongside the other
+ * scripts to combine concurrent load and queries in one run.
+ */
+static char *insert_only = {
+	"\\set nbranches " CppAsString2(nbranches) " * :scale\n"
+	"\\set ntellers " CppAsString2(ntellers) " * :scale\n"
+	"\\set naccounts " CppAsString2(naccounts) " * :scale\n"
+	"\\setrandom aid 1 :naccounts key\n"
+	"\\setrandom bid 1 :nbranches key\n"
+	"\\setrandom tid 1 :ntellers key\n"
+	"\\setrandom delta -5000 5000\n"
+	"INSERT INTO pgbench_history (tid, bid, aid, delta, mtime) VALUES (:tid, :bid, :aid, :delta, CURRENT_TIMESTAMP);\n"
+};
+
 /* Function prototypes */
 static void setalarm(int seconds);
 static void *threadRun(void *arg);
@@ -291,7 +331,11 @@ usage(const char *progname)
 		   "  -D VARNAME=VALUE\n"
 		   "               define variable for use by custom script\n"
 		   "  -f FILENAME  read transaction script from FILENAME\n"
+		   "  -G           print per-segment dispatch latency breakdown (Greenplum)\n"
+		   "  -I           mix in insert-only load on pgbench_history\n"
+		   "  -J           perform motion-heavy join transactions (Greenplum)\n"
 		   "  -j NUM       number of threads (default: 1)\n"
+		   "  -k NUM       skew factor for distribution-key values (default: 1 = uniform)\n"
 		   "  -l           write transaction times to log file\n"
 		   "  -M {simple|extended|prepared}\n"
 		   "               protocol for submitting queries to server (default: simple)\n"
@@ -325,6 +369,19 @@ getrand(int min, int max)
 	return min + (int) (((max - min + 1) * (double) random()) / (MAX_RANDOM_VALUE + 1.0));
 }
 
+/*
+ * random number generator: power-law distribution from min to max
+ * inclusive, concentrated toward min as skew_factor grows.  A factor of
+ * 1.0 is the uniform distribution.
+ */
+static int
+getskewedrand(int min, int max)
+{
+	double		uniform = (double) random() / (MAX_RANDOM_VALUE + 1.0);
+
+	return min + (int) ((max - min + 1) * pow(uniform, skew_factor));
+}
+
 /* call PQexec() and exit() on failure */
 static void
 executeStatement(PGconn *con, const char *sql)
@@ -1010,7 +1067,12 @@ top:
 #ifdef DEBUG
 			printf("min: %d max: %d random: %d\n", min, max, getrand(min, max));
 #endif
-			snprintf(res, sizeof(res), "%d", getrand(min, max));
+			/* a trailing "key" tag marks the variable as subject to -k skew */
+			if (argc >= 5 && pg_strcasecmp(argv[4], "key") == 0 &&
+				skew_factor > 1.0)
+				snprintf(res, sizeof(res), "%d", getskewedrand(min, max));
+			else
+				snprintf(res, sizeof(res), "%d", getrand(min, max));
 
 			if (!putVariable(st, argv[0], argv[1], res))
 			{
@@ -1440,7 +1502,10 @@ process_commands(char *buf)
 				return NULL;
 			}
 
-			for (j = 4; j < my_commands->argc; j++)
+			/* argv[4] may be the "key" tag marking a distribution key */
+			j = (my_commands->argc >= 5 &&
+				 pg_strcasecmp(my_commands->argv[4], "key") == 0) ? 5 : 4;
+			for (; j < my_commands->argc; j++)
 				fprintf(stderr, "%s: extra argument \"%s\" ignored\n",
 						my_commands->argv[0], my_commands->argv[j]);
 		}
@@ -1684,6 +1749,49 @@ process_builtin(char *tb)
 	return my_commands;
 }
 
+/*
+ * Print a per-segment latency breakdown from the server's dispatch
+ * statistics (-G).  Shows, for each segment, how often it was the last
+ * responder across the benchmark's sessions and the accumulated time
+ * spent waiting on it.  Requires a server that provides
+ * gp_dispatch_stats(); called while the client sessions still exist.
+ */
+static void
+printPerSegmentReport(void)
+{
+	PGconn	   *con;
+	PGresult   *res;
+	int			i;
+
+	if ((con = doConnect()) == NULL)
+		return;
+
+	res = PQexec(con,
+				 "SELECT straggler_content, count(*), sum(straggler_us) "
+				 "FROM gp_dispatch_stats() "
+				 "WHERE straggler_content >= 0 "
+				 "GROUP BY straggler_content "
+				 "ORDER BY sum(straggler_us) DESC");
+	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	{
+		fprintf(stderr, "per-segment report not available: %s",
+				PQerrorMessage(con));
+	}
+	else
+	{
+		printf("per-segment dispatch latency breakdown (slowest responder):\n");
+		if (PQntuples(res) == 0)
+			printf("  no dispatch straggler samples recorded\n");
+		for (i = 0; i < PQntuples(res); i++)
+			printf("  segment %s: straggler for %s session(s), %s us accumulated wait\n",
+				   PQgetvalue(res, i, 0),
+				   PQgetvalue(res, i, 1),
+				   PQgetvalue(res, i, 2));
+	}
+	PQclear(res);
+	PQfinish(con);
+}
+
 /* print out results */
 static void
 printResults(int ttype, int normal_xacts, int nclients, int nthreads,
@@ -1705,6 +1813,8 @@ printResults(int ttype, int normal_xacts, int nclients, int nthreads,
 		s = "Update only pgbench_accounts";
 	else if (ttype == 1)
 		s = "SELECT only";
+	else if (ttype == 4)
+		s = "MPP motion join";
 	else
 		s = "Custom query";
 
@@ -1727,6 +1837,8 @@ printResults(int ttype, int normal_xacts, int nclients, int nthreads,
 	}
 	printf("tps = %f (including connections establishing)\n", tps_include);
 	printf("tps = %f (excluding connections establishing)\n", tps_exclude);
+	if (skew_factor > 1.0)
+		printf("key skew factor: %g\n", skew_factor);
 }
 
 
@@ -1743,6 +1855,7 @@ main(int argc, char **argv)
 								 * 2: skip update of branches and tellers */
 	char	   *filename = NULL;
 	bool		scale_given = false;
+	bool		add_insert_mix = false; /* mix in the -I load script? */
 
 	CState	   *state;			/* status of clients */
 	TState	   *threads;		/* array of thread */
@@ -1803,7 +1916,7 @@ main(int argc, char **argv)
 
 	memset(state, 0, sizeof(*state));
 
-	while ((c = getopt(argc, argv, "ih:nvp:dSNc:Cs:t:T:U:lf:D:F:M:j:x:q")) != -1)
+	while ((c = getopt(argc, argv, "ih:nvp:dSNJIGk:c:Cs:t:T:U:lf:D:F:M:j:x:q")) != -1)
 	{
 		switch (c)
 		{
@@ -1837,6 +1950,23 @@ main(int argc, char **argv)
 			case 'N':
 				ttype = 2;
 				break;
+			case 'J':
+				ttype = 4;
+				break;
+			case 'I':
+				add_insert_mix = true;
+				break;
+			case 'G':
+				report_per_segment = true;
+				break;
+			case 'k':
+				skew_factor = atof(optarg);
+				if (skew_factor < 1.0)
+				{
+					fprintf(stderr, "invalid skew factor: %s (must be >= 1.0)\n", optarg);
+					exit(1);
+				}
+				break;
 			case 'c':
 				nclients = atoi(optarg);
 				if (nclients <= 0 || nclients > MAXCLIENTS)
@@ -2126,10 +2256,27 @@ main(int argc, char **argv)
 			num_files = 1;
 			break;
 
+		case 4:
+			sql_files[0] = process_builtin(motion_join);
+			num_files = 1;
+			break;
+
 		default:
 			break;
 	}
 
+	/* mix in the insert-only load script alongside the selected scripts */
+	if (add_insert_mix)
+	{
+		if (num_files >= MAX_FILES)
+		{
+			fprintf(stderr, "at most %d SQL files are allowed\n", MAX_FILES);
+			exit(1);
+		}
+		sql_files[num_files] = process_builtin(insert_only);
+		num_files++;
+	}
+
 	/* get start up time */
 	INSTR_TIME_SET_CURRENT(start_time);
 
@@ -2184,6 +2331,10 @@ main(int argc, char **argv)
 			free(ret);
 		}
 	}
+	/* read the dispatch stats while the client sessions still exist */
+	if (report_per_segment)
+		printPerSegmentReport();
+
 	disconnect_all(state, nclients);
 
 	/* get end time */
@@ -0,0 +1,489 @@
+#include <sys/time.h>
+
+#include "gpcheckcloud.h"
+
+bool hasHeader;
+
+char eolString[EOL_CHARS_MAX_LEN + 1] = "\n";  // LF by default
+
+string s3extErrorMessage;
+
+volatile bool QueryCancelPending = false;
+
+static bool uploadS3(const char *urlWithOptions, const char *fileToUpload);
+static bool downloadS3(const char *urlWithOptions);
+static bool benchmarkS3(const char *urlWithOptions);
+static bool checkConfig(const char *urlWithOptions);
+static void printBucketContents(const ListBucketResult &result);
+static void printTemplate();
+static void validateCommandLineArgs(map<char, string> &optionPairs);
+static map<char, string> parseCommandLineArgs(int argc, char *argv[]);
+static void registerSignalHandler();
+static void printUsage(FILE *stream);
+
+// As we can't catch 'IsAbortInProgress()' in UT, so here consider QueryCancelPending only
+bool S3QueryIsAbortInProgress(void) {
+    return QueryCancelPending;
+}
+
+void MaskThreadSignals() {
+}
+
+void *S3Alloc(size_t size) {
+    return malloc(size);
+}
+
+void S3Free(void *p) {
+    free(p);
+}
+
+static void handleAbortSignal(int signum) {
+    fprintf(stderr, "Interrupted by user (%s), exiting...\n\n", strsignal(signum));
+    QueryCancelPending = true;
+}
+
+static void registerSignalHandler() {
+    signal(SIGHUP, handleAbortSignal);
+    signal(SIGABRT, handleAbortSignal);
+    signal(SIGTERM, handleAbortSignal);
+    signal(SIGINT, handleAbortSignal);
+    signal(SIGTSTP, handleAbortSignal);
+}
+
+static void printUsage(FILE *stream) {
+    fprintf(stream,
+            "Usage: gpcheckcloud -c \"s3://endpoint/bucket/prefix "
+            "config=path_to_config_file [region=region_name]\", to check the configuration.\n"
+            "       gpcheckcloud -d \"s3://endpoint/bucket/prefix "
+            "config=path_to_config_file [region=region_name]\", to download and output to stdout.\n"
+            "       gpcheckcloud -u \"/path/to/file\" \"s3://endpoint/bucket/prefix "
+            "config=path_to_config_file [region=region_name]\", to upload a file.\n"
+            "       gpcheckcloud -b \"s3://endpoint/bucket/prefix "
+            "config=path_to_config_file [region=region_name]\", to benchmark download "
+            "performance and recommend s3.conf settings.\n"
+            "       gpcheckcloud -t, to show the config template.\n"
+            "       gpcheckcloud -h, to show this help.\n");
+}
+
+// parse the arguments into char-string value pairs
+static map<char, string> parseCommandLineArgs(int argc, char *argv[]) {
+    int opt = 0;
+    map<char, string> optionPairs;
+
+    while ((opt = getopt(argc, argv, "c:d:u:b:ht")) != -1) {
+        switch (opt) {
+            case 'c':
+            case 'd':
+            case 'b':
+            case 'h':
+            case 't':
+                if (optarg == NULL) {
+                    optionPairs[opt] = "";
+                } else if (optarg[0] == '-') {
+                    fprintf(stderr, "Failed. Invalid argument for -%c: '%s'.\n\n", opt, optarg);
+                    printUsage(stderr);
+                    exit(EXIT_FAILURE);
+                } else {
+                    optionPairs[opt] = optarg;
+                }
+
+                break;
+            case 'u':
+                if (optarg == NULL) {
+                    optionPairs[opt] = "";
+                } else if (optind + 1 == argc) {      // has two option values
+                    optionPairs['f'] = optarg;        // value of option file
+                    optionPairs['u'] = argv[optind];  // value of option url
+                } else {
+                    fprintf(stderr, "Failed. Invalid arguments for -u, please check.\n\n");
+                    printUsage(stderr);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+
+            default:  // '?'
+                printUsage(stderr);
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    return optionPairs;
+}
+
+// check if command line arguments are valid
+static void validateCommandLineArgs(map<char, string> &optionPairs) {
+    uint64_t count = optionPairs.count('f') + optionPairs.count('u');
+
+    if ((count == 2) && (optionPairs.size() == 2)) {
+        return;
+    } else if (count == 1) {
+        fprintf(stderr, "Failed. Option \'-u\' must work with \'-f\'.\n\n");
+        printUsage(stderr);
+        exit(EXIT_FAILURE);
+    }
+
+    if (optionPairs.size() > 1) {
+        stringstream ss;
+
+        ss << "Failed. Can't set options ";
+
+        // concatenate all option names
+        // e.g. if we have -c and -d, insert "-c, -d" into the stream.
+        for (map<char, string>::iterator i = optionPairs.begin(); i != optionPairs.end(); i++) {
+            ss << "'-" << i->first << "' ";
+        }
+
+        ss << "at the same time.";
+
+        // example message: "Failed. Can't set options '-c' '-d' at the same time."
+        fprintf(stderr, "%s\n\n", ss.str().c_str());
+        printUsage(stderr);
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void printTemplate() {
+    printf(
+        "[default]\n"
+        "secret = \"aws secret\"\n"
+        "accessid = \"aws access id\"\n"
+        "threadnum = 4\n"
+        "chunksize = 67108864\n"
+        "low_speed_limit = 10240\n"
+        "low_speed_time = 60\n"
+        "retrynum = 3\n"
+        "backoff_base_ms = 1000\n"
+        "backoff_cap_ms = 30000\n"
+        "encryption = true\n"
+        "version = 1\n"
+        "proxy = \"\"\n"
+        "autocompress = true\n"
+        "verifycert = true\n"
+        "server_side_encryption = \"\"\n"
+        "# gpcheckcloud config\n"
+        "gpcheckcloud_newline = \"\\n\"\n");
+}
+
+static void printBucketContents(const ListBucketResult &result) {
+    char urlbuf[256];
+    vector<BucketContent>::const_iterator i;
+
+    for (i = result.contents.begin(); i != result.contents.end(); i++) {
+        snprintf(urlbuf, 256, "%s", i->getName().c_str());
+        printf("File: %s, Size: %" PRIu64 "\n", urlbuf, i->getSize());
+    }
+}
+
+static bool checkConfig(const char *urlWithOptions) {
+    if (!urlWithOptions) {
+        return false;
+    }
+
+    GPReader *reader = reader_init(urlWithOptions);
+    if (!reader) {
+        return false;
+    }
+
+    ListBucketResult result = reader->getKeyList();
+
+    if (result.contents.empty()) {
+        fprintf(stderr,
+                "\nYour configuration works well, however there is no file matching your "
+                "prefix.\n");
+    } else {
+        printBucketContents(result);
+        fprintf(stderr, "\nYour configuration works well.\n");
+    }
+
+    reader_cleanup(&reader);
+
+    return true;
+}
+
+static bool downloadS3(const char *urlWithOptions) {
+    if (!urlWithOptions) {
+        return false;
+    }
+
+    int data_len = BUF_SIZE;
+    char data_buf[BUF_SIZE];
+    bool ret = true;
+
+    thread_setup();
+
+    GPReader *reader = reader_init(urlWithOptions);
+    if (!reader) {
+        return false;
+    }
+
+    strncpy(eolString, reader->getParams().getGpcheckcloud_newline().c_str(), EOL_CHARS_MAX_LEN);
+    eolString[EOL_CHARS_MAX_LEN] = '\0';
+
+    do {
+        data_len = BUF_SIZE;
+
+        if (!reader_transfer_data(reader, data_buf, data_len)) {
+            fprintf(stderr, "Failed to read data from Amazon S3\n");
+            ret = false;
+            break;
+        }
+
+        fwrite(data_buf, (size_t)data_len, 1, stdout);
+    } while (data_len && !S3QueryIsAbortInProgress());
+
+    reader_cleanup(&reader);
+
+    thread_cleanup();
+
+    return ret;
+}
+
+struct BenchmarkResult {
+    uint64_t numOfChunks;
+    uint64_t chunkSize;
+    uint64_t totalBytes;
+    double seconds;
+    double minReadMs;
+    double avgReadMs;
+    double maxReadMs;
+};
+
+static double elapsedSeconds(const struct timeval &begin, const struct timeval &end) {
+    return (end.tv_sec - begin.tv_sec) + (end.tv_usec - begin.tv_usec) / 1000000.0;
+}
+
+// Download up to BENCHMARK_BYTES_PER_CONFIG bytes with the given thread count
+// and chunk size, discarding the data, and record sustained bandwidth and
+// per-read latency.
+static BenchmarkResult benchmarkOneConfig(const string &urlWithOptions, uint64_t numOfChunks,
+                                          uint64_t chunkSize) {
+    const uint64_t bytesPerConfig = 128 * 1024 * 1024;
+
+    char data_buf[BUF_SIZE];
+    BenchmarkResult result = {numOfChunks, chunkSize, 0, 0, 0, 0, 0};
+
+    S3Params params = InitConfig(urlWithOptions);
+    params.setNumOfChunks(numOfChunks);
+    params.setChunkSize(chunkSize);
+
+    PrepareS3MemContext(params);
+
+    GPReader reader(params);
+    reader.open(params);
+
+    uint64_t reads = 0;
+    double totalReadMs = 0;
+    struct timeval begin, readBegin, readEnd;
+
+    gettimeofday(&begin, NULL);
+
+    while (result.totalBytes < bytesPerConfig && !S3QueryIsAbortInProgress()) {
+        gettimeofday(&readBegin, NULL);
+        uint64_t readLen = reader.read(data_buf, BUF_SIZE);
+        gettimeofday(&readEnd, NULL);
+
+        if (readLen == 0) {
+            break;
+        }
+
+        double readMs = elapsedSeconds(readBegin, readEnd) * 1000.0;
+        if (reads == 0 || readMs < result.minReadMs) {
+            result.minReadMs = readMs;
+        }
+        if (readMs > result.maxReadMs) {
+            result.maxReadMs = readMs;
+        }
+        totalReadMs += readMs;
+
+        reads++;
+        result.totalBytes += readLen;
+    }
+
+    gettimeofday(&readEnd, NULL);
+    result.seconds = elapsedSeconds(begin, readEnd);
+    result.avgReadMs = (reads == 0) ? 0 : totalReadMs / reads;
+
+    reader.close();
+
+    return result;
+}
+
+// Sweep thread counts and chunk sizes against the configured bucket and print
+// bandwidth and latency per configuration, then the s3.conf settings of the
+// fastest one, so deployments can be sized without trial runs on production
+// queries.
+static bool benchmarkS3(const char *urlWithOptions) {
+    if (!urlWithOptions) {
+        return false;
+    }
+
+    const uint64_t threadNums[] = {1, 2, 4, 8};
+    const uint64_t chunkSizes[] = {8 * 1024 * 1024, 16 * 1024 * 1024, 32 * 1024 * 1024,
+                                   64 * 1024 * 1024};
+
+    bool haveBest = false;
+    BenchmarkResult best = {0, 0, 0, 0, 0, 0, 0};
+
+    thread_setup();
+
+    for (size_t t = 0; t < sizeof(threadNums) / sizeof(threadNums[0]); t++) {
+        for (size_t c = 0; c < sizeof(chunkSizes) / sizeof(chunkSizes[0]); c++) {
+            if (S3QueryIsAbortInProgress()) {
+                thread_cleanup();
+                return false;
+            }
+
+            try {
+                BenchmarkResult result =
+                    benchmarkOneConfig(urlWithOptions, threadNums[t], chunkSizes[c]);
+
+                if (result.totalBytes == 0) {
+                    fprintf(stderr, "No file matching the given prefix, nothing to benchmark.\n");
+                    thread_cleanup();
+                    return false;
+                }
+
+                double mbPerSec = (result.seconds == 0)
+                                      ? 0
+                                      : result.totalBytes / result.seconds / (1024 * 1024);
+
+                printf("threadnum %2" PRIu64 ", chunksize %3" PRIu64
+                       " MB: %8.2f MB/s, read latency min/avg/max %.2f/%.2f/%.2f ms\n",
+                       result.numOfChunks, result.chunkSize / (1024 * 1024), mbPerSec,
+                       result.minReadMs, result.avgReadMs, result.maxReadMs);
+
+                if (!haveBest || (result.totalBytes / result.seconds) >
+                                     (best.totalBytes / best.seconds)) {
+                    best = result;
+                    haveBest = true;
+                }
+            } catch (S3Exception &e) {
+                fprintf(stderr, "threadnum %" PRIu64 ", chunksize %" PRIu64
+                                " MB: failed, caught a %s exception: %s\n",
+                        threadNums[t], chunkSizes[c] / (1024 * 1024), e.getType().c_str(),
+                        e.getFullMessage().c_str());
+            }
+        }
+    }
+
+    thread_cleanup();
+
+    if (!haveBest) {
+        return false;
+    }
+
+    printf(
+        "\nRecommended s3.conf settings:\n"
+        "threadnum = %" PRIu64 "\n"
+        "chunksize = %" PRIu64 "\n",
+        best.numOfChunks, best.chunkSize);
+
+    return true;
+}
+
+static bool uploadS3(const char *urlWithOptions, const char *fileToUpload) {
+    if (!urlWithOptions) {
+        return false;
+    }
+
+    size_t data_len = BUF_SIZE;
+    char data_buf[BUF_SIZE];
+    size_t read_len = 0;
+    bool ret = true;
+
+    thread_setup();
+
+    GPWriter *writer = writer_init(urlWithOptions);
+    if (!writer) {
+        return false;
+    }
+
+    FILE *fd = fopen(fileToUpload, "r");
+    if (fd == NULL) {
+        fprintf(stderr, "File does not exist\n");
+        ret = false;
+    } else {
+        do {
+            read_len = fread(data_buf, 1, data_len, fd);
+
+            if (read_len == 0) {
+                break;
+            }
+
+            if (!writer_transfer_data(writer, data_buf, (int)read_len)) {
+                fprintf(stderr, "Failed to write data to Amazon S3\n");
+                ret = false;
+                break;
+            }
+        } while (read_len == data_len && !S3QueryIsAbortInProgress());
+
+        if (ferror(fd)) {
+            ret = false;
+        }
+
+        fclose(fd);
+    }
+
+    writer_cleanup(&writer);
+
+    thread_cleanup();
+
+    return ret;
+}
+
+int main(int argc, char *argv[]) {
+    bool ret = true;
+
+    s3ext_loglevel = EXT_ERROR;
+    s3ext_logtype = STDERR_LOG;
+
+    if (argc == 1) {
+        printUsage(stderr);
+        exit(EXIT_FAILURE);
+    }
+
+    /* Prepare to receive interrupts */
+    registerSignalHandler();
+
+    map<char, string> optionPairs = parseCommandLineArgs(argc, argv);
+
+    validateCommandLineArgs(optionPairs);
+
+    if (!optionPairs.empty()) {
+        const char *arg = optionPairs.begin()->second.c_str();
+
+        switch (optionPairs.begin()->first) {
+            case 'c':
+                ret = checkConfig(arg);
+                break;
+            case 'd':
+                ret = downloadS3(arg);
+                break;
+            case 'b':
+                ret = benchmarkS3(arg);
+                break;
+            case 'u':
+            case 'f':
+                ret = uploadS3(optionPairs['u'].c_str(), optionPairs['f'].c_str());
+                break;
+            case 'h':
+                printUsage(stdout);
+                break;
+            case 't':
+                printTemplate();
+                break;
+            default:
+                printUsage(stderr);
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    // Abort should not print the failed info
+    if (ret || S3QueryIsAbortInProgress()) {
+        exit(EXIT_SUCCESS);
+    } else {
+        fprintf(stderr, "Failed. Please check the arguments and configuration file.\n\n");
+        printUsage(stderr);
+        exit(EXIT_FAILURE);
+    }
+}
@@ -29,6 +29,7 @@ class CompressWriter : public Writer {
    private:
     void flush();
     uint64_t writeOneChunk(const char *buf, uint64_t count);
+    void emitSyncPoint();
 
     Writer *writer;
 
@@ -38,6 +39,9 @@ class CompressWriter : public Writer {
 
     // add this flag to make close() reentrant
     bool isClosed;
+
+    // uncompressed bytes written since the last full-flush sync point.
+    uint64_t bytesSinceSyncPoint;
 };
 
 #endif
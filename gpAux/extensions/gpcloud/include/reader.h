@@ -16,6 +16,19 @@ class Reader {
     // errors.
     virtual uint64_t read(char *buf, uint64_t count) = 0;
 
+    // readZeroCopy() lends the caller a pointer into the reader's internal
+    // buffer instead of copying, saving one memcpy of every byte read. The
+    // lease is valid until the next readZeroCopy() call; len == 0 means EOF.
+    // Only readers that return true from hasZeroCopyRead() support it.
+    virtual const char *readZeroCopy(uint64_t &len) {
+        len = 0;
+        return NULL;
+    }
+
+    virtual bool hasZeroCopyRead() const {
+        return false;
+    }
+
     // This should be reentrant, has no side effects when called multiple times.
     virtual void close() = 0;
 };
@@ -46,7 +46,11 @@ class S3BucketReader : public Reader {
     uint64_t readWithoutHeaderLine(char *buf, uint64_t count);
 
     ListBucketResult keyList;  // List of matched keys/files.
-    uint64_t keyIndex;         // BucketContent index of keylist->contents.
+
+    // Indexes into keyList.contents of the keys this segment reads, picked by
+    // greedy size balancing over the listing; keyIndex is the cursor into it.
+    vector<uint64_t> ownKeyIndexes;
+    uint64_t keyIndex;
 
     BucketContent &getNextKey();
     S3Params constructReaderParams(BucketContent &key);
@@ -12,6 +12,8 @@
 
 #define S3_REQUEST_NO_RETRY 1
 #define S3_REQUEST_MAX_RETRIES 3
+// tells *WithRetries() to use the retrynum configured in S3Params
+#define S3_REQUEST_CONFIGURED_RETRIES ((uint64_t)-1)
 
 #define S3_RANGE_HEADER_STRING_LEN 128
 
@@ -92,20 +94,20 @@ class S3InterfaceService : public S3Interface {
 
    protected:
     Response getResponseWithRetries(const string &url, HTTPHeaders &headers,
-                                    uint64_t retries = S3_REQUEST_MAX_RETRIES);
+                                    uint64_t retries = S3_REQUEST_CONFIGURED_RETRIES);
 
     Response putResponseWithRetries(const string &url, HTTPHeaders &headers, S3VectorUInt8 &data,
-                                    uint64_t retries = S3_REQUEST_MAX_RETRIES);
+                                    uint64_t retries = S3_REQUEST_CONFIGURED_RETRIES);
 
     Response postResponseWithRetries(const string &url, HTTPHeaders &headers,
                                      const vector<uint8_t> &data,
-                                     uint64_t retries = S3_REQUEST_MAX_RETRIES);
+                                     uint64_t retries = S3_REQUEST_CONFIGURED_RETRIES);
 
     ResponseCode headResponseWithRetries(const string &url, HTTPHeaders &headers,
-                                         uint64_t retries = S3_REQUEST_MAX_RETRIES);
+                                         uint64_t retries = S3_REQUEST_CONFIGURED_RETRIES);
 
     Response deleteRequestWithRetries(const string &url, HTTPHeaders &headers,
-                                      uint64_t retries = S3_REQUEST_MAX_RETRIES);
+                                      uint64_t retries = S3_REQUEST_CONFIGURED_RETRIES);
 
     string getUploadId(const S3Url &s3Url);
 
@@ -118,6 +120,8 @@ class S3InterfaceService : public S3Interface {
     bool abortUpload(const S3Url &s3Url, const string &uploadId);
 
    private:
+    void backoffBeforeRetry(uint64_t attempt);
+
     bool parseBucketXML(ListBucketResult *result, xmlParserCtxtPtr xmlcontext, string &marker);
 
     Response getBucketResponse(const S3Url &s3Url, const string &encodedQuery);
@@ -11,9 +11,16 @@ struct Range {
     uint64_t length;
 };
 
+// Adaptive chunk sizing: chunks start small so scans produce rows quickly,
+// double toward the configured chunk size while fetches complete fast, and
+// shrink again on errors or slow round trips.
+#define S3_ADAPTIVE_CHUNKSIZE_INITIAL (8 * 1024 * 1024)
+#define S3_ADAPTIVE_CHUNKSIZE_MIN (2 * 1024 * 1024)
+#define S3_ADAPTIVE_FETCH_SLOW_SECONDS 20.0
+
 class OffsetMgr {
    public:
-    OffsetMgr() : keySize(0), chunkSize(0), curPos(0) {
+    OffsetMgr() : keySize(0), chunkSize(0), curPos(0), maxChunkSize(0) {
         pthread_mutex_init(&this->offsetLock, NULL);
     }
     ~OffsetMgr() {
@@ -46,17 +53,32 @@ class OffsetMgr {
         this->setCurPos(0);
         this->setChunkSize(0);
         this->setKeySize(0);
+        this->maxChunkSize = 0;
     }
 
     uint64_t getCurPos() const {
         return curPos;
     }
 
+    // Start handing out small chunks and let fetch feedback grow the chunk
+    // size toward the configured one. Call before any getNextOffset(); a
+    // configured chunk size at or below the initial window leaves the
+    // controller disabled.
+    void enableAdaptiveChunkSize() {
+        if (this->chunkSize > S3_ADAPTIVE_CHUNKSIZE_INITIAL) {
+            this->maxChunkSize = this->chunkSize;
+            this->chunkSize = S3_ADAPTIVE_CHUNKSIZE_INITIAL;
+        }
+    }
+
+    void reportFetchResult(bool success, double seconds);
+
    private:
     pthread_mutex_t offsetLock;
     uint64_t keySize;  // size of S3 key(file)
     uint64_t chunkSize;
     uint64_t curPos;
+    uint64_t maxChunkSize;  // configured chunk size, 0 if not adapting
 };
 
 enum ChunkStatus {
@@ -85,6 +107,10 @@ class S3KeyReader : public Reader {
 
     void open(const S3Params& params);
     uint64_t read(char* buf, uint64_t count);
+    const char* readZeroCopy(uint64_t& len);
+    bool hasZeroCopyRead() const {
+        return true;
+    }
     void close();
 
     void setS3InterfaceService(S3Interface* s3) {
@@ -187,6 +213,7 @@ class ChunkBuffer {
     }
 
     uint64_t read(char* buf, uint64_t len);
+    const char* readZeroCopy(uint64_t& len);
     uint64_t fill();
 
     void setS3InterfaceService(S3Interface* s3) {
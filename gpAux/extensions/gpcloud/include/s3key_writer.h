@@ -44,6 +44,7 @@ class S3KeyWriter : public Writer {
     void flushBuffer();
     void completeKeyWriting();
     void checkQueryCancelSignal();
+    void reapFinishedThreads();
 
     bool sharedError;
     std::exception_ptr sharedException;
@@ -56,6 +57,11 @@ class S3KeyWriter : public Writer {
     map<uint64_t, string> etagList;
 
     vector<pthread_t> threadList;
+
+    // threads that finished their part and are waiting to be joined; reaped
+    // on the next flush so a long upload does not pile up dead threads.
+    vector<pthread_t> finishedThreads;
+
     pthread_mutex_t mutex;
     pthread_cond_t cv;
     uint64_t partNumber;
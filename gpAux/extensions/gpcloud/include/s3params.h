@@ -20,6 +20,10 @@ class S3Params {
           proxy(""),
           debugCurl(false),
           autoCompress(false),
+          compressLevel(-1),
+          retryNum(3),
+          backoffBaseMs(0),
+          backoffCapMs(30000),
           verifyCert(false),
           sseType(SSE_NONE),
           gpcheckcloud_newline("") {
@@ -111,6 +115,38 @@ class S3Params {
         this->autoCompress = autoCompress;
     }
 
+    int getCompressLevel() const {
+        return compressLevel;
+    }
+
+    void setCompressLevel(int compressLevel) {
+        this->compressLevel = compressLevel;
+    }
+
+    uint64_t getRetryNum() const {
+        return retryNum;
+    }
+
+    void setRetryNum(uint64_t retryNum) {
+        this->retryNum = retryNum;
+    }
+
+    uint64_t getBackoffBaseMs() const {
+        return backoffBaseMs;
+    }
+
+    void setBackoffBaseMs(uint64_t backoffBaseMs) {
+        this->backoffBaseMs = backoffBaseMs;
+    }
+
+    uint64_t getBackoffCapMs() const {
+        return backoffCapMs;
+    }
+
+    void setBackoffCapMs(uint64_t backoffCapMs) {
+        this->backoffCapMs = backoffCapMs;
+    }
+
     const S3MemoryContext& getMemoryContext() const {
         return memoryContext;
     }
@@ -164,6 +200,11 @@ class S3Params {
 
     bool debugCurl;     // debug curl or not
     bool autoCompress;  // whether to compress data before uploading
+    int compressLevel;  // zlib compression level, -1 picks zlib's default
+
+    uint64_t retryNum;        // attempts per request before giving up
+    uint64_t backoffBaseMs;   // first retry delay, 0 disables backoff
+    uint64_t backoffCapMs;    // upper bound for the doubling retry delay
     bool verifyCert;  // This option determines whether curl verifies the authenticity of the peer's
                       // certificate.
 
@@ -27,6 +27,13 @@ class S3RESTfulService : public RESTfulService {
 
     Response deleteRequest(const string& url, HTTPHeaders& headers);
 
+    // Curl handle pool, shared by all key readers/writers going through this
+    // service within a scan. An idle handle keeps its established keep-alive
+    // connections (and TLS sessions), so consecutive requests to the same
+    // endpoint skip the TCP and TLS handshakes.
+    CURL* acquireCurlHandle();
+    void releaseCurlHandle(CURL* curl);
+
    private:
     uint64_t lowSpeedLimit;
     uint64_t lowSpeedTime;
@@ -39,7 +46,10 @@ class S3RESTfulService : public RESTfulService {
     uint64_t chunkBufferSize;
     S3MemoryContext s3MemContext;
 
-    void performCurl(CURL* curl, Response& response);
+    vector<CURL*> idleCurlHandles;
+    pthread_mutex_t handlePoolLock;
+
+    void performCurl(CURL* curl, Response& response, bool abortable = true);
 };
 
 class S3MessageParser {
@@ -20,10 +20,11 @@ void CompressWriter::open(const S3Params& params) {
     this->zstream.opaque = Z_NULL;
 
     // With S3_DEFLATE_WINDOWSBITS, it generates gzip stream with header and trailer
-    int ret = deflateInit2(&this->zstream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+    int ret = deflateInit2(&this->zstream, params.getCompressLevel(), Z_DEFLATED,
                            S3_DEFLATE_WINDOWSBITS, 8, Z_DEFAULT_STRATEGY);
 
     this->isClosed = false;
+    this->bytesSinceSyncPoint = 0;
 
     // init them here to get ready for both writer() and close()
     this->zstream.next_in = NULL;
@@ -84,9 +85,42 @@ uint64_t CompressWriter::write(const char* buf, uint64_t count) {
         writtenLen += this->writeOneChunk(buf + writtenLen, count - writtenLen);
     }
 
+    // One sync point per ~chunk of input costs only a few bytes per
+    // S3_ZIP_COMPRESS_CHUNKSIZE, while bounding how far into the stream a
+    // range reader has to decompress before reaching a restart point.
+    this->bytesSinceSyncPoint += writtenLen;
+    if (this->bytesSinceSyncPoint >= S3_ZIP_COMPRESS_CHUNKSIZE) {
+        this->emitSyncPoint();
+        this->bytesSinceSyncPoint = 0;
+    }
+
     return writtenLen;
 }
 
+// Emit a Z_FULL_FLUSH sync point: it byte-aligns the output and resets the
+// compression dictionary, so decompression can restart at this offset without
+// any of the preceding bytes. These are the flush points a gzip chunk index
+// records to let readers decode disjoint regions of one object.
+void CompressWriter::emitSyncPoint() {
+    int status;
+    bool outBufferFull;
+
+    do {
+        status = deflate(&this->zstream, Z_FULL_FLUSH);
+        if (status < 0 && status != Z_BUF_ERROR) {
+            deflateEnd(&this->zstream);
+            S3_CHECK_OR_DIE(false, S3RuntimeError,
+                            string("Failed to compress data: ") +
+                                std::to_string((unsigned long long)status) + ", " +
+                                this->zstream.msg);
+        }
+
+        // a full output buffer means the flush may be incomplete, go on
+        outBufferFull = (this->zstream.avail_out == 0);
+        this->flush();
+    } while (outBufferFull);
+}
+
 void CompressWriter::close() {
     if (this->isClosed) {
         return;
@@ -76,35 +76,56 @@ void DecompressReader::decompress() {
         this->zstream.avail_out = S3_ZIP_DECOMPRESS_CHUNKSIZE;
         this->zstream.next_out = (Byte *)this->out;
 
-        // read S3_ZIP_DECOMPRESS_CHUNKSIZE data from underlying reader and put into this->in
-        // buffer. read() might happen more than once when reaching EOF, make sure every time read()
-        // will return 0.
-        uint64_t hasRead = this->reader->read(this->in, S3_ZIP_DECOMPRESS_CHUNKSIZE);
-
-        // EOF, no more data to decompress.
-        if (hasRead == 0) {
-            S3DEBUG(
-                "No more data to decompress: avail_in = %u, avail_out = %u, total_in = %u, "
-                "total_out = %u",
-                zstream.avail_in, zstream.avail_out, zstream.total_in, zstream.total_out);
-            return;
-        }
+        // Inflate straight out of the upstream reader's chunk memory when it
+        // can lend us a stable pointer, saving one copy of every compressed
+        // byte; the lease stays valid until we ask for the next one, and we
+        // only do that once avail_in is drained.
+        if (this->reader->hasZeroCopyRead()) {
+            uint64_t leaseLen = 0;
+            const char *leasePtr = this->reader->readZeroCopy(leaseLen);
+
+            // EOF, no more data to decompress.
+            if (leaseLen == 0) {
+                S3DEBUG(
+                    "No more data to decompress: avail_in = %u, avail_out = %u, total_in = %u, "
+                    "total_out = %u",
+                    zstream.avail_in, zstream.avail_out, zstream.total_in, zstream.total_out);
+                return;
+            }
+
+            this->zstream.next_in = (Byte *)leasePtr;
+            this->zstream.avail_in = leaseLen;
+        } else {
+            // read S3_ZIP_DECOMPRESS_CHUNKSIZE data from underlying reader and put into this->in
+            // buffer. read() might happen more than once when reaching EOF, make sure every time
+            // read() will return 0.
+            uint64_t hasRead = this->reader->read(this->in, S3_ZIP_DECOMPRESS_CHUNKSIZE);
+
+            // EOF, no more data to decompress.
+            if (hasRead == 0) {
+                S3DEBUG(
+                    "No more data to decompress: avail_in = %u, avail_out = %u, total_in = %u, "
+                    "total_out = %u",
+                    zstream.avail_in, zstream.avail_out, zstream.total_in, zstream.total_out);
+                return;
+            }
+
+            // Fill this->in as possible as it could, otherwise data in this->in might not be able
+            // to be inflated.
+            while (hasRead < S3_ZIP_DECOMPRESS_CHUNKSIZE) {
+                uint64_t count =
+                    this->reader->read(this->in + hasRead, S3_ZIP_DECOMPRESS_CHUNKSIZE - hasRead);
 
-        // Fill this->in as possible as it could, otherwise data in this->in might not be able to be
-        // inflated.
-        while (hasRead < S3_ZIP_DECOMPRESS_CHUNKSIZE) {
-            uint64_t count =
-                this->reader->read(this->in + hasRead, S3_ZIP_DECOMPRESS_CHUNKSIZE - hasRead);
+                if (count == 0) {
+                    break;
+                }
 
-            if (count == 0) {
-                break;
+                hasRead += count;
             }
 
-            hasRead += count;
+            this->zstream.next_in = (Byte *)this->in;
+            this->zstream.avail_in = hasRead;
         }
-
-        this->zstream.next_in = (Byte *)this->in;
-        this->zstream.avail_in = hasRead;
     } else {
         // Still have more data in 'in' buffer to decode.
         this->zstream.avail_out = S3_ZIP_DECOMPRESS_CHUNKSIZE;
@@ -14,10 +14,53 @@ S3BucketReader::~S3BucketReader() {
     this->close();
 }
 
+// Assign keys to segments by greedy size balancing: walk the keys from
+// largest to smallest and hand each one to the segment with the fewest bytes
+// assigned so far. A plain round-robin on the key index lets one huge object
+// and a pile of tiny ones land on the same segment, so the scan runs as long
+// as the most loaded segment instead of the average. Every segment computes
+// the same assignment over the same listing, so they agree without any
+// coordination. Returns the indexes of this segment's keys in listing order.
+static vector<uint64_t> assignKeysToSegment(const vector<BucketContent>& contents, int32_t segid,
+                                            int32_t segnum) {
+    vector<uint64_t> order(contents.size());
+    for (uint64_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+
+    if (order.empty()) {
+        return order;
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&contents](uint64_t a, uint64_t b) {
+        return contents[a].getSize() > contents[b].getSize();
+    });
+
+    vector<uint64_t> assignedBytes(segnum, 0);
+    vector<uint64_t> ownKeyIndexes;
+
+    for (uint64_t i = 0; i < order.size(); i++) {
+        int32_t leastLoaded = 0;
+        for (int32_t seg = 1; seg < segnum; seg++) {
+            if (assignedBytes[seg] < assignedBytes[leastLoaded]) {
+                leastLoaded = seg;
+            }
+        }
+
+        assignedBytes[leastLoaded] += contents[order[i]].getSize();
+        if (leastLoaded == segid) {
+            ownKeyIndexes.push_back(order[i]);
+        }
+    }
+
+    std::sort(ownKeyIndexes.begin(), ownKeyIndexes.end());
+    return ownKeyIndexes;
+}
+
 void S3BucketReader::open(const S3Params& params) {
     this->params = params;
 
-    this->keyIndex = s3ext_segid;  // we may change it in unit tests
+    this->keyIndex = 0;
 
     S3_CHECK_OR_DIE(this->s3Interface != NULL, S3RuntimeError, "s3Interface is NULL");
 
@@ -27,11 +70,12 @@ void S3BucketReader::open(const S3Params& params) {
                     s3Url.getFullUrlForCurl());
 
     this->keyList = this->s3Interface->listBucket(s3Url);
+    this->ownKeyIndexes = assignKeysToSegment(this->keyList.contents, s3ext_segid, s3ext_segnum);
 }
 
 BucketContent& S3BucketReader::getNextKey() {
-    BucketContent& key = this->keyList.contents[this->keyIndex];
-    this->keyIndex += s3ext_segnum;
+    BucketContent& key = this->keyList.contents[this->ownKeyIndexes[this->keyIndex]];
+    this->keyIndex++;
     return key;
 }
 
@@ -98,7 +142,7 @@ uint64_t S3BucketReader::read(char* buf, uint64_t count) {
     uint64_t readCount = 0;
     while (true) {
         if (this->needNewReader) {
-            if (this->keyIndex >= this->keyList.contents.size()) {
+            if (this->keyIndex >= this->ownKeyIndexes.size()) {
                 S3DEBUG("Read finished for segment: %d", s3ext_segid);
                 return 0;
             }
@@ -137,4 +181,6 @@ void S3BucketReader::close() {
     if (!this->keyList.contents.empty()) {
         this->keyList.contents.clear();
     }
+
+    this->ownKeyIndexes.clear();
 }
\ No newline at end of file
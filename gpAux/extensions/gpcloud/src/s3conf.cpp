@@ -21,6 +21,31 @@ int32_t s3ext_logserverport = -1;
 int32_t s3ext_logsock_udp = -1;
 struct sockaddr_in s3ext_logserveraddr;
 
+// Per-LOCATION override: an external table can tune selected parameters in
+// its URL options (e.g. "... threadnum=8 chunksize=33554432"), so tables over
+// a fast staging bucket and a slow archival bucket need not share one global
+// tuning. Values are clamped to the same range as the config file ones.
+static int64_t ScanUrlOption(const string& urlWithOptions, const string& key,
+                             int64_t currentValue, int64_t minValue, int64_t maxValue) {
+    string value = GetOptS3(urlWithOptions, key);
+    if (value.empty()) {
+        return currentValue;
+    }
+
+    long long scannedValue = 0;
+    if (sscanf(value.c_str(), "%12lld", &scannedValue) != 1) {
+        return currentValue;
+    }
+
+    if (scannedValue > maxValue) {
+        scannedValue = maxValue;
+    } else if (scannedValue < minValue) {
+        scannedValue = minValue;
+    }
+
+    return scannedValue;
+}
+
 S3Params InitConfig(const string& urlWithOptions) {
 #ifdef S3_STANDALONE
     s3ext_segid = 0;
@@ -85,22 +110,45 @@ S3Params InitConfig(const string& urlWithOptions) {
     s3ext_logserverport = s3Cfg.SafeScan("logserverport", configSection, 1111, 1, 65535);
 
     int64_t numOfChunks = s3Cfg.SafeScan("threadnum", configSection, 4, 1, 8);
+    numOfChunks = ScanUrlOption(urlWithOptions, "threadnum", numOfChunks, 1, 8);
     params.setNumOfChunks(numOfChunks);
 
     int64_t chunkSize = s3Cfg.SafeScan("chunksize", configSection, 64 * 1024 * 1024,
                                        8 * 1024 * 1024, 128 * 1024 * 1024);
+    chunkSize =
+        ScanUrlOption(urlWithOptions, "chunksize", chunkSize, 8 * 1024 * 1024, 128 * 1024 * 1024);
     params.setChunkSize(chunkSize);
 
     int64_t lowSpeedLimit = s3Cfg.SafeScan("low_speed_limit", configSection, 10240, 0, INT_MAX);
+    lowSpeedLimit = ScanUrlOption(urlWithOptions, "low_speed_limit", lowSpeedLimit, 0, INT_MAX);
     params.setLowSpeedLimit(lowSpeedLimit);
 
     int64_t lowSpeedTime = s3Cfg.SafeScan("low_speed_time", configSection, 60, 0, INT_MAX);
+    lowSpeedTime = ScanUrlOption(urlWithOptions, "low_speed_time", lowSpeedTime, 0, INT_MAX);
     params.setLowSpeedTime(lowSpeedTime);
 
+    // retries per request; the delay doubles from backoff_base_ms up to
+    // backoff_cap_ms with full jitter, so a throttled endpoint is not hammered
+    int64_t retryNum = s3Cfg.SafeScan("retrynum", configSection, 3, 1, 10);
+    retryNum = ScanUrlOption(urlWithOptions, "retrynum", retryNum, 1, 10);
+    params.setRetryNum(retryNum);
+
+    int64_t backoffBase = s3Cfg.SafeScan("backoff_base_ms", configSection, 1000, 0, 60 * 1000);
+    params.setBackoffBaseMs(backoffBase);
+
+    int64_t backoffCap =
+        s3Cfg.SafeScan("backoff_cap_ms", configSection, 30 * 1000, backoffBase, 600 * 1000);
+    params.setBackoffCapMs(backoffCap);
+
     params.setProxy(s3Cfg.Get(configSection, "proxy", ""));
 
     params.setAutoCompress(s3Cfg.GetBool(configSection, "autocompress", "true"));
 
+    // level 1 trades a little ratio for several times less CPU per segment,
+    // useful when export throughput is compression bound; -1 is zlib's default
+    int64_t compressLevel = s3Cfg.SafeScan("compresslevel", configSection, -1, -1, 9);
+    params.setCompressLevel(compressLevel);
+
     params.setVerifyCert(s3Cfg.GetBool(configSection, "verifycert", "true"));
 
     string sse_type = s3Cfg.Get(configSection, "server_side_encryption", "");
@@ -1,3 +1,5 @@
+#include <unistd.h>
+
 #include "s3interface.h"
 
 // use destructor ~XMLContextHolder() to do the cleanup
@@ -29,9 +31,44 @@ S3InterfaceService::~S3InterfaceService() {
     xmlCleanupParser();
 }
 
+// Sleep before the next retry attempt: the delay doubles from the configured
+// backoff_base_ms up to backoff_cap_ms, and the actual sleep is uniform in
+// [0, delay] (full jitter) so concurrent threads do not retry in lockstep
+// against a throttled endpoint. A base of zero disables the backoff. Only
+// connection-class errors are retried at all; the RESTful layer maps
+// retriable server errors (500/503, RequestTimeout) to S3ConnectionError
+// and everything else is thrown through to fail the query.
+void S3InterfaceService::backoffBeforeRetry(uint64_t attempt) {
+    uint64_t delayMs = this->params.getBackoffBaseMs();
+    uint64_t capMs = this->params.getBackoffCapMs();
+
+    if (delayMs == 0) {
+        return;
+    }
+
+    for (uint64_t i = 1; i < attempt && delayMs < capMs; i++) {
+        delayMs *= 2;
+    }
+    delayMs = std::min(delayMs, capMs);
+
+    delayMs = ((uint64_t)rand()) % (delayMs + 1);
+
+    // sleep in small slices so a query abort is noticed promptly
+    while (delayMs > 0 && !S3QueryIsAbortInProgress()) {
+        uint64_t sliceMs = std::min(delayMs, (uint64_t)100);
+        usleep(sliceMs * 1000);
+        delayMs -= sliceMs;
+    }
+}
+
 Response S3InterfaceService::getResponseWithRetries(const string &url, HTTPHeaders &headers,
                                                     uint64_t retries) {
     string message;
+
+    if (retries == S3_REQUEST_CONFIGURED_RETRIES) {
+        retries = this->params.getRetryNum();
+    }
+
     uint64_t retry = retries;
 
     while (retry--) {
@@ -43,6 +80,9 @@ Response S3InterfaceService::getResponseWithRetries(const string &url, HTTPHeade
                 S3_DIE(S3QueryAbort, "Downloading is interrupted");
             }
             S3WARN("Failed to get a good response in GET from '%s', retrying ...", url.c_str());
+            if (retry > 0) {
+                this->backoffBeforeRetry(retries - retry);
+            }
         }
     };
 
@@ -52,6 +92,11 @@ Response S3InterfaceService::getResponseWithRetries(const string &url, HTTPHeade
 Response S3InterfaceService::putResponseWithRetries(const string &url, HTTPHeaders &headers,
                                                     S3VectorUInt8 &data, uint64_t retries) {
     string message;
+
+    if (retries == S3_REQUEST_CONFIGURED_RETRIES) {
+        retries = this->params.getRetryNum();
+    }
+
     uint64_t retry = retries;
 
     while (retry--) {
@@ -63,6 +108,9 @@ Response S3InterfaceService::putResponseWithRetries(const string &url, HTTPHeade
                 S3_DIE(S3QueryAbort, "Uploading is interrupted");
             }
             S3WARN("Failed to get a good response in PUT from '%s', retrying ...", url.c_str());
+            if (retry > 0) {
+                this->backoffBeforeRetry(retries - retry);
+            }
         }
     };
 
@@ -73,6 +121,11 @@ Response S3InterfaceService::postResponseWithRetries(const string &url, HTTPHead
                                                      const vector<uint8_t> &data,
                                                      uint64_t retries) {
     string message;
+
+    if (retries == S3_REQUEST_CONFIGURED_RETRIES) {
+        retries = this->params.getRetryNum();
+    }
+
     uint64_t retry = retries;
 
     while (retry--) {
@@ -84,6 +137,9 @@ Response S3InterfaceService::postResponseWithRetries(const string &url, HTTPHead
                 S3_DIE(S3QueryAbort, "Uploading is interrupted");
             }
             S3WARN("Failed to get a good response in POST from '%s', retrying ...", url.c_str());
+            if (retry > 0) {
+                this->backoffBeforeRetry(retries - retry);
+            }
         }
     };
 
@@ -97,6 +153,11 @@ bool S3InterfaceService::isKeyExisted(ResponseCode code) {
 ResponseCode S3InterfaceService::headResponseWithRetries(const string &url, HTTPHeaders &headers,
                                                          uint64_t retries) {
     string message;
+
+    if (retries == S3_REQUEST_CONFIGURED_RETRIES) {
+        retries = this->params.getRetryNum();
+    }
+
     uint64_t retry = retries;
 
     while (retry--) {
@@ -109,6 +170,9 @@ ResponseCode S3InterfaceService::headResponseWithRetries(const string &url, HTTP
             }
 
             S3WARN("Failed to get a good response in HEAD from '%s', retrying ...", url.c_str());
+            if (retry > 0) {
+                this->backoffBeforeRetry(retries - retry);
+            }
         }
     };
 
@@ -118,6 +182,11 @@ ResponseCode S3InterfaceService::headResponseWithRetries(const string &url, HTTP
 Response S3InterfaceService::deleteRequestWithRetries(const string &url, HTTPHeaders &headers,
                                                       uint64_t retries) {
     string message;
+
+    if (retries == S3_REQUEST_CONFIGURED_RETRIES) {
+        retries = this->params.getRetryNum();
+    }
+
     uint64_t retry = retries;
 
     while (retry--) {
@@ -129,6 +198,9 @@ Response S3InterfaceService::deleteRequestWithRetries(const string &url, HTTPHea
                 S3_DIE(S3QueryAbort, "Uploading is interrupted");
             }
             S3WARN("Failed to get a good response in DELETE from '%s', retrying ...", url.c_str());
+            if (retry > 0) {
+                this->backoffBeforeRetry(retries - retry);
+            }
         }
     };
 
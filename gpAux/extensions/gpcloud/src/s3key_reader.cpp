@@ -1,3 +1,5 @@
+#include <sys/time.h>
+
 #include "s3key_reader.h"
 
 // Return (offset, length) of next chunk to download,
@@ -20,6 +22,24 @@ Range OffsetMgr::getNextOffset() {
     return ret;
 }
 
+// Feedback from a finished chunk fetch. While downloads succeed quickly the
+// chunk size doubles up to the configured one, probing for the bandwidth
+// plateau; an error or a slow round trip halves it so that throttling or
+// transient congestion does not pin every in-flight chunk for minutes.
+void OffsetMgr::reportFetchResult(bool success, double seconds) {
+    if (this->maxChunkSize == 0) {
+        return;  // adaptive sizing not enabled
+    }
+
+    pthread_mutex_lock(&this->offsetLock);
+    if (!success || seconds > S3_ADAPTIVE_FETCH_SLOW_SECONDS) {
+        this->chunkSize = std::max(this->chunkSize / 2, (uint64_t)S3_ADAPTIVE_CHUNKSIZE_MIN);
+    } else if (this->chunkSize < this->maxChunkSize) {
+        this->chunkSize = std::min(this->chunkSize * 2, this->maxChunkSize);
+    }
+    pthread_mutex_unlock(&this->offsetLock);
+}
+
 ChunkBuffer::ChunkBuffer(const S3Url& s3Url, S3KeyReader& reader, const S3MemoryContext& context)
     : s3Url(s3Url), chunkData(context), offsetMgr(reader.getOffsetMgr()), sharedKeyReader(reader) {
     s3Interface = NULL;
@@ -97,6 +117,55 @@ uint64_t ChunkBuffer::read(char* buf, uint64_t len) {
     return lenToRead;
 }
 
+// Zero-copy variant of read(): lend the caller whatever is left of the
+// current chunk as a pointer into chunkData, valid until the next call. The
+// chunk is recycled for the downloader on the call after the one that drained
+// it, so a leased pointer is never pulled out from under the caller; len == 0
+// tells the caller to move on to the next chunk buffer.
+const char* ChunkBuffer::readZeroCopy(uint64_t& len) {
+    S3_CHECK_OR_DIE(!S3QueryIsAbortInProgress(), S3QueryAbort, "");
+
+    UniqueLock statusLock(&this->statusMutex);
+    while (this->status != ReadyToRead) {
+        pthread_cond_wait(&this->statusCondVar, &this->statusMutex);
+    }
+
+    // Error is shared between all chunks.
+    if (this->isError()) {
+        len = 0;
+        return NULL;
+    }
+
+    uint64_t leftLen = this->chunkDataSize - this->curChunkOffset;
+
+    if (leftLen == 0) {
+        // the previous lease drained this chunk, hand it back to the
+        // downloader; same bookkeeping as the empty branch of read()
+        this->curChunkOffset = 0;
+
+        if (!this->isEOF()) {
+            this->chunkData.release();
+
+            this->status = ReadyToFill;
+
+            Range range = this->offsetMgr.getNextOffset();
+            this->curFileOffset = range.offset;
+            this->chunkDataSize = range.length;
+
+            pthread_cond_signal(&this->statusCondVar);
+        }
+
+        len = 0;
+        return NULL;
+    }
+
+    const char* ptr = (const char*)this->chunkData.data() + this->curChunkOffset;
+    this->curChunkOffset += leftLen;
+    len = leftLen;
+
+    return ptr;
+}
+
 // returning uint64_t(-1) means error
 uint64_t ChunkBuffer::fill() {
     UniqueLock statusLock(&this->statusMutex);
@@ -118,18 +187,30 @@ uint64_t ChunkBuffer::fill() {
     uint64_t readLen = 0;
 
     if (leftLen != 0) {
+        bool fetchSucceeded = true;
+        struct timeval fetchStart, fetchEnd;
+
+        gettimeofday(&fetchStart, NULL);
+
         try {
             readLen = this->s3Interface->fetchData(offset, this->chunkData, leftLen, this->s3Url);
             if (readLen != leftLen) {
                 S3DEBUG("Failed to fetch expected data from S3");
                 this->setSharedError(true, S3PartialResponseError(leftLen, readLen));
+                fetchSucceeded = false;
             } else {
                 S3DEBUG("Got %" PRIu64 " bytes from S3", readLen);
             }
         } catch (S3Exception& e) {
             S3DEBUG("Failed to fetch expected data from S3");
             this->setSharedError(true);
+            fetchSucceeded = false;
         }
+
+        gettimeofday(&fetchEnd, NULL);
+        offsetMgr.reportFetchResult(fetchSucceeded,
+                                    (fetchEnd.tv_sec - fetchStart.tv_sec) +
+                                        (fetchEnd.tv_usec - fetchStart.tv_usec) / 1000000.0);
     }
 
     if (offset + leftLen >= offsetMgr.getKeySize()) {
@@ -195,6 +276,11 @@ void S3KeyReader::open(const S3Params& params) {
     S3_CHECK_OR_DIE(params.getChunkSize() > 0, S3RuntimeError,
                     "chunk size must be greater than zero");
 
+    // adapt the chunk size to the observed fetch latency; the configured
+    // chunk size is the upper bound, so memory consumption never exceeds
+    // numOfChunks * chunksize
+    this->offsetMgr.enableAdaptiveChunkSize();
+
     this->chunkBuffers.reserve(this->numOfChunks);
 
     for (uint64_t i = 0; i < this->numOfChunks; i++) {
@@ -259,6 +345,56 @@ uint64_t S3KeyReader::read(char* buf, uint64_t count) {
     return readLen;
 }
 
+// Zero-copy variant of read(): returns a lease into the current chunk buffer
+// covering everything the chunk has left, valid until the next call. Chunk
+// rotation, EOL appending and error propagation follow read().
+const char* S3KeyReader::readZeroCopy(uint64_t& len) {
+    uint64_t fileLen = this->offsetMgr.getKeySize();
+    const char* ptr = NULL;
+
+    do {
+        // confirm there is no more available data, done with this file
+        if (this->transferredKeyLen >= fileLen) {
+            if (!this->hasEol && !this->eolAppended) {
+                this->eolAppended = true;
+
+                len = strlen(eolString);
+                return eolString;
+            }
+
+            len = 0;
+            return NULL;
+        }
+
+        ChunkBuffer& buffer = chunkBuffers[this->curReadingChunk % this->numOfChunks];
+
+        ptr = buffer.readZeroCopy(len);
+
+        if (this->isSharedError()) {
+            if (this->sharedException != NULL) {
+                std::rethrow_exception(this->sharedException);
+            } else {
+                throw S3RuntimeError("Unexpected runtime error, sharedException is NULL");
+            }
+        }
+
+        this->transferredKeyLen += len;
+        if (this->transferredKeyLen == fileLen && len > 0) {
+            if (ptr[len - 1] == '\r' || ptr[len - 1] == '\n') {
+                this->hasEol = true;
+            }
+        }
+
+        // a lease drains its chunk, so an empty result means the chunk was
+        // recycled; move to the next one and retry
+        if (len == 0) {
+            this->curReadingChunk++;
+        }
+    } while (len == 0);
+
+    return ptr;
+}
+
 // reset marks before reading next key
 void S3KeyReader::reset() {
     this->sharedError = false;
@@ -60,6 +60,7 @@ void S3KeyWriter::checkQueryCancelSignal() {
             pthread_join(threadList[i], NULL);
         }
         this->threadList.clear();
+        this->finishedThreads.clear();
 
         // to avoid double unlock as other parts may lock it
         pthread_mutex_lock(&this->mutex);
@@ -101,6 +102,7 @@ void* S3KeyWriter::UploadThreadFunc(void* data) {
         if (!etag.empty()) {
             writer->etagList[params->currentNumber] = etag;
         }
+        writer->finishedThreads.push_back(pthread_self());
         writer->activeThreads--;
         pthread_cond_broadcast(&writer->cv);
         S3DEBUG("Upload part finish: %p, eTag: %s, part number: %" PRIu64, pthread_self(),
@@ -111,6 +113,11 @@ void* S3KeyWriter::UploadThreadFunc(void* data) {
         writer->sharedError = true;
         writer->sharedException = std::current_exception();
 
+        {
+            UniqueLock threadLock(&writer->mutex);
+            writer->finishedThreads.push_back(pthread_self());
+        }
+
         // notify the flushBuffer, otherwise it will be locked when trying to create a new thread.
         writer->activeThreads--;
         pthread_cond_broadcast(&writer->cv);
@@ -120,8 +127,40 @@ void* S3KeyWriter::UploadThreadFunc(void* data) {
     return NULL;
 }
 
+// Join upload threads that have already finished, so their stacks are
+// reclaimed while the upload is still in progress. Without this the writer
+// accumulates one dead, unjoined thread per uploaded part until close().
+void S3KeyWriter::reapFinishedThreads() {
+    vector<pthread_t> finished;
+
+    {
+        UniqueLock queueLock(&this->mutex);
+        finished.swap(this->finishedThreads);
+
+        // forget the reaped threads, otherwise the cancel and close paths
+        // would join them a second time
+        for (size_t i = 0; i < finished.size(); i++) {
+            for (vector<pthread_t>::iterator it = this->threadList.begin();
+                 it != this->threadList.end(); it++) {
+                if (pthread_equal(*it, finished[i])) {
+                    this->threadList.erase(it);
+                    break;
+                }
+            }
+        }
+    }
+
+    // join outside the lock; these threads have released it already, so the
+    // join returns immediately
+    for (size_t i = 0; i < finished.size(); i++) {
+        pthread_join(finished[i], NULL);
+    }
+}
+
 void S3KeyWriter::flushBuffer() {
     if (!this->buffer.empty()) {
+        this->reapFinishedThreads();
+
         UniqueLock queueLock(&this->mutex);
         while (this->activeThreads >= this->params.getNumOfChunks()) {
             pthread_cond_wait(&this->cv, &this->mutex);
@@ -154,6 +193,7 @@ void S3KeyWriter::completeKeyWriting() {
         pthread_join(threadList[i], NULL);
     }
     this->threadList.clear();
+    this->finishedThreads.clear();
 
     this->checkQueryCancelSignal();
 
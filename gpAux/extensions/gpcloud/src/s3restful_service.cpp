@@ -7,6 +7,7 @@ S3RESTfulService::S3RESTfulService()
       debugCurl(false),
       verifyCert(true),
       chunkBufferSize(64 * 1024) {
+    pthread_mutex_init(&this->handlePoolLock, NULL);
 }
 
 S3RESTfulService::S3RESTfulService(const string &proxy)
@@ -16,6 +17,7 @@ S3RESTfulService::S3RESTfulService(const string &proxy)
       debugCurl(false),
       verifyCert(true),
       chunkBufferSize(64 * 1024) {
+    pthread_mutex_init(&this->handlePoolLock, NULL);
 }
 
 S3RESTfulService::S3RESTfulService(const S3Params &params)
@@ -30,14 +32,56 @@ S3RESTfulService::S3RESTfulService(const S3Params &params)
     this->chunkBufferSize = params.getChunkSize();
     this->verifyCert = params.isVerifyCert();
     this->proxy = params.getProxy();
+
+    pthread_mutex_init(&this->handlePoolLock, NULL);
 }
 
 S3RESTfulService::~S3RESTfulService() {
+    for (size_t i = 0; i < this->idleCurlHandles.size(); i++) {
+        curl_easy_cleanup(this->idleCurlHandles[i]);
+    }
+    this->idleCurlHandles.clear();
+    pthread_mutex_destroy(&this->handlePoolLock);
+
     // This function is not thread safe, must NOT call it when any other
     // threads are running, that is, do NOT put it in threads.
     curl_global_cleanup();
 }
 
+// Hand out a pooled curl handle, or create one if the pool is empty. Reusing
+// handles instead of creating one per request lets consecutive requests to
+// the same endpoint ride existing keep-alive connections, which matters most
+// for scans over many small objects where TLS handshakes dominate.
+CURL *S3RESTfulService::acquireCurlHandle() {
+    CURL *curl = NULL;
+
+    pthread_mutex_lock(&this->handlePoolLock);
+    if (!this->idleCurlHandles.empty()) {
+        curl = this->idleCurlHandles.back();
+        this->idleCurlHandles.pop_back();
+    }
+    pthread_mutex_unlock(&this->handlePoolLock);
+
+    if (curl == NULL) {
+        curl = curl_easy_init();
+    }
+
+    return curl;
+}
+
+void S3RESTfulService::releaseCurlHandle(CURL *curl) {
+    if (curl == NULL) {
+        return;
+    }
+
+    // reset all options but keep the handle's connection cache alive
+    curl_easy_reset(curl);
+
+    pthread_mutex_lock(&this->handlePoolLock);
+    this->idleCurlHandles.push_back(curl);
+    pthread_mutex_unlock(&this->handlePoolLock);
+}
+
 // curl's write function callback.
 static size_t RESTfulServiceWriteFuncCallback(char *ptr, size_t size, size_t nmemb, void *userp) {
     if (S3QueryIsAbortInProgress()) {
@@ -95,11 +139,11 @@ static size_t RESTfulServiceReadFuncCallback(char *ptr, size_t size, size_t nmem
 }
 
 struct CURLWrapper {
-    CURLWrapper(const string &url, curl_slist *headers, uint64_t lowSpeedLimit,
-                uint64_t lowSpeedTime, bool debugCurl, string proxy) {
-        curl = curl_easy_init();
+    CURLWrapper(S3RESTfulService *service, const string &url, curl_slist *headers,
+                uint64_t lowSpeedLimit, uint64_t lowSpeedTime, bool debugCurl, string proxy)
+        : service(service) {
+        curl = service->acquireCurlHandle();
         curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_FORBID_REUSE, 1L);
         curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
         curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
         curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, lowSpeedLimit);
@@ -114,13 +158,63 @@ struct CURLWrapper {
         }
     }
     ~CURLWrapper() {
-        curl_easy_cleanup(curl);
+        service->releaseCurlHandle(curl);
     }
+    S3RESTfulService *service;
     CURL *curl;
 };
 
-void S3RESTfulService::performCurl(CURL *curl, Response &response) {
-    CURLcode res = curl_easy_perform(curl);
+// Drive the transfer through the curl multi interface instead of a blocking
+// curl_easy_perform(). The loop wakes up at least once a second, so a query
+// abort cancels a stalled transfer promptly instead of waiting out the
+// low-speed timeout. deleteRequest() passes abortable = false because it is
+// issued during query cancellation and must run to completion.
+void S3RESTfulService::performCurl(CURL *curl, Response &response, bool abortable) {
+    CURLM *multi = curl_multi_init();
+    S3_CHECK_OR_DIE(multi != NULL, S3ConnectionError, "Failed to initialize curl multi handle");
+
+    curl_multi_add_handle(multi, curl);
+
+    CURLcode res = CURLE_OK;
+    CURLMcode mres = CURLM_OK;
+    int runningHandles = 1;
+
+    while (runningHandles > 0) {
+        mres = curl_multi_perform(multi, &runningHandles);
+        if (mres != CURLM_OK || runningHandles == 0) {
+            break;
+        }
+
+        if (abortable && S3QueryIsAbortInProgress()) {
+            res = CURLE_ABORTED_BY_CALLBACK;
+            break;
+        }
+
+        int numfds = 0;
+        mres = curl_multi_wait(multi, NULL, 0, 1000, &numfds);
+        if (mres != CURLM_OK) {
+            break;
+        }
+    }
+
+    if (mres == CURLM_OK && res == CURLE_OK) {
+        int msgsLeft = 0;
+        CURLMsg *message = NULL;
+        while ((message = curl_multi_info_read(multi, &msgsLeft)) != NULL) {
+            if (message->msg == CURLMSG_DONE && message->easy_handle == curl) {
+                res = message->data.result;
+            }
+        }
+    }
+
+    // detach before the wrapper resets the easy handle back into the pool
+    curl_multi_remove_handle(multi, curl);
+    curl_multi_cleanup(multi);
+
+    if (mres != CURLM_OK) {
+        S3_DIE(S3ConnectionError, curl_multi_strerror(mres));
+    }
+
     if (res != CURLE_OK) {
         if (res == CURLE_COULDNT_RESOLVE_HOST || res == CURLE_COULDNT_RESOLVE_PROXY) {
             S3_DIE(S3ResolveError, curl_easy_strerror(res));
@@ -148,7 +242,7 @@ Response S3RESTfulService::get(const string &url, HTTPHeaders &headers) {
     response.getRawData().reserve(this->chunkBufferSize);
 
     headers.CreateList();
-    CURLWrapper wrapper(url, headers.GetList(), this->lowSpeedLimit, this->lowSpeedTime,
+    CURLWrapper wrapper(this, url, headers.GetList(), this->lowSpeedLimit, this->lowSpeedTime,
                         this->debugCurl, this->proxy);
     CURL *curl = wrapper.curl;
 
@@ -181,7 +275,7 @@ Response S3RESTfulService::put(const string &url, HTTPHeaders &headers, const S3
     Response response(RESPONSE_ERROR);
 
     headers.CreateList();
-    CURLWrapper wrapper(url, headers.GetList(), this->lowSpeedLimit, this->lowSpeedTime,
+    CURLWrapper wrapper(this, url, headers.GetList(), this->lowSpeedLimit, this->lowSpeedTime,
                         this->debugCurl, this->proxy);
     CURL *curl = wrapper.curl;
 
@@ -224,7 +318,7 @@ Response S3RESTfulService::post(const string &url, HTTPHeaders &headers,
     Response response(RESPONSE_ERROR);
 
     headers.CreateList();
-    CURLWrapper wrapper(url, headers.GetList(), this->lowSpeedLimit, this->lowSpeedTime,
+    CURLWrapper wrapper(this, url, headers.GetList(), this->lowSpeedLimit, this->lowSpeedTime,
                         this->debugCurl, this->proxy);
     CURL *curl = wrapper.curl;
 
@@ -269,7 +363,7 @@ ResponseCode S3RESTfulService::head(const string &url, HTTPHeaders &headers) {
     Response response(RESPONSE_ERROR);
 
     headers.CreateList();
-    CURLWrapper wrapper(url, headers.GetList(), this->lowSpeedLimit, this->lowSpeedTime,
+    CURLWrapper wrapper(this, url, headers.GetList(), this->lowSpeedLimit, this->lowSpeedTime,
                         this->debugCurl, this->proxy);
     CURL *curl = wrapper.curl;
 
@@ -302,7 +396,7 @@ Response S3RESTfulService::deleteRequest(const string &url, HTTPHeaders &headers
     Response response(RESPONSE_ERROR);
 
     headers.CreateList();
-    CURLWrapper wrapper(url, headers.GetList(), this->lowSpeedLimit, this->lowSpeedTime,
+    CURLWrapper wrapper(this, url, headers.GetList(), this->lowSpeedLimit, this->lowSpeedTime,
                         this->debugCurl, this->proxy);
     CURL *curl = wrapper.curl;
 
@@ -317,7 +411,7 @@ Response S3RESTfulService::deleteRequest(const string &url, HTTPHeaders &headers
     curl_easy_setopt(curl, CURLOPT_READFUNCTION, RESTfulServiceReadFuncCallback);
     curl_easy_setopt(curl, CURLOPT_INFILESIZE_LARGE, (curl_off_t)data.size());
 
-    this->performCurl(curl, response);
+    this->performCurl(curl, response, false);
 
     if (response.getStatus() == RESPONSE_OK) {
 	return response;
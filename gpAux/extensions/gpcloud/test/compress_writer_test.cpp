@@ -138,6 +138,58 @@ TEST_F(CompressWriterTest, AbleToCompressOneSmallString) {
     EXPECT_STREQ(input, (const char *)this->out);
 }
 
+TEST_F(CompressWriterTest, EmitsSyncPointPerChunkOfInput) {
+    const char pangram[] = "The quick brown fox jumps over the lazy dog";
+    uint64_t times = S3_ZIP_COMPRESS_CHUNKSIZE / (sizeof(pangram) - 1) + 1;
+
+    string input;
+    for (uint64_t i = 0; i < times; i++) input.append(pangram);
+
+    compressWriter.write(input.c_str(), input.length());
+
+    // a full flush ends with an empty stored block: 00 00 FF FF
+    const char marker[] = {0x00, 0x00, (char)0xff, (char)0xff};
+    const char *raw = writer.getRawData();
+    bool found = false;
+    for (size_t i = 0; i + sizeof(marker) <= writer.getDataSize(); i++) {
+        if (memcmp(raw + i, marker, sizeof(marker)) == 0) {
+            found = true;
+            break;
+        }
+    }
+    EXPECT_TRUE(found);
+
+    // the stream still round-trips across the sync point
+    compressWriter.close();
+
+    Byte *result = new Byte[input.length() + 1];
+    this->coreUncompress((Byte *)writer.getRawData(), writer.getDataSize(), result,
+                         input.length() + 1);
+
+    EXPECT_TRUE(memcmp(input.c_str(), result, input.length()) == 0);
+
+    delete[] result;
+}
+
+TEST_F(CompressWriterTest, AbleToCompressWithFastestLevel) {
+    const char input[] = "The quick brown fox jumps over the lazy dog";
+
+    // reopen with the fastest compression level; output must still be a
+    // well-formed gzip stream that round-trips
+    compressWriter.close();
+    writer.getRawDataVector().clear();
+
+    S3Params params("s3://abc/def/");
+    params.setCompressLevel(1);
+    compressWriter.open(params);
+
+    compressWriter.write(input, sizeof(input));
+    compressWriter.close();
+
+    this->simpleUncompress(writer.getRawData(), writer.getDataSize());
+    EXPECT_STREQ(input, (const char *)this->out);
+}
+
 TEST_F(CompressWriterTest, AbleToWriteServeralTimesBeforeClose) {
     unsigned int i, times = 100;
 
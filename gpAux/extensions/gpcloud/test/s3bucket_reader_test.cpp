@@ -148,6 +148,69 @@ TEST_F(S3BucketReaderTest, ReaderShouldSkipIfFileIsNotForThisSegment) {
     EXPECT_EQ((uint64_t)0, bucketReader->read(buf, sizeof(buf)));
 }
 
+TEST_F(S3BucketReaderTest, BigKeyBalancedToLeastLoadedSegment) {
+    // one 1000-byte key and three 10-byte keys over two segments: greedy size
+    // balancing gives the big key to segment 0 and everything else to segment 1
+    ListBucketResult result;
+    result.contents.emplace_back("big", 1000);
+    result.contents.emplace_back("a", 10);
+    result.contents.emplace_back("b", 10);
+    result.contents.emplace_back("c", 10);
+
+    S3Params params("https://s3-us-east-2.amazonaws.com/s3test.pivotal.io/whatever");
+
+    EXPECT_CALL(s3Interface, listBucket(_)).Times(1).WillOnce(Return(result));
+
+    EXPECT_CALL(s3Reader, read(_, _)).Times(2).WillOnce(Return(256)).WillOnce(Return(0));
+
+    EXPECT_CALL(s3Reader, open(_)).Times(1);
+
+    s3ext_segid = 0;
+    s3ext_segnum = 2;
+
+    bucketReader->open(params);
+    bucketReader->setUpstreamReader(&s3Reader);
+
+    EXPECT_EQ((uint64_t)256, bucketReader->read(buf, sizeof(buf)));
+    EXPECT_EQ((uint64_t)0, bucketReader->read(buf, sizeof(buf)));
+}
+
+TEST_F(S3BucketReaderTest, SmallKeysBalancedAwayFromBigKey) {
+    // the counterpart of BigKeyBalancedToLeastLoadedSegment: segment 1 owns
+    // the three small keys, in listing order
+    ListBucketResult result;
+    result.contents.emplace_back("big", 1000);
+    result.contents.emplace_back("a", 10);
+    result.contents.emplace_back("b", 10);
+    result.contents.emplace_back("c", 10);
+
+    S3Params params("https://s3-us-east-2.amazonaws.com/s3test.pivotal.io/whatever");
+
+    EXPECT_CALL(s3Interface, listBucket(_)).Times(1).WillOnce(Return(result));
+
+    EXPECT_CALL(s3Reader, read(_, _))
+        .Times(6)
+        .WillOnce(Return(10))
+        .WillOnce(Return(0))
+        .WillOnce(Return(10))
+        .WillOnce(Return(0))
+        .WillOnce(Return(10))
+        .WillOnce(Return(0));
+
+    EXPECT_CALL(s3Reader, open(_)).Times(3);
+
+    s3ext_segid = 1;
+    s3ext_segnum = 2;
+
+    bucketReader->open(params);
+    bucketReader->setUpstreamReader(&s3Reader);
+
+    EXPECT_EQ((uint64_t)10, bucketReader->read(buf, sizeof(buf)));
+    EXPECT_EQ((uint64_t)10, bucketReader->read(buf, sizeof(buf)));
+    EXPECT_EQ((uint64_t)10, bucketReader->read(buf, sizeof(buf)));
+    EXPECT_EQ((uint64_t)0, bucketReader->read(buf, sizeof(buf)));
+}
+
 TEST_F(S3BucketReaderTest, UpstreamReaderThrowException) {
     ListBucketResult result;
     result.contents.emplace_back("foo", 0);
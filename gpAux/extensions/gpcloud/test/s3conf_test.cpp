@@ -34,6 +34,10 @@ TEST(Config, Basic) {
     EXPECT_EQ("", params.getProxy());
 
     EXPECT_TRUE(params.isAutoCompress());
+    EXPECT_EQ(-1, params.getCompressLevel());
+    EXPECT_EQ((uint64_t)3, params.getRetryNum());
+    EXPECT_EQ((uint64_t)1000, params.getBackoffBaseMs());
+    EXPECT_EQ((uint64_t)30000, params.getBackoffCapMs());
     EXPECT_TRUE(params.isVerifyCert());
 
     EXPECT_EQ(SSE_S3, params.getSSEType());
@@ -73,6 +77,25 @@ TEST(Config, SpecialSwitches) {
 
     EXPECT_TRUE(params.isDebugCurl());
     EXPECT_FALSE(params.isAutoCompress());
+    EXPECT_EQ(1, params.getCompressLevel());
+}
+
+TEST(Config, UrlOptionOverrides) {
+    S3Params params = InitConfig(
+        "s3://abc/a config=data/s3test.conf section=default threadnum=2 chunksize=9437184 "
+        "retrynum=5");
+
+    EXPECT_EQ((uint64_t)2, params.getNumOfChunks());
+    EXPECT_EQ((uint64_t)9437184, params.getChunkSize());
+    EXPECT_EQ((uint64_t)5, params.getRetryNum());
+}
+
+TEST(Config, UrlOptionOverridesAreClamped) {
+    S3Params params =
+        InitConfig("s3://abc/a config=data/s3test.conf section=default threadnum=100 chunksize=1");
+
+    EXPECT_EQ((uint64_t)8, params.getNumOfChunks());
+    EXPECT_EQ((uint64_t)(8 * 1024 * 1024), params.getChunkSize());
 }
 
 TEST(Config, SectionExist) {
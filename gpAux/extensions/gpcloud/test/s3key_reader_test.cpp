@@ -216,6 +216,51 @@ TEST(OffsetMgr, reset) {
     EXPECT_EQ((uint64_t)0, o.getCurPos());
 }
 
+TEST(OffsetMgr, AdaptiveChunkSize) {
+    OffsetMgr o;
+    o.setKeySize(1024 * 1024 * 1024);
+    o.setChunkSize(64 * 1024 * 1024);
+    o.enableAdaptiveChunkSize();
+
+    // starts at the initial window, not the configured maximum
+    EXPECT_EQ((uint64_t)S3_ADAPTIVE_CHUNKSIZE_INITIAL, o.getChunkSize());
+
+    // fast successful fetches double the window up to the configured size
+    o.reportFetchResult(true, 1.0);
+    EXPECT_EQ((uint64_t)(16 * 1024 * 1024), o.getChunkSize());
+    o.reportFetchResult(true, 1.0);
+    o.reportFetchResult(true, 1.0);
+    EXPECT_EQ((uint64_t)(64 * 1024 * 1024), o.getChunkSize());
+    o.reportFetchResult(true, 1.0);
+    EXPECT_EQ((uint64_t)(64 * 1024 * 1024), o.getChunkSize());
+
+    // a failed fetch halves it
+    o.reportFetchResult(false, 1.0);
+    EXPECT_EQ((uint64_t)(32 * 1024 * 1024), o.getChunkSize());
+
+    // a slow fetch halves it as well
+    o.reportFetchResult(true, S3_ADAPTIVE_FETCH_SLOW_SECONDS + 1);
+    EXPECT_EQ((uint64_t)(16 * 1024 * 1024), o.getChunkSize());
+
+    // never shrinks below the minimum
+    for (int i = 0; i < 10; i++) {
+        o.reportFetchResult(false, 1.0);
+    }
+    EXPECT_EQ((uint64_t)S3_ADAPTIVE_CHUNKSIZE_MIN, o.getChunkSize());
+}
+
+TEST(OffsetMgr, AdaptiveChunkSizeDisabledForSmallChunks) {
+    OffsetMgr o;
+    o.setKeySize(4096);
+    o.setChunkSize(1000);
+    o.enableAdaptiveChunkSize();
+
+    // configured chunk size is below the initial window; nothing adapts
+    EXPECT_EQ((uint64_t)1000, o.getChunkSize());
+    o.reportFetchResult(false, 100.0);
+    EXPECT_EQ((uint64_t)1000, o.getChunkSize());
+}
+
 TEST_F(S3KeyReaderTest, OpenWithZeroChunk) {
     S3Params params("s3://abc/def");
 
@@ -290,6 +335,53 @@ TEST_F(S3KeyReaderTest, ReadWithSingleChunkNormalCase) {
     EXPECT_EQ((uint64_t)0, this->read(buffer, 32));
 }
 
+TEST_F(S3KeyReaderTest, ZeroCopyReadWithSingleChunk) {
+    S3Params params("s3://abc/def");
+    params.setNumOfChunks(1);
+    params.setKeySize(255);
+    params.setChunkSize(8192);
+
+    EXPECT_CALL(s3Interface, fetchData(_, _, _, _)).WillOnce(Invoke(MockFetchData(255, 8192)));
+
+    this->open(params);
+
+    uint64_t len = 0;
+
+    // whole chunk leased in one call, then the appended EOL, then EOF
+    EXPECT_NE((const char *)NULL, this->readZeroCopy(len));
+    EXPECT_EQ((uint64_t)255, len);
+    EXPECT_STREQ("\n", this->readZeroCopy(len));
+    EXPECT_EQ((uint64_t)1, len);
+    EXPECT_EQ((const char *)NULL, this->readZeroCopy(len));
+    EXPECT_EQ((uint64_t)0, len);
+}
+
+TEST_F(S3KeyReaderTest, ZeroCopyReadWithKeyLargerThanChunkSize) {
+    S3Params params("s3://abc/def");
+    params.setNumOfChunks(2);
+    params.setKeySize(255);
+    params.setChunkSize(64);
+
+    EXPECT_CALL(s3Interface, fetchData(_, _, _, _))
+        .WillOnce(Invoke(MockFetchData(64, 64)))
+        .WillOnce(Invoke(MockFetchData(64, 64)))
+        .WillOnce(Invoke(MockFetchData(64, 64)))
+        .WillOnce(Invoke(MockFetchData(63, 64)));
+
+    this->open(params);
+
+    uint64_t len = 0;
+    uint64_t total = 0;
+
+    while (this->readZeroCopy(len) != NULL) {
+        total += len;
+    }
+
+    // 255 bytes of data plus the appended EOL
+    EXPECT_EQ((uint64_t)256, total);
+    EXPECT_EQ((uint64_t)0, len);
+}
+
 TEST_F(S3KeyReaderTest, ReadWithSmallBuffer) {
     S3Params params("s3://abc/def");
 
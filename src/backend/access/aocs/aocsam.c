@@ -60,6 +60,13 @@ static AOCSScanDesc aocs_beginscan_internal(Relation relation,
 						Snapshot appendOnlyMetaDataSnapshot,
 						TupleDesc relationTupleDesc, bool *proj);
 
+/*
+ * Number of rows aocs_getnext's internal batch is sized for.  A batch
+ * never crosses a block boundary, so the actual row count per fill is
+ * bounded by the smallest current block among the projected columns.
+ */
+#define AOCS_BATCH_DEFAULT_ROWS 256
+
 /*
  * Open the segment file for a specified column associated with the datum
  * stream.
@@ -496,6 +503,15 @@ aocs_beginscan_internal(Relation relation,
 
 	scan->blockDirectory = NULL;
 
+	/*
+	 * Bulk-read rows through an internal batch that aocs_getnext drains.
+	 * The batch only carries the projected columns, so it needs at least
+	 * one; callers always project at least the first column.
+	 */
+	scan->batch = NULL;
+	if (gp_enable_aocs_batch_read && scan->num_proj_atts > 0)
+		scan->batch = aocs_batch_init(scan, AOCS_BATCH_DEFAULT_ROWS);
+
 	AppendOnlyVisimap_Init(&scan->visibilityMap,
 						   relation->rd_appendonly->visimaprelid,
 						   relation->rd_appendonly->visimapidxid,
@@ -511,6 +527,13 @@ aocs_rescan(AOCSScanDesc scan)
 	close_cur_scan_seg(scan);
 	close_ds_read(scan->ds, scan->relationTupleDesc->natts);
 	aocs_initscan(scan);
+
+	/* Throw away rows batched up from the previous pass. */
+	if (scan->batch)
+	{
+		scan->batch->numRows = 0;
+		scan->batch->curRow = 0;
+	}
 }
 
 void
@@ -526,6 +549,9 @@ aocs_endscan(AOCSScanDesc scan)
 	pfree(scan->proj_atts);
 	pfree(scan->ds);
 
+	if (scan->batch)
+		aocs_batch_finish(scan->batch);
+
 	for (i = 0; i < scan->total_seg; ++i)
 	{
 		if (scan->seginfo[i])
@@ -542,6 +568,212 @@ aocs_endscan(AOCSScanDesc scan)
 	pfree(scan);
 }
 
+/*
+ * Allocate a batch for bulk reads from the given scan.  Values / nulls
+ * vectors are only allocated for the scan's projected columns.
+ */
+AOCSBatch
+aocs_batch_init(AOCSScanDesc scan, int maxRows)
+{
+	AOCSBatch	batch;
+	int			nvp = scan->relationTupleDesc->natts;
+	int			i;
+
+	Assert(maxRows > 0);
+
+	batch = (AOCSBatch) palloc0(sizeof(AOCSBatchData));
+	batch->natts = nvp;
+	batch->maxRows = maxRows;
+
+	batch->values = (Datum **) palloc0(sizeof(Datum *) * nvp);
+	batch->nulls = (bool **) palloc0(sizeof(bool *) * nvp);
+	for (i = 0; i < scan->num_proj_atts; i++)
+	{
+		int			attno = scan->proj_atts[i];
+
+		batch->values[attno] = (Datum *) palloc(sizeof(Datum) * maxRows);
+		batch->nulls[attno] = (bool *) palloc(sizeof(bool) * maxRows);
+	}
+
+	batch->visible = (bool *) palloc(sizeof(bool) * maxRows);
+	batch->ctids = (ItemPointerData *) palloc(sizeof(ItemPointerData) * maxRows);
+
+	return batch;
+}
+
+void
+aocs_batch_finish(AOCSBatch batch)
+{
+	int			i;
+
+	/*
+	 * The values / nulls vectors were only allocated for the projected
+	 * columns; the other entries are NULL.
+	 */
+	for (i = 0; i < batch->natts; i++)
+	{
+		if (batch->values[i])
+			pfree(batch->values[i]);
+		if (batch->nulls[i])
+			pfree(batch->nulls[i]);
+	}
+
+	pfree(batch->values);
+	pfree(batch->nulls);
+	pfree(batch->visible);
+	pfree(batch->ctids);
+	pfree(batch);
+}
+
+/*
+ * Bulk form of aocs_getnext: fill the batch with the next run of rows,
+ * reading each projected column's vector in one pass over its datum
+ * stream.  A batch never crosses a block boundary, so all rows of a fill
+ * come from each column's current block and the per-column pass runs the
+ * block decode loop back to back.
+ *
+ * Rows that fail the visibility map check are included in the batch with
+ * batch->visible[] false; the caller must skip them.  Returns false when
+ * the scan is complete (and then leaves numRows == 0).
+ */
+bool
+aocs_getnext_batch(AOCSScanDesc scan, ScanDirection direction, AOCSBatch batch)
+{
+	int64		rowNum;
+	int			err = 0;
+	int			i;
+	int			n;
+	int			r;
+	bool		isSnapshotAny = (scan->snapshot == SnapshotAny);
+
+	Assert(ScanDirectionIsForward(direction));
+	Assert(scan->num_proj_atts > 0);
+
+	batch->numRows = 0;
+	batch->curRow = 0;
+
+	while (1)
+	{
+ReadNext:
+		/* If necessary, open next seg */
+		if (scan->cur_seg < 0 || err < 0)
+		{
+			err = open_next_scan_seg(scan);
+			if (err < 0)
+			{
+				/* No more seg, we are at the end */
+				scan->cur_seg = -1;
+				return false;
+			}
+			scan->cur_seg_row = 0;
+		}
+
+		Assert(scan->cur_seg >= 0);
+
+		rowNum = INT64CONST(-1);
+		n = batch->maxRows;
+
+		/*
+		 * First pass: position every projected column on the first row of
+		 * the batch, reading the next block where the current one is
+		 * exhausted, and cap the batch at the shortest current block.
+		 */
+		for (i = 0; i < scan->num_proj_atts; i++)
+		{
+			int			attno = scan->proj_atts[i];
+			int			avail;
+
+			err = datumstreamread_advance(scan->ds[attno]);
+			Assert(err >= 0);
+			if (err == 0)
+			{
+				err = datumstreamread_block(scan->ds[attno], scan->blockDirectory, attno);
+				if (err < 0)
+				{
+					/*
+					 * Ha, cannot read next block, we need to go to next seg
+					 */
+					close_cur_scan_seg(scan);
+					goto ReadNext;
+				}
+
+				err = datumstreamread_advance(scan->ds[attno]);
+				Assert(err > 0);
+			}
+
+			datumstreamread_get(scan->ds[attno],
+								&batch->values[attno][0],
+								&batch->nulls[attno][0]);
+
+			if (rowNum == INT64CONST(-1) &&
+				scan->ds[attno]->blockFirstRowNum != INT64CONST(-1))
+			{
+				Assert(scan->ds[attno]->blockFirstRowNum > 0);
+				rowNum = scan->ds[attno]->blockFirstRowNum +
+					datumstreamread_nth(scan->ds[attno]);
+			}
+
+			avail = 1 + datumstreamread_remaining(scan->ds[attno]);
+			if (avail < n)
+				n = avail;
+		}
+
+		/*
+		 * Second pass: bulk-fill the rest of each column's vector from its
+		 * current block.  The cap above guarantees the block has the rows.
+		 */
+		for (i = 0; i < scan->num_proj_atts; i++)
+		{
+			int			attno = scan->proj_atts[i];
+
+			if (n > 1)
+			{
+				int			filled;
+
+				filled = datumstreamread_getbatch(scan->ds[attno], n - 1,
+												  &batch->values[attno][1],
+												  &batch->nulls[attno][1]);
+				Assert(filled == n - 1);
+			}
+		}
+
+		/*
+		 * Row numbers are consecutive within a block, so the batch's rows
+		 * are rowNum, rowNum + 1, ... (or the plain segment row counter for
+		 * pre-4.0 blocks that do not store a first row number).
+		 */
+		for (r = 0; r < n; r++)
+		{
+			AOTupleId	aoTupleId;
+
+			AOTupleIdInit_Init(&aoTupleId);
+			AOTupleIdInit_segmentFileNum(&aoTupleId,
+										 scan->seginfo[scan->cur_seg]->segno);
+
+			scan->cur_seg_row++;
+			if (rowNum == INT64CONST(-1))
+			{
+				AOTupleIdInit_rowNum(&aoTupleId, scan->cur_seg_row);
+			}
+			else
+			{
+				AOTupleIdInit_rowNum(&aoTupleId, rowNum + r);
+			}
+
+			batch->visible[r] =
+				(isSnapshotAny ||
+				 AppendOnlyVisimap_IsVisible(&scan->visibilityMap, &aoTupleId));
+			batch->ctids[r] = *((ItemPointer) &aoTupleId);
+		}
+
+		batch->numRows = n;
+		return true;
+	}
+
+	Assert(!"Never here");
+	return false;
+}
+
 void
 aocs_getnext(AOCSScanDesc scan, ScanDirection direction, TupleTableSlot *slot)
 {
@@ -559,6 +791,46 @@ aocs_getnext(AOCSScanDesc scan, ScanDirection direction, TupleTableSlot *slot)
 	ncol = slot->tts_tupleDescriptor->natts;
 	Assert(ncol <= scan->relationTupleDesc->natts);
 
+	/*
+	 * With batch reads enabled, refill the scan's batch as needed and hand
+	 * out its rows one at a time.
+	 */
+	if (scan->batch != NULL)
+	{
+		AOCSBatch	batch = scan->batch;
+
+		while (1)
+		{
+			while (batch->curRow < batch->numRows)
+			{
+				int			r = batch->curRow++;
+
+				if (!batch->visible[r])
+					continue;
+
+				for (i = 0; i < scan->num_proj_atts; i++)
+				{
+					int			attno = scan->proj_atts[i];
+
+					d[attno] = batch->values[attno][r];
+					null[attno] = batch->nulls[attno][r];
+				}
+
+				scan->cdb_fake_ctid = batch->ctids[r];
+
+				TupSetVirtualTupleNValid(slot, ncol);
+				slot_set_ctid(slot, &(scan->cdb_fake_ctid));
+				return;
+			}
+
+			if (!aocs_getnext_batch(scan, direction, batch))
+			{
+				ExecClearTuple(slot);
+				return;
+			}
+		}
+	}
+
 	while (1)
 	{
 ReadNext:
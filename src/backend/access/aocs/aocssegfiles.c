@@ -234,9 +234,19 @@ GetAllAOCSFileSegInfo(Relation prel,
 {
 	Relation	pg_aocsseg_rel;
 	AOCSFileSegInfo **results;
+	Size		infoSize;
 
 	Assert(RelationIsAoCols(prel));
 
+	/*
+	 * Serve repeated reads under the same snapshot from the
+	 * transaction-local cache, sparing the heap scan of pg_aocsseg_*.
+	 */
+	infoSize = aocsfileseginfo_size(RelationGetNumberOfAttributes(prel));
+	if (AOSegFileInfoCacheLookup(prel, appendOnlyMetaDataSnapshot,
+								 infoSize, (void ***) &results, totalseg))
+		return results;
+
 	pg_aocsseg_rel = relation_open(prel->rd_appendonly->segrelid, AccessShareLock);
 
 	results = GetAllAOCSFileSegInfo_pg_aocsseg_rel(
@@ -248,6 +258,9 @@ GetAllAOCSFileSegInfo(Relation prel,
 
 	heap_close(pg_aocsseg_rel, AccessShareLock);
 
+	AOSegFileInfoCacheStore(prel, appendOnlyMetaDataSnapshot,
+							(void **) results, *totalseg, infoSize);
+
 	return results;
 }
 
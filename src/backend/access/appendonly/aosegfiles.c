@@ -25,6 +25,7 @@
 #include "access/aocssegfiles.h"
 #include "access/aosegfiles.h"
 #include "access/appendonlytid.h"
+#include "access/xact.h"
 #include "catalog/pg_appendonly_fn.h"
 #include "catalog/pg_type.h"
 #include "catalog/pg_proc.h"
@@ -38,10 +39,14 @@
 #include "storage/lmgr.h"
 #include "utils/acl.h"
 #include "utils/builtins.h"
+#include "utils/hsearch.h"
 #include "utils/int8.h"
+#include "utils/inval.h"
+#include "utils/memutils.h"
 #include "utils/syscache.h"
 #include "utils/fmgroids.h"
 #include "utils/numeric.h"
+#include "utils/tqual.h"
 #include "utils/visibility_summary.h"
 
 static Datum ao_compression_ratio_internal(Oid relid);
@@ -291,6 +296,318 @@ GetFileSegInfo(Relation parentrel, Snapshot appendOnlyMetaDataSnapshot, int segn
 }
 
 
+/* ------------------------------------------------------------------------
+ *
+ * TRANSACTION-LOCAL CACHE OF AO SEGMENT FILE CATALOG CONTENTS
+ *
+ * Every scan start reads the relation's pg_aoseg_* (or pg_aocsseg_*)
+ * rows to learn the segment file EOFs, and a query over many partitions
+ * pays for one heap scan of the aoseg relation per partition per scan.
+ * The result of such a read is purely a function of the snapshot it was
+ * taken under, so we keep a backend-local cache of the most recent read
+ * per relation, keyed by relation oid and validated against the full
+ * identity of the snapshot. Repeated reads under the same snapshot --
+ * rescans, joins and multi-scan queries over stable partitions -- are
+ * then served from memory.
+ *
+ * Only MVCC snapshot reads are cached; SnapshotNow and friends are used
+ * by writer and vacuum paths that must see up-to-the-minute state. The
+ * cache is dropped at (sub)transaction end and on relcache invalidation
+ * of a cached relation.
+ *
+ * ------------------------------------------------------------------------
+ */
+
+typedef struct AOSegFileInfoCacheEntry
+{
+	/* Append-only (parent) relation the segfile info belongs to. Hash key. */
+	Oid			relid;
+
+	/* Identity of the snapshot the result was read under. */
+	TransactionId snapXmin;
+	TransactionId snapXmax;
+	CommandId	snapCurcid;
+	uint32		snapXcnt;
+	TransactionId *snapXip;
+	int32		snapSubxcnt;
+	TransactionId *snapSubxip;
+	bool		snapSuboverflowed;
+	bool		snapHaveDistrib;
+	DistributedTransactionTimeStamp snapDistribTimeStamp;
+	DistributedSnapshotId snapDistribSnapshotId;
+
+	/* The cached segment file info, in segno order. */
+	int			totalsegs;
+	Size		infoSize;
+	void	  **seginfos;
+} AOSegFileInfoCacheEntry;
+
+static HTAB *AOSegFileInfoCache = NULL;
+static MemoryContext AOSegFileInfoCacheContext = NULL;
+
+/*
+ * Drop all cached segfile info. The hash table lives in the cache
+ * context, so resetting the context releases everything at once.
+ */
+static void
+AOSegFileInfoCacheReset(void)
+{
+	if (AOSegFileInfoCache == NULL)
+		return;
+
+	AOSegFileInfoCache = NULL;
+	MemoryContextReset(AOSegFileInfoCacheContext);
+}
+
+static void
+AOSegFileInfoCacheXactCallback(XactEvent event, void *arg)
+{
+	AOSegFileInfoCacheReset();
+}
+
+static void
+AOSegFileInfoCacheSubXactCallback(SubXactEvent event, SubTransactionId mySubid,
+								  SubTransactionId parentSubid, void *arg)
+{
+	/*
+	 * Aborting a subtransaction changes what an already-taken snapshot
+	 * sees of our own transaction's pg_aoseg updates, so throw away
+	 * everything read so far.
+	 */
+	if (event == SUBXACT_EVENT_ABORT_SUB)
+		AOSegFileInfoCacheReset();
+}
+
+static void
+AOSegFileInfoCacheRelcacheCallback(Datum arg, Oid relid)
+{
+	if (AOSegFileInfoCache == NULL)
+		return;
+
+	if (relid == InvalidOid)
+		AOSegFileInfoCacheReset();
+	else
+	{
+		/*
+		 * The removed entry's arrays stay in the cache context until the
+		 * next reset; they are small and bounded by the transaction.
+		 */
+		(void) hash_search(AOSegFileInfoCache, &relid, HASH_REMOVE, NULL);
+	}
+}
+
+static void
+AOSegFileInfoCacheInit(void)
+{
+	HASHCTL		info;
+
+	if (AOSegFileInfoCacheContext == NULL)
+	{
+		AOSegFileInfoCacheContext =
+			AllocSetContextCreate(TopMemoryContext,
+								  "AOSegFileInfoCache",
+								  ALLOCSET_SMALL_MINSIZE,
+								  ALLOCSET_SMALL_INITSIZE,
+								  ALLOCSET_DEFAULT_MAXSIZE);
+
+		RegisterXactCallback(AOSegFileInfoCacheXactCallback, NULL);
+		RegisterSubXactCallback(AOSegFileInfoCacheSubXactCallback, NULL);
+		CacheRegisterRelcacheCallback(AOSegFileInfoCacheRelcacheCallback,
+									  (Datum) 0);
+	}
+
+	MemSet(&info, 0, sizeof(info));
+	info.keysize = sizeof(Oid);
+	info.entrysize = sizeof(AOSegFileInfoCacheEntry);
+	info.hash = oid_hash;
+	info.hcxt = AOSegFileInfoCacheContext;
+
+	AOSegFileInfoCache = hash_create("AO segfile info cache", 16, &info,
+									 HASH_ELEM | HASH_FUNCTION | HASH_CONTEXT);
+}
+
+/*
+ * Does the given snapshot have exactly the same visibility as the one the
+ * cached result was read under?
+ */
+static bool
+AOSegFileInfoCacheSnapshotMatches(AOSegFileInfoCacheEntry *entry,
+								  Snapshot snapshot)
+{
+	if (entry->snapXmin != snapshot->xmin ||
+		entry->snapXmax != snapshot->xmax ||
+		entry->snapCurcid != snapshot->curcid ||
+		entry->snapXcnt != snapshot->xcnt ||
+		entry->snapSubxcnt != snapshot->subxcnt ||
+		entry->snapSuboverflowed != snapshot->suboverflowed ||
+		entry->snapHaveDistrib != snapshot->haveDistribSnapshot)
+		return false;
+
+	if (entry->snapXcnt > 0 &&
+		memcmp(entry->snapXip, snapshot->xip,
+			   entry->snapXcnt * sizeof(TransactionId)) != 0)
+		return false;
+
+	if (entry->snapSubxcnt > 0 &&
+		memcmp(entry->snapSubxip, snapshot->subxip,
+			   entry->snapSubxcnt * sizeof(TransactionId)) != 0)
+		return false;
+
+	if (entry->snapHaveDistrib &&
+		(entry->snapDistribTimeStamp !=
+		 snapshot->distribSnapshotWithLocalMapping.ds.distribTransactionTimeStamp ||
+		 entry->snapDistribSnapshotId !=
+		 snapshot->distribSnapshotWithLocalMapping.ds.distribSnapshotId))
+		return false;
+
+	return true;
+}
+
+/*
+ * AOSegFileInfoCacheLookup
+ *
+ * Look for cached segment file info for the relation, read under a
+ * snapshot with the same visibility as the given one. On a hit, set
+ * *seginfos to a freshly palloc'd copy that the caller owns (NULL when
+ * the cached result is empty), set *totalsegs, and return true.
+ */
+bool
+AOSegFileInfoCacheLookup(Relation parentrel,
+						 Snapshot appendOnlyMetaDataSnapshot,
+						 Size infoSize,
+						 void ***seginfos,
+						 int *totalsegs)
+{
+	Oid			relid = RelationGetRelid(parentrel);
+	AOSegFileInfoCacheEntry *entry;
+	void	  **result;
+	int			i;
+
+	if (AOSegFileInfoCache == NULL ||
+		appendOnlyMetaDataSnapshot == InvalidSnapshot ||
+		!IsMVCCSnapshot(appendOnlyMetaDataSnapshot))
+		return false;
+
+	entry = (AOSegFileInfoCacheEntry *)
+		hash_search(AOSegFileInfoCache, &relid, HASH_FIND, NULL);
+	if (entry == NULL ||
+		entry->infoSize != infoSize ||
+		!AOSegFileInfoCacheSnapshotMatches(entry, appendOnlyMetaDataSnapshot))
+		return false;
+
+	*totalsegs = entry->totalsegs;
+	if (entry->totalsegs == 0)
+	{
+		*seginfos = NULL;
+		return true;
+	}
+
+	result = (void **) palloc(entry->totalsegs * sizeof(void *));
+	for (i = 0; i < entry->totalsegs; i++)
+	{
+		result[i] = palloc(infoSize);
+		memcpy(result[i], entry->seginfos[i], infoSize);
+	}
+	*seginfos = result;
+
+	elogif(Debug_appendonly_print_scan, LOG,
+		   "Append-only segment file info cache hit for table '%s': %d segfiles",
+		   RelationGetRelationName(parentrel), entry->totalsegs);
+
+	return true;
+}
+
+/*
+ * AOSegFileInfoCacheStore
+ *
+ * Remember the segment file info just read for the relation, together
+ * with the identity of the snapshot it was read under. The cache keeps
+ * its own copy; the caller's arrays are untouched.
+ */
+void
+AOSegFileInfoCacheStore(Relation parentrel,
+						Snapshot appendOnlyMetaDataSnapshot,
+						void **seginfos,
+						int totalsegs,
+						Size infoSize)
+{
+	Oid			relid = RelationGetRelid(parentrel);
+	Snapshot	snapshot = appendOnlyMetaDataSnapshot;
+	AOSegFileInfoCacheEntry *entry;
+	MemoryContext oldcxt;
+	bool		found;
+	int			i;
+
+	if (snapshot == InvalidSnapshot || !IsMVCCSnapshot(snapshot))
+		return;
+
+	if (AOSegFileInfoCache == NULL)
+		AOSegFileInfoCacheInit();
+
+	entry = (AOSegFileInfoCacheEntry *)
+		hash_search(AOSegFileInfoCache, &relid, HASH_ENTER, &found);
+
+	/*
+	 * Replace an existing entry for the relation, freeing its arrays so
+	 * that repeatedly re-reading a relation within one transaction does
+	 * not bloat the cache context.
+	 */
+	if (found)
+	{
+		for (i = 0; i < entry->totalsegs; i++)
+			pfree(entry->seginfos[i]);
+		if (entry->seginfos != NULL)
+			pfree(entry->seginfos);
+		if (entry->snapXip != NULL)
+			pfree(entry->snapXip);
+		if (entry->snapSubxip != NULL)
+			pfree(entry->snapSubxip);
+	}
+
+	oldcxt = MemoryContextSwitchTo(AOSegFileInfoCacheContext);
+
+	entry->snapXmin = snapshot->xmin;
+	entry->snapXmax = snapshot->xmax;
+	entry->snapCurcid = snapshot->curcid;
+	entry->snapXcnt = snapshot->xcnt;
+	entry->snapXip = NULL;
+	if (snapshot->xcnt > 0)
+	{
+		entry->snapXip = palloc(snapshot->xcnt * sizeof(TransactionId));
+		memcpy(entry->snapXip, snapshot->xip,
+			   snapshot->xcnt * sizeof(TransactionId));
+	}
+	entry->snapSubxcnt = snapshot->subxcnt;
+	entry->snapSubxip = NULL;
+	if (snapshot->subxcnt > 0)
+	{
+		entry->snapSubxip = palloc(snapshot->subxcnt * sizeof(TransactionId));
+		memcpy(entry->snapSubxip, snapshot->subxip,
+			   snapshot->subxcnt * sizeof(TransactionId));
+	}
+	entry->snapSuboverflowed = snapshot->suboverflowed;
+	entry->snapHaveDistrib = snapshot->haveDistribSnapshot;
+	entry->snapDistribTimeStamp =
+		snapshot->distribSnapshotWithLocalMapping.ds.distribTransactionTimeStamp;
+	entry->snapDistribSnapshotId =
+		snapshot->distribSnapshotWithLocalMapping.ds.distribSnapshotId;
+
+	entry->infoSize = infoSize;
+	entry->totalsegs = totalsegs;
+	entry->seginfos = NULL;
+	if (totalsegs > 0)
+	{
+		entry->seginfos = (void **) palloc(totalsegs * sizeof(void *));
+		for (i = 0; i < totalsegs; i++)
+		{
+			entry->seginfos[i] = palloc(infoSize);
+			memcpy(entry->seginfos[i], seginfos[i], infoSize);
+		}
+	}
+
+	MemoryContextSwitchTo(oldcxt);
+}
+
 /*
  * GetAllFileSegInfo
  *
@@ -309,6 +626,15 @@ GetAllFileSegInfo(Relation parentrel,
 
 	Assert(RelationIsAoRows(parentrel));
 
+	/*
+	 * Serve repeated reads under the same snapshot from the
+	 * transaction-local cache, sparing the heap scan of pg_aoseg_*.
+	 */
+	if (AOSegFileInfoCacheLookup(parentrel, appendOnlyMetaDataSnapshot,
+								 sizeof(FileSegInfo),
+								 (void ***) &result, totalsegs))
+		return result;
+
 	pg_aoseg_rel = heap_open(parentrel->rd_appendonly->segrelid, AccessShareLock);
 
 	result = GetAllFileSegInfo_pg_aoseg_rel(
@@ -319,6 +645,9 @@ GetAllFileSegInfo(Relation parentrel,
 
 	heap_close(pg_aoseg_rel, AccessShareLock);
 
+	AOSegFileInfoCacheStore(parentrel, appendOnlyMetaDataSnapshot,
+							(void **) result, *totalsegs, sizeof(FileSegInfo));
+
 	return result;
 }
 
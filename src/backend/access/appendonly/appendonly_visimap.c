@@ -77,6 +77,18 @@ static void AppendOnlyVisimap_Find(
 					   AppendOnlyVisimap *visiMap,
 					   AOTupleId *tupleId);
 
+/*
+ * Invalidates the coverage cache of the inline visibility fast path.
+ * Must be called whenever the current visimap entry is changed or moved
+ * outside of AppendOnlyVisimap_IsVisibleInternal.
+ */
+static void
+AppendOnlyVisimap_InvalidateCache(AppendOnlyVisimap *visiMap)
+{
+	visiMap->cacheSegmentFileNum = -1;
+	visiMap->cacheBitmap = NULL;
+}
+
 /*
  * Finishes the visimap operations.
  * No other function should be called with the given
@@ -129,6 +141,8 @@ AppendOnlyVisimap_Init(
 	oldContext = MemoryContextSwitchTo(
 									   visiMap->memoryContext);
 
+	AppendOnlyVisimap_InvalidateCache(visiMap);
+
 	AppendOnlyVisimapEntry_Init(&visiMap->visimapEntry,
 								visiMap->memoryContext);
 
@@ -179,14 +193,15 @@ AppendOnlyVisimap_Find(
 }
 
 /*
- * Checks if a tuple is visible according to the visibility map.
- * A positive result is a necessary but not sufficient condition for
- * a tuple to be visible to the user.
+ * Out-of-line miss path of AppendOnlyVisimap_IsVisible (see the header
+ * for the inline fast path).  Repositions the visimap entry so that it
+ * covers the given tuple id, refreshes the coverage cache, and checks
+ * the visibility.
  *
  * Assumes that the visibility has been initialized and not finished.
  */
 bool
-AppendOnlyVisimap_IsVisible(
+AppendOnlyVisimap_IsVisibleInternal(
 							AppendOnlyVisimap *visiMap,
 							AOTupleId *aoTupleId)
 {
@@ -209,6 +224,17 @@ AppendOnlyVisimap_IsVisible(
 		AppendOnlyVisimap_Find(visiMap, aoTupleId);
 	}
 
+	/*
+	 * The entry now covers the aoTupleId; let the fast path answer for
+	 * the rest of its range.
+	 */
+	visiMap->cacheSegmentFileNum = visiMap->visimapEntry.segmentFileNum;
+	visiMap->cacheFirstRowNum = visiMap->visimapEntry.firstRowNum;
+	visiMap->cacheLastRowNum = visiMap->visimapEntry.firstRowNum +
+		APPENDONLY_VISIMAP_MAX_RANGE - 1;
+	visiMap->cacheBitmap = visiMap->visimapEntry.bitmap;
+	visiMap->cacheAllVisible = bms_is_empty(visiMap->visimapEntry.bitmap);
+
 	/* visimap entry is now positioned to cover the aoTupleId */
 	return AppendOnlyVisimapEntry_IsVisible(&visiMap->visimapEntry,
 											aoTupleId);
@@ -249,6 +275,8 @@ AppendOnlyVisimap_DeleteSegmentFile(
 	elogif(Debug_appendonly_print_visimap, LOG,
 		   "Delete visimap for segment file %d", segno);
 
+	AppendOnlyVisimap_InvalidateCache(visiMap);
+
 	AppendOnlyVisimapStore_DeleteSegmentFile(&visiMap->visimapStore,
 											 segno);
 }
@@ -261,6 +289,10 @@ AppendOnlyVisimap_GetRelationHiddenTupleCount(
 											  AppendOnlyVisimap *visiMap)
 {
 	Assert(visiMap);
+
+	/* the store scan below uses the visimap entry as scratch space */
+	AppendOnlyVisimap_InvalidateCache(visiMap);
+
 	return AppendOnlyVisimapStore_GetRelationHiddenTupleCount(
 															  &visiMap->visimapStore, &visiMap->visimapEntry);
 }
@@ -274,6 +306,10 @@ AppendOnlyVisimap_GetSegmentFileHiddenTupleCount(
 												 int segno)
 {
 	Assert(visiMap);
+
+	/* the store scan below uses the visimap entry as scratch space */
+	AppendOnlyVisimap_InvalidateCache(visiMap);
+
 	return AppendOnlyVisimapStore_GetSegmentFileHiddenTupleCount(
 																 &visiMap->visimapStore, &visiMap->visimapEntry, segno);
 }
@@ -696,6 +732,12 @@ AppendOnlyVisimapDelete_Hide(
 	visiMap = visiMapDelete->visiMap;
 	Assert(visiMap);
 
+	/*
+	 * Hiding a tuple moves and modifies the entry (and may reallocate its
+	 * bitmap) behind the visibility fast path's back.
+	 */
+	AppendOnlyVisimap_InvalidateCache(visiMap);
+
 	if (!AppendOnlyVisimapEntry_CoversTuple(&visiMap->visimapEntry,
 											aoTupleId))
 	{
@@ -826,6 +868,9 @@ AppendOnlyVisimapDelete_Finish(
 	visiMap = visiMapDelete->visiMap;
 	Assert(visiMap);
 
+	/* the write-back below rebuilds entries from the spill file */
+	AppendOnlyVisimap_InvalidateCache(visiMap);
+
 	elogif(Debug_appendonly_print_visimap, LOG, "Write-back all dirty visimap entries");
 
 	/*
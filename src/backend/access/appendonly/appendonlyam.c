@@ -30,6 +30,8 @@
  */
 #include "postgres.h"
 
+#include <fcntl.h>
+
 #include "access/aosegfiles.h"
 #include "access/appendonlytid.h"
 #include "access/appendonlywriter.h"
@@ -45,6 +47,7 @@
 #include "catalog/pg_appendonly.h"
 #include "catalog/pg_appendonly_fn.h"
 #include "catalog/pg_attribute_encoding.h"
+#include "catalog/pg_type.h"
 #include "cdb/cdbappendonlyam.h"
 #include "cdb/cdbappendonlystorage.h"
 #include "cdb/cdbappendonlystorageformat.h"
@@ -53,8 +56,10 @@
 #include "fmgr.h"
 #include "miscadmin.h"
 #include "pgstat.h"
+#include "storage/fd.h"
 #include "utils/datum.h"
 #include "utils/faultinjector.h"
+#include "utils/guc.h"
 #include "utils/lsyscache.h"
 #include "utils/memutils.h"
 
@@ -141,6 +146,50 @@ static void AppendOnlyExecutorReadBlock_Finish(
 static void AppendOnlyExecutorReadBlock_ResetCounts(
 										AppendOnlyExecutorReadBlock *executorReadBlock);
 
+/*
+ * Zone maps summarize the leading column of each varblock as an int64
+ * min/max pair kept in the block directory. Only types whose ordering is
+ * that of their binary integer representation qualify, so that scan-time
+ * comparisons need no per-type comparison functions.
+ */
+bool
+AppendOnlyZoneMap_TypeEligible(Oid typid)
+{
+	switch (typid)
+	{
+		case INT2OID:
+		case INT4OID:
+		case INT8OID:
+		case DATEOID:
+#ifdef HAVE_INT64_TIMESTAMP
+		case TIMESTAMPOID:
+		case TIMESTAMPTZOID:
+#endif
+			return true;
+		default:
+			return false;
+	}
+}
+
+/*
+ * Encode a datum of one of the eligible types as an order-preserving
+ * int64.
+ */
+static int64
+AppendOnlyZoneMap_DatumToInt64(Oid typid, Datum value)
+{
+	switch (typid)
+	{
+		case INT2OID:
+			return (int64) DatumGetInt16(value);
+		case INT4OID:
+		case DATEOID:
+			return (int64) DatumGetInt32(value);
+		default:
+			return DatumGetInt64(value);
+	}
+}
+
 /* ----------------
  *		initscan - scan code common to appendonly_beginscan and appendonly_rescan
  * ----------------
@@ -167,6 +216,59 @@ initscan(AppendOnlyScanDesc scan, ScanKey key)
 	pgstat_count_heap_scan(scan->aos_rd);
 }
 
+/*
+ * How much of the upcoming segment file to ask the kernel to read ahead
+ * when the scan opens a segment file.
+ */
+#define AO_NEXT_SEGFILE_PREFETCH_LEN (8 * 1024 * 1024)
+
+/*
+ * Hint the kernel to start reading the segment file the scan will need
+ * next, so that its leading blocks are already in the page cache by the
+ * time the current segment file has been consumed. A single backend
+ * reads the populated segment files strictly one after another; without
+ * the hint every file switch stalls until the device returns the first
+ * blocks of a file the kernel has never seen.
+ *
+ * The hint is fire-and-forget: the file is opened just long enough to
+ * issue posix_fadvise(WILLNEED) on its leading bytes and closed again
+ * (the page cache keeps the readahead). Failure to open is ignored; the
+ * real open will report it.
+ */
+static void
+PrefetchNextFileSegForRead(AppendOnlyScanDesc scan)
+{
+	Relation	reln = scan->aos_rd;
+	int			i;
+
+	if (!gp_appendonly_read_prefetch)
+		return;
+
+	for (i = scan->aos_segfiles_processed; i < scan->aos_total_segfiles; i++)
+	{
+		FileSegInfo *fsinfo = scan->aos_segfile_arr[i];
+		char		path[MAXPGPATH];
+		int32		fileSegNo;
+		File		file;
+
+		/* Same eligibility test that SetNextFileSegForRead applies. */
+		if (fsinfo->eof == 0 || fsinfo->state == AOSEG_STATE_AWAITING_DROP)
+			continue;
+
+		MakeAOSegmentFileName(reln, fsinfo->segno, -1, &fileSegNo, path);
+
+		file = PathNameOpenFile(path, O_RDONLY | PG_BINARY, 0400);
+		if (file < 0)
+			return;
+
+		FilePrefetch(file, 0,
+					 (int) Min(fsinfo->eof,
+							   (int64) AO_NEXT_SEGFILE_PREFETCH_LEN));
+		FileClose(file);
+		return;
+	}
+}
+
 /*
  * Open the next file segment to scan and allocate all resources needed for it.
  */
@@ -328,6 +430,12 @@ SetNextFileSegForRead(AppendOnlyScanDesc scan)
 								   formatversion,
 								   eof);
 
+	/*
+	 * With the current segment file open, overlap its consumption with
+	 * readahead of the next one.
+	 */
+	PrefetchNextFileSegForRead(scan);
+
 	AppendOnlyExecutionReadBlock_SetSegmentFileNum(
 												   &scan->executorReadBlock,
 												   segno);
@@ -1238,6 +1346,91 @@ AppendOnlyExecutorReadBlock_FetchTuple(AppendOnlyExecutorReadBlock *executorRead
 
 /* ------------------------------------------------------------------------------ */
 
+/*
+ * Check the zone map of the current block against the scan keys on the
+ * leading column. Returns true only when the block directory entry for
+ * exactly this block carries a valid zone map that proves no row in the
+ * block can satisfy the keys. All btree comparison operators are strict,
+ * so rows with a NULL leading column fail the keys as well and do not
+ * prevent skipping.
+ */
+static bool
+zoneMapCanSkipCurrentBlock(AppendOnlyScanDesc scan)
+{
+	AppendOnlyBlockDirectoryEntry directoryEntry;
+	AOTupleId	aoTupleId;
+	int			keyNo;
+
+	if (scan->zoneMapDirectory == NULL ||
+		scan->aos_nkeys == 0 ||
+		scan->executorReadBlock.rowCount <= 0)
+		return false;
+
+	AOTupleIdInit_Init(&aoTupleId);
+	AOTupleIdInit_segmentFileNum(&aoTupleId,
+								 scan->executorReadBlock.segmentFileNum);
+	AOTupleIdInit_rowNum(&aoTupleId,
+						 scan->executorReadBlock.blockFirstRowNum);
+
+	if (!AppendOnlyBlockDirectory_GetEntry(scan->zoneMapDirectory,
+										   &aoTupleId,
+										   0,
+										   &directoryEntry))
+		return false;
+
+	/*
+	 * Only trust the zone map when the directory entry describes exactly
+	 * this block. An entry stretched over several blocks, or the last
+	 * entry standing in for trailing unrecorded blocks, says nothing
+	 * about this block's values.
+	 */
+	if (!directoryEntry.zoneMapValid ||
+		directoryEntry.range.firstRowNum != scan->executorReadBlock.blockFirstRowNum)
+		return false;
+
+	for (keyNo = 0; keyNo < scan->aos_nkeys; keyNo++)
+	{
+		ScanKey		key = &scan->aos_key[keyNo];
+		int64		arg;
+
+		if (key->sk_attno != 1 ||
+			(key->sk_flags & SK_ISNULL) != 0)
+			continue;
+
+		arg = AppendOnlyZoneMap_DatumToInt64(scan->zoneMapTypid,
+											 key->sk_argument);
+
+		switch (key->sk_strategy)
+		{
+			case BTLessStrategyNumber:
+				if (directoryEntry.zoneMapMin >= arg)
+					return true;
+				break;
+			case BTLessEqualStrategyNumber:
+				if (directoryEntry.zoneMapMin > arg)
+					return true;
+				break;
+			case BTEqualStrategyNumber:
+				if (arg < directoryEntry.zoneMapMin ||
+					arg > directoryEntry.zoneMapMax)
+					return true;
+				break;
+			case BTGreaterEqualStrategyNumber:
+				if (directoryEntry.zoneMapMax < arg)
+					return true;
+				break;
+			case BTGreaterStrategyNumber:
+				if (directoryEntry.zoneMapMax <= arg)
+					return true;
+				break;
+			default:
+				break;
+		}
+	}
+
+	return false;
+}
+
 /*
  * You can think of this scan routine as get next "executor" AO block.
  */
@@ -1253,29 +1446,51 @@ getNextBlock(AppendOnlyScanDesc scan)
 			return false;
 	}
 
-	if (!AppendOnlyExecutorReadBlock_GetBlockInfo(
-												  &scan->storageRead,
-												  &scan->executorReadBlock))
+	for (;;)
 	{
+		if (!AppendOnlyExecutorReadBlock_GetBlockInfo(
+													  &scan->storageRead,
+													  &scan->executorReadBlock))
+		{
+			if (scan->blockDirectory)
+			{
+				AppendOnlyBlockDirectory_End_forInsert(scan->blockDirectory);
+			}
+
+			/* done reading the file */
+			CloseScannedFileSeg(scan);
+
+			return false;
+		}
+
 		if (scan->blockDirectory)
 		{
-			AppendOnlyBlockDirectory_End_forInsert(scan->blockDirectory);
+			AppendOnlyBlockDirectory_InsertEntry(
+												 scan->blockDirectory, 0,
+												 scan->executorReadBlock.blockFirstRowNum,
+												 scan->executorReadBlock.headerOffsetInFile,
+												 scan->executorReadBlock.rowCount,
+												 false);
 		}
 
-		/* done reading the file */
-		CloseScannedFileSeg(scan);
+		if (!zoneMapCanSkipCurrentBlock(scan))
+			break;
 
-		return false;
-	}
+		/*
+		 * The zone map proves no row in this block can pass the scan
+		 * keys; skip its content without reading it. Keep the row number
+		 * accounting current for blocks that do not store a firstRowNum.
+		 */
+		elogif(Debug_appendonly_print_scan, LOG,
+			   "Append-only scan zone map skip block for table '%s' "
+			   "(first row " INT64_FORMAT ", row count %d)",
+			   NameStr(scan->aos_rd->rd_rel->relname),
+			   scan->executorReadBlock.blockFirstRowNum,
+			   scan->executorReadBlock.rowCount);
 
-	if (scan->blockDirectory)
-	{
-		AppendOnlyBlockDirectory_InsertEntry(
-											 scan->blockDirectory, 0,
-											 scan->executorReadBlock.blockFirstRowNum,
-											 scan->executorReadBlock.headerOffsetInFile,
-											 scan->executorReadBlock.rowCount,
-											 false);
+		AppendOnlyStorageRead_SkipCurrentBlock(&scan->storageRead);
+		AppendOnlyExecutionReadBlock_FinishedScanBlock(
+													   &scan->executorReadBlock);
 	}
 
 	AppendOnlyExecutorReadBlock_GetContents(
@@ -1421,6 +1636,12 @@ setupNextWriteBlock(AppendOnlyInsertDesc aoInsertDesc)
 	}
 
 	aoInsertDesc->bufferCount++;
+
+	/* Start collecting the zone map for the new block from scratch. */
+	aoInsertDesc->blockZoneValid = false;
+	aoInsertDesc->blockZoneHasNulls = false;
+	aoInsertDesc->blockZoneMin = 0;
+	aoInsertDesc->blockZoneMax = 0;
 }
 
 static void
@@ -1530,6 +1751,16 @@ finishWriteBlock(AppendOnlyInsertDesc aoInsertDesc)
 										 itemCount,
 										 false);
 
+	/* Publish the zone map collected for this block, if any. */
+	if (aoInsertDesc->zoneMapCollect && aoInsertDesc->blockZoneValid)
+		AppendOnlyBlockDirectory_SetLastEntryZoneMap(
+													 &aoInsertDesc->blockDirectory,
+													 0,
+													 aoInsertDesc->blockFirstRowNum,
+													 aoInsertDesc->blockZoneMin,
+													 aoInsertDesc->blockZoneMax,
+													 aoInsertDesc->blockZoneHasNulls);
+
 	Assert(aoInsertDesc->nonCompressedData == NULL);
 	Assert(!AppendOnlyStorageWrite_IsBufferAllocated(&aoInsertDesc->storageWrite));
 }
@@ -1653,6 +1884,42 @@ appendonly_beginrangescan_internal(Relation relation,
 						   AccessShareLock,
 						   appendOnlyMetaDataSnapshot);
 
+	/*
+	 * Open the block directory for zone map lookups when the scan carries
+	 * scan keys the zone maps can answer for the leading column.
+	 */
+	scan->zoneMapDirectory = NULL;
+	scan->zoneMapTypid = InvalidOid;
+	if (gp_enable_ao_zonemaps && nkeys > 0 &&
+		OidIsValid(relation->rd_appendonly->blkdirrelid) &&
+		RelationGetDescr(relation)->natts > 0)
+	{
+		Form_pg_attribute leadAttr = RelationGetDescr(relation)->attrs[0];
+
+		if (!leadAttr->attisdropped &&
+			AppendOnlyZoneMap_TypeEligible(leadAttr->atttypid))
+		{
+			AppendOnlyBlockDirectory *zoneMapDir =
+			palloc0(sizeof(AppendOnlyBlockDirectory));
+
+			AppendOnlyBlockDirectory_Init_forSearch(zoneMapDir,
+													appendOnlyMetaDataSnapshot,
+													scan->aos_segfile_arr,
+													scan->aos_total_segfiles,
+													relation,
+													1,	/* numColumnGroups */
+													false,
+													NULL);
+			if (zoneMapDir->blkdirRel != NULL)
+			{
+				scan->zoneMapDirectory = zoneMapDir;
+				scan->zoneMapTypid = leadAttr->atttypid;
+			}
+			else
+				pfree(zoneMapDir);
+		}
+	}
+
 	return scan;
 }
 
@@ -1777,6 +2044,14 @@ appendonly_endscan(AppendOnlyScanDesc scan)
 	AppendOnlyExecutorReadBlock_Finish(&scan->executorReadBlock);
 
 	AppendOnlyVisimap_Finish(&scan->visibilityMap, AccessShareLock);
+
+	if (scan->zoneMapDirectory != NULL)
+	{
+		AppendOnlyBlockDirectory_End_forSearch(scan->zoneMapDirectory);
+		pfree(scan->zoneMapDirectory);
+		scan->zoneMapDirectory = NULL;
+	}
+
 	pfree(scan->aos_filenamepath);
 
 	pfree(scan->title);
@@ -2789,6 +3064,27 @@ aoInsertDesc->appendOnlyMetaDataSnapshot, //CONCERN:Safe to assume all block dir
 											aoInsertDesc->fsInfo, aoInsertDesc->lastSequence,
 											rel, segno, 1, false);
 
+	/*
+	 * Decide whether to collect a leading-column zone map for each
+	 * varblock. This requires a block directory to store it in and a
+	 * leading column whose type the zone map machinery understands.
+	 */
+	aoInsertDesc->zoneMapCollect = false;
+	aoInsertDesc->zoneMapTypid = InvalidOid;
+	if (gp_enable_ao_zonemaps &&
+		aoInsertDesc->blockDirectory.blkdirRel != NULL &&
+		RelationGetDescr(rel)->natts > 0)
+	{
+		Form_pg_attribute leadAttr = RelationGetDescr(rel)->attrs[0];
+
+		if (!leadAttr->attisdropped &&
+			AppendOnlyZoneMap_TypeEligible(leadAttr->atttypid))
+		{
+			aoInsertDesc->zoneMapCollect = true;
+			aoInsertDesc->zoneMapTypid = leadAttr->atttypid;
+		}
+	}
+
 	return aoInsertDesc;
 }
 
@@ -3019,6 +3315,32 @@ appendonly_insert(AppendOnlyInsertDesc aoInsertDesc,
 		setupNextWriteBlock(aoInsertDesc);
 	}
 
+	/*
+	 * Fold the tuple's leading column into the current block's zone map.
+	 * A large tuple is accumulated into the block set up after it, whose
+	 * directory entry covers the large tuple's row number.
+	 */
+	if (aoInsertDesc->zoneMapCollect)
+	{
+		Datum		value;
+		bool		isnull;
+
+		value = memtuple_getattr(tup, aoInsertDesc->mt_bind, 1, &isnull);
+		if (isnull)
+			aoInsertDesc->blockZoneHasNulls = true;
+		else
+		{
+			int64		encoded =
+			AppendOnlyZoneMap_DatumToInt64(aoInsertDesc->zoneMapTypid, value);
+
+			if (!aoInsertDesc->blockZoneValid || encoded < aoInsertDesc->blockZoneMin)
+				aoInsertDesc->blockZoneMin = encoded;
+			if (!aoInsertDesc->blockZoneValid || encoded > aoInsertDesc->blockZoneMax)
+				aoInsertDesc->blockZoneMax = encoded;
+			aoInsertDesc->blockZoneValid = true;
+		}
+	}
+
 	aoInsertDesc->insertCount++;
 	if (!aoInsertDesc->update_mode)
 		pgstat_count_heap_insert(relation);
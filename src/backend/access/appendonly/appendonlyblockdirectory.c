@@ -29,6 +29,12 @@
 int			gp_blockdirectory_entry_min_range = 0;
 int			gp_blockdirectory_minipage_size = NUM_MINIPAGE_ENTRIES;
 
+/*
+ * Number of slots in the per-scan cache of recently decoded minipages
+ * kept by search-mode block directories.
+ */
+#define NUM_MINIPAGE_CACHE_SLOTS 16
+
 static inline uint32
 minipage_size(uint32 nEntry)
 {
@@ -36,6 +42,33 @@ minipage_size(uint32 nEntry)
 		sizeof(MinipageEntry) * nEntry;
 }
 
+/*
+ * Size of a minipage that carries a zone map array after the entries
+ * (version MINIPAGE_VERSION_ZONEMAP).
+ */
+static inline uint32
+minipage_size_with_zonemap(uint32 nEntry)
+{
+	return minipage_size(nEntry) +
+		sizeof(MinipageZoneMapEntry) * nEntry;
+}
+
+/*
+ * swap_minipage
+ *
+ * Exchange the decoded minipages held by two MinipagePerColumnGroups.
+ * Only pointers move; no minipage content is copied.
+ */
+static inline void
+swap_minipage(MinipagePerColumnGroup *a, MinipagePerColumnGroup *b)
+{
+	MinipagePerColumnGroup tmp;
+
+	tmp = *a;
+	*a = *b;
+	*b = tmp;
+}
+
 static void load_last_minipage(
 				   AppendOnlyBlockDirectory *blockDirectory,
 				   int64 lastSequence,
@@ -62,6 +95,15 @@ static bool insert_new_entry(AppendOnlyBlockDirectory *blockDirectory,
 				 int64 fileOffset,
 				 int64 rowCount,
 				 bool addColAction);
+static MinipageCacheSlot *minipage_cache_lookup(
+					  AppendOnlyBlockDirectory *blockDirectory,
+					  int segmentFileNum,
+					  int columnGroupNo,
+					  int64 rowNum,
+					  int *entry_no);
+static void minipage_cache_stash(
+					 AppendOnlyBlockDirectory *blockDirectory,
+					 int columnGroupNo);
 
 void
 AppendOnlyBlockDirectoryEntry_GetBeginRange(
@@ -150,10 +192,19 @@ init_internal(AppendOnlyBlockDirectory *blockDirectory)
 		&blockDirectory->minipages[groupNo];
 
 		minipageInfo->minipage =
-			palloc0(minipage_size(NUM_MINIPAGE_ENTRIES));
+			palloc0(minipage_size_with_zonemap(NUM_MINIPAGE_ENTRIES));
 		minipageInfo->numMinipageEntries = 0;
+		minipageInfo->zoneMapEntries =
+			palloc0(sizeof(MinipageZoneMapEntry) * NUM_MINIPAGE_ENTRIES);
+		minipageInfo->segmentFileNum = -1;
+		minipageInfo->segmentFileInfo = NULL;
 	}
 
+	/* Search-mode directories set up the minipage cache afterwards. */
+	blockDirectory->minipageCache = NULL;
+	blockDirectory->numMinipageCacheSlots = 0;
+	blockDirectory->minipageCacheUseCount = 0;
+
 	MemoryContextSwitchTo(oldcxt);
 }
 
@@ -214,6 +265,18 @@ AppendOnlyBlockDirectory_Init_forSearch(
 		index_open(aoRel->rd_appendonly->blkdiridxid, AccessShareLock);
 
 	init_internal(blockDirectory);
+
+	/*
+	 * Lookups keep a small LRU cache of decoded minipages, so that fetches
+	 * whose TIDs move back and forth between directory ranges or segment
+	 * files do not probe the block directory btree again for ranges that
+	 * were already decoded. The slot buffers are allocated lazily, the
+	 * first time a minipage is stashed.
+	 */
+	blockDirectory->numMinipageCacheSlots = NUM_MINIPAGE_CACHE_SLOTS;
+	blockDirectory->minipageCache =
+		MemoryContextAllocZero(blockDirectory->memoryContext,
+							   NUM_MINIPAGE_CACHE_SLOTS * sizeof(MinipageCacheSlot));
 }
 
 /*
@@ -357,7 +420,7 @@ set_directoryentry_range(
 
 	Assert(entry_no >= 0 && ((uint32) entry_no) < minipageInfo->numMinipageEntries);
 
-	fsInfo = blockDirectory->currentSegmentFileInfo;
+	fsInfo = minipageInfo->segmentFileInfo;
 	Assert(fsInfo != NULL);
 
 	if (blockDirectory->isAOCol)
@@ -391,6 +454,16 @@ set_directoryentry_range(
 		}
 	}
 
+	/*
+	 * Copy out the zone map for the entry, if one was recorded.
+	 */
+	directoryEntry->zoneMapValid =
+		((minipageInfo->zoneMapEntries[entry_no].flags & MINIPAGE_ZONEMAP_VALID) != 0);
+	directoryEntry->zoneMapHasNulls =
+		((minipageInfo->zoneMapEntries[entry_no].flags & MINIPAGE_ZONEMAP_HASNULLS) != 0);
+	directoryEntry->zoneMapMin = minipageInfo->zoneMapEntries[entry_no].zoneMin;
+	directoryEntry->zoneMapMax = minipageInfo->zoneMapEntries[entry_no].zoneMax;
+
 	directoryEntry->range.lastRowNum = entry->firstRowNum + entry->rowCount - 1;
 	if (next_entry == NULL && gp_blockdirectory_entry_min_range != 0)
 	{
@@ -489,16 +562,16 @@ AppendOnlyBlockDirectory_GetEntry(
 					  columnGroupNo, segmentFileNum, rowNum)));
 
 	/*
-	 * If the segment file number is the same as
-	 * blockDirectory->currentSegmentFileNum, the in-memory minipage may
-	 * contain such an entry. We search the in-memory minipage first. If such
-	 * an entry can not be found, we search for the appropriate minipage by
-	 * using the block directory btree index.
+	 * If the in-memory minipage for this column group was decoded from the
+	 * requested segment file, it may contain such an entry. We search the
+	 * in-memory minipage first, then the cache of recently used minipages.
+	 * If such an entry can not be found, we search for the appropriate
+	 * minipage by using the block directory btree index.
 	 */
-	if (segmentFileNum == blockDirectory->currentSegmentFileNum &&
+	if (segmentFileNum == minipageInfo->segmentFileNum &&
 		minipageInfo->numMinipageEntries > 0)
 	{
-		Assert(blockDirectory->currentSegmentFileInfo != NULL);
+		Assert(minipageInfo->segmentFileInfo != NULL);
 
 		MinipageEntry *firstentry =
 		&minipageInfo->minipage->entry[0];
@@ -514,6 +587,15 @@ AppendOnlyBlockDirectory_GetEntry(
 										   rowNum);
 			if (entry_no != -1)
 			{
+				/*
+				 * Keep the directory-wide current segment file fields in
+				 * step with the entry we return; callers use them to
+				 * validate their cached directory entries.
+				 */
+				blockDirectory->currentSegmentFileNum = segmentFileNum;
+				blockDirectory->currentSegmentFileInfo =
+					minipageInfo->segmentFileInfo;
+
 				return set_directoryentry_range(blockDirectory,
 												columnGroupNo,
 												entry_no,
@@ -539,6 +621,42 @@ AppendOnlyBlockDirectory_GetEntry(
 		}
 	}
 
+	/*
+	 * Next, check whether a recently used minipage has an entry covering
+	 * the rowNum, before paying for a btree probe of the block directory.
+	 */
+	if (blockDirectory->minipageCache != NULL)
+	{
+		MinipageCacheSlot *slot;
+
+		slot = minipage_cache_lookup(blockDirectory, segmentFileNum,
+									 columnGroupNo, rowNum, &entry_no);
+		if (slot != NULL)
+		{
+			/*
+			 * Trade the cached minipage for the current one; the minipage
+			 * being displaced stays behind in the slot for later lookups.
+			 */
+			swap_minipage(minipageInfo, &slot->minipageInfo);
+			slot->lastUseCount = ++blockDirectory->minipageCacheUseCount;
+
+			blockDirectory->currentSegmentFileNum = segmentFileNum;
+			blockDirectory->currentSegmentFileInfo =
+				minipageInfo->segmentFileInfo;
+
+			ereportif(Debug_appendonly_print_blockdirectory, LOG,
+					  (errmsg("Append-only block directory minipage cache hit: "
+							  "(columnGroupNo, segmentFileNum, rowNum) = "
+							  "(%d, %d, " INT64_FORMAT ")",
+							  columnGroupNo, segmentFileNum, rowNum)));
+
+			return set_directoryentry_range(blockDirectory,
+											columnGroupNo,
+											entry_no,
+											directoryEntry);
+		}
+	}
+
 	for (i = 0; i < blockDirectory->totalSegfiles; i++)
 	{
 		fsInfo = blockDirectory->segmentFileInfo[i];
@@ -594,6 +712,14 @@ AppendOnlyBlockDirectory_GetEntry(
 			blockDirectory->currentSegmentFileNum = segmentFileNum;
 			blockDirectory->currentSegmentFileInfo = fsInfo;
 
+			/*
+			 * Keep the minipage being displaced around in the cache; TIDs
+			 * that fall back into its range can then be resolved without
+			 * re-probing the btree.
+			 */
+			if (blockDirectory->minipageCache != NULL)
+				minipage_cache_stash(blockDirectory, tmpGroupNo);
+
 			extract_minipage(blockDirectory,
 							 tuple,
 							 heapTupleDesc,
@@ -748,6 +874,15 @@ insert_new_entry(
 						  entry->firstRowNum, columnGroupNo, entry->fileOffset,
 						  firstRowNum - entry->firstRowNum)));
 
+		/*
+		 * If the entry gets stretched to cover rows past the block it was
+		 * recorded for (new entries skipped because of
+		 * gp_blockdirectory_entry_min_range), its zone map no longer
+		 * summarizes all rows in the range, so throw it away.
+		 */
+		if (entry->rowCount != firstRowNum - entry->firstRowNum)
+			minipageInfo->zoneMapEntries[lastEntryNo].flags = 0;
+
 		entry->rowCount = firstRowNum - entry->firstRowNum;
 	}
 
@@ -763,6 +898,8 @@ insert_new_entry(
 		 */
 		MemSet(minipageInfo->minipage->entry, 0,
 			   minipageInfo->numMinipageEntries * sizeof(MinipageEntry));
+		MemSet(minipageInfo->zoneMapEntries, 0,
+			   minipageInfo->numMinipageEntries * sizeof(MinipageZoneMapEntry));
 		minipageInfo->numMinipageEntries = 0;
 	}
 
@@ -773,6 +910,10 @@ insert_new_entry(
 	entry->fileOffset = fileOffset;
 	entry->rowCount = rowCount;
 
+	/* No zone map until the caller provides one. */
+	MemSet(&minipageInfo->zoneMapEntries[minipageInfo->numMinipageEntries], 0,
+		   sizeof(MinipageZoneMapEntry));
+
 	minipageInfo->numMinipageEntries++;
 
 	ereportif(Debug_appendonly_print_blockdirectory, LOG,
@@ -785,6 +926,57 @@ insert_new_entry(
 	return true;
 }
 
+/*
+ * AppendOnlyBlockDirectory_SetLastEntryZoneMap
+ *
+ * Attach a zone map (min/max of the leading column) to the entry that was
+ * just inserted for the block starting at firstRowNum. If the latest
+ * in-memory entry does not describe exactly that block -- for example
+ * because the entry was suppressed or stretched due to
+ * gp_blockdirectory_entry_min_range -- the zone map is dropped, leaving
+ * the entry unprunable, which is always safe.
+ */
+void
+AppendOnlyBlockDirectory_SetLastEntryZoneMap(
+											 AppendOnlyBlockDirectory *blockDirectory,
+											 int columnGroupNo,
+											 int64 firstRowNum,
+											 int64 zoneMin,
+											 int64 zoneMax,
+											 bool hasNulls)
+{
+	MinipagePerColumnGroup *minipageInfo;
+	MinipageEntry *entry;
+	MinipageZoneMapEntry *zoneEntry;
+	int			lastEntryNo;
+
+	if (blockDirectory->blkdirRel == NULL ||
+		blockDirectory->blkdirIdx == NULL)
+		return;
+
+	minipageInfo = &blockDirectory->minipages[columnGroupNo];
+	lastEntryNo = minipageInfo->numMinipageEntries - 1;
+	if (lastEntryNo < 0)
+		return;
+
+	entry = &(minipageInfo->minipage->entry[lastEntryNo]);
+	if (entry->firstRowNum != firstRowNum)
+		return;
+
+	zoneEntry = &minipageInfo->zoneMapEntries[lastEntryNo];
+	zoneEntry->zoneMin = zoneMin;
+	zoneEntry->zoneMax = zoneMax;
+	zoneEntry->flags = MINIPAGE_ZONEMAP_VALID;
+	if (hasNulls)
+		zoneEntry->flags |= MINIPAGE_ZONEMAP_HASNULLS;
+
+	ereportif(Debug_appendonly_print_blockdirectory, LOG,
+			  (errmsg("Append-only block directory set entry zone map: "
+					  "(firstRowNum, columnGroupNo, zoneMin, zoneMax, hasNulls) = ("
+					  INT64_FORMAT ", %d, " INT64_FORMAT ", " INT64_FORMAT ", %d)",
+					  firstRowNum, columnGroupNo, zoneMin, zoneMax, hasNulls)));
+}
+
 /*
  * AppendOnlyBlockDirectory_DeleteSegmentFile
  *
@@ -914,15 +1106,36 @@ copy_out_minipage(MinipagePerColumnGroup *minipageInfo,
 	value = (struct varlena *)
 		DatumGetPointer(minipage_value);
 	detoast_value = pg_detoast_datum(value);
-	Assert(VARSIZE(detoast_value) <= minipage_size(NUM_MINIPAGE_ENTRIES));
+	Assert(VARSIZE(detoast_value) <= minipage_size_with_zonemap(NUM_MINIPAGE_ENTRIES));
 
 	memcpy(minipageInfo->minipage, detoast_value, VARSIZE(detoast_value));
-	if (detoast_value != value)
-		pfree(detoast_value);
 
 	Assert(minipageInfo->minipage->nEntry <= NUM_MINIPAGE_ENTRIES);
 
 	minipageInfo->numMinipageEntries = minipageInfo->minipage->nEntry;
+
+	/*
+	 * Pick up the zone map array following the entries, if this minipage
+	 * was written with one. Minipages written before zone maps existed
+	 * (version 0) simply leave all entries unprunable.
+	 */
+	if (minipageInfo->minipage->version >= MINIPAGE_VERSION_ZONEMAP &&
+		VARSIZE(detoast_value) >=
+		minipage_size_with_zonemap(minipageInfo->minipage->nEntry))
+	{
+		memcpy(minipageInfo->zoneMapEntries,
+			   ((char *) detoast_value) +
+			   minipage_size(minipageInfo->minipage->nEntry),
+			   sizeof(MinipageZoneMapEntry) * minipageInfo->minipage->nEntry);
+	}
+	else
+	{
+		MemSet(minipageInfo->zoneMapEntries, 0,
+			   sizeof(MinipageZoneMapEntry) * NUM_MINIPAGE_ENTRIES);
+	}
+
+	if (detoast_value != value)
+		pfree(detoast_value);
 }
 
 
@@ -963,6 +1176,13 @@ extract_minipage(AppendOnlyBlockDirectory *blockDirectory,
 
 	ItemPointerCopy(&tuple->t_self, &minipageInfo->tupleTid);
 
+	/*
+	 * Remember which segment file the minipage was decoded from, so that
+	 * its validity can be judged per column group.
+	 */
+	minipageInfo->segmentFileNum = blockDirectory->currentSegmentFileNum;
+	minipageInfo->segmentFileInfo = fsInfo;
+
 	/*
 	 * When crashes during inserts, or cancellation during inserts, there are
 	 * out-of-date minipage entries in the block directory. We reset those
@@ -1123,6 +1343,100 @@ find_minipage_entry(Minipage *minipage,
 		return -1;
 }
 
+/*
+ * minipage_cache_lookup
+ *
+ * Find a cached minipage for the given segment file and column group
+ * that has an entry covering rowNum. On a hit, *entry_no is set and the
+ * slot is returned. Otherwise, NULL is returned.
+ */
+static MinipageCacheSlot *
+minipage_cache_lookup(AppendOnlyBlockDirectory *blockDirectory,
+					  int segmentFileNum,
+					  int columnGroupNo,
+					  int64 rowNum,
+					  int *entry_no)
+{
+	int			slotNo;
+
+	for (slotNo = 0; slotNo < blockDirectory->numMinipageCacheSlots; slotNo++)
+	{
+		MinipageCacheSlot *slot = &blockDirectory->minipageCache[slotNo];
+
+		if (slot->minipageInfo.numMinipageEntries == 0 ||
+			slot->columnGroupNo != columnGroupNo ||
+			slot->minipageInfo.segmentFileNum != segmentFileNum)
+			continue;
+
+		/*
+		 * The row ranges of minipages within one segment file and column
+		 * group do not overlap, so an entry covering rowNum is exactly the
+		 * entry that a btree probe would find.
+		 */
+		*entry_no = find_minipage_entry(slot->minipageInfo.minipage,
+										slot->minipageInfo.numMinipageEntries,
+										rowNum);
+		if (*entry_no != -1)
+			return slot;
+	}
+
+	return NULL;
+}
+
+/*
+ * minipage_cache_stash
+ *
+ * Move the current minipage for the given column group into the cache,
+ * evicting the least recently used slot when no slot is free. The column
+ * group's MinipagePerColumnGroup is left holding the evicted slot's
+ * buffers, to be overwritten by the next extract_minipage().
+ */
+static void
+minipage_cache_stash(AppendOnlyBlockDirectory *blockDirectory,
+					 int columnGroupNo)
+{
+	MinipagePerColumnGroup *minipageInfo =
+	&blockDirectory->minipages[columnGroupNo];
+	MinipageCacheSlot *victim = NULL;
+	int			slotNo;
+
+	Assert(blockDirectory->minipageCache != NULL);
+
+	/* Nothing worth keeping. */
+	if (minipageInfo->numMinipageEntries == 0)
+		return;
+
+	for (slotNo = 0; slotNo < blockDirectory->numMinipageCacheSlots; slotNo++)
+	{
+		MinipageCacheSlot *slot = &blockDirectory->minipageCache[slotNo];
+
+		if (slot->minipageInfo.numMinipageEntries == 0)
+		{
+			victim = slot;
+			break;
+		}
+		if (victim == NULL || slot->lastUseCount < victim->lastUseCount)
+			victim = slot;
+	}
+
+	/* Slots allocate their buffers the first time they are used. */
+	if (victim->minipageInfo.minipage == NULL)
+	{
+		MemoryContext oldcxt =
+		MemoryContextSwitchTo(blockDirectory->memoryContext);
+
+		victim->minipageInfo.minipage =
+			palloc0(minipage_size_with_zonemap(NUM_MINIPAGE_ENTRIES));
+		victim->minipageInfo.zoneMapEntries =
+			palloc0(sizeof(MinipageZoneMapEntry) * NUM_MINIPAGE_ENTRIES);
+		MemoryContextSwitchTo(oldcxt);
+	}
+
+	swap_minipage(minipageInfo, &victim->minipageInfo);
+	victim->columnGroupNo = columnGroupNo;
+	victim->lastUseCount = ++blockDirectory->minipageCacheUseCount;
+}
+
 /*
  * write_minipage
  *
@@ -1157,8 +1471,41 @@ write_minipage(AppendOnlyBlockDirectory *blockDirectory,
 		Int64GetDatum(minipageInfo->minipage->entry[0].firstRowNum);
 	nulls[Anum_pg_aoblkdir_firstrownum - 1] = false;
 
-	SET_VARSIZE(minipageInfo->minipage,
-				minipage_size(minipageInfo->numMinipageEntries));
+	/*
+	 * Serialize the zone map array after the entries when at least one
+	 * entry carries a zone map; otherwise keep the version 0 layout so
+	 * that directories without zone maps are byte-identical to before.
+	 */
+	{
+		bool		anyZoneMap = false;
+		uint32		i;
+
+		for (i = 0; i < minipageInfo->numMinipageEntries; i++)
+		{
+			if (minipageInfo->zoneMapEntries[i].flags & MINIPAGE_ZONEMAP_VALID)
+			{
+				anyZoneMap = true;
+				break;
+			}
+		}
+
+		if (anyZoneMap)
+		{
+			minipageInfo->minipage->version = MINIPAGE_VERSION_ZONEMAP;
+			memcpy(((char *) minipageInfo->minipage) +
+				   minipage_size(minipageInfo->numMinipageEntries),
+				   minipageInfo->zoneMapEntries,
+				   sizeof(MinipageZoneMapEntry) * minipageInfo->numMinipageEntries);
+			SET_VARSIZE(minipageInfo->minipage,
+						minipage_size_with_zonemap(minipageInfo->numMinipageEntries));
+		}
+		else
+		{
+			minipageInfo->minipage->version = MINIPAGE_VERSION_BASE;
+			SET_VARSIZE(minipageInfo->minipage,
+						minipage_size(minipageInfo->numMinipageEntries));
+		}
+	}
 	minipageInfo->minipage->nEntry = minipageInfo->numMinipageEntries;
 	values[Anum_pg_aoblkdir_minipage - 1] =
 		PointerGetDatum(minipageInfo->minipage);
@@ -1233,6 +1580,7 @@ AppendOnlyBlockDirectory_End_forInsert(
 		}
 
 		pfree(minipageInfo->minipage);
+		pfree(minipageInfo->zoneMapEntries);
 	}
 
 	ereportif(Debug_appendonly_print_blockdirectory, LOG,
@@ -1269,6 +1617,8 @@ AppendOnlyBlockDirectory_End_forSearch(
 	{
 		if (blockDirectory->minipages[groupNo].minipage != NULL)
 			pfree(blockDirectory->minipages[groupNo].minipage);
+		if (blockDirectory->minipages[groupNo].zoneMapEntries != NULL)
+			pfree(blockDirectory->minipages[groupNo].zoneMapEntries);
 	}
 
 	ereportif(Debug_appendonly_print_blockdirectory, LOG,
@@ -1318,6 +1668,7 @@ AppendOnlyBlockDirectory_End_addCol(
 							  groupNo, minipageInfo->numMinipageEntries)));
 		}
 		pfree(minipageInfo->minipage);
+		pfree(minipageInfo->zoneMapEntries);
 	}
 
 	ereportif(Debug_appendonly_print_blockdirectory, LOG,
@@ -62,6 +62,80 @@ static AORelHashEntry AORelLookupHashEntry(Oid relid);
 static bool AORelCreateHashEntry(Oid relid);
 static bool *GetFileSegStateInfoFromSegments(Relation parentrel);
 static int64 *GetTotalTupleCountFromSegments(Relation parentrel, int segno);
+static int64 *GetVisimapEntryCountFromSegments(Relation parentrel);
+
+/*
+ * The AppendOnlyHash table is partitioned, and each partition is guarded by
+ * its own lightweight lock (FirstAOSegFileLock + partition number), so that
+ * segfile assignment for different relations can proceed in parallel instead
+ * of convoying on a single global lock. A relation maps to a partition by
+ * the low-order bits of its relid's hash value, which is the same rule
+ * dynahash uses internally, so holding the partition lock protects both the
+ * relation's hash entry and the bucket chains it lives in.
+ *
+ * Operations that walk the whole table (evicting an unused entry, the
+ * end-of-transaction passes) must hold every partition lock. These are
+ * always taken in ascending order to avoid deadlocks between such callers
+ * and single-partition callers.
+ *
+ * The num_existing_aorels counter spans all partitions and is protected
+ * separately, by the spinlock in AppendOnlyWriterData.
+ */
+#define AORelHashPartition(hashcode) \
+	((hashcode) % NUM_AOSEGFILE_PARTITIONS)
+#define AORelHashPartitionLock(hashcode) \
+	((LWLockId) (FirstAOSegFileLock + AORelHashPartition(hashcode)))
+
+/*
+ * AORelSegFilePartitionLock -- the lock protecting a given relation's
+ * entry in the AppendOnlyHash table.
+ */
+LWLockId
+AORelSegFilePartitionLock(Oid relid)
+{
+	return AORelHashPartitionLock(get_hash_value(AppendOnlyHash,
+												 (void *) &relid));
+}
+
+/*
+ * Acquire every AppendOnlyHash partition lock, in ascending order.
+ */
+static void
+AORelAcquireAllPartitionLocks(void)
+{
+	int			i;
+
+	for (i = 0; i < NUM_AOSEGFILE_PARTITIONS; i++)
+		LWLockAcquire(FirstAOSegFileLock + i, LW_EXCLUSIVE);
+}
+
+/*
+ * Release every AppendOnlyHash partition lock, in reverse order.
+ */
+static void
+AORelReleaseAllPartitionLocks(void)
+{
+	int			i;
+
+	for (i = NUM_AOSEGFILE_PARTITIONS; --i >= 0;)
+		LWLockRelease(FirstAOSegFileLock + i);
+}
+
+/*
+ * Same, but keep holding the given partition lock. Used when trading all
+ * partition locks back down to the single one a caller expects to hold.
+ */
+static void
+AORelReleaseAllPartitionLocksExcept(LWLockId keepLock)
+{
+	int			i;
+
+	for (i = NUM_AOSEGFILE_PARTITIONS; --i >= 0;)
+	{
+		if (FirstAOSegFileLock + i != keepLock)
+			LWLockRelease(FirstAOSegFileLock + i);
+	}
+}
 
 /*
  * AppendOnlyWriterShmemSize -- estimate size the append only writer structures
@@ -112,6 +186,7 @@ InitAppendOnlyWriter(void)
 								 * table */
 
 	/* Specify that we have no AO rel information yet. */
+	SpinLockInit(&AppendOnlyWriter->mutex);
 	AppendOnlyWriter->num_existing_aorels = 0;
 
 	/* Create AppendOnlyHash (empty at this point). */
@@ -144,7 +219,8 @@ AOHashTableInit(void)
 	info.keysize = sizeof(Oid);
 	info.entrysize = sizeof(AORelHashEntryData);
 	info.hash = tag_hash;
-	hash_flags = (HASH_ELEM | HASH_FUNCTION);
+	info.num_partitions = NUM_AOSEGFILE_PARTITIONS;
+	hash_flags = (HASH_ELEM | HASH_FUNCTION | HASH_PARTITION);
 
 	ereportif(Debug_appendonly_print_segfile_choice, LOG,
 			  (errmsg("AOHashTableInit: Creating hash table for %d append only tables",
@@ -181,14 +257,15 @@ AORelCreateHashEntry(Oid relid)
 	AORelHashEntry aoHashEntry = NULL;
 	Relation	aorel;
 	bool	   *awaiting_drop = NULL;
+	LWLockId	partitionLock = AORelSegFilePartitionLock(relid);
 
 	Insist(Gp_role == GP_ROLE_DISPATCH);
 
 	/*
-	 * Momentarily release the AOSegFileLock so we can safely access the
+	 * Momentarily release the partition lock so we can safely access the
 	 * system catalog (i.e. without risking a deadlock).
 	 */
-	LWLockRelease(AOSegFileLock);
+	LWLockRelease(partitionLock);
 
 	/*
 	 * Now get all the segment files information for this relation from the QD
@@ -215,11 +292,11 @@ AORelCreateHashEntry(Oid relid)
 	heap_close(aorel, RowExclusiveLock);
 
 	/*
-	 * Re-acquire AOSegFileLock.
+	 * Re-acquire the partition lock.
 	 *
 	 * Note: Another session may have raced-in and created it.
 	 */
-	LWLockAcquire(AOSegFileLock, LW_EXCLUSIVE);
+	LWLockAcquire(partitionLock, LW_EXCLUSIVE);
 
 	aoHashEntry = AppendOnlyRelHashNew(relid, &exists);
 
@@ -305,7 +382,9 @@ AORelCreateHashEntry(Oid relid)
 	}
 
 	/* record the fact that another hash entry is now taken */
+	SpinLockAcquire(&AppendOnlyWriter->mutex);
 	AppendOnlyWriter->num_existing_aorels++;
+	SpinLockRelease(&AppendOnlyWriter->mutex);
 
 	if (allfsinfo)
 	{
@@ -333,8 +412,8 @@ AORelCreateHashEntry(Oid relid)
  * AORelRemoveEntry -- remove the hash entry for a given relation.
  *
  * Notes
- *	The append only lightweight lock (AOSegFileLock) *must* be held for
- *	this operation.
+ *	The relation's AppendOnlyHash partition lock (see
+ *	AORelSegFilePartitionLock) *must* be held for this operation.
  */
 bool
 AORelRemoveHashEntry(Oid relid)
@@ -358,7 +437,9 @@ AORelRemoveHashEntry(Oid relid)
 	if (aoentry == NULL)
 		return false;
 
+	SpinLockAcquire(&AppendOnlyWriter->mutex);
 	AppendOnlyWriter->num_existing_aorels--;
+	SpinLockRelease(&AppendOnlyWriter->mutex);
 
 	return true;
 }
@@ -409,8 +490,8 @@ AORelGetHashEntry(Oid relid)
 /*
  * Gets or creates the AORelHashEntry.
  *
- * Assumes that the AOSegFileLock is acquired.
- * The AOSegFileLock will still be acquired when this function returns, expect
+ * Assumes that the relation's partition lock is acquired.
+ * The partition lock will still be acquired when this function returns, expect
  * if it errors out.
  */
 static AORelHashEntryData *
@@ -429,12 +510,12 @@ AORelGetOrCreateHashEntry(Oid relid)
 	 * We need to create a hash entry for this relation.
 	 *
 	 * However, we need to access the pg_appendonly system catalog table, so
-	 * AORelCreateHashEntry will carefully release the AOSegFileLock, gather
-	 * the information, and then re-acquire AOSegFileLock.
+	 * AORelCreateHashEntry will carefully release the partition lock, gather
+	 * the information, and then re-acquire it.
 	 */
 	if (!AORelCreateHashEntry(relid))
 	{
-		LWLockRelease(AOSegFileLock);
+		LWLockRelease(AORelSegFilePartitionLock(relid));
 		ereport(ERROR, (errmsg("can't have more than %d different append-only "
 							   "tables open for writing data at the same time. "
 							   "if tables are heavily partitioned or if your "
@@ -452,25 +533,37 @@ AORelGetOrCreateHashEntry(Oid relid)
  * AppendOnlyRelHashNew -- return a new (empty) aorel hash object to initialize.
  *
  * Notes
- *	The appendonly lightweight lock (AOSegFileLock) *must* be held for
- *	this operation.
+ *	The relation's AppendOnlyHash partition lock *must* be held for
+ *	this operation. If an unused entry has to be evicted to make room,
+ *	the lock is momentarily traded for all partition locks (the eviction
+ *	scan walks the whole table), so a concurrently created entry is
+ *	possible and is reported through "exists" just like a raced-in
+ *	creation was before.
  */
 static AORelHashEntry
 AppendOnlyRelHashNew(Oid relid, bool *exists)
 {
 	AORelHashEntryData *aorelentry = NULL;
+	int			num_existing_aorels;
 
 	Insist(Gp_role == GP_ROLE_DISPATCH);
 
+	SpinLockAcquire(&AppendOnlyWriter->mutex);
+	num_existing_aorels = AppendOnlyWriter->num_existing_aorels;
+	SpinLockRelease(&AppendOnlyWriter->mutex);
+
 	/*
 	 * We do not want to exceed the max number of allowed entries since we
 	 * don't drop entries when we're done with them (so we could reuse them).
 	 * Note that the hash table will allow going past max_size (it's not a
-	 * hard limit) so we do the check ourselves.
+	 * hard limit) so we do the check ourselves. Creations in different
+	 * partitions may slip past it concurrently, so the counter can
+	 * overshoot MaxAppendOnlyTables by a handful; the next creation then
+	 * evicts more than one entry's worth over time.
 	 *
 	 * Therefore, check for this condition first and deal with it if exists.
 	 */
-	if (AppendOnlyWriter->num_existing_aorels >= MaxAppendOnlyTables)
+	if (num_existing_aorels >= MaxAppendOnlyTables)
 	{
 		/* see if there's already an existing entry for this relid */
 		aorelentry = AORelLookupHashEntry(relid);
@@ -488,8 +581,27 @@ AppendOnlyRelHashNew(Oid relid, bool *exists)
 		{
 			HASH_SEQ_STATUS status;
 			AORelHashEntryData *hentry;
+			LWLockId	partitionLock = AORelSegFilePartitionLock(relid);
 
-			Assert(AppendOnlyWriter->num_existing_aorels == MaxAppendOnlyTables);
+			/*
+			 * The eviction scan touches every partition, so trade our
+			 * single partition lock for all of them (in ascending order,
+			 * to not deadlock against other scanners).
+			 */
+			LWLockRelease(partitionLock);
+			AORelAcquireAllPartitionLocks();
+
+			/*
+			 * While the lock was dropped another session may have created
+			 * the entry. Use it if so.
+			 */
+			aorelentry = AORelLookupHashEntry(relid);
+			if (aorelentry)
+			{
+				AORelReleaseAllPartitionLocksExcept(partitionLock);
+				*exists = true;	/* reuse */
+				return NULL;
+			}
 
 			/*
 			 * loop through all entries looking for an unused one
@@ -518,6 +630,7 @@ AppendOnlyRelHashNew(Oid relid, bool *exists)
 																	exists);
 
 					Insist(aorelentry);
+					AORelReleaseAllPartitionLocksExcept(partitionLock);
 					return (AORelHashEntry) aorelentry;
 				}
 
@@ -526,6 +639,7 @@ AppendOnlyRelHashNew(Oid relid, bool *exists)
 			/*
 			 * No room for a new entry. give up.
 			 */
+			AORelReleaseAllPartitionLocksExcept(partitionLock);
 			return NULL;
 		}
 
@@ -693,7 +807,7 @@ DeregisterSegnoForCompactionDrop(Oid relid, List *compactedSegmentFileList)
 		return;
 	}
 
-	LWLockAcquire(AOSegFileLock, LW_EXCLUSIVE);
+	LWLockAcquire(AORelSegFilePartitionLock(relid), LW_EXCLUSIVE);
 
 	aoentry = AORelGetOrCreateHashEntry(relid);
 	Assert(aoentry);
@@ -717,7 +831,7 @@ DeregisterSegnoForCompactionDrop(Oid relid, List *compactedSegmentFileList)
 		}
 	}
 
-	LWLockRelease(AOSegFileLock);
+	LWLockRelease(AORelSegFilePartitionLock(relid));
 	return;
 }
 
@@ -739,7 +853,7 @@ RegisterSegnoForCompactionDrop(Oid relid, List *compactedSegmentFileList)
 		return;
 	}
 
-	LWLockAcquire(AOSegFileLock, LW_EXCLUSIVE);
+	LWLockAcquire(AORelSegFilePartitionLock(relid), LW_EXCLUSIVE);
 
 	aoentry = AORelGetOrCreateHashEntry(relid);
 	Assert(aoentry);
@@ -763,7 +877,7 @@ RegisterSegnoForCompactionDrop(Oid relid, List *compactedSegmentFileList)
 		}
 	}
 
-	LWLockRelease(AOSegFileLock);
+	LWLockRelease(AORelSegFilePartitionLock(relid));
 	return;
 }
 
@@ -792,6 +906,7 @@ SetSegnoForCompaction(Relation rel,
 	int			i;
 	AORelHashEntryData *aoentry;
 	int64		segzero_tupcount = 0;
+	int64	   *visimap_entry_count = NULL;
 
 	Assert(Gp_role != GP_ROLE_EXECUTE);
 	Assert(is_drop);
@@ -823,7 +938,7 @@ SetSegnoForCompaction(Relation rel,
 
 	/*
 	 * On the first call in a vacuum run, get an updated estimate from segno
-	 * 0. We do this before aquiring the AOSegFileLock.
+	 * 0. We do this before aquiring the partition lock.
 	 */
 	if (!compactedSegmentFileList)
 	{
@@ -834,7 +949,14 @@ SetSegnoForCompaction(Relation rel,
 		pfree(total_tupcount);
 	}
 
-	LWLockAcquire(AOSegFileLock, LW_EXCLUSIVE);
+	/*
+	 * Ask the segments how many visimap entries each segfile has, so that
+	 * the most bloated candidate is compacted first. Like the segno 0
+	 * estimate above, this is done before taking the partition lock.
+	 */
+	visimap_entry_count = GetVisimapEntryCountFromSegments(rel);
+
+	LWLockAcquire(AORelSegFilePartitionLock(RelationGetRelid(rel)), LW_EXCLUSIVE);
 
 	aoentry = AORelGetOrCreateHashEntry(RelationGetRelid(rel));
 	Assert(aoentry);
@@ -875,6 +997,8 @@ SetSegnoForCompaction(Relation rel,
 
 	if (usesegno <= 0)
 	{
+		int64		best_entry_count = -1;
+
 		for (i = 0; i < MAX_AOREL_CONCURRENCY; i++)
 		{
 			AOSegfileStatus *segfilestat = &aoentry->relsegfiles[i];
@@ -891,7 +1015,13 @@ SetSegnoForCompaction(Relation rel,
 							  in_compaction_list, in_inserted_list)));
 
 			/*
-			 * Select when there are tuples and it is available.
+			 * Select when there are tuples and it is available. Among the
+			 * eligible segfiles, prefer the one with the most visimap
+			 * entries: a segfile without entries hides no tuples at all,
+			 * and beyond that every entry covers a row range that has had
+			 * deletions, so the count is a cheap proxy for how much
+			 * reclaimable data the segfile holds. Ties keep the previous
+			 * ascending segno order.
 			 */
 			if ((segfilestat->total_tupcount > 0) &&
 				segfilestat->state == AVAILABLE &&
@@ -899,12 +1029,17 @@ SetSegnoForCompaction(Relation rel,
 				!in_compaction_list &&
 				!in_inserted_list)
 			{
-				usesegno = i;
-				break;
+				if (visimap_entry_count[i] > best_entry_count)
+				{
+					usesegno = i;
+					best_entry_count = visimap_entry_count[i];
+				}
 			}
 		}
 	}
 
+	pfree(visimap_entry_count);
+
 	if (usesegno != APPENDONLY_COMPACTION_SEGNO_INVALID)
 	{
 		/* mark this segno as in use */
@@ -938,7 +1073,7 @@ SetSegnoForCompaction(Relation rel,
 						  RelationGetRelationName(rel), RelationGetRelid(rel))));
 	}
 
-	LWLockRelease(AOSegFileLock);
+	LWLockRelease(AORelSegFilePartitionLock(RelationGetRelid(rel)));
 
 	Assert(usesegno >= 0 || usesegno == APPENDONLY_COMPACTION_SEGNO_INVALID);
 
@@ -988,7 +1123,7 @@ SetSegnoForCompactionInsert(Relation rel,
 					  "relation \"%s\" (%d)",
 					  RelationGetRelationName(rel), RelationGetRelid(rel))));
 
-	LWLockAcquire(AOSegFileLock, LW_EXCLUSIVE);
+	LWLockAcquire(AORelSegFilePartitionLock(RelationGetRelid(rel)), LW_EXCLUSIVE);
 
 	aoentry = AORelGetOrCreateHashEntry(RelationGetRelid(rel));
 	Assert(aoentry);
@@ -1040,7 +1175,7 @@ SetSegnoForCompactionInsert(Relation rel,
 
 	if (!segno_chosen)
 	{
-		LWLockRelease(AOSegFileLock);
+		LWLockRelease(AORelSegFilePartitionLock(RelationGetRelid(rel)));
 		ereport(ERROR, (errmsg("could not find segment file to use for "
 							   "inserting into relation %s (%d).",
 							   RelationGetRelationName(rel), RelationGetRelid(rel))));
@@ -1052,7 +1187,7 @@ SetSegnoForCompactionInsert(Relation rel,
 	aoentry->relsegfiles[usesegno].state = INSERT_USE;
 	aoentry->relsegfiles[usesegno].xid = CurrentXid;
 
-	LWLockRelease(AOSegFileLock);
+	LWLockRelease(AORelSegFilePartitionLock(RelationGetRelid(rel)));
 	appendOnlyInsertXact = true;
 
 	Assert(usesegno >= 0);
@@ -1131,7 +1266,8 @@ SetSegnoForWrite(Relation rel, int existingsegno)
 							  "relation \"%s\" (%d) ",
 							  RelationGetRelationName(rel), RelationGetRelid(rel))));
 
-			LWLockAcquire(AOSegFileLock, LW_EXCLUSIVE);
+			LWLockAcquire(AORelSegFilePartitionLock(RelationGetRelid(rel)),
+						  LW_EXCLUSIVE);
 
 			aoentry = AORelGetOrCreateHashEntry(RelationGetRelid(rel));
 			Assert(aoentry);
@@ -1200,7 +1336,7 @@ SetSegnoForWrite(Relation rel, int existingsegno)
 
 			if (!segno_chosen)
 			{
-				LWLockRelease(AOSegFileLock);
+				LWLockRelease(AORelSegFilePartitionLock(RelationGetRelid(rel)));
 				ereport(ERROR, (errmsg("could not find segment file to use for "
 									   "inserting into relation %s (%d).",
 									   RelationGetRelationName(rel), RelationGetRelid(rel))));
@@ -1212,7 +1348,7 @@ SetSegnoForWrite(Relation rel, int existingsegno)
 			aoentry->relsegfiles[usesegno].state = INSERT_USE;
 			aoentry->relsegfiles[usesegno].xid = CurrentXid;
 
-			LWLockRelease(AOSegFileLock);
+			LWLockRelease(AORelSegFilePartitionLock(RelationGetRelid(rel)));
 			appendOnlyInsertXact = true;
 
 			Assert(usesegno >= 0);
@@ -1280,6 +1416,56 @@ assignPerRelSegno(List *all_relids)
 	return mapping;
 }
 
+/*
+ * Working state for accumulateSegfileTupCounts().
+ */
+typedef struct AOTupCountContext
+{
+	const char *sql;			/* query text, for error messages */
+	int64	   *total_tupcount; /* array indexed by segno */
+} AOTupCountContext;
+
+/*
+ * CdbDispatchResultConsumer callback for GetTotalTupleCountFromSegments().
+ * Folds one QE's (tupcount, segno) rows into the per-segfile totals.
+ */
+static void
+accumulateSegfileTupCounts(struct pg_result *pgresult,
+						   struct SegmentDatabaseDescriptor *segdbDesc,
+						   void *context)
+{
+	AOTupCountContext *ctx = (AOTupCountContext *) context;
+	int			j;
+
+	if (PQresultStatus(pgresult) != PGRES_TUPLES_OK)
+		ereport(ERROR,
+				(errmsg("failed to obtain AO total tupcount: %s (%s)",
+						ctx->sql,
+						PQresultErrorMessage(pgresult))));
+
+	for (j = 0; j < PQntuples(pgresult); j++)
+	{
+		char	   *value;
+		int64		tupcount;
+		int			segno;
+
+		/* We don't expect NULL, but sanity check. */
+		if (PQgetisnull(pgresult, j, 0) == 1)
+			elog(ERROR, "unexpected NULL in tupcount in results: %s",
+				 ctx->sql);
+		if (PQgetisnull(pgresult, j, 1) == 1)
+			elog(ERROR, "unexpected NULL in segno in results: %s",
+				 ctx->sql);
+
+		value = PQgetvalue(pgresult, j, 0);
+		tupcount = DatumGetFloat8(
+								  DirectFunctionCall1(float8in, CStringGetDatum(value)));
+		value = PQgetvalue(pgresult, j, 1);
+		segno = pg_atoi(value, sizeof(int32), 0);
+		ctx->total_tupcount[segno] += tupcount;
+	}
+}
+
 /*
  * Collects tupcount for each segfile from all segdbs by sending a query.
  * Returns an array of int64, each of whose element has the aggregated
@@ -1293,9 +1479,7 @@ GetTotalTupleCountFromSegments(Relation parentrel,
 {
 	StringInfoData sqlstmt;
 	Relation	aosegrel;
-	CdbPgResults cdb_pgresults = {NULL, 0};
-	int			i,
-				j;
+	AOTupCountContext ctx;
 	int64	   *total_tupcount = NULL;
 	Oid			save_userid;
 	bool		save_secdefcxt;
@@ -1318,10 +1502,16 @@ GetTotalTupleCountFromSegments(Relation parentrel,
 	/* Allocate result array to be returned. */
 	total_tupcount = palloc0(sizeof(int64) * MAX_AOREL_CONCURRENCY);
 
+	ctx.sql = sqlstmt.data;
+	ctx.total_tupcount = total_tupcount;
+
 	/*
 	 * Dispatch the query to segments.  Although this path is not critical to
 	 * use SPI, it is desirable to avoid another MPP query here, too.
 	 *
+	 * The results are folded into total_tupcount as they are drained, so we
+	 * never hold every segment's result set in memory at once.
+	 *
 	 * Since pg_aoseg namespace is a part of catalog, we need a superuser
 	 * privilege.  This is just a band-aid and we need to revisit the
 	 * mechanism to synchronize pg_aoseg between master and segment.
@@ -1331,58 +1521,92 @@ GetTotalTupleCountFromSegments(Relation parentrel,
 
 	PG_TRY();
 	{
-		CdbDispatchCommand(sqlstmt.data, DF_WITH_SNAPSHOT, &cdb_pgresults);
+		CdbDispatchCommandConsume(sqlstmt.data, DF_WITH_SNAPSHOT,
+								  accumulateSegfileTupCounts, &ctx);
 
 		/* Restore userid */
 		SetUserIdAndContext(save_userid, save_secdefcxt);
+	}
+	PG_CATCH();
+	{
+		SetUserIdAndContext(save_userid, save_secdefcxt);
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
 
-		for (i = 0; i < cdb_pgresults.numResults; i++)
-		{
-			struct pg_result *pgresult = cdb_pgresults.pg_results[i];
+	pfree(sqlstmt.data);
 
-			if (PQresultStatus(pgresult) != PGRES_TUPLES_OK)
-				ereport(ERROR,
-						(errmsg("failed to obtain AO total tupcount: %s (%s)",
-								sqlstmt.data,
-								PQresultErrorMessage(pgresult))));
-			else
-			{
-				for (j = 0; j < PQntuples(pgresult); j++)
-				{
-					char	   *value;
-					int64		tupcount;
-					int			segno;
+	return total_tupcount;
+}
 
-					/* We don't expect NULL, but sanity check. */
-					if (PQgetisnull(pgresult, j, 0) == 1)
-						elog(ERROR, "unexpected NULL in tupcount in results[%d]: %s",
-							 i, sqlstmt.data);
-					if (PQgetisnull(pgresult, j, 1) == 1)
-						elog(ERROR, "unexpected NULL in segno in results[%d]: %s",
-							 i, sqlstmt.data);
+/*
+ * Collects the number of visibility map entries each segfile has from all
+ * segdbs by sending a query.  Returns an array of int64 indexed by segno.
+ * A segfile without visimap entries hides no tuples at all; beyond that,
+ * every entry covers a row range that has had deletions, so the count is a
+ * cheap proxy for the amount of reclaimable data.  The bitmaps themselves
+ * are compressed and cannot be aggregated in plain SQL.
+ */
+static int64 *
+GetVisimapEntryCountFromSegments(Relation parentrel)
+{
+	StringInfoData sqlstmt;
+	Relation	visimaprel;
+	AOTupCountContext ctx;
+	int64	   *entry_count = NULL;
+	Oid			save_userid;
+	bool		save_secdefcxt;
 
-					value = PQgetvalue(pgresult, j, 0);
-					tupcount = DatumGetFloat8(
-											  DirectFunctionCall1(float8in, CStringGetDatum(value)));
-					value = PQgetvalue(pgresult, j, 1);
-					segno = pg_atoi(value, sizeof(int32), 0);
-					total_tupcount[segno] += tupcount;
-				}
-			}
-		}
+	/*
+	 * get the name of the visimap relation
+	 */
+	visimaprel = heap_open(parentrel->rd_appendonly->visimaprelid,
+						   AccessShareLock);
+
+	/*
+	 * assemble our query string
+	 */
+	initStringInfo(&sqlstmt);
+	appendStringInfo(&sqlstmt,
+					 "SELECT count(*), segno FROM pg_aoseg.%s GROUP BY segno",
+					 RelationGetRelationName(visimaprel));
+	heap_close(visimaprel, AccessShareLock);
+
+	/* Allocate result array to be returned. */
+	entry_count = palloc0(sizeof(int64) * MAX_AOREL_CONCURRENCY);
+
+	ctx.sql = sqlstmt.data;
+	ctx.total_tupcount = entry_count;
+
+	/*
+	 * Dispatch the query to segments, folding the per-QE counts into
+	 * entry_count as the results are drained.
+	 *
+	 * Since pg_aoseg namespace is a part of catalog, we need a superuser
+	 * privilege.  This is just a band-aid and we need to revisit the
+	 * mechanism to synchronize pg_aoseg between master and segment.
+	 */
+	GetUserIdAndContext(&save_userid, &save_secdefcxt);
+	SetUserIdAndContext(BOOTSTRAP_SUPERUSERID, true);
+
+	PG_TRY();
+	{
+		CdbDispatchCommandConsume(sqlstmt.data, DF_WITH_SNAPSHOT,
+								  accumulateSegfileTupCounts, &ctx);
+
+		/* Restore userid */
+		SetUserIdAndContext(save_userid, save_secdefcxt);
 	}
 	PG_CATCH();
 	{
 		SetUserIdAndContext(save_userid, save_secdefcxt);
-		cdbdisp_clearCdbPgResults(&cdb_pgresults);
 		PG_RE_THROW();
 	}
 	PG_END_TRY();
 
 	pfree(sqlstmt.data);
-	cdbdisp_clearCdbPgResults(&cdb_pgresults);
 
-	return total_tupcount;
+	return entry_count;
 }
 
 /*
@@ -1681,8 +1905,11 @@ UpdateMasterAosegTotals(Relation parentrel, int segno, int64 tupcount, int64 mod
 	 * same trick for the aoseg table since MVCC protects us there in case we
 	 * abort.
 	 */
+	LWLockAcquire(AORelSegFilePartitionLock(RelationGetRelid(parentrel)),
+				  LW_EXCLUSIVE);
 	aoHashEntry = AORelGetHashEntry(RelationGetRelid(parentrel));
 	aoHashEntry->relsegfiles[segno].tupsadded += tupcount;
+	LWLockRelease(AORelSegFilePartitionLock(RelationGetRelid(parentrel)));
 }
 
 
@@ -1717,7 +1944,8 @@ AtCommit_AppendOnly(void)
 	/* We should have an XID if we modified AO tables */
 	Assert(CurrentXid != InvalidTransactionId);
 
-	LWLockAcquire(AOSegFileLock, LW_EXCLUSIVE);
+	/* walking the whole hash table requires every partition lock */
+	AORelAcquireAllPartitionLocks();
 
 	/*
 	 * for each AO table hash entry
@@ -1775,7 +2003,7 @@ AtCommit_AppendOnly(void)
 		}
 	}
 
-	LWLockRelease(AOSegFileLock);
+	AORelReleaseAllPartitionLocks();
 }
 
 /*
@@ -1807,7 +2035,8 @@ AtAbort_AppendOnly(void)
 
 	hash_seq_init(&status, AppendOnlyHash);
 
-	LWLockAcquire(AOSegFileLock, LW_EXCLUSIVE);
+	/* walking the whole hash table requires every partition lock */
+	AORelAcquireAllPartitionLocks();
 
 	/*
 	 * for each AO table hash entry
@@ -1860,11 +2089,11 @@ AtAbort_AppendOnly(void)
 		}
 	}
 
-	LWLockRelease(AOSegFileLock);
+	AORelReleaseAllPartitionLocks();
 }
 
 /*
- * Assumes that AOSegFileLock is held.
+ * Assumes that the entry's partition lock is held.
  * Transitions from state 3, 4, or 4 to the correct next state based
  * on the abort/commit of the transaction.
  *
@@ -1939,7 +2168,7 @@ AtEOXact_AppendOnly_StateTransition(AORelHashEntry aoentry, int segno,
 }
 
 /*
- * Assumes that AOSegFileLock is held.
+ * Assumes that the entry's partition lock is held.
  */
 static void
 AtEOXact_AppendOnly_Relation(AORelHashEntry aoentry, TransactionId currentXid)
@@ -2025,7 +2254,8 @@ AtEOXact_AppendOnly(void)
 
 	hash_seq_init(&status, AppendOnlyHash);
 
-	LWLockAcquire(AOSegFileLock, LW_EXCLUSIVE);
+	/* walking the whole hash table requires every partition lock */
+	AORelAcquireAllPartitionLocks();
 
 	/*
 	 * for each AO table hash entry
@@ -2035,7 +2265,7 @@ AtEOXact_AppendOnly(void)
 		AtEOXact_AppendOnly_Relation(aoentry, CurrentXid);
 	}
 
-	LWLockRelease(AOSegFileLock);
+	AORelReleaseAllPartitionLocks();
 
 	appendOnlyInsertXact = false;
 }
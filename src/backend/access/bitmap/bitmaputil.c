@@ -26,6 +26,7 @@
 static void _bitmap_findnextword(BMBatchWords* words, uint64 nextReadNo);
 static void _bitmap_resetWord(BMBatchWords *words, uint32 prevStartNo);
 static uint8 _bitmap_find_bitset(BM_HRL_WORD word, uint8 lastPos);
+static uint32 _bitmap_literal_run_len(BMBatchWords *words, uint32 maxlen);
 
 /*
  * _bitmap_formitem() -- construct a LOV entry.
@@ -551,6 +552,22 @@ fast_forward(uint32 nbatches, BMBatchWords **batches, BMBatchWords *result)
 	return batches[0]->nextread;
 }
 
+/*
+ * _bitmap_literal_run_len() -- count the consecutive literal words
+ *		available at the current read position of a batch, up to 'maxlen'.
+ */
+static uint32
+_bitmap_literal_run_len(BMBatchWords *words, uint32 maxlen)
+{
+	uint32		len = 0;
+
+	while (len < maxlen && len < words->nwords &&
+		   !IS_FILL_WORD(words->hwords, words->startNo + len))
+		len++;
+
+	return len;
+}
+
 /*
  * _bitmap_union() -- union 'numBatches' bitmaps
  *
@@ -584,6 +601,57 @@ _bitmap_union(BMBatchWords **batches, uint32 numBatches, BMBatchWords *result)
 		BM_HRL_WORD orWord = LITERAL_ALL_ZERO;
 		BM_HRL_WORD	word;
 		bool		orWordIsLiteral = true;
+		uint32		runLen;
+
+		/*
+		 * Fast path: when the next several words are literals in every
+		 * batch, OR them as flat word arrays in one pass instead of going
+		 * through the per-word dispatch below.  The inner loop is a plain
+		 * dst[k] |= src[k] over contiguous memory, which the compiler can
+		 * unroll and vectorize.  The result words are all literals, so the
+		 * result header bits stay zero, same as the one-word path.
+		 */
+		runLen = result->maxNumOfWords - result->nwords;
+		for (batchNo = 0; batchNo < numBatches; batchNo++)
+		{
+			BMBatchWords *bch = batches[batchNo];
+
+			_bitmap_findnextword(bch, nextReadNo);
+
+			if (bch->nwords == 0)
+			{
+				/* let the word-at-a-time loop do its "done" bookkeeping */
+				runLen = 0;
+				break;
+			}
+
+			runLen = _bitmap_literal_run_len(bch, runLen);
+			if (runLen == 0)
+				break;
+		}
+
+		if (runLen > 1)
+		{
+			BM_HRL_WORD *dst = &result->cwords[result->nwords];
+			uint32		k;
+
+			MemSet(dst, 0, runLen * sizeof(BM_HRL_WORD));
+			for (batchNo = 0; batchNo < numBatches; batchNo++)
+			{
+				BMBatchWords *bch = batches[batchNo];
+				BM_HRL_WORD *src = &bch->cwords[bch->startNo];
+
+				for (k = 0; k < runLen; k++)
+					dst[k] |= src[k];
+
+				bch->nwordsread += runLen;
+				bch->startNo += runLen;
+				bch->nwords -= runLen;
+			}
+			result->nwords += runLen;
+			nextReadNo += runLen;
+			continue;
+		}
 
 		for (batchNo = 0; batchNo < numBatches; batchNo++)
 		{
@@ -1255,7 +1255,8 @@ attribute_reloptions(Datum reloptions, bool validate)
 	int			numoptions;
 	static const relopt_parse_elt tab[] = {
 		{"n_distinct", RELOPT_TYPE_REAL, offsetof(AttributeOpts, n_distinct)},
-		{"n_distinct_inherited", RELOPT_TYPE_REAL, offsetof(AttributeOpts, n_distinct_inherited)}
+		{"n_distinct_inherited", RELOPT_TYPE_REAL, offsetof(AttributeOpts, n_distinct_inherited)},
+		{SOPT_COMPTYPE, RELOPT_TYPE_STRING, offsetof(AttributeOpts, compresstype)}
 	};
 
 	options = parseRelOptions(reloptions, validate, RELOPT_KIND_ATTRIBUTE,
@@ -108,6 +108,8 @@ static relopt_real realRelOpts_gp[] =
 	{{NULL}}
 };
 
+static void validate_attribute_compresstype(char *value);
+
 static relopt_string stringRelOpts_gp[] =
 {
 	{
@@ -126,6 +128,14 @@ static relopt_string stringRelOpts_gp[] =
 		},
 		0, false, NULL, ""
 	},
+	{
+		{
+			SOPT_COMPTYPE,
+			"TOAST compression type for the column",
+			RELOPT_KIND_ATTRIBUTE
+		},
+		0, true, validate_attribute_compresstype, ""
+	},
 	/* list terminator */
 	{{NULL}}
 };
@@ -188,6 +198,36 @@ initialize_reloptions_gp(void)
 	}
 }
 
+/*
+ * Validator for the per-column "compresstype" attribute option, which
+ * selects the TOAST compression method used for the column.
+ */
+static void
+validate_attribute_compresstype(char *value)
+{
+	if (value == NULL)
+		return;
+
+	if (pg_strcasecmp(value, "pglz") == 0)
+		return;
+
+	if (pg_strcasecmp(value, "lz4") == 0)
+	{
+#ifndef HAVE_LIBLZ4
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("lz4 compression is not supported by this build")));
+#endif
+		return;
+	}
+
+	ereport(ERROR,
+			(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			 errmsg("invalid value \"%s\" for attribute option \"%s\"",
+					value, SOPT_COMPTYPE),
+			 errhint("Valid values are \"pglz\" and \"lz4\".")));
+}
+
 /*
  * This is set whenever the GUC gp_default_storage_options is set.
  */
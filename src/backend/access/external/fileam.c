@@ -80,7 +80,7 @@ static void FunctionCallPrepareFormatter(FunctionCallInfoData *fcinfo,
 
 static void open_external_readable_source(FileScanDesc scan);
 static void open_external_writable_source(ExternalInsertDesc extInsertDesc);
-static int	external_getdata(URL_FILE *extfile, CopyState pstate, int maxread);
+static int	external_getdata(FileScanDesc scan, CopyState pstate, int maxread);
 static void external_senddata(URL_FILE *extfile, CopyState pstate);
 static void external_scan_error_callback(void *arg);
 static void readHeaderLine(CopyState pstate);
@@ -149,6 +149,7 @@ external_beginscan(Relation relation, uint32 scancounter,
 	scan->fs_scancounter = scancounter;
 	scan->fs_noop = false;
 	scan->fs_file = NULL;
+	scan->fs_morelocs = NIL;
 	scan->fs_formatter = NULL;
 	scan->fs_constraintExprs = NULL;
 	if (relation->rd_att->constr != NULL && relation->rd_att->constr->num_check > 0)
@@ -194,6 +195,35 @@ external_beginscan(Relation relation, uint32 scancounter,
 			else
 				uri = (char *) strVal(v);
 		}
+
+		/*
+		 * With gp_external_chain_urls, don't stop after draining our own
+		 * gpfdist URI: line up the other distinct URIs (starting just past
+		 * ours, so segments fan out) and visit them too. gpfdist hands out
+		 * blocks to whichever segments are asking, so joining the sessions
+		 * of the busier locations levels out completion times when the
+		 * data is skewed across the URIs.
+		 */
+		if (gp_external_chain_urls && uri &&
+			(IS_GPFDIST_URI(uri) || IS_GPFDISTS_URI(uri)))
+		{
+			int			nuris = list_length(uriList);
+			int			i;
+
+			for (i = 1; i < nuris; i++)
+			{
+				Value	   *w = (Value *) list_nth(uriList, (idx + i) % nuris);
+
+				if (w->type == T_Null)
+					continue;
+				if (strcmp(strVal(w), uri) == 0)
+					continue;
+				if (list_member(scan->fs_morelocs, w))
+					continue;
+				scan->fs_morelocs = lappend(scan->fs_morelocs,
+											makeString(pstrdup(strVal(w))));
+			}
+		}
 	}
 	else if (Gp_role == GP_ROLE_DISPATCH && isMasterOnly)
 	{
@@ -268,6 +298,14 @@ external_beginscan(Relation relation, uint32 scancounter,
 	InitParseState(scan->fs_pstate, relation, NULL, NULL, false, fmtOpts, fmtType,
 				scan->fs_uri, rejLimit, rejLimitInRows, logErrors, encoding);
 
+	/*
+	 * URI chaining passes the header flag of the moment to each gpfdist it
+	 * opens, and by the second open the header was already consumed. Rather
+	 * than misinform the server, don't chain HEADER tables.
+	 */
+	if (scan->fs_pstate->header_line)
+		scan->fs_morelocs = NIL;
+
 	if (fmttype_is_custom(fmtType))
 	{
 		scan->fs_formatter = (FormatterData *) palloc0(sizeof(FormatterData));
@@ -915,7 +953,7 @@ externalgettup_defined(FileScanDesc scan)
 		/* need to fill our buffer with data? */
 		if (pstate->raw_buf_done)
 		{
-			pstate->bytesread = external_getdata(scan->fs_file, pstate, RAW_BUF_SIZE);
+			pstate->bytesread = external_getdata(scan, pstate, RAW_BUF_SIZE);
 			pstate->begloc = pstate->raw_buf;
 			pstate->raw_buf_done = (pstate->bytesread == 0);
 			pstate->raw_buf_index = 0;
@@ -1024,7 +1062,7 @@ externalgettup_custom(FileScanDesc scan)
 		/* need to fill our buffer with data? */
 		if (pstate->raw_buf_done)
 		{
-			int			bytesread = external_getdata(scan->fs_file, pstate, RAW_BUF_SIZE);
+			int			bytesread = external_getdata(scan, pstate, RAW_BUF_SIZE);
 
 			if (bytesread > 0)
 				appendBinaryStringInfo(&formatter->fmt_databuf, pstate->raw_buf, bytesread);
@@ -1606,7 +1644,7 @@ open_external_writable_source(ExternalInsertDesc extInsertDesc)
  * get a chunk of data from the external data file.
  */
 static int
-external_getdata(URL_FILE *extfile, CopyState pstate, int maxread)
+external_getdata(FileScanDesc scan, CopyState pstate, int maxread)
 {
 	int			bytesread = 0;
 
@@ -1617,24 +1655,50 @@ external_getdata(URL_FILE *extfile, CopyState pstate, int maxread)
 	 * result in skipping the last line.
 	 */
 
+	for (;;)
+	{
+		bytesread = url_fread((void *) pstate->raw_buf, maxread, scan->fs_file, pstate);
 
-	bytesread = url_fread((void *) pstate->raw_buf, maxread, extfile, pstate);
+		if (url_feof(scan->fs_file, bytesread))
+		{
+			if (scan->fs_morelocs != NIL)
+			{
+				/*
+				 * This URI is drained, but more locations were lined up for
+				 * us (see gp_external_chain_urls). Hop to the next one and
+				 * keep pulling; the scan only sees EOF once every location
+				 * is drained.
+				 */
+				if (bytesread == 0)
+				{
+					Value	   *v = (Value *) linitial(scan->fs_morelocs);
+
+					url_fclose(scan->fs_file, true, pstate->cur_relname);
+					scan->fs_file = NULL;
+					scan->fs_uri = strVal(v);
+					pstate->filename = scan->fs_uri;
+					scan->fs_morelocs = list_delete_first(scan->fs_morelocs);
+					open_external_readable_source(scan);
+					continue;
+				}
 
-	if (url_feof(extfile, bytesread))
-	{
-		pstate->fe_eof = true;
-	}
+				/* got data; switch URIs on the next call */
+			}
+			else
+				pstate->fe_eof = true;
+		}
 
-	if (bytesread <= 0)
-	{
-		if (url_ferror(extfile, bytesread, NULL, 0))
-			ereport(ERROR,
-					(errcode_for_file_access(),
-					 errmsg("could not read from external file: %m")));
+		if (bytesread <= 0)
+		{
+			if (url_ferror(scan->fs_file, bytesread, NULL, 0))
+				ereport(ERROR,
+						(errcode_for_file_access(),
+						 errmsg("could not read from external file: %m")));
 
-	}
+		}
 
-	return bytesread;
+		return bytesread;
+	}
 }
 
 /*
@@ -644,6 +644,27 @@ fill_buffer(URL_CURL_FILE *curl, int want)
 	   file->u.curl.still_running, curl->in.bot, curl->in.top, want);
 	*/
 
+	/*
+	 * Even when we already hold the requested bytes, opportunistically move
+	 * whatever has arrived in the kernel socket buffer into our application
+	 * buffer with one non-blocking pump of curl. While the backend is busy
+	 * forming tuples the socket buffer is the only readahead; once it fills,
+	 * the TCP receive window closes and gpfdist stops sending until we next
+	 * come up for air. Draining it on every read keeps the window open so the
+	 * transfer overlaps with parsing instead of alternating with it.
+	 */
+	if (curl->still_running && curl->in.top - curl->in.bot >= want)
+	{
+		while (CURLM_CALL_MULTI_PERFORM ==
+			   (e = curl_multi_perform(multi_handle, &curl->still_running)));
+
+		if (e != 0)
+		{
+			elog(ERROR, "internal error: curl_multi_perform failed (%d - %s)",
+				 e, curl_easy_strerror(e));
+		}
+	}
+
 	/* attempt to fill buffer */
 	while (curl->still_running && curl->in.top - curl->in.bot < want)
 	{
@@ -997,6 +1018,97 @@ extract_http_domain(char *i_path, char *o_domain, int dlen)
 	memcpy(o_domain, p_st, cpsz);
 }
 
+/*
+ * Per-backend cache of idle curl easy handles, keyed by the gpfdist
+ * endpoint ("host:port" as it appears in the resolved curl url).
+ *
+ * libcurl keeps established connections (and negotiated SSL sessions)
+ * inside the easy handle across curl_easy_reset(), so parking a handle
+ * here at fclose time and fishing it out again at the next fopen lets
+ * consecutive statements against the same gpfdist reuse the keep-alive
+ * TCP connection instead of paying connect (and, for gpfdists, SSL
+ * handshake) latency on every statement. Every curl option is set from
+ * scratch in url_curl_fopen(), so a reset handle behaves exactly like a
+ * freshly inited one.
+ *
+ * The parked handles deliberately live outside the curlhandle_t resource
+ * owner tracking: they belong to no query, and survive until evicted or
+ * the backend exits.
+ */
+#define IDLE_HANDLE_CACHE_SIZE	8
+
+typedef struct
+{
+	char		domain[HOST_NAME_SIZE];
+	CURL	   *handle;
+} idle_handle_slot_t;
+
+static idle_handle_slot_t idle_handle_cache[IDLE_HANDLE_CACHE_SIZE];
+static int	idle_handle_clock = 0;
+
+/*
+ * Fetch a parked handle for this endpoint, or NULL if none is cached.
+ */
+static CURL *
+get_cached_easy_handle(char *curl_url)
+{
+	char		domain[HOST_NAME_SIZE] = {0};
+	int			i;
+
+	extract_http_domain(curl_url, domain, HOST_NAME_SIZE - 1);
+
+	for (i = 0; i < IDLE_HANDLE_CACHE_SIZE; i++)
+	{
+		idle_handle_slot_t *slot = &idle_handle_cache[i];
+
+		if (slot->handle && strcmp(slot->domain, domain) == 0)
+		{
+			CURL	   *handle = slot->handle;
+
+			slot->handle = NULL;
+			return handle;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Park an easy handle for later reuse against the same endpoint. The
+ * handle is reset, which wipes all transfer state and options but keeps
+ * live connections around. If the cache is full, recycle a slot
+ * round-robin.
+ */
+static void
+put_cached_easy_handle(char *curl_url, CURL *handle)
+{
+	idle_handle_slot_t *slot = NULL;
+	int			i;
+
+	curl_easy_reset(handle);
+
+	for (i = 0; i < IDLE_HANDLE_CACHE_SIZE; i++)
+	{
+		if (idle_handle_cache[i].handle == NULL)
+		{
+			slot = &idle_handle_cache[i];
+			break;
+		}
+	}
+
+	if (slot == NULL)
+	{
+		slot = &idle_handle_cache[idle_handle_clock];
+		idle_handle_clock = (idle_handle_clock + 1) % IDLE_HANDLE_CACHE_SIZE;
+		curl_easy_cleanup(slot->handle);
+		slot->handle = NULL;
+	}
+
+	memset(slot->domain, 0, sizeof(slot->domain));
+	extract_http_domain(curl_url, slot->domain, HOST_NAME_SIZE - 1);
+	slot->handle = handle;
+}
+
 static bool
 url_has_ipv6_format (char *url)
 {
@@ -1097,8 +1209,14 @@ url_curl_fopen(char *url, bool forwrite, extvar_t *ev, CopyState pstate)
 		pstate->header_line = 0;
 	}
 
-	/* initialize a curl session and get a libcurl handle for it */
-	if (! (file->curl->handle = curl_easy_init()))
+	/*
+	 * Initialize a curl session and get a libcurl handle for it, reusing a
+	 * parked handle (with its keep-alive connection) when a previous
+	 * statement already talked to this endpoint.
+	 */
+	file->curl->handle = get_cached_easy_handle(file->curl_url);
+	if (file->curl->handle == NULL &&
+		!(file->curl->handle = curl_easy_init()))
 		elog(ERROR, "internal error: curl_easy_init failed");
 
 	CURL_EASY_SETOPT(file->curl->handle, CURLOPT_URL, file->curl_url);
@@ -1373,6 +1491,28 @@ url_curl_fclose(URL_FILE *fileg, bool failOnError, const char *relname)
 	if (file->for_write && file->curl->handle != NULL)
 		gp_proto0_write_done(file);
 
+	/*
+	 * Park the easy handle for reuse by the next statement that opens the
+	 * same endpoint, so its keep-alive connection survives across
+	 * statements. Skip handles whose transfer errored out; libcurl itself
+	 * refuses to reuse a connection with unread data on it, so parking
+	 * after an early close (e.g. on LIMIT) is safe.
+	 */
+	if (file->curl->handle != NULL && !file->error && file->curl_url != NULL)
+	{
+		if (file->curl->in_multi_handle)
+		{
+			CURLMcode	e = curl_multi_remove_handle(multi_handle, file->curl->handle);
+
+			if (CURLM_OK != e)
+				elog(WARNING, "internal error curl_multi_remove_handle (%d - %s)", e, curl_easy_strerror(e));
+			file->curl->in_multi_handle = false;
+		}
+
+		put_cached_easy_handle(file->curl_url, file->curl->handle);
+		file->curl->handle = NULL;
+	}
+
 	destroy_curlhandle(file->curl);
 	file->curl = NULL;
 
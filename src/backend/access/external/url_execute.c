@@ -14,6 +14,7 @@
 
 #include "postgres.h"
 
+#include <fcntl.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
@@ -27,6 +28,9 @@
 #define EXEC_DATA_P 0 /* index to data pipe */
 #define EXEC_ERR_P 1 /* index to error pipe  */
 
+/* requested capacity for the data pipe, where the OS lets us set one */
+#define EXEC_DATA_PIPE_SIZE (1024 * 1024)
+
 /*
  * This struct encapsulates the resources that need to be explicitly cleaned up
  * on error. We use the resource owner mechanism to make sure
@@ -622,6 +626,21 @@ popen_with_stderr(int *pipes, const char *exe, bool forwrite)
 		close(data[WRITE]);
 		return -1;
 	}
+
+#ifdef F_SETPIPE_SZ
+
+	/*
+	 * Ask the kernel for a bigger data pipe.  The command on the other end
+	 * is usually a streaming producer (for gphdfs, the Hadoop connector
+	 * JVM), and the Linux default of 64kB forces a wakeup on both sides
+	 * every few reads.  A bigger pipe lets each side move data in larger
+	 * chunks and decouples their scheduling.  This is best-effort: the
+	 * kernel caps the size at fs/pipe-max-size for unprivileged processes
+	 * and we simply keep the default capacity if the call fails.
+	 */
+	(void) fcntl(data[WRITE], F_SETPIPE_SZ, EXEC_DATA_PIPE_SIZE);
+#endif
+
 #ifndef WIN32
 
 	pid = fork();
@@ -30,11 +30,17 @@
 #include <unistd.h>
 #include <fcntl.h>
 
+#ifdef HAVE_LIBLZ4
+#include <lz4.h>
+#endif
+
 #include "access/genam.h"
 #include "access/heapam.h"
+#include "access/reloptions.h"
 #include "access/tuptoaster.h"
 #include "access/xact.h"
 #include "catalog/catalog.h"
+#include "utils/attoptcache.h"
 #include "utils/fmgroids.h"
 #include "utils/pg_lzcompress.h"
 #include "utils/rel.h"
@@ -57,6 +63,19 @@
 #define VARATT_EXTERNAL_IS_COMPRESSED(toast_pointer) \
 	((toast_pointer).va_extsize < (toast_pointer).va_rawsize - VARHDRSZ)
 
+/*
+ * A compressed varlena starts with a PGLZ_Header whose rawsize word holds
+ * the uncompressed payload size.  Since toastable values are less than 1GB,
+ * the two high bits of that word are always zero, and we use one of them to
+ * flag values compressed with lz4 instead of pglz.  Values written before
+ * this existed have the bit clear and keep decompressing with pglz.
+ */
+#define TOAST_COMPRESS_LZ4_FLAG		0x40000000
+#define TOAST_COMPRESS_RAWSIZE(ptr) \
+	(((PGLZ_Header *) (ptr))->rawsize & ~TOAST_COMPRESS_LZ4_FLAG)
+#define TOAST_COMPRESS_IS_LZ4(ptr) \
+	((((PGLZ_Header *) (ptr))->rawsize & TOAST_COMPRESS_LZ4_FLAG) != 0)
+
 /*
  * Macro to fetch the possibly-unaligned contents of an EXTERNAL datum
  * into a local "struct varatt_external" toast pointer.  This should be
@@ -77,6 +96,8 @@ do { \
 
 static void toast_delete_datum(Relation rel, Datum value);
 static Datum toast_save_datum(Relation rel, Datum value, bool isFrozen, int options);
+static int	toast_compression_method(Relation rel, AttrNumber attnum);
+static struct varlena *toast_decompress_datum(struct varlena * attr);
 static struct varlena *toast_fetch_datum(struct varlena * attr);
 static struct varlena *toast_fetch_datum_slice(struct varlena * attr,
 						int32 sliceoffset, int32 length);
@@ -148,8 +169,7 @@ varattrib_untoast_len(Datum d)
 
 		if (VARATT_IS_COMPRESSED(attr))
 		{
-			PGLZ_Header *tmp = (PGLZ_Header *) attr;
-			len = PGLZ_RAW_SIZE(tmp);
+			len = TOAST_COMPRESS_RAWSIZE(attr);
 		}
 		else if (VARATT_IS_SHORT(attr))
 		{
@@ -198,13 +218,12 @@ varattrib_untoast_ptr_len(Datum d, char **datastart, int *len, void **tofree)
 
 		if (VARATT_IS_COMPRESSED(attr))
 		{
-			PGLZ_Header *tmp = (PGLZ_Header *) attr;
-			attr = (struct varlena *) palloc(PGLZ_RAW_SIZE(tmp) + VARHDRSZ);
-			SET_VARSIZE(attr, PGLZ_RAW_SIZE(tmp) + VARHDRSZ);
-			pglz_decompress(tmp, VARDATA(attr));
+			struct varlena *tmp = attr;
+
+			attr = toast_decompress_datum(tmp);
 
-			/* If tofree is set, that is, we get it from toast_fetch_datum.  
-			 * We need to free it here 
+			/* If tofree is set, that is, we get it from toast_fetch_datum.
+			 * We need to free it here
 			 */
 			if(*tofree)
 				pfree(*tofree);
@@ -247,11 +266,9 @@ heap_tuple_untoast_attr(struct varlena * attr)
 		/* If it's compressed, decompress it */
 		if (VARATT_IS_COMPRESSED(attr))
 		{
-			PGLZ_Header *tmp = (PGLZ_Header *) attr;
+			struct varlena *tmp = attr;
 
-			attr = (struct varlena *) palloc(PGLZ_RAW_SIZE(tmp) + VARHDRSZ);
-			SET_VARSIZE(attr, PGLZ_RAW_SIZE(tmp) + VARHDRSZ);
-			pglz_decompress(tmp, VARDATA(attr));
+			attr = toast_decompress_datum(tmp);
 			pfree(tmp);
 		}
 	}
@@ -260,11 +277,7 @@ heap_tuple_untoast_attr(struct varlena * attr)
 		/*
 		 * This is a compressed value inside of the main tuple
 		 */
-		PGLZ_Header *tmp = (PGLZ_Header *) attr;
-
-		attr = (struct varlena *) palloc(PGLZ_RAW_SIZE(tmp) + VARHDRSZ);
-		SET_VARSIZE(attr, PGLZ_RAW_SIZE(tmp) + VARHDRSZ);
-		pglz_decompress(tmp, VARDATA(attr));
+		attr = toast_decompress_datum(attr);
 	}
 	else if (VARATT_IS_SHORT(attr))
 	{
@@ -319,14 +332,11 @@ heap_tuple_untoast_attr_slice(struct varlena * attr,
 
 	if (VARATT_IS_COMPRESSED(preslice))
 	{
-		PGLZ_Header *tmp = (PGLZ_Header *) preslice;
-		Size		size = PGLZ_RAW_SIZE(tmp) + VARHDRSZ;
+		struct varlena *tmp = preslice;
 
-		preslice = (struct varlena *) palloc(size);
-		SET_VARSIZE(preslice, size);
-		pglz_decompress(tmp, VARDATA(preslice));
+		preslice = toast_decompress_datum(tmp);
 
-		if (tmp != (PGLZ_Header *) attr)
+		if (tmp != attr)
 			pfree(tmp);
 	}
 
@@ -388,7 +398,7 @@ toast_raw_datum_size(Datum value)
 	else if (VARATT_IS_COMPRESSED(attr))
 	{
 		/* here, va_rawsize is just the payload size */
-		result = VARRAWSIZE_4B_C(attr) + VARHDRSZ;
+		result = TOAST_COMPRESS_RAWSIZE(attr) + VARHDRSZ;
 	}
 	else if (VARATT_IS_SHORT(attr))
 	{
@@ -802,7 +812,8 @@ toast_insert_or_update_generic(Relation rel, GenericTuple newtup, GenericTuple o
 		if (att[i]->attstorage == 'x')
 		{
 			old_value = toast_values[i];
-			new_value = toast_compress_datum(old_value);
+			new_value = toast_compress_datum(old_value,
+											 toast_compression_method(rel, att[i]->attnum));
 
 			if (DatumGetPointer(new_value) != NULL)
 			{
@@ -939,7 +950,8 @@ toast_insert_or_update_generic(Relation rel, GenericTuple newtup, GenericTuple o
 		 */
 		i = biggest_attno;
 		old_value = toast_values[i];
-		new_value = toast_compress_datum(old_value);
+		new_value = toast_compress_datum(old_value,
+										 toast_compression_method(rel, att[i]->attnum));
 
 		if (DatumGetPointer(new_value) != NULL)
 		{
@@ -1382,7 +1394,7 @@ toast_flatten_tuple_attribute(Datum value,
  * ----------
  */
 Datum
-toast_compress_datum(Datum value)
+toast_compress_datum(Datum value, int cmethod)
 {
 	struct varlena *tmp;
 	int32		valsize = VARSIZE_ANY_EXHDR(DatumGetPointer(value));
@@ -1398,6 +1410,35 @@ toast_compress_datum(Datum value)
 		valsize > PGLZ_strategy_default->max_input_size)
 		return PointerGetDatum(NULL);
 
+#ifdef HAVE_LIBLZ4
+	if (cmethod == TOAST_COMPRESSION_LZ4)
+	{
+		int32		bound = LZ4_compressBound(valsize);
+		int32		clen;
+
+		tmp = (struct varlena *) palloc(bound + sizeof(PGLZ_Header));
+		clen = LZ4_compress_default(VARDATA_ANY(DatumGetPointer(value)),
+									(char *) tmp + sizeof(PGLZ_Header),
+									valsize, bound);
+
+		/* Insist on the same > 2 byte savings the pglz path requires */
+		if (clen > 0 &&
+			clen + (int32) sizeof(PGLZ_Header) < valsize - 2)
+		{
+			SET_VARSIZE_COMPRESSED(tmp, clen + sizeof(PGLZ_Header));
+			((PGLZ_Header *) tmp)->rawsize = valsize | TOAST_COMPRESS_LZ4_FLAG;
+			return PointerGetDatum(tmp);
+		}
+
+		/* incompressible data */
+		pfree(tmp);
+		return PointerGetDatum(NULL);
+	}
+#else
+	/* Column marked lz4 by a build that had it; fall back to pglz */
+	(void) cmethod;
+#endif
+
 	tmp = (struct varlena *) palloc(PGLZ_MAX_OUTPUT(valsize));
 
 	/*
@@ -1426,6 +1467,72 @@ toast_compress_datum(Datum value)
 }
 
 
+/* ----------
+ * toast_compression_method -
+ *
+ *	Which compression method to use for a column, from the column's
+ *	attoptions (ALTER TABLE ... ALTER COLUMN ... SET (compresstype=...)).
+ *	Columns with no setting keep compressing with pglz, so existing
+ *	tables are unaffected.
+ * ----------
+ */
+static int
+toast_compression_method(Relation rel, AttrNumber attnum)
+{
+	AttributeOpts *aopts;
+	char	   *type;
+
+	aopts = get_attribute_options(RelationGetRelid(rel), attnum);
+	if (aopts == NULL)
+		return TOAST_COMPRESSION_PGLZ;
+
+	type = GET_STRING_RELOPTION(aopts, compresstype);
+	if (type != NULL && pg_strcasecmp(type, "lz4") == 0)
+		return TOAST_COMPRESSION_LZ4;
+
+	return TOAST_COMPRESSION_PGLZ;
+}
+
+
+/* ----------
+ * toast_decompress_datum -
+ *
+ *	Decompress a compressed varlena, dispatching on the compression
+ *	method recorded in its header.
+ * ----------
+ */
+static struct varlena *
+toast_decompress_datum(struct varlena * attr)
+{
+	struct varlena *result;
+	int32		rawsize = TOAST_COMPRESS_RAWSIZE(attr);
+
+	Assert(VARATT_IS_COMPRESSED(attr));
+
+	result = (struct varlena *) palloc(rawsize + VARHDRSZ);
+	SET_VARSIZE(result, rawsize + VARHDRSZ);
+
+	if (TOAST_COMPRESS_IS_LZ4(attr))
+	{
+#ifdef HAVE_LIBLZ4
+		if (LZ4_decompress_safe((char *) attr + sizeof(PGLZ_Header),
+								VARDATA(result),
+								VARSIZE(attr) - sizeof(PGLZ_Header),
+								rawsize) != rawsize)
+			elog(ERROR, "compressed lz4 data is corrupt");
+#else
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("value was compressed with lz4, which is not supported by this build")));
+#endif
+	}
+	else
+		pglz_decompress((PGLZ_Header *) attr, VARDATA(result));
+
+	return result;
+}
+
+
 /* ----------
  * toast_save_datum -
  *
@@ -1487,7 +1594,7 @@ toast_save_datum(Relation rel, Datum value, bool isFrozen, int options)
 		data_p = VARDATA(dval);
 		data_todo = VARSIZE(dval) - VARHDRSZ;
 		/* rawsize in a compressed datum is just the size of the payload */
-		toast_pointer.va_rawsize = VARRAWSIZE_4B_C(dval) + VARHDRSZ;
+		toast_pointer.va_rawsize = TOAST_COMPRESS_RAWSIZE(dval) + VARHDRSZ;
 		toast_pointer.va_extsize = data_todo;
 		/* Assert that the numbers look like it's compressed */
 		Assert(VARATT_EXTERNAL_IS_COMPRESSED(toast_pointer));
@@ -1528,7 +1635,7 @@ toast_save_datum(Relation rel, Datum value, bool isFrozen, int options)
 		Assert(VARATT_EXTERNAL_IS_COMPRESSED(toast_pointer));
 		elog(DEBUG4,
 			 "saved toast datum, original varsize %ud rawsize %ud new extsize %ud rawsize %uld\n", 
-			 VARSIZE(value), VARRAWSIZE_4B_C(value) + VARHDRSZ,
+			 VARSIZE(value), TOAST_COMPRESS_RAWSIZE(value) + VARHDRSZ,
 			 toast_pointer.va_extsize, toast_pointer.va_rawsize);
 	}
 	else
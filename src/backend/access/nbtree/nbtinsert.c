@@ -108,31 +108,94 @@ _bt_doinsert(Relation rel, IndexTuple itup,
 	bool		is_unique = false;
 	int			natts = rel->rd_rel->relnatts;
 	ScanKey		itup_scankey;
-	BTStack		stack;
+	BTStack		stack = NULL;
 	Buffer		buf;
 	OffsetNumber offset;
+	bool		fastpath;
 
 	/* we need an insertion scan key to do our search, so build one */
 	itup_scankey = _bt_mkscankey(rel, itup);
 
 top:
-	/* find the first page containing this key */
-	stack = _bt_search(rel, natts, itup_scankey, false, &buf, BT_WRITE);
-
-	offset = InvalidOffsetNumber;
-
-	/* trade in our read lock for a write lock */
-	LockBuffer(buf, BUFFER_LOCK_UNLOCK);
-	LockBuffer(buf, BT_WRITE);
+	fastpath = false;
 
 	/*
-	 * If the page was split between the time that we surrendered our read
-	 * lock and acquired our write lock, then this page may no longer be the
-	 * right place for the key we want to insert.  In this case, we need to
-	 * move right in the tree.	See Lehman and Yao for an excruciatingly
-	 * precise description.
+	 * Ordered loads (serial keys, timestamps, bulk appends) insert every
+	 * tuple on the rightmost leaf page, yet each insertion would descend
+	 * the whole tree.  _bt_insertonpg caches the rightmost leaf it last
+	 * inserted on in rd_targblock; if the new key is strictly greater
+	 * than every key on that page and it still has room, we can insert
+	 * there directly and skip the descent.  All conditions are re-checked
+	 * while holding the write lock, so a stale hint is simply discarded.
 	 */
-	buf = _bt_moveright(rel, buf, natts, itup_scankey, false, BT_WRITE);
+	if (RelationGetTargetBlock(rel) != InvalidBlockNumber)
+	{
+		Size		itemsz;
+		Page		page;
+		BTPageOpaque lpageop;
+
+		buf = ReadBuffer(rel, RelationGetTargetBlock(rel));
+
+		/* don't wait for the lock; the normal descent path is the backup */
+		if (ConditionalLockBuffer(buf))
+		{
+			_bt_checkpage(rel, buf);
+
+			page = BufferGetPage(buf);
+			lpageop = (BTPageOpaque) PageGetSpecialPointer(page);
+
+			itemsz = IndexTupleDSize(*itup);
+			itemsz = MAXALIGN(itemsz);
+
+			/*
+			 * The page must still be the non-dead rightmost leaf, have
+			 * room for the new tuple, and sort strictly after its last
+			 * key (and hence after every key in the index).  Requiring
+			 * free space up front also means the insertion cannot split,
+			 * so passing a NULL stack to _bt_insertonpg is safe.
+			 */
+			if (P_ISLEAF(lpageop) && P_RIGHTMOST(lpageop) &&
+				!P_IGNORE(lpageop) &&
+				PageGetFreeSpace(page) > itemsz &&
+				PageGetMaxOffsetNumber(page) >= P_FIRSTDATAKEY(lpageop) &&
+				_bt_compare(rel, natts, itup_scankey, page,
+							PageGetMaxOffsetNumber(page)) > 0)
+			{
+				fastpath = true;
+			}
+			else
+			{
+				_bt_relbuf(rel, buf);
+				RelationSetTargetBlock(rel, InvalidBlockNumber);
+			}
+		}
+		else
+		{
+			ReleaseBuffer(buf);
+			RelationSetTargetBlock(rel, InvalidBlockNumber);
+		}
+	}
+
+	if (!fastpath)
+	{
+		/* find the first page containing this key */
+		stack = _bt_search(rel, natts, itup_scankey, false, &buf, BT_WRITE);
+
+		/* trade in our read lock for a write lock */
+		LockBuffer(buf, BUFFER_LOCK_UNLOCK);
+		LockBuffer(buf, BT_WRITE);
+
+		/*
+		 * If the page was split between the time that we surrendered our
+		 * read lock and acquired our write lock, then this page may no
+		 * longer be the right place for the key we want to insert.  In this
+		 * case, we need to move right in the tree.  See Lehman and Yao for
+		 * an excruciatingly precise description.
+		 */
+		buf = _bt_moveright(rel, buf, natts, itup_scankey, false, BT_WRITE);
+	}
+
+	offset = InvalidOffsetNumber;
 
 	/*
 	 * If we're not allowing duplicates, make sure the key isn't already in
@@ -175,6 +238,7 @@ top:
 			XactLockTableWait(xwait);
 			/* start over... */
 			_bt_freestack(stack);
+			stack = NULL;
 			goto top;
 		}
 	}
@@ -955,6 +1019,15 @@ _bt_insertonpg(Relation rel,
 			_bt_relbuf(rel, metabuf);
 		}
 
+		/*
+		 * Remember the rightmost leaf page so the next _bt_doinsert in
+		 * this backend can try inserting there without descending the
+		 * tree.  The hint is re-verified under lock before use, so it's
+		 * fine if the page splits or empties in the meantime.
+		 */
+		if (P_ISLEAF(lpageop) && P_RIGHTMOST(lpageop))
+			RelationSetTargetBlock(rel, itup_blkno);
+
 		_bt_relbuf(rel, buf);
 	}
 }
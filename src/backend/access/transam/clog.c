@@ -410,6 +410,52 @@ TransactionIdGetStatus(TransactionId xid, XLogRecPtr *lsn)
 	return status;
 }
 
+/*
+ * Interrogate the state of a batch of transactions in the commit log.
+ *
+ * Fills status[i] and lsn[i] for each xids[i], with the same semantics as
+ * TransactionIdGetStatus().  Consecutive xids that fall on the same clog
+ * page are resolved during a single page visit, so CLogControlLock is taken
+ * once per page instead of once per xid.  Callers chasing neighboring xids
+ * (e.g. the tail of a bulk load) should therefore pass the vector in
+ * ascending xid order; an unordered vector is still answered correctly, it
+ * just batches less.
+ *
+ * NB: as with TransactionIdGetStatus(), this is a low-level routine;
+ * TransactionIdFetchStatusBatch() in transam.c is the intended caller.
+ */
+void
+TransactionIdGetStatusBatch(int nxids, const TransactionId *xids,
+							XidStatus *status, XLogRecPtr *lsn)
+{
+	int			i = 0;
+
+	while (i < nxids)
+	{
+		int			pageno = TransactionIdToPage(xids[i]);
+		int			slotno;
+
+		/* lock is acquired by SimpleLruReadPage_ReadOnly */
+
+		slotno = SimpleLruReadPage_ReadOnly(ClogCtl, pageno, xids[i]);
+
+		do
+		{
+			TransactionId xid = xids[i];
+			int			byteno = TransactionIdToByte(xid);
+			int			bshift = TransactionIdToBIndex(xid) * CLOG_BITS_PER_XACT;
+			char	   *byteptr;
+
+			byteptr = ClogCtl->shared->page_buffer[slotno] + byteno;
+			status[i] = (*byteptr >> bshift) & CLOG_XACT_BITMASK;
+			lsn[i] = ClogCtl->shared->group_lsn[GetLSNIndex(slotno, xid)];
+			i++;
+		} while (i < nxids && TransactionIdToPage(xids[i]) == pageno);
+
+		LWLockRelease(CLogControlLock);
+	}
+}
+
 /*
  * Find the next lowest transaction with a logged or recorded status.
  * I.e. One that does not have a status of default (0) -- i.e: in-progress.
@@ -418,7 +418,17 @@ DistributedLog_CommittedCheck(
 	DistributedLogEntry *ptr;
 	TransactionId oldestXmin;
 
-	LWLockAcquire(DistributedLogControlLock, LW_EXCLUSIVE);
+	/*
+	 * This sits on the visibility-check path of every tuple examined under
+	 * a distributed snapshot, so take the control lock in shared mode for
+	 * the oldestXmin check and let SimpleLruReadPage_ReadOnly() do the
+	 * same for the page read (it only escalates to exclusive on a buffer
+	 * miss), the same way the clog and subtrans readers do. Like those
+	 * readers, we don't recheck oldestXmin after re-acquiring the lock:
+	 * truncation is far behind the horizon of anything still being looked
+	 * up here.
+	 */
+	LWLockAcquire(DistributedLogControlLock, LW_SHARED);
 
 	oldestXmin = DistributedLogShared->oldestXmin;
 	if (oldestXmin == InvalidTransactionId)
@@ -433,7 +443,10 @@ DistributedLog_CommittedCheck(
 		return false;
 	}
 
-	slotno = SimpleLruReadPage(DistributedLogCtl, page, true, localXid);
+	LWLockRelease(DistributedLogControlLock);
+
+	/* lock is re-acquired by SimpleLruReadPage_ReadOnly */
+	slotno = SimpleLruReadPage_ReadOnly(DistributedLogCtl, page, localXid);
 	ptr = (DistributedLogEntry *) DistributedLogCtl->shared->page_buffer[slotno];
 	ptr += entryno;
 	*distribTimeStamp = ptr->distribTimeStamp;
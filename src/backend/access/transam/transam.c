@@ -26,14 +26,35 @@
 
 
 /*
- * Single-item cache for results of TransactionLogFetch.  It's worth having
- * such a cache because we frequently find ourselves repeatedly checking the
- * same XID, for example when scanning a table just after a bulk insert,
- * update, or delete.
+ * Small cache for results of TransactionLogFetch.  It's worth having such a
+ * cache because we frequently find ourselves repeatedly checking the same
+ * XID, for example when scanning a table just after a bulk insert, update,
+ * or delete.  An update-churned heap page typically carries a handful of
+ * distinct XIDs repeated across its tuples, so we keep the last few
+ * completed XIDs in a direct-mapped table rather than only the most recent
+ * one; that way one page's worth of visibility checks usually resolves
+ * without going back to clog at all.
  */
-static TransactionId cachedFetchXid = InvalidTransactionId;
-static XidStatus cachedFetchXidStatus;
-static XLogRecPtr cachedCommitLSN;
+#define NUM_CACHED_FETCH_XIDS	8
+
+typedef struct CachedFetchEnt
+{
+	TransactionId xid;
+	XidStatus	status;
+	XLogRecPtr	commitLSN;
+} CachedFetchEnt;
+
+static CachedFetchEnt cachedFetchXids[NUM_CACHED_FETCH_XIDS];
+
+#define CachedFetchSlot(xid) \
+	(&cachedFetchXids[(xid) % NUM_CACHED_FETCH_XIDS])
+
+/*
+ * Chunk size for TransactionIdFetchStatusBatch.  Callers may pass vectors of
+ * any length; we chop them up internally so the scratch arrays fit on the
+ * stack.
+ */
+#define XID_FETCH_BATCH_SIZE	64
 
 /* Handy constant for an invalid xlog recptr */
 static const XLogRecPtr InvalidXLogRecPtr = {0, 0};
@@ -57,13 +78,15 @@ TransactionLogFetch(TransactionId transactionId)
 {
 	XidStatus	xidstatus;
 	XLogRecPtr	xidlsn;
+	CachedFetchEnt *ent;
 
 	/*
-	 * Before going to the commit log manager, check our single item cache to
-	 * see if we didn't just check the transaction status a moment ago.
+	 * Before going to the commit log manager, check our cache to see if we
+	 * didn't just check the transaction status a moment ago.
 	 */
-	if (TransactionIdEquals(transactionId, cachedFetchXid))
-		return cachedFetchXidStatus;
+	ent = CachedFetchSlot(transactionId);
+	if (TransactionIdEquals(transactionId, ent->xid))
+		return ent->status;
 
 	/*
 	 * Also, check to see if the transaction ID is a permanent one.
@@ -89,14 +112,93 @@ TransactionLogFetch(TransactionId transactionId)
 	if (xidstatus != TRANSACTION_STATUS_IN_PROGRESS &&
 		xidstatus != TRANSACTION_STATUS_SUB_COMMITTED)
 	{
-		cachedFetchXid = transactionId;
-		cachedFetchXidStatus = xidstatus;
-		cachedCommitLSN = xidlsn;
+		ent->xid = transactionId;
+		ent->status = xidstatus;
+		ent->commitLSN = xidlsn;
 	}
 
 	return xidstatus;
 }
 
+/*
+ * TransactionIdFetchStatusBatch --- fetch commit status of a vector of xids
+ *
+ * On return, status[i] holds the status of xids[i].  Xids answered by the
+ * local cache or recognized as permanent never touch clog; the remaining
+ * ones are resolved through TransactionIdGetStatusBatch(), which visits each
+ * clog page only once for the xids that live on it.  Pass the vector in
+ * ascending xid order to get the full benefit.  Results for completed
+ * transactions are entered into the cache, so subsequent per-xid checks
+ * (e.g. TransactionIdDidCommit() on the same tuples) hit the cache too.
+ */
+void
+TransactionIdFetchStatusBatch(int nxids, const TransactionId *xids,
+							  XidStatus *status)
+{
+	while (nxids > 0)
+	{
+		TransactionId missXid[XID_FETCH_BATCH_SIZE];
+		int			missPos[XID_FETCH_BATCH_SIZE];
+		XidStatus	missStatus[XID_FETCH_BATCH_SIZE];
+		XLogRecPtr	missLsn[XID_FETCH_BATCH_SIZE];
+		int			nmiss = 0;
+		int			chunk = Min(nxids, XID_FETCH_BATCH_SIZE);
+		int			i;
+
+		for (i = 0; i < chunk; i++)
+		{
+			TransactionId xid = xids[i];
+			CachedFetchEnt *ent = CachedFetchSlot(xid);
+
+			if (TransactionIdEquals(xid, ent->xid))
+			{
+				status[i] = ent->status;
+				continue;
+			}
+			if (!TransactionIdIsNormal(xid))
+			{
+				if (TransactionIdEquals(xid, BootstrapTransactionId) ||
+					TransactionIdEquals(xid, FrozenTransactionId))
+					status[i] = TRANSACTION_STATUS_COMMITTED;
+				else
+					status[i] = TRANSACTION_STATUS_ABORTED;
+				continue;
+			}
+			missXid[nmiss] = xid;
+			missPos[nmiss] = i;
+			nmiss++;
+		}
+
+		if (nmiss > 0)
+		{
+			TransactionIdGetStatusBatch(nmiss, missXid, missStatus, missLsn);
+
+			for (i = 0; i < nmiss; i++)
+			{
+				status[missPos[i]] = missStatus[i];
+
+				/*
+				 * Cache it, subject to the same rule as TransactionLogFetch:
+				 * never cache status that could still change.
+				 */
+				if (missStatus[i] != TRANSACTION_STATUS_IN_PROGRESS &&
+					missStatus[i] != TRANSACTION_STATUS_SUB_COMMITTED)
+				{
+					CachedFetchEnt *ent = CachedFetchSlot(missXid[i]);
+
+					ent->xid = missXid[i];
+					ent->status = missStatus[i];
+					ent->commitLSN = missLsn[i];
+				}
+			}
+		}
+
+		xids += chunk;
+		status += chunk;
+		nxids -= chunk;
+	}
+}
+
 /* ----------------------------------------------------------------
  *						Interface functions
  *
@@ -241,7 +343,7 @@ TransactionIdDidAbort(TransactionId transactionId)
 bool
 TransactionIdIsKnownCompleted(TransactionId transactionId)
 {
-	if (TransactionIdEquals(transactionId, cachedFetchXid))
+	if (TransactionIdEquals(transactionId, CachedFetchSlot(transactionId)->xid))
 	{
 		/* If it's in the cache at all, it must be completed. */
 		return true;
@@ -413,8 +515,8 @@ TransactionIdGetCommitLSN(TransactionId xid)
 	 * checking TransactionLogFetch's cache will usually succeed and avoid an
 	 * extra trip to shared memory.
 	 */
-	if (TransactionIdEquals(xid, cachedFetchXid))
-		return cachedCommitLSN;
+	if (TransactionIdEquals(xid, CachedFetchSlot(xid)->xid))
+		return CachedFetchSlot(xid)->commitLSN;
 
 	/* Special XIDs are always known committed */
 	if (!TransactionIdIsNormal(xid))
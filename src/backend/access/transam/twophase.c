@@ -76,6 +76,10 @@
 /* GUC variable, can't be changed after startup */
 int			max_prepared_xacts = 0;
 
+/* group commit knobs, shared with RecordTransactionCommit (see xact.c) */
+extern int	CommitDelay;
+extern int	CommitSiblings;
+
 /*
  * This struct describes one global transaction that is in prepared state
  * or attempting to become prepared.
@@ -1126,7 +1130,6 @@ EndPrepare(GlobalTransaction gxact)
 {
 	TransactionId xid = gxact->proc.xid;
 	TwoPhaseFileHeader *hdr;
-	char		path[MAXPGPATH];
 
 	/* Add the end sentinel to the list of 2PC records */
 	RegisterTwoPhaseRecord(TWOPHASE_RM_END_ID, 0,
@@ -1147,24 +1150,16 @@ EndPrepare(GlobalTransaction gxact)
 				 errmsg("two-phase state file maximum length exceeded")));
 
 	/*
-	 * Create the 2PC state file.
+	 * No 2PC state file is created: the PREPARE record in the WAL is the
+	 * only persistent copy of the state data.  Its begin location is
+	 * remembered in the gxact (and in the crash-recovery map below) so that
+	 * FinishPreparedTransaction can re-read it directly from the log.
 	 *
-	 * Note: because we use BasicOpenFile(), we are responsible for ensuring
-	 * the FD gets closed in any error exit path.  Once we get into the
-	 * critical section, though, it doesn't matter since any failure causes
-	 * PANIC anyway.
-	 */
-	TwoPhaseFilePath(path, xid);
-
-	/*
 	 * We have to set inCommit here, too; otherwise a checkpoint starting
 	 * immediately after the WAL record is inserted could complete without
-	 * fsync'ing our state file.  (This is essentially the same kind of race
-	 * condition as the COMMIT-to-clog-write case that RecordTransactionCommit
-	 * uses inCommit for; see notes there.)
-	 *
-	 * We save the PREPARE record's location in the gxact for later use by
-	 * CheckPointTwoPhase.
+	 * fsync'ing our prepare record.  (This is essentially the same kind of
+	 * race condition as the COMMIT-to-clog-write case that
+	 * RecordTransactionCommit uses inCommit for; see notes there.)
 	 *
 	 * NOTE: Critical section and CheckpointStartLock were moved up.
 	 */
@@ -1178,6 +1173,17 @@ EndPrepare(GlobalTransaction gxact)
 	/* Add the prepared record to our global list */
 	add_recover_post_checkpoint_prepared_transactions_map_entry(xid, &gxact->prepare_begin_lsn, "EndPrepare");
 
+	/*
+	 * In Greenplum every distributed write comes through here on the
+	 * segments, not through RecordTransactionCommit, so honor the
+	 * commit_delay group commit window before flushing: with enough
+	 * concurrently preparing backends one fsync covers several PREPARE
+	 * records.
+	 */
+	if (CommitDelay > 0 && enableFsync &&
+		CountActiveBackends() >= CommitSiblings)
+		pg_usleep(CommitDelay);
+
 	XLogFlush(gxact->prepare_lsn);
 
 	/*
@@ -1336,8 +1342,22 @@ FinishPreparedTransaction(const char *gid, bool isCommit, bool raiseErrorIfNotFo
      */
     XLogReadRecoveryCommandFile(DEBUG5);
 
-    /* Now we can determine the list of expected TLIs */
-    expectedTLIs = XLogReadTimeLineHistory(ThisTimeLineID);
+    /*
+     * Now we can determine the list of expected TLIs.  The list only changes
+     * on a timeline switch, so once we have built it for the current timeline
+     * we keep it around (in TopMemoryContext, since we will be called again
+     * in later transactions) rather than re-reading the timeline history file
+     * for every COMMIT/ROLLBACK PREPARED.  Note: don't free the old list; it
+     * may have been allocated in a memory context that is already gone.
+     */
+    if (expectedTLIs == NIL ||
+		(TimeLineID) linitial_int(expectedTLIs) != ThisTimeLineID)
+	{
+		MemoryContext oldcxt = MemoryContextSwitchTo(TopMemoryContext);
+
+		expectedTLIs = XLogReadTimeLineHistory(ThisTimeLineID);
+		MemoryContextSwitchTo(oldcxt);
+	}
 
 
     /* get the two phase information from the xlog */
@@ -1954,10 +1974,15 @@ RecordTransactionCommitPrepared(TransactionId xid,
 	recptr = XLogInsert(RM_XACT_ID, XLOG_XACT_COMMIT_PREPARED, rdata);
 
 	/*
-	 * We don't currently try to sleep before flush here ... nor is there any
-	 * support for async commit of a prepared xact (the very idea is probably
-	 * a contradiction)
+	 * Unlike upstream we do sleep before the flush when commit_delay is
+	 * set: COMMIT PREPARED is the normal commit path on a Greenplum
+	 * segment, so these are exactly the flushes group commit is meant to
+	 * amortize. There is still no support for async commit of a prepared
+	 * xact (the very idea is probably a contradiction).
 	 */
+	if (CommitDelay > 0 && enableFsync &&
+		CountActiveBackends() >= CommitSiblings)
+		pg_usleep(CommitDelay);
 
 	/* Flush XLOG to disk */
 	XLogFlush(recptr);
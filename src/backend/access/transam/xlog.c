@@ -26,6 +26,7 @@
 #include "access/clog.h"
 #include "access/multixact.h"
 #include "access/distributedlog.h"
+#include "access/htup.h"
 #include "access/subtrans.h"
 #include "access/transam.h"
 #include "access/tuptoaster.h"
@@ -2250,23 +2251,43 @@ XLogFlush(XLogRecPtr record)
 	/* initialize to given target; may increase below */
 	WriteRqstPtr = record;
 
-	/* read LogwrtResult and update local state */
+	/*
+	 * Now wait until we get the write lock, or someone else does the flush
+	 * for us.
+	 */
+	for (;;)
 	{
 		/* use volatile pointer to prevent code rearrangement */
 		volatile XLogCtlData *xlogctl = XLogCtl;
 
+		/* read LogwrtResult and update local state */
 		SpinLockAcquire(&xlogctl->info_lck);
 		if (XLByteLT(WriteRqstPtr, xlogctl->LogwrtRqst.Write))
 			WriteRqstPtr = xlogctl->LogwrtRqst.Write;
 		LogwrtResult = xlogctl->LogwrtResult;
 		SpinLockRelease(&xlogctl->info_lck);
-	}
 
-	/* done already? */
-	if (!XLByteLE(record, LogwrtResult.Flush))
-	{
-		/* now wait for the write lock */
-		LWLockAcquire(WALWriteLock, LW_EXCLUSIVE);
+		/* done already? */
+		if (XLByteLE(record, LogwrtResult.Flush))
+			break;
+
+		/*
+		 * Try to get the write lock.  If we can't get it immediately, wait
+		 * until it's released, and recheck if we still need to do the flush
+		 * or if the backend that held the lock did it for us already.  This
+		 * helps to maintain a good rate of group committing when the system
+		 * is bottlenecked by the speed that the WAL can be written to disk.
+		 */
+		if (!LWLockAcquireOrWait(WALWriteLock, LW_EXCLUSIVE))
+		{
+			/*
+			 * The lock is now free, but we didn't acquire it yet.  Before we
+			 * do, loop back to check if someone else flushed the record for
+			 * us already.
+			 */
+			continue;
+		}
+		/* Got the lock */
 		LogwrtResult = XLogCtl->Write.LogwrtResult;
 		if (!XLByteLE(record, LogwrtResult.Flush))
 		{
@@ -2295,6 +2316,8 @@ XLogFlush(XLogRecPtr record)
 			XLogWrite(WriteRqst, false, false);
 		}
 		LWLockRelease(WALWriteLock);
+		/* done */
+		break;
 	}
 
 	END_CRIT_SECTION();
@@ -4763,6 +4786,290 @@ XLogCloseReadRecord(void)
 	memset(&EndRecPtr, 0, sizeof(XLogRecPtr));
 }
 
+/*
+ * How far (in kB) past the page being replayed XLogPrefetchAhead may read
+ * WAL from the current segment to hint upcoming data blocks.  0 keeps the
+ * lookahead within the page ReadRecord has already buffered.
+ */
+int			gp_recovery_prefetch_distance = 0;
+
+#ifdef USE_PREFETCH
+
+/* End of the WAL stretch already scanned by XLogPrefetchAhead */
+static XLogRecPtr prefetchedUpto = {0, 0};
+
+/*
+ * Hint the kernel about a data block an upcoming WAL record will touch.
+ *
+ * This must not throw on relations or blocks that do not (or no longer)
+ * exist, since the records being peeked at have not been CRC-verified and
+ * recovery must not die on a bad hint, so probe with smgrexists/smgrnblocks
+ * before issuing the posix_fadvise.  The one-entry nblocks cache is reset
+ * for every scan (see XLogPrefetchAhead); within a scan no redo runs, so
+ * the file size cannot change under us.
+ */
+static void
+XLogPrefetchBlock(RelFileNode rnode, BlockNumber blkno, bool newScan)
+{
+	static RelFileNode cachedNode;
+	static BlockNumber cachedNBlocks = 0;
+	static bool cacheValid = false;
+	SMgrRelation reln;
+
+	if (newScan)
+		cacheValid = false;
+
+	reln = smgropen(rnode);
+
+	if (!cacheValid || !RelFileNodeEquals(rnode, cachedNode))
+	{
+		if (!smgrexists(reln, MAIN_FORKNUM))
+			return;
+		cachedNode = rnode;
+		cachedNBlocks = smgrnblocks(reln, MAIN_FORKNUM);
+		cacheValid = true;
+	}
+
+	/* Blocks at or beyond EOF will be created by the record itself. */
+	if (blkno >= cachedNBlocks)
+		return;
+
+	smgrprefetch(reln, MAIN_FORKNUM, blkno);
+}
+
+/*
+ * Decode the block references of one upcoming record and hint them.
+ * Returns the number of hints issued.
+ *
+ * Only the common heap record types are decoded; they dominate the WAL of
+ * write-heavy workloads, and other resource managers either restore full
+ * pages, write at EOF (append-only inserts), or are too rare to matter.
+ */
+static int
+XLogPrefetchRecord(XLogRecord *record, bool newScan)
+{
+	uint8		info = record->xl_info & ~XLR_INFO_MASK;
+	char	   *data = XLogRecGetData(record);
+
+	/*
+	 * Records carrying backup blocks restore full page images; their redo
+	 * never reads the old page contents.
+	 */
+	if (record->xl_info & XLR_BKP_BLOCK_MASK)
+		return 0;
+
+	if (record->xl_rmid == RM_HEAP_ID)
+	{
+		switch (info & XLOG_HEAP_OPMASK)
+		{
+			case XLOG_HEAP_INSERT:
+			case XLOG_HEAP_DELETE:
+			case XLOG_HEAP_LOCK:
+			case XLOG_HEAP_INPLACE:
+				if (record->xl_len >= SizeOfHeapTid)
+				{
+					xl_heaptid *target = (xl_heaptid *) data;
+
+					XLogPrefetchBlock(target->node,
+									  ItemPointerGetBlockNumber(&target->tid),
+									  newScan);
+					return 1;
+				}
+				break;
+			case XLOG_HEAP_UPDATE:
+				if (record->xl_len >= SizeOfHeapUpdate)
+				{
+					xl_heap_update *xlrec = (xl_heap_update *) data;
+					BlockNumber oldblk;
+					BlockNumber newblk;
+
+					oldblk = ItemPointerGetBlockNumber(&xlrec->target.tid);
+					newblk = ItemPointerGetBlockNumber(&xlrec->newtid);
+					XLogPrefetchBlock(xlrec->target.node, oldblk, newScan);
+					if (newblk != oldblk)
+					{
+						XLogPrefetchBlock(xlrec->target.node, newblk, false);
+						return 2;
+					}
+					return 1;
+				}
+				break;
+			default:
+				break;
+		}
+	}
+	else if (record->xl_rmid == RM_HEAP2_ID)
+	{
+		if ((info & XLOG_HEAP_OPMASK) == XLOG_HEAP2_CLEAN &&
+			record->xl_len >= SizeOfHeapClean)
+		{
+			xl_heap_clean *xlrec = (xl_heap_clean *) data;
+
+			XLogPrefetchBlock(xlrec->node, xlrec->block, newScan);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Scan the records on one buffered WAL page, starting at pos, and hint the
+ * data blocks they reference.  Stops at the hint budget or at anything that
+ * does not look like a complete record lying fully within the page (a
+ * record continuing onto the next page is picked up again there via its
+ * continuation header).  Returns the offset at which scanning stopped.
+ */
+static uint32
+XLogPrefetchPage(char *page, uint32 pos, int *nhints, bool *newScan)
+{
+	while (*nhints < target_prefetch_pages &&
+		   pos + SizeOfXLogRecord <= XLOG_BLCKSZ)
+	{
+		XLogRecord *record = (XLogRecord *) (page + pos);
+		int			issued;
+
+		/* Stop at anything that is not a complete, sane-looking record. */
+		if (record->xl_tot_len < SizeOfXLogRecord + record->xl_len ||
+			pos + MAXALIGN(record->xl_tot_len) > XLOG_BLCKSZ ||
+			record->xl_rmid > RM_MAX_ID)
+			break;
+
+		issued = XLogPrefetchRecord(record, *newScan);
+		if (issued > 0)
+			*newScan = false;
+		*nhints += issued;
+
+		pos += MAXALIGN(record->xl_tot_len);
+	}
+
+	return pos;
+}
+
+/*
+ * Hint the kernel to read ahead the data blocks that the WAL records
+ * following the one being replayed will touch.
+ *
+ * Recovery applies records one at a time, and much of its elapsed time is
+ * spent waiting for synchronous reads of the data pages the records modify.
+ * While one record is being applied we can look at the records after it
+ * that are already sitting in the reader's page buffer, decode their block
+ * references, and issue posix_fadvise hints for them, so those reads
+ * overlap with the redo work in front of them.  When
+ * gp_recovery_prefetch_distance is set, the scan additionally reads the
+ * following WAL pages of the current segment, up to that distance, so the
+ * hint window no longer collapses near page boundaries.
+ *
+ * This is a hint-only path: the peeked records have not been CRC-verified
+ * (a bogus hint merely fades away), and we stop at anything that does not
+ * look like a complete record or the expected next page.  Like the
+ * executor's prefetch consumers, this is enabled by setting
+ * effective_io_concurrency, which also caps the number of hints issued per
+ * scan.
+ */
+static void
+XLogPrefetchAhead(void)
+{
+	uint32		targetOff;
+	uint32		pos;
+	int			nhints = 0;
+	bool		newScan = true;
+
+	if (target_prefetch_pages <= 0 || readBuf == NULL)
+		return;
+
+	/*
+	 * The next records live on the page holding the end of the record just
+	 * read.  If EndRecPtr landed exactly on a page boundary, or ReadRecord
+	 * has its buffer elsewhere, there is nothing in memory to scan.
+	 */
+	targetOff = ((EndRecPtr.xrecoff % XLogSegSize) / XLOG_BLCKSZ) * XLOG_BLCKSZ;
+	if (readId != EndRecPtr.xlogid ||
+		readSeg != EndRecPtr.xrecoff / XLogSegSize ||
+		readOff != targetOff)
+		return;
+
+	/* Already hinted past this point? */
+	if (XLByteLT(EndRecPtr, prefetchedUpto))
+		return;
+
+	pos = XLogPrefetchPage(readBuf, EndRecPtr.xrecoff % XLOG_BLCKSZ,
+						   &nhints, &newScan);
+
+	prefetchedUpto.xlogid = readId;
+	prefetchedUpto.xrecoff = readSeg * XLogSegSize + readOff + pos;
+
+	/*
+	 * Continue into the WAL pages following the buffered one, reading them
+	 * from the already-open segment file.  XLogPageRead seeks before every
+	 * read, so moving the file position here is harmless.  We never cross
+	 * into the next segment; the scan just resumes there once replay does.
+	 */
+	if (gp_recovery_prefetch_distance > 0 && readFile >= 0)
+	{
+		static char *aheadBuf = NULL;
+		uint32		limitOff;
+		uint32		off;
+
+		limitOff = targetOff + (uint32) gp_recovery_prefetch_distance * 1024;
+		if (limitOff > XLogSegSize - XLOG_BLCKSZ)
+			limitOff = XLogSegSize - XLOG_BLCKSZ;
+
+		for (off = targetOff + XLOG_BLCKSZ;
+			 off <= limitOff && nhints < target_prefetch_pages;
+			 off += XLOG_BLCKSZ)
+		{
+			XLogPageHeader hdr;
+			uint32		ppos;
+
+			if (aheadBuf == NULL)
+			{
+				aheadBuf = (char *) malloc(XLOG_BLCKSZ);
+				if (aheadBuf == NULL)
+					return;
+			}
+
+			if (lseek(readFile, (off_t) off, SEEK_SET) < 0 ||
+				read(readFile, aheadBuf, XLOG_BLCKSZ) != XLOG_BLCKSZ)
+				break;
+
+			/*
+			 * Stop at anything that is not the next page of this WAL
+			 * stretch; a recycled segment still carries its old headers.
+			 */
+			hdr = (XLogPageHeader) aheadBuf;
+			if (hdr->xlp_magic != XLOG_PAGE_MAGIC ||
+				(hdr->xlp_info & ~XLP_ALL_FLAGS) != 0 ||
+				hdr->xlp_pageaddr.xlogid != readId ||
+				hdr->xlp_pageaddr.xrecoff != readSeg * XLogSegSize + off)
+				break;
+
+			ppos = XLogPageHeaderSize(hdr);
+			if (hdr->xlp_info & XLP_FIRST_IS_CONTRECORD)
+			{
+				XLogContRecord *contrecord;
+
+				if (ppos + SizeOfXLogContRecord > XLOG_BLCKSZ)
+					break;
+				contrecord = (XLogContRecord *) (aheadBuf + ppos);
+				ppos += MAXALIGN(SizeOfXLogContRecord + contrecord->xl_rem_len);
+				if (ppos >= XLOG_BLCKSZ)
+				{
+					/* The continuation fills this whole page; keep going. */
+					prefetchedUpto.xrecoff = readSeg * XLogSegSize + off + XLOG_BLCKSZ;
+					continue;
+				}
+			}
+
+			ppos = XLogPrefetchPage(aheadBuf, ppos, &nhints, &newScan);
+
+			prefetchedUpto.xrecoff = readSeg * XLogSegSize + off + ppos;
+		}
+	}
+}
+
+#endif   /* USE_PREFETCH */
+
 /*
  * Check whether the xlog header of a page just read in looks valid.
  *
@@ -7486,6 +7793,14 @@ StartupXLOG(void)
 					TransactionIdIsValid(record->xl_xid))
 					RecordKnownAssignedTransactionIds(record->xl_xid);
 
+#ifdef USE_PREFETCH
+				/*
+				 * Hint the data blocks the records behind this one will
+				 * touch, so their reads overlap with applying this record.
+				 */
+				XLogPrefetchAhead();
+#endif
+
 				ApplyStartupRedo(&ReadRecPtr, &EndRecPtr, record);
 
 				/*
@@ -38,6 +38,12 @@ CREATE OR REPLACE VIEW gp_transaction_log AS
 
 GRANT SELECT ON gp_transaction_log TO PUBLIC;
 
+CREATE OR REPLACE VIEW gp_dispatch_stats AS
+    SELECT *
+      FROM gp_dispatch_stats() AS L(gp_session_id int, phase text, dispatches bigint, samples bigint, total_us bigint, max_us bigint, straggler_content int, straggler_us bigint, under_256us bigint, under_1ms bigint, under_4ms bigint, under_16ms bigint, under_64ms bigint, under_256ms bigint, over_256ms bigint);
+
+GRANT SELECT ON gp_dispatch_stats TO PUBLIC;
+
 CREATE OR REPLACE VIEW gp_distributed_log AS 
     SELECT *
       FROM gp_distributed_log() AS L(segment_id smallint, dbid smallint, distributed_xid xid, distributed_id text, status text, local_transaction xid);
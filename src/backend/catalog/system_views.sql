@@ -447,6 +447,38 @@ CREATE VIEW gp_stat_replication AS
          ON G.gp_segment_id = R.gp_segment_id
     );
 
+CREATE FUNCTION gp_stat_get_master_interconnect_flows() RETURNS SETOF RECORD AS
+$$
+    SELECT pg_catalog.gp_execution_segment() AS gp_segment_id, *
+    FROM pg_catalog.gp_interconnect_flow_stats()
+$$
+LANGUAGE SQL EXECUTE ON MASTER;
+
+CREATE FUNCTION gp_stat_get_segment_interconnect_flows() RETURNS SETOF RECORD AS
+$$
+    SELECT pg_catalog.gp_execution_segment() AS gp_segment_id, *
+    FROM pg_catalog.gp_interconnect_flow_stats()
+$$
+LANGUAGE SQL EXECUTE ON ALL SEGMENTS;
+
+CREATE VIEW gp_interconnect_flows AS
+    SELECT * FROM pg_catalog.gp_stat_get_master_interconnect_flows() AS F
+    (gp_segment_id integer, teardowns bigint, snd_pkts bigint,
+     recv_pkts bigint, retransmits bigint, crc_errors bigint,
+     mismatched_pkts bigint, disordered_pkts bigint, duplicated_pkts bigint,
+     recv_acks bigint, status_query_msgs bigint,
+     recv_queue_depth_avg float8, capacity_avg float8)
+    UNION ALL
+    SELECT * FROM pg_catalog.gp_stat_get_segment_interconnect_flows() AS F
+    (gp_segment_id integer, teardowns bigint, snd_pkts bigint,
+     recv_pkts bigint, retransmits bigint, crc_errors bigint,
+     mismatched_pkts bigint, disordered_pkts bigint, duplicated_pkts bigint,
+     recv_acks bigint, status_query_msgs bigint,
+     recv_queue_depth_avg float8, capacity_avg float8);
+
+CREATE VIEW gp_vfd_stats AS
+    SELECT * FROM pg_catalog.gp_vfd_stats();
+
 CREATE VIEW pg_stat_database AS 
     SELECT 
             D.oid AS datid, 
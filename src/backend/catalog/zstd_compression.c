@@ -50,8 +50,17 @@ zstd_constructor(PG_FUNCTION_ARGS)
 
 	state->level = sa->complevel;
 	state->compress = compress;
-	state->zstd_compress_context = ZSTD_createCCtx();
-	state->zstd_decompress_context = ZSTD_createDCtx();
+
+	/*
+	 * Callers construct separate states per direction (one per column for
+	 * column-oriented tables), so only set up the context that will be
+	 * used; the zstd contexts keep sizable workspaces once used.  The
+	 * free functions in the destructor accept NULL.
+	 */
+	if (compress)
+		state->zstd_compress_context = ZSTD_createCCtx();
+	else
+		state->zstd_decompress_context = ZSTD_createDCtx();
 
 	PG_RETURN_POINTER(cs);
 }
@@ -132,6 +132,7 @@ BufferedAppendSetFile(BufferedAppend *bufferedAppend,
 	bufferedAppend->filePathName = filePathName;
 	bufferedAppend->fileLen = eof;
 	bufferedAppend->fileLen_uncompressed = eof_uncompressed;
+	bufferedAppend->fileAllocatedLen = eof;
 }
 
 
@@ -169,6 +170,30 @@ BufferedAppendWrite(BufferedAppend *bufferedAppend)
 	Assert(bufferedAppend->largeWriteLen > 0);
 	largeWriteMemory = bufferedAppend->largeWriteMemory;
 
+	/*
+	 * Preallocate file space in large extents ahead of the write position,
+	 * so the filesystem can lay the file out in a few contiguous extents
+	 * instead of growing it piecemeal with each large write.  A failure
+	 * here is not an error: the write below will allocate the space the
+	 * traditional way (and will report ENOSPC properly if that's what the
+	 * preallocation ran into).
+	 */
+	if (gp_appendonly_preallocate_len > 0 &&
+		bufferedAppend->largeWritePosition + bufferedAppend->largeWriteLen >
+		bufferedAppend->fileAllocatedLen)
+	{
+		int64		newAllocatedLen;
+
+		newAllocatedLen = bufferedAppend->largeWritePosition +
+			bufferedAppend->largeWriteLen +
+			(int64) gp_appendonly_preallocate_len * 1024;
+
+		if (FileAllocate(bufferedAppend->file,
+						 (off_t) bufferedAppend->fileAllocatedLen,
+						 (off_t) (newAllocatedLen - bufferedAppend->fileAllocatedLen)) >= 0)
+			bufferedAppend->fileAllocatedLen = newAllocatedLen;
+	}
+
 	bytestotal = 0;
 	bytesleft = bufferedAppend->largeWriteLen;
 	while (bytesleft > 0)
@@ -400,11 +425,28 @@ BufferedAppendCompleteFile(BufferedAppend *bufferedAppend,
 	if (bufferedAppend->largeWriteLen > 0)
 		BufferedAppendWrite(bufferedAppend);
 
+	/*
+	 * Give back any preallocated space beyond the data actually written,
+	 * so it isn't left occupying disk (the logical EOF in the catalog is
+	 * what controls visibility, but the physical tail is pure waste).
+	 */
+	if (bufferedAppend->fileAllocatedLen > bufferedAppend->largeWritePosition)
+	{
+		if (FileTruncate(bufferedAppend->file,
+						 bufferedAppend->largeWritePosition) < 0)
+			ereport(ERROR,
+					(errcode_for_file_access(),
+					 errmsg("could not truncate preallocated space in table \"%s\" in segment file \"%s\": %m",
+							bufferedAppend->relationName,
+							bufferedAppend->filePathName)));
+	}
+
 	*fileLen = bufferedAppend->fileLen;
 	*fileLen_uncompressed = bufferedAppend->fileLen_uncompressed;
 
 	bufferedAppend->largeWritePosition = 0;
 	bufferedAppend->largeWriteLen = 0;
+	bufferedAppend->fileAllocatedLen = 0;
 
 	bufferedAppend->bufferLen = 0;
 
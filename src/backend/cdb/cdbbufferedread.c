@@ -17,6 +17,7 @@
 #include "postgres.h"
 
 #include "cdb/cdbbufferedread.h"
+#include "storage/fd.h"
 #include "utils/guc.h"
 #include "miscadmin.h"
 
@@ -241,6 +242,35 @@ BufferedReadIo(
 		offset += actualLen;
 	}
 
+	/*
+	 * Ask the kernel to start reading the next large-read window while the
+	 * caller parses and decompresses the window just read, overlapping disk
+	 * I/O with CPU work. This is only a hint: platforms without
+	 * posix_fadvise keep reading synchronously as before. Skip it for
+	 * temporary-range (random) reads, where the next sequential window is
+	 * usually not the next range requested.
+	 */
+	if (gp_appendonly_read_prefetch &&
+		!bufferedRead->haveTemporaryLimitInEffect)
+	{
+		int64		nextPosition;
+		int64		remainingFileLen;
+		int32		nextReadLen;
+
+		nextPosition = bufferedRead->largeReadPosition +
+			bufferedRead->largeReadLen;
+		remainingFileLen = bufferedRead->fileLen - nextPosition;
+		if (remainingFileLen > bufferedRead->maxLargeReadLen)
+			nextReadLen = bufferedRead->maxLargeReadLen;
+		else
+			nextReadLen = (int32) remainingFileLen;
+
+		if (nextReadLen > 0)
+			(void) FilePrefetch(bufferedRead->file,
+								(off_t) nextPosition,
+								nextReadLen);
+	}
+
 	if (VacuumCostActive)
 		VacuumCostBalance += VacuumCostPageMiss;
 }
@@ -367,6 +397,13 @@ BufferedReadSetTemporaryRange(
 	Assert(bufferedRead != NULL);
 	Assert(bufferedRead->file >= 0);
 
+	/*
+	 * Establish the temporary limit before any read below, so that
+	 * BufferedReadIo knows not to prefetch past the requested range.
+	 */
+	bufferedRead->haveTemporaryLimitInEffect = true;
+	bufferedRead->temporaryLimitFileLen = afterFileOffset;
+
 	/*
 	 * Forget any current read buffer length (but not the offset!).
 	 */
@@ -447,10 +484,6 @@ BufferedReadSetTemporaryRange(
 		if (bufferedRead->largeReadLen > 0)
 			BufferedReadIo(bufferedRead);
 	}
-
-	bufferedRead->haveTemporaryLimitInEffect = true;
-	bufferedRead->temporaryLimitFileLen = afterFileOffset;
-
 }
 
 /*
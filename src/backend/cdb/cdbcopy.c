@@ -35,6 +35,16 @@
 
 #include <poll.h>
 
+/*
+ * How much COPY data we let pile up in a segment connection's output buffer
+ * before the sender waits for that segment to drain.  While it waits, every
+ * other pending connection is flushed too, so a laggard segment slows down
+ * only the rows bound for it rather than the whole load.
+ */
+#define COPY_MAX_PENDING_BYTES	(1024 * 1024)
+
+static void cdbCopyDrainQueues(CdbCopy *c, SegmentDatabaseDescriptor *target);
+
 /*
  * Create a cdbCopy object that includes all the cdb
  * information and state needed by the backend COPY.
@@ -68,6 +78,9 @@ makeCdbCopy(bool is_copy_in)
 
 	Assert(c->total_segs >= 0);
 
+	c->seg_bytes_sent = (uint64 *) palloc0(c->total_segs * sizeof(uint64));
+	c->seg_backpressure_waits = (uint64 *) palloc0(c->total_segs * sizeof(uint64));
+
 	/* Initialize the state of each segment database */
 	c->segdb_state = (SegDbState **) palloc((c->total_segs) * sizeof(SegDbState *));
 
@@ -199,6 +212,29 @@ cdbCopyStart(CdbCopy *c, char *copyCmd, struct GpPolicy *policy)
 		c->segdb_state[seg][0] = SEGDB_COPY;	/* we be jammin! */
 	}
 
+	/*
+	 * For COPY FROM, switch the writer gang connections to nonblocking mode:
+	 * PQputCopyData then queues rows in libpq's per-connection output buffer
+	 * and sends whatever each socket will accept without waiting, so the
+	 * parser keeps running while laggard segments drain.  The connections
+	 * are switched back to blocking mode in cdbCopyEndAndFetchRejectNum.
+	 */
+	if (c->copy_in)
+	{
+		Gang	   *gp = c->primary_writer;
+
+		for (seg = 0; seg < gp->size; seg++)
+		{
+			SegmentDatabaseDescriptor *q = &gp->db_descriptors[seg];
+
+			if (PQsetnonblocking(q->conn, 1) != 0)
+				ereport(ERROR,
+						(errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+						 errmsg("unable to set nonblocking mode on connection to segment %d: %s",
+								q->segindex, PQerrorMessage(q->conn))));
+		}
+	}
+
 	return;
 }
 
@@ -244,7 +280,11 @@ cdbCopySendData(CdbCopy *c, int target_seg, const char *buffer,
 
 	q = getSegmentDescriptorFromGang(gp, target_seg);
 
-	/* transmit the COPY data */
+	/*
+	 * Queue the COPY data.  The connection is in nonblocking mode, so this
+	 * sends what the socket will accept and buffers the rest in libpq's
+	 * output buffer rather than stalling on a slow segment.
+	 */
 	result = PQputCopyData(q->conn, buffer, nbytes);
 
 	if (result != 1)
@@ -260,7 +300,100 @@ cdbCopySendData(CdbCopy *c, int target_seg, const char *buffer,
 							 target_seg, PQerrorMessage(q->conn));
 
 		c->io_errors = true;
+		return;
+	}
+
+	c->seg_bytes_sent[target_seg] += nbytes;
+
+	/*
+	 * Backpressure: once this segment has fallen too far behind, wait for
+	 * its socket to drain back under the cap, servicing every other pending
+	 * connection while we wait.
+	 */
+	if (q->conn->outCount > COPY_MAX_PENDING_BYTES)
+	{
+		c->seg_backpressure_waits[target_seg]++;
+		cdbCopyDrainQueues(c, q);
+	}
+}
+
+/*
+ * Poll-driven flush of the COPY data queued on the writer gang connections.
+ *
+ * If 'target' is given, return as soon as its pending data is back under
+ * half the backpressure cap; with a NULL target, return only when every
+ * connection's queue is empty (used before ending the COPY).  Either way,
+ * all pending connections are flushed as their sockets become writable, so
+ * no segment sits idle while we wait for another.
+ *
+ * Like cdbCopySendData, this doesn't throw; send failures are recorded in
+ * c->err_msg and c->io_errors, and the failed connection's queue is
+ * abandoned.
+ */
+static void
+cdbCopyDrainQueues(CdbCopy *c, SegmentDatabaseDescriptor *target)
+{
+	Gang	   *gp = c->primary_writer;
+	struct pollfd *fds;
+	bool	   *failed;
+	int			i;
+
+	fds = (struct pollfd *) palloc(gp->size * sizeof(struct pollfd));
+	failed = (bool *) palloc0(gp->size * sizeof(bool));
+
+	for (;;)
+	{
+		int			nfds = 0;
+		int			n;
+		bool		targetDrained = true;
+
+		for (i = 0; i < gp->size; i++)
+		{
+			SegmentDatabaseDescriptor *q = &gp->db_descriptors[i];
+
+			if (failed[i] || q->conn->outCount == 0)
+				continue;
+
+			if (pqFlushNonBlocking(q->conn) < 0)
+			{
+				appendStringInfo(&(c->err_msg),
+								 "Failed to send data to segment %d: %s\n",
+								 q->segindex, PQerrorMessage(q->conn));
+				c->io_errors = true;
+				failed[i] = true;
+				continue;
+			}
+
+			if (q->conn->outCount == 0)
+				continue;
+
+			if (q == target && q->conn->outCount > COPY_MAX_PENDING_BYTES / 2)
+				targetDrained = false;
+			else if (target == NULL)
+				targetDrained = false;
+
+			fds[nfds].fd = PQsocket(q->conn);
+			fds[nfds].events = POLLOUT;
+			fds[nfds].revents = 0;
+			nfds++;
+		}
+
+		if (nfds == 0 || targetDrained)
+			break;
+
+		n = poll(fds, nfds, -1);
+		if (n < 0 && errno != EINTR)
+		{
+			appendStringInfo(&(c->err_msg),
+							 "poll() failed while sending COPY data: %s\n",
+							 strerror(errno));
+			c->io_errors = true;
+			break;
+		}
 	}
+
+	pfree(failed);
+	pfree(fds);
 }
 
 /*
@@ -733,6 +866,28 @@ cdbCopyEndAndFetchRejectNum(CdbCopy *c, int *total_rows_completed)
 	/* results from each segment */
 	results = (int *) palloc0(sizeof(int) * size);
 
+	/*
+	 * For COPY FROM, push out whatever data is still queued on the
+	 * connections, then return them to blocking mode so that PQputCopyEnd
+	 * and the result processing below behave as usual.
+	 */
+	if (c->copy_in)
+	{
+		cdbCopyDrainQueues(c, NULL);
+
+		for (seg = 0; seg < size; seg++)
+		{
+			q = &db_descriptors[seg];
+			PQsetnonblocking(q->conn, 0);
+
+			if (c->seg_backpressure_waits[q->segindex] > 0)
+				elog(DEBUG1, "COPY backpressure: seg%d stalled the sender " UINT64_FORMAT " times (" UINT64_FORMAT " bytes sent)",
+					 q->segindex,
+					 c->seg_backpressure_waits[q->segindex],
+					 c->seg_bytes_sent[q->segindex]);
+		}
+	}
+
 	for (seg = 0; seg < size; seg++)
 	{
 		q = &db_descriptors[seg];
@@ -318,23 +318,87 @@ DistributedSnapshot_Copy(DistributedSnapshot *target,
 		   source->count * sizeof(DistributedTransactionId));
 }
 
+/*
+ * The in-progress xid array dominates the serialized snapshot size and is
+ * shipped with every dispatched statement, so it is encoded as unsigned
+ * varint deltas instead of raw 4-byte xids: the array is sorted and
+ * distributed xids are dense, so under load most entries shrink to a
+ * single byte. The deltas are computed modulo 2^32 (first entry relative
+ * to xmin), which makes the round trip lossless for any input, sorted or
+ * not.
+ */
+static int
+xidDeltaSize(uint32 v)
+{
+	int			size = 1;
+
+	while (v >= 0x80)
+	{
+		v >>= 7;
+		size++;
+	}
+	return size;
+}
+
+static char *
+xidDeltaEncode(char *p, uint32 v)
+{
+	while (v >= 0x80)
+	{
+		*p++ = (char) (v | 0x80);
+		v >>= 7;
+	}
+	*p++ = (char) v;
+	return p;
+}
+
+static const char *
+xidDeltaDecode(const char *p, uint32 *v)
+{
+	uint32		result = 0;
+	int			shift = 0;
+	unsigned char b;
+
+	do
+	{
+		b = (unsigned char) *p++;
+		result |= (uint32) (b & 0x7F) << shift;
+		shift += 7;
+	} while (b & 0x80);
+
+	*v = result;
+	return p;
+}
+
 int
 DistributedSnapshot_SerializeSize(DistributedSnapshot *ds)
 {
+	DistributedTransactionId prev = ds->xmin;
+	int			xipsize = 0;
+	int			i;
+
+	for (i = 0; i < ds->count; i++)
+	{
+		xipsize += xidDeltaSize(ds->inProgressXidArray[i] - prev);
+		prev = ds->inProgressXidArray[i];
+	}
+
 	return sizeof(DistributedTransactionTimeStamp) +
 		sizeof(DistributedSnapshotId) +
 	/* xminAllDistributedSnapshots, xmin, xmax */
 		3 * sizeof(DistributedTransactionId) +
 	/* count */
 		sizeof(int32) +
-	/* Size of inProgressXidArray */
-		sizeof(DistributedTransactionId) * ds->count;
+	/* Size of delta-encoded inProgressXidArray */
+		xipsize;
 }
 
 int
 DistributedSnapshot_Serialize(DistributedSnapshot *ds, char *buf)
 {
 	char	   *p = buf;
+	DistributedTransactionId prev = ds->xmin;
+	int			i;
 
 	memcpy(p, &ds->distribTransactionTimeStamp, sizeof(DistributedTransactionTimeStamp));
 	p += sizeof(DistributedTransactionTimeStamp);
@@ -349,8 +413,11 @@ DistributedSnapshot_Serialize(DistributedSnapshot *ds, char *buf)
 	memcpy(p, &ds->count, sizeof(int32));
 	p += sizeof(int32);
 
-	memcpy(p, ds->inProgressXidArray, sizeof(DistributedTransactionId) * ds->count);
-	p += sizeof(DistributedTransactionId) * ds->count;
+	for (i = 0; i < ds->count; i++)
+	{
+		p = xidDeltaEncode(p, ds->inProgressXidArray[i] - prev);
+		prev = ds->inProgressXidArray[i];
+	}
 
 	Assert((p - buf) == DistributedSnapshot_SerializeSize(ds));
 
@@ -409,13 +476,18 @@ DistributedSnapshot_Deserialize(const char *buf, DistributedSnapshot *ds)
 
 	if (count > 0)
 	{
-		int			xipsize;
+		DistributedTransactionId prev = ds->xmin;
+		uint32		delta;
+		int			i;
 
 		Assert(ds->inProgressXidArray != NULL);
 
-		xipsize = sizeof(DistributedTransactionId) * count;
-		memcpy(ds->inProgressXidArray, p, xipsize);
-		p += xipsize;
+		for (i = 0; i < count; i++)
+		{
+			p = xidDeltaDecode(p, &delta);
+			prev += delta;
+			ds->inProgressXidArray[i] = prev;
+		}
 	}
 	ds->count = count;
 
@@ -43,6 +43,19 @@
 /* Constant prime value used for an FNV1 hash */
 #define FNV_32_PRIME ((uint32)0x01000193)
 
+/* CRC-32C (Castagnoli) initial basis and reflected polynomial */
+#define CRC32C_INIT ((uint32)0xFFFFFFFF)
+#define CRC32C_POLY ((uint32)0x82F63B78)
+
+/*
+ * Use the SSE4.2 crc32 instructions when we can detect them at run time;
+ * crc32c_buf() falls back to a table-driven implementation otherwise.
+ */
+#if defined(__x86_64__) && defined(__GNUC__)
+#define HAVE_CRC32C_HW 1
+#include <cpuid.h>
+#endif
+
 /* Constant used for hashing a NULL value */
 #define NULL_VAL ((uint32)0XF0F0F0F1)
 
@@ -60,6 +73,7 @@
 
 /* local function declarations */
 static uint32 fnv1_32_buf(void *buf, size_t len, uint32 hashval);
+static uint32 crc32c_buf(void *buf, size_t len, uint32 hashval);
 static int	inet_getkey(inet *addr, unsigned char *inet_key, int key_size);
 static int	ignoreblanks(char *data, int len);
 static int	ispowof2(int numsegs);
@@ -86,10 +100,28 @@ static int	ispowof2(int numsegs);
  */
 CdbHash *
 makeCdbHash(int numsegs)
+{
+	/*
+	 * FNV-1 is the legacy hash family; it decides where all existing
+	 * hash-distributed data lives, so it remains the default.
+	 */
+	return makeCdbHashAlg(numsegs, HASH_FNV_1);
+}
+
+/*
+ * Like makeCdbHash, but with an explicit choice of hash family.
+ *
+ * Callers whose hash values never determine on-disk placement (for
+ * example transient repartitioning) may pick HASH_CRC32C, which uses
+ * the SSE4.2 crc32 instructions where the CPU provides them.
+ */
+CdbHash *
+makeCdbHashAlg(int numsegs, CdbHashAlg alg)
 {
 	CdbHash    *h;
 
 	Assert(numsegs > 0);		/* verify number of segments is legal. */
+	Assert(alg == HASH_FNV_1 || alg == HASH_CRC32C);
 
 	/* Create a pointer to a CdbHash that includes the hash properties */
 	h = palloc(sizeof(CdbHash));
@@ -99,6 +131,7 @@ makeCdbHash(int numsegs)
 	 */
 	h->hash = 0;
 	h->numsegs = numsegs;
+	h->hashalg = alg;
 
 	/*
 	 * set the reduction algorithm: If num_segs is power of 2 use bit mask,
@@ -131,6 +164,26 @@ makeCdbHash(int numsegs)
 }
 
 
+/*
+ * Return the initial offset basis for a hash family.
+ */
+static inline uint32
+hashbase(CdbHashAlg alg)
+{
+	return (alg == HASH_CRC32C) ? CRC32C_INIT : FNV1_32_INIT;
+}
+
+/*
+ * Fold a buffer into a running hash value using the given family.
+ */
+static inline uint32
+hashbuf(CdbHashAlg alg, void *buf, size_t len, uint32 hval)
+{
+	if (alg == HASH_CRC32C)
+		return crc32c_buf(buf, len, hval);
+	return fnv1_32_buf(buf, len, hval);
+}
+
 /*
  * Initialize CdbHash for hashing the next tuple values.
  */
@@ -138,7 +191,7 @@ void
 cdbhashinit(CdbHash *h)
 {
 	/* reset the hash value to the initial offset basis */
-	h->hash = FNV1_32_INIT;
+	h->hash = hashbase(h->hashalg);
 }
 
 /*
@@ -149,7 +202,7 @@ addToCdbHash(void *cdbHash, void *buf, size_t len)
 {
 	CdbHash    *h = (CdbHash *) cdbHash;
 
-	h->hash = fnv1_32_buf(buf, len, h->hash);
+	h->hash = hashbuf(h->hashalg, buf, len, h->hash);
 }
 
 /*
@@ -644,7 +697,7 @@ cdbhashnokey(CdbHash *h)
 	size_t		len = sizeof(rrbuf);
 
 	/* compute the hash */
-	h->hash = fnv1_32_buf(buf, len, h->hash);
+	h->hash = hashbuf(h->hashalg, buf, len, h->hash);
 
 	h->rrindex++;				/* increment for next time around */
 }
@@ -682,6 +735,138 @@ cdbhashreduce(CdbHash *h)
 	return result;
 }
 
+/*================================================================
+ *
+ * BATCHED HASH API
+ *
+ * The per-datum API above re-enters hashDatum's type dispatch for
+ * every attribute of every tuple. The batched variants below take a
+ * column vector at a time, so the dispatch happens once per column
+ * per batch and the integer fast paths compile to a tight loop.
+ *
+ *================================================================
+ */
+
+/* client data for addToBatchHash */
+typedef struct CdbHashBatchSlot
+{
+	CdbHashAlg	alg;
+	uint32	   *slot;			/* accumulator for the current tuple */
+} CdbHashBatchSlot;
+
+/*
+ * Implements datumHashFunction over one slot of a batch.
+ */
+static void
+addToBatchHash(void *clientData, void *buf, size_t len)
+{
+	CdbHashBatchSlot *bs = (CdbHashBatchSlot *) clientData;
+
+	*bs->slot = hashbuf(bs->alg, buf, len, *bs->slot);
+}
+
+/*
+ * Reset a batch of hash accumulators to the initial offset basis.
+ */
+void
+cdbhashbatchinit(CdbHash *h, int ntuples, uint32 *hashes)
+{
+	uint32		base = hashbase(h->hashalg);
+	int			i;
+
+	for (i = 0; i < ntuples; i++)
+		hashes[i] = base;
+}
+
+/*
+ * Fold one hash-key column into a batch of hash accumulators.
+ *
+ * values/nulls hold one entry per tuple; NULL entries are folded in
+ * exactly as cdbhashnull() would fold them, so a batched hash always
+ * matches the equivalent sequence of per-datum calls.
+ */
+void
+cdbhashbatch(CdbHash *h, Oid type, int ntuples,
+			 const Datum *values, const bool *nulls, uint32 *hashes)
+{
+	CdbHashAlg	alg = h->hashalg;
+	int			i;
+
+	switch (type)
+	{
+			/*
+			 * Fast paths for the common integer distribution keys: hoist
+			 * the type dispatch out of the loop. These must produce the
+			 * same bytes as hashDatum, which widens all integer sizes to
+			 * an 8 byte buffer.
+			 */
+		case INT2OID:
+		case INT4OID:
+		case INT8OID:
+			for (i = 0; i < ntuples; i++)
+			{
+				int64		intbuf;
+
+				if (nulls[i])
+				{
+					uint32		nullbuf = NULL_VAL;
+
+					hashes[i] = hashbuf(alg, &nullbuf, sizeof(nullbuf),
+										hashes[i]);
+					continue;
+				}
+
+				if (type == INT2OID)
+					intbuf = (int64) DatumGetInt16(values[i]);
+				else if (type == INT4OID)
+					intbuf = (int64) DatumGetInt32(values[i]);
+				else
+					intbuf = DatumGetInt64(values[i]);
+
+				hashes[i] = hashbuf(alg, &intbuf, sizeof(intbuf), hashes[i]);
+			}
+			break;
+
+		default:
+			for (i = 0; i < ntuples; i++)
+			{
+				CdbHashBatchSlot bs;
+
+				bs.alg = alg;
+				bs.slot = &hashes[i];
+
+				if (nulls[i])
+					hashNullDatum(addToBatchHash, &bs);
+				else
+					hashDatum(values[i], type, addToBatchHash, &bs);
+			}
+			break;
+	}
+}
+
+/*
+ * Reduce a batch of hash values to segment numbers.
+ */
+void
+cdbhashbatchreduce(CdbHash *h, int ntuples,
+				   const uint32 *hashes, unsigned int *segs)
+{
+	int			i;
+
+	Assert(h->reducealg == REDUCE_BITMASK || h->reducealg == REDUCE_LAZYMOD);
+
+	if (h->reducealg == REDUCE_BITMASK)
+	{
+		for (i = 0; i < ntuples; i++)
+			segs[i] = FASTMOD(hashes[i], (uint32) h->numsegs);
+	}
+	else
+	{
+		for (i = 0; i < ntuples; i++)
+			segs[i] = hashes[i] % (h->numsegs);
+	}
+}
+
 bool
 typeIsArrayType(Oid typeoid)
 {
@@ -823,6 +1008,98 @@ fnv1_32_buf(void *buf, size_t len, uint32 hval)
 	return hval;
 }
 
+/* lookup table for the software CRC-32C fallback, built on first use */
+static uint32 crc32c_table[256];
+static bool crc32c_have_hw = false;
+static bool crc32c_initialized = false;
+
+/*
+ * One-time setup for crc32c_buf: probe the CPU for SSE4.2 and build the
+ * fallback table. Cheap enough to do lazily in the first hash call.
+ */
+static void
+crc32c_setup(void)
+{
+	int			i;
+
+	for (i = 0; i < 256; i++)
+	{
+		uint32		crc = (uint32) i;
+		int			j;
+
+		for (j = 0; j < 8; j++)
+			crc = (crc & 1) ? (crc >> 1) ^ CRC32C_POLY : (crc >> 1);
+
+		crc32c_table[i] = crc;
+	}
+
+#ifdef HAVE_CRC32C_HW
+	{
+		unsigned int eax,
+					ebx,
+					ecx,
+					edx;
+
+		if (__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+			crc32c_have_hw = ((ecx & (1 << 20)) != 0);	/* SSE4.2 */
+	}
+#endif
+
+	crc32c_initialized = true;
+}
+
+/*
+ * crc32c_buf - fold a buffer into a running CRC-32C value
+ *
+ * Same contract as fnv1_32_buf: pass CRC32C_INIT for the first call and
+ * the previous return value thereafter. Uses the SSE4.2 crc32
+ * instructions when available, a table-driven loop otherwise; both
+ * produce identical values, so mixed clusters stay consistent.
+ */
+static uint32
+crc32c_buf(void *buf, size_t len, uint32 hval)
+{
+	unsigned char *bp = (unsigned char *) buf;
+
+	if (!crc32c_initialized)
+		crc32c_setup();
+
+#ifdef HAVE_CRC32C_HW
+	if (crc32c_have_hw)
+	{
+		uint64		crc64 = hval;
+
+		while (len >= sizeof(uint64))
+		{
+			uint64		chunk;
+
+			memcpy(&chunk, bp, sizeof(uint64));
+			__asm__("crc32q %1, %0" : "+r"(crc64) : "rm"(chunk));
+			bp += sizeof(uint64);
+			len -= sizeof(uint64);
+		}
+
+		hval = (uint32) crc64;
+		while (len > 0)
+		{
+			__asm__("crc32b %1, %0" : "+r"(hval) : "rm"(*bp));
+			bp++;
+			len--;
+		}
+
+		return hval;
+	}
+#endif
+
+	while (len > 0)
+	{
+		hval = crc32c_table[(hval ^ *bp++) & 0xFF] ^ (hval >> 8);
+		len--;
+	}
+
+	return hval;
+}
+
 /*
  * Support function for hashing on inet/cidr (see network.c)
  *
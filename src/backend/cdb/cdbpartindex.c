@@ -998,6 +998,43 @@ get_relation_part_constraints(Oid rootOid, List **defaultLevels)
 	return allCons;
 }
 
+/*
+ * get_relation_part_defaults
+ *  return the list of partitioning levels of the given root that have a
+ *  default partition
+ *
+ * This is a cheap alternative to get_relation_part_constraints() for callers
+ * that only need the default partition information: it checks the
+ * parisdefault flag of the partition rules instead of fetching and merging
+ * the part constraint of every part.
+ */
+List *
+get_relation_part_defaults(Oid rootOid)
+{
+	List	   *defaultLevels = NIL;
+
+	if (!rel_is_partitioned(rootOid))
+	{
+		return NIL;
+	}
+
+	/* get number of partitioning levels */
+	List	   *partkeys = rel_partition_keys_ordered(rootOid);
+	int			nLevels = list_length(partkeys);
+
+	for (int level = 0; level < nLevels; level++)
+	{
+		PartitionNode *pn = get_parts(rootOid, level, 0 /* parent */ , false /* inctemplate */ , false /* includesubparts */ );
+
+		Assert(NULL != pn);
+		if (NULL != pn->default_part)
+			defaultLevels = lappend_int(defaultLevels, level);
+	}
+
+	list_free(partkeys);
+	return defaultLevels;
+}
+
 /*
  * populateIndexInfo
  *  Populate the IndexInfo structure with the information from pg_index tuple.
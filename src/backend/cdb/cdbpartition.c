@@ -36,6 +36,7 @@
 #include "catalog/namespace.h"
 #include "cdb/cdbpartition.h"
 #include "cdb/cdbvars.h"
+#include "miscadmin.h"
 #include "commands/defrem.h"
 #include "commands/tablecmds.h"
 #include "commands/tablespace.h"
@@ -53,7 +54,9 @@
 #include "utils/builtins.h"
 #include "utils/datum.h"
 #include "utils/elog.h"
+#include "utils/catcache.h"
 #include "utils/fmgroids.h"
+#include "utils/inval.h"
 #include "utils/lsyscache.h"
 #include "utils/memutils.h"
 #include "utils/syscache.h"
@@ -153,6 +156,8 @@ static bool compare_partn_opfuncid(PartitionNode *partnode,
 					   List *colvals,
 					   Datum *values, bool *isnull,
 					   TupleDesc tupdesc);
+static void buildListPartitionLookup(PartitionNode *partnode, TupleDesc tupdesc,
+						 Oid exprTypeOid, PartitionListState *ls);
 static PartitionNode *selectListPartition(PartitionNode *partnode, Datum *values, bool *isnull,
 					TupleDesc tupdesc, PartitionAccessMethods *accessMethods,
 					Oid *foundOid, PartitionRule **prule, Oid exprTypid);
@@ -2298,6 +2303,117 @@ get_parts(Oid relid, int2 level, Oid parent, bool inctemplate,
 	return pnode;
 }
 
+/*
+ * Backend-local cache of partition descriptor trees.
+ *
+ * Rebuilding the PartitionNode tree of a heavily partitioned table from the
+ * pg_partition catalogs costs a catalog scan per level and rule; with tens
+ * of thousands of leaves that is tens of milliseconds for every statement
+ * that touches the table.  We keep one prebuilt tree per root relation in
+ * CacheMemoryContext and hand out copies, so the planner, the optimizer
+ * translator and the executor all start from the same cached tree.
+ *
+ * Every element of the tree comes from pg_partition or pg_partition_rule,
+ * both of which have syscaches, so flushing the cache from their syscache
+ * invalidation callbacks catches all partition DDL, including DDL executed
+ * by other backends.  Partition DDL is rare enough that the callbacks
+ * simply drop the whole cache.
+ */
+typedef struct PartitionNodeCacheEntry
+{
+	Oid			relid;			/* root of the partitioned table (hash key) */
+	MemoryContext context;		/* private context holding pnode */
+	PartitionNode *pnode;		/* the cached descriptor tree */
+} PartitionNodeCacheEntry;
+
+static HTAB *partitionNodeCache = NULL;
+
+/*
+ * Drop every cached partition descriptor.  Registered for the PARTOID and
+ * PARTRULEOID syscaches; any change to the partition catalogs gets here.
+ */
+static void
+InvalidatePartitionNodeCache(Datum arg, int cacheid, ItemPointer tuplePtr)
+{
+	HASH_SEQ_STATUS status;
+	PartitionNodeCacheEntry *entry;
+
+	if (partitionNodeCache == NULL)
+		return;
+
+	hash_seq_init(&status, partitionNodeCache);
+	while ((entry = hash_seq_search(&status)) != NULL)
+	{
+		MemoryContextDelete(entry->context);
+		(void) hash_search(partitionNodeCache, &entry->relid,
+						   HASH_REMOVE, NULL);
+	}
+}
+
+/*
+ * Create the cache hashtable and register for invalidations, once.
+ */
+static void
+InitPartitionNodeCache(void)
+{
+	HASHCTL		ctl;
+
+	MemSet(&ctl, 0, sizeof(ctl));
+	ctl.keysize = sizeof(Oid);
+	ctl.entrysize = sizeof(PartitionNodeCacheEntry);
+	ctl.hash = oid_hash;
+	partitionNodeCache = hash_create("Partition node cache", 16, &ctl,
+									 HASH_ELEM | HASH_FUNCTION);
+
+	/* Make sure we've initialized CacheMemoryContext. */
+	if (!CacheMemoryContext)
+		CreateCacheMemoryContext();
+
+	/* Watch for invalidation events. */
+	CacheRegisterSyscacheCallback(PARTOID,
+								  InvalidatePartitionNodeCache,
+								  (Datum) 0);
+	CacheRegisterSyscacheCallback(PARTRULEOID,
+								  InvalidatePartitionNodeCache,
+								  (Datum) 0);
+}
+
+/*
+ * Store a freshly built descriptor tree in the cache.  The cached copy
+ * lives in its own context under CacheMemoryContext so that dropping the
+ * entry releases all of it at once.
+ */
+static void
+PartitionNodeCacheInsert(Oid relid, PartitionNode *pnode)
+{
+	PartitionNodeCacheEntry *entry;
+	MemoryContext context;
+	MemoryContext oldcontext;
+	bool		found;
+
+	if (partitionNodeCache == NULL)
+		InitPartitionNodeCache();
+
+	/* Build the private copy before touching the hashtable. */
+	context = AllocSetContextCreate(CacheMemoryContext,
+									"partition descriptor",
+									ALLOCSET_SMALL_MINSIZE,
+									ALLOCSET_SMALL_INITSIZE,
+									ALLOCSET_DEFAULT_MAXSIZE);
+	oldcontext = MemoryContextSwitchTo(context);
+	pnode = copyObject(pnode);
+	MemoryContextSwitchTo(oldcontext);
+
+	entry = (PartitionNodeCacheEntry *) hash_search(partitionNodeCache,
+													&relid, HASH_ENTER,
+													&found);
+	if (found)
+		MemoryContextDelete(entry->context);
+
+	entry->context = context;
+	entry->pnode = pnode;
+}
+
 PartitionNode *
 RelationBuildPartitionDesc(Relation rel, bool inctemplate)
 {
@@ -2308,9 +2424,32 @@ PartitionNode *
 RelationBuildPartitionDescByOid(Oid relid, bool inctemplate)
 {
 	PartitionNode *n;
+	bool		use_cache;
+
+	/*
+	 * Only the common form of the descriptor (no subpartition templates) is
+	 * cached, and only in normally running backends.
+	 */
+	use_cache = (!inctemplate &&
+				 gp_enable_partition_node_cache &&
+				 IsNormalProcessingMode());
+
+	if (use_cache && partitionNodeCache != NULL)
+	{
+		PartitionNodeCacheEntry *entry;
+
+		entry = (PartitionNodeCacheEntry *) hash_search(partitionNodeCache,
+														&relid, HASH_FIND,
+														NULL);
+		if (entry != NULL)
+			return copyObject(entry->pnode);
+	}
 
 	n = get_parts(relid, 0, 0, inctemplate, true /* includesubparts */ );
 
+	if (use_cache && n != NULL)
+		PartitionNodeCacheInsert(relid, n);
+
 	return n;
 }
 
@@ -3786,6 +3925,137 @@ compare_partn_opfuncid(PartitionNode *partnode,
 	return true;
 }								/* end compare_partn_opfuncid */
 
+/* Minimum number of list rules before building the hash lookup pays off */
+#define MIN_LIST_LOOKUP_RULES 8
+
+static int
+list_lookup_entry_cmp(const void *a, const void *b)
+{
+	const PartitionListLookupEntry *ea = (const PartitionListLookupEntry *) a;
+	const PartitionListLookupEntry *eb = (const PartitionListLookupEntry *) b;
+
+	if (ea->hashval < eb->hashval)
+		return -1;
+	if (ea->hashval > eb->hashval)
+		return 1;
+	return 0;
+}
+
+/*
+ * Compile the rules of a list partitioned level into a lookup table sorted
+ * by hash value, so that selecting the part for a tuple costs one hash and
+ * a binary search instead of walking the rule list and comparing every
+ * listed value.
+ *
+ * Only the plain case qualifies: a single-column key, no cross-type
+ * comparison (the tuple value must be of the column type so the column
+ * type's hash function applies to it), and a type with a default hash
+ * opclass.  Anything else leaves ls->lookup NULL and the caller falls back
+ * to the exhaustive scan.
+ */
+static void
+buildListPartitionLookup(PartitionNode *partnode, TupleDesc tupdesc,
+						 Oid exprTypeOid, PartitionListState *ls)
+{
+	Partition  *part = partnode->part;
+	AttrNumber	attno;
+	Oid			typid;
+	Operator	op;
+	Oid			opno;
+	Oid			opfuncid;
+	Oid			lhs_hashfn;
+	Oid			rhs_hashfn;
+	PartitionListLookupEntry *lookup;
+	int			nvalues = 0;
+	int			i = 0;
+	ListCell   *lc;
+
+	ls->lookup_tried = true;
+
+	if (part->parnatts != 1)
+		return;
+
+	if (list_length(partnode->rules) < MIN_LIST_LOOKUP_RULES)
+		return;
+
+	attno = part->paratts[0];
+	typid = tupdesc->attrs[attno - 1]->atttypid;
+
+	if (OidIsValid(exprTypeOid) && exprTypeOid != typid)
+		return;
+
+	/*
+	 * The hash function comes from the hash opfamily of the same "=" the
+	 * exhaustive scan compares with, so hash(a) == hash(b) whenever a = b.
+	 * Types whose "=" is not hashable fall back to the exhaustive scan.
+	 */
+	op = oper(NULL, list_make2(makeString("pg_catalog"), makeString("=")),
+			  typid, typid, true /* noError */ , -1);
+	if (op == NULL)
+		return;
+	opno = oprid(op);
+	opfuncid = ((Form_pg_operator) GETSTRUCT(op))->oprcode;
+	ReleaseSysCache(op);
+
+	if (!get_op_hash_functions(opno, &lhs_hashfn, &rhs_hashfn))
+		return;
+
+	fmgr_info(lhs_hashfn, &ls->lookup_hashfunc);
+
+	/*
+	 * The probes re-check candidates with the same equality function the
+	 * exhaustive scan uses, so set it up here.
+	 */
+	if (!ls->eqinit[0])
+	{
+		fmgr_info(opfuncid, &(ls->eqfuncs[0]));
+		ls->eqinit[0] = true;
+	}
+
+	foreach(lc, partnode->rules)
+		nvalues += list_length(((PartitionRule *) lfirst(lc))->parlistvalues);
+
+	lookup = palloc(nvalues * sizeof(PartitionListLookupEntry));
+
+	foreach(lc, partnode->rules)
+	{
+		PartitionRule *rule = (PartitionRule *) lfirst(lc);
+		ListCell   *lc2;
+
+		foreach(lc2, rule->parlistvalues)
+		{
+			List	   *colvals = (List *) lfirst(lc2);
+			Const	   *c;
+
+			if (list_length(colvals) != 1 ||
+				!IsA(linitial(colvals), Const))
+			{
+				/* unexpected shape; leave the exhaustive scan in charge */
+				pfree(lookup);
+				return;
+			}
+
+			c = (Const *) linitial(colvals);
+			if (c->constisnull)
+				ls->lookup_nullrule = (struct PartitionRule *) rule;
+			else
+			{
+				lookup[i].hashval =
+					DatumGetUInt32(FunctionCall1(&ls->lookup_hashfunc,
+												 c->constvalue));
+				lookup[i].value = c->constvalue;
+				lookup[i].rule = (struct PartitionRule *) rule;
+				i++;
+			}
+		}
+	}
+
+	qsort(lookup, i, sizeof(PartitionListLookupEntry), list_lookup_entry_cmp);
+
+	ls->lookup = lookup;
+	ls->nlookup = i;
+}
+
 /*
  *	Given a partition-by-list PartitionNode, search for
  *	a part that matches the given datum value.
@@ -3820,15 +4090,93 @@ selectListPartition(PartitionNode *partnode, Datum *values, bool *isnull,
 		ls->eqfuncs = palloc(sizeof(FmgrInfo) * natts);
 		ls->eqinit = palloc0(sizeof(bool) * natts);
 
+		ls->lookup = NULL;
+		ls->nlookup = 0;
+		ls->lookup_nullrule = NULL;
+
+		/*
+		 * Without accessMethods this state is rebuilt for every call, so
+		 * building the lookup table would cost more than it saves.
+		 */
+		ls->lookup_tried = (accessMethods == NULL);
+
 		if (accessMethods)
 			accessMethods->amstate[partnode->part->parlevel] = (void *) ls;
 	}
 
+	/*
+	 * Build the lookup table while still in our caller's memory context, so
+	 * it persists across tuples like the rest of the state in ls.
+	 */
+	if (!ls->lookup_tried)
+		buildListPartitionLookup(partnode, tupdesc, exprTypeOid, ls);
+
 	if (accessMethods && accessMethods->part_cxt)
 		oldcxt = MemoryContextSwitchTo(accessMethods->part_cxt);
 
 	*foundOid = InvalidOid;
 
+	/*
+	 * Fast path: probe the precompiled lookup table instead of walking the
+	 * rule list.  The hash is only a filter; a candidate still has to pass
+	 * the same equality function the exhaustive scan below would use.
+	 */
+	if (ls->lookup != NULL)
+	{
+		AttrNumber	attno = part->paratts[0];
+		PartitionRule *rule = NULL;
+
+		if (isnull[attno - 1])
+			rule = (PartitionRule *) ls->lookup_nullrule;
+		else
+		{
+			Datum		d = values[attno - 1];
+			uint32		hashval = DatumGetUInt32(FunctionCall1(&ls->lookup_hashfunc, d));
+			int			low = 0;
+			int			high = ls->nlookup - 1;
+
+			while (low <= high)
+			{
+				int			mid = low + (high - low) / 2;
+
+				if (ls->lookup[mid].hashval < hashval)
+					low = mid + 1;
+				else if (ls->lookup[mid].hashval > hashval)
+					high = mid - 1;
+				else
+				{
+					int			j = mid;
+
+					/* back up to the first entry with this hash value */
+					while (j > 0 && ls->lookup[j - 1].hashval == hashval)
+						j--;
+
+					for (; j < ls->nlookup && ls->lookup[j].hashval == hashval; j++)
+					{
+						if (DatumGetBool(FunctionCall2(&ls->eqfuncs[0], d,
+													   ls->lookup[j].value)))
+						{
+							rule = (PartitionRule *) ls->lookup[j].rule;
+							break;
+						}
+					}
+					break;
+				}
+			}
+		}
+
+		if (rule != NULL)
+		{
+			*foundOid = rule->parchildrelid;
+			*prule = rule;
+		}
+
+		if (oldcxt)
+			MemoryContextSwitchTo(oldcxt);
+
+		return rule != NULL ? rule->children : NULL;
+	}
+
 	/* With LIST, we have no choice at the moment except to be exhaustive */
 	foreach(lc, partnode->rules)
 	{
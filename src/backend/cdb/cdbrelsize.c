@@ -23,12 +23,179 @@
 #include "cdb/cdbdispatchresult.h"
 #include "libpq-fe.h"
 #include "lib/stringinfo.h"
+#include "storage/lwlock.h"
+#include "storage/shmem.h"
 #include "utils/int8.h"
 #include "utils/lsyscache.h"
 #include "utils/builtins.h"
+#include "utils/timestamp.h"
 
 #include "cdb/cdbrelsize.h"
 
+/*
+ * Shared cache of dispatched relation sizes, keyed by (database, relation).
+ *
+ * Dispatching "select pg_relation_size()" to every segment serializes
+ * planning behind a cluster round trip.  To bound that cost, the result of
+ * each dispatch is stored here, and cdbRelMaxSegSizeCached() serves planner
+ * requests from the cache while the entry is younger than
+ * gp_relsize_cache_timeout; only the first backend to touch a relation
+ * after the entry expires pays for the round trip.  Callers that need the
+ * exact current size (e.g. emptiness checks in DDL) keep using
+ * cdbRelMaxSegSize(), which always dispatches and refreshes the cache as a
+ * side effect.
+ */
+typedef struct RelSizeCacheKey
+{
+	Oid			dbid;
+	Oid			relid;
+} RelSizeCacheKey;
+
+typedef struct RelSizeCacheEntry
+{
+	RelSizeCacheKey key;		/* hash key, must be first */
+	int64		size;			/* last dispatched max segment size */
+	TimestampTz lastUpdate;		/* when the size was dispatched */
+} RelSizeCacheEntry;
+
+#define RELSIZE_CACHE_SIZE		4096
+
+static HTAB *RelSizeCacheHash = NULL;
+
+/* Seconds a cached relation size stays usable; 0 disables the cache. */
+int			gp_relsize_cache_timeout = 0;
+
+/*
+ * CdbRelSizeCacheShmemSize -- estimate the shared memory needed for the
+ * relation size cache.
+ */
+Size
+CdbRelSizeCacheShmemSize(void)
+{
+	Insist(Gp_role == GP_ROLE_DISPATCH);
+
+	return hash_estimate_size((Size) RELSIZE_CACHE_SIZE,
+							  sizeof(RelSizeCacheEntry));
+}
+
+/*
+ * CdbRelSizeCacheShmemInit -- initialize the relation size cache.
+ */
+void
+CdbRelSizeCacheShmemInit(void)
+{
+	HASHCTL		info;
+
+	Insist(Gp_role == GP_ROLE_DISPATCH);
+
+	MemSet(&info, 0, sizeof(info));
+	info.keysize = sizeof(RelSizeCacheKey);
+	info.entrysize = sizeof(RelSizeCacheEntry);
+	info.hash = tag_hash;
+
+	RelSizeCacheHash = ShmemInitHash("CDB Relation Size Cache",
+									 RELSIZE_CACHE_SIZE,
+									 RELSIZE_CACHE_SIZE,
+									 &info,
+									 HASH_ELEM | HASH_FUNCTION);
+
+	if (!RelSizeCacheHash)
+		ereport(FATAL,
+				(errcode(ERRCODE_OUT_OF_MEMORY),
+				 errmsg("not enough shared memory for relation size cache")));
+}
+
+/*
+ * Remember a dispatched size in the shared cache.
+ *
+ * If the (fixed-size) hash table is full, reap entries that have already
+ * expired and retry once; if everything is still live we simply don't cache
+ * this relation.
+ */
+static void
+cdbRelSizeCacheStore(Oid relid, int64 size)
+{
+	RelSizeCacheKey key;
+	RelSizeCacheEntry *entry;
+	TimestampTz now = GetCurrentTimestamp();
+
+	if (RelSizeCacheHash == NULL || gp_relsize_cache_timeout <= 0)
+		return;
+
+	key.dbid = MyDatabaseId;
+	key.relid = relid;
+
+	LWLockAcquire(RelSizeCacheLock, LW_EXCLUSIVE);
+
+	entry = (RelSizeCacheEntry *) hash_search(RelSizeCacheHash,
+											  (void *) &key,
+											  HASH_ENTER_NULL, NULL);
+	if (entry == NULL)
+	{
+		HASH_SEQ_STATUS hstat;
+		RelSizeCacheEntry *old;
+
+		hash_seq_init(&hstat, RelSizeCacheHash);
+		while ((old = (RelSizeCacheEntry *) hash_seq_search(&hstat)) != NULL)
+		{
+			if (TimestampDifferenceExceeds(old->lastUpdate, now,
+										   gp_relsize_cache_timeout * 1000))
+				hash_search(RelSizeCacheHash, (void *) &old->key,
+							HASH_REMOVE, NULL);
+		}
+
+		entry = (RelSizeCacheEntry *) hash_search(RelSizeCacheHash,
+												  (void *) &key,
+												  HASH_ENTER_NULL, NULL);
+	}
+
+	if (entry != NULL)
+	{
+		entry->size = size;
+		entry->lastUpdate = now;
+	}
+
+	LWLockRelease(RelSizeCacheLock);
+}
+
+/*
+ * Get the max size of the relation across segments, accepting a cached
+ * value no older than gp_relsize_cache_timeout.  Use this only where a
+ * bounded-staleness size is acceptable, such as planner estimates.
+ */
+int64
+cdbRelMaxSegSizeCached(Relation rel)
+{
+	RelSizeCacheKey key;
+	RelSizeCacheEntry *entry;
+	int64		size;
+
+	if (RelSizeCacheHash == NULL || gp_relsize_cache_timeout <= 0)
+		return cdbRelMaxSegSize(rel);
+
+	key.dbid = MyDatabaseId;
+	key.relid = RelationGetRelid(rel);
+
+	LWLockAcquire(RelSizeCacheLock, LW_SHARED);
+
+	entry = (RelSizeCacheEntry *) hash_search(RelSizeCacheHash,
+											  (void *) &key,
+											  HASH_FIND, NULL);
+	if (entry != NULL &&
+		!TimestampDifferenceExceeds(entry->lastUpdate, GetCurrentTimestamp(),
+									gp_relsize_cache_timeout * 1000))
+	{
+		size = entry->size;
+		LWLockRelease(RelSizeCacheLock);
+		return size;
+	}
+
+	LWLockRelease(RelSizeCacheLock);
+
+	/* Not cached, or too stale: dispatch (which refreshes the cache). */
+	return cdbRelMaxSegSize(rel);
+}
+
 /*
  * Get the max size of the relation across segments
  */
@@ -78,5 +245,7 @@ cdbRelMaxSegSize(Relation rel)
 
 	cdbdisp_clearCdbPgResults(&cdb_pgresults);
 
+	cdbRelSizeCacheStore(RelationGetRelid(rel), size);
+
 	return size;
 }
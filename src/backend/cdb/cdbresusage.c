@@ -0,0 +1,257 @@
+/*-------------------------------------------------------------------------
+ *
+ * cdbresusage.c
+ *	  Per-query CPU and I/O accounting.
+ *
+ * The executor calls ResUsageQueryStart() / ResUsageQueryEnd() around
+ * every (outermost) query.  Start takes a getrusage() snapshot; End
+ * computes the deltas and appends one entry, tagged with the query's
+ * session id and command count, to a fixed-size ring in shared memory.
+ * Because both the dispatcher and the qExecs do this, summing the
+ * entries of all segments for one (session_id, command_count) pair
+ * yields the cluster-wide CPU seconds and block I/O of that query;
+ * gp_query_resource_usage() reads a segment's ring out, and is declared
+ * EXECUTE ON ALL SEGMENTS so the aggregation is a plain GROUP BY on the
+ * dispatcher.
+ *
+ * The cost per query is two getrusage() calls and one spinlocked ring
+ * append, so this stays on unconditionally.
+ *
+ * Portions Copyright (c) 2012-Present Pivotal Software, Inc.
+ *
+ * IDENTIFICATION
+ *	    src/backend/cdb/cdbresusage.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#ifdef HAVE_GETRUSAGE
+#include <sys/resource.h>
+#else
+#include "rusagestub.h"
+#endif
+
+#include "funcapi.h"
+#include "miscadmin.h"
+#include "catalog/pg_type.h"
+#include "portability/instr_time.h"
+#include "storage/shmem.h"
+#include "storage/spin.h"
+#include "utils/builtins.h"
+#include "utils/workfile_mgr.h"
+#include "cdb/cdbresusage.h"
+#include "cdb/cdbvars.h"
+
+typedef struct GpResUsageRing
+{
+	slock_t		lock;			/* protects nextSlot and the entries */
+	uint64		nextSlot;		/* total entries ever written */
+	GpResUsageEntry entries[GP_RESUSAGE_RING_SIZE];
+} GpResUsageRing;
+
+static GpResUsageRing *ResUsageRing = NULL;
+
+/*
+ * State of the query currently being accounted by this backend.  Nested
+ * executor runs (SPI, functions) are folded into the outermost query, so
+ * only the depth 0 -> 1 transition snapshots and only the 1 -> 0
+ * transition records.
+ */
+static struct
+{
+	int			nesting;
+	int			sessionId;
+	int			commandCount;
+	instr_time	startTime;
+	struct rusage startRu;
+} CurrentQuery;
+
+Size
+ResUsageShmemSize(void)
+{
+	return MAXALIGN(sizeof(GpResUsageRing));
+}
+
+void
+ResUsageShmemInit(void)
+{
+	ResUsageRing = (GpResUsageRing *) ShmemAlloc(ResUsageShmemSize());
+	MemSet(ResUsageRing, 0, sizeof(GpResUsageRing));
+	SpinLockInit(&ResUsageRing->lock);
+}
+
+/*
+ * ResUsageQueryStart --- snapshot resource usage at executor startup
+ */
+void
+ResUsageQueryStart(void)
+{
+	if (ResUsageRing == NULL)
+		return;
+
+	/*
+	 * A new command resets the nesting depth; this also recovers from any
+	 * depth leaked by an aborted query, whose ExecutorEnd never ran.
+	 */
+	if (CurrentQuery.sessionId != gp_session_id ||
+		CurrentQuery.commandCount != gp_command_count)
+		CurrentQuery.nesting = 0;
+
+	if (CurrentQuery.nesting++ > 0)
+		return;
+
+	CurrentQuery.sessionId = gp_session_id;
+	CurrentQuery.commandCount = gp_command_count;
+	INSTR_TIME_SET_CURRENT(CurrentQuery.startTime);
+	getrusage(RUSAGE_SELF, &CurrentQuery.startRu);
+}
+
+/*
+ * ResUsageQueryEnd --- account the finished query into the shared ring
+ */
+void
+ResUsageQueryEnd(void)
+{
+	instr_time	endTime;
+	struct rusage endRu;
+	int64		spillBytes;
+	GpResUsageEntry *entry;
+
+	if (ResUsageRing == NULL || CurrentQuery.nesting <= 0)
+		return;
+
+	if (--CurrentQuery.nesting > 0)
+		return;
+
+	INSTR_TIME_SET_CURRENT(endTime);
+	INSTR_TIME_SUBTRACT(endTime, CurrentQuery.startTime);
+	getrusage(RUSAGE_SELF, &endRu);
+
+	/*
+	 * Workfile space still charged to this query; an approximation of its
+	 * spill footprint, since files freed during execution are no longer
+	 * counted.  Returns -1 when the query never spilled.
+	 */
+	spillBytes = WorkfileQueryspace_GetSize(CurrentQuery.sessionId,
+											CurrentQuery.commandCount);
+	if (spillBytes < 0)
+		spillBytes = 0;
+
+	SpinLockAcquire(&ResUsageRing->lock);
+	entry = &ResUsageRing->entries[ResUsageRing->nextSlot % GP_RESUSAGE_RING_SIZE];
+	ResUsageRing->nextSlot++;
+
+	entry->sessionId = CurrentQuery.sessionId;
+	entry->commandCount = CurrentQuery.commandCount;
+	entry->endTime = GetCurrentTimestamp();
+	entry->elapsedUs = (int64) (INSTR_TIME_GET_DOUBLE(endTime) * 1000000.0);
+	entry->cpuUserUs = (int64) (endRu.ru_utime.tv_sec - CurrentQuery.startRu.ru_utime.tv_sec) * 1000000 +
+		(endRu.ru_utime.tv_usec - CurrentQuery.startRu.ru_utime.tv_usec);
+	entry->cpuSysUs = (int64) (endRu.ru_stime.tv_sec - CurrentQuery.startRu.ru_stime.tv_sec) * 1000000 +
+		(endRu.ru_stime.tv_usec - CurrentQuery.startRu.ru_stime.tv_usec);
+	entry->readBytes = (int64) (endRu.ru_inblock - CurrentQuery.startRu.ru_inblock) * 512;
+	entry->writeBytes = (int64) (endRu.ru_oublock - CurrentQuery.startRu.ru_oublock) * 512;
+	entry->spillBytes = spillBytes;
+	SpinLockRelease(&ResUsageRing->lock);
+}
+
+/*
+ * gp_query_resource_usage - one row per retained finished query.
+ */
+Datum
+gp_query_resource_usage(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+	GpResUsageEntry *snapshot;
+	int			index;
+
+	if (SRF_IS_FIRSTCALL())
+	{
+		TupleDesc	tupdesc;
+		MemoryContext oldcontext;
+
+		funcctx = SRF_FIRSTCALL_INIT();
+
+		oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+		tupdesc = CreateTemplateTupleDesc(10, false);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 1, "segid",
+						   INT4OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 2, "session_id",
+						   INT4OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 3, "command_count",
+						   INT4OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 4, "end_time",
+						   TIMESTAMPTZOID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 5, "elapsed_us",
+						   INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 6, "cpu_user_us",
+						   INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 7, "cpu_sys_us",
+						   INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 8, "read_bytes",
+						   INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 9, "write_bytes",
+						   INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 10, "spill_bytes",
+						   INT8OID, -1, 0);
+
+		funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+
+		/* copy the ring so each call iterates over a stable image */
+		snapshot = (GpResUsageEntry *)
+			palloc(GP_RESUSAGE_RING_SIZE * sizeof(GpResUsageEntry));
+		if (ResUsageRing != NULL)
+		{
+			SpinLockAcquire(&ResUsageRing->lock);
+			memcpy(snapshot, ResUsageRing->entries,
+				   GP_RESUSAGE_RING_SIZE * sizeof(GpResUsageEntry));
+			SpinLockRelease(&ResUsageRing->lock);
+		}
+		else
+			MemSet(snapshot, 0, GP_RESUSAGE_RING_SIZE * sizeof(GpResUsageEntry));
+
+		funcctx->user_fctx = (void *) snapshot;
+		funcctx->call_cntr = 0;
+		funcctx->max_calls = GP_RESUSAGE_RING_SIZE;
+
+		MemoryContextSwitchTo(oldcontext);
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+	snapshot = (GpResUsageEntry *) funcctx->user_fctx;
+
+	for (index = funcctx->call_cntr; index < funcctx->max_calls; index++)
+	{
+		GpResUsageEntry *entry = &snapshot[index];
+		Datum		values[10];
+		bool		nulls[10];
+		HeapTuple	tuple;
+
+		if (entry->sessionId == 0)
+			continue;
+
+		values[0] = Int32GetDatum(GpIdentity.segindex);
+		values[1] = Int32GetDatum(entry->sessionId);
+		values[2] = Int32GetDatum(entry->commandCount);
+		values[3] = TimestampTzGetDatum(entry->endTime);
+		values[4] = Int64GetDatum(entry->elapsedUs);
+		values[5] = Int64GetDatum(entry->cpuUserUs);
+		values[6] = Int64GetDatum(entry->cpuSysUs);
+		values[7] = Int64GetDatum(entry->readBytes);
+		values[8] = Int64GetDatum(entry->writeBytes);
+		values[9] = Int64GetDatum(entry->spillBytes);
+		MemSet(nulls, false, sizeof(nulls));
+
+		tuple = heap_form_tuple(funcctx->tuple_desc, values, nulls);
+
+		/* skip the entries consumed by this scan, including this one */
+		funcctx->call_cntr = index;
+
+		SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+	}
+
+	SRF_RETURN_DONE(funcctx);
+}
@@ -46,8 +46,17 @@
 static int	GetNextSegid(CdbSreh *cdbsreh);
 static void PreprocessByteaData(char *src);
 static void ErrorLogWrite(CdbSreh *cdbsreh);
+static void ErrorLogFlush(CdbSreh *cdbsreh);
 
 #define ErrorLogDir "errlog"
+
+/*
+ * Flush buffered error log records to the log file once this many bytes have
+ * accumulated. Small enough that a load keeps a modest footprint per bad row
+ * burst, large enough that the per-append lock/open/close cost is amortized
+ * over many rows.
+ */
+#define ERRORLOG_FLUSH_SIZE (64 * 1024)
 #define ErrorLogFileName(fname, dbId, relId) \
 	snprintf(fname, MAXPGPATH, "errlog/%u_%u", dbId, relId)
 
@@ -103,6 +112,8 @@ makeCdbSreh(int rejectlimit, bool is_limit_in_rows,
 	snprintf(h->filename, sizeof(h->filename),
 			 "%s", filename ? filename : "<stdin>");
 
+	initStringInfo(&h->logbuf);
+
 	/*
 	 * Create a temporary memory context that we can reset once per row to
 	 * recover palloc'd memory.  This avoids any problems with leaks inside
@@ -121,6 +132,9 @@ makeCdbSreh(int rejectlimit, bool is_limit_in_rows,
 void
 destroyCdbSreh(CdbSreh *cdbsreh)
 {
+	/* write out any bad rows still sitting in the buffer */
+	ErrorLogFlush(cdbsreh);
+	pfree(cdbsreh->logbuf.data);
 
 	/* delete the bad row context */
 	MemoryContextDelete(cdbsreh->badrowcontext);
@@ -149,10 +163,15 @@ HandleSingleRowError(CdbSreh *cdbsreh)
 
 	/*
 	 * if reached the segment reject limit don't do anything. (this will get
-	 * checked and handled later on by the caller).
+	 * checked and handled later on by the caller). Push out the buffered
+	 * error log records now, so the rows rejected before the limit was hit
+	 * are on disk when the caller aborts the load.
 	 */
 	if (IsRejectLimitReached(cdbsreh))
+	{
+		ErrorLogFlush(cdbsreh);
 		return;
+	}
 
 	/*
 	 * If not specified table or file, do nothing.  Otherwise, record the
@@ -561,26 +580,56 @@ VerifyRejectLimit(char rejectlimittype, int rejectlimit)
 }
 
 /*
- * Write into the error log file.  This opens the file every time,
- * so that we can keep it simple to deal with concurrent write.
+ * Buffer one error log record for writing.  Records accumulate in
+ * cdbsreh->logbuf and are appended to the log file in bulk by
+ * ErrorLogFlush(), so a load with a high error rate does not pay the
+ * lock/open/close cost for every single bad row.
  */
 static void
 ErrorLogWrite(CdbSreh *cdbsreh)
 {
 	HeapTuple	tuple;
-	char		filename[MAXPGPATH];
-	FILE	   *fp;
 	pg_crc32	crc;
-	int			ret;
 
 	Assert(OidIsValid(cdbsreh->relid));
-	ErrorLogFileName(filename, MyDatabaseId, cdbsreh->relid);
 	tuple = FormErrorTuple(cdbsreh);
 
 	INIT_CRC32C(crc);
 	COMP_CRC32C(crc, tuple->t_data, tuple->t_len);
 	FIN_CRC32C(crc);
 
+	/*
+	 * format: 0-4: length 5-8: crc 9-n: tuple data
+	 */
+	appendBinaryStringInfo(&cdbsreh->logbuf,
+						   (char *) &tuple->t_len, sizeof(tuple->t_len));
+	appendBinaryStringInfo(&cdbsreh->logbuf, (char *) &crc, sizeof(pg_crc32));
+	appendBinaryStringInfo(&cdbsreh->logbuf, (char *) tuple->t_data, tuple->t_len);
+
+	heap_freetuple(tuple);
+
+	if (cdbsreh->logbuf.len >= ERRORLOG_FLUSH_SIZE)
+		ErrorLogFlush(cdbsreh);
+}
+
+/*
+ * Append the buffered error log records to the error log file.  This opens
+ * the file every time, so that we can keep it simple to deal with concurrent
+ * write.
+ */
+static void
+ErrorLogFlush(CdbSreh *cdbsreh)
+{
+	char		filename[MAXPGPATH];
+	FILE	   *fp;
+	int			ret;
+
+	if (cdbsreh->logbuf.len == 0)
+		return;
+
+	Assert(OidIsValid(cdbsreh->relid));
+	ErrorLogFileName(filename, MyDatabaseId, cdbsreh->relid);
+
 	LWLockAcquire(ErrorLogLock, LW_EXCLUSIVE);
 	fp = AllocateFile(filename, "a");
 
@@ -598,20 +647,13 @@ ErrorLogWrite(CdbSreh *cdbsreh)
 	if (!fp)
 		ereport(ERROR, (errmsg("could not open \"%s\": %m", filename)));
 
-	/*
-	 * format: 0-4: length 5-8: crc 9-n: tuple data
-	 */
-	if (fwrite(&tuple->t_len, 1, sizeof(tuple->t_len), fp) != sizeof(tuple->t_len))
-		elog(ERROR, "could not write tuple length: %m");
-	if (fwrite(&crc, 1, sizeof(pg_crc32), fp) != sizeof(pg_crc32))
-		elog(ERROR, "could not write checksum: %m");
-	if (fwrite(tuple->t_data, 1, tuple->t_len, fp) != tuple->t_len)
-		elog(ERROR, "could not write tuple data: %m");
+	if (fwrite(cdbsreh->logbuf.data, 1, cdbsreh->logbuf.len, fp) != cdbsreh->logbuf.len)
+		elog(ERROR, "could not write error log records: %m");
 
 	FreeFile(fp);
 	LWLockRelease(ErrorLogLock);
 
-	heap_freetuple(tuple);
+	resetStringInfo(&cdbsreh->logbuf);
 }
 
 /*
@@ -25,6 +25,12 @@
 #include "utils/memaccounting.h"
 #include "utils/zlib_wrapper.h"
 
+/*
+ * Node trees smaller than this are shipped uncompressed: deflating a few
+ * hundred bytes costs more dispatch latency than it saves on the wire.
+ */
+#define COMPRESS_THRESHOLD_BYTES 1024
+
 static char *compress_string(const char *src, int uncompressed_size, int *size);
 static char *uncompress_string(const char *src, int size, int *uncompressed_len);
 
@@ -91,6 +97,10 @@ deserializeNode(const char *strNode, int size)
 /*
  * Compress a (binary) string using zlib.
  *
+ * The output starts with the original length; a negative length marks a
+ * string that was stored verbatim, either because it was smaller than
+ * COMPRESS_THRESHOLD_BYTES or because deflate failed to shrink it.
+ *
  * returns the compressed data and the size of the compressed data.
  */
 static char *
@@ -99,6 +109,7 @@ compress_string(const char *src, int uncompressed_size, int *size)
 	int			level = 3;
 	unsigned long compressed_size;
 	int			status;
+	int			stored_marker;
 
 	Bytef	   *result;
 
@@ -110,18 +121,36 @@ compress_string(const char *src, int uncompressed_size, int *size)
 		return NULL;
 	}
 
-	compressed_size = gp_compressBound(uncompressed_size);	/* worst case */
+	if (uncompressed_size >= COMPRESS_THRESHOLD_BYTES)
+	{
+		compressed_size = gp_compressBound(uncompressed_size);	/* worst case */
 
-	result = palloc(compressed_size + sizeof(int));
-	memcpy(result, &uncompressed_size, sizeof(int));	/* save the original
-														 * length */
+		result = palloc(compressed_size + sizeof(int));
+		memcpy(result, &uncompressed_size, sizeof(int));	/* save the original
+															 * length */
 
-	status = gp_compress2(result + sizeof(int), &compressed_size, (Bytef *) src, uncompressed_size, level);
-	if (status != Z_OK)
-		elog(ERROR, "Compression failed: %s (errno=%d) uncompressed len %d, compressed %d",
-			 zError(status), status, uncompressed_size, (int) compressed_size);
+		status = gp_compress2(result + sizeof(int), &compressed_size, (Bytef *) src, uncompressed_size, level);
+		if (status != Z_OK)
+			elog(ERROR, "Compression failed: %s (errno=%d) uncompressed len %d, compressed %d",
+				 zError(status), status, uncompressed_size, (int) compressed_size);
+
+		if (compressed_size < (unsigned long) uncompressed_size)
+		{
+			*size = compressed_size + sizeof(int);
+
+			return (char *) result;
+		}
+
+		/* deflate didn't shrink it; store verbatim instead */
+		pfree(result);
+	}
 
-	*size = compressed_size + sizeof(int);
+	result = palloc(uncompressed_size + sizeof(int));
+	stored_marker = -uncompressed_size;
+	memcpy(result, &stored_marker, sizeof(int));
+	memcpy(result + sizeof(int), src, uncompressed_size);
+
+	*size = uncompressed_size + sizeof(int);
 
 	return (char *) result;
 }
@@ -145,6 +174,18 @@ uncompress_string(const char *src, int size, int *uncompressed_len)
 
 	memcpy(uncompressed_len, src, sizeof(int));
 
+	if (*uncompressed_len < 0)
+	{
+		/* stored verbatim by compress_string() */
+		*uncompressed_len = -*uncompressed_len;
+		Assert(*uncompressed_len == size - (int) sizeof(int));
+
+		result = palloc(*uncompressed_len);
+		memcpy(result, src + sizeof(int), *uncompressed_len);
+
+		return (char *) result;
+	}
+
 	resultlen = *uncompressed_len;
 	result = palloc(resultlen);
 
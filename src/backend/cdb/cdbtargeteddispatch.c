@@ -316,15 +316,23 @@ GetContentIdsFromPlanForSingleRelation(List *rtable, Plan *plan, int rangeTableI
 				hashCode = cdbhashreduce(h);
 
 				/*
-				 * right now we only allow ONE contentid
+				 * Accumulate the set of target segments.  Multiple values
+				 * (e.g. from an IN-list on the distribution key) may hash to
+				 * different segments; the dispatch descriptor carries the
+				 * whole set.
 				 */
-				if (result.dd.contentIds == NULL)
-					result.dd.contentIds = list_make1_int(hashCode);
-				else if (linitial_int(result.dd.contentIds) != hashCode)
-				{
-					result.dd.isDirectDispatch = false;
-					break;
-				}
+				result.dd.contentIds = list_append_unique_int(result.dd.contentIds, hashCode);
+			}
+
+			/*
+			 * If the values cover every segment anyway then plain dispatch
+			 * is no worse and simpler.
+			 */
+			if (result.dd.isDirectDispatch &&
+				list_length(result.dd.contentIds) >= GpIdentity.numsegments)
+			{
+				result.dd.isDirectDispatch = false;
+				result.dd.contentIds = NULL;
 			}
 		}
 		else
@@ -364,20 +372,23 @@ MergeDirectDispatchCalculationInfo(DirectDispatchCalculationInfo *to, DirectDisp
 		/* to didn't even think it needed to run so accept from */
 		to->dd.contentIds = from->dd.contentIds;
 	}
-	else if (linitial_int(to->dd.contentIds) != linitial_int(from->dd.contentIds))
+	else
 	{
 		/*
-		 * we only support dispatch to single segment or all segments, so
-		 * can't support this right now
+		 * The slice must run wherever either relation needs data, so take
+		 * the union of the two segment sets.
 		 */
-		/* but this needs to be a union of the segments */
-		to->dd.isDirectDispatch = false;
-	}
-	else
-	{
-		/* they matched -- no merge required! */
+		ListCell   *cell;
 
-		Assert(list_length(to->dd.contentIds) == list_length(from->dd.contentIds));
+		foreach(cell, from->dd.contentIds)
+			to->dd.contentIds = list_append_unique_int(to->dd.contentIds, lfirst_int(cell));
+
+		if (list_length(to->dd.contentIds) >= GpIdentity.numsegments)
+		{
+			/* union covers every segment: fall back to plain dispatch */
+			to->dd.isDirectDispatch = false;
+			to->dd.contentIds = NULL;
+		}
 	}
 
 	to->haveProcessedAnyCalculations = true;
@@ -432,11 +443,16 @@ FinalizeDirectDispatchDataForSlice(Node *node, ContentIdAssignmentData *data, bo
 					if (ShouldPrintTestMessages())
 						elog(INFO, "DDCR learned no content dispatch is required");
 				}
-				else
+				else if (list_length(ddcr->dd.contentIds) == 1)
 				{
 					if (ShouldPrintTestMessages())
 						elog(INFO, "DDCR learned dispatch to content %d", linitial_int(ddcr->dd.contentIds));
 				}
+				else
+				{
+					if (ShouldPrintTestMessages())
+						elog(INFO, "DDCR learned dispatch to %d contents", list_length(ddcr->dd.contentIds));
+				}
 
 				oldContext = MemoryContextSwitchTo(data->memoryContextForOutput);
 				plan->directDispatch.contentIds = list_copy(ddcr->dd.contentIds);
@@ -139,7 +139,6 @@ static void clearTransactionState(void);
 static void doNotifyingCommitPrepared(void);
 static void doNotifyingAbort(void);
 static void retryAbortPrepared(void);
-static bool doNotifyCommittedInDoubt(char *gid);
 static void doAbortInDoubt(char *gid);
 static void doQEDistributedExplicitBegin(int txnOptions);
 
@@ -424,6 +423,13 @@ GetPlannedStmtDirectDispatch_AndUsingNodeIsSufficient(PlannedStmt *stmt)
 	if (stmt->nInitPlans > 0)
 		return false;
 
+	/*
+	 * The DTM tracks a single direct-dispatch content id, so a plan that
+	 * targets several segments must go through the regular distributed path.
+	 */
+	if (list_length(stmt->planTree->directDispatch.contentIds) != 1)
+		return false;
+
 	return true;
 }
 
@@ -1042,31 +1048,6 @@ doNotifyingAbort(void)
 	elog(DTM_DEBUG5, "doNotifyingAbort called resetCurrentGxact");
 }
 
-static bool
-doNotifyCommittedInDoubt(char *gid)
-{
-	bool		succeeded;
-	bool		badGangs;
-
-	CdbDispatchDirectDesc direct = default_dispatch_direct_desc;
-
-	/* UNDONE: Pass real gxid instead of InvalidDistributedTransactionId. */
-	succeeded = doDispatchDtxProtocolCommand(DTX_PROTOCOL_COMMAND_RECOVERY_COMMIT_PREPARED, /* flags */ 0,
-											 gid, InvalidDistributedTransactionId,
-											 &badGangs, /* raiseError */ false,
-											 &direct, NULL, 0);
-	if (!succeeded)
-	{
-		elog(FATAL, "Crash recovery broadcast of the distributed transaction 'Commit Prepared' broadcast failed to one or more segments for gid = %s.", gid);
-	}
-	else
-	{
-		elog(LOG, "Crash recovery broadcast of the distributed transaction 'Commit Prepared' broadcast succeeded for gid = %s.", gid);
-	}
-
-	return succeeded;
-}
-
 static void
 doAbortInDoubt(char *gid)
 {
@@ -1125,6 +1106,21 @@ prepareDtxTransaction(void)
 
 	Assert(currentGxact->state == DTX_STATE_ACTIVE_DISTRIBUTED);
 
+	/*
+	 * XXX A transaction that stayed direct-dispatched to one content
+	 * (currentGxact->directTransaction) wrote on exactly one segment, and
+	 * could in principle commit with a single one-phase message instead of
+	 * the prepare / commit-prepared pair below (the broadcasts are already
+	 * narrowed to that one content). Getting there is more than a dispatch
+	 * change, though: the segment's plain commit record would have to carry
+	 * the distributed xid so DistributedLog is updated crash-safely (today
+	 * only RecordTransactionCommitPrepared does that), the QD would skip
+	 * its distributed commit record, and recovery would need to treat the
+	 * segment's commit as the commit point. Until the commit record format
+	 * grows that information, every distributed writer goes through full
+	 * two-phase.
+	 */
+
 	/*
 	 * Broadcast PREPARE TRANSACTION to segments.
 	 */
@@ -2358,19 +2354,51 @@ recoverInDoubtTransactions(void)
 		 "Going to retry commit notification for distributed transactions (count = %d)",
 		 *shmNumCommittedGxacts);
 
-	for (i = 0; i < *shmNumCommittedGxacts; i++)
+	if (*shmNumCommittedGxacts > 0)
 	{
-		TMGXACT_LOG    *gxact_log = &shmCommittedGxactArray[i];
+		char	  **gids;
+		bool		succeeded;
 
-		Assert(gxact_log->gxid != InvalidDistributedTransactionId);
+		gids = palloc(*shmNumCommittedGxacts * sizeof(char *));
 
-		elog(DTM_DEBUG5,
-			 "Recovering committed distributed transaction gid = %s",
-			 gxact_log->gid);
+		for (i = 0; i < *shmNumCommittedGxacts; i++)
+		{
+			TMGXACT_LOG    *gxact_log = &shmCommittedGxactArray[i];
+
+			Assert(gxact_log->gxid != InvalidDistributedTransactionId);
+
+			elog(DTM_DEBUG5,
+				 "Recovering committed distributed transaction gid = %s",
+				 gxact_log->gid);
+
+			gids[i] = gxact_log->gid;
+		}
+
+		/*
+		 * Resolve all the in-doubt commits in one pipelined round trip
+		 * rather than one synchronous dispatch per transaction.  The
+		 * commands are independent and idempotent, so on failure we can
+		 * simply start over on the next recovery attempt; no forget
+		 * record is written for any of them until all have been
+		 * delivered.
+		 */
+		succeeded = CdbDispatchDtxProtocolCommandPipelined(
+			DTX_PROTOCOL_COMMAND_RECOVERY_COMMIT_PREPARED,
+			DtxProtocolCommandToString(DTX_PROTOCOL_COMMAND_RECOVERY_COMMIT_PREPARED),
+			gids, *shmNumCommittedGxacts);
+
+		if (!succeeded)
+			elog(FATAL, "Crash recovery broadcast of the distributed transaction "
+				 "'Commit Prepared' broadcast failed to one or more segments");
+
+		elog(LOG, "Crash recovery broadcast of the distributed transaction "
+			 "'Commit Prepared' broadcast succeeded for %d transactions",
+			 *shmNumCommittedGxacts);
 
-		doNotifyCommittedInDoubt(gxact_log->gid);
+		for (i = 0; i < *shmNumCommittedGxacts; i++)
+			RecordDistributedForgetCommitted(&shmCommittedGxactArray[i]);
 
-		RecordDistributedForgetCommitted(gxact_log);
+		pfree(gids);
 	}
 
 	*shmNumCommittedGxacts = 0;
@@ -80,6 +80,8 @@ bool		gp_external_enable_exec = true; /* allow ext tables with EXECUTE */
 
 int			gp_external_max_segs;	/* max segdbs per gpfdist/gpfdists URI */
 
+bool		gp_external_chain_urls = false; /* segs drain every gpfdist URI */
+
 int			gp_safefswritesize; /* set for safe AO writes in non-mature fs */
 
 int			gp_connections_per_thread;	/* How many libpq connections are
@@ -88,6 +90,9 @@ int			gp_connections_per_thread;	/* How many libpq connections are
 int			gp_cached_gang_threshold;	/* How many gangs to keep around from
 										 * stmt to stmt. */
 
+bool		gp_eager_writer_gang = false;	/* pre-create writer gang at
+											 * session start */
+
 int			Gp_segment = UNDEF_SEGMENT; /* What content this QE is handling. */
 
 bool		Gp_write_shared_snapshot;	/* tell the writer QE to write the
@@ -99,6 +104,14 @@ bool		gp_reraise_signal = false;	/* try to dump core when we get
 bool		gp_set_proc_affinity = false;	/* set processor affinity (if
 											 * platform supports it) */
 
+bool		gp_numa_interleave_shared_memory = false;	/* interleave the
+															 * shared segment
+															 * across NUMA nodes */
+
+bool		gp_numa_backend_affinity = false;	/* bind backends to the NUMA
+												 * node of their buffer
+												 * freelist partition */
+
 int			gp_reject_percent_threshold;	/* SREH reject % kicks off only
 											 * after * <num> records have been
 											 * processed	*/
@@ -146,6 +159,9 @@ int gp_fts_mark_mirror_down_grace_period = 30;
 int			gp_gang_creation_retry_count = 5;	/* disable by default */
 int			gp_gang_creation_retry_timer = 2000;	/* 2000ms */
 
+int			gp_gang_max_parallel_connects = 0;	/* cap on in-flight connect
+												 * attempts, 0 = unlimited */
+
 /*
  * gp_enable_slow_writer_testmode
  *
@@ -197,6 +213,18 @@ bool		gp_interconnect_aggressive_retry = true;	/* fast-track app-level
 
 bool		gp_interconnect_full_crc = false;	/* sanity check UDP data. */
 
+int			gp_interconnect_busy_poll_us = 0;	/* rx-thread adaptive spin
+												 * ceiling, 0 = off */
+
+int			gp_motion_batch_size = 0;	/* tuples batched per route before
+										 * chunks are sent, 0 = off */
+
+bool		gp_interconnect_compress_chunks = false;	/* compress chunk lists
+														 * before transmission */
+
+int			gp_interconnect_compress_threshold = 1024;	/* min list size (bytes)
+														 * worth compressing */
+
 bool		gp_interconnect_log_stats = false;	/* emit stats at log-level */
 
 bool		gp_interconnect_cache_future_packets = true;
@@ -240,6 +268,8 @@ bool		gp_selectivity_damping_sigsort = true;
 
 int			gp_hashjoin_tuples_per_bucket = 5;
 int			gp_hashagg_groups_per_bucket = 5;
+bool		gp_hashjoin_bloom_filter = true;
+int			gp_hashjoin_spill_batch_size = 64;
 
 
 /* default value to 0, which means we do not try to control number of spill batches */
@@ -283,6 +313,11 @@ bool		gp_disable_tuple_hints = false;
 
 int			gp_workfile_compress_algorithm = 0;
 bool		gp_workfile_checksumming = false;
+bool		gp_workfile_caching = false;
+bool		gp_workfile_mmap_read = true;
+bool		gp_shareinput_shmem_sync = true;
+int			gp_logtape_prefetch_blocks = 4;
+int			gp_workfile_discard_threshold = 0;
 int			gp_workfile_caching_loglevel = DEBUG1;
 int			gp_sessionstate_loglevel = DEBUG1;
 
@@ -302,6 +337,12 @@ int			gp_workfile_type_hashjoin = 0;
 /* Gpmon */
 bool		gp_enable_gpperfmon = false;
 int			gp_gpperfmon_send_interval = 1;
+
+/*
+ * Number of packet slots in the shared-memory telemetry ring; 0 keeps the
+ * old behavior of each backend sending its gpmon packets over UDP itself.
+ */
+int			gp_gpperfmon_queue_size = 0;
 int			gpperfmon_log_alert_level = GPPERFMON_LOG_ALERT_LEVEL_NONE;
 
 /* Enable single-slice single-row inserts ?*/
@@ -322,6 +363,7 @@ char	   *gp_autostats_mode_string;
 int			gp_autostats_mode_in_functions;
 char	   *gp_autostats_mode_in_functions_string;
 int			gp_autostats_on_change_threshold = 100000;
+bool		gp_autostats_incremental = false;
 bool		log_autostats = true;
 
 /* --------------------------------------------------------------------------------------------------
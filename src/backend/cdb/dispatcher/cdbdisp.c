@@ -24,6 +24,8 @@
 #include "cdb/cdbdisp_thread.h"
 #include "cdb/cdbdisp_async.h"
 #include "cdb/cdbdispatchresult.h"
+#include "cdb/cdbdispatchstats.h"
+#include "portability/instr_time.h"
 #include "libpq-fe.h"
 #include "libpq-int.h"
 #include "cdb/cdbfts.h"
@@ -76,6 +78,8 @@ cdbdisp_dispatchToGang(struct CdbDispatcherState *ds,
 					   CdbDispatchDirectDesc *disp_direct)
 {
 	struct CdbDispatchResults *dispatchResults = ds->primaryResults;
+	instr_time	starttime;
+	instr_time	endtime;
 
 	Assert(Gp_role == GP_ROLE_DISPATCH);
 	Assert(gp && gp->size > 0);
@@ -100,12 +104,20 @@ cdbdisp_dispatchToGang(struct CdbDispatcherState *ds,
 		}
 	}
 
+	cdbdisp_stats_countDispatch();
+	INSTR_TIME_SET_CURRENT(starttime);
+
 	/*
 	 * WIP: will use a function pointer for implementation later, currently
 	 * just use an internal function to move dispatch thread related code into
 	 * a separate file.
 	 */
 	(pDispatchFuncs->dispatchToGang) (ds, gp, sliceIndex, disp_direct);
+
+	INSTR_TIME_SET_CURRENT(endtime);
+	INSTR_TIME_SUBTRACT(endtime, starttime);
+	cdbdisp_stats_addSample(GP_DISPATCH_PHASE_ENQUEUE,
+							INSTR_TIME_GET_MICROSEC(endtime));
 }
 
 /*
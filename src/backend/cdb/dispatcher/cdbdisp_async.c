@@ -36,7 +36,9 @@
 #include "cdb/cdbgang.h"
 #include "cdb/cdbvars.h"
 #include "cdb/cdbpq.h"
+#include "cdb/cdbdispatchstats.h"
 #include "miscadmin.h"
+#include "portability/instr_time.h"
 
 #define DISPATCH_WAIT_TIMEOUT_MSEC 2000
 
@@ -78,6 +80,13 @@ typedef struct CdbDispatchCmdAsync
 	char	   *query_text;
 	int			query_text_len;
 
+	/*
+	 * When the first command was queued, and whether any result bytes have
+	 * arrived since then; used for the dispatch latency statistics.
+	 */
+	instr_time	dispatchStart;
+	bool		firstResultSeen;
+
 } CdbDispatchCmdAsync;
 
 static int	timeoutCounter = 0;
@@ -117,6 +126,8 @@ static void checkDispatchResult(CdbDispatcherState *ds,
 
 static bool processResults(CdbDispatchResult *dispatchResult);
 
+static uint64 elapsedUsSince(instr_time start);
+
 static void
 			signalQEs(CdbDispatchCmdAsync *pParms);
 
@@ -284,6 +295,16 @@ cdbdisp_dispatchToGang_async(struct CdbDispatcherState *ds,
 	int			i;
 	CdbDispatchCmdAsync *pParms = (CdbDispatchCmdAsync *) ds->dispatchParams;
 
+	/*
+	 * Stamp the start of the first enqueue; the first-result and per-QE ack
+	 * latencies are measured from here.
+	 */
+	if (pParms->dispatchCount == 0)
+	{
+		INSTR_TIME_SET_CURRENT(pParms->dispatchStart);
+		pParms->firstResultSeen = false;
+	}
+
 	/*
 	 * Start the dispatching
 	 */
@@ -297,9 +318,16 @@ cdbdisp_dispatchToGang_async(struct CdbDispatcherState *ds,
 
 		if (dispDirect->directed_dispatch)
 		{
-			/* We can direct dispatch to one segment DB only */
-			Assert(dispDirect->count == 1);
-			if (dispDirect->content[0] != segdbDesc->segindex)
+			/* skip segments that are not in the target set */
+			int			j;
+
+			Assert(dispDirect->count >= 1);
+			for (j = 0; j < dispDirect->count; j++)
+			{
+				if (dispDirect->content[j] == segdbDesc->segindex)
+					break;
+			}
+			if (j == dispDirect->count)
 				continue;
 		}
 
@@ -645,6 +673,20 @@ handlePollError(CdbDispatchCmdAsync *pParms)
 	return;
 }
 
+/*
+ * Microseconds elapsed since 'start'.
+ */
+static uint64
+elapsedUsSince(instr_time start)
+{
+	instr_time	now;
+
+	INSTR_TIME_SET_CURRENT(now);
+	INSTR_TIME_SUBTRACT(now, start);
+
+	return INSTR_TIME_GET_MICROSEC(now);
+}
+
 /*
  * Receive and process results from QEs.
  */
@@ -687,6 +729,13 @@ handlePollSuccess(CdbDispatchCmdAsync *pParms,
 		ELOG_DISPATCHER_DEBUG("PQsocket says there are results from %d of %d (%s)",
 							  i + 1, pParms->dispatchCount, segdbDesc->whoami);
 
+		if (!pParms->firstResultSeen)
+		{
+			cdbdisp_stats_addSample(GP_DISPATCH_PHASE_FIRST_RESULT,
+									elapsedUsSince(pParms->dispatchStart));
+			pParms->firstResultSeen = true;
+		}
+
 		/*
 		 * Receive and process results from this QE.
 		 */
@@ -699,6 +748,9 @@ handlePollSuccess(CdbDispatchCmdAsync *pParms,
 		{
 			dispatchResult->stillRunning = false;
 
+			cdbdisp_stats_addAck(segdbDesc->segindex,
+								 elapsedUsSince(pParms->dispatchStart));
+
 			ELOG_DISPATCHER_DEBUG("processResults says we are finished with %d of %d (%s)",
 								  i + 1, pParms->dispatchCount, segdbDesc->whoami);
 
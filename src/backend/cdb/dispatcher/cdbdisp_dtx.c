@@ -26,6 +26,7 @@
 #include "cdb/cdbdisp_dtx.h"
 #include "cdb/cdbdispatchresult.h"
 #include "cdb/cdbgang.h"
+#include "cdb/cdbpq.h"
 
 #include "storage/procarray.h"	/* updateSharedLocalSnapshot */
 #include "utils/snapmgr.h"
@@ -249,12 +250,11 @@ qdSerializeDtxContextInfo(int *size, bool wantSnapshot, bool inCursor,
 }
 
 /*
- * Build a dtx protocol command string to be dispatched to QE.
+ * Format a dtx protocol command message in the current memory context.
  */
 static char *
-buildGpDtxProtocolCommand(struct CdbDispatcherState *ds,
-						  DispatchCommandDtxProtocolParms *pDtxProtocolParms,
-						  int *finalLen)
+formatGpDtxProtocolCommand(DispatchCommandDtxProtocolParms *pDtxProtocolParms,
+						   int *finalLen)
 {
 	int			dtxProtocolCommand = (int) pDtxProtocolParms->dtxProtocolCommand;
 	int			flags = pDtxProtocolParms->flags;
@@ -283,14 +283,7 @@ buildGpDtxProtocolCommand(struct CdbDispatcherState *ds,
 	char	   *shared_query = NULL;
 	char	   *pos = NULL;
 
-	if (ds->dispatchStateContext == NULL)
-		ds->dispatchStateContext = AllocSetContextCreate(TopMemoryContext,
-														 "Dispatch Context",
-														 ALLOCSET_DEFAULT_MINSIZE,
-														 ALLOCSET_DEFAULT_INITSIZE,
-														 ALLOCSET_DEFAULT_MAXSIZE);
-
-	shared_query = MemoryContextAlloc(ds->dispatchStateContext, total_query_len);
+	shared_query = palloc(total_query_len);
 	pos = shared_query;
 
 	*pos++ = 'T';
@@ -346,3 +339,185 @@ buildGpDtxProtocolCommand(struct CdbDispatcherState *ds,
 
 	return shared_query;
 }
+
+/*
+ * Build a dtx protocol command string to be dispatched to QE, allocated in
+ * the dispatcher state's memory context.
+ */
+static char *
+buildGpDtxProtocolCommand(struct CdbDispatcherState *ds,
+						  DispatchCommandDtxProtocolParms *pDtxProtocolParms,
+						  int *finalLen)
+{
+	MemoryContext oldContext;
+	char	   *shared_query;
+
+	if (ds->dispatchStateContext == NULL)
+		ds->dispatchStateContext = AllocSetContextCreate(TopMemoryContext,
+														 "Dispatch Context",
+														 ALLOCSET_DEFAULT_MINSIZE,
+														 ALLOCSET_DEFAULT_INITSIZE,
+														 ALLOCSET_DEFAULT_MAXSIZE);
+
+	oldContext = MemoryContextSwitchTo(ds->dispatchStateContext);
+	shared_query = formatGpDtxProtocolCommand(pDtxProtocolParms, finalLen);
+	MemoryContextSwitchTo(oldContext);
+
+	return shared_query;
+}
+
+/*
+ * CdbDispatchDtxProtocolCommandPipelined:
+ *
+ * Send the same DTX protocol command for several gids to every segment db,
+ * pipelined: all of the messages are queued on each connection before any
+ * response is read, so resolving n transactions costs one network round
+ * trip instead of n.  The responses are matched in send order and each is
+ * validated the same way doDispatchDtxProtocolCommand() validates a single
+ * command's results.
+ *
+ * Used by DTM recovery to resolve in-doubt transactions in bulk; the
+ * commands must be independent of each other (no command may depend on an
+ * earlier one's outcome).
+ *
+ * Returns true iff every command succeeded on every segment.
+ */
+bool
+CdbDispatchDtxProtocolCommandPipelined(DtxProtocolCommand dtxProtocolCommand,
+									   char *dtxProtocolCommandLoggingStr,
+									   char **gids,
+									   int ngids)
+{
+	Gang	   *primaryGang;
+	char	  **queryText;
+	int		   *queryTextLen;
+	int		   *nsent;
+	bool		succeeded = true;
+	int			i,
+				k;
+
+	if (ngids == 0)
+		return true;
+
+	/*
+	 * Allocate a primary QE for every available segDB in the system.
+	 */
+	primaryGang = AllocateWriterGang();
+
+	Assert(primaryGang);
+
+	if (primaryGang->dispatcherActive)
+	{
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("query plan with multiple segworker groups is not supported"),
+				 errhint("dispatching DTX commands to a busy gang")));
+	}
+
+	/*
+	 * Format one message per gid.
+	 */
+	queryText = palloc(ngids * sizeof(char *));
+	queryTextLen = palloc(ngids * sizeof(int));
+
+	for (k = 0; k < ngids; k++)
+	{
+		DispatchCommandDtxProtocolParms dtxProtocolParms;
+
+		MemSet(&dtxProtocolParms, 0, sizeof(dtxProtocolParms));
+		dtxProtocolParms.dtxProtocolCommand = dtxProtocolCommand;
+		dtxProtocolParms.dtxProtocolCommandLoggingStr = dtxProtocolCommandLoggingStr;
+		if (strlen(gids[k]) >= TMGIDSIZE)
+			elog(PANIC, "Distribute transaction identifier too long (%d)",
+				 (int) strlen(gids[k]));
+		memcpy(dtxProtocolParms.gid, gids[k], TMGIDSIZE);
+		dtxProtocolParms.gxid = InvalidDistributedTransactionId;
+
+		queryText[k] = formatGpDtxProtocolCommand(&dtxProtocolParms, &queryTextLen[k]);
+	}
+
+	/*
+	 * Queue every message on every connection before reading any response.
+	 * Remember how many messages made it onto each connection so we only
+	 * wait for responses that will actually arrive.
+	 */
+	nsent = palloc0(primaryGang->size * sizeof(int));
+
+	for (i = 0; i < primaryGang->size; i++)
+	{
+		PGconn	   *conn = primaryGang->db_descriptors[i].conn;
+
+		for (k = 0; k < ngids; k++)
+		{
+			if (!PQsendGpDtxProtocolPipelined(conn, queryText[k], queryTextLen[k]))
+			{
+				elog(LOG, "CdbDispatchDtxProtocolCommandPipelined: send of %s for gid = %s failed on seg%d: %s",
+					 dtxProtocolCommandLoggingStr, gids[k],
+					 primaryGang->db_descriptors[i].segindex,
+					 PQerrorMessage(conn));
+				succeeded = false;
+				break;
+			}
+			nsent[i]++;
+		}
+	}
+
+	/*
+	 * Collect and validate the responses, in send order.  Even after a
+	 * failure we keep draining so the connections are left in a usable
+	 * state where possible.
+	 */
+	for (i = 0; i < primaryGang->size; i++)
+	{
+		PGconn	   *conn = primaryGang->db_descriptors[i].conn;
+
+		for (k = 0; k < nsent[i]; k++)
+		{
+			PGresult   *res;
+			bool		sawSuccess = false;
+
+			if (k > 0)
+				PQgpRearmForPipelinedResult(conn);
+
+			while ((res = PQgetResult(conn)) != NULL)
+			{
+				ExecStatusType resultStatus = PQresultStatus(res);
+
+				if (resultStatus == PGRES_COMMAND_OK ||
+					resultStatus == PGRES_TUPLES_OK)
+				{
+					char	   *cmdStatus = PQcmdStatus(res);
+
+					if (strncmp(cmdStatus, dtxProtocolCommandLoggingStr,
+								strlen(cmdStatus)) == 0)
+						sawSuccess = true;
+					else
+						succeeded = false;
+				}
+				else
+					succeeded = false;
+
+				PQclear(res);
+			}
+
+			if (!sawSuccess)
+			{
+				elog(LOG, "CdbDispatchDtxProtocolCommandPipelined: %s for gid = %s failed on seg%d",
+					 dtxProtocolCommandLoggingStr, gids[k],
+					 primaryGang->db_descriptors[i].segindex);
+				succeeded = false;
+			}
+
+			if (PQstatus(conn) == CONNECTION_BAD)
+				break;
+		}
+	}
+
+	for (k = 0; k < ngids; k++)
+		pfree(queryText[k]);
+	pfree(queryText);
+	pfree(queryTextLen);
+	pfree(nsent);
+
+	return succeeded;
+}
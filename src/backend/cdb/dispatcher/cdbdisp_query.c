@@ -16,9 +16,11 @@
 
 #include "postgres.h"
 
+#include "access/hash.h"
 #include "access/xact.h"
 #include "libpq-fe.h"
 #include "libpq-int.h"
+#include "portability/instr_time.h"
 #include "cdb/cdbconn.h"
 #include "cdb/cdbgang.h"
 #include "cdb/cdbutil.h"
@@ -44,6 +46,7 @@
 								 * DispatchCommandParms */
 #include "cdb/cdbdisp_dtx.h"	/* for qdSerializeDtxContextInfo() */
 #include "cdb/cdbdispatchresult.h"
+#include "cdb/cdbdispatchstats.h"
 
 extern bool Test_print_direct_dispatch_info;
 
@@ -102,15 +105,63 @@ typedef struct DispatchCommandQueryParms
 	/* the map from sliceIndex to gang_id, in array form */
 	int			numSlices;
 	int		   *sliceIndexGangIdMap;
+
+	/*
+	 * True if every dispatched slice goes to the whole primary writer gang;
+	 * only such plans are eligible for cached plan dispatch.
+	 */
+	bool		writerGangOnly;
 } DispatchCommandQueryParms;
 
+/*
+ * State of the cached plan dispatch protocol (see buildGpQueryString).
+ *
+ * This is the QD's mirror of the serialized plans that the QEs of the
+ * current writer gang hold in their caches: a FIFO ring evicted in the same
+ * order and with the same capacity as on the QE side, so that both ends
+ * always agree on the cache contents.  Each entry keeps its own copy of the
+ * serialized plan bytes: the 32-bit hash alone cannot establish plan
+ * identity, and on a hash collision a USE dispatch would make the QEs
+ * silently run the wrong plan.  A cache hit therefore requires the stored
+ * bytes to compare equal to the new plan; the memory cost is bounded by the
+ * ring size.  A plan is recorded here only after its dispatch has been
+ * handed to the connections (see cdbdisp_confirmCachedPlanDispatch), and
+ * the whole ring is reset when the writer gang goes away.
+ */
+typedef struct
+{
+	uint32		hash;			/* hash of the serialized plan tree */
+	int			len;			/* its length */
+	char	   *plan;			/* the plan bytes, in TopMemoryContext */
+} CachedPlanDispatchEntry;
+
+/* result of probing the mirror for a plan (see cdbdisp_planCacheLookup) */
+typedef enum
+{
+	PLAN_CACHE_MISS,			/* not cached; safe to STORE */
+	PLAN_CACHE_HIT,				/* cached, bytes verified; safe to USE */
+	PLAN_CACHE_CONFLICT			/* a different plan owns this (hash, len) */
+} CachedPlanLookupResult;
+
+static CachedPlanDispatchEntry cachedPlanDispatchRing[CACHED_PLAN_DISPATCH_SLOTS];
+static int	cachedPlanDispatchCount = 0;
+static int	cachedPlanDispatchNext = 0;
+
+/* STORE dispatch built but not yet handed to the connections */
+static bool pendingCachedPlanValid = false;
+static CachedPlanDispatchEntry pendingCachedPlan;
+
+bool		gp_cached_plan_dispatch = false;
+
 static void cdbdisp_dispatchCommandInternal(const char *strCommand,
 								char *serializedQuerytree,
 								int serializedQuerytreelen,
 								char *serializedQueryDispatchDesc,
 								int serializedQueryDispatchDesclen,
 								int flags,
-								CdbPgResults *cdb_pgresults);
+								CdbPgResults *cdb_pgresults,
+								CdbDispatchResultConsumer consumer,
+								void *consumerContext);
 
 static void cdbdisp_dispatchSetCommandToAllGangs(const char *strCommand,
 									 char *serializedQuerytree,
@@ -143,6 +194,11 @@ static int *buildSliceIndexGangIdMap(SliceVec *sliceVec, int numSlices, int numT
 
 static char *serializeParamListInfo(ParamListInfo paramLI, int *len_p);
 
+static CachedPlanLookupResult cdbdisp_planCacheLookup(uint32 hash, int len,
+						  const char *plan);
+static void cdbdisp_confirmCachedPlanDispatch(void);
+static void cdbdisp_discardPendingCachedPlan(void);
+
 /*
  * Compose and dispatch the MPPEXEC commands corresponding to a plan tree
  * within a complete parallel plan. (A plan tree will correspond either
@@ -350,7 +406,36 @@ CdbDispatchCommand(const char *strCommand,
 										   NULL,
 										   0,
 										   flags,
-										   cdb_pgresults);
+										   cdb_pgresults,
+										   NULL,
+										   NULL);
+}
+
+/*
+ * CdbDispatchCommandConsume:
+ *
+ * Like CdbDispatchCommand(), but instead of materializing every QE's
+ * PGresults in a CdbPgResults array for the caller to walk and free,
+ * hands each PGresult to 'consumer' as the results are drained and
+ * frees it as soon as the callback returns.  Use this when the command
+ * can return a lot of data per QE and the caller only needs one pass
+ * over the results.
+ */
+void
+CdbDispatchCommandConsume(const char *strCommand,
+						  int flags,
+						  CdbDispatchResultConsumer consumer,
+						  void *context)
+{
+	return cdbdisp_dispatchCommandInternal(strCommand,
+										   NULL,
+										   0,
+										   NULL,
+										   0,
+										   flags,
+										   NULL,
+										   consumer,
+										   context);
 }
 
 /*
@@ -423,7 +508,8 @@ CdbDispatchUtilityStatement(struct Node *stmt,
 	return cdbdisp_dispatchCommandInternal(debug_query_string,
 										   serializedQuerytree, serializedQuerytree_len,
 										   serializedQueryDispatchDesc, serializedQueryDispatchDesc_len,
-										   flags, cdb_pgresults);
+										   flags, cdb_pgresults,
+										   NULL, NULL);
 }
 
 /*
@@ -439,7 +525,9 @@ cdbdisp_dispatchCommandInternal(const char *strCommand,
 								char *serializedQueryDispatchDesc,
 								int serializedQueryDispatchDesclen,
 								int flags,
-								CdbPgResults *cdb_pgresults)
+								CdbPgResults *cdb_pgresults,
+								CdbDispatchResultConsumer consumer,
+								void *consumerContext)
 {
 	struct CdbDispatcherState ds = {NULL, NULL, NULL};
 	CdbDispatchResults *dispatchresults = NULL;
@@ -538,7 +626,11 @@ cdbdisp_dispatchCommandInternal(const char *strCommand,
 						 errdetail("Command: \"%s\"", strCommand)));
 		}
 
-		if (cdb_pgresults)
+		if (consumer)
+		{
+			cdbdisp_consumeResults(dispatchresults, consumer, consumerContext);
+		}
+		else if (cdb_pgresults)
 		{
 			cdbdisp_returnResults(dispatchresults, cdb_pgresults);
 		}
@@ -583,6 +675,11 @@ cdbdisp_buildPlanQueryParms(struct QueryDesc *queryDesc,
 
 	DispatchCommandQueryParms *pQueryParms = (DispatchCommandQueryParms *) palloc0(sizeof(*pQueryParms));
 
+	instr_time	serializeStart;
+	instr_time	serializeEnd;
+
+	INSTR_TIME_SET_CURRENT(serializeStart);
+
 	/*
 	 * serialized plan tree. Note that we're called for a single slice tree
 	 * (corresponding to an initPlan or the main plan), so the parameters are
@@ -590,6 +687,11 @@ cdbdisp_buildPlanQueryParms(struct QueryDesc *queryDesc,
 	 */
 	splan = serializeNode((Node *) queryDesc->plannedstmt, &splan_len, &splan_len_uncompressed);
 
+	INSTR_TIME_SET_CURRENT(serializeEnd);
+	INSTR_TIME_SUBTRACT(serializeEnd, serializeStart);
+	cdbdisp_stats_addSample(GP_DISPATCH_PHASE_SERIALIZE,
+							INSTR_TIME_GET_MICROSEC(serializeEnd));
+
 	uint64		plan_size_in_kb = ((uint64) splan_len_uncompressed) / (uint64) 1024;
 
 	elog(((gp_log_gang >= GPVARS_VERBOSITY_TERSE) ? LOG : DEBUG1),
@@ -881,6 +983,92 @@ fillSliceVector(SliceTable *sliceTbl, int rootIdx,
 	return top_count;
 }
 
+/*
+ * Probe the mirror for a plan about to be dispatched.
+ *
+ * The hash and length are only a cheap filter; identity is established by
+ * comparing the stored plan bytes, since the QE side looks plans up by
+ * (hash, length) alone and a USE dispatch based on a colliding hash would
+ * make the QEs silently execute the wrong plan.  If the key matches but
+ * the bytes differ, the caller must not STORE the new plan either: doing
+ * so would put two plans under the same key in the QE rings and make a
+ * later USE ambiguous there.  We report that case as PLAN_CACHE_CONFLICT
+ * so the plan is simply dispatched in full, uncached.  The invariant that
+ * at most one mirrored entry owns a given (hash, length) lets us decide on
+ * the first key match.
+ */
+static CachedPlanLookupResult
+cdbdisp_planCacheLookup(uint32 hash, int len, const char *plan)
+{
+	int			i;
+
+	for (i = 0; i < cachedPlanDispatchCount; i++)
+	{
+		if (cachedPlanDispatchRing[i].hash == hash &&
+			cachedPlanDispatchRing[i].len == len)
+		{
+			if (memcmp(cachedPlanDispatchRing[i].plan, plan, len) == 0)
+				return PLAN_CACHE_HIT;
+			return PLAN_CACHE_CONFLICT;
+		}
+	}
+	return PLAN_CACHE_MISS;
+}
+
+/*
+ * The STORE dispatch prepared by buildGpQueryString has been handed to the
+ * gang's connections, so the QEs will cache the plan; record it in our
+ * mirror.  Not recording until this point keeps the mirror honest if the
+ * dispatch is abandoned before any send (e.g. on a pending cancel).
+ */
+static void
+cdbdisp_confirmCachedPlanDispatch(void)
+{
+	if (!pendingCachedPlanValid)
+		return;
+
+	/* the ring evicts in FIFO order; free the plan copy being replaced */
+	if (cachedPlanDispatchCount == CACHED_PLAN_DISPATCH_SLOTS)
+		pfree(cachedPlanDispatchRing[cachedPlanDispatchNext].plan);
+
+	cachedPlanDispatchRing[cachedPlanDispatchNext] = pendingCachedPlan;
+	cachedPlanDispatchNext = (cachedPlanDispatchNext + 1) % CACHED_PLAN_DISPATCH_SLOTS;
+	if (cachedPlanDispatchCount < CACHED_PLAN_DISPATCH_SLOTS)
+		cachedPlanDispatchCount++;
+	pendingCachedPlanValid = false;
+	pendingCachedPlan.plan = NULL;
+}
+
+/*
+ * Drop a STORE entry that was prepared by buildGpQueryString but whose
+ * dispatch was never handed to the connections.
+ */
+static void
+cdbdisp_discardPendingCachedPlan(void)
+{
+	if (pendingCachedPlanValid && pendingCachedPlan.plan != NULL)
+		pfree(pendingCachedPlan.plan);
+	pendingCachedPlanValid = false;
+	pendingCachedPlan.plan = NULL;
+}
+
+/*
+ * Forget which plans the writer gang QEs have cached. Called whenever the
+ * writer gang is destroyed or created anew, since fresh QE processes start
+ * with empty caches.
+ */
+void
+cdbdisp_invalidateCachedPlans(void)
+{
+	int			i;
+
+	for (i = 0; i < cachedPlanDispatchCount; i++)
+		pfree(cachedPlanDispatchRing[i].plan);
+	cachedPlanDispatchCount = 0;
+	cachedPlanDispatchNext = 0;
+	cdbdisp_discardPendingCachedPlan();
+}
+
 /*
  * Build a query string to be dispatched to QE.
  */
@@ -895,13 +1083,15 @@ buildGpQueryString(struct CdbDispatcherState *ds,
 	int			querytree_len = pQueryParms->serializedQuerytreelen;
 	const char *plantree = pQueryParms->serializedPlantree;
 	int			plantree_len = pQueryParms->serializedPlantreelen;
+	uint32		planHash = 0;
+	int			planCacheLen = 0;
 	const char *params = pQueryParms->serializedParams;
 	int			params_len = pQueryParms->serializedParamslen;
 	const char *sddesc = pQueryParms->serializedQueryDispatchDesc;
 	int			sddesc_len = pQueryParms->serializedQueryDispatchDesclen;
 	const char *dtxContextInfo = pQueryParms->serializedDtxContextInfo;
 	int			dtxContextInfo_len = pQueryParms->serializedDtxContextInfolen;
-	int			flags = 0;		/* unused flags */
+	int			flags = 0;		/* MPP_QUERY_FLAG_XXX bits */
 	int			rootIdx = pQueryParms->rootIdx;
 	const char *seqServerHost = pQueryParms->seqServerHost;
 	int			seqServerHostlen = pQueryParms->seqServerHostlen;
@@ -925,11 +1115,56 @@ buildGpQueryString(struct CdbDispatcherState *ds,
 			   *pos;
 	char		one = 1;
 	char		zero = 0;
+	instr_time	starttime;
+	instr_time	endtime;
+
+	INSTR_TIME_SET_CURRENT(starttime);
 
 	initStringInfo(&resgroupInfo);
 	if (IsResGroupActivated())
 		SerializeResGroupInfo(&resgroupInfo);
 
+	/*
+	 * Cached plan dispatch: for plans whose every slice runs on the whole
+	 * writer gang, have the QEs cache the serialized plan tree under its
+	 * hash, and on later executions of the same plan send only the hash
+	 * (plus the params, which change per execution) instead of the whole
+	 * plan.  This shrinks the per-execute message for prepared statements
+	 * from the size of the plan to a few bytes.
+	 */
+	cdbdisp_discardPendingCachedPlan();
+	if (gp_cached_plan_dispatch &&
+		pQueryParms->writerGangOnly &&
+		plantree_len > 0)
+	{
+		planHash = DatumGetUInt32(hash_any((const unsigned char *) plantree,
+										   plantree_len));
+		planCacheLen = plantree_len;
+
+		switch (cdbdisp_planCacheLookup(planHash, planCacheLen, plantree))
+		{
+			case PLAN_CACHE_HIT:
+				flags |= MPP_QUERY_FLAG_PLAN_CACHE_USE;
+				plantree = NULL;
+				plantree_len = 0;
+				break;
+
+			case PLAN_CACHE_MISS:
+				flags |= MPP_QUERY_FLAG_PLAN_CACHE_STORE;
+				pendingCachedPlan.hash = planHash;
+				pendingCachedPlan.len = planCacheLen;
+				pendingCachedPlan.plan = MemoryContextAlloc(TopMemoryContext,
+															planCacheLen);
+				memcpy(pendingCachedPlan.plan, plantree, planCacheLen);
+				pendingCachedPlanValid = true;
+				break;
+
+			case PLAN_CACHE_CONFLICT:
+				/* hash collision; dispatch the plan in full, uncached */
+				break;
+		}
+	}
+
 	total_query_len = 1 /* 'M' */ +
 		sizeof(len) /* message length */ +
 		sizeof(gp_command_count) +
@@ -946,6 +1181,8 @@ buildGpQueryString(struct CdbDispatcherState *ds,
 		sizeof(dtxContextInfo_len) +
 		dtxContextInfo_len +
 		sizeof(flags) +
+		sizeof(planHash) +
+		sizeof(planCacheLen) +
 		sizeof(seqServerHostlen) +
 		sizeof(seqServerPort) +
 		command_len +
@@ -1055,6 +1292,14 @@ buildGpQueryString(struct CdbDispatcherState *ds,
 	memcpy(pos, &tmp, sizeof(tmp));
 	pos += sizeof(tmp);
 
+	n32 = htonl(planHash);
+	memcpy(pos, &n32, sizeof(n32));
+	pos += sizeof(n32);
+
+	tmp = htonl(planCacheLen);
+	memcpy(pos, &tmp, sizeof(tmp));
+	pos += sizeof(tmp);
+
 	tmp = htonl(seqServerHostlen);
 	memcpy(pos, &tmp, sizeof(tmp));
 	pos += sizeof(tmp);
@@ -1133,6 +1378,11 @@ buildGpQueryString(struct CdbDispatcherState *ds,
 	if (finalLen)
 		*finalLen = len + 1;
 
+	INSTR_TIME_SET_CURRENT(endtime);
+	INSTR_TIME_SUBTRACT(endtime, starttime);
+	cdbdisp_stats_addSample(GP_DISPATCH_PHASE_SERIALIZE,
+							INSTR_TIME_GET_MICROSEC(endtime));
+
 	return shared_query;
 }
 
@@ -1174,12 +1424,62 @@ cdbdisp_dispatchX(DispatchCommandQueryParms *pQueryParms,
 	pQueryParms->numSlices = nTotalSlices;
 	pQueryParms->sliceIndexGangIdMap = buildSliceIndexGangIdMap(sliceVector, nSlices, nTotalSlices);
 
+	/*
+	 * A plan is eligible for cached plan dispatch only if every dispatched
+	 * slice goes to the whole primary writer gang: the writer gang is the
+	 * only gang whose QEs are stable across executions, and direct dispatch
+	 * would leave some of its QEs without the plan.
+	 */
+	pQueryParms->writerGangOnly = true;
+	for (iSlice = 0; iSlice < nSlices; iSlice++)
+	{
+		Slice	   *slice = sliceVector[iSlice].slice;
+
+		if (slice == NULL || slice->gangType == GANGTYPE_UNALLOCATED)
+			continue;
+
+		if (slice->primaryGang == NULL ||
+			slice->primaryGang->type != GANGTYPE_PRIMARY_WRITER ||
+			slice->directDispatch.isDirectDispatch)
+		{
+			pQueryParms->writerGangOnly = false;
+			break;
+		}
+	}
+
 	/*
 	 * Allocate result array with enough slots for QEs of primary gangs.
 	 */
 	ds->primaryResults = NULL;
 	ds->dispatchParams = NULL;
 	queryText = buildGpQueryString(ds, pQueryParms, &queryTextLength);
+
+	/*
+	 * The dispatch buffer now holds the only image every connection will
+	 * send (each QE connection's outBuffer is pointed at it, see
+	 * PQsendGpQuery_shared()), so the serialized node trees are dead weight.
+	 * Release them before the sends start instead of keeping two copies of
+	 * a multi-megabyte plan alive for the whole dispatch.
+	 */
+	if (pQueryParms->serializedPlantree != NULL)
+	{
+		pfree(pQueryParms->serializedPlantree);
+		pQueryParms->serializedPlantree = NULL;
+		pQueryParms->serializedPlantreelen = 0;
+	}
+	if (pQueryParms->serializedParams != NULL)
+	{
+		pfree(pQueryParms->serializedParams);
+		pQueryParms->serializedParams = NULL;
+		pQueryParms->serializedParamslen = 0;
+	}
+	if (pQueryParms->serializedQueryDispatchDesc != NULL)
+	{
+		pfree(pQueryParms->serializedQueryDispatchDesc);
+		pQueryParms->serializedQueryDispatchDesc = NULL;
+		pQueryParms->serializedQueryDispatchDesclen = 0;
+	}
+
 	cdbdisp_makeDispatcherState(ds, nTotalSlices, cancelOnError, queryText, queryTextLength);
 
 	cdb_total_plans++;
@@ -1204,7 +1504,7 @@ cdbdisp_dispatchX(DispatchCommandQueryParms *pQueryParms,
 
 	for (iSlice = 0; iSlice < nSlices; iSlice++)
 	{
-		CdbDispatchDirectDesc direct;
+		CdbDispatchDirectDesc *direct;
 		Gang	   *primaryGang = NULL;
 		Slice	   *slice = NULL;
 		int			si = -1;
@@ -1233,26 +1533,35 @@ cdbdisp_dispatchX(DispatchCommandQueryParms *pQueryParms,
 
 		if (slice->directDispatch.isDirectDispatch)
 		{
-			direct.directed_dispatch = true;
-			Assert(list_length(slice->directDispatch.contentIds) == 1);
-			direct.count = 1;
+			ListCell   *cell;
+			int			ncontents = list_length(slice->directDispatch.contentIds);
+			int			j = 0;
+
+			Assert(ncontents >= 1);
 
 			/*
-			 * We only support single content right now. If this changes then
-			 * we need to change from a list to another structure to avoid n^2
-			 * cases
+			 * The descriptor's content array is variable length, sized by
+			 * the number of target segments.
 			 */
-			direct.content[0] = linitial_int(slice->directDispatch.contentIds);
+			direct = palloc(offsetof(CdbDispatchDirectDesc, content) +
+							ncontents * sizeof(uint16));
+			direct->directed_dispatch = true;
+			direct->count = ncontents;
+
+			foreach(cell, slice->directDispatch.contentIds)
+				direct->content[j++] = lfirst_int(cell);
 
 			if (Test_print_direct_dispatch_info)
 			{
-				elog(INFO, "Dispatch command to SINGLE content");
+				if (ncontents == 1)
+					elog(INFO, "Dispatch command to SINGLE content");
+				else
+					elog(INFO, "Dispatch command to %d contents", ncontents);
 			}
 		}
 		else
 		{
-			direct.directed_dispatch = false;
-			direct.count = 0;
+			direct = DEFAULT_DISP_DIRECT;
 
 			if (Test_print_direct_dispatch_info)
 			{
@@ -1274,7 +1583,13 @@ cdbdisp_dispatchX(DispatchCommandQueryParms *pQueryParms,
 		if (primaryGang->type == GANGTYPE_PRIMARY_WRITER)
 			ds->primaryResults->writer_gang = primaryGang;
 
-		cdbdisp_dispatchToGang(ds, primaryGang, si, &direct);
+		cdbdisp_dispatchToGang(ds, primaryGang, si, direct);
+
+		/*
+		 * The message carrying a plan to be cached has been handed to the
+		 * gang's connections; record it in the QD-side mirror.
+		 */
+		cdbdisp_confirmCachedPlanDispatch();
 
 		SIMPLE_FAULT_INJECTOR(AfterOneSliceDispatched);
 	}
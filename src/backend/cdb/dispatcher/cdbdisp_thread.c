@@ -204,9 +204,16 @@ cdbdisp_initDispatchParmsForGang(struct CdbDispatcherState *ds,
 
 		if (disp_direct->directed_dispatch)
 		{
-			/* currently we allow direct-to-one dispatch, only */
-			Assert(disp_direct->count == 1);
-			if (disp_direct->content[0] != segdbDesc->segindex)
+			/* skip segments that are not in the target set */
+			int			j;
+
+			Assert(disp_direct->count >= 1);
+			for (j = 0; j < disp_direct->count; j++)
+			{
+				if (disp_direct->content[j] == segdbDesc->segindex)
+					break;
+			}
+			if (j == disp_direct->count)
 				continue;
 		}
 
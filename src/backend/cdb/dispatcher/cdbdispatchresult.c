@@ -874,6 +874,59 @@ cdbdisp_returnResults(CdbDispatchResults *primaryResults, CdbPgResults *cdb_pgre
 
 }
 
+/*
+ * Incremental counterpart of cdbdisp_returnResults(): walk the results one
+ * QE at a time, hand each PGresult to the caller's consumer callback and
+ * PQclear() it as soon as the callback returns.  Only one QE's worth of
+ * PGresult ptrs is ever materialized, so the consumption-side footprint is
+ * O(one QE) instead of O(total results).
+ *
+ * If the consumer throws, any results it has not yet seen are still owned
+ * by this QE's snatch array and are leaked, just as they would be by a
+ * caller of cdbdisp_returnResults() erroring out before
+ * cdbdisp_clearCdbPgResults(); consumers that may reject a result should
+ * do so on the first PGresult they see.
+ */
+void
+cdbdisp_consumeResults(CdbDispatchResults *primaryResults,
+					   CdbDispatchResultConsumer consumer,
+					   void *context)
+{
+	CdbDispatchResult *dispatchResult;
+	struct pg_result **snatch;
+	int			nresults;
+	int			i;
+	int			r;
+
+	if (!primaryResults || !consumer)
+		return;
+
+	for (i = 0; i < primaryResults->resultCount; ++i)
+	{
+		dispatchResult = &primaryResults->resultArray[i];
+
+		nresults = cdbdisp_numPGresult(dispatchResult);
+		if (nresults == 0)
+			continue;
+
+		/*
+		 * Take ownership of this QE's PGresult object(s), then hand them
+		 * over one by one and free each as soon as it has been consumed.
+		 */
+		snatch = palloc(nresults * sizeof(struct pg_result *));
+		nresults = cdbdisp_snatchPGresults(dispatchResult, snatch, nresults);
+
+		for (r = 0; r < nresults; ++r)
+		{
+			consumer(snatch[r], dispatchResult->segdbDesc, context);
+			PQclear(snatch[r]);
+			snatch[r] = NULL;
+		}
+
+		pfree(snatch);
+	}
+}
+
 /*
  * used in the interconnect on the dispatcher to avoid error-cleanup deadlocks.
  */
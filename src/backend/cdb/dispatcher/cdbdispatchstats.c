@@ -0,0 +1,301 @@
+/*-------------------------------------------------------------------------
+ *
+ * cdbdispatchstats.c
+ *	  Per-backend dispatch latency statistics.
+ *
+ * We cannot tell from the logs whether a slow statement start was spent
+ * serializing the plan, writing it to the gang's sockets, or waiting for
+ * acknowledgements from straggling segments.  This module keeps a small
+ * per-backend slot in shared memory where the dispatcher accumulates
+ * per-phase latency totals and histograms, and exposes them through the
+ * set-returning function backing the gp_dispatch_stats view.
+ *
+ * The owning backend is the only writer of its slot, so no locking is
+ * done; the view may see a slot mid-update, which is acceptable for
+ * monitoring data.
+ *
+ * Portions Copyright (c) 2012-Present Pivotal Software, Inc.
+ *
+ * IDENTIFICATION
+ *	    src/backend/cdb/dispatcher/cdbdispatchstats.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "funcapi.h"
+#include "miscadmin.h"
+#include "catalog/pg_type.h"
+#include "storage/backendid.h"
+#include "storage/shmem.h"
+#include "utils/builtins.h"
+#include "cdb/cdbdispatchstats.h"
+#include "cdb/cdbvars.h"
+
+static GpDispatchStatsEntry *dispatchStatsEntries = NULL;
+
+static const char *const phaseNames[GP_DISPATCH_PHASE_COUNT] =
+{
+	"serialize",
+	"enqueue",
+	"first_result",
+	"ack"
+};
+
+Datum		gp_dispatch_stats__(PG_FUNCTION_ARGS);
+
+PG_FUNCTION_INFO_V1(gp_dispatch_stats__);
+
+Size
+DispatchStatsShmemSize(void)
+{
+	return mul_size(MaxBackends, sizeof(GpDispatchStatsEntry));
+}
+
+void
+DispatchStatsShmemInit(void)
+{
+	bool		found;
+
+	dispatchStatsEntries = (GpDispatchStatsEntry *)
+		ShmemInitStruct("Dispatch Stats", DispatchStatsShmemSize(), &found);
+
+	if (!found)
+		MemSet(dispatchStatsEntries, 0, DispatchStatsShmemSize());
+}
+
+/*
+ * Return this backend's slot, resetting it if it still holds data from a
+ * previous session that had the same BackendId.  Returns NULL when stats
+ * cannot be recorded (not a QD, or shmem not initialized).
+ */
+static GpDispatchStatsEntry *
+myStatsEntry(void)
+{
+	GpDispatchStatsEntry *entry;
+
+	if (Gp_role != GP_ROLE_DISPATCH ||
+		dispatchStatsEntries == NULL ||
+		MyBackendId == InvalidBackendId)
+		return NULL;
+
+	entry = &dispatchStatsEntries[MyBackendId - 1];
+
+	if (entry->sessionId != gp_session_id)
+	{
+		MemSet(entry, 0, sizeof(GpDispatchStatsEntry));
+		entry->sessionId = gp_session_id;
+		entry->stragglerContent = -1;
+	}
+
+	return entry;
+}
+
+/*
+ * Map a latency in microseconds to its histogram bucket: bucket 0 is
+ * < 256us, and each further bucket covers 4x the previous one.
+ */
+static int
+bucketForLatency(uint64 us)
+{
+	int			bucket = 0;
+
+	us >>= 8;
+	while (us > 0 && bucket < GP_DISPATCH_STATS_NBUCKETS - 1)
+	{
+		us >>= 2;
+		bucket++;
+	}
+
+	return bucket;
+}
+
+/*
+ * Count one gang dispatch by this backend.
+ */
+void
+cdbdisp_stats_countDispatch(void)
+{
+	GpDispatchStatsEntry *entry = myStatsEntry();
+
+	if (entry == NULL)
+		return;
+
+	entry->nDispatches++;
+}
+
+/*
+ * Accumulate one latency sample for the given phase.
+ */
+void
+cdbdisp_stats_addSample(GpDispatchStatsPhase phase, uint64 us)
+{
+	GpDispatchStatsEntry *entry = myStatsEntry();
+	GpDispatchPhaseStats *stats;
+
+	if (entry == NULL)
+		return;
+
+	Assert(phase >= 0 && phase < GP_DISPATCH_PHASE_COUNT);
+
+	stats = &entry->phases[phase];
+	stats->samples++;
+	stats->total_us += us;
+	if (us > stats->max_us)
+		stats->max_us = us;
+	stats->hist[bucketForLatency(us)]++;
+}
+
+/*
+ * Accumulate the completion latency of one QE, remembering the slowest
+ * content seen so far so stragglers can be identified by segment.
+ */
+void
+cdbdisp_stats_addAck(int contentId, uint64 us)
+{
+	GpDispatchStatsEntry *entry = myStatsEntry();
+
+	if (entry == NULL)
+		return;
+
+	cdbdisp_stats_addSample(GP_DISPATCH_PHASE_ACK, us);
+
+	if (us > entry->stragglerUs)
+	{
+		entry->stragglerUs = us;
+		entry->stragglerContent = contentId;
+	}
+}
+
+/*
+ * gp_dispatch_stats__ - produce the contents of the gp_dispatch_stats view:
+ * one row per (session, dispatch phase).
+ */
+Datum
+gp_dispatch_stats__(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+	GpDispatchStatsEntry *snapshot;
+	int			index;
+	int			nslots = MaxBackends;
+
+	if (SRF_IS_FIRSTCALL())
+	{
+		TupleDesc	tupdesc;
+		MemoryContext oldcontext;
+
+		funcctx = SRF_FIRSTCALL_INIT();
+
+		oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+		/* this had better match the gp_dispatch_stats view in cdb_schema.sql */
+		tupdesc = CreateTemplateTupleDesc(15, false);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 1, "gp_session_id",
+						   INT4OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 2, "phase",
+						   TEXTOID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 3, "dispatches",
+						   INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 4, "samples",
+						   INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 5, "total_us",
+						   INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 6, "max_us",
+						   INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 7, "straggler_content",
+						   INT4OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 8, "straggler_us",
+						   INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 9, "under_256us",
+						   INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 10, "under_1ms",
+						   INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 11, "under_4ms",
+						   INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 12, "under_16ms",
+						   INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 13, "under_64ms",
+						   INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 14, "under_256ms",
+						   INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 15, "over_256ms",
+						   INT8OID, -1, 0);
+
+		funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+
+		/*
+		 * Copy the whole array so each call iterates over a stable image;
+		 * the last two histogram buckets are folded together below to keep
+		 * the view at a readable width.
+		 */
+		snapshot = (GpDispatchStatsEntry *)
+			palloc(nslots * sizeof(GpDispatchStatsEntry));
+		if (dispatchStatsEntries != NULL)
+			memcpy(snapshot, dispatchStatsEntries,
+				   nslots * sizeof(GpDispatchStatsEntry));
+		else
+			MemSet(snapshot, 0, nslots * sizeof(GpDispatchStatsEntry));
+
+		funcctx->user_fctx = (void *) snapshot;
+		funcctx->call_cntr = 0;
+		funcctx->max_calls = nslots * GP_DISPATCH_PHASE_COUNT;
+
+		MemoryContextSwitchTo(oldcontext);
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+	snapshot = (GpDispatchStatsEntry *) funcctx->user_fctx;
+
+	for (index = funcctx->call_cntr; index < funcctx->max_calls; index++)
+	{
+		GpDispatchStatsEntry *entry = &snapshot[index / GP_DISPATCH_PHASE_COUNT];
+		int			phase = index % GP_DISPATCH_PHASE_COUNT;
+		GpDispatchPhaseStats *stats = &entry->phases[phase];
+
+		Datum		values[15];
+		bool		nulls[15];
+		HeapTuple	tuple;
+
+		if (entry->sessionId == 0)
+			continue;
+
+		MemSet(values, 0, sizeof(values));
+		MemSet(nulls, false, sizeof(nulls));
+
+		values[0] = Int32GetDatum(entry->sessionId);
+		values[1] = CStringGetTextDatum(phaseNames[phase]);
+		values[2] = Int64GetDatum((int64) entry->nDispatches);
+		values[3] = Int64GetDatum((int64) stats->samples);
+		values[4] = Int64GetDatum((int64) stats->total_us);
+		values[5] = Int64GetDatum((int64) stats->max_us);
+
+		if (phase == GP_DISPATCH_PHASE_ACK && entry->stragglerContent >= 0)
+		{
+			values[6] = Int32GetDatum(entry->stragglerContent);
+			values[7] = Int64GetDatum((int64) entry->stragglerUs);
+		}
+		else
+		{
+			nulls[6] = true;
+			nulls[7] = true;
+		}
+
+		values[8] = Int64GetDatum((int64) stats->hist[0]);
+		values[9] = Int64GetDatum((int64) stats->hist[1]);
+		values[10] = Int64GetDatum((int64) stats->hist[2]);
+		values[11] = Int64GetDatum((int64) stats->hist[3]);
+		values[12] = Int64GetDatum((int64) stats->hist[4]);
+		values[13] = Int64GetDatum((int64) stats->hist[5]);
+		values[14] = Int64GetDatum((int64) (stats->hist[6] + stats->hist[7]));
+
+		tuple = heap_form_tuple(funcctx->tuple_desc, values, nulls);
+
+		/* skip the entries consumed by this scan, including this one */
+		funcctx->call_cntr = index;
+
+		SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+	}
+
+	SRF_RETURN_DONE(funcctx);
+}
@@ -49,6 +49,7 @@
 #include "libpq/libpq-be.h"
 #include "libpq/ip.h"
 
+#include "utils/guc.h"
 #include "utils/guc_tables.h"
 
 #define MAX_CACHED_1_GANGS 1
@@ -264,6 +265,9 @@ AllocateWriterGang()
 								PRIMARY_WRITER_GANG_ID, nsegdb, -1);
 		writerGang->allocated = true;
 
+		/* fresh QEs have empty plan caches; forget our mirror of them */
+		cdbdisp_invalidateCachedPlans();
+
 		/*
 		 * set "whoami" for utility statement. non-utility statement will
 		 * overwrite it in function getCdbProcessList.
@@ -632,16 +636,31 @@ addOneOption(StringInfo string, struct config_generic *guc)
 
 /*
  * Add GUCs to option string.
+ *
+ * The option string is a pure function of the current GUC settings, so we
+ * cache it for the life of the session and rebuild it only when
+ * gp_guc_generation indicates that some setting may have changed.  Building
+ * it walks every GUC and used to be redone for every connection of every
+ * gang we create.
+ *
+ * The returned string lives in TopMemoryContext and remains owned by this
+ * module: callers must treat it as read-only and must not pfree it.
  */
 char *
 makeOptions(void)
 {
+	static char *cachedOptions = NULL;
+	static int	cachedGeneration = -1;
+
 	struct config_generic **gucs = get_guc_variables();
 	int			ngucs = get_num_guc_variables();
 	CdbComponentDatabaseInfo *qdinfo = NULL;
 	StringInfoData string;
 	int			i;
 
+	if (cachedOptions != NULL && cachedGeneration == gp_guc_generation)
+		return cachedOptions;
+
 	initStringInfo(&string);
 
 	Assert(Gp_role == GP_ROLE_DISPATCH);
@@ -686,7 +705,18 @@ makeOptions(void)
 			addOneOption(&string, guc);
 	}
 
-	return string.data;
+	/*
+	 * Stash a copy where it survives the (often short-lived) context we were
+	 * called in.  Gang creation is synchronous, so no connection can still be
+	 * reading the previous copy by the time we get here.
+	 */
+	if (cachedOptions != NULL)
+		pfree(cachedOptions);
+	cachedOptions = MemoryContextStrdup(TopMemoryContext, string.data);
+	cachedGeneration = gp_guc_generation;
+	pfree(string.data);
+
+	return cachedOptions;
 }
 
 /*
@@ -1040,15 +1070,25 @@ getCdbProcessList(Gang *gang, int sliceIndex, DirectDispatchInfo *directDispatch
 
 	if (directDispatch != NULL && directDispatch->isDirectDispatch)
 	{
-		/* Currently, direct dispatch is to one segment db. */
-		Assert(list_length(directDispatch->contentIds) == 1);
+		Assert(list_length(directDispatch->contentIds) >= 1);
+
+		/*
+		 * Walk the gang in segment index order so the process list comes out
+		 * ordered the same way as in the full-gang case.
+		 */
+		for (i = 0; i < gang->size; i++)
+		{
+			SegmentDatabaseDescriptor *segdbDesc = &gang->db_descriptors[i];
+			CdbProcess *process;
 
-		int			directDispatchContentId = linitial_int(directDispatch->contentIds);
-		SegmentDatabaseDescriptor *segdbDesc = &gang->db_descriptors[directDispatchContentId];
-		CdbProcess *process = makeCdbProcess(segdbDesc);
+			if (!list_member_int(directDispatch->contentIds, segdbDesc->segindex))
+				continue;
 
-		setQEIdentifier(segdbDesc, sliceIndex, gang->perGangContext);
-		list = lappend(list, (void*)process);
+			process = makeCdbProcess(segdbDesc);
+
+			setQEIdentifier(segdbDesc, sliceIndex, gang->perGangContext);
+			list = lappend(list, (void*)process);
+		}
 	}
 	else
 	{
@@ -1140,6 +1180,10 @@ DisconnectAndDestroyGang(Gang *gp)
 
 	AssertImply(gp->type == GANGTYPE_PRIMARY_WRITER, !readerGangsExist());
 
+	/* the writer QEs' plan caches die with their processes */
+	if (gp->type == GANGTYPE_PRIMARY_WRITER)
+		cdbdisp_invalidateCachedPlans();
+
 	ELOG_DISPATCHER_DEBUG("DisconnectAndDestroyGang entered: id = %d", gp->gang_id);
 
 	if (gp->allocated)
@@ -65,6 +65,11 @@ createGang_async(GangType type, int gang_id, int size, int content)
 	 */
 	bool	   *connStatusDone = NULL;
 
+	/* bounded-concurrency launch state (see gp_gang_max_parallel_connects) */
+	bool	   *connStarted = NULL;
+	int			nextToStart = 0;
+	int			inFlight = 0;
+
 	ELOG_DISPATCHER_DEBUG("createGang type = %d, gang_id = %d, size = %d, content = %d",
 						  type, gang_id, size, content);
 
@@ -84,6 +89,8 @@ create_gang_retry:
 	successful_connections = 0;
 	in_recovery_mode_count = 0;
 	retry = false;
+	nextToStart = 0;
+	inFlight = 0;
 
 	/* allocate and initialize a gang structure */
 	newGangDefinition = buildGangDefinition(type, gang_id, size, content);
@@ -100,58 +107,23 @@ create_gang_retry:
 	 */
 	pollingStatus = palloc(sizeof(PostgresPollingStatusType) * size);
 	connStatusDone = palloc(sizeof(bool) * size);
+	connStarted = palloc0(sizeof(bool) * size);
 
 	struct pollfd *fds;
 
 	PG_TRY();
 	{
 		for (i = 0; i < size; i++)
-		{
-			char		gpqeid[100];
-			char	   *options;
-
-			/*
-			 * Create the connection requests.	If we find a segment without a
-			 * valid segdb we error out.  Also, if this segdb is invalid, we
-			 * must fail the connection.
-			 */
-			segdbDesc = &newGangDefinition->db_descriptors[i];
-
-			/*
-			 * Build the connection string.  Writer-ness needs to be processed
-			 * early enough now some locks are taken before command line
-			 * options are recognized.
-			 */
-			build_gpqeid_param(gpqeid, sizeof(gpqeid),
-							   segdbDesc->segindex,
-							   type == GANGTYPE_PRIMARY_WRITER,
-							   gang_id,
-							   segdbDesc->segment_database_info->hostSegs);
-
-			options = makeOptions();
-
-			/* start connection in asynchronous way */
-			cdbconn_doConnectStart(segdbDesc, gpqeid, options);
-
-			if (cdbconn_isBadConnection(segdbDesc))
-				ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
-								errmsg("failed to acquire resources on one or more segments"),
-								errdetail("%s (%s)", PQerrorMessage(segdbDesc->conn), segdbDesc->whoami)));
-
 			connStatusDone[i] = false;
 
-			/*
-			 * If connection status is not CONNECTION_BAD after
-			 * PQconnectStart(), we must act as if the PQconnectPoll() had
-			 * returned PGRES_POLLING_WRITING
-			 */
-			pollingStatus[i] = PGRES_POLLING_WRITING;
-		}
-
 		/*
-		 * Ok, we've now launched all the connection attempts. Start the
-		 * timeout clock (= get the start timestamp), and poll until they're
-		 * all completed or we reach timeout.
+		 * Launch the connection attempts, then start the timeout clock
+		 * (= get the start timestamp) and poll until they're all completed
+		 * or we reach timeout.  With gp_gang_max_parallel_connects set,
+		 * only that many attempts are kept in flight at once and further
+		 * ones are launched as earlier ones finish, so a cluster-wide
+		 * reconnect (e.g. after a segment bounce) doesn't hit every
+		 * postmaster with the whole gang at the same moment.
 		 */
 		gettimeofday(&startTS, NULL);
 		fds = (struct pollfd *) palloc0(sizeof(struct pollfd) * size);
@@ -161,6 +133,53 @@ create_gang_retry:
 			int			nready;
 			int			nfds = 0;
 
+			while (nextToStart < size &&
+				   (gp_gang_max_parallel_connects <= 0 ||
+					inFlight < gp_gang_max_parallel_connects))
+			{
+				char		gpqeid[100];
+				char	   *options;
+
+				/*
+				 * Create the connection requests.	If we find a segment
+				 * without a valid segdb we error out.  Also, if this segdb
+				 * is invalid, we must fail the connection.
+				 */
+				i = nextToStart++;
+				segdbDesc = &newGangDefinition->db_descriptors[i];
+
+				/*
+				 * Build the connection string.  Writer-ness needs to be
+				 * processed early enough now some locks are taken before
+				 * command line options are recognized.
+				 */
+				build_gpqeid_param(gpqeid, sizeof(gpqeid),
+								   segdbDesc->segindex,
+								   type == GANGTYPE_PRIMARY_WRITER,
+								   gang_id,
+								   segdbDesc->segment_database_info->hostSegs);
+
+				options = makeOptions();
+
+				/* start connection in asynchronous way */
+				cdbconn_doConnectStart(segdbDesc, gpqeid, options);
+
+				if (cdbconn_isBadConnection(segdbDesc))
+					ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+									errmsg("failed to acquire resources on one or more segments"),
+									errdetail("%s (%s)", PQerrorMessage(segdbDesc->conn), segdbDesc->whoami)));
+
+				connStarted[i] = true;
+				inFlight++;
+
+				/*
+				 * If connection status is not CONNECTION_BAD after
+				 * PQconnectStart(), we must act as if the PQconnectPoll()
+				 * had returned PGRES_POLLING_WRITING
+				 */
+				pollingStatus[i] = PGRES_POLLING_WRITING;
+			}
+
 			poll_timeout = getPollTimeout(&startTS);
 
 			for (i = 0; i < size; i++)
@@ -168,10 +187,10 @@ create_gang_retry:
 				segdbDesc = &newGangDefinition->db_descriptors[i];
 
 				/*
-				 * Skip established connections and in-recovery-mode
-				 * connections
+				 * Skip connections not yet launched, established
+				 * connections and in-recovery-mode connections
 				 */
-				if (connStatusDone[i])
+				if (!connStarted[i] || connStatusDone[i])
 					continue;
 
 				switch (pollingStatus[i])
@@ -184,6 +203,7 @@ create_gang_retry:
 											errdetail("Internal error: No motion listener port (%s)", segdbDesc->whoami)));
 						successful_connections++;
 						connStatusDone[i] = true;
+						inFlight--;
 						continue;
 
 					case PGRES_POLLING_READING:
@@ -203,6 +223,7 @@ create_gang_retry:
 						{
 							in_recovery_mode_count++;
 							connStatusDone[i] = true;
+							inFlight--;
 							elog(LOG, "segment is in recovery mode (%s)", segdbDesc->whoami);
 						}
 						else
@@ -227,7 +248,12 @@ create_gang_retry:
 			}
 
 			if (nfds == 0)
+			{
+				/* launch the remaining connection attempts, if any */
+				if (nextToStart < size)
+					continue;
 				break;
+			}
 
 			CHECK_FOR_INTERRUPTS();
 
@@ -252,7 +278,7 @@ create_gang_retry:
 				for (i = 0; i < size; i++)
 				{
 					segdbDesc = &newGangDefinition->db_descriptors[i];
-					if (connStatusDone[i])
+					if (!connStarted[i] || connStatusDone[i])
 						continue;
 
 					Assert(PQsocket(segdbDesc->conn) > 0);
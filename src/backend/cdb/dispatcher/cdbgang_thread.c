@@ -369,11 +369,8 @@ destroyConnectParms(DoConnectParms *doConnectParmsAr, int count)
 		{
 			DoConnectParms *pParms = &doConnectParmsAr[i];
 
-			if (pParms->connectOptions != NULL)
-			{
-				pfree(pParms->connectOptions);
-				pParms->connectOptions = NULL;
-			}
+			/* connectOptions is owned (and cached) by makeOptions() */
+			pParms->connectOptions = NULL;
 
 			pfree(pParms->segdbDescPtrArray);
 			pParms->segdbDescPtrArray = NULL;
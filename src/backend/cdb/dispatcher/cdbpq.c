@@ -60,3 +60,67 @@ PQsendGpQuery_shared(PGconn *conn, char *shared_query, int query_len, bool nonbl
 	conn->asyncStatus = PGASYNC_BUSY;
 	return 1;
 }
+
+/*
+ * Append a preformatted DTX protocol message ('T' ...) to the connection's
+ * output buffer.  Unlike PQsendGpQuery_shared(), this may be called again
+ * before the responses to an earlier pipelined message have been consumed:
+ * the QE processes the messages in order and the responses come back in the
+ * same order.  After draining one message's results with PQgetResult()
+ * (until it returns NULL), call PQgpRearmForPipelinedResult() to read the
+ * next message's results.
+ */
+int
+PQsendGpDtxProtocolPipelined(PGconn *conn, const char *dtx_command, int command_len)
+{
+	if (conn == NULL || conn->status != CONNECTION_OK)
+		return 0;
+
+	if (conn->asyncStatus != PGASYNC_IDLE && conn->asyncStatus != PGASYNC_BUSY)
+	{
+		printfPQExpBuffer(&conn->errorMessage,
+						  libpq_gettext("cannot pipeline while another command is mid-response\n"));
+		return 0;
+	}
+
+	if (conn->outBuffer_shared)
+	{
+		printfPQExpBuffer(&conn->errorMessage,
+						  libpq_gettext("cannot pipeline onto a shared query buffer\n"));
+		return 0;
+	}
+
+	if (pqCheckOutBufferSpace(conn->outCount + command_len, conn))
+		return 0;				/* errorMessage already set */
+
+	memcpy(conn->outBuffer + conn->outCount, dtx_command, command_len);
+	conn->outCount += command_len;
+
+	conn->queryclass = PGQUERY_SIMPLE;
+
+	/*
+	 * Give the data a push; PQgetResult() will do any additional flushing
+	 * needed when the responses are collected.
+	 */
+	if (pqFlushNonBlocking(conn) < 0)
+	{
+		pqHandleSendFailure(conn);
+		return 0;
+	}
+
+	conn->asyncStatus = PGASYNC_BUSY;
+	return 1;
+}
+
+/*
+ * Re-arm a connection so PQgetResult() will read the response of the next
+ * pipelined DTX protocol message.  libpq goes idle when it sees the
+ * ReadyForQuery that ends one message's response cycle; this flips it back
+ * to busy so the following response cycle is parsed.
+ */
+void
+PQgpRearmForPipelinedResult(PGconn *conn)
+{
+	if (conn->asyncStatus == PGASYNC_IDLE)
+		conn->asyncStatus = PGASYNC_BUSY;
+}
@@ -28,6 +28,10 @@
 #include "utils/memutils.h"
 #include "utils/typcache.h"
 
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
+
 
 /*
  * MOTION NODE INFO DATA STRUCTURES
@@ -68,6 +72,12 @@ static inline void reconstructTuple(MotionNodeEntry *pMNEntry, ChunkSorterEntry
 
 /* Stats-function declarations. */
 static void statSendTuple(MotionLayerState *mlStates, MotionNodeEntry *pMNEntry, TupleChunkList tcList);
+static MotionRouteBatch *getRouteBatch(MotionLayerState *mlStates,
+			  ChunkTransportState *transportStates, MotionNodeEntry *pMNEntry,
+			  int16 motNodeID, int16 targetRoute);
+static bool flushRouteBatch(MotionLayerState *mlStates,
+				ChunkTransportState *transportStates, MotionNodeEntry *pMNEntry,
+				int16 motNodeID, int16 targetRoute, MotionRouteBatch *batch);
 static void statSendEOS(MotionLayerState *mlStates, MotionNodeEntry *pMNEntry);
 static void statChunksProcessed(MotionLayerState *mlStates, MotionNodeEntry *pMNEntry, int chunksProcessed, int chunkBytes, int tupleBytes);
 static void statNewTupleArrived(MotionNodeEntry *pMNEntry, ChunkSorterEntry *pCSEntry);
@@ -357,6 +367,10 @@ UpdateMotionLayerNode(MotionLayerState *mlStates, int16 motNodeID, bool preserve
 
 	pEntry->num_stream_ends_recvd = 0;
 
+	/* Per-route send batches are allocated lazily, on first use. */
+	pEntry->route_batches = NULL;
+	pEntry->nroute_batches = 0;
+
 	/* Initialize statistics counters. */
 	pEntry->stat_total_chunks_sent = 0;
 	pEntry->stat_total_bytes_sent = 0;
@@ -443,6 +457,24 @@ CheckAndSendRecordCache(MotionLayerState *mlStates,
 	elog(DEBUG5, "Serializing RecordCache for sending.");
 #endif
 
+	/*
+	 * Tuples already micro-batched for this route were serialized against
+	 * the previous record cache; make sure they go out first.
+	 */
+	if (gp_motion_batch_size > 0 && pMNEntry->route_batches != NULL)
+	{
+		MotionRouteBatch *batch;
+
+		batch = getRouteBatch(mlStates, transportStates, pMNEntry,
+							  motNodeID, targetRoute);
+		if (!flushRouteBatch(mlStates, transportStates, pMNEntry,
+							 motNodeID, targetRoute, batch))
+		{
+			pMNEntry->stopped = true;
+			return;
+		}
+	}
+
 	/* Create and store the serialized form, and some stats about it. */
 	oldCtxt = MemoryContextSwitchTo(mlStates->motion_layer_mctx);
 
@@ -477,6 +509,98 @@ CheckAndSendRecordCache(MotionLayerState *mlStates,
 	UpdateSentRecordCache(conn);
 }
 
+/*
+ * Return the micro-batch for one route of a motion node, allocating the
+ * batch array on first use.  The last slot is reserved for broadcast.
+ */
+static MotionRouteBatch *
+getRouteBatch(MotionLayerState *mlStates,
+			  ChunkTransportState *transportStates,
+			  MotionNodeEntry *pMNEntry,
+			  int16 motNodeID,
+			  int16 targetRoute)
+{
+	if (pMNEntry->route_batches == NULL)
+	{
+		ChunkTransportStateEntry *pEntry = NULL;
+
+		getChunkTransportState(transportStates, motNodeID, &pEntry);
+
+		pMNEntry->nroute_batches = pEntry->numConns + 1;
+		pMNEntry->route_batches = (MotionRouteBatch *)
+			MemoryContextAllocZero(mlStates->motion_layer_mctx,
+								   pMNEntry->nroute_batches * sizeof(MotionRouteBatch));
+	}
+
+	if (targetRoute == BROADCAST_SEGIDX)
+		return &pMNEntry->route_batches[pMNEntry->nroute_batches - 1];
+
+	Assert(targetRoute >= 0 && targetRoute < pMNEntry->nroute_batches - 1);
+	return &pMNEntry->route_batches[targetRoute];
+}
+
+/*
+ * Hand the accumulated chunks of one route batch to the transport in a
+ * single call, and recycle the chunks.  Returns false if the receivers
+ * have gone away (the caller should stop sending).
+ */
+static bool
+flushRouteBatch(MotionLayerState *mlStates,
+				ChunkTransportState *transportStates,
+				MotionNodeEntry *pMNEntry,
+				int16 motNodeID,
+				int16 targetRoute,
+				MotionRouteBatch *batch)
+{
+	bool		ok = true;
+
+	if (batch->ntuples == 0)
+		return true;
+
+	ok = SendTupleChunkToAMS(mlStates, transportStates, motNodeID,
+							 targetRoute, batch->list.p_first);
+
+	clearTCList(&pMNEntry->ser_tup_info.chunkCache, &batch->list);
+	batch->ntuples = 0;
+
+	return ok;
+}
+
+/*
+ * Flush any pending per-route micro-batches of a motion node.  Called
+ * before end-of-stream, and whenever ordering against another send path
+ * must be preserved.
+ */
+void
+FlushTupleBatches(MotionLayerState *mlStates,
+				  ChunkTransportState *transportStates,
+				  int16 motNodeID)
+{
+	MotionNodeEntry *pMNEntry;
+	int			route;
+
+	pMNEntry = getMotionNodeEntry(mlStates, motNodeID, "FlushTupleBatches");
+
+	if (pMNEntry->route_batches == NULL)
+		return;
+
+	for (route = 0; route < pMNEntry->nroute_batches; route++)
+	{
+		int16		targetRoute;
+
+		if (pMNEntry->route_batches[route].ntuples == 0)
+			continue;
+
+		targetRoute = (route == pMNEntry->nroute_batches - 1) ?
+			BROADCAST_SEGIDX : route;
+
+		if (!flushRouteBatch(mlStates, transportStates, pMNEntry,
+							 motNodeID, targetRoute,
+							 &pMNEntry->route_batches[route]))
+			pMNEntry->stopped = true;
+	}
+}
+
 /*
  * Function:  SendTuple - Sends a portion or whole tuple to the AMS layer.
  */
@@ -515,6 +639,24 @@ SendTuple(MotionLayerState *mlStates,
 	{
 		struct directTransportBuffer b;
 
+		/*
+		 * Any micro-batched chunks for this route must reach the wire ahead
+		 * of tuples written straight into the send buffer below.
+		 */
+		if (gp_motion_batch_size > 0 && pMNEntry->route_batches != NULL)
+		{
+			MotionRouteBatch *batch;
+
+			batch = getRouteBatch(mlStates, transportStates, pMNEntry,
+								  motNodeID, targetRoute);
+			if (!flushRouteBatch(mlStates, transportStates, pMNEntry,
+								 motNodeID, targetRoute, batch))
+			{
+				pMNEntry->stopped = true;
+				return STOP_SENDING;
+			}
+		}
+
 		getTransportDirectBuffer(transportStates, motNodeID, targetRoute, &b);
 
 		if (b.pri != NULL && b.prilen > TUPLE_CHUNK_HEADER_SIZE)
@@ -535,6 +677,34 @@ SendTuple(MotionLayerState *mlStates,
 
 				return SEND_COMPLETE;
 			}
+
+			/*
+			 * The tuple did not fit in what remains of the send buffer. If
+			 * the transport can flush the buffered chunks out from under us,
+			 * retry the in-place serialization against the then-empty
+			 * buffer; this spares wide rows the detour through a chunk list
+			 * and the extra copy back into the send buffer.
+			 */
+			if (flushTransportDirectBuffer(mlStates, transportStates,
+										   motNodeID, targetRoute))
+			{
+				getTransportDirectBuffer(transportStates, motNodeID, targetRoute, &b);
+
+				if (b.pri != NULL && b.prilen > TUPLE_CHUNK_HEADER_SIZE)
+					sent = SerializeTupleDirect(tuple, &pMNEntry->ser_tup_info, &b);
+
+				if (sent > 0)
+				{
+					putTransportDirectBuffer(transportStates, motNodeID, targetRoute, sent);
+
+					tcList.num_chunks = 1;
+					tcList.serialized_data_length = sent;
+
+					statSendTuple(mlStates, pMNEntry, &tcList);
+
+					return SEND_COMPLETE;
+				}
+			}
 		}
 		/* Otherwise fall-through */
 	}
@@ -556,6 +726,47 @@ SendTuple(MotionLayerState *mlStates,
 		 tcList.num_chunks);
 #endif
 
+	/*
+	 * With micro-batching enabled, splice the serialized chunks onto the
+	 * route's pending batch instead of handing each tuple to the transport
+	 * separately; the batch is flushed once it holds a packet's worth of
+	 * data or gp_motion_batch_size tuples.
+	 */
+	if (gp_motion_batch_size > 0)
+	{
+		MotionRouteBatch *batch;
+
+		batch = getRouteBatch(mlStates, transportStates, pMNEntry,
+							  motNodeID, targetRoute);
+
+		if (batch->list.p_first == NULL)
+			batch->list = tcList;
+		else
+		{
+			batch->list.p_last->p_next = tcList.p_first;
+			batch->list.p_last = tcList.p_last;
+			batch->list.num_chunks += tcList.num_chunks;
+			batch->list.serialized_data_length += tcList.serialized_data_length;
+		}
+		batch->ntuples++;
+
+		/* update stats per tuple, while we still have the tuple's list */
+		statSendTuple(mlStates, pMNEntry, &tcList);
+
+		if (batch->ntuples >= gp_motion_batch_size ||
+			batch->list.serialized_data_length >= Gp_max_tuple_chunk_size)
+		{
+			if (!flushRouteBatch(mlStates, transportStates, pMNEntry,
+								 motNodeID, targetRoute, batch))
+			{
+				pMNEntry->stopped = true;
+				return STOP_SENDING;
+			}
+		}
+
+		return SEND_COMPLETE;
+	}
+
 	/* do the send. */
 	if (!SendTupleChunkToAMS(mlStates, transportStates, motNodeID, targetRoute, tcList.p_first))
 	{
@@ -600,6 +811,9 @@ SendEndOfStream(MotionLayerState *mlStates,
 	 */
 	pMNEntry = getMotionNodeEntry(mlStates, motNodeID, "SendEndOfStream");
 
+	/* micro-batched tuples must precede the end-of-stream token */
+	FlushTupleBatches(mlStates, transportStates, motNodeID);
+
 	transportStates->SendEos(mlStates, transportStates, motNodeID, s_eos_chunk_data);
 
 	/*
@@ -923,6 +1137,19 @@ EndMotionLayerNode(MotionLayerState *mlStates, int16 motNodeID, bool flushCommLa
 		}
 	}
 
+	/* Recycle any micro-batched chunks that never got flushed. */
+	if (pMNEntry->route_batches != NULL)
+	{
+		int			route;
+
+		for (route = 0; route < pMNEntry->nroute_batches; route++)
+			clearTCList(&pMNEntry->ser_tup_info.chunkCache,
+						&pMNEntry->route_batches[route].list);
+		pfree(pMNEntry->route_batches);
+		pMNEntry->route_batches = NULL;
+		pMNEntry->nroute_batches = 0;
+	}
+
 	CleanupSerTupInfo(&pMNEntry->ser_tup_info);
 	FreeTupleDesc(pMNEntry->tuple_desc);
 	if (!pMNEntry->preserve_order)
@@ -1072,6 +1299,87 @@ materializeChunk(TupleChunkListItem *tcItem)
 	return;
 }
 
+/*
+ * Reinflate a TC_COMPRESSED chunk and feed the original chunks it carries
+ * back to the chunk sorter.  The payload is the uncompressed length
+ * (uint32) followed by the deflated image of a chunk sequence, headers
+ * included; see compressChunkList() in ic_common.c for the sender side.
+ */
+static void
+handleCompressedChunk(MotionLayerState *mlStates,
+					  ChunkTransportState *transportStates,
+					  MotionNodeEntry *pMNEntry,
+					  TupleChunkListItem tcItem,
+					  int16 motNodeID,
+					  int16 srcRoute)
+{
+#ifndef HAVE_LIBZ
+	ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+					errmsg("Received TC_COMPRESSED chunk from [src=%d,mn=%d] but "
+						   "this server was built without zlib support.",
+						   srcRoute, motNodeID)));
+#else
+	uint16		payloadSize;
+	uint32		rawLen;
+	uLongf		destLen;
+	char	   *data;
+	char	   *raw;
+	char	   *pos;
+
+	GetChunkDataSize(tcItem, &payloadSize);
+	data = GetChunkDataPtr(tcItem) + TUPLE_CHUNK_HEADER_SIZE;
+
+	if (payloadSize <= sizeof(uint32))
+		ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+						errmsg("Received truncated TC_COMPRESSED chunk from [src=%d,mn=%d].",
+							   srcRoute, motNodeID)));
+
+	memcpy(&rawLen, data, sizeof(uint32));
+
+	raw = palloc(rawLen);
+	destLen = rawLen;
+
+	if (uncompress((Bytef *) raw, &destLen,
+				   (Bytef *) data + sizeof(uint32),
+				   payloadSize - sizeof(uint32)) != Z_OK ||
+		destLen != rawLen)
+		ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+						errmsg("Could not decompress TC_COMPRESSED chunk from [src=%d,mn=%d].",
+							   srcRoute, motNodeID)));
+
+	/* walk the inflated image, chunk by chunk */
+	pos = raw;
+	while (pos < raw + rawLen)
+	{
+		TupleChunkListItem newItem;
+		uint16		dataSize;
+		int			chunkLen;
+
+		memcpy(&dataSize, pos, sizeof(uint16));
+		chunkLen = TUPLE_CHUNK_HEADER_SIZE + dataSize;
+
+		if (pos + chunkLen > raw + rawLen)
+			ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+							errmsg("Malformed chunk inside TC_COMPRESSED chunk from [src=%d,mn=%d].",
+								   srcRoute, motNodeID)));
+
+		newItem = (TupleChunkListItem)
+			palloc(sizeof(TupleChunkListItemData) + chunkLen);
+		newItem->p_next = NULL;
+		newItem->inplace = NULL;
+		newItem->chunk_length = chunkLen;
+		memcpy(newItem->chunk_data, pos, chunkLen);
+
+		addChunkToSorter(mlStates, transportStates, pMNEntry, newItem,
+						 motNodeID, srcRoute);
+
+		pos += chunkLen;
+	}
+
+	pfree(raw);
+#endif   /* HAVE_LIBZ */
+}
+
 /*
  * Add another tuple-chunk to the chunk sorter.  If the new chunk
  * completes another HeapTuple, that tuple will be deserialized and
@@ -1222,6 +1530,12 @@ addChunkToSorter(MotionLayerState *mlStates,
 								   "end of stream");
 			break;
 
+		case TC_COMPRESSED:
+			/* inflate, and re-feed the original chunks to ourselves */
+			handleCompressedChunk(mlStates, transportStates, pMNEntry,
+								  tcItem, motNodeID, srcRoute);
+			break;
+
 		default:
 			ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
 							errmsg("Received tuple chunk of unrecognized type %d (len %d)"
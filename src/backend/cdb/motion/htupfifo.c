@@ -3,6 +3,15 @@
  * htupfifo.c
  *	   A FIFO queue for HeapTuples.
  *
+ * The FIFO is a linked list of fixed-size chunks, each holding an array
+ * of tuple pointers.  Tuples are appended at the tail chunk and consumed
+ * from the head chunk, ring-buffer style; a chunk is only allocated once
+ * per HTF_CHUNK_CAPACITY appends, and one drained chunk is kept on the
+ * side for reuse.  The previous implementation linked an individually
+ * allocated entry per tuple, which cost an allocation, a pointer chase
+ * and a freelist round-trip on every single tuple moved through a motion
+ * node.
+ *
  * Portions Copyright (c) 2005-2008, Greenplum inc
  * Portions Copyright (c) 2012-Present Pivotal Software, Inc.
  *
@@ -19,8 +28,6 @@
 #include "utils/memutils.h"
 #include "cdb/htupfifo.h"
 
-#define HTF_FREELIST_MAX_LEN (10)
-
 static void htfifo_cleanup(htup_fifo htf);
 
 /*
@@ -72,11 +79,12 @@ htfifo_init(htup_fifo htf, int max_mem_kb)
 	AssertArg(htf != NULL);
 	AssertArg(max_mem_kb > MIN_HTUPFIFO_KB);
 
-	htf->p_first = NULL;
-	htf->p_last = NULL;
+	htf->head = NULL;
+	htf->tail = NULL;
+	htf->head_pos = 0;
+	htf->tail_pos = 0;
 
-	htf->freelist = NULL;
-	htf->freelist_count = 0;
+	htf->spare = NULL;
 
 	htf->tup_count = 0;
 	htf->curr_mem_size = 0;
@@ -99,18 +107,24 @@ htfifo_cleanup(htup_fifo htf)
 	while ((tup = htfifo_gettuple(htf)) != NULL)
 		pfree(tup);
 
-	while (htf->freelist)
+	/* a drained FIFO keeps its last chunk rewound in place; free it too */
+	while (htf->head != NULL)
 	{
-		htf_entry	trash = htf->freelist;
-
-		htf->freelist = trash->p_next;
+		htf_chunk	trash = htf->head;
 
+		htf->head = trash->p_next;
 		pfree(trash);
 	}
-	htf->freelist_count = 0;
+	htf->tail = NULL;
+
+	if (htf->spare != NULL)
+	{
+		pfree(htf->spare);
+		htf->spare = NULL;
+	}
 
-	htf->p_first = NULL;
-	htf->p_last = NULL;
+	htf->head_pos = 0;
+	htf->tail_pos = 0;
 	htf->tup_count = 0;
 	htf->curr_mem_size = 0;
 	htf->max_mem_size = 0;
@@ -146,43 +160,44 @@ htfifo_destroy(htup_fifo htf)
 void
 htfifo_addtuple(htup_fifo htf, GenericTuple tup)
 {
-	htf_entry	p_ent;
-
 	AssertArg(htf != NULL);
 	AssertArg(tup != NULL);
 
-	/* Populate the new entry. */
-	if (htf->freelist != NULL)
-	{
-		p_ent = htf->freelist;
-		htf->freelist = p_ent->p_next;
-		htf->freelist_count = htf->freelist_count - 1;
-	}
-	else
+	if (htf->tail == NULL || htf->tail_pos == HTF_CHUNK_CAPACITY)
 	{
-		p_ent = (htf_entry) palloc(sizeof(htf_entry_data));
-	}
-	p_ent->tup = tup;
-	p_ent->p_next = NULL;
+		/* need a fresh tail chunk */
+		htf_chunk	chunk;
 
-	/* Put the new entry at the end of the FIFO. */
-	if (htf->p_last != NULL)
-	{
-		AssertState(htf->p_first != NULL);
-		htf->p_last->p_next = p_ent;
-	}
-	else
-		/* htf->p_last == NULL */
-	{
-		AssertState(htf->p_first == NULL);
-		htf->p_first = p_ent;
+		if (htf->spare != NULL)
+		{
+			chunk = htf->spare;
+			htf->spare = NULL;
+		}
+		else
+		{
+			chunk = (htf_chunk) palloc(sizeof(htf_chunk_data));
+			htf->curr_mem_size += GetMemoryChunkSpace(chunk);
+		}
+		chunk->p_next = NULL;
+
+		if (htf->tail != NULL)
+			htf->tail->p_next = chunk;
+		else
+		{
+			AssertState(htf->head == NULL);
+			htf->head = chunk;
+			htf->head_pos = 0;
+		}
+		htf->tail = chunk;
+		htf->tail_pos = 0;
 	}
-	htf->p_last = p_ent;
+
+	htf->tail->tups[htf->tail_pos++] = tup;
 
 	/* Update the FIFO state. */
 
 	htf->tup_count++;
-	htf->curr_mem_size += GetMemoryChunkSpace(p_ent) + GetMemoryChunkSpace(tup);
+	htf->curr_mem_size += GetMemoryChunkSpace(tup);
 }
 
 
@@ -193,61 +208,56 @@ htfifo_addtuple(htup_fifo htf, GenericTuple tup)
 GenericTuple
 htfifo_gettuple(htup_fifo htf)
 {
-	htf_entry	p_ent;
 	GenericTuple tup;
 
 	AssertArg(htf != NULL);
 
-	/* Pull the first entry from the FIFO. */
-
-	p_ent = htf->p_first;
-	if (p_ent != NULL)
+	if (htf->head == NULL ||
+		(htf->head == htf->tail && htf->head_pos == htf->tail_pos))
 	{
-		/* Got something.  Unhook the first entry from the list. */
+		/*
+		 * No entries in FIFO.	Just do some sanity checks, but NULL is the
+		 * result.
+		 */
+		AssertState(htf->tup_count == 0);
+		return NULL;
+	}
 
-		htf->p_first = p_ent->p_next;
-		if (htf->p_first == NULL)
-			htf->p_last = NULL;
+	tup = htf->head->tups[htf->head_pos++];
+	AssertState(tup != NULL);
 
-		p_ent->p_next = NULL;	/* Just for the sake of completeness... */
+	/* Update the FIFO state. */
 
-		tup = p_ent->tup;
-		AssertState(tup != NULL);
+	AssertState(htf->tup_count > 0);
+	AssertState(htf->curr_mem_size > 0);
 
-		/* Update the FIFO state. */
+	htf->tup_count--;
+	htf->curr_mem_size -= GetMemoryChunkSpace(tup);
 
-		AssertState(htf->tup_count > 0);
-		AssertState(htf->curr_mem_size > 0);
+	if (htf->head == htf->tail && htf->head_pos == htf->tail_pos)
+	{
+		/* drained the FIFO: rewind in place, keeping the chunk */
+		htf->head_pos = 0;
+		htf->tail_pos = 0;
+	}
+	else if (htf->head_pos == HTF_CHUNK_CAPACITY)
+	{
+		/* head chunk is used up: pop it, recycling one chunk at most */
+		htf_chunk	trash = htf->head;
 
-		htf->tup_count--;
-		htf->curr_mem_size -=
-			(GetMemoryChunkSpace(p_ent) + GetMemoryChunkSpace(tup));
+		htf->head = trash->p_next;
+		htf->head_pos = 0;
 
-		AssertState(htf->tup_count >= 0);
-		AssertState(htf->curr_mem_size >= 0);
+		AssertState(htf->head != NULL);
 
-		/* Free the FIFO entry. */
-		if (htf->freelist_count > HTF_FREELIST_MAX_LEN)
-		{
-			pfree(p_ent);
-		}
+		if (htf->spare == NULL)
+			htf->spare = trash;
 		else
 		{
-			p_ent->p_next = htf->freelist;
-			htf->freelist = p_ent;
-			htf->freelist_count = htf->freelist_count + 1;
+			htf->curr_mem_size -= GetMemoryChunkSpace(trash);
+			pfree(trash);
 		}
 	}
-	else
-	{
-		/*
-		 * No entries in FIFO.	Just do some sanity checks, but NULL is the
-		 * result.
-		 */
-		AssertState(htf->tup_count == 0);
-		AssertState(htf->curr_mem_size == 0);
-		tup = NULL;
-	}
 
 	return tup;
 }
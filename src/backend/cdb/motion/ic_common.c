@@ -31,6 +31,14 @@
 #include <sys/time.h>
 #include <netinet/in.h>
 
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
 #ifdef WIN32
 #define WIN32_LEAN_AND_MEAN
 #ifndef _WIN32_WINNT
@@ -271,6 +279,71 @@ CleanUpMotionLayerIPC(void)
 	UDP_listenerFd = -1;
 }
 
+/*
+ * Try to compress a whole chunk list into a single TC_COMPRESSED chunk.
+ *
+ * The payload of a TC_COMPRESSED chunk is the uncompressed length (uint32)
+ * followed by the deflated image of the original chunks, headers included,
+ * so the receiver can reinflate and re-feed them to its chunk sorter
+ * unchanged.  Returns a palloc'd chunk item, or NULL if the list is below
+ * the compression threshold, did not shrink, or would not fit in a single
+ * chunk (the transport sends one chunk per call, so we cannot emit a
+ * multi-chunk compressed image here).
+ */
+static TupleChunkListItem
+compressChunkList(TupleChunkListItem tcItem)
+{
+#ifndef HAVE_LIBZ
+	return NULL;
+#else
+	TupleChunkListItem currItem;
+	TupleChunkListItem compItem;
+	uLongf		compLen;
+	uint32		rawLen = 0;
+	char	   *raw;
+	char	   *pos;
+
+	for (currItem = tcItem; currItem != NULL; currItem = currItem->p_next)
+		rawLen += currItem->chunk_length;
+
+	if (rawLen < gp_interconnect_compress_threshold)
+		return NULL;
+
+	raw = palloc(rawLen);
+	pos = raw;
+	for (currItem = tcItem; currItem != NULL; currItem = currItem->p_next)
+	{
+		memcpy(pos, GetChunkDataPtr(currItem), currItem->chunk_length);
+		pos += currItem->chunk_length;
+	}
+
+	compLen = compressBound(rawLen);
+	compItem = palloc(sizeof(TupleChunkListItemData) +
+					  TUPLE_CHUNK_HEADER_SIZE + sizeof(uint32) + compLen);
+
+	if (compress2((Bytef *) compItem->chunk_data + TUPLE_CHUNK_HEADER_SIZE + sizeof(uint32),
+				  &compLen, (Bytef *) raw, rawLen, 1) != Z_OK ||
+		sizeof(uint32) + compLen >= rawLen ||
+		sizeof(uint32) + compLen > Gp_max_tuple_chunk_size)
+	{
+		/* did not shrink enough to be worth it; send it as-is */
+		pfree(compItem);
+		pfree(raw);
+		return NULL;
+	}
+	pfree(raw);
+
+	compItem->p_next = NULL;
+	compItem->inplace = NULL;
+	compItem->chunk_length = TUPLE_CHUNK_HEADER_SIZE + sizeof(uint32) + compLen;
+	SetChunkType(compItem->chunk_data, TC_COMPRESSED);
+	SetChunkDataSize(compItem->chunk_data, sizeof(uint32) + compLen);
+	memcpy(compItem->chunk_data + TUPLE_CHUNK_HEADER_SIZE, &rawLen, sizeof(uint32));
+
+	return compItem;
+#endif   /* HAVE_LIBZ */
+}
+
 /* See ml_ipc.h */
 bool
 SendTupleChunkToAMS(MotionLayerState *mlStates,
@@ -284,6 +357,7 @@ SendTupleChunkToAMS(MotionLayerState *mlStates,
 	ChunkTransportStateEntry *pEntry = NULL;
 	MotionConn *conn;
 	TupleChunkListItem currItem;
+	TupleChunkListItem compItem = NULL;
 
 	if (!transportStates)
 		elog(FATAL, "SendTupleChunkToAMS: no transport-states.");
@@ -301,26 +375,43 @@ SendTupleChunkToAMS(MotionLayerState *mlStates,
 
 	getChunkTransportState(transportStates, motNodeID, &pEntry);
 
+	/*
+	 * If chunk compression is on, try to collapse the whole list into one
+	 * TC_COMPRESSED chunk before it goes to the wire.
+	 */
+	if (gp_interconnect_compress_chunks)
+	{
+		compItem = compressChunkList(tcItem);
+		if (compItem != NULL)
+			tcItem = compItem;
+	}
+
 	/*
 	 * tcItem can actually be a chain of tcItems.  we need to send out all of
 	 * them.
 	 */
-	currItem = tcItem;
-
-	for (currItem = tcItem; currItem != NULL; currItem = currItem->p_next)
+	if (targetRoute == BROADCAST_SEGIDX)
 	{
+		/*
+		 * The chain was serialized exactly once; give the whole of it to
+		 * each still-active connection in turn, so per-destination work is
+		 * just the copy into that connection's send buffer (which the
+		 * transport must own for retransmission) rather than a re-walk of
+		 * every connection per chunk.
+		 */
+		doBroadcastList(mlStates, transportStates, pEntry, tcItem, &recount);
+	}
+	else
+	{
+		/* handle pt-to-pt message. Primary */
+		conn = pEntry->conns + targetRoute;
+
+		for (currItem = tcItem; currItem != NULL; currItem = currItem->p_next)
+		{
 #ifdef AMS_VERBOSE_LOGGING
-		elog(DEBUG5, "SendTupleChunkToAMS: chunk length %d", currItem->chunk_length);
+			elog(DEBUG5, "SendTupleChunkToAMS: chunk length %d", currItem->chunk_length);
 #endif
 
-		if (targetRoute == BROADCAST_SEGIDX)
-		{
-			doBroadcast(mlStates, transportStates, pEntry, currItem, &recount);
-		}
-		else
-		{
-			/* handle pt-to-pt message. Primary */
-			conn = pEntry->conns + targetRoute;
 			/* only send to interested connections */
 			if (conn->stillActive)
 			{
@@ -332,6 +423,9 @@ SendTupleChunkToAMS(MotionLayerState *mlStates,
 		}
 	}
 
+	if (compItem != NULL)
+		pfree(compItem);
+
 	if (recount == 0)
 		return true;
 
@@ -449,6 +543,47 @@ putTransportDirectBuffer(ChunkTransportState *transportStates,
 	return;
 }
 
+/*
+ * Flush the buffered chunks of one route to the wire so that a follow-up
+ * getTransportDirectBuffer() sees an empty transmit buffer.  Returns true
+ * if the transport flushed and the connection can take more data; returns
+ * false if the transport has no flush fast path, the connection is no
+ * longer active, or nothing was buffered.
+ */
+bool
+flushTransportDirectBuffer(MotionLayerState *mlStates,
+						   ChunkTransportState *transportStates,
+						   int16 motNodeID,
+						   int16 targetRoute)
+{
+	ChunkTransportStateEntry *pEntry = NULL;
+	MotionConn *conn;
+
+	if (!transportStates)
+	{
+		elog(FATAL, "flushTransportDirectBuffer: no transport states");
+	}
+	else if (!transportStates->activated)
+	{
+		elog(FATAL, "flushTransportDirectBuffer: inactive transport states");
+	}
+	else if (targetRoute == BROADCAST_SEGIDX)
+	{
+		elog(FATAL, "flushTransportDirectBuffer: can't direct-transport to broadcast");
+	}
+
+	if (transportStates->FlushBuffer == NULL)
+		return false;
+
+	getChunkTransportState(transportStates, motNodeID, &pEntry);
+
+	/* handle pt-to-pt message. Primary */
+	conn = pEntry->conns + targetRoute;
+
+	return transportStates->FlushBuffer(mlStates, transportStates, pEntry,
+										conn, motNodeID);
+}
+
 /*
  * DeregisterReadInterest is called on receiving nodes when they
  * believe that they're done with the receiver
@@ -505,6 +640,11 @@ DeregisterReadInterest(ChunkTransportState *transportStates,
 		shutdown(conn->sockfd, SHUT_WR);
 
 		MPP_FD_CLR(conn->sockfd, &pEntry->readSet);
+
+#ifdef __linux__
+		if (pEntry->epollFd >= 0)
+			epoll_ctl(pEntry->epollFd, EPOLL_CTL_DEL, conn->sockfd, NULL);
+#endif
 	}
 	return;
 }
@@ -773,6 +913,7 @@ createChunkTransportState(ChunkTransportState *transportStates,
 	pEntry->numConns = numPrimaryConns;
 	pEntry->numPrimaryConns = numPrimaryConns;
 	pEntry->scanStart = 0;
+	pEntry->epollFd = -1;
 	pEntry->sendSlice = sendSlice;
 	pEntry->recvSlice = recvSlice;
 
@@ -837,6 +978,12 @@ removeChunkTransportState(ChunkTransportState *transportStates,
 
 	MPP_FD_ZERO(&pEntry->readSet);
 
+	if (pEntry->epollFd >= 0)
+	{
+		closesocket(pEntry->epollFd);
+		pEntry->epollFd = -1;
+	}
+
 	return pEntry;
 }
 
@@ -43,6 +43,10 @@
 #include <sys/time.h>
 #include <netinet/in.h>
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
 /*
  * backlog for listen() call: it is important that this be something like a
  * good match for the maximum number of QEs. Slow insert performance will
@@ -1438,6 +1442,8 @@ SetupTCPInterconnect(EState *estate)
 	estate->interconnect_context->RecvTupleChunkFromAny = RecvTupleChunkFromAnyTCP;
 	estate->interconnect_context->SendEos = SendEosTCP;
 	estate->interconnect_context->SendChunk = SendChunkTCP;
+	/* TCP sends from the connection buffer directly; no flush fast path */
+	estate->interconnect_context->FlushBuffer = NULL;
 	estate->interconnect_context->doSendStopMessage = doSendStopMessageTCP;
 
 	mySlice = (Slice *) list_nth(estate->interconnect_context->sliceTable->slices, LocallyExecutingSliceIndex(estate));
@@ -2627,6 +2633,51 @@ RecvTupleChunkFromTCP(ChunkTransportState *transportStates,
 	return RecvTupleChunk(conn, transportStates);
 }
 
+#ifdef __linux__
+/*
+ * Lazily build an epoll instance mirroring pEntry->readSet, so that
+ * RecvTupleChunkFromAnyTCP can wait on one epoll fd instead of copying
+ * and scanning an fd_set proportional to the connection count on every
+ * call.  All incoming connections are registered during interconnect
+ * setup, before the first receive, so enumerating the readSet here once
+ * is complete; DeregisterReadInterest removes sockets as they go EOS.
+ *
+ * On failure we log and mark the entry so the select() path is used.
+ */
+static void
+setupEntryEpoll(ChunkTransportStateEntry *pEntry)
+{
+	int			i;
+
+	pEntry->epollFd = epoll_create(pEntry->numConns + 1);
+	if (pEntry->epollFd < 0)
+	{
+		elog(LOG, "interconnect: epoll_create: %m; falling back to select()");
+		pEntry->epollFd = -2;	/* don't retry */
+		return;
+	}
+
+	for (i = 0; i < pEntry->numConns; i++)
+	{
+		MotionConn *conn = pEntry->conns + i;
+		struct epoll_event ev;
+
+		if (conn->sockfd < 0 || !MPP_FD_ISSET(conn->sockfd, &pEntry->readSet))
+			continue;
+
+		ev.events = EPOLLIN;
+		ev.data.u32 = i;
+		if (epoll_ctl(pEntry->epollFd, EPOLL_CTL_ADD, conn->sockfd, &ev) < 0)
+		{
+			elog(LOG, "interconnect: epoll_ctl: %m; falling back to select()");
+			close(pEntry->epollFd);
+			pEntry->epollFd = -2;
+			return;
+		}
+	}
+}
+#endif   /* __linux__ */
+
 static TupleChunkListItem
 RecvTupleChunkFromAnyTCP(MotionLayerState *mlStates,
 						 ChunkTransportState *transportStates,
@@ -2695,15 +2746,61 @@ RecvTupleChunkFromAnyTCP(MotionLayerState *mlStates,
 		if (skipSelect)
 			break;
 
-		n = select(pEntry->highReadSock + 1, (fd_set *) &rset, NULL, NULL, &timeout);
-		pMNEntry->sel_rd_wait += (tval.tv_sec - timeout.tv_sec) * 1000000 + (tval.tv_usec - timeout.tv_usec);
-		if (n < 0)
+#ifdef __linux__
+		if (pEntry->epollFd == -1)
+			setupEntryEpoll(pEntry);
+
+		if (pEntry->epollFd >= 0)
 		{
-			if (errno == EINTR)
-				continue;
-			ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
-							errmsg("Interconnect error receiving an incoming packet."),
-							errdetail("%s: %m", "select")));
+			struct epoll_event evs[64];
+			struct timeval before,
+						after;
+			int			j;
+
+			gettimeofday(&before, NULL);
+			n = epoll_wait(pEntry->epollFd, evs, lengthof(evs),
+						   tval.tv_sec * 1000 + tval.tv_usec / 1000);
+			gettimeofday(&after, NULL);
+			pMNEntry->sel_rd_wait += (after.tv_sec - before.tv_sec) * 1000000 +
+				(after.tv_usec - before.tv_usec);
+
+			if (n < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+								errmsg("Interconnect error receiving an incoming packet."),
+								errdetail("%s: %m", "epoll_wait")));
+			}
+
+			/*
+			 * Translate the ready list into rset, so the fair round-robin
+			 * scan below works the same for both wait mechanisms.
+			 */
+			if (n > 0)
+			{
+				MPP_FD_ZERO(&rset);
+				for (j = 0; j < n; j++)
+				{
+					conn = pEntry->conns + evs[j].data.u32;
+					if (conn->sockfd >= 0)
+						MPP_FD_SET(conn->sockfd, &rset);
+				}
+			}
+		}
+		else
+#endif   /* __linux__ */
+		{
+			n = select(pEntry->highReadSock + 1, (fd_set *) &rset, NULL, NULL, &timeout);
+			pMNEntry->sel_rd_wait += (tval.tv_sec - timeout.tv_sec) * 1000000 + (tval.tv_usec - timeout.tv_usec);
+			if (n < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+								errmsg("Interconnect error receiving an incoming packet."),
+								errdetail("%s: %m", "select")));
+			}
 		}
 #ifdef AMS_VERBOSE_LOGGING
 		elog(DEBUG5, "RecvTupleChunkFromAny() select() returned %d ready sockets", n);
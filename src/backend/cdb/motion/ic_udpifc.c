@@ -37,6 +37,9 @@
 #include "libpq/ip.h"
 #include "utils/builtins.h"
 #include "utils/faultinjector.h"
+#include "funcapi.h"
+#include "storage/shmem.h"
+#include "storage/spin.h"
 #include "port/atomics.h"
 #include "port/pg_crc32c.h"
 #include "storage/latch.h"
@@ -634,6 +637,35 @@ typedef struct ICStatistics
 /* Statistics for UDP interconnect. */
 static ICStatistics ic_statistics;
 
+/*
+ * ICStatsShmemData
+ *
+ * Cluster-visible totals of the per-query ICStatistics counters, kept in
+ * shared memory so that gp_interconnect_flows can be queried from any
+ * backend while other sessions run.  Each interconnect teardown folds its
+ * query's counters into these totals under the spinlock.
+ */
+typedef struct ICStatsShmemData
+{
+	slock_t		lock;
+	uint64		teardowns;
+	uint64		sndPktNum;
+	uint64		recvPktNum;
+	uint64		retransmits;
+	uint64		crcErrors;
+	uint64		mismatchNum;
+	uint64		disorderedPktNum;
+	uint64		duplicatedPktNum;
+	uint64		recvAckNum;
+	uint64		statusQueryMsgNum;
+	uint64		totalRecvQueueSize;
+	uint64		recvQueueSizeCountingTime;
+	uint64		totalCapacity;
+	uint64		capacityCountingTime;
+} ICStatsShmemData;
+
+static ICStatsShmemData *ic_stats_shmem = NULL;
+
 /*=========================================================================
  * STATIC FUNCTIONS declarations
  */
@@ -725,6 +757,10 @@ static void SendEosUDPIFC(MotionLayerState *mlStates, ChunkTransportState *trans
 			  int motNodeID, TupleChunkListItem tcItem);
 static bool SendChunkUDPIFC(MotionLayerState *mlStates, ChunkTransportState *transportStates,
 				ChunkTransportStateEntry *pEntry, MotionConn *conn, TupleChunkListItem tcItem, int16 motionId);
+static bool flushBuffer(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry,
+			MotionConn *conn, int16 motionId);
+static bool SendFlushUDPIFC(MotionLayerState *mlStates, ChunkTransportState *transportStates,
+				ChunkTransportStateEntry *pEntry, MotionConn *conn, int16 motionId);
 
 static void doSendStopMessageUDPIFC(ChunkTransportState *transportStates, int16 motNodeID);
 static bool dispatcherAYT(void);
@@ -2999,6 +3035,7 @@ SetupUDPIFCInterconnect_Internal(EState *estate)
 	estate->interconnect_context->RecvTupleChunkFromAny = RecvTupleChunkFromAnyUDPIFC;
 	estate->interconnect_context->SendEos = SendEosUDPIFC;
 	estate->interconnect_context->SendChunk = SendChunkUDPIFC;
+	estate->interconnect_context->FlushBuffer = SendFlushUDPIFC;
 	estate->interconnect_context->doSendStopMessage = doSendStopMessageUDPIFC;
 
 	mySlice = (Slice *) list_nth(estate->interconnect_context->sliceTable->slices, LocallyExecutingSliceIndex(estate));
@@ -3556,6 +3593,27 @@ TeardownUDPIFCInterconnect_Internal(ChunkTransportState *transportStates,
 		 (minRtt == ~((uint64) 0) ? 0 : minRtt), (minDev == ~((uint64) 0) ? 0 : minDev), avgRtt, avgDev, maxRtt, maxDev,
 		 snd_control_info.cwnd, ic_statistics.statusQueryMsgNum);
 
+	/* Fold this query's counters into the cluster-visible totals. */
+	if (ic_stats_shmem != NULL)
+	{
+		SpinLockAcquire(&ic_stats_shmem->lock);
+		ic_stats_shmem->teardowns++;
+		ic_stats_shmem->sndPktNum += (uint64) ic_statistics.sndPktNum;
+		ic_stats_shmem->recvPktNum += (uint64) ic_statistics.recvPktNum;
+		ic_stats_shmem->retransmits += (uint64) ic_statistics.retransmits;
+		ic_stats_shmem->crcErrors += (uint64) ic_statistics.crcErrors;
+		ic_stats_shmem->mismatchNum += (uint64) ic_statistics.mismatchNum;
+		ic_stats_shmem->disorderedPktNum += (uint64) ic_statistics.disorderedPktNum;
+		ic_stats_shmem->duplicatedPktNum += (uint64) ic_statistics.duplicatedPktNum;
+		ic_stats_shmem->recvAckNum += (uint64) ic_statistics.recvAckNum;
+		ic_stats_shmem->statusQueryMsgNum += (uint64) ic_statistics.statusQueryMsgNum;
+		ic_stats_shmem->totalRecvQueueSize += ic_statistics.totalRecvQueueSize;
+		ic_stats_shmem->recvQueueSizeCountingTime += ic_statistics.recvQueueSizeCountingTime;
+		ic_stats_shmem->totalCapacity += ic_statistics.totalCapacity;
+		ic_stats_shmem->capacityCountingTime += ic_statistics.capacityCountingTime;
+		SpinLockRelease(&ic_stats_shmem->lock);
+	}
+
 	ic_control_info.isSender = false;
 	memset(&ic_statistics, 0, sizeof(ICStatistics));
 
@@ -5307,9 +5365,6 @@ SendChunkUDPIFC(MotionLayerState *mlStates,
 {
 
 	int			length = TYPEALIGN(TUPLE_CHUNK_ALIGN, tcItem->chunk_length);
-	int			retry = 0;
-	bool		doCheckExpiration = false;
-	bool		gotStops = false;
 
 	Assert(conn->msgSize > 0);
 
@@ -5327,6 +5382,37 @@ SendChunkUDPIFC(MotionLayerState *mlStates,
 		return true;
 	}
 
+	if (!flushBuffer(transportStates, pEntry, conn, motionId))
+		return true;
+
+	/* now we can copy the input to the new buffer */
+	memcpy(conn->pBuff + conn->msgSize, tcItem->chunk_data, tcItem->chunk_length);
+	conn->msgSize += length;
+
+	conn->tupleCount++;
+
+	return true;
+}
+
+/*
+ * flushBuffer
+ * 		Transmit the current packet of a connection and acquire a fresh
+ * 		send buffer, blocking until one is available.
+ *
+ * Returns false if the connection went inactive (a stop message arrived
+ * while we were waiting for a buffer), in which case the caller must not
+ * write any more data to it.
+ */
+static bool
+flushBuffer(ChunkTransportState *transportStates,
+			ChunkTransportStateEntry *pEntry,
+			MotionConn *conn,
+			int16 motionId)
+{
+	int			retry = 0;
+	bool		doCheckExpiration = false;
+	bool		gotStops = false;
+
 	/* prepare this for transmit */
 
 	ic_statistics.totalCapacity += conn->capacity;
@@ -5382,20 +5468,41 @@ SendChunkUDPIFC(MotionLayerState *mlStates,
 		handleStopMsgs(transportStates, pEntry, motionId);
 		gotStops = false;
 		if (!conn->stillActive)
-			return true;
+			return false;
 	}
 
 	/* reinitialize connection */
 	conn->tupleCount = 0;
 	conn->msgSize = sizeof(conn->conn_info);
 
-	/* now we can copy the input to the new buffer */
-	memcpy(conn->pBuff + conn->msgSize, tcItem->chunk_data, tcItem->chunk_length);
-	conn->msgSize += length;
+	return true;
+}
 
-	conn->tupleCount++;
+/*
+ * SendFlushUDPIFC
+ * 		Flush any buffered chunks of a connection to the wire, so the
+ * 		caller can serialize a tuple straight into the fresh send buffer
+ * 		instead of staging it in a chunk list first.
+ *
+ * Returns true if the connection is still active and offers an empty
+ * send buffer afterwards.  A connection whose buffer holds nothing but
+ * the packet header is left alone: there is nothing to flush, and the
+ * caller's tuple will not fit an empty packet either.
+ */
+static bool
+SendFlushUDPIFC(MotionLayerState *mlStates,
+				ChunkTransportState *transportStates,
+				ChunkTransportStateEntry *pEntry,
+				MotionConn *conn,
+				int16 motionId)
+{
+	if (!conn->stillActive)
+		return false;
 
-	return true;
+	if (conn->msgSize <= sizeof(conn->conn_info))
+		return false;
+
+	return flushBuffer(transportStates, pEntry, conn, motionId);
 }
 
 /*
@@ -6102,6 +6209,8 @@ rxThreadFunc(void *arg)
 	icpkthdr   *pkt = NULL;
 	bool		skip_poll = false;
 	uint32		expected = 1;
+	uint64		busy_poll_start = 0;	/* when the current spin began (us) */
+	uint64		busy_poll_window = 0;	/* adaptive spin window (us) */
 
 	gp_set_thread_sigmasks();
 
@@ -6204,9 +6313,41 @@ rxThreadFunc(void *arg)
 
 			if (read_count < 0)
 			{
+				if (errno == EWOULDBLOCK)
+				{
+					/*
+					 * The socket ran dry.  If busy-polling is enabled and
+					 * traffic arrived recently, keep spinning on the
+					 * non-blocking recvfrom() for a while instead of going
+					 * back to sleep in poll(): on low-latency plans the next
+					 * datagram is usually microseconds away, and the
+					 * poll()-wakeup adds scheduling latency to every chunk.
+					 * The spin window shrinks every time it expires without
+					 * traffic, so an idle connection quickly falls back to
+					 * the cheap blocking path.
+					 */
+					if (busy_poll_window > 0)
+					{
+						uint64		now = getCurrentTime();
+
+						if (busy_poll_start == 0)
+							busy_poll_start = now;
+
+						if (now - busy_poll_start < busy_poll_window)
+							continue;	/* skip_poll stays true: spin */
+
+						/* window expired without traffic: shrink it */
+						busy_poll_window >>= 1;
+					}
+
+					skip_poll = false;
+					busy_poll_start = 0;
+					continue;
+				}
+
 				skip_poll = false;
 
-				if (errno == EWOULDBLOCK || errno == EINTR)
+				if (errno == EINTR)
 					continue;
 
 				write_log("Interconnect error: recvfrom (%d)", errno);
@@ -6236,6 +6377,20 @@ rxThreadFunc(void *arg)
 			 */
 			skip_poll = true;
 
+			/*
+			 * Traffic is flowing: (re)grow the adaptive busy-poll window,
+			 * up to the configured ceiling.
+			 */
+			if (gp_interconnect_busy_poll_us > 0)
+			{
+				busy_poll_window = Max(busy_poll_window * 2, 64);
+				busy_poll_window = Min(busy_poll_window,
+									   (uint64) gp_interconnect_busy_poll_us);
+				busy_poll_start = 0;
+			}
+			else
+				busy_poll_window = 0;
+
 			/* length must be >= 0 */
 			if (pkt->len < 0)
 			{
@@ -6950,3 +7105,87 @@ getActiveMotionConns(void)
 {
 	return ic_statistics.activeConnectionsNum;
 }
+
+/*
+ * ICStatsShmemSize
+ * 		Report the amount of shared memory needed for the interconnect
+ * 		statistics totals.
+ */
+Size
+ICStatsShmemSize(void)
+{
+	return MAXALIGN(sizeof(ICStatsShmemData));
+}
+
+/*
+ * ICStatsShmemInit
+ * 		Allocate and initialize the interconnect statistics totals in
+ * 		shared memory.
+ */
+void
+ICStatsShmemInit(void)
+{
+	bool		found;
+
+	ic_stats_shmem = (ICStatsShmemData *)
+		ShmemInitStruct("Interconnect Statistics",
+						ICStatsShmemSize(),
+						&found);
+
+	if (!found)
+	{
+		MemSet(ic_stats_shmem, 0, sizeof(ICStatsShmemData));
+		SpinLockInit(&ic_stats_shmem->lock);
+	}
+}
+
+/*
+ * gp_interconnect_flow_stats
+ * 		SQL-callable wrapper returning this segment's cumulative UDP
+ * 		interconnect counters as a single row.  The gp_interconnect_flows
+ * 		view unions the results from the master and every segment.
+ */
+Datum
+gp_interconnect_flow_stats(PG_FUNCTION_ARGS)
+{
+	TupleDesc	tupdesc;
+	Datum		values[12];
+	bool		nulls[12];
+	HeapTuple	tuple;
+	ICStatsShmemData stats;
+
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	if (ic_stats_shmem == NULL)
+		memset(&stats, 0, sizeof(stats));
+	else
+	{
+		SpinLockAcquire(&ic_stats_shmem->lock);
+		stats = *ic_stats_shmem;
+		SpinLockRelease(&ic_stats_shmem->lock);
+	}
+
+	MemSet(nulls, false, sizeof(nulls));
+
+	values[0] = Int64GetDatum((int64) stats.teardowns);
+	values[1] = Int64GetDatum((int64) stats.sndPktNum);
+	values[2] = Int64GetDatum((int64) stats.recvPktNum);
+	values[3] = Int64GetDatum((int64) stats.retransmits);
+	values[4] = Int64GetDatum((int64) stats.crcErrors);
+	values[5] = Int64GetDatum((int64) stats.mismatchNum);
+	values[6] = Int64GetDatum((int64) stats.disorderedPktNum);
+	values[7] = Int64GetDatum((int64) stats.duplicatedPktNum);
+	values[8] = Int64GetDatum((int64) stats.recvAckNum);
+	values[9] = Int64GetDatum((int64) stats.statusQueryMsgNum);
+	values[10] = Float8GetDatum(stats.recvQueueSizeCountingTime == 0 ? 0 :
+								(double) stats.totalRecvQueueSize /
+								(double) stats.recvQueueSizeCountingTime);
+	values[11] = Float8GetDatum(stats.capacityCountingTime == 0 ? 0 :
+								(double) stats.totalCapacity /
+								(double) stats.capacityCountingTime);
+
+	tuple = heap_form_tuple(tupdesc, values, nulls);
+
+	PG_RETURN_DATUM(HeapTupleGetDatum(tuple));
+}
@@ -126,6 +126,7 @@ struct TupleRemapper
 	int			typmodmapsize;	/* size of typmodmap */
 	TupleDesc	tupledesc;		/* current top-level tuple descriptor */
 	TupleRemapInfo **field_remapinfo;	/* current top-level remap info */
+	bool		plan_built;		/* field_remapinfo compiled for tupledesc? */
 	bool		remap_needed;	/* is remap needed */
 };
 
@@ -168,6 +169,7 @@ CreateTupleRemapper(void)
 	remapper->typmodmapsize = 0;
 	remapper->tupledesc = NULL;
 	remapper->field_remapinfo = NULL;
+	remapper->plan_built = false;
 	remapper->remap_needed = false;
 
 	return remapper;
@@ -198,18 +200,26 @@ TRCheckAndRemap(TupleRemapper *remapper, TupleDesc tupledesc, GenericTuple tuple
 	if (!remapper->remap_needed)
 		return tuple;
 
-	if (!remapper->field_remapinfo)
+	/*
+	 * Compile the remap plan for this descriptor the first time through (or
+	 * again if the descriptor changed, which the executor permits).  A NULL
+	 * plan means no field of the descriptor can contain a composite value,
+	 * so per-tuple inspection is unnecessary and tuples pass straight
+	 * through below.
+	 */
+	if (!remapper->plan_built || remapper->tupledesc != tupledesc)
 	{
-		Assert(remapper->tupledesc == NULL);
+		if (remapper->field_remapinfo != NULL)
+			pfree(remapper->field_remapinfo);
 		remapper->field_remapinfo = BuildFieldRemapInfo(tupledesc,
 														remapper->mycontext);
-		if (remapper->field_remapinfo != NULL)
-		{
-			/* Remapping is required. Save a copy of the tupledesc */
-			remapper->tupledesc = tupledesc;
-		}
+		remapper->tupledesc = tupledesc;
+		remapper->plan_built = true;
 	}
 
+	if (remapper->field_remapinfo == NULL)
+		return tuple;
+
 	return TRRemapTuple(remapper, tupledesc, remapper->field_remapinfo, tuple);
 }
 
@@ -16,6 +16,8 @@
 
 #include <math.h>
 
+#include "access/aocssegfiles.h"
+#include "access/aosegfiles.h"
 #include "access/heapam.h"
 #include "access/transam.h"
 #include "access/tupconvert.h"
@@ -27,6 +29,8 @@
 #include "catalog/namespace.h"
 #include "catalog/pg_inherits_fn.h"
 #include "catalog/pg_namespace.h"
+#include "cdb/cdbaocsam.h"
+#include "cdb/cdbappendonlyam.h"
 #include "cdb/cdbpartition.h"
 #include "cdb/cdbtm.h"
 #include "cdb/cdbvars.h"
@@ -34,6 +38,7 @@
 #include "commands/vacuum.h"
 #include "executor/executor.h"
 #include "executor/spi.h"
+#include "funcapi.h"
 #include "miscadmin.h"
 #include "nodes/nodeFuncs.h"
 #include "parser/parse_oper.h"
@@ -44,6 +49,7 @@
 #include "storage/proc.h"
 #include "storage/procarray.h"
 #include "utils/acl.h"
+#include "utils/array.h"
 #include "utils/attoptcache.h"
 #include "utils/builtins.h"
 #include "utils/datum.h"
@@ -53,6 +59,7 @@
 #include "utils/pg_rusage.h"
 #include "utils/syscache.h"
 #include "utils/tuplesort.h"
+#include "utils/snapmgr.h"
 #include "utils/tqual.h"
 
 /*
@@ -122,17 +129,18 @@ static void compute_index_stats(Relation onerel, double totalrows,
 static VacAttrStats *examine_attribute(Relation onerel, int attnum);
 static int acquire_sample_rows(Relation onerel, HeapTuple *rows,
 					int targrows, double *totalrows, double *totaldeadrows);
+static int acquire_sample_rows_ao(Relation onerel, bool *proj,
+					   HeapTuple *rows, int targrows,
+					   double *totalrows, double *totaldeadrows);
 static int acquire_sample_rows_by_query(Relation onerel, int nattrs, VacAttrStats **attrstats, HeapTuple **rows,
 										int targrows, double *totalrows, double *totaldeadrows, BlockNumber *totalpages, bool rootonly,  RowIndexes **colLargeRowIndexes /* Maintain information if the row of a column exceeds WIDTH_THRESHOLD */);
 static double random_fract(void);
 static double init_selection_state(int n);
 static double get_next_S(double t, int n, double *stateptr);
 static int	compare_rows(const void *a, const void *b);
-#if 0
 static int acquire_inherited_sample_rows(Relation onerel,
 							  HeapTuple *rows, int targrows,
 							  double *totalrows, double *totaldeadrows);
-#endif
 static void update_attstats(Oid relid, bool inh,
 				int natts, VacAttrStats **vacattrstats);
 static Datum std_fetch_func(VacAttrStatsP stats, int rownum, bool *isNull);
@@ -1171,10 +1179,11 @@ BlockSampler_Next(BlockSampler bs)
  * The returned list of tuples is in order by physical position in the table.
  * (We will rely on this later to derive correlation estimates.)
  *
- * GPDB: Not used in Greenplum currently. Instead, we acquire the sample
- * rows by issuing an SPI query, see acquire_sample_rows_by_query
+ * GPDB: In Greenplum this runs in the segments, invoked through the
+ * gp_acquire_sample_rows() function that the QD dispatches; see
+ * acquire_sample_rows_by_query for the QD side.
  */
-static int pg_attribute_unused()
+static int
 acquire_sample_rows(Relation onerel, HeapTuple *rows, int targrows,
 					double *totalrows, double *totaldeadrows)
 {
@@ -1413,6 +1422,178 @@ acquire_sample_rows(Relation onerel, HeapTuple *rows, int targrows,
 	return numrows;
 }
 
+/*
+ * acquire_sample_rows_ao -- acquire a random sample of rows from an
+ * append-only (row- or column-oriented) table
+ *
+ * This has the same API as acquire_sample_rows, except that the caller
+ * may pass a projection bitmap in 'proj' (indexed by attnum - 1) to limit
+ * which columns are fetched from a column-oriented table; pass NULL to
+ * fetch them all.  Columns outside the projection come back as NULLs.
+ *
+ * Append-only tables have no random access path comparable to the heap
+ * block sampler, so we make one streaming pass over the table and maintain
+ * the reservoir with Vitter's algorithm directly on the tuple stream.  The
+ * visibility map has already filtered out dead rows by the time tuples
+ * reach us, so the pass also yields an exact count of live rows.
+ */
+static int
+acquire_sample_rows_ao(Relation onerel, bool *proj, HeapTuple *rows,
+					   int targrows, double *totalrows, double *totaldeadrows)
+{
+	TupleDesc	tupdesc = RelationGetDescr(onerel);
+	TupleTableSlot *slot;
+	Snapshot	snapshot;
+	AppendOnlyScanDesc aoscan = NULL;
+	AOCSScanDesc aocsscan = NULL;
+	bool	   *scanproj = NULL;
+	int			numrows = 0;	/* # rows now in reservoir */
+	double		samplerows = 0; /* total # rows collected */
+	double		rowstoskip = -1;	/* -1 means not set yet */
+	double		rstate;
+
+	Assert(targrows > 0);
+	Assert(RelationIsAoRows(onerel) || RelationIsAoCols(onerel));
+
+	snapshot = GetActiveSnapshot();
+	slot = MakeSingleTupleTableSlot(tupdesc);
+
+	if (RelationIsAoRows(onerel))
+		aoscan = appendonly_beginscan(onerel, snapshot, snapshot, 0, NULL);
+	else
+	{
+		Datum	   *values;
+		bool	   *nulls;
+		int			attno;
+
+		/*
+		 * Scan only the columns the caller asked for; this is the payoff of
+		 * sampling column-oriented tables natively instead of through SQL.
+		 */
+		scanproj = (bool *) palloc0(tupdesc->natts * sizeof(bool));
+		for (attno = 0; attno < tupdesc->natts; attno++)
+		{
+			if (tupdesc->attrs[attno]->attisdropped)
+				continue;
+			scanproj[attno] = (proj == NULL || proj[attno]);
+		}
+
+		aocsscan = aocs_beginscan(onerel, snapshot, snapshot, NULL, scanproj);
+
+		/*
+		 * aocs_getnext only fills in the projected columns, so set everything
+		 * else to NULL once up front; it stays that way for the whole scan.
+		 */
+		values = slot_get_values(slot);
+		nulls = slot_get_isnull(slot);
+		for (attno = 0; attno < tupdesc->natts; attno++)
+		{
+			values[attno] = (Datum) 0;
+			nulls[attno] = true;
+		}
+	}
+
+	/* Prepare for sampling rows */
+	rstate = init_selection_state(targrows);
+
+	for (;;)
+	{
+		vacuum_delay_point();
+
+		if (aoscan != NULL)
+		{
+			if (appendonly_getnext(aoscan, ForwardScanDirection, slot) == NULL)
+				break;
+		}
+		else
+		{
+			aocs_getnext(aocsscan, ForwardScanDirection, slot);
+			if (TupIsNull(slot))
+				break;
+		}
+
+		/*
+		 * Maintain the reservoir with Vitter's algorithm, like the loop in
+		 * acquire_sample_rows does.  We only materialize the tuple as a
+		 * HeapTuple when it is actually kept in the sample.
+		 */
+		if (numrows < targrows)
+			rows[numrows++] = ExecCopySlotHeapTuple(slot);
+		else
+		{
+			if (rowstoskip < 0)
+				rowstoskip = get_next_S(samplerows, targrows, &rstate);
+
+			if (rowstoskip <= 0)
+			{
+				/*
+				 * Found a suitable tuple, so save it, replacing one old tuple
+				 * at random
+				 */
+				int			k = (int) (targrows * random_fract());
+
+				Assert(k >= 0 && k < targrows);
+				heap_freetuple(rows[k]);
+				rows[k] = ExecCopySlotHeapTuple(slot);
+			}
+
+			rowstoskip -= 1;
+		}
+
+		samplerows += 1;
+	}
+
+	if (aoscan != NULL)
+		appendonly_endscan(aoscan);
+	else
+		aocs_endscan(aocsscan);
+	if (scanproj != NULL)
+		pfree(scanproj);
+	ExecDropSingleTupleTableSlot(slot);
+
+	/*
+	 * We made a full pass over the table, so we saw every live row; dead rows
+	 * were filtered out by the visibility map before reaching us.
+	 */
+	*totalrows = samplerows;
+	*totaldeadrows = 0;
+
+	ereport(elevel,
+			(errmsg("\"%s\": scanned %.0f rows; "
+					"%d rows in sample, %.0f estimated total rows",
+					RelationGetRelationName(onerel),
+					samplerows, numrows, *totalrows)));
+
+	return numrows;
+}
+
+/*
+ * gp_acquire_sample_rows_internal -- acquire sample rows from any supported
+ * relation kind
+ *
+ * This is the segment-side entry point used by the gp_acquire_sample_rows()
+ * function (analyzefuncs.c), which the QD dispatches in
+ * acquire_sample_rows_by_query.  It routes to the appropriate low-level
+ * sampler: the inheritance-tree walker for partition roots, the streaming
+ * reservoir for append-only tables, and the block sampler for heap tables.
+ */
+int
+gp_acquire_sample_rows_internal(Relation onerel, bool inherited, bool *proj,
+								HeapTuple *rows, int targrows,
+								double *totalrows, double *totaldeadrows)
+{
+	if (inherited)
+		return acquire_inherited_sample_rows(onerel, rows, targrows,
+											 totalrows, totaldeadrows);
+
+	if (RelationIsAoRows(onerel) || RelationIsAoCols(onerel))
+		return acquire_sample_rows_ao(onerel, proj, rows, targrows,
+									  totalrows, totaldeadrows);
+
+	return acquire_sample_rows(onerel, rows, targrows,
+							   totalrows, totaldeadrows);
+}
+
 /* Select a random value R uniformly distributed in (0 - 1) */
 static double
 random_fract(void)
@@ -1550,7 +1731,9 @@ compare_rows(const void *a, const void *b)
 
 /*
  * This performs the same job as acquire_sample_rows() in PostgreSQL, but
- * uses an SQL query to get the rows instead of a low-level block sampler.
+ * runs on the QD and collects the sample from all segments, by dispatching
+ * an SQL query that invokes gp_acquire_sample_rows() (or, for external
+ * tables and external partitions, by filtering a plain scan with random()).
  *
  * Unlike acquire_sample_rows(), this allocates the rows array for you,
  * and returns it in *rows. The reason is that this might return a few rows
@@ -1693,13 +1876,50 @@ acquire_sample_rows_by_query(Relation onerel, int nattrs, VacAttrStats **attrsta
 		appendStringInfo(&str, " %s limit %lu ",
 						 thresholdStr.data, (unsigned long) targrows);
 	}
-	else
+	else if (nattrs == 0 || RelationIsExternal(onerel))
 	{
 		appendStringInfo(&str, "select %s from %s.%s as Ta %s limit %lu ",
 						 columnStr.data,
 						 quote_identifier(schemaName),
 						 quote_identifier(tableName), thresholdStr.data, (unsigned long) targrows);
 	}
+	else
+	{
+		/*
+		 * Sample with gp_acquire_sample_rows(), which runs on all segments
+		 * and maintains a reservoir sample in a single streaming pass over
+		 * the table (using a random block sampler on heap tables), instead
+		 * of scanning the whole table through SQL and filtering with
+		 * random().  Each segment returns at most targrows rows, so the cost
+		 * is proportional to the sample size, not the table size.
+		 */
+		StringInfoData attnumStr;
+		StringInfoData coldefStr;
+
+		initStringInfo(&attnumStr);
+		initStringInfo(&coldefStr);
+		for (i = 0; i < nattrs; i++)
+		{
+			Form_pg_attribute attr = attrstats[i]->attr;
+
+			appendStringInfo(&attnumStr, "%s%d",
+							 (i == 0) ? "" : ",",
+							 attrstats[i]->tupattnum);
+			appendStringInfo(&coldefStr, "%s%s %s",
+							 (i == 0) ? "" : ", ",
+							 quote_identifier(NameStr(attr->attname)),
+							 format_type_with_typemod(attr->atttypid,
+													  attr->atttypmod));
+		}
+
+		appendStringInfo(&str, "select %s from pg_catalog.gp_acquire_sample_rows(%u, %d, '{%s}'::pg_catalog.int2[]) as Ta (%s) limit %lu ",
+						 columnStr.data,
+						 RelationGetRelid(onerel),
+						 targrows,
+						 attnumStr.data,
+						 coldefStr.data,
+						 (unsigned long) targrows);
+	}
 
 	oldcxt = CurrentMemoryContext;
 
@@ -1972,17 +2192,17 @@ analyzeEstimateIndexpages(Relation onerel, Relation indrel, BlockNumber *indexPa
 	return;
 }
 
-/*
- * GPDB: Not used in Greenplum currently. Instead, we acquire the sample
- * rows by issuing an SPI query, see acquire_sample_rows_by_query
- */
-#if 0
 /*
  * acquire_inherited_sample_rows -- acquire sample rows from inheritance tree
  *
  * This has the same API as acquire_sample_rows, except that rows are
  * collected from all inheritance children as well as the specified table.
  * We fail and return zero if there are no inheritance children.
+ *
+ * GPDB: This runs in the segments, like acquire_sample_rows. Children
+ * can be heap, append-only row- or column-oriented tables; external
+ * partitions are skipped (the QD samples those through an SQL query
+ * instead, see acquire_sample_rows_by_query).
  */
 static int
 acquire_inherited_sample_rows(Relation onerel, HeapTuple *rows, int targrows,
@@ -2043,8 +2263,33 @@ acquire_inherited_sample_rows(Relation onerel, HeapTuple *rows, int targrows,
 			continue;
 		}
 
+		/* Skip external partitions; they cannot be sampled here */
+		if (RelationIsExternal(childrel))
+		{
+			Assert(childrel != onerel);
+			heap_close(childrel, AccessShareLock);
+			continue;
+		}
+
 		rels[nrels] = childrel;
-		relblocks[nrels] = (double) RelationGetNumberOfBlocks(childrel);
+		if (RelationIsAoRows(childrel))
+		{
+			FileSegTotals *fstotal;
+
+			fstotal = GetSegFilesTotals(childrel, GetActiveSnapshot());
+			relblocks[nrels] = Max(1.0, ceil((double) fstotal->totalbytes / BLCKSZ));
+			pfree(fstotal);
+		}
+		else if (RelationIsAoCols(childrel))
+		{
+			FileSegTotals *fstotal;
+
+			fstotal = GetAOCSSSegFilesTotals(childrel, GetActiveSnapshot());
+			relblocks[nrels] = Max(1.0, ceil((double) fstotal->totalbytes / BLCKSZ));
+			pfree(fstotal);
+		}
+		else
+			relblocks[nrels] = (double) RelationGetNumberOfBlocks(childrel);
 		totalblocks += relblocks[nrels];
 		nrels++;
 	}
@@ -2077,16 +2322,24 @@ acquire_inherited_sample_rows(Relation onerel, HeapTuple *rows, int targrows,
 							tdrows;
 
 				/* Fetch a random sample of the child's rows */
-				childrows = acquire_sample_rows(childrel,
-												rows + numrows,
-												childtargrows,
-												&trows,
-												&tdrows);
+				if (RelationIsAoRows(childrel) || RelationIsAoCols(childrel))
+					childrows = acquire_sample_rows_ao(childrel,
+													   NULL,
+													   rows + numrows,
+													   childtargrows,
+													   &trows,
+													   &tdrows);
+				else
+					childrows = acquire_sample_rows(childrel,
+													rows + numrows,
+													childtargrows,
+													&trows,
+													&tdrows);
 
 				/* We may need to convert from child's rowtype to parent's */
 				if (childrows > 0 &&
 					!equalTupleDescs(RelationGetDescr(childrel),
-									 RelationGetDescr(onerel)))
+									 RelationGetDescr(onerel), false))
 				{
 					TupleConversionMap *map;
 
@@ -2125,7 +2378,6 @@ acquire_inherited_sample_rows(Relation onerel, HeapTuple *rows, int targrows,
 
 	return numrows;
 }
-#endif
 
 /*
  *	update_attstats() -- update attribute statistics for one relation
@@ -1,11 +1,18 @@
 #include "postgres.h"
 
 #include "access/aocssegfiles.h"
+#include "access/heapam.h"
 #include "catalog/pg_appendonly_fn.h"
+#include "catalog/pg_type.h"
 #include "cdb/cdbappendonlyam.h"
 #include "cdb/cdbvars.h"
+#include "commands/vacuum.h"
+#include "funcapi.h"
 #include "storage/bufmgr.h"
+#include "utils/acl.h"
+#include "utils/array.h"
 #include "utils/builtins.h"
+#include "utils/lsyscache.h"
 #include "utils/rel.h"
 #include "miscadmin.h"
 
@@ -361,3 +368,161 @@ gp_statistics_estimate_reltuples_relpages_oid(PG_FUNCTION_ARGS)
 
 	PG_RETURN_ARRAYTYPE_P(result);
 }
+
+/**
+ * Per-query state of gp_acquire_sample_rows(), kept across SRF calls.
+ */
+typedef struct
+{
+	HeapTuple  *sample;		/* sampled rows, projected to the output columns */
+	int			numrows;	/* number of rows in sample */
+} gp_acquire_sample_rows_context;
+
+/**
+ * gp_acquire_sample_rows(regclass, targrows, attnums) - sample a table natively
+ *
+ * Executes on all segments; each segment samples its own portion of the
+ * table with the low-level samplers in analyze.c and returns at most
+ * 'targrows' rows, projected down to the requested attribute numbers. The QD
+ * dispatches this from acquire_sample_rows_by_query, so that ANALYZE cost is
+ * proportional to the sample size rather than the table size. If the given
+ * relation is a partition root, the sample is taken over its whole
+ * inheritance tree.
+ *
+ * This returns SETOF record, so the caller must supply a column definition
+ * list matching the requested attributes.
+ */
+Datum
+gp_acquire_sample_rows(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+	gp_acquire_sample_rows_context *ctx;
+
+	if (SRF_IS_FIRSTCALL())
+	{
+		MemoryContext oldcontext;
+		Oid			relOid = PG_GETARG_OID(0);
+		int32		targrows = PG_GETARG_INT32(1);
+		ArrayType  *attarray = PG_GETARG_ARRAYTYPE_P(2);
+		Relation	onerel;
+		TupleDesc	relDesc;
+		TupleDesc	outDesc;
+		Datum	   *attdatums;
+		int			nattrs;
+		int16	   *attnums;
+		bool	   *proj;
+		HeapTuple  *rows;
+		double		totalrows;
+		double		totaldeadrows;
+		bool		inherited;
+		int			numrows;
+		Datum	   *outvals;
+		bool	   *outnulls;
+		int			i;
+		int			j;
+
+		funcctx = SRF_FIRSTCALL_INIT();
+		oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+		if (targrows < 1)
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("number of sample rows must be at least 1")));
+
+		/*
+		 * The QD dispatches this in the session of the user running ANALYZE,
+		 * so apply the same permission check that ANALYZE itself does.
+		 */
+		if (!superuser() && !pg_class_ownercheck(relOid, GetUserId()))
+			aclcheck_error(ACLCHECK_NOT_OWNER, ACL_KIND_CLASS,
+						   get_rel_name(relOid));
+
+		onerel = heap_open(relOid, AccessShareLock);
+
+		if (onerel->rd_rel->relkind != RELKIND_RELATION ||
+			RelationIsExternal(onerel))
+			ereport(ERROR,
+					(errcode(ERRCODE_WRONG_OBJECT_TYPE),
+					 errmsg("\"%s\" is not a heap or append-only table",
+							RelationGetRelationName(onerel))));
+
+		relDesc = RelationGetDescr(onerel);
+
+		deconstruct_array(attarray, INT2OID, 2, true, 's',
+						  &attdatums, NULL, &nattrs);
+		if (nattrs < 1)
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("at least one attribute must be requested")));
+
+		attnums = (int16 *) palloc(nattrs * sizeof(int16));
+		proj = (bool *) palloc0(relDesc->natts * sizeof(bool));
+		for (i = 0; i < nattrs; i++)
+		{
+			attnums[i] = DatumGetInt16(attdatums[i]);
+			if (attnums[i] < 1 || attnums[i] > relDesc->natts ||
+				relDesc->attrs[attnums[i] - 1]->attisdropped)
+				ereport(ERROR,
+						(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+						 errmsg("invalid attribute number %d",
+								(int) attnums[i])));
+			proj[attnums[i] - 1] = true;
+		}
+
+		/* For a partition root, sample the whole inheritance tree */
+		inherited = onerel->rd_rel->relhassubclass;
+
+		rows = (HeapTuple *) palloc(targrows * sizeof(HeapTuple));
+		numrows = gp_acquire_sample_rows_internal(onerel, inherited, proj,
+												  rows, targrows,
+												  &totalrows, &totaldeadrows);
+
+		/* Build the output row type from the requested attributes */
+		outDesc = CreateTemplateTupleDesc(nattrs, false);
+		for (i = 0; i < nattrs; i++)
+		{
+			Form_pg_attribute att = relDesc->attrs[attnums[i] - 1];
+
+			TupleDescInitEntry(outDesc, i + 1, NameStr(att->attname),
+							   att->atttypid, att->atttypmod, 0);
+		}
+		funcctx->tuple_desc = BlessTupleDesc(outDesc);
+
+		/* Project the sampled rows down to the requested attributes */
+		outvals = (Datum *) palloc(nattrs * sizeof(Datum));
+		outnulls = (bool *) palloc(nattrs * sizeof(bool));
+		ctx = (gp_acquire_sample_rows_context *)
+			palloc(sizeof(gp_acquire_sample_rows_context));
+		ctx->sample = (HeapTuple *) palloc(numrows * sizeof(HeapTuple));
+		ctx->numrows = numrows;
+		for (j = 0; j < numrows; j++)
+		{
+			for (i = 0; i < nattrs; i++)
+				outvals[i] = heap_getattr(rows[j], attnums[i], relDesc,
+										  &outnulls[i]);
+			ctx->sample[j] = heap_form_tuple(outDesc, outvals, outnulls);
+			heap_freetuple(rows[j]);
+		}
+		pfree(rows);
+
+		/*
+		 * Keep the lock until end of transaction; the sampled datums may
+		 * still carry references to the relation's toast table.
+		 */
+		heap_close(onerel, NoLock);
+
+		funcctx->user_fctx = ctx;
+		funcctx->max_calls = numrows;
+
+		MemoryContextSwitchTo(oldcontext);
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+	ctx = (gp_acquire_sample_rows_context *) funcctx->user_fctx;
+
+	if (funcctx->call_cntr < funcctx->max_calls)
+		SRF_RETURN_NEXT(funcctx,
+						HeapTupleGetDatum(ctx->sample[funcctx->call_cntr]));
+
+	SRF_RETURN_DONE(funcctx);
+}
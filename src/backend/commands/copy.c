@@ -6369,12 +6369,51 @@ CopyReadAttributesCSV(CopyState cstate, bool *nulls, int *attr_offsets,
 		{
 			char		c;
 
-			/* Not in quote */
+			/*
+			 * Not in quote.
+			 *
+			 * Rather than classifying one byte at a time, memchr to the next
+			 * delimiter or quote (libc scans word- or vector-wide) and move
+			 * the run of ordinary bytes in between with one bulk append.
+			 */
 			for (;;)
 			{
+				const char *base;
+				const char *stop;
+				int			remain;
+				int			run;
+
 				end_cursor = cstate->line_buf.cursor;
-				if (cstate->line_buf.cursor >= line_len - 1)
+				remain = (line_len - 1) - cstate->line_buf.cursor;
+				if (remain <= 0)
 					goto endfield;
+
+				base = cstate->line_buf.data + cstate->line_buf.cursor;
+				stop = memchr(base, delimc, remain);
+				{
+					const char *q = memchr(base, quotec,
+										   stop != NULL ? (size_t) (stop - base) : remain);
+
+					if (q != NULL)
+						stop = q;
+				}
+
+				run = (stop != NULL ? stop - base : remain);
+				if (run > 0)
+				{
+					appendBinaryStringInfo(&cstate->attribute_buf, base, run);
+					cstate->attribute_buf.cursor += run;
+					cstate->line_buf.cursor += run;
+				}
+
+				if (stop == NULL)
+				{
+					/* consumed the rest of the line */
+					end_cursor = cstate->line_buf.cursor;
+					goto endfield;
+				}
+
+				end_cursor = cstate->line_buf.cursor;
 				c = cstate->line_buf.data[cstate->line_buf.cursor++];
 				/* unquoted field delimiter */
 				if (c == delimc)
@@ -6383,25 +6422,49 @@ CopyReadAttributesCSV(CopyState cstate, bool *nulls, int *attr_offsets,
 					goto endfield;
 				}
 				/* start of quoted field (or part of field) */
-				if (c == quotec)
-				{
-					saw_quote = true;
-					break;
-				}
-				/* Add c to output string */
-				appendStringInfoCharMacro(&cstate->attribute_buf, c);
-				cstate->attribute_buf.cursor++;
+				Assert(c == quotec);
+				saw_quote = true;
+				break;
 			}
 
-			/* In quote */
+			/* In quote: same memchr bulk-copy scheme as above */
 			for (;;)
 			{
+				const char *base;
+				const char *stop;
+				int			remain;
+				int			run;
+
 				end_cursor = cstate->line_buf.cursor;
-				if (cstate->line_buf.cursor >= line_len - 1)
+				remain = (line_len - 1) - cstate->line_buf.cursor;
+				if (remain <= 0)
 					ereport(ERROR,
 							(errcode(ERRCODE_BAD_COPY_FILE_FORMAT),
 							 errmsg("unterminated CSV quoted field")));
 
+				base = cstate->line_buf.data + cstate->line_buf.cursor;
+				stop = memchr(base, escapec, remain);
+				if (quotec != escapec)
+				{
+					const char *q = memchr(base, quotec,
+										   stop != NULL ? (size_t) (stop - base) : remain);
+
+					if (q != NULL)
+						stop = q;
+				}
+
+				run = (stop != NULL ? stop - base : remain);
+				if (run > 0)
+				{
+					appendBinaryStringInfo(&cstate->attribute_buf, base, run);
+					cstate->attribute_buf.cursor += run;
+					cstate->line_buf.cursor += run;
+				}
+
+				if (stop == NULL)
+					continue;	/* ran off the line; next pass reports it */
+
+				end_cursor = cstate->line_buf.cursor;
 				c = cstate->line_buf.data[cstate->line_buf.cursor++];
 
 				/* escape within a quoted field */
@@ -7410,15 +7473,46 @@ scanCSVLine(CopyState cstate, const char *s, char eol, char escapec, char quotec
 	}
 	else
 		/* safe to scroll byte by byte */
-	{	
-		for ( ; *s != eol && s < end ; s++)
+	{
+		/*
+		 * The quote/escape state machine only changes at eol, quotec and
+		 * escapec bytes; everything in between is plain data. Instead of
+		 * examining every byte we memchr() to the next interesting byte
+		 * (memchr is typically word-at-a-time or SIMD in libc) and apply
+		 * the per-byte rules only there. This is where CSV COPY FROM
+		 * spends its scanning time on wide data lines.
+		 */
+		while (s < end)
 		{
-			if (cstate->in_quote && *s == escapec)
+			const char *stop = memchr(s, eol, end - s);
+			size_t		span = (stop != NULL ? stop : end) - s;
+			const char *special = memchr(s, quotec, span);
+			const char *esc = memchr(s, escapec, special != NULL ? (size_t) (special - s) : span);
+
+			if (esc != NULL)
+				special = esc;
+
+			if (special == NULL)
+			{
+				/* only ordinary bytes up to the eol (or buffer end) */
+				if (span > 0)
+					cstate->last_was_esc = false;
+				s = (stop != NULL) ? stop : end;
+				break;
+			}
+
+			/* ordinary bytes skipped before the special one clear the flag */
+			if (special > s)
+				cstate->last_was_esc = false;
+
+			if (cstate->in_quote && *special == escapec)
 				cstate->last_was_esc = !cstate->last_was_esc;
-			if (*s == quotec && !cstate->last_was_esc)
+			if (*special == quotec && !cstate->last_was_esc)
 				cstate->in_quote = !cstate->in_quote;
-			if (*s != escapec)
+			if (*special != escapec)
 				cstate->last_was_esc = false;
+
+			s = special + 1;
 		}
 	}
 
@@ -781,7 +781,6 @@ show_dispatch_info(Slice *slice, ExplainState *es)
 		{
 			if (slice->directDispatch.isDirectDispatch)
 			{
-				Assert(list_length(slice->directDispatch.contentIds) == 1);
 				segments = list_length(slice->directDispatch.contentIds);
 			}
 			else
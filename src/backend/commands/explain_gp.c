@@ -113,6 +113,10 @@ typedef struct CdbExplain_StatInst
 	ExplainSortMethod sortMethod;	/* Type of sort */
 	ExplainSortSpaceType sortSpaceType; /* Sort space type */
 	long		sortSpaceUsed;	/* Memory / Disk used by sort(KBytes) */
+	double		spillBytesWritten;	/* workfile bytes written (incl. children) */
+	double		spillBytesRead; /* workfile bytes read (incl. children) */
+	double		spillFiles;		/* workfiles created (incl. children) */
+	double		spillTime;		/* seconds spent in workfile I/O */
 	int			bnotes;			/* Offset to beginning of node's extra text */
 	int			enotes;			/* Offset to end of node's extra text */
 } CdbExplain_StatInst;
@@ -183,6 +187,12 @@ typedef struct CdbExplain_NodeSummary
 	/* Summary of space used by sort */
 	CdbExplain_Agg sortSpaceUsed[NUM_SORT_SPACE_TYPE][NUM_SORT_METHOD];
 
+	/* Workfile I/O performed by the node and its children */
+	CdbExplain_Agg spillBytesWritten;
+	CdbExplain_Agg spillBytesRead;
+	CdbExplain_Agg spillFiles;
+	CdbExplain_Agg spillTime;
+
 	/* insts array info */
 	int			segindex0;		/* segment id of insts[0] */
 	int			ninst;			/* num of StatInst entries in inst array */
@@ -323,8 +333,7 @@ typedef struct CdbExplain_LocalStatCtx
 } CdbExplain_LocalStatCtx;
 
 
-static void
-cdbexplain_showExecStatsEnd(struct PlannedStmt *stmt,
+void cdbexplain_showExecStatsEnd(struct PlannedStmt *stmt,
 							struct CdbExplain_ShowStatCtx  *showstatctx,
                             struct EState                  *estate,
 							ExplainState *es);
@@ -982,6 +991,10 @@ cdbexplain_collectStatsFromNode(PlanState *planstate, CdbExplain_SendStatCtx *ct
 	si->sortMethod = String2ExplainSortMethod(instr->sortMethod);
 	si->sortSpaceType = String2ExplainSortSpaceType(instr->sortSpaceType, si->sortMethod);
 	si->sortSpaceUsed = instr->sortSpaceUsed;
+	si->spillBytesWritten = (double) instr->wfusage.bytes_written;
+	si->spillBytesRead = (double) instr->wfusage.bytes_read;
+	si->spillFiles = (double) instr->wfusage.files_created;
+	si->spillTime = INSTR_TIME_GET_DOUBLE(instr->wfusage.io_time);
 }								/* cdbexplain_collectStatsFromNode */
 
 
@@ -1109,6 +1122,10 @@ cdbexplain_depositStatsToNode(PlanState *planstate, CdbExplain_RecvStatCtx *ctx)
 	CdbExplain_DepStatAcc peakMemBalance;
 	CdbExplain_DepStatAcc totalPartTableScanned;
 	CdbExplain_DepStatAcc sortSpaceUsed[NUM_SORT_SPACE_TYPE][NUM_SORT_METHOD];
+	CdbExplain_DepStatAcc spillBytesWritten;
+	CdbExplain_DepStatAcc spillBytesRead;
+	CdbExplain_DepStatAcc spillFiles;
+	CdbExplain_DepStatAcc spillTime;
 	int			imsgptr;
 	int			nInst;
 
@@ -1133,6 +1150,10 @@ cdbexplain_depositStatsToNode(PlanState *planstate, CdbExplain_RecvStatCtx *ctx)
 	cdbexplain_depStatAcc_init0(&totalWorkfileCreated);
 	cdbexplain_depStatAcc_init0(&peakMemBalance);
 	cdbexplain_depStatAcc_init0(&totalPartTableScanned);
+	cdbexplain_depStatAcc_init0(&spillBytesWritten);
+	cdbexplain_depStatAcc_init0(&spillBytesRead);
+	cdbexplain_depStatAcc_init0(&spillFiles);
+	cdbexplain_depStatAcc_init0(&spillTime);
 	for (int idx = 0; idx < NUM_SORT_METHOD; ++idx)
 	{
 		cdbexplain_depStatAcc_init0(&sortSpaceUsed[MEMORY_SORT_SPACE_TYPE - 1][idx]);
@@ -1184,6 +1205,10 @@ cdbexplain_depositStatsToNode(PlanState *planstate, CdbExplain_RecvStatCtx *ctx)
 		cdbexplain_depStatAcc_upd(&totalWorkfileCreated, (rsi->workfileCreated ? 1 : 0), rsh, rsi, nsi);
 		cdbexplain_depStatAcc_upd(&peakMemBalance, rsi->peakMemBalance, rsh, rsi, nsi);
 		cdbexplain_depStatAcc_upd(&totalPartTableScanned, rsi->numPartScanned, rsh, rsi, nsi);
+		cdbexplain_depStatAcc_upd(&spillBytesWritten, rsi->spillBytesWritten, rsh, rsi, nsi);
+		cdbexplain_depStatAcc_upd(&spillBytesRead, rsi->spillBytesRead, rsh, rsi, nsi);
+		cdbexplain_depStatAcc_upd(&spillFiles, rsi->spillFiles, rsh, rsi, nsi);
+		cdbexplain_depStatAcc_upd(&spillTime, rsi->spillTime, rsh, rsi, nsi);
 		if (rsi->sortMethod < NUM_SORT_METHOD && rsi->sortMethod != UNINITIALIZED_SORT && rsi->sortSpaceType != UNINITIALIZED_SORT_SPACE_TYPE)
 		{
 			Assert(rsi->sortSpaceType <= NUM_SORT_SPACE_TYPE);
@@ -1204,6 +1229,10 @@ cdbexplain_depositStatsToNode(PlanState *planstate, CdbExplain_RecvStatCtx *ctx)
 	ns->totalWorkfileCreated = totalWorkfileCreated.agg;
 	ns->peakMemBalance = peakMemBalance.agg;
 	ns->totalPartTableScanned = totalPartTableScanned.agg;
+	ns->spillBytesWritten = spillBytesWritten.agg;
+	ns->spillBytesRead = spillBytesRead.agg;
+	ns->spillFiles = spillFiles.agg;
+	ns->spillTime = spillTime.agg;
 	for (int idx = 0; idx < NUM_SORT_METHOD; ++idx)
 	{
 		ns->sortSpaceUsed[MEMORY_SORT_SPACE_TYPE - 1][idx] = sortSpaceUsed[MEMORY_SORT_SPACE_TYPE - 1][idx].agg;
@@ -1626,6 +1655,36 @@ cdbexplain_showExecStats(struct PlanState *planstate, ExplainState *es)
 		}
 	}
 
+	/*
+	 * Workfile I/O performed by this node, including its children: bytes
+	 * written and read across all workers, and the busiest worker's share.
+	 */
+	if (es->analyze && es->verbose &&
+		ns->spillBytesWritten.vsum + ns->spillBytesRead.vsum > 0)
+	{
+		if (es->format == EXPLAIN_FORMAT_TEXT)
+		{
+			appendStringInfoSpaces(es->str, es->indent * 2);
+			appendStringInfo(es->str,
+							 "Workfile I/O: %ldkB written, %ldkB read, %.0f file(s)",
+							 (long) kb(ns->spillBytesWritten.vsum),
+							 (long) kb(ns->spillBytesRead.vsum),
+							 ns->spillFiles.vsum);
+			if (ns->spillTime.vmax > 0)
+				appendStringInfo(es->str, "  Max I/O time: %.3f ms (segment %d)",
+								 1000.0 * ns->spillTime.vmax,
+								 ns->spillTime.imax);
+			appendStringInfoChar(es->str, '\n');
+		}
+		else
+		{
+			ExplainPropertyLong("Workfile Bytes Written", (long) ns->spillBytesWritten.vsum, es);
+			ExplainPropertyLong("Workfile Bytes Read", (long) ns->spillBytesRead.vsum, es);
+			ExplainPropertyLong("Workfiles Created", (long) ns->spillFiles.vsum, es);
+			ExplainPropertyFloat("Workfile Max I/O Time", 1000.0 * ns->spillTime.vmax, 3, es);
+		}
+	}
+
 	if (es->verbose && EXPLAIN_MEMORY_VERBOSITY_SUPPRESS < explain_memory_verbosity)
 	{
 		/*
@@ -1859,7 +1918,7 @@ cdbexplain_showExecStats(struct PlanState *planstate, ExplainState *es)
  * This doesn't free the CdbExplain_ShowStatCtx object or buffers, because
  * they will be free'd shortly by the end of statement anyway.
  */
-static void
+void
 cdbexplain_showExecStatsEnd(struct PlannedStmt *stmt,
 							struct CdbExplain_ShowStatCtx *showstatctx,
 							struct EState *estate,
@@ -1875,10 +1934,10 @@ cdbexplain_showExecStatsEnd(struct PlannedStmt *stmt,
 	char		segbuf[50];
 
 	/*
-	 * Summary by slice
-	 *
-	 * GPDB_90_MERGE_FIXME: Refactor the Slice statistics printing such that
-	 * we can use it in non-TEXT format output.
+	 * Summary by slice.  The TEXT format keeps its compact hand-built
+	 * layout; other formats emit one group per slice, so that a
+	 * machine-readable plan (e.g. auto_explain logging in JSON format)
+	 * carries the per-slice statistics along with it.
 	 */
 	if (es->format == EXPLAIN_FORMAT_TEXT)
 	{
@@ -2091,6 +2150,101 @@ cdbexplain_showExecStatsEnd(struct PlannedStmt *stmt,
 
 		ExplainCloseGroup("Slice statistics", "Slice statistics", true, es);
 	}
+	else if (showstatctx->nslice > 0)
+	{
+		ExplainOpenGroup("Slice statistics", "Slice statistics", false, es);
+
+		for (sliceIndex = 0; sliceIndex < showstatctx->nslice; sliceIndex++)
+		{
+			CdbExplain_SliceSummary *ss = &showstatctx->slices[sliceIndex];
+			CdbExplain_DispatchSummary *ds = &ss->dispatchSummary;
+
+			ExplainOpenGroup("Slice", NULL, true, es);
+			ExplainPropertyInteger("Slice ID", sliceIndex, es);
+
+			/* Worker counts, shown only when some workers didn't finish OK */
+			slice = getCurrentSlice(estate, sliceIndex);
+			if (slice &&
+				slice->numGangMembersToBeActive > 0 &&
+				slice->numGangMembersToBeActive != ss->dispatchSummary.nOk)
+			{
+				int			nNotDispatched = slice->numGangMembersToBeActive - ds->nResult + ds->nNotDispatched;
+
+				if (ds->nError > 0)
+					ExplainPropertyInteger("Workers Errored", ds->nError, es);
+				if (ds->nCanceled > 0)
+					ExplainPropertyInteger("Workers Canceled", ds->nCanceled, es);
+				if (nNotDispatched > 0)
+					ExplainPropertyInteger("Workers Not Dispatched", nNotDispatched, es);
+				if (ds->nIgnorableError > 0)
+					ExplainPropertyInteger("Workers Aborted", ds->nIgnorableError, es);
+				if (ds->nOk > 0)
+					ExplainPropertyInteger("Workers Ok", ds->nOk, es);
+			}
+
+			/* Executor memory high-water mark, in bytes */
+			if (ss->peakmemused.vcnt > 0)
+			{
+				ExplainPropertyLong("Executor Memory", (long) ss->peakmemused.vmax, es);
+				if (ss->peakmemused.vcnt > 1)
+				{
+					ExplainPropertyFloat("Executor Memory Average",
+										 cdbexplain_agg_avg(&ss->peakmemused), 0, es);
+					ExplainPropertyInteger("Executor Memory Workers", ss->peakmemused.vcnt, es);
+				}
+				if (ss->peakmemused.imax >= 0)
+					ExplainPropertyInteger("Executor Memory Max Segment", ss->peakmemused.imax, es);
+			}
+
+			if (EXPLAIN_MEMORY_VERBOSITY_SUPPRESS < explain_memory_verbosity)
+			{
+				/* Memory accounting global peak memory usage */
+				double		kilobytes = ss->memory_accounting_global_peak.vmax;
+				int			workers = 1;
+
+				if (ss->memory_accounting_global_peak.vcnt > 0)
+					ExplainPropertyLong("Peak Memory", (long) ss->memory_accounting_global_peak.vmax, es);
+				if (ss->memory_accounting_global_peak.vcnt > 1)
+				{
+					kilobytes = cdbexplain_agg_avg(&ss->memory_accounting_global_peak);
+					workers = ss->memory_accounting_global_peak.vcnt;
+					ExplainPropertyFloat("Peak Memory Average", kilobytes, 0, es);
+					ExplainPropertyInteger("Peak Memory Workers", workers, es);
+				}
+
+				kilobytes = floor((kilobytes + 1023.0) / 1024.0);
+				total_memory_across_slices += (kilobytes * workers);
+
+				/* Vmem reserved by QEs */
+				if (ss->vmem_reserved.vcnt > 0)
+				{
+					ExplainPropertyLong("Vmem Reserved", (long) ss->vmem_reserved.vmax, es);
+					if (ss->vmem_reserved.vcnt > 1)
+					{
+						ExplainPropertyFloat("Vmem Reserved Average",
+											 cdbexplain_agg_avg(&ss->vmem_reserved), 0, es);
+						ExplainPropertyInteger("Vmem Reserved Workers", ss->vmem_reserved.vcnt, es);
+					}
+				}
+			}
+
+			/* Work_mem used/wanted (max over all nodes and workers of slice) */
+			if (ss->workmemused_max + ss->workmemwanted_max > 0)
+			{
+				ExplainPropertyLong("Work Memory Used", (long) ss->workmemused_max, es);
+				if (ss->workmemwanted_max > 0)
+					ExplainPropertyLong("Work Memory Wanted", (long) ss->workmemwanted_max, es);
+			}
+
+			ExplainCloseGroup("Slice", NULL, true, es);
+		}
+
+		ExplainCloseGroup("Slice statistics", "Slice statistics", false, es);
+
+		if (total_memory_across_slices > 0)
+			ExplainPropertyFloat("Total Memory Used Across Slices",
+								 total_memory_across_slices, 0, es);
+	}
 
 	if (!IsResManagerMemoryPolicyNone())
 	{
@@ -5891,9 +5891,10 @@ ATRewriteTable(AlteredTableInfo *tab, Oid OIDNewHeap)
 			 * old relation so we are guaranteed to not drop the hash
 			 * entry from under any concurrent operation.
 			 */
-			LWLockAcquire(AOSegFileLock, LW_EXCLUSIVE);
+			LWLockAcquire(AORelSegFilePartitionLock(RelationGetRelid(oldrel)),
+						  LW_EXCLUSIVE);
 			AORelRemoveHashEntry(RelationGetRelid(oldrel));
-			LWLockRelease(AOSegFileLock);
+			LWLockRelease(AORelSegFilePartitionLock(RelationGetRelid(oldrel)));
 		}
 		else
 		{
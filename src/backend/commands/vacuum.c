@@ -803,6 +803,26 @@ vacuumStatement_Relation(VacuumStmt *vacstmt, Oid relid,
 				PushActiveSnapshot(GetTransactionSnapshot());
 				onerel = try_relation_open(relid, lmode, false /* dontwait */);
 
+				/*
+				 * Incremental compaction: a lazy vacuum stops scheduling
+				 * further compaction rounds for this relation once the
+				 * per-run segfile budget is used up. The remaining bloated
+				 * segfiles are picked up by the next vacuum run, since
+				 * SetSegnoForCompaction compacts the most bloated ones
+				 * first. A full vacuum always reclaims everything.
+				 */
+				if (gp_appendonly_compaction_segfile_limit > 0 &&
+					!(vacstmt->options & VACOPT_FULL) &&
+					list_length(compactedSegmentFileList) >=
+					gp_appendonly_compaction_segfile_limit)
+				{
+					elogif(Debug_appendonly_print_compaction, LOG,
+						   "Stopping compaction of relation %d after %d "
+						   "segment files (gp_appendonly_compaction_segfile_limit)",
+						   relid, list_length(compactedSegmentFileList));
+					break;
+				}
+
 				/* Chose a source and destination segfile for compaction. */
 				if (!vacuum_assign_compaction_segno(onerel,
 													compactedSegmentFileList,
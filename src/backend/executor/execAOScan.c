@@ -14,11 +14,121 @@
  */
 #include "postgres.h"
 
+#include "access/skey.h"
+#include "catalog/pg_am.h"
+#include "commands/defrem.h"
 #include "executor/executor.h"
 #include "nodes/execnodes.h"
+#include "nodes/nodeFuncs.h"
 #include "cdb/cdbappendonlyam.h"
+#include "cdb/cdbvars.h"
+#include "utils/lsyscache.h"
 #include "utils/snapmgr.h"
 
+/*
+ * Translate simple "Var op Const" quals on the scanned relation's leading
+ * column into scan keys, so that the append-only layer can test them
+ * against the block directory zone maps and skip varblocks wholesale. The
+ * executor still evaluates the full qual list; the keys only need to be
+ * implied by it, never complete.
+ */
+static ScanKey
+aoscan_build_zonemap_scankeys(ScanState *scanState, int *nkeys)
+{
+	Relation	relation = scanState->ss_currentRelation;
+	List	   *qual = scanState->ps.plan->qual;
+	TupleDesc	tupDesc = RelationGetDescr(relation);
+	Oid			atttypid;
+	Oid			opclass;
+	Oid			opfamily;
+	ScanKey		keys;
+	int			n;
+	ListCell   *lc;
+
+	*nkeys = 0;
+
+	if (!gp_enable_ao_zonemaps ||
+		qual == NIL ||
+		!OidIsValid(relation->rd_appendonly->blkdirrelid) ||
+		tupDesc->natts == 0 ||
+		tupDesc->attrs[0]->attisdropped)
+		return NULL;
+
+	atttypid = tupDesc->attrs[0]->atttypid;
+	if (!AppendOnlyZoneMap_TypeEligible(atttypid))
+		return NULL;
+
+	opclass = GetDefaultOpClass(atttypid, BTREE_AM_OID);
+	if (!OidIsValid(opclass))
+		return NULL;
+	opfamily = get_opclass_family(opclass);
+
+	keys = palloc0(list_length(qual) * sizeof(ScanKeyData));
+	n = 0;
+	foreach(lc, qual)
+	{
+		OpExpr	   *opexpr = (OpExpr *) lfirst(lc);
+		Node	   *leftArg;
+		Node	   *rightArg;
+		Var		   *var;
+		Const	   *constArg;
+		Oid			opno;
+		int			strategy;
+
+		if (!IsA(opexpr, OpExpr) ||
+			list_length(opexpr->args) != 2)
+			continue;
+
+		leftArg = (Node *) linitial(opexpr->args);
+		rightArg = (Node *) lsecond(opexpr->args);
+		opno = opexpr->opno;
+
+		if (IsA(leftArg, Var) && IsA(rightArg, Const))
+		{
+			var = (Var *) leftArg;
+			constArg = (Const *) rightArg;
+		}
+		else if (IsA(leftArg, Const) && IsA(rightArg, Var))
+		{
+			/* Commute "Const op Var" into "Var op Const". */
+			opno = get_commutator(opno);
+			if (!OidIsValid(opno))
+				continue;
+			var = (Var *) rightArg;
+			constArg = (Const *) leftArg;
+		}
+		else
+			continue;
+
+		if (var->varattno != 1 ||
+			var->varlevelsup != 0 ||
+			var->vartype != atttypid ||
+			constArg->consttype != atttypid ||
+			constArg->constisnull)
+			continue;
+
+		strategy = get_op_opfamily_strategy(opno, opfamily);
+		if (strategy == InvalidStrategy)
+			continue;
+
+		ScanKeyInit(&keys[n],
+					var->varattno,
+					strategy,
+					get_opcode(opno),
+					constArg->constvalue);
+		n++;
+	}
+
+	if (n == 0)
+	{
+		pfree(keys);
+		return NULL;
+	}
+
+	*nkeys = n;
+	return keys;
+}
+
 TupleTableSlot *
 AppendOnlyScanNext(ScanState *scanState)
 {
@@ -52,6 +162,8 @@ void
 BeginScanAppendOnlyRelation(ScanState *scanState)
 {
 	Snapshot appendOnlyMetaDataSnapshot;
+	int nkeys;
+	ScanKey keys;
 
 	Assert(IsA(scanState, TableScanState) ||
 		   IsA(scanState, DynamicTableScanState));
@@ -71,11 +183,19 @@ BeginScanAppendOnlyRelation(ScanState *scanState)
 		appendOnlyMetaDataSnapshot = GetTransactionSnapshot();
 	}
 
+	nkeys = 0;
+	keys = aoscan_build_zonemap_scankeys(&node->ss, &nkeys);
+
 	node->aos_ScanDesc = appendonly_beginscan(
 			node->ss.ss_currentRelation, 
 			node->ss.ps.state->es_snapshot, 
 			appendOnlyMetaDataSnapshot,
-			0, NULL);
+			nkeys, keys);
+
+	/* appendonly_beginscan keeps its own copy of the keys. */
+	if (keys != NULL)
+		pfree(keys);
+
 	node->ss.scan_state = SCAN_SCAN;
 }
 
@@ -84,6 +84,12 @@ freeBitmapState(BitmapTableScanState *scanstate)
 		scanstate->tbmiterator = NULL;
 		scanstate->tbmres = NULL;
 	}
+
+	if (scanstate->prefetch_iterator != NULL)
+	{
+		tbm_generic_end_iterate(scanstate->prefetch_iterator);
+		scanstate->prefetch_iterator = NULL;
+	}
 }
 
 static TupleTableSlot*
@@ -116,6 +122,16 @@ readBitmap(BitmapTableScanState *scanState)
 
 /*
  * Reads the next bitmap page from the current bitmap.
+ *
+ * For heap tables we also run a second iterator over the same bitmap a
+ * configurable distance ahead of this one, issuing PrefetchBuffer calls
+ * for the upcoming pages so that a scan of cold data keeps a deep I/O
+ * queue instead of paying one disk latency per page.  scanState->
+ * prefetch_pages tracks exactly how many pages ahead the prefetch
+ * iterator is, and prefetch_target is the desired distance, which starts
+ * small and ramps up to the GUC-controlled maximum, target_prefetch_pages.
+ * The ramp-up avoids wasted prefetches in a scan that a LIMIT stops after
+ * a few tuples.
  */
 static bool
 fetchNextBitmapPage(BitmapTableScanState *scanState)
@@ -132,11 +148,45 @@ fetchNextBitmapPage(BitmapTableScanState *scanState)
 	if (scanState->tbmiterator == NULL)
 	{
 		scanState->tbmiterator = tbm_generic_begin_iterate(scanState->tbm);
+
+#ifdef USE_PREFETCH
+		/*
+		 * AO fetches don't go through the buffer manager, so prefetching
+		 * applies to heap tables only.
+		 */
+		if (target_prefetch_pages > 0 &&
+			scanState->ss.tableType == TableTypeHeap)
+		{
+			scanState->prefetch_iterator = tbm_generic_begin_iterate(scanState->tbm);
+			scanState->prefetch_pages = 0;
+			scanState->prefetch_target = -1;
+		}
+#endif   /* USE_PREFETCH */
 	}
 
 	do
 	{
 		tbmres = tbm_generic_iterate(scanState->tbmiterator);
+
+#ifdef USE_PREFETCH
+		if (tbmres && scanState->prefetch_iterator)
+		{
+			if (scanState->prefetch_pages > 0)
+			{
+				/* The main iterator has closed the distance by one page */
+				scanState->prefetch_pages--;
+			}
+			else
+			{
+				/* Do not let the prefetch iterator get behind the main one */
+				TBMIterateResult *tbmpre =
+					tbm_generic_iterate(scanState->prefetch_iterator);
+
+				if (tbmpre == NULL || tbmpre->blockno != tbmres->blockno)
+					elog(ERROR, "prefetch and main iterators are out of sync");
+			}
+		}
+#endif   /* USE_PREFETCH */
 	} while (tbmres && (tbmres->ntuples == 0));
 
 	if (tbmres)
@@ -153,6 +203,48 @@ fetchNextBitmapPage(BitmapTableScanState *scanState)
 		{
 			scanState->isLossyBitmapPage = false;
 		}
+
+#ifdef USE_PREFETCH
+		if (scanState->prefetch_iterator)
+		{
+			/*
+			 * Increase the prefetch target if it's not yet at the max.  Note
+			 * that we will increase it to zero after the first page, then to
+			 * one after the second, then it doubles as later pages are
+			 * fetched.
+			 */
+			if (scanState->prefetch_target >= target_prefetch_pages)
+				 /* don't increase any further */ ;
+			else if (scanState->prefetch_target >= target_prefetch_pages / 2)
+				scanState->prefetch_target = target_prefetch_pages;
+			else if (scanState->prefetch_target > 0)
+				scanState->prefetch_target *= 2;
+			else
+				scanState->prefetch_target++;
+
+			/*
+			 * We issue prefetch requests *after* establishing that there is
+			 * work to do on the current page, else we might uselessly
+			 * prefetch the same page we are just about to request for real.
+			 */
+			while (scanState->prefetch_pages < scanState->prefetch_target)
+			{
+				TBMIterateResult *tbmpre =
+					tbm_generic_iterate(scanState->prefetch_iterator);
+
+				if (tbmpre == NULL)
+				{
+					/* No more pages to prefetch */
+					tbm_generic_end_iterate(scanState->prefetch_iterator);
+					scanState->prefetch_iterator = NULL;
+					break;
+				}
+				scanState->prefetch_pages++;
+				PrefetchBuffer(scanState->ss.ss_currentRelation, MAIN_FORKNUM,
+							   tbmpre->blockno);
+			}
+		}
+#endif   /* USE_PREFETCH */
 	}
 
 	return (tbmres != NULL);
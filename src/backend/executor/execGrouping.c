@@ -17,6 +17,7 @@
 #include "executor/executor.h"
 #include "miscadmin.h"
 #include "parser/parse_oper.h"
+#include "utils/fmgroids.h"
 #include "utils/lsyscache.h"
 #include "utils/memutils.h"
 #include "utils/syscache.h"
@@ -28,6 +29,69 @@ static uint32 TupleHashTableHash(const void *key, Size keysize);
 static int TupleHashTableMatch(const void *key1, const void *key2,
 					Size keysize);
 
+/* timestamp_eq; fmgroids.h only carries the timestamptz entry (1152) */
+#define TIMESTAMP_EQ_OID 2052
+
+/*
+ * execTupleFieldFastEq
+ *		Datum-level equality for types whose equality operator amounts to a
+ *		byte comparison of the stored values.
+ *
+ * Grouping and DISTINCT spend much of their time dispatching through
+ * FunctionCall2 once per column per tuple.  For the common equality
+ * operators that outcome is fully determined by the bytes of the two
+ * datums, so compare those directly and skip fmgr.  Returns false (leaving
+ * *eq untouched) for operators it does not recognize, e.g. float equality
+ * (-0 vs 0, NaN) or bpchar (trailing-space semantics); the caller then
+ * falls back to the equality function.
+ *
+ * Note: any detoasted copies made for the varlena cases are left in
+ * CurrentMemoryContext, which all callers reset between comparisons.
+ */
+static inline bool
+execTupleFieldFastEq(FmgrInfo *eqfn, Datum attr1, Datum attr2, bool *eq)
+{
+	switch (eqfn->fn_oid)
+	{
+		case F_BOOLEQ:
+		case F_CHAREQ:
+		case F_INT2EQ:
+		case F_INT4EQ:
+		case F_OIDEQ:
+		case F_DATE_EQ:
+			/* pass-by-value: the datums are the values */
+			*eq = (attr1 == attr2);
+			return true;
+
+		case F_INT8EQ:
+#ifdef HAVE_INT64_TIMESTAMP
+		case F_TIMESTAMP_EQ:	/* timestamptz; shares C code with timestamp */
+		case TIMESTAMP_EQ_OID:
+		case F_TIME_EQ:
+#endif
+			/* 64-bit value; DatumGetInt64 copes with by-reference builds */
+			*eq = (DatumGetInt64(attr1) == DatumGetInt64(attr2));
+			return true;
+
+		case F_TEXTEQ:
+		case F_BYTEAEQ:
+			{
+				struct varlena *v1 = PG_DETOAST_DATUM_PACKED(attr1);
+				struct varlena *v2 = PG_DETOAST_DATUM_PACKED(attr2);
+				Size		len = VARSIZE_ANY_EXHDR(v1);
+
+				if (len != VARSIZE_ANY_EXHDR(v2))
+					*eq = false;
+				else
+					*eq = (memcmp(VARDATA_ANY(v1), VARDATA_ANY(v2), len) == 0);
+				return true;
+			}
+
+		default:
+			return false;
+	}
+}
+
 
 /*****************************************************************************
  *		Utility routines for grouping tuples together
@@ -58,6 +122,7 @@ execTuplesMatch(TupleTableSlot *slot1,
 {
 	MemoryContext oldContext;
 	bool		result;
+	bool		equal;
 	int			i;
 
 	/* Reset and switch into the temp context. */
@@ -95,8 +160,11 @@ execTuplesMatch(TupleTableSlot *slot1,
 
 		/* Apply the type-specific equality function */
 
-		if (!DatumGetBool(FunctionCall2(&eqfunctions[i],
-										attr1, attr2)))
+		if (!execTupleFieldFastEq(&eqfunctions[i], attr1, attr2, &equal))
+			equal = DatumGetBool(FunctionCall2(&eqfunctions[i],
+											   attr1, attr2));
+
+		if (!equal)
 		{
 			result = false;		/* they aren't equal */
 			break;
@@ -128,6 +196,7 @@ execTuplesUnequal(TupleTableSlot *slot1,
 {
 	MemoryContext oldContext;
 	bool		result;
+	bool		equal;
 	int			i;
 
 	/* Reset and switch into the temp context. */
@@ -162,8 +231,11 @@ execTuplesUnequal(TupleTableSlot *slot1,
 
 		/* Apply the type-specific equality function */
 
-		if (!DatumGetBool(FunctionCall2(&eqfunctions[i],
-										attr1, attr2)))
+		if (!execTupleFieldFastEq(&eqfunctions[i], attr1, attr2, &equal))
+			equal = DatumGetBool(FunctionCall2(&eqfunctions[i],
+											   attr1, attr2));
+
+		if (!equal)
 		{
 			result = true;		/* they are unequal */
 			break;
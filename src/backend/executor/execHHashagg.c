@@ -32,6 +32,7 @@
 #include "utils/elog.h"
 #include "cdb/memquota.h"
 #include "utils/workfile_mgr.h"
+#include "utils/vmem_tracker.h"
 
 #include "access/hash.h"
 
@@ -91,10 +92,14 @@ typedef enum InputRecordType
 #define HAVE_FREESPACE(hashtable) \
 		(AVAIL_MEM(hashtable) > 0)
 
-/* Actual memory needed per bucket = entry pointer + bloom value */
-#define OVERHEAD_PER_BUCKET (sizeof(HashAggBucket) + sizeof(uint64))
+/* Actual memory needed per bucket = one open-addressing slot */
+#define OVERHEAD_PER_BUCKET (sizeof(HashAggSlot))
 
-#define BLOOMVAL(hashkey) ((uint64)1) << (((hashkey) >> 23) & 0x3f);
+/*
+ * Open addressing degrades sharply as the slot array fills up; expand (or
+ * spill) once this share of the slots is occupied.
+ */
+#define HASHAGG_MAX_FILL(nbuckets) (((nbuckets) >> 2) * 3)
 
 #define BUCKET_IDX(hashtable, hashkey) \
 		(((hashkey) >> (hashtable)->pshift) & ((hashtable)->nbuckets - 1))
@@ -268,7 +273,6 @@ makeHashAggEntryForInput(AggState *aggstate, TupleTableSlot *inputslot, uint32 h
 	entry->tuple_and_aggs = NULL;
 	entry->hashvalue = hashvalue;
 	entry->is_primodial = !(hashtable->is_spilling);
-	entry->next = NULL;
 
 	/*
 	 * Copy memtuple into group_buf. Remember to always allocate
@@ -339,7 +343,6 @@ makeHashAggEntryForGroup(AggState *aggstate, void *tuple_and_aggs,
 	entry->hashvalue = hashvalue;
 	entry->is_primodial = !(hashtable->is_spilling);
 	entry->tuple_and_aggs = copy_tuple_and_aggs;
-	entry->next = NULL;
 
 	/* Initialize per group data */
 	adjustInputGroup(aggstate, entry->tuple_and_aggs);
@@ -390,15 +393,14 @@ lookup_agg_hash_entry(AggState *aggstate,
 					  InputRecordType input_type, int32 input_size,
 					  uint32 hashkey, bool *p_isnew)
 {
-	HashAggEntry *entry;
+	HashAggEntry *entry = NULL;
 	HashAggTable *hashtable = aggstate->hhashtable;
 	MemTupleBinding *mt_bind = aggstate->hashslot->tts_mt_bind;
 	ExprContext *tmpcontext = aggstate->tmpcontext; /* per input tuple context */
 	Agg *agg = (Agg*)aggstate->ss.ps.plan;
 	MemoryContext oldcxt;
-	unsigned int bucket_idx;
-	uint64 bloomval;			/* bloom filter value */
-   
+	unsigned int slot_idx;
+
 	Assert(mt_bind != NULL);
 
 	if (p_isnew != NULL)
@@ -406,29 +408,34 @@ lookup_agg_hash_entry(AggState *aggstate,
 
 	oldcxt = MemoryContextSwitchTo(tmpcontext->ecxt_per_tuple_memory);
 
-	bucket_idx = BUCKET_IDX(hashtable, hashkey);
-	bloomval = BLOOMVAL(hashkey);
-	entry = (0 == (hashtable->bloom[bucket_idx] & bloomval) ? NULL :
-			 hashtable->buckets[bucket_idx]);
-
 	/*
-	 * Search entry chain for the bucket. If such an entry found in the
-	 * chain, move it to the front of the chain. Otherwise, if there
-	 * are any space left, create a new entry, and insert it in
-	 * the front of the chain.
+	 * Probe linearly from the home bucket.  The slot array keeps the full
+	 * hash value beside each entry pointer, so slots belonging to other
+	 * groups are rejected without touching the entries themselves; the
+	 * (comparatively expensive) key comparison runs only on a full hash
+	 * match.  An empty slot ends the probe: the group is not in the table,
+	 * and that slot is where a new entry would go.
 	 */
-	while (entry != NULL)
+	slot_idx = BUCKET_IDX(hashtable, hashkey);
+	for (;;)
 	{
-		MemTuple mtup = (MemTuple) entry->tuple_and_aggs;
+		HashAggSlot *slot = &hashtable->slots[slot_idx];
+		MemTuple mtup;
 		int i;
-		bool match = true;
+		bool match;
 
-		if (hashkey != entry->hashvalue)
+		if (slot->entry == NULL)
+			break;
+
+		if (slot->hashvalue != hashkey)
 		{
-			entry = entry->next;
+			slot_idx = (slot_idx + 1) & (hashtable->nbuckets - 1);
 			continue;
 		}
-		
+
+		mtup = (MemTuple) slot->entry->tuple_and_aggs;
+		match = true;
+
 		for (i = 0; match && i < agg->numCols; i++)
 		{
 			AttrNumber	att = agg->grpColIdx[i];
@@ -436,7 +443,7 @@ lookup_agg_hash_entry(AggState *aggstate,
 			Datum entry_datum = 0;
 			bool input_isNull = false;
 			bool entry_isNull = false;
-				
+
 			switch(input_type)
 			{
 				case INPUT_RECORD_TUPLE:
@@ -458,17 +465,35 @@ lookup_agg_hash_entry(AggState *aggstate,
 				continue; /* Both non-NULL and equal. */
 			match = (input_isNull && entry_isNull);/* NULLs match in group keys. */
 		}
-		
-		/* Break if found an existing matching entry. */
+
+		/* Stop if found an existing matching entry. */
 		if (match)
+		{
+			entry = slot->entry;
 			break;
+		}
 
-		entry = entry->next;
+		slot_idx = (slot_idx + 1) & (hashtable->nbuckets - 1);
 	}
 
 	if (entry == NULL)
 	{
-		/* Entry not found! Create a new matching entry. */
+		/*
+		 * Entry not found.  Grow the slot array first if it is getting too
+		 * full for efficient probing; if it is full and cannot grow, give
+		 * up so that the caller spills.
+		 */
+		if (hashtable->expandable &&
+			hashtable->num_entries + 1 > HASHAGG_MAX_FILL(hashtable->nbuckets))
+			expand_hash_table(aggstate);
+
+		if (hashtable->num_entries + 1 >= hashtable->nbuckets)
+		{
+			(void) MemoryContextSwitchTo(oldcxt);
+			return NULL;
+		}
+
+		/* Create a new matching entry. */
 		switch(input_type)
 		{
 			case INPUT_RECORD_TUPLE:
@@ -480,29 +505,28 @@ lookup_agg_hash_entry(AggState *aggstate,
 			default:
 				insist_log(false, "invalid record type %d", input_type);
 		}
-			
+
 		if (entry != NULL)
 		{
-			if (hashtable->expandable &&
-					hashtable->num_entries >= (hashtable->nbuckets * gp_hashagg_groups_per_bucket))
-			{
-				/* The hashtable is denser than envisioned; increase the number of buckets */
-				expand_hash_table(aggstate);
-				/* Recompute bucket_idx in case nbuckets changed */
-				bucket_idx = BUCKET_IDX(hashtable, hashkey);
-			}
+			/*
+			 * Re-probe for the insert position: expand_hash_table may have
+			 * moved the empty slot, and makeHashAggEntryFor* cannot have
+			 * added the key.
+			 */
+			slot_idx = BUCKET_IDX(hashtable, hashkey);
+			while (hashtable->slots[slot_idx].entry != NULL)
+				slot_idx = (slot_idx + 1) & (hashtable->nbuckets - 1);
+
+			hashtable->slots[slot_idx].hashvalue = hashkey;
+			hashtable->slots[slot_idx].entry = entry;
 
-			entry->next = hashtable->buckets[bucket_idx];
-			hashtable->buckets[bucket_idx] = entry;
-			hashtable->bloom[bucket_idx] |= bloomval;
-			
 			++hashtable->num_ht_groups;
 			++hashtable->num_entries;
 
 			*p_isnew = true; /* created a new entry */
 		}
 		/*
-		  else no matching entry, and no room to create one. 
+		  else no matching entry, and no room to create one.
 		*/
 	}
 
@@ -547,8 +571,12 @@ calcHashAggTableSizes(double memquota,	/* Memory quota in bytes. */
 
 	Assert(ngroups >= 0);
 
-	/* Estimate the overhead per entry in the hash table */
-	entrysize = entrywidth + OVERHEAD_PER_BUCKET / (double) gp_hashagg_groups_per_bucket;
+	/*
+	 * Estimate the overhead per entry in the hash table.  With open
+	 * addressing we keep the slot array at most 3/4 full, so each entry
+	 * accounts for 4/3 slots.
+	 */
+	entrysize = entrywidth + OVERHEAD_PER_BUCKET * 4.0 / 3.0;
 
 	elog(HHA_MSG_LVL, "HashAgg: ngroups = %g, memquota = %g, entrysize = %g",
 		 ngroups, memquota, entrysize);
@@ -586,7 +614,7 @@ calcHashAggTableSizes(double memquota,	/* Memory quota in bytes. */
 	nentries = Min(ngroups, nentries);
 
 	/* but at least a few hash entries as required */
-	nentries = Max(nentries, gp_hashagg_groups_per_bucket);
+	nentries = Max(nentries, 4);
 	entries_mem = nentries * entrywidth;
 
 	/*
@@ -601,8 +629,8 @@ calcHashAggTableSizes(double memquota,	/* Memory quota in bytes. */
 
 	memquota -= entries_mem;
 
-	/* Determine the number of buckets */
-	nbuckets = ceil(nentries / gp_hashagg_groups_per_bucket);
+	/* Determine the number of slots, keeping the array at most 3/4 full */
+	nbuckets = ceil(nentries * 4.0 / 3.0);
 
 	/* Use only as many allowed by memory */
 	nbuckets = Min(nbuckets, floor(memquota / OVERHEAD_PER_BUCKET));
@@ -636,8 +664,8 @@ calcHashAggTableSizes(double memquota,	/* Memory quota in bytes. */
 		elog(HHA_MSG_LVL, "HashAgg: not enough memory for the hash table parameters chosen:");
 		elog(HHA_MSG_LVL, "HashAgg: nbuckets = %d, nentries = %d, nbatches = %d",
 			 (int)nbuckets, (int)nentries, (int)nbatches);
-		elog(HHA_MSG_LVL, "HashAgg: ngroups = %d, gp_hashagg_groups_per_bucket = %d",
-			 (int)ngroups, (int)gp_hashagg_groups_per_bucket);
+		elog(HHA_MSG_LVL, "HashAgg: ngroups = %d",
+			 (int)ngroups);
 		return false;
 	}
 
@@ -767,10 +795,9 @@ create_agg_hash_table(AggState *aggstate)
 		elog(ERROR, ERRMSG_GP_INSUFFICIENT_STATEMENT_MEMORY);
 	}
 
-	/* Initialize the hash buckets */
+	/* Initialize the hash slots */
 	hashtable->nbuckets = hashtable->hats.nbuckets;
-	hashtable->buckets = (HashAggBucket *) palloc0(hashtable->nbuckets * sizeof(HashAggBucket));
-	hashtable->bloom = (uint64 *) palloc0(hashtable->nbuckets * sizeof(uint64));
+	hashtable->slots = (HashAggSlot *) palloc0(hashtable->nbuckets * sizeof(HashAggSlot));
 
 	hashtable->pshift = 0;
 	hashtable->expandable = true;
@@ -799,6 +826,9 @@ create_agg_hash_table(AggState *aggstate)
 
 	hashtable->prev_slot = NULL;
 
+	/* Nothing to spill yet; ignore pre-spill requests that predate us */
+	hashtable->prespill_serial = RedZoneHandler_GetPreSpillRequestCount();
+
 	MemSet(padding_dummy, 0, MAXIMUM_ALIGNOF);
 	
 	init_agg_hash_iter(hashtable);
@@ -828,6 +858,8 @@ agg_hash_initial_pass(AggState *aggstate)
 	HashAggTable *hashtable = aggstate->hhashtable;
 	ExprContext *tmpcontext = aggstate->tmpcontext; /* per input tuple context */
 	TupleTableSlot *outerslot = NULL;
+	PlanState *outerPlan = outerPlanState(aggstate);
+	bool directfetch = ExecScanSupportsDirectFetch(outerPlan);
 	bool streaming = ((Agg *) aggstate->ss.ps.plan)->streaming;
 	bool tuple_remaining = true;
 
@@ -849,7 +881,8 @@ agg_hash_initial_pass(AggState *aggstate)
 	}
 	else
 	{
-		outerslot = ExecProcNode(outerPlanState(aggstate));
+		/* The first fetch always dispatches through ExecProcNode. */
+		outerslot = ExecProcNode(outerPlan);
 	}
 
 	/*
@@ -882,6 +915,17 @@ agg_hash_initial_pass(AggState *aggstate)
 			hashtable->mem_for_metadata += size;
 		}
 
+		/*
+		 * Cooperative pre-spill: if the red-zone handler has signalled
+		 * vmem pressure since we last checked, spill the in-memory groups
+		 * now instead of waiting for the runaway detector to terminate the
+		 * biggest query. Streaming mode holds little memory and streams
+		 * entries out on its own, so it doesn't take part.
+		 */
+		if (!streaming && hashtable->num_entries > 0 &&
+			RedZoneHandler_PreSpillRequested(&hashtable->prespill_serial))
+			spill_hash_table(aggstate);
+
 		/* set up for advance_aggregates call */
 		tmpcontext->ecxt_outertuple = outerslot;
 
@@ -952,8 +996,15 @@ agg_hash_initial_pass(AggState *aggstate)
 			break;
 		}
 
-		/* Read the next tuple */
-		outerslot = ExecProcNode(outerPlanState(aggstate));
+		/*
+		 * Read the next tuple.  This loop consumes the entire input, so
+		 * when the child is a table scan we skip the per-tuple
+		 * ExecProcNode overhead and call into the scan directly.
+		 */
+		if (directfetch)
+			outerslot = ExecScanDirectFetch(outerPlan);
+		else
+			outerslot = ExecProcNode(outerPlan);
 	}
 
 	if (GET_TOTAL_USED_SIZE(hashtable) > hashtable->mem_used)
@@ -1314,37 +1365,34 @@ spill_hash_table(AggState *aggstate)
 			CheckSendPlanStateGpmonPkt(&aggstate->ss.ps);
 		}
 
-		for (bucket_no = file_no; bucket_no < hashtable->nbuckets;
-			 bucket_no += spill_set->num_spill_files)
+		/*
+		 * Write out the entries belonging to this file.  A group's batch is
+		 * determined by its home bucket, not by the slot the entry actually
+		 * occupies, so that reloading assigns it back deterministically.
+		 */
+		for (bucket_no = 0; bucket_no < hashtable->nbuckets; bucket_no++)
 		{
-			HashAggEntry *entry = hashtable->buckets[bucket_no];
-			
-			/* Ignore empty chains. */
-			if (entry == NULL) continue;
-			
-			/* Write all entries in the hash chain. */
-			while ( entry  != NULL )
-			{
-				HashAggEntry *spill_entry = entry;
-				entry = spill_entry->next;
-
-				if (spill_entry != NULL)
-				{
-					int32 written_bytes;
-					
-					written_bytes = writeHashEntry(aggstate, spill_file->file_info, spill_entry);
-					spill_file->file_info->ntuples++;
-					spill_file->file_info->total_bytes += written_bytes;
-
-					hashtable->num_spill_groups++;
-				}
-			}
+			HashAggEntry *entry = hashtable->slots[bucket_no].entry;
+			int32 written_bytes;
+
+			if (entry == NULL)
+				continue;
+
+			if (BUCKET_IDX(hashtable, entry->hashvalue) % spill_set->num_spill_files
+				!= file_no)
+				continue;
+
+			written_bytes = writeHashEntry(aggstate, spill_file->file_info, entry);
+			spill_file->file_info->ntuples++;
+			spill_file->file_info->total_bytes += written_bytes;
 
-			hashtable->buckets[bucket_no] = NULL;
-			hashtable->bloom[bucket_no] = 0;
+			hashtable->num_spill_groups++;
 		}
 	}
 
+	/* All entries have been written out; empty the slot array */
+	MemSet(hashtable->slots, 0, hashtable->nbuckets * sizeof(HashAggSlot));
+
 	/* Reset the buffer */
 	mpool_reset(hashtable->group_buf);
 
@@ -1360,11 +1408,11 @@ spill_hash_table(AggState *aggstate)
 static void
 expand_hash_table(AggState *aggstate)
 {
-	unsigned mem_needed, old_nbuckets, bucket_idx, new_bucket_idx;
-	uint32 hashkey;
-	uint64 bloomval;
-	HashAggEntry *entry, *nextentry;
+	unsigned mem_needed, old_nbuckets, slot_no, new_slot_idx;
+	HashAggSlot *old_slots;
+	HashAggSlot *new_slots;
 	HashAggTable *hashtable = aggstate->hhashtable;
+	MemoryContext oldcxt;
 
 #ifdef USE_ASSERT_CHECKING
 	unsigned nentries = 0;
@@ -1397,42 +1445,36 @@ expand_hash_table(AggState *aggstate)
 
 	Assert(GET_TOTAL_USED_SIZE(hashtable) < hashtable->max_mem);
 
-	hashtable->buckets = (HashAggBucket *) repalloc(hashtable->buckets,
-		hashtable->nbuckets * sizeof(HashAggBucket));
-	hashtable->bloom =  (uint64 *) repalloc(hashtable->bloom,
-		hashtable->nbuckets * sizeof(uint64));
+	oldcxt = MemoryContextSwitchTo(aggstate->aggcontext);
+	new_slots = (HashAggSlot *) palloc0(hashtable->nbuckets * sizeof(HashAggSlot));
+	MemoryContextSwitchTo(oldcxt);
 
-	memset(hashtable->bloom, 0, hashtable->nbuckets * sizeof(uint64));
-	memset(hashtable->buckets + old_nbuckets, 0, old_nbuckets * sizeof(HashAggBucket));
+	/*
+	 * Re-insert every occupied slot into the doubled array, probing
+	 * linearly from each entry's new home bucket.
+	 */
+	old_slots = hashtable->slots;
+	hashtable->slots = new_slots;
 
-	/* Iterate all the entries from the hashtable move them as needed */
-	for(bucket_idx=0; bucket_idx < old_nbuckets; ++bucket_idx)
+	for (slot_no = 0; slot_no < old_nbuckets; ++slot_no)
 	{
-		entry = hashtable->buckets[bucket_idx];
-		hashtable->buckets[bucket_idx] = NULL;
-
-		while(entry != NULL)
-		{
-			nextentry = entry->next;
-			hashkey = entry->hashvalue;
-			bloomval = BLOOMVAL(hashkey);
+		HashAggSlot *old_slot = &old_slots[slot_no];
 
-			new_bucket_idx = BUCKET_IDX(hashtable, hashkey);
-
-			Assert(new_bucket_idx == bucket_idx ||
-					new_bucket_idx == bucket_idx + old_nbuckets);
+		if (old_slot->entry == NULL)
+			continue;
 
-			/* Insert this at the head of the bucket */
-			entry->next = hashtable->buckets[new_bucket_idx];
-			hashtable->buckets[new_bucket_idx] = entry;
-			hashtable->bloom[new_bucket_idx] |= bloomval;
+		new_slot_idx = BUCKET_IDX(hashtable, old_slot->hashvalue);
+		while (new_slots[new_slot_idx].entry != NULL)
+			new_slot_idx = (new_slot_idx + 1) & (hashtable->nbuckets - 1);
 
-			entry = nextentry;
+		new_slots[new_slot_idx] = *old_slot;
 #ifdef USE_ASSERT_CHECKING
-			++nentries;
+		++nentries;
 #endif
-		}
 	}
+
+	pfree(old_slots);
+
 	hashtable->num_expansions++;
 	Assert(hashtable->mem_for_metadata > 0);
 	Assert(nentries == hashtable->num_entries);
@@ -1518,8 +1560,9 @@ writeHashEntry(AggState *aggstate, BatchFileInfo *file_info,
 
 /*
  * agg_hash_table_stat_upd
- *   Collect buckets and hash chain statistics of the in-memory hash table for
- *   EXPLAIN ANALYZE
+ *   Collect probe-length statistics of the in-memory hash table for
+ *   EXPLAIN ANALYZE; the distance of each entry from its home bucket
+ *   plays the role the chain length had with chained buckets.
  */
 static void
 agg_hash_table_stat_upd(HashAggTable *hashtable)
@@ -1528,15 +1571,16 @@ agg_hash_table_stat_upd(HashAggTable *hashtable)
 
 	for (i = 0; i < hashtable->nbuckets; i++)
 	{
-		HashAggEntry   *entry = hashtable->buckets[i];
-		int             chainlength = 0;
+		HashAggSlot	   *slot = &hashtable->slots[i];
+		unsigned int	home;
+		int				probelength;
 
-		if (entry)
-		{
-			for (chainlength = 0; entry; chainlength++)
-				entry = entry->next;
-			cdbexplain_agg_upd(&hashtable->chainlength, chainlength, i);
-		}
+		if (slot->entry == NULL)
+			continue;
+
+		home = BUCKET_IDX(hashtable, slot->hashvalue);
+		probelength = ((i - home) & (hashtable->nbuckets - 1)) + 1;
+		cdbexplain_agg_upd(&hashtable->chainlength, probelength, i);
 	}
 
 	hashtable->total_buckets += hashtable->nbuckets;
@@ -1550,10 +1594,9 @@ agg_hash_table_stat_upd(HashAggTable *hashtable)
  * Initialize the HashAggTable's (one and only) entry iterator. */
 void init_agg_hash_iter(HashAggTable* hashtable)
 {
-	Assert( hashtable != NULL && hashtable->buckets != NULL && hashtable->nbuckets > 0 );
-	
+	Assert( hashtable != NULL && hashtable->slots != NULL && hashtable->nbuckets > 0 );
+
 	hashtable->curr_bucket_idx = -1;
-	hashtable->next_entry = NULL;
 }
 
 /* Function: agg_hash_iter
@@ -1569,21 +1612,14 @@ HashAggEntry *
 agg_hash_iter(AggState *aggstate)
 {
 	HashAggTable* hashtable = aggstate->hhashtable;
-	HashAggEntry *entry = hashtable->next_entry;
-	SpillSet *spill_set = hashtable->spill_set;
-	MemoryContext oldcxt;
+	HashAggEntry *entry = NULL;
 
-	Assert( hashtable != NULL && hashtable->buckets != NULL && hashtable->nbuckets > 0 );
-
-	if (hashtable->curr_spill_file != NULL)
-		spill_set = hashtable->curr_spill_file->spill_set;
-	
-	oldcxt = MemoryContextSwitchTo(hashtable->entry_cxt);
+	Assert( hashtable != NULL && hashtable->slots != NULL && hashtable->nbuckets > 0 );
 
 	while (entry == NULL &&
 		   hashtable->nbuckets > ++ hashtable->curr_bucket_idx)
 	{
-		entry = hashtable->buckets[hashtable->curr_bucket_idx];
+		entry = hashtable->slots[hashtable->curr_bucket_idx].entry;
 		if (entry != NULL)
 		{
 			Assert(entry->is_primodial);
@@ -1592,13 +1628,7 @@ agg_hash_iter(AggState *aggstate)
 	}
 
 	if (entry != NULL)
-	{
 		hashtable->num_output_groups++;
-		hashtable->next_entry = entry->next;
-		entry->next = NULL;
-	}
-
-	MemoryContextSwitchTo(oldcxt);
 
 	return entry;
 }
@@ -2130,7 +2160,7 @@ void reset_agg_hash_table(AggState *aggstate, int64 nentries)
 		"HashAgg: resetting " INT64_FORMAT "-entry hash table",
 		hashtable->num_ht_groups);
 
-	Assert(hashtable->buckets && hashtable->bloom);
+	Assert(hashtable->slots);
 
 	/*
 	 * Determine whether to reallocate buckets. Especially avoid re-allocation if
@@ -2161,11 +2191,9 @@ void reset_agg_hash_table(AggState *aggstate, int64 nentries)
 		hashtable->hats.nbuckets = hats.nbuckets;
 		hashtable->hats.nentries = hats.nentries;
 
-		pfree(hashtable->buckets);
-		pfree(hashtable->bloom);
+		pfree(hashtable->slots);
 
-		hashtable->buckets = (HashAggBucket *) palloc0(hashtable->nbuckets * sizeof(HashAggBucket));
-		hashtable->bloom = (uint64 *) palloc0(hashtable->nbuckets * sizeof(uint64));
+		hashtable->slots = (HashAggSlot *) palloc0(hashtable->nbuckets * sizeof(HashAggSlot));
 
 		hashtable->expandable = true;
 
@@ -2178,8 +2206,7 @@ void reset_agg_hash_table(AggState *aggstate, int64 nentries)
 	else
 	{
 		/* No need to reallocated buckets. Reset to zero. */
-		MemSet(hashtable->buckets, 0, hashtable->nbuckets * sizeof(HashAggBucket));
-		MemSet(hashtable->bloom, 0, hashtable->nbuckets * sizeof(uint64));
+		MemSet(hashtable->slots, 0, hashtable->nbuckets * sizeof(HashAggSlot));
 	}
 
 	Assert(hashtable->mem_for_metadata > 0);
@@ -2216,8 +2243,7 @@ void destroy_agg_hash_table(AggState *aggstate)
 		Gpmon_ResetAggHashTable(aggstate);
 
 		/* destroy_batches(aggstate->hhashtable); */
-		pfree(aggstate->hhashtable->buckets);
-		pfree(aggstate->hhashtable->bloom);
+		pfree(aggstate->hhashtable->slots);
 		if (aggstate->hhashtable->hashkey_buf)
 			pfree(aggstate->hhashtable->hashkey_buf);
 
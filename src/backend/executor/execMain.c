@@ -92,6 +92,7 @@
 #include "cdb/cdbdisp_query.h"
 #include "cdb/cdbdispatchresult.h"
 #include "cdb/cdbexplain.h"             /* cdbexplain_sendExecStats() */
+#include "cdb/cdbresusage.h"
 #include "cdb/cdbplan.h"
 #include "cdb/cdbsrlz.h"
 #include "cdb/cdbsubplan.h"
@@ -290,6 +291,9 @@ standard_ExecutorStart(QueryDesc *queryDesc, int eflags)
 	if (query_info_collect_hook)
 		(*query_info_collect_hook)(METRICS_QUERY_START, queryDesc);
 
+	/* Baseline for per-query CPU and I/O accounting */
+	ResUsageQueryStart();
+
 	/**
 	 * Distribute memory to operators.
 	 */
@@ -1092,6 +1096,12 @@ standard_ExecutorEnd(QueryDesc *queryDesc)
 		}
 	}
 
+	/*
+	 * Account the query's CPU and I/O usage while its workfiles are still
+	 * charged to it.
+	 */
+	ResUsageQueryEnd();
+
 	if (gp_partitioning_dynamic_selection_log &&
 		estate->dynamicTableScanInfo != NULL &&
 		estate->dynamicTableScanInfo->numScans > 0)
@@ -3846,14 +3856,19 @@ intorel_receive(TupleTableSlot *slot, DestReceiver *self)
 
 	if (RelationIsAoRows(into_rel))
 	{
-		MemTuple	tuple = ExecCopySlotMemTuple(slot);
+		/*
+		 * Materialize the memtuple in the slot's own reusable buffer (as
+		 * ExecInsert does) rather than copying it; appendonly_insert copies
+		 * the data into the insert buffers, so no per-row allocation is
+		 * needed.
+		 */
+		MemTuple	tuple = ExecFetchSlotMemTuple(slot, false);
 		AOTupleId	aoTupleId;
 
 		if (myState->ao_insertDesc == NULL)
 			myState->ao_insertDesc = appendonly_insert_init(into_rel, RESERVED_SEGNO, false);
 
 		appendonly_insert(myState->ao_insertDesc, tuple, InvalidOid, &aoTupleId);
-		pfree(tuple);
 	}
 	else if (RelationIsAoCols(into_rel))
 	{
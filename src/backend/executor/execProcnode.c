@@ -867,6 +867,21 @@ ExecProcNode(PlanState *node)
 {
 	TupleTableSlot *result = NULL;
 
+	/*
+	 * Collapse pure pass-through stages: a node marked with ps_ProxyTarget
+	 * (a trivial SubqueryScan) just relays its input's result slot, so fetch
+	 * from the input directly and skip a full dispatch layer per bypassed
+	 * node.  The loop re-checks each layer, so a node with a pending
+	 * parameter change, with EXPLAIN ANALYZE instrumentation attached, or
+	 * under perfmon row accounting is still executed normally and rescan
+	 * signaling and per-node row counts stay exact.
+	 */
+	while (node->ps_ProxyTarget != NULL &&
+		   node->chgParam == NULL &&
+		   node->instrument == NULL &&
+		   !gp_enable_gpperfmon)
+		node = node->ps_ProxyTarget;
+
 	START_MEMORY_ACCOUNT(node->plan->memoryAccountId);
 	{
 
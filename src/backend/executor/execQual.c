@@ -41,6 +41,7 @@
 #include "access/tupconvert.h"
 #include "catalog/pg_type.h"
 #include "cdb/cdbpartition.h"
+#include "cdb/cdbvars.h"
 #include "cdb/partitionselection.h"
 #include "commands/typecmds.h"
 #include "executor/execdebug.h"
@@ -5113,6 +5114,643 @@ ExecEvalExprSwitchContext(ExprState *expression,
 }
 
 
+/* ----------------------------------------------------------------
+ *		Bytecode expression evaluation
+ *
+ * ExecEvalExpr dispatches through a per-node function pointer and recurses
+ * for every operand, so a wide projection or a complex qual pays one
+ * indirect call (and its branch misprediction) per node per tuple.  For the
+ * common scalar node types we instead flatten the already-initialized
+ * ExprState tree into a linear program of postfix opcodes at ExecInitExpr
+ * time, and evaluate it with a single dispatch loop over a small value
+ * stack.  Anything the compiler does not understand is simply left on the
+ * tree-walking path; compiled and interpreted subexpressions coexist
+ * freely.
+ *
+ * Supported nodes: scalar Var, Const, OpExpr and FuncExpr (non-set-
+ * returning), BoolExpr, argless CaseExpr, and RelabelType (a no-op).
+ * ----------------------------------------------------------------
+ */
+
+typedef enum ExprBcOpcode
+{
+	EBC_VAR,					/* push an attribute of an input slot */
+	EBC_CONST,					/* push an immediate value */
+	EBC_FUNC,					/* pop nargs, call function, push result */
+	EBC_NOT,					/* boolean NOT of the top of stack */
+	EBC_AND_COMBINE,			/* fold top into AND accumulator below it */
+	EBC_OR_COMBINE,				/* fold top into OR accumulator below it */
+	EBC_JUMP,					/* unconditional jump */
+	EBC_JUMP_IF_NOT_TRUE,		/* pop; jump unless non-null true */
+	EBC_DONE					/* pop and return the result */
+} ExprBcOpcode;
+
+typedef struct ExprBcStep
+{
+	ExprBcOpcode opcode;
+	union
+	{
+		struct
+		{
+			int			varno;	/* INNER, OUTER, or scan slot */
+			AttrNumber	attnum;
+			Oid			vartype;	/* for one-time slot sanity check */
+		}			var;
+		struct
+		{
+			Datum		value;
+			bool		isnull;
+		}			con;
+		struct
+		{
+			FunctionCallInfoData *fcinfo;	/* preallocated, arity filled in */
+			int			nargs;
+			bool		strict;
+		}			func;
+		struct
+		{
+			int			target; /* destination step index */
+		}			jump;
+	}			d;
+} ExprBcStep;
+
+typedef struct ExprBytecodeProgram
+{
+	ExprBcStep *steps;
+	int			nsteps;
+	Datum	   *stack;			/* preallocated evaluation stack */
+	bool	   *stacknull;
+	bool		var_checked;	/* one-time Var checks done */
+	ExprStateEvalFunc fallback; /* evalfunc this program replaced */
+} ExprBytecodeProgram;
+
+/* Workspace used while flattening an ExprState tree */
+typedef struct ExprBcCompiler
+{
+	ExprBcStep *steps;
+	int			nsteps;
+	int			maxsteps;
+	int			depth;			/* current stack depth */
+	int			maxdepth;
+	List	   *subprograms;	/* descendants that carry their own program */
+} ExprBcCompiler;
+
+static bool ExecBcEmitExpr(ExprBcCompiler *c, ExprState *state);
+
+/* Append a step, growing the array as needed; returns its index. */
+static int
+ExecBcAppend(ExprBcCompiler *c, ExprBcOpcode opcode)
+{
+	if (c->nsteps == c->maxsteps)
+	{
+		c->maxsteps *= 2;
+		c->steps = (ExprBcStep *)
+			repalloc(c->steps, c->maxsteps * sizeof(ExprBcStep));
+	}
+	c->steps[c->nsteps].opcode = opcode;
+	return c->nsteps++;
+}
+
+static void
+ExecBcPush(ExprBcCompiler *c)
+{
+	c->depth++;
+	if (c->depth > c->maxdepth)
+		c->maxdepth = c->depth;
+}
+
+/*
+ * Emit steps that leave the value of the given subexpression on top of the
+ * stack.  Returns false if the subexpression cannot be compiled, in which
+ * case the caller must abandon the whole program.
+ */
+static bool
+ExecBcEmitExpr(ExprBcCompiler *c, ExprState *state)
+{
+	if (state == NULL || state->expr == NULL)
+		return false;
+
+	/*
+	 * If this subtree compiled on its own during bottom-up initialization,
+	 * remember it: once the enclosing program is in place its private
+	 * program is dead weight and will be released.
+	 */
+	if (state->bcprogram != NULL)
+		c->subprograms = lappend(c->subprograms, state);
+
+	switch (nodeTag(state->expr))
+	{
+		case T_Var:
+			{
+				Var		   *variable = (Var *) state->expr;
+				int			idx;
+
+				/* whole-row Vars take the interpreted path */
+				if (variable->varattno == InvalidAttrNumber)
+					return false;
+
+				idx = ExecBcAppend(c, EBC_VAR);
+				c->steps[idx].d.var.varno = variable->varno;
+				c->steps[idx].d.var.attnum = variable->varattno;
+				c->steps[idx].d.var.vartype = variable->vartype;
+				ExecBcPush(c);
+				return true;
+			}
+
+		case T_Const:
+			{
+				Const	   *con = (Const *) state->expr;
+				int			idx;
+
+				idx = ExecBcAppend(c, EBC_CONST);
+				c->steps[idx].d.con.value = con->constvalue;
+				c->steps[idx].d.con.isnull = con->constisnull;
+				ExecBcPush(c);
+				return true;
+			}
+
+		case T_RelabelType:
+			/* binary-compatible coercion: just evaluate the input */
+			return ExecBcEmitExpr(c, ((GenericExprState *) state)->arg);
+
+		case T_OpExpr:
+		case T_FuncExpr:
+			{
+				FuncExprState *fcache = (FuncExprState *) state;
+				Oid			funcid;
+				bool		retset;
+				int			nargs = list_length(fcache->args);
+				ListCell   *arg;
+				FunctionCallInfoData *fcinfo;
+				int			idx;
+
+				if (IsA(state->expr, OpExpr))
+				{
+					funcid = ((OpExpr *) state->expr)->opfuncid;
+					retset = ((OpExpr *) state->expr)->opretset;
+				}
+				else
+				{
+					funcid = ((FuncExpr *) state->expr)->funcid;
+					retset = ((FuncExpr *) state->expr)->funcretset;
+				}
+
+				if (retset || nargs > FUNC_MAX_ARGS)
+					return false;
+
+				foreach(arg, fcache->args)
+				{
+					if (!ExecBcEmitExpr(c, (ExprState *) lfirst(arg)))
+						return false;
+				}
+
+				/*
+				 * Look up the function now rather than at first evaluation.
+				 * This performs the permission check at executor startup,
+				 * which is no earlier than the tree walker would for any
+				 * expression that actually gets evaluated.
+				 */
+				if (fcache->func.fn_oid == InvalidOid)
+					init_fcache(funcid, fcache, CurrentMemoryContext, false);
+				if (fcache->func.fn_retset)
+					return false;
+
+				fcinfo = (FunctionCallInfoData *)
+					palloc(sizeof(FunctionCallInfoData));
+				InitFunctionCallInfoData(*fcinfo, &fcache->func, nargs,
+										 NULL, NULL);
+
+				idx = ExecBcAppend(c, EBC_FUNC);
+				c->steps[idx].d.func.fcinfo = fcinfo;
+				c->steps[idx].d.func.nargs = nargs;
+				c->steps[idx].d.func.strict = fcache->func.fn_strict;
+
+				/* pop the arguments, push the result */
+				c->depth -= nargs;
+				ExecBcPush(c);
+				return true;
+			}
+
+		case T_BoolExpr:
+			{
+				BoolExprState *bstate = (BoolExprState *) state;
+				BoolExpr   *boolexpr = (BoolExpr *) state->expr;
+				List	   *jumpdone = NIL;
+				ListCell   *lc;
+				int			idx;
+
+				if (boolexpr->boolop == NOT_EXPR)
+				{
+					if (!ExecBcEmitExpr(c, (ExprState *) linitial(bstate->args)))
+						return false;
+					ExecBcAppend(c, EBC_NOT);
+					return true;
+				}
+
+				/*
+				 * AND/OR: seed an accumulator, then fold each argument into
+				 * it.  The combine step short-circuits by jumping past the
+				 * remaining arguments once the outcome is decided.
+				 */
+				idx = ExecBcAppend(c, EBC_CONST);
+				c->steps[idx].d.con.value =
+					BoolGetDatum(boolexpr->boolop == AND_EXPR);
+				c->steps[idx].d.con.isnull = false;
+				ExecBcPush(c);
+
+				foreach(lc, bstate->args)
+				{
+					if (!ExecBcEmitExpr(c, (ExprState *) lfirst(lc)))
+					{
+						list_free(jumpdone);
+						return false;
+					}
+					idx = ExecBcAppend(c,
+									   boolexpr->boolop == AND_EXPR ?
+									   EBC_AND_COMBINE : EBC_OR_COMBINE);
+					c->depth--;
+					jumpdone = lappend_int(jumpdone, idx);
+				}
+
+				foreach(lc, jumpdone)
+					c->steps[lfirst_int(lc)].d.jump.target = c->nsteps;
+				list_free(jumpdone);
+				return true;
+			}
+
+		case T_CaseExpr:
+			{
+				CaseExprState *cstate = (CaseExprState *) state;
+				List	   *jumpdone = NIL;
+				ListCell   *lc;
+				int			basedepth = c->depth;
+				int			idx;
+
+				/*
+				 * The "CASE arg WHEN ..." form communicates the test value
+				 * through CaseTestExpr placeholders; leave it interpreted.
+				 */
+				if (cstate->arg != NULL)
+					return false;
+
+				foreach(lc, cstate->args)
+				{
+					CaseWhenState *wclause = (CaseWhenState *) lfirst(lc);
+					int			jumpnext;
+
+					c->depth = basedepth;
+					if (!ExecBcEmitExpr(c, wclause->expr))
+					{
+						list_free(jumpdone);
+						return false;
+					}
+					jumpnext = ExecBcAppend(c, EBC_JUMP_IF_NOT_TRUE);
+					c->depth--;
+					if (!ExecBcEmitExpr(c, wclause->result))
+					{
+						list_free(jumpdone);
+						return false;
+					}
+					idx = ExecBcAppend(c, EBC_JUMP);
+					jumpdone = lappend_int(jumpdone, idx);
+					c->steps[jumpnext].d.jump.target = c->nsteps;
+				}
+
+				c->depth = basedepth;
+				if (cstate->defresult != NULL)
+				{
+					if (!ExecBcEmitExpr(c, cstate->defresult))
+					{
+						list_free(jumpdone);
+						return false;
+					}
+				}
+				else
+				{
+					idx = ExecBcAppend(c, EBC_CONST);
+					c->steps[idx].d.con.value = (Datum) 0;
+					c->steps[idx].d.con.isnull = true;
+					ExecBcPush(c);
+				}
+
+				foreach(lc, jumpdone)
+					c->steps[lfirst_int(lc)].d.jump.target = c->nsteps;
+				list_free(jumpdone);
+				return true;
+			}
+
+		default:
+			return false;
+	}
+}
+
+/*
+ * One-time sanity checks on the program's Vars, done on first evaluation
+ * when the input slots are available.  This mirrors what ExecEvalScalarVar
+ * does before handing off to ExecEvalScalarVarFast.
+ */
+static void
+ExecBcCheckVars(ExprBytecodeProgram *program, ExprContext *econtext)
+{
+	int			i;
+
+	for (i = 0; i < program->nsteps; i++)
+	{
+		ExprBcStep *step = &program->steps[i];
+		TupleTableSlot *slot;
+		TupleDesc	slot_tupdesc;
+		Form_pg_attribute attr;
+
+		if (step->opcode != EBC_VAR || step->d.var.attnum <= 0)
+			continue;
+
+		switch (step->d.var.varno)
+		{
+			case INNER:
+				slot = econtext->ecxt_innertuple;
+				break;
+			case OUTER:
+				slot = econtext->ecxt_outertuple;
+				break;
+			default:
+				slot = econtext->ecxt_scantuple;
+				break;
+		}
+
+		slot_tupdesc = slot->tts_tupleDescriptor;
+
+		if (step->d.var.attnum > slot_tupdesc->natts)	/* should never happen */
+			elog(ERROR, "attribute number %d exceeds number of columns %d",
+				 step->d.var.attnum, slot_tupdesc->natts);
+
+		attr = slot_tupdesc->attrs[step->d.var.attnum - 1];
+
+		/* can't check type if dropped, since atttypid is probably 0 */
+		if (!attr->attisdropped)
+		{
+			if (step->d.var.vartype != attr->atttypid)
+				ereport(ERROR,
+						(errmsg("attribute %d has wrong type",
+								step->d.var.attnum),
+						 errdetail("Table has type %s, but query expects %s.",
+								   format_type_be(attr->atttypid),
+								   format_type_be(step->d.var.vartype))));
+		}
+	}
+
+	program->var_checked = true;
+}
+
+/* ----------------------------------------------------------------
+ *		ExecEvalBytecode
+ *
+ *		Run a compiled expression program: a single loop dispatching
+ *		over flat opcodes instead of a recursive tree walk.
+ * ----------------------------------------------------------------
+ */
+static Datum
+ExecEvalBytecode(ExprState *state, ExprContext *econtext,
+				 bool *isNull, ExprDoneCond *isDone)
+{
+	ExprBytecodeProgram *program = state->bcprogram;
+	ExprBcStep *steps = program->steps;
+	Datum	   *stack = program->stack;
+	bool	   *stacknull = program->stacknull;
+	int			sp = 0;
+	int			pc = 0;
+
+	if (isDone)
+		*isDone = ExprSingleResult;
+
+	if (!program->var_checked)
+		ExecBcCheckVars(program, econtext);
+
+	for (;;)
+	{
+		ExprBcStep *step = &steps[pc];
+
+		switch (step->opcode)
+		{
+			case EBC_VAR:
+				{
+					TupleTableSlot *slot;
+
+					switch (step->d.var.varno)
+					{
+						case INNER:
+							slot = econtext->ecxt_innertuple;
+							break;
+						case OUTER:
+							slot = econtext->ecxt_outertuple;
+							break;
+						default:
+							slot = econtext->ecxt_scantuple;
+							break;
+					}
+					stack[sp] = slot_getattr(slot, step->d.var.attnum,
+											 &stacknull[sp]);
+					sp++;
+					pc++;
+					break;
+				}
+
+			case EBC_CONST:
+				stack[sp] = step->d.con.value;
+				stacknull[sp] = step->d.con.isnull;
+				sp++;
+				pc++;
+				break;
+
+			case EBC_FUNC:
+				{
+					FunctionCallInfoData *fcinfo = step->d.func.fcinfo;
+					int			nargs = step->d.func.nargs;
+					int			i;
+
+					sp -= nargs;
+
+					if (step->d.func.strict)
+					{
+						bool		anynull = false;
+
+						for (i = 0; i < nargs; i++)
+							anynull |= stacknull[sp + i];
+						if (anynull)
+						{
+							stack[sp] = (Datum) 0;
+							stacknull[sp] = true;
+							sp++;
+							pc++;
+							break;
+						}
+					}
+
+					for (i = 0; i < nargs; i++)
+					{
+						fcinfo->arg[i] = stack[sp + i];
+						fcinfo->argnull[i] = stacknull[sp + i];
+					}
+
+					{
+						PgStat_FunctionCallUsage fcusage;
+
+						pgstat_init_function_usage(fcinfo, &fcusage);
+						fcinfo->isnull = false;
+						stack[sp] = FunctionCallInvoke(fcinfo);
+						stacknull[sp] = fcinfo->isnull;
+						pgstat_end_function_usage(&fcusage, true);
+					}
+					sp++;
+					pc++;
+					break;
+				}
+
+			case EBC_NOT:
+				/* NULL input yields NULL output */
+				if (!stacknull[sp - 1])
+					stack[sp - 1] =
+						BoolGetDatum(!DatumGetBool(stack[sp - 1]));
+				pc++;
+				break;
+
+			case EBC_AND_COMBINE:
+				/* stack holds ..., accumulator, argument value */
+				sp--;
+				if (!stacknull[sp] && !DatumGetBool(stack[sp]))
+				{
+					/* definitively false; short-circuit */
+					stack[sp - 1] = BoolGetDatum(false);
+					stacknull[sp - 1] = false;
+					pc = step->d.jump.target;
+				}
+				else
+				{
+					if (stacknull[sp])
+						stacknull[sp - 1] = true;
+					pc++;
+				}
+				break;
+
+			case EBC_OR_COMBINE:
+				sp--;
+				if (!stacknull[sp] && DatumGetBool(stack[sp]))
+				{
+					/* definitively true; short-circuit */
+					stack[sp - 1] = BoolGetDatum(true);
+					stacknull[sp - 1] = false;
+					pc = step->d.jump.target;
+				}
+				else
+				{
+					if (stacknull[sp])
+						stacknull[sp - 1] = true;
+					pc++;
+				}
+				break;
+
+			case EBC_JUMP:
+				pc = step->d.jump.target;
+				break;
+
+			case EBC_JUMP_IF_NOT_TRUE:
+				sp--;
+				if (stacknull[sp] || !DatumGetBool(stack[sp]))
+					pc = step->d.jump.target;
+				else
+					pc++;
+				break;
+
+			case EBC_DONE:
+				sp--;
+				*isNull = stacknull[sp];
+				return stack[sp];
+
+			default:
+				elog(ERROR, "unrecognized bytecode opcode: %d",
+					 (int) step->opcode);
+		}
+	}
+}
+
+/*
+ * ExecExprBytecodeCompile
+ *		Try to flatten the expression rooted at this ExprState into a
+ *		bytecode program, replacing its evalfunc on success.
+ *
+ * Called at the tail of ExecInitExpr, so compilation proceeds bottom-up:
+ * a compilable subexpression first gets its own program, and is then
+ * subsumed (and its program released) when an enclosing expression
+ * compiles too.  On failure the tree-walking evalfunc is left in place,
+ * and any compiled subexpressions keep their programs.
+ */
+static void
+ExecExprBytecodeCompile(ExprState *state)
+{
+	ExprBcCompiler c;
+	ExprBytecodeProgram *program;
+	ListCell   *lc;
+
+	/*
+	 * Only roots where the program can beat the tree walker are worth the
+	 * memory: a bare Var or Const is already a single call.
+	 */
+	switch (nodeTag(state->expr))
+	{
+		case T_OpExpr:
+		case T_FuncExpr:
+			/* leave the hand-written strict2 fast paths alone */
+			if (state->evalfunc != (ExprStateEvalFunc) ExecEvalOper &&
+				state->evalfunc != (ExprStateEvalFunc) ExecEvalFunc)
+				return;
+			break;
+		case T_BoolExpr:
+		case T_CaseExpr:
+			break;
+		default:
+			return;
+	}
+
+	MemSet(&c, 0, sizeof(c));
+	c.maxsteps = 32;
+	c.steps = (ExprBcStep *) palloc(c.maxsteps * sizeof(ExprBcStep));
+
+	if (!ExecBcEmitExpr(&c, state))
+	{
+		pfree(c.steps);
+		list_free(c.subprograms);
+		return;
+	}
+
+	ExecBcAppend(&c, EBC_DONE);
+	Assert(c.depth == 1);
+
+	program = (ExprBytecodeProgram *) palloc0(sizeof(ExprBytecodeProgram));
+	program->steps = c.steps;
+	program->nsteps = c.nsteps;
+	program->stack = (Datum *) palloc(c.maxdepth * sizeof(Datum));
+	program->stacknull = (bool *) palloc(c.maxdepth * sizeof(bool));
+	program->fallback = state->evalfunc;
+
+	state->bcprogram = program;
+	state->evalfunc = ExecEvalBytecode;
+
+	/* Release programs of subexpressions this one subsumed. */
+	foreach(lc, c.subprograms)
+	{
+		ExprState  *sub = (ExprState *) lfirst(lc);
+		ExprBytecodeProgram *subprog = sub->bcprogram;
+
+		sub->evalfunc = subprog->fallback;
+		sub->bcprogram = NULL;
+		pfree(subprog->steps);
+		pfree(subprog->stack);
+		pfree(subprog->stacknull);
+		pfree(subprog);
+	}
+	list_free(c.subprograms);
+}
+
+
 /*
  * ExecInitExpr: prepare an expression tree for execution
  *
@@ -5944,6 +6582,13 @@ ExecInitExpr(Expr *node, PlanState *parent)
 	/* Common code for all state-node types */
 	state->expr = node;
 
+	/*
+	 * See if this subtree can be flattened into a bytecode program; the
+	 * compiler quietly declines anything it does not support.
+	 */
+	if (gp_enable_expr_bytecode)
+		ExecExprBytecodeCompile(state);
+
 	return state;
 }
 
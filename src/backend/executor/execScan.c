@@ -16,8 +16,12 @@
  */
 #include "postgres.h"
 
+#include "cdb/cdbvars.h"
 #include "executor/executor.h"
+#include "executor/nodeTableScan.h"
 #include "miscadmin.h"
+#include "optimizer/clauses.h"
+#include "portability/instr_time.h"
 #include "utils/memutils.h"
 
 /*
@@ -118,6 +122,229 @@ ExecScanFetch(ScanState *node,
 	return (*accessMtd) (node);
 }
 
+/*
+ * Runtime adaptive qual reordering.
+ *
+ * The planner orders qual lists by estimated cost and selectivity, but for
+ * ad-hoc workloads the estimates are often wrong, and an expensive clause
+ * that rejects almost nothing can end up running first over every tuple of
+ * a large scan.  When gp_enable_adaptive_quals is set and a scan has more
+ * than one qual clause, ExecScan measures the per-clause evaluation time
+ * and rejection rate over a sample of tuples, then re-sorts the clauses so
+ * that the ones that reject the most tuples per unit of work run first.
+ * Sampling repeats periodically, so the order also adapts to correlation
+ * drift within one scan (e.g. a clustered attribute).
+ *
+ * Clauses containing volatile functions are never reordered; for those the
+ * scan falls back to plain in-order ExecQual.  Reordering stable clauses
+ * is fair game: the planner's order_qual_clauses() already reorders them
+ * by estimated cost, so evaluation order is not part of the contract.
+ *
+ * The measured rejection rates are conditional on the current clause order
+ * (a clause is only tested on tuples that survived the clauses before it),
+ * which is what the greedy cost/(1 - selectivity) ranking wants.
+ */
+
+/* tuples measured per sampling phase */
+#define ADQUAL_SAMPLE_TUPLES	1000
+/* tuples between two sampling phases */
+#define ADQUAL_RESAMPLE_INTERVAL	100000
+
+typedef struct AdaptiveQualItem
+{
+	ExprState  *clause;
+	double		ntested;		/* times evaluated in this sample */
+	double		npassed;		/* times it returned true */
+	instr_time	evaltime;		/* total evaluation time in this sample */
+	double		rank;			/* cost / (1 - selectivity), ascending */
+} AdaptiveQualItem;
+
+typedef struct AdaptiveQualState
+{
+	int			nquals;
+	AdaptiveQualItem *items;	/* in current evaluation order */
+	bool		sampling;		/* measuring, or running the sorted order? */
+	double		ntuples;		/* tuples seen in the current phase */
+} AdaptiveQualState;
+
+/*
+ * Build the reordering state for a qual list, or return NULL if the list
+ * is not worth (single clause) or not safe (volatile functions) to reorder.
+ */
+static AdaptiveQualState *
+make_adaptive_qual_state(List *qual)
+{
+	AdaptiveQualState *aqstate;
+	ListCell   *l;
+	int			i;
+
+	if (list_length(qual) < 2)
+		return NULL;
+
+	foreach(l, qual)
+	{
+		ExprState  *clause = (ExprState *) lfirst(l);
+
+		if (contain_volatile_functions((Node *) clause->expr))
+			return NULL;
+	}
+
+	aqstate = (AdaptiveQualState *) palloc0(sizeof(AdaptiveQualState));
+	aqstate->nquals = list_length(qual);
+	aqstate->items = (AdaptiveQualItem *)
+		palloc0(aqstate->nquals * sizeof(AdaptiveQualItem));
+	aqstate->sampling = true;
+
+	i = 0;
+	foreach(l, qual)
+		aqstate->items[i++].clause = (ExprState *) lfirst(l);
+
+	return aqstate;
+}
+
+static int
+adqual_rank_cmp(const void *a, const void *b)
+{
+	const AdaptiveQualItem *ia = (const AdaptiveQualItem *) a;
+	const AdaptiveQualItem *ib = (const AdaptiveQualItem *) b;
+
+	if (ia->rank < ib->rank)
+		return -1;
+	if (ia->rank > ib->rank)
+		return 1;
+	return 0;
+}
+
+/*
+ * End a sampling phase: rank the clauses by measured cost per rejection and
+ * sort them, cheapest-and-most-selective first.
+ */
+static void
+adqual_reorder(AdaptiveQualState *aqstate)
+{
+	int			i;
+
+	for (i = 0; i < aqstate->nquals; i++)
+	{
+		AdaptiveQualItem *item = &aqstate->items[i];
+		double		sel = 1.0;
+		double		cost = 0.0;
+
+		if (item->ntested > 0)
+		{
+			sel = item->npassed / item->ntested;
+			cost = INSTR_TIME_GET_DOUBLE(item->evaltime) / item->ntested;
+		}
+
+		if (sel < 1.0)
+			item->rank = cost / (1.0 - sel);
+		else
+		{
+			/*
+			 * Rejected nothing in the sample; run it last, but still order
+			 * such clauses among themselves by cost.
+			 */
+			item->rank = (cost + 1.0) * 1.0e9;
+		}
+	}
+
+	qsort(aqstate->items, aqstate->nquals, sizeof(AdaptiveQualItem),
+		  adqual_rank_cmp);
+}
+
+/*
+ * Evaluate one qual clause; like one step of ExecQual with resultForNull
+ * false.  Caller has switched into the per-tuple memory context.
+ */
+static inline bool
+adqual_eval_one(ExprState *clause, ExprContext *econtext)
+{
+	Datum		expr_value;
+	bool		isNull;
+
+	expr_value = ExecEvalExpr(clause, econtext, &isNull, NULL);
+	if (isNull)
+		return false;
+	return DatumGetBool(expr_value);
+}
+
+/*
+ * ExecAdaptiveQual
+ *   Qual check with runtime reordering; equivalent to
+ *   ExecQual(qual, econtext, false) apart from clause order.
+ */
+static bool
+ExecAdaptiveQual(AdaptiveQualState *aqstate, ExprContext *econtext)
+{
+	MemoryContext oldContext;
+	bool		result = true;
+	int			i;
+
+	oldContext = MemoryContextSwitchTo(econtext->ecxt_per_tuple_memory);
+
+	if (aqstate->sampling)
+	{
+		for (i = 0; i < aqstate->nquals; i++)
+		{
+			AdaptiveQualItem *item = &aqstate->items[i];
+			instr_time	starttime;
+			instr_time	endtime;
+			bool		pass;
+
+			INSTR_TIME_SET_CURRENT(starttime);
+			pass = adqual_eval_one(item->clause, econtext);
+			INSTR_TIME_SET_CURRENT(endtime);
+			INSTR_TIME_ACCUM_DIFF(item->evaltime, endtime, starttime);
+
+			item->ntested++;
+			if (pass)
+				item->npassed++;
+			else
+			{
+				result = false;
+				break;
+			}
+		}
+
+		if (++aqstate->ntuples >= ADQUAL_SAMPLE_TUPLES)
+		{
+			adqual_reorder(aqstate);
+			aqstate->sampling = false;
+			aqstate->ntuples = 0;
+		}
+	}
+	else
+	{
+		for (i = 0; i < aqstate->nquals; i++)
+		{
+			if (!adqual_eval_one(aqstate->items[i].clause, econtext))
+			{
+				result = false;
+				break;
+			}
+		}
+
+		if (++aqstate->ntuples >= ADQUAL_RESAMPLE_INTERVAL)
+		{
+			/* forget the old sample and measure again */
+			for (i = 0; i < aqstate->nquals; i++)
+			{
+				AdaptiveQualItem *item = &aqstate->items[i];
+
+				item->ntested = 0;
+				item->npassed = 0;
+				INSTR_TIME_SET_ZERO(item->evaltime);
+			}
+			aqstate->sampling = true;
+			aqstate->ntuples = 0;
+		}
+	}
+
+	MemoryContextSwitchTo(oldContext);
+
+	return result;
+}
+
 /* ----------------------------------------------------------------
  *		ExecScan
  *
@@ -148,6 +375,7 @@ ExecScan(ScanState *node,
 	ExprContext *econtext;
 	List	   *qual;
 	ProjectionInfo *projInfo;
+	AdaptiveQualState *aqstate;
 
 	/*
 	 * Fetch data from node
@@ -162,6 +390,17 @@ ExecScan(ScanState *node,
 	if (!qual && !projInfo)
 		return ExecScanFetch(node, accessMtd, recheckMtd);
 
+	/*
+	 * Decide once per scan whether the qual list can be reordered at
+	 * runtime; see make_adaptive_qual_state.
+	 */
+	if (qual && gp_enable_adaptive_quals && !node->ss_aqchecked)
+	{
+		node->ss_aqstate = make_adaptive_qual_state(qual);
+		node->ss_aqchecked = true;
+	}
+	aqstate = gp_enable_adaptive_quals ? node->ss_aqstate : NULL;
+
 	/*
 	 * Reset per-tuple memory context to free any expression evaluation
 	 * storage allocated in the previous tuple cycle.  
@@ -210,7 +449,9 @@ ExecScan(ScanState *node,
 		 * when the qual is nil ... saves only a few cycles, but they add up
 		 * ...
 		 */
-		if (!qual || ExecQual(qual, econtext, false))
+		if (!qual ||
+			(aqstate ? ExecAdaptiveQual(aqstate, econtext)
+					 : ExecQual(qual, econtext, false)))
 		{
 			/*
 			 * Found a satisfactory scan tuple.
@@ -239,6 +480,66 @@ ExecScan(ScanState *node,
 	}
 }
 
+/*
+ * ExecScanSupportsDirectFetch
+ *   Decide whether a consumer that drains its child tuple-by-tuple may
+ *   fetch from it with ExecScanDirectFetch instead of ExecProcNode.
+ *
+ * ExecProcNode pays for dispatch, instrumentation, gpperfmon and subplan
+ * bookkeeping on every tuple.  A node that consumes its whole input in a
+ * tight loop (e.g. the HashAgg load phase) can skip that per-tuple
+ * overhead and call into the scan directly, provided nothing above needs
+ * the per-tuple accounting: no EXPLAIN ANALYZE instrumentation, no
+ * gpperfmon packets, and no subplans hanging off the scan's quals (those
+ * are squelched by ExecProcNode when the scan is exhausted).
+ *
+ * The consumer must have fetched at least one tuple through ExecProcNode
+ * first, so that one-time work (rescan on chgParam, gpmon node-start)
+ * has already happened.
+ */
+bool
+ExecScanSupportsDirectFetch(PlanState *ps)
+{
+	return (IsA(ps, TableScanState) &&
+			ps->instrument == NULL &&
+			ps->subPlan == NIL &&
+			!gp_enable_gpperfmon);
+}
+
+/*
+ * ExecScanDirectFetch
+ *   Fetch the next tuple from a scan node, bypassing ExecProcNode.
+ *
+ * Only legal when ExecScanSupportsDirectFetch said so and a tuple has
+ * already been fetched through ExecProcNode.
+ */
+TupleTableSlot *
+ExecScanDirectFetch(PlanState *ps)
+{
+	TupleTableSlot *result;
+
+	Assert(ExecScanSupportsDirectFetch(ps));
+
+	/* A rescan request must go through the normal path. */
+	if (ps->chgParam != NULL)
+		return ExecProcNode(ps);
+
+	/* ExecScan only checks these when it has a qual or projection to do. */
+	CHECK_FOR_INTERRUPTS();
+
+	if (QueryFinishPending)
+		return NULL;
+
+	/* Keep the scan's allocations charged to its own account. */
+	START_MEMORY_ACCOUNT(ps->plan->memoryAccountId);
+	{
+		result = ExecTableScan((TableScanState *) ps);
+	}
+	END_MEMORY_ACCOUNT();
+
+	return result;
+}
+
 /*
  * ExecAssignScanProjectionInfo
  *		Set up projection info for a scan node, if necessary.
@@ -99,6 +99,7 @@
 #include "storage/bufmgr.h"
 #include "utils/builtins.h"
 #include "utils/lsyscache.h"
+#include "utils/syscache.h"
 #include "utils/typcache.h"
 
 #include "cdb/cdbvars.h"                    /* Gp_segment */
@@ -686,6 +687,40 @@ ExecCopySlotMemTupleTo(TupleTableSlot *slot, MemoryContext pctxt, char *dest, un
 	Assert(mtup);
 	return mtup;
 }
+
+/* --------------------------------
+ *		ExecCopySlotMemTupleToBuffer
+ *			Copy the slot's minimal physical tuple into a caller-owned
+ *			resizable buffer, growing the buffer (in bufcxt) only when
+ *			the tuple does not fit.
+ *
+ *		The buffer follows the same high-watermark discipline as the
+ *		slot-internal PRIVATE_tts_mtup_buf: callers that copy one tuple
+ *		per row stop paying a palloc per row once the buffer has grown
+ *		to the widest row seen.  *buf may be NULL/0 initially; the
+ *		buffer belongs to the caller and is reclaimed with bufcxt.
+ * --------------------------------
+ */
+MemTuple
+ExecCopySlotMemTupleToBuffer(TupleTableSlot *slot, MemoryContext bufcxt,
+							 char **buf, unsigned int *buflen)
+{
+	unsigned int tuplen = *buflen;
+	MemTuple mtup = ExecCopySlotMemTupleTo(slot, NULL, *buf, &tuplen);
+
+	if (!mtup)
+	{
+		if (*buf)
+			pfree(*buf);
+		*buf = MemoryContextAlloc(bufcxt, tuplen);
+		*buflen = tuplen;
+
+		mtup = ExecCopySlotMemTupleTo(slot, NULL, *buf, &tuplen);
+		Assert(mtup);
+	}
+
+	return mtup;
+}
 		
 /* --------------------------------
  *		ExecFetchSlotTuple
@@ -1206,11 +1241,13 @@ TupleDescGetAttInMetadata(TupleDesc tupdesc)
 {
 	int			natts = tupdesc->natts;
 	int			i;
+	int			nfetch;
 	Oid			atttypeid;
-	Oid			attinfuncid;
 	FmgrInfo   *attinfuncinfo;
 	Oid		   *attioparams;
 	int32	   *atttypmods;
+	Datum	   *typekeys;
+	HeapTuple  *typetuples;
 	AttInMetadata *attinmeta;
 
 	attinmeta = (AttInMetadata *) palloc(sizeof(AttInMetadata));
@@ -1219,23 +1256,63 @@ TupleDescGetAttInMetadata(TupleDesc tupdesc)
 	attinmeta->tupdesc = BlessTupleDesc(tupdesc);
 
 	/*
-	 * Gather info needed later to call the "in" function for each attribute
+	 * Gather info needed later to call the "in" function for each attribute.
+	 * The pg_type tuples for all the (non-dropped) attributes are fetched
+	 * with a single batched syscache lookup.
 	 */
 	attinfuncinfo = (FmgrInfo *) palloc0(natts * sizeof(FmgrInfo));
 	attioparams = (Oid *) palloc0(natts * sizeof(Oid));
 	atttypmods = (int32 *) palloc0(natts * sizeof(int32));
+	typekeys = (Datum *) palloc(natts * sizeof(Datum));
+	typetuples = (HeapTuple *) palloc(natts * sizeof(HeapTuple));
 
+	nfetch = 0;
 	for (i = 0; i < natts; i++)
 	{
-		/* Ignore dropped attributes */
 		if (!tupdesc->attrs[i]->attisdropped)
-		{
-			atttypeid = tupdesc->attrs[i]->atttypid;
-			getTypeInputInfo(atttypeid, &attinfuncid, &attioparams[i]);
-			fmgr_info(attinfuncid, &attinfuncinfo[i]);
-			atttypmods[i] = tupdesc->attrs[i]->atttypmod;
-		}
+			typekeys[nfetch++] = ObjectIdGetDatum(tupdesc->attrs[i]->atttypid);
+	}
+
+	SearchSysCacheBatch(TYPEOID, nfetch,
+						typekeys, NULL, NULL, NULL, typetuples);
+
+	nfetch = 0;
+	for (i = 0; i < natts; i++)
+	{
+		HeapTuple	typetuple;
+		Form_pg_type pt;
+
+		/* Ignore dropped attributes */
+		if (tupdesc->attrs[i]->attisdropped)
+			continue;
+
+		atttypeid = tupdesc->attrs[i]->atttypid;
+		typetuple = typetuples[nfetch++];
+
+		/* same checks as getTypeInputInfo() */
+		if (!HeapTupleIsValid(typetuple))
+			elog(ERROR, "cache lookup failed for type %u", atttypeid);
+		pt = (Form_pg_type) GETSTRUCT(typetuple);
+		if (!pt->typisdefined)
+			ereport(ERROR,
+					(errcode(ERRCODE_UNDEFINED_OBJECT),
+					 errmsg("type %s is only a shell",
+							format_type_be(atttypeid))));
+		if (!OidIsValid(pt->typinput))
+			ereport(ERROR,
+					(errcode(ERRCODE_UNDEFINED_FUNCTION),
+					 errmsg("no input function available for type %s",
+							format_type_be(atttypeid))));
+
+		attioparams[i] = getTypeIOParam(typetuple);
+		fmgr_info(pt->typinput, &attinfuncinfo[i]);
+		atttypmods[i] = tupdesc->attrs[i]->atttypmod;
+
+		ReleaseSysCache(typetuple);
 	}
+
+	pfree(typekeys);
+	pfree(typetuples);
 	attinmeta->attinfuncs = attinfuncinfo;
 	attinmeta->attioparams = attioparams;
 	attinmeta->atttypmods = atttypmods;
@@ -330,13 +330,13 @@ CreateExprContext(EState *estate)
 
 	/*
 	 * Create working memory for expression evaluation in this context.
+	 * Everything palloc'd here dies at the next ResetExprContext(), so use
+	 * the cheaper append-only Generation allocator rather than an AllocSet.
 	 */
 	econtext->ecxt_per_tuple_memory =
-		AllocSetContextCreate(estate->es_query_cxt,
-							  "ExprContext",
-							  ALLOCSET_DEFAULT_MINSIZE,
-							  ALLOCSET_DEFAULT_INITSIZE,
-							  ALLOCSET_DEFAULT_MAXSIZE);
+		GenerationContextCreate(estate->es_query_cxt,
+								"ExprContext",
+								ALLOCSET_DEFAULT_INITSIZE);
 
 	econtext->ecxt_param_exec_vals = estate->es_param_exec_vals;
 	econtext->ecxt_param_list_info = estate->es_param_list_info;
@@ -401,13 +401,13 @@ CreateStandaloneExprContext(void)
 
 	/*
 	 * Create working memory for expression evaluation in this context.
+	 * As in CreateExprContext, per-tuple lifetimes suit the Generation
+	 * allocator.
 	 */
 	econtext->ecxt_per_tuple_memory =
-		AllocSetContextCreate(CurrentMemoryContext,
-							  "ExprContext",
-							  ALLOCSET_DEFAULT_MINSIZE,
-							  ALLOCSET_DEFAULT_INITSIZE,
-							  ALLOCSET_DEFAULT_MAXSIZE);
+		GenerationContextCreate(CurrentMemoryContext,
+								"ExprContext",
+								ALLOCSET_DEFAULT_INITSIZE);
 
 	econtext->ecxt_param_exec_vals = NULL;
 	econtext->ecxt_param_list_info = NULL;
@@ -18,9 +18,12 @@
 
 #include "postgres.h"
 
+#include <sys/mman.h>
+
 #include "storage/buffile.h"
 #include "storage/bfz.h"
 #include "executor/execWorkfile.h"
+#include "executor/instrument.h"
 #include "miscadmin.h"
 #include "cdb/cdbvars.h"
 #include "utils/workfile_mgr.h"
@@ -38,6 +41,32 @@ static uint64 temp_file_counter = 0;
 static void ExecWorkFile_SetFlags(ExecWorkFile *workfile, bool delOnClose, bool created);
 static void ExecWorkFile_AdjustBFZSize(ExecWorkFile *workfile, int64 file_size);
 
+/*
+ * Workfile I/O is totted up in pgWorkfileUsage so EXPLAIN ANALYZE can
+ * attribute spill traffic to plan nodes (see WorkfileUsage in instrument.h).
+ * The clock is only read once an instrumented query has run in this backend.
+ */
+static inline void
+workfile_io_start(instr_time *start)
+{
+	if (workfile_instr_timing)
+		INSTR_TIME_SET_CURRENT(*start);
+	else
+		INSTR_TIME_SET_ZERO(*start);
+}
+
+static inline void
+workfile_io_done(instr_time *start)
+{
+	if (!INSTR_TIME_IS_ZERO(*start))
+	{
+		instr_time	endtime;
+
+		INSTR_TIME_SET_CURRENT(endtime);
+		INSTR_TIME_ACCUM_DIFF(pgWorkfileUsage.io_time, endtime, *start);
+	}
+}
+
 /*
  * ExecWorkFile_Create
  *    create a new work file with the specified name, the file type,
@@ -85,6 +114,8 @@ ExecWorkFile_Create(const char *fileName,
 	workfile->size = 0;
 	ExecWorkFile_SetFlags(workfile, delOnClose, true /* created */);
 
+	pgWorkfileUsage.files_created++;
+
 	return workfile;
 }
 
@@ -202,6 +233,7 @@ ExecWorkFile_Write(ExecWorkFile *workfile,
 {
 	Assert(workfile != NULL);
 	uint64 bytes;
+	instr_time	iostart;
 
 	SIMPLE_FAULT_INJECTOR(WorkfileWriteFail);
 
@@ -210,6 +242,8 @@ ExecWorkFile_Write(ExecWorkFile *workfile,
 		return false;
 	}
 
+	workfile_io_start(&iostart);
+
 	/* Test the per-query and per-segment limit */
 	if ((workfile->flags & EXEC_WORKFILE_LIMIT_SIZE) &&
 			!WorkfileDiskspace_Reserve(size))
@@ -281,6 +315,9 @@ ExecWorkFile_Write(ExecWorkFile *workfile,
 			insist_log(false, "invalid work file type: %d", workfile->fileType);
 	}
 
+	pgWorkfileUsage.bytes_written += size;
+	workfile_io_done(&iostart);
+
 	return true;
 }
 
@@ -301,7 +338,10 @@ ExecWorkFile_Read(ExecWorkFile *workfile,
 {
 	Assert(workfile != NULL);
 	uint64 bytes = 0;
-	
+	instr_time	iostart;
+
+	workfile_io_start(&iostart);
+
 	switch(workfile->fileType)
 	{
 		case BUFFILE:
@@ -314,7 +354,10 @@ ExecWorkFile_Read(ExecWorkFile *workfile,
 		default:
 			insist_log(false, "invalid work file type: %d", workfile->fileType);
 	}
-	
+
+	pgWorkfileUsage.bytes_read += bytes;
+	workfile_io_done(&iostart);
+
 	return bytes;
 }
 
@@ -346,6 +389,9 @@ ExecWorkFile_ReadFromBuffer(ExecWorkFile *workfile,
 			insist_log(false, "invalid work file type: %d", workfile->fileType);
 	}
 
+	if (data != NULL)
+		pgWorkfileUsage.bytes_read += size;
+
 	return data;
 }
 
@@ -561,6 +607,26 @@ ExecWorkFile_Seek(ExecWorkFile *workfile, uint64 offset, int whence)
 	return result;
 }
 
+/*
+ * ExecWorkFile_Prefetch
+ *   Advise the OS to read a range of the workfile into the page cache ahead
+ *   of an upcoming read.  This is a hint only: the logical file position is
+ *   unchanged and failures are silently ignored.
+ */
+void
+ExecWorkFile_Prefetch(ExecWorkFile *workfile, int64 offset, int amount)
+{
+	Assert(workfile != NULL);
+	switch(workfile->fileType)
+	{
+	case BUFFILE:
+		(void) BufFilePrefetch((BufFile *) workfile->file, offset, amount);
+		break;
+	default:
+		insist_log(false, "invalid work file type: %d", workfile->fileType);
+	}
+}
+
 void
 ExecWorkFile_Flush(ExecWorkFile *workfile)
 {
@@ -575,6 +641,64 @@ ExecWorkFile_Flush(ExecWorkFile *workfile)
 	}
 }
 
+/*
+ * ExecWorkFile_Mmap
+ *    Map the current contents of a workfile read-only into the address
+ * space, so readers can serve data straight from the OS page cache
+ * without read() syscalls.
+ *
+ * Only uncompressed BUFFILE workfiles can be mapped; for anything else
+ * (or if mmap itself fails) NULL is returned and the caller should keep
+ * using ExecWorkFile_Read.  Any buffered writes are flushed first, so the
+ * mapping covers everything written to the file so far; data written
+ * after the call is not guaranteed to be visible through it.
+ *
+ * On success, *length is set to the mapped size.  The mapping remains
+ * valid after the file is closed or unlinked; release it with
+ * ExecWorkFile_Munmap.
+ */
+void *
+ExecWorkFile_Mmap(ExecWorkFile *workfile, int64 *length)
+{
+	int			fd;
+	int64		size;
+	void	   *addr;
+
+	Assert(workfile != NULL);
+
+	if (workfile->fileType != BUFFILE)
+		return NULL;
+
+	ExecWorkFile_Flush(workfile);
+
+	size = BufFileGetSize((BufFile *) workfile->file);
+	if (size <= 0)
+		return NULL;
+
+	fd = BufFileGetRawDesc((BufFile *) workfile->file);
+	if (fd < 0)
+		return NULL;
+
+	addr = mmap(NULL, (size_t) size, PROT_READ, MAP_SHARED, fd, 0);
+	if (addr == MAP_FAILED)
+		return NULL;
+
+	*length = size;
+	return addr;
+}
+
+/*
+ * ExecWorkFile_Munmap
+ *    Release a mapping created by ExecWorkFile_Mmap.
+ */
+void
+ExecWorkFile_Munmap(void *addr, int64 length)
+{
+	Assert(addr != NULL);
+
+	munmap(addr, (size_t) length);
+}
+
 /*
  * Suspend a file without closing it. For bfz, which allocates a buffer for
  * each open a file, this frees up that buffer but keeps the fd so we can
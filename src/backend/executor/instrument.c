@@ -23,6 +23,21 @@
 #include "utils/memutils.h"
 
 BufferUsage pgBufferUsage;
+WorkfileUsage pgWorkfileUsage;
+
+/*
+ * Set once CDB instrumentation is requested in this backend; tells
+ * execWorkfile.c to time its reads and writes.  Never reset: the clock
+ * reads are cheap relative to the file I/O they bracket.
+ */
+bool		workfile_instr_timing = false;
+
+/*
+ * Calibrated TSC frequency in ticks per second, for the low-overhead
+ * timing mode (gp_instrument_rdtsc).  0 means not yet calibrated; a
+ * negative value means the TSC is unusable in this backend.
+ */
+static double instr_tsc_hz = 0;
 
 static void BufferUsageAccumDiff(BufferUsage *dst,
 					 const BufferUsage *add, const BufferUsage *sub);
@@ -39,6 +54,73 @@ static int  shmemNumSlots = -1;
 static bool instrumentResownerCallbackRegistered = false;
 static InstrumentationResownerSet *slotsOccupied = NULL;
 
+/*
+ * Calibrate the TSC against the instr_time clock, once per backend: spin
+ * for a couple of milliseconds and compute ticks per second from the two
+ * clocks' deltas.  Sets instr_tsc_hz negative if the TSC is unavailable
+ * or did not advance, in which case timing falls back to instr_time.
+ */
+static void
+InstrCalibrateTsc(void)
+{
+#ifdef INSTR_HAVE_TSC
+	instr_time	t0,
+				t1;
+	uint64		tsc0,
+				tsc1;
+	double		elapsed;
+
+	if (instr_tsc_hz != 0)
+		return;
+
+	INSTR_TIME_SET_CURRENT(t0);
+	tsc0 = instr_read_tsc();
+	do
+	{
+		INSTR_TIME_SET_CURRENT(t1);
+		elapsed = INSTR_TIME_GET_DOUBLE(t1) - INSTR_TIME_GET_DOUBLE(t0);
+	} while (elapsed < 0.002);
+	tsc1 = instr_read_tsc();
+
+	if (tsc1 > tsc0)
+		instr_tsc_hz = (double) (tsc1 - tsc0) / elapsed;
+	else
+		instr_tsc_hz = -1;
+#else
+	instr_tsc_hz = -1;
+#endif
+}
+
+/*
+ * Seconds accumulated for the current cycle of this node, combining the
+ * instr_time counter with any TSC ticks from the low-overhead mode.
+ */
+double
+InstrGetElapsed(Instrumentation *instr)
+{
+	double		result = INSTR_TIME_GET_DOUBLE(instr->counter);
+
+	if (instr->tsccounter > 0 && instr_tsc_hz > 0)
+		result += (double) instr->tsccounter / instr_tsc_hz;
+
+	return result;
+}
+
+/*
+ * Fill in the timing-mode parameters of a new Instrumentation from the
+ * gp_instrument_rdtsc and gp_instrument_timing_interval GUCs.
+ */
+static void
+InstrSetTimingMode(Instrumentation *instr)
+{
+	if (gp_instrument_rdtsc)
+	{
+		InstrCalibrateTsc();
+		instr->use_tsc = (instr_tsc_hz > 0);
+	}
+	instr->timerinterval = gp_instrument_timing_interval;
+}
+
 /* Allocate new instrumentation structure(s) */
 Instrumentation *
 InstrAlloc(int n, int instrument_options)
@@ -59,7 +141,12 @@ InstrAlloc(int n, int instrument_options)
 			instr[i].needs_bufusage = need_buffers;
 			instr[i].need_timer = need_timer;
 			instr[i].need_cdb = need_cdb;
+			if (need_timer)
+				InstrSetTimingMode(&instr[i]);
 		}
+
+		if (need_cdb)
+			workfile_instr_timing = true;
 	}
 
 	return instr;
@@ -74,14 +161,26 @@ InstrAlloc(int n, int instrument_options)
 void
 InstrStartNode(Instrumentation *instr)
 {
-	if (INSTR_TIME_IS_ZERO(instr->starttime))
-		INSTR_TIME_SET_CURRENT(instr->starttime);
-	else
-		elog(DEBUG2, "InstrStartNode called twice in a row");
+	instr->itercount++;
+	if (instr->use_tsc)
+	{
+		if (INSTR_SHOULD_TIME(instr))
+			instr->starttsc = instr_read_tsc();
+	}
+	else if (INSTR_SHOULD_TIME(instr))
+	{
+		if (INSTR_TIME_IS_ZERO(instr->starttime))
+			INSTR_TIME_SET_CURRENT(instr->starttime);
+		else
+			elog(DEBUG2, "InstrStartNode called twice in a row");
+	}
 
 	/* initialize buffer usage per plan node */
 	if (instr->needs_bufusage)
 		instr->bufusage_start = pgBufferUsage;
+
+	if (instr->need_cdb)
+		instr->wfusage_start = pgWorkfileUsage;
 }
 
 /* Exit from a plan node */
@@ -93,32 +192,62 @@ InstrStartNode(Instrumentation *instr)
 void
 InstrStopNode(Instrumentation *instr, uint64 nTuples)
 {
-	instr_time	endtime;
-
 	/* count the returned tuples */
 	instr->tuplecount += nTuples;
 
-	if (INSTR_TIME_IS_ZERO(instr->starttime))
+	if (instr->use_tsc)
+	{
+		if (instr->starttsc != 0)
+		{
+			instr->tsccounter += instr_read_tsc() - instr->starttsc;
+			instr->starttsc = 0;
+			instr->timedcount++;
+		}
+		else if (instr->timerinterval <= 1)
+		{
+			elog(DEBUG2, "InstrStopNode called without start");
+			return;
+		}
+	}
+	else if (!INSTR_TIME_IS_ZERO(instr->starttime))
+	{
+		instr_time	endtime;
+
+		INSTR_TIME_SET_CURRENT(endtime);
+		INSTR_TIME_ACCUM_DIFF(instr->counter, endtime, instr->starttime);
+		INSTR_TIME_SET_ZERO(instr->starttime);
+		instr->timedcount++;
+	}
+	else if (instr->timerinterval <= 1)
 	{
 		elog(DEBUG2, "InstrStopNode called without start");
 		return;
 	}
 
-	INSTR_TIME_SET_CURRENT(endtime);
-	INSTR_TIME_ACCUM_DIFF(instr->counter, endtime, instr->starttime);
-
-	INSTR_TIME_SET_ZERO(instr->starttime);
-
 	/* Adds delta of buffer usage to node's count. */
 	if (instr->needs_bufusage)
 		BufferUsageAccumDiff(&instr->bufusage,
 							 &pgBufferUsage, &instr->bufusage_start);
 
+	/* Adds delta of workfile I/O to node's count. */
+	if (instr->need_cdb)
+	{
+		instr->wfusage.bytes_written +=
+			pgWorkfileUsage.bytes_written - instr->wfusage_start.bytes_written;
+		instr->wfusage.bytes_read +=
+			pgWorkfileUsage.bytes_read - instr->wfusage_start.bytes_read;
+		instr->wfusage.files_created +=
+			pgWorkfileUsage.files_created - instr->wfusage_start.files_created;
+		INSTR_TIME_ACCUM_DIFF(instr->wfusage.io_time,
+							  pgWorkfileUsage.io_time,
+							  instr->wfusage_start.io_time);
+	}
+
 	/* Is this the first tuple of this cycle? */
 	if (!instr->running)
 	{
 		instr->running = true;
-		instr->firsttuple = INSTR_TIME_GET_DOUBLE(instr->counter);
+		instr->firsttuple = InstrGetElapsed(instr);
 		/* CDB: save this start time as the first start */
 		instr->firststart = instr->starttime;
 	}
@@ -140,7 +269,15 @@ InstrEndLoop(Instrumentation *instr)
 		elog(DEBUG2, "InstrEndLoop called on running node");
 
 	/* Accumulate per-cycle statistics into totals */
-	totaltime = INSTR_TIME_GET_DOUBLE(instr->counter);
+	totaltime = InstrGetElapsed(instr);
+
+	/*
+	 * If only every Nth invocation was timed, extrapolate the cycle total
+	 * from the timed sample.  The first-tuple time is always measured
+	 * directly, so startup time needs no scaling.
+	 */
+	if (instr->timedcount > 0 && instr->itercount > instr->timedcount)
+		totaltime *= (double) instr->itercount / (double) instr->timedcount;
 
 	/* CDB: Report startup time from only the first cycle. */
 	if (instr->nloops == 0)
@@ -154,6 +291,10 @@ InstrEndLoop(Instrumentation *instr)
 	instr->running = false;
 	INSTR_TIME_SET_ZERO(instr->starttime);
 	INSTR_TIME_SET_ZERO(instr->counter);
+	instr->starttsc = 0;
+	instr->tsccounter = 0;
+	instr->itercount = 0;
+	instr->timedcount = 0;
 	instr->firsttuple = 0;
 	instr->tuplecount = 0;
 }
@@ -371,6 +512,8 @@ pickInstrFromShmem(const Plan *plan, int instrument_options)
 	{
 		instr->need_timer = (instrument_options & INSTRUMENT_TIMER) != 0;
 		instr->need_cdb = (instrument_options & INSTRUMENT_CDB) != 0;
+		if (instr->need_timer)
+			InstrSetTimingMode(instr);
 	}
 
 	return instr;
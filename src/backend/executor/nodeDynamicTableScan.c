@@ -32,6 +32,7 @@
 #include "cdb/cdbpartition.h"
 #include "cdb/cdbvars.h"
 #include "cdb/partitionselection.h"
+#include "storage/bufmgr.h"
 
 static inline void
 CleanupOnePartition(ScanState *scanState);
@@ -54,6 +55,8 @@ ExecInitDynamicTableScan(DynamicTableScan *node, EState *estate, int eflags)
 
 	state->firstPartition = true;
 
+	state->nextPidValid = false;
+
 	/* lastRelOid is used to remap varattno for heterogeneous partitions */
 	state->lastRelOid = reloid;
 
@@ -72,6 +75,53 @@ ExecInitDynamicTableScan(DynamicTableScan *node, EState *estate, int eflags)
 	return state;
 }
 
+/*
+ * prefetchNextPartition
+ *   Peek at the next partition to scan and ask the OS to read its first
+ * blocks ahead of time.
+ *
+ * The pid index is consumed one step ahead of the scan: the peeked pid is
+ * stashed in the scan state, and initNextTableToScan picks it up when the
+ * current partition is exhausted. By then the kernel has (hopefully) pulled
+ * the next partition's first blocks into the page cache, so the startup of
+ * one partition overlaps with the draining of the previous one instead of
+ * serializing behind it. Only heap partitions go through the buffer
+ * manager; append-only partitions are skipped.
+ */
+static void
+prefetchNextPartition(DynamicTableScanState *node)
+{
+#ifdef USE_PREFETCH
+	Oid		   *pid;
+	Relation	nextRel;
+
+	if (target_prefetch_pages <= 0)
+		return;
+
+	pid = hash_seq_search(&node->pidStatus);
+	if (pid == NULL)
+	{
+		node->shouldCallHashSeqTerm = false;
+		return;
+	}
+
+	node->nextPid = *pid;
+	node->nextPidValid = true;
+
+	nextRel = OpenScanRelationByOid(node->nextPid);
+	if (RelationIsHeap(nextRel))
+	{
+		BlockNumber nblocks = RelationGetNumberOfBlocks(nextRel);
+		BlockNumber nprefetch = Min(nblocks, (BlockNumber) target_prefetch_pages);
+		BlockNumber blkno;
+
+		for (blkno = 0; blkno < nprefetch; blkno++)
+			PrefetchBuffer(nextRel, MAIN_FORKNUM, blkno);
+	}
+	CloseScanRelation(nextRel);
+#endif   /* USE_PREFETCH */
+}
+
 /*
  * initNextTableToScan
  *   Find the next table to scan and initiate the scan if the previous table
@@ -89,13 +139,30 @@ initNextTableToScan(DynamicTableScanState *node)
 	if (scanState->scan_state == SCAN_INIT ||
 		scanState->scan_state == SCAN_DONE)
 	{
-		Oid *pid = hash_seq_search(&node->pidStatus);
-		if (pid == NULL)
+		Oid partOid;
+
+		if (node->nextPidValid)
 		{
-			node->shouldCallHashSeqTerm = false;
+			/* prefetchNextPartition already pulled this pid off the index */
+			partOid = node->nextPid;
+			node->nextPidValid = false;
+		}
+		else if (!node->shouldCallHashSeqTerm)
+		{
+			/* the pid index has been fully consumed by the look-ahead */
 			return false;
 		}
-		
+		else
+		{
+			Oid *pid = hash_seq_search(&node->pidStatus);
+			if (pid == NULL)
+			{
+				node->shouldCallHashSeqTerm = false;
+				return false;
+			}
+			partOid = *pid;
+		}
+
 		/* Collect number of partitions scanned in EXPLAIN ANALYZE */
 		if (NULL != scanState->ps.instrument)
 		{
@@ -112,9 +179,9 @@ initNextTableToScan(DynamicTableScanState *node)
 		 * to return correct partition oid, we need to update
 		 * our tuple table slot's oid to reflect the partition oid.
 		 */
-		scanState->ss_ScanTupleSlot->tts_tableOid = *pid;
+		scanState->ss_ScanTupleSlot->tts_tableOid = partOid;
 
-		scanState->ss_currentRelation = OpenScanRelationByOid(*pid);
+		scanState->ss_currentRelation = OpenScanRelationByOid(partOid);
 		Relation lastScannedRel = OpenScanRelationByOid(node->lastRelOid);
 		TupleDesc lastTupDesc = RelationGetDescr(lastScannedRel);
 		CloseScanRelation(lastScannedRel);
@@ -137,7 +204,7 @@ initNextTableToScan(DynamicTableScanState *node)
 			 * Now that the varattno mapping has been changed, change the relation that
 			 * the new varnos correspond to
 			 */
-			node->lastRelOid = *pid;
+			node->lastRelOid = partOid;
 		}
 
 		/*
@@ -167,6 +234,13 @@ initNextTableToScan(DynamicTableScanState *node)
 		
 		scanState->tableType = getTableType(scanState->ss_currentRelation);
 		BeginTableScanRelation(scanState);
+
+		/*
+		 * Kick off readahead for the partition after this one while we
+		 * drain the one we just opened.
+		 */
+		if (node->shouldCallHashSeqTerm && !node->nextPidValid)
+			prefetchNextPartition(node);
 	}
 
 	return true;
@@ -263,6 +337,8 @@ DynamicTableScanEndCurrentScan(DynamicTableScanState *node)
 {
 	CleanupOnePartition((ScanState*)node);
 
+	node->nextPidValid = false;
+
 	if (node->shouldCallHashSeqTerm)
 	{
 		hash_seq_term(&node->pidStatus);
@@ -41,6 +41,7 @@
 #include "utils/lsyscache.h"
 #include "utils/faultinjector.h"
 #include "utils/syscache.h"
+#include "utils/vmem_tracker.h"
 
 #include "cdb/cdbexplain.h"
 #include "cdb/cdbvars.h"
@@ -131,6 +132,9 @@ MultiExecHash(HashState *node)
 		{
 			int			bucketNumber;
 
+			if (hashtable->bloomfilter)
+				ExecHashBloomAdd(hashtable, hashvalue);
+
 			bucketNumber = ExecHashGetSkewBucket(hashtable, hashvalue);
 			if (bucketNumber != INVALID_SKEW_BUCKET_NO)
 			{
@@ -324,9 +328,12 @@ ExecHashTableCreate(HashState *hashState, HashJoinState *hjstate, List *hashOper
 	hashtable->nbatch_original = nbatch;
 	hashtable->nbatch_outstart = nbatch;
 	hashtable->growEnabled = true;
+	hashtable->prespill_serial = RedZoneHandler_GetPreSpillRequestCount();
 	hashtable->totalTuples = 0;
 	hashtable->innerBatchFile = NULL;
 	hashtable->outerBatchFile = NULL;
+	hashtable->innerBatchSpill = NULL;
+	hashtable->outerBatchSpill = NULL;
 	hashtable->work_set = NULL;
 	hashtable->spaceUsed = 0;
 	hashtable->spaceAllowed = operatorMemKB * 1024L;
@@ -334,6 +341,9 @@ ExecHashTableCreate(HashState *hashState, HashJoinState *hjstate, List *hashOper
 	hashtable->spaceUsedSkew = 0;
 	hashtable->spaceAllowedSkew =
 		hashtable->spaceAllowed * SKEW_WORK_MEM_PERCENT / 100;
+	hashtable->bloomfilter = NULL;
+	hashtable->bloomchecked = 0;
+	hashtable->bloomfiltered = 0;
 	hashtable->stats = NULL;
 	hashtable->eagerlyReleased = false;
 	hashtable->hjstate = hjstate;
@@ -400,11 +410,30 @@ ExecHashTableCreate(HashState *hashState, HashJoinState *hjstate, List *hashOper
 			palloc0(nbatch * sizeof(ExecWorkFile *));
 		hashtable->outerBatchFile = (ExecWorkFile **)
 			palloc0(nbatch * sizeof(ExecWorkFile *));
+		hashtable->innerBatchSpill = (HashJoinBatchSpill *)
+			palloc0(nbatch * sizeof(HashJoinBatchSpill));
+		hashtable->outerBatchSpill = (HashJoinBatchSpill *)
+			palloc0(nbatch * sizeof(HashJoinBatchSpill));
 		/* The files will not be opened until needed... */
 		/* ... but make sure we have temp tablespaces established for them */
 		PrepareTempTablespaces();
 	}
 
+	/*
+	 * If the join emits nothing for an unmatched outer tuple, overlay the
+	 * table with a Bloom filter so the probe side can discard such tuples
+	 * before they reach the buckets or the outer batch files.  The filter
+	 * must cover spilled inner tuples too, so unlike the buckets it lives
+	 * in hashCxt for the whole join.
+	 */
+	if (gp_hashjoin_bloom_filter &&
+		(hjstate->js.jointype == JOIN_INNER ||
+		 hjstate->js.jointype == JOIN_SEMI))
+	{
+		hashtable->bloomfilter = (uint64 *)
+			palloc0(nbuckets * sizeof(uint64));
+	}
+
 	/*
 	 * Prepare context for the first-scan space allocations; allocate the
 	 * hashbucket array therein, and set each bucket "empty".
@@ -730,6 +759,10 @@ ExecHashIncreaseNumBatches(HashJoinTable hashtable)
 			palloc0(nbatch * sizeof(ExecWorkFile *));
 		hashtable->outerBatchFile = (ExecWorkFile **)
 			palloc0(nbatch * sizeof(ExecWorkFile *));
+		hashtable->innerBatchSpill = (HashJoinBatchSpill *)
+			palloc0(nbatch * sizeof(HashJoinBatchSpill));
+		hashtable->outerBatchSpill = (HashJoinBatchSpill *)
+			palloc0(nbatch * sizeof(HashJoinBatchSpill));
 		/* time to establish the temp tablespaces, too */
 		PrepareTempTablespaces();
 	}
@@ -744,6 +777,14 @@ ExecHashIncreaseNumBatches(HashJoinTable hashtable)
 			   (nbatch - oldnbatch) * sizeof(ExecWorkFile *));
 		MemSet(hashtable->outerBatchFile + oldnbatch, 0,
 			   (nbatch - oldnbatch) * sizeof(ExecWorkFile *));
+		hashtable->innerBatchSpill = (HashJoinBatchSpill *)
+			repalloc(hashtable->innerBatchSpill, nbatch * sizeof(HashJoinBatchSpill));
+		hashtable->outerBatchSpill = (HashJoinBatchSpill *)
+			repalloc(hashtable->outerBatchSpill, nbatch * sizeof(HashJoinBatchSpill));
+		MemSet(hashtable->innerBatchSpill + oldnbatch, 0,
+			   (nbatch - oldnbatch) * sizeof(HashJoinBatchSpill));
+		MemSet(hashtable->outerBatchSpill + oldnbatch, 0,
+			   (nbatch - oldnbatch) * sizeof(HashJoinBatchSpill));
 	}
 
 	/* EXPLAIN ANALYZE batch statistics */
@@ -802,6 +843,7 @@ ExecHashIncreaseNumBatches(HashJoinTable hashtable)
 									  tuple->hashvalue,
 									  hashtable,
 									  &hashtable->innerBatchFile[batchno],
+									  &hashtable->innerBatchSpill[batchno],
 									  hashtable->bfCxt);
 				/* and remove from hash table */
 				if (prevtuple)
@@ -881,6 +923,16 @@ ExecHashTableInsert(HashState *hashState, HashJoinTable hashtable,
 	{
 	PlanState *ps = &hashState->ps;
 
+	/*
+	 * Cooperative pre-spill: if the red-zone handler has signalled vmem
+	 * pressure since we last checked, double the number of batches early so
+	 * that more of the inner relation goes to workfiles instead of memory.
+	 */
+	if (hashtable->growEnabled && hashtable->totalTuples > 0 &&
+		(!hashtable->hjstate->reuse_hashtable || hashtable->first_pass) &&
+		RedZoneHandler_PreSpillRequested(&hashtable->prespill_serial))
+		ExecHashIncreaseNumBatches(hashtable);
+
 	ExecHashGetBucketAndBatch(hashtable, hashvalue,
 							  &bucketno, &batchno);
 
@@ -931,6 +983,7 @@ ExecHashTableInsert(HashState *hashState, HashJoinTable hashtable,
 							  hashvalue,
 							  hashtable,
 							  &hashtable->innerBatchFile[batchno],
+							  &hashtable->innerBatchSpill[batchno],
 							  hashtable->bfCxt);
 	}
 	}
@@ -1091,6 +1144,58 @@ ExecHashGetBucketAndBatch(HashJoinTable hashtable,
 	}
 }
 
+/*
+ * ExecHashBloomWord
+ *		compute the two-bit signature a hash value leaves in its filter word
+ *
+ * The word itself is selected by the hash value's home bucket number, so the
+ * in-word bit positions must come from independent bits; remix the hash value
+ * with a multiplicative hash rather than reuse bits that also steer bucket
+ * and batch selection.
+ */
+static inline uint64
+ExecHashBloomWord(uint32 hashvalue)
+{
+	uint32		h = hashvalue * 2654435761u;
+
+	return (UINT64CONST(1) << (h & 63)) | (UINT64CONST(1) << ((h >> 6) & 63));
+}
+
+/*
+ * ExecHashBloomAdd
+ *		record an inner tuple's hash value in the Bloom filter
+ *
+ * Must be called for every inner tuple, whether it lands in the in-memory
+ * table, a skew bucket, or an inner batch file: the probe side tests the
+ * filter before the batch number is even looked at.
+ */
+void
+ExecHashBloomAdd(HashJoinTable hashtable, uint32 hashvalue)
+{
+	Assert(hashtable->bloomfilter != NULL);
+
+	hashtable->bloomfilter[hashvalue & (hashtable->nbuckets - 1)] |=
+		ExecHashBloomWord(hashvalue);
+}
+
+/*
+ * ExecHashBloomTest
+ *		may any inner tuple have this hash value?
+ *
+ * A false result is definitive: no inner tuple in any batch hashed to this
+ * value, so an outer tuple carrying it can be discarded without touching
+ * the buckets or the outer batch files.
+ */
+bool
+ExecHashBloomTest(HashJoinTable hashtable, uint32 hashvalue)
+{
+	uint64		word = ExecHashBloomWord(hashvalue);
+
+	Assert(hashtable->bloomfilter != NULL);
+
+	return (hashtable->bloomfilter[hashvalue & (hashtable->nbuckets - 1)] & word) == word;
+}
+
 /*
  * ExecScanHashBucket
  *		scan a hash bucket for matches to the current outer tuple
@@ -1354,6 +1459,14 @@ ExecHashTableExplainEnd(PlanState *planstate, struct StringInfoData *buf)
                              hashtable->nbatch - stats->nonemptybatches);
         appendStringInfoChar(buf, '\n');
     }
+
+    /* Report Bloom filter effectiveness. */
+    if (hashtable->bloomchecked > 0)
+        appendStringInfo(buf,
+                         "Bloom filter rejected " UINT64_FORMAT
+                         " of " UINT64_FORMAT " outer tuples.\n",
+                         hashtable->bloomfiltered,
+                         hashtable->bloomchecked);
 }                               /* ExecHashTableExplainEnd */
 
 
@@ -1537,7 +1650,8 @@ ExecHashTableExplainBatchEnd(HashState *hashState, HashJoinTable hashtable)
 
 			if (hashtable->outerBatchFile &&
 				hashtable->outerBatchFile[i] != NULL)
-				filebytes = ExecWorkFile_Tell64(hashtable->outerBatchFile[i]);
+				filebytes = ExecWorkFile_Tell64(hashtable->outerBatchFile[i]) +
+					hashtable->outerBatchSpill[i].used;
 
 			Assert(filebytes >= bs->outerfilesize);
 			owrbytes += filebytes - bs->outerfilesize;
@@ -1547,7 +1661,8 @@ ExecHashTableExplainBatchEnd(HashState *hashState, HashJoinTable hashtable)
 
 			if (hashtable->innerBatchFile &&
 				hashtable->innerBatchFile[i])
-				filebytes = ExecWorkFile_Tell64(hashtable->innerBatchFile[i]);
+				filebytes = ExecWorkFile_Tell64(hashtable->innerBatchFile[i]) +
+					hashtable->innerBatchSpill[i].used;
 
 			Assert(filebytes >= bs->innerfilesize);
 			iwrbytes += filebytes - bs->innerfilesize;
@@ -1660,7 +1775,16 @@ ExecHashBuildSkewHash(HashJoinTable hashtable, Hash *node, int mcvsToUse)
 		 * We allocate the bucket memory in the hashtable's batch context. It
 		 * is only needed during the first batch, and this ensures it will be
 		 * automatically removed once the first batch is done.
+		 *
+		 * The bucket structs themselves are all the same size and get freed
+		 * one by one as buckets are removed (see
+		 * ExecHashRemoveNextSkewBucket), so they go in a slab context under
+		 * the batch context.
 		 */
+		hashtable->skewCxt = SlabContextCreate(hashtable->batchCxt,
+											   "HashSkewBuckets",
+											   SLAB_DEFAULT_BLOCK_SIZE,
+											   sizeof(HashSkewBucket));
 		hashtable->skewBucket = (HashSkewBucket **)
 			MemoryContextAllocZero(hashtable->batchCxt,
 								   nbuckets * sizeof(HashSkewBucket *));
@@ -1714,7 +1838,7 @@ ExecHashBuildSkewHash(HashJoinTable hashtable, Hash *node, int mcvsToUse)
 
 			/* Okay, create a new skew bucket for this hashvalue. */
 			hashtable->skewBucket[bucket] = (HashSkewBucket *)
-				MemoryContextAlloc(hashtable->batchCxt,
+				MemoryContextAlloc(hashtable->skewCxt,
 								   sizeof(HashSkewBucket));
 			hashtable->skewBucket[bucket]->hashvalue = hashvalue;
 			hashtable->skewBucket[bucket]->tuples = NULL;
@@ -1882,7 +2006,9 @@ ExecHashRemoveNextSkewBucket(HashState *hashState, HashJoinTable hashtable)
 			ExecHashJoinSaveTuple(ps, tuple,
 								  hashvalue,
 								  hashtable,
-								  &hashtable->innerBatchFile[batchno], hashtable->bfCxt);
+								  &hashtable->innerBatchFile[batchno],
+								  &hashtable->innerBatchSpill[batchno],
+								  hashtable->bfCxt);
 			pfree(hashTuple);
 			hashtable->spaceUsed -= tupleSize;
 			hashtable->spaceUsedSkew -= tupleSize;
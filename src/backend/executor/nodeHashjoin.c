@@ -44,6 +44,7 @@ static bool isNotDistinctJoin(List *qualList);
 static void ReleaseHashTable(HashJoinState *node);
 
 static void SpillCurrentBatch(HashJoinState *node);
+static void ExecHashJoinFlushBatchSpill(ExecWorkFile *file, HashJoinBatchSpill *spill);
 static bool ExecHashJoinReloadHashTable(HashJoinState *hjstate);
 
 /* ----------------------------------------------------------------
@@ -323,6 +324,7 @@ ExecHashJoin(HashJoinState *node)
 									  hashvalue,
 									  hashtable,
 									  &hashtable->outerBatchFile[batchno],
+									  &hashtable->outerBatchSpill[batchno],
 									  hashtable->bfCxt);
 				node->hj_NeedNewOuter = true;
 				continue;		/* loop around for a new outer tuple */
@@ -739,6 +741,24 @@ ExecHashJoinOuterGetTuple(PlanState *outerNode,
 				/* remember outer relation is not empty for possible rescan */
 				hjstate->hj_OuterNotEmpty = true;
 
+				/*
+				 * Consult the Bloom filter built over all inner tuples.  A
+				 * miss proves this tuple matches nothing in any batch, and
+				 * the join emits nothing for unmatched outer tuples (the
+				 * filter is only built for such join types), so discard it
+				 * here rather than probe the buckets or spill it to an
+				 * outer batch file.
+				 */
+				if (hashtable->bloomfilter)
+				{
+					hashtable->bloomchecked++;
+					if (!ExecHashBloomTest(hashtable, *hashvalue))
+					{
+						hashtable->bloomfiltered++;
+						continue;
+					}
+				}
+
 				return slot;
 			}
 
@@ -962,8 +982,12 @@ start_over:
 		goto start_over;
 
 	/*
-	 * Rewind outer batch file, so that we can start reading it.
+	 * Rewind outer batch file, so that we can start reading it.  Any tuples
+	 * still sitting in the write staging buffer must reach the file first.
 	 */
+	ExecHashJoinFlushBatchSpill(hashtable->outerBatchFile[curbatch],
+								&hashtable->outerBatchSpill[curbatch]);
+
 	bool		result = ExecWorkFile_Rewind(hashtable->outerBatchFile[curbatch]);
 	if (!result)
 	{
@@ -989,7 +1013,7 @@ start_over:
 void
 ExecHashJoinSaveTuple(PlanState *ps, MemTuple tuple, uint32 hashvalue,
 					  HashJoinTable hashtable, ExecWorkFile **fileptr,
-					  MemoryContext bfCxt)
+					  HashJoinBatchSpill *spill, MemoryContext bfCxt)
 {
 	ExecWorkFile *file = *fileptr;
 
@@ -1031,6 +1055,40 @@ ExecHashJoinSaveTuple(PlanState *ps, MemTuple tuple, uint32 hashvalue,
 		MemoryContextSwitchTo(oldcxt);
 	}
 
+	/*
+	 * Stage the record rather than writing it through, so that the file sees
+	 * few large writes instead of two small ones per tuple.  The staging
+	 * buffer is flushed when full, and before the batch file is rewound for
+	 * reading.  Oversized tuples fall through to a direct write.
+	 */
+	if (spill != NULL && gp_hashjoin_spill_batch_size > 0)
+	{
+		int			recsize = sizeof(uint32) + memtuple_get_size(tuple);
+
+		if (spill->data == NULL)
+		{
+			spill->size = gp_hashjoin_spill_batch_size * 1024;
+			spill->data = MemoryContextAlloc(bfCxt, spill->size);
+		}
+
+		if (spill->used + recsize > spill->size)
+			ExecHashJoinFlushBatchSpill(file, spill);
+
+		if (recsize <= spill->size)
+		{
+			memcpy(spill->data + spill->used, &hashvalue, sizeof(uint32));
+			memcpy(spill->data + spill->used + sizeof(uint32),
+				   tuple, memtuple_get_size(tuple));
+			spill->used += recsize;
+
+			if (ps)
+			{
+				CheckSendPlanStateGpmonPkt(ps);
+			}
+			return;
+		}
+	}
+
 	if (!ExecWorkFile_Write(file, (void *) &hashvalue, sizeof(uint32)))
 	{
 		workfile_mgr_report_error();
@@ -1047,6 +1105,24 @@ ExecHashJoinSaveTuple(PlanState *ps, MemTuple tuple, uint32 hashvalue,
 	}
 }
 
+/*
+ * Write out any records staged for a batch file.  Must be called before the
+ * file is rewound for reading; harmless if nothing is staged.
+ */
+static void
+ExecHashJoinFlushBatchSpill(ExecWorkFile *file, HashJoinBatchSpill *spill)
+{
+	if (spill->used == 0)
+		return;
+
+	if (!ExecWorkFile_Write(file, spill->data, spill->used))
+	{
+		workfile_mgr_report_error();
+	}
+
+	spill->used = 0;
+}
+
 /*
  * ExecHashJoinGetSavedTuple
  *		read the next tuple from a batch file.	Return NULL if no more.
@@ -1271,6 +1347,7 @@ SpillCurrentBatch(HashJoinState *node)
 								  tuple->hashvalue,
 								  hashtable,
 								  &hashtable->innerBatchFile[curbatch],
+								  &hashtable->innerBatchSpill[curbatch],
 								  hashtable->bfCxt);
 			tuple = tuple->next;
 		}
@@ -1297,7 +1374,10 @@ ExecHashJoinReloadHashTable(HashJoinState *hjstate)
 
 	if (hashtable->innerBatchFile[curbatch] != NULL)
 	{
-		/* Rewind batch file */
+		/* Flush staged writes, then rewind batch file */
+		ExecHashJoinFlushBatchSpill(hashtable->innerBatchFile[curbatch],
+									&hashtable->innerBatchSpill[curbatch]);
+
 		bool		result = ExecWorkFile_Rewind(hashtable->innerBatchFile[curbatch]);
 
 		if (!result)
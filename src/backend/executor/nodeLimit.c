@@ -155,6 +155,26 @@ ExecLimit(LimitState *node)
 				}
 				node->subSlot = slot;
 				node->position++;
+
+				/*
+				 * CDB: If this is the last tuple of the window, tell source
+				 * QEs to stop right away rather than waiting for our parent
+				 * to ask for the (rejected) next tuple.  The parent may
+				 * never call us again -- e.g. when the executor was asked
+				 * for exactly this many rows, or a cursor fetch ends here --
+				 * and until then every sender slice keeps scanning and
+				 * shipping tuples that will be thrown away.  Not done if the
+				 * caller might scan backward through us, since the squelched
+				 * subtree could not back up.
+				 */
+				if (!node->noCount &&
+					node->position - node->offset >= node->count &&
+					!node->expect_backward)
+				{
+					node->lstate = LIMIT_WINDOWEND;
+					ExecSquelchNode(outerPlan);
+					return slot;
+				}
 			}
 			else
 			{
@@ -364,6 +384,7 @@ ExecInitLimit(Limit *node, EState *estate, int eflags)
 	limitstate->ps.state = estate;
 
 	limitstate->lstate = LIMIT_INITIAL;
+	limitstate->expect_backward = (eflags & EXEC_FLAG_BACKWARD) != 0;
 
 	/*
 	 * Miscellaneous initialization
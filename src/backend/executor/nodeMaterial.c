@@ -26,6 +26,7 @@
 #include "executor/executor.h"
 #include "executor/nodeMaterial.h"
 #include "executor/instrument.h"        /* Instrumentation */
+#include "nodes/nodeFuncs.h"
 #include "utils/tuplestorenew.h"
 
 #include "miscadmin.h"
@@ -35,6 +36,232 @@
 static void ExecMaterialExplainEnd(PlanState *planstate, struct StringInfoData *buf);
 static void ExecChildRescan(MaterialState *node, ExprContext *exprCtxt);
 static void DestroyTupleStore(MaterialState *node);
+static bool ExecMaterialCanReuseWorkfiles(Material *ma);
+static Bitmapset *ExecMaterialNeededColumns(MaterialState *node);
+
+/*
+ * Can this Material publish its workfiles for cross-query reuse, or attach
+ * to workfiles published by an earlier query?
+ *
+ * Only plain materializations whose subtree runs entirely in this slice
+ * qualify: with a Motion underneath, skipping the subplan would leave the
+ * sending slices blocked. Parameterized subplans are excluded as well,
+ * since their result depends on parameter values that are not part of the
+ * plan fingerprint.
+ */
+static bool
+ExecMaterialCanReuseWorkfiles(Material *ma)
+{
+	return gp_workfile_caching &&
+		ma->share_type == SHARE_NOTSHARED &&
+		!ma->cdb_strict &&
+		!IsA(outerPlan((Plan *) ma), Motion) &&
+		ma->plan.allParam == NULL &&
+		ma->plan.extParam == NULL;
+}
+
+/*
+ * Support for column pruning: a Material node's output is consumed only
+ * through its parent's expressions, so any column the parent never
+ * references can be stored as a NULL instead of its (possibly wide) value.
+ * The tuples keep the full descriptor, which means readers need no changes;
+ * we only save the storage and spill bandwidth of the pruned datums.
+ */
+
+/*
+ * Locate the immediate parent of 'child' in the plan tree rooted at 'node'.
+ * Returns NULL if 'child' is not found below 'node'.
+ */
+static Plan *
+ExecMaterialFindParent(Plan *node, Plan *child)
+{
+	Plan	   *result = NULL;
+	ListCell   *lc;
+	List	   *planlist = NIL;
+
+	if (node == NULL)
+		return NULL;
+
+	if (node->lefttree == child || node->righttree == child)
+		return node;
+
+	if (node->lefttree != NULL)
+		result = ExecMaterialFindParent(node->lefttree, child);
+	if (result == NULL && node->righttree != NULL)
+		result = ExecMaterialFindParent(node->righttree, child);
+	if (result != NULL)
+		return result;
+
+	switch (nodeTag(node))
+	{
+		case T_Append:
+			planlist = ((Append *) node)->appendplans;
+			break;
+		case T_Sequence:
+			planlist = ((Sequence *) node)->subplans;
+			break;
+		case T_BitmapAnd:
+			planlist = ((BitmapAnd *) node)->bitmapplans;
+			break;
+		case T_BitmapOr:
+			planlist = ((BitmapOr *) node)->bitmapplans;
+			break;
+		case T_SubqueryScan:
+			{
+				Plan	   *subplan = ((SubqueryScan *) node)->subplan;
+
+				if (subplan == child)
+					return node;
+				return ExecMaterialFindParent(subplan, child);
+			}
+		default:
+			break;
+	}
+
+	foreach(lc, planlist)
+	{
+		Plan	   *subplan = (Plan *) lfirst(lc);
+
+		if (subplan == child)
+			return node;
+		result = ExecMaterialFindParent(subplan, child);
+		if (result != NULL)
+			return result;
+	}
+
+	return NULL;
+}
+
+typedef struct MaterialNeededColsContext
+{
+	Index		varno;			/* OUTER or INNER, depending on which child
+								 * the Material is */
+	Bitmapset  *cols;			/* referenced attribute numbers */
+	bool		fail;			/* set on whole-row or system attribute */
+} MaterialNeededColsContext;
+
+static bool
+material_needed_cols_walker(Node *node, MaterialNeededColsContext *ctx)
+{
+	if (node == NULL)
+		return false;
+	if (IsA(node, Var))
+	{
+		Var		   *var = (Var *) node;
+
+		if (var->varno == ctx->varno)
+		{
+			if (var->varattno <= 0)
+			{
+				/* whole-row or system attribute: cannot prune anything */
+				ctx->fail = true;
+				return true;
+			}
+			ctx->cols = bms_add_member(ctx->cols, var->varattno);
+		}
+		return false;
+	}
+	return expression_tree_walker(node, material_needed_cols_walker, ctx);
+}
+
+/*
+ * Compute the set of attribute numbers of this Material's output that its
+ * parent node actually references.  Returns NULL if the set cannot be
+ * determined safely or if every column is needed anyway; in that case the
+ * caller must store full tuples.
+ *
+ * We only trust parents whose complete set of expression fields we know;
+ * an unfamiliar parent may reference columns through a field we would not
+ * walk, so we decline to prune under it.
+ */
+static Bitmapset *
+ExecMaterialNeededColumns(MaterialState *node)
+{
+	PlannedStmt *stmt = node->ss.ps.state->es_plannedstmt;
+	Plan	   *ma = node->ss.ps.plan;
+	Plan	   *parent;
+	ListCell   *lc;
+	MaterialNeededColsContext ctx;
+
+	if (stmt == NULL)
+		return NULL;
+
+	parent = ExecMaterialFindParent(stmt->planTree, ma);
+	foreach(lc, stmt->subplans)
+	{
+		if (parent != NULL)
+			break;
+		parent = ExecMaterialFindParent((Plan *) lfirst(lc), ma);
+	}
+
+	if (parent == NULL || (parent->lefttree != ma && parent->righttree != ma))
+		return NULL;
+
+	ctx.varno = (parent->lefttree == ma) ? OUTER : INNER;
+	ctx.cols = NULL;
+	ctx.fail = false;
+
+	material_needed_cols_walker((Node *) parent->targetlist, &ctx);
+	material_needed_cols_walker((Node *) parent->qual, &ctx);
+
+	switch (nodeTag(parent))
+	{
+		case T_Result:
+			material_needed_cols_walker(((Result *) parent)->resconstantqual, &ctx);
+			break;
+		case T_Agg:
+			{
+				Agg		   *agg = (Agg *) parent;
+				int			i;
+
+				/*
+				 * Grouping columns are referenced positionally through
+				 * grpColIdx when nodeAgg compares input tuples, not through
+				 * any expression the walker visits, so add them explicitly.
+				 */
+				for (i = 0; i < agg->numCols; i++)
+					ctx.cols = bms_add_member(ctx.cols, agg->grpColIdx[i]);
+
+				/*
+				 * In a ROLLUP chain the input additionally carries
+				 * GROUPING/GROUP_ID columns that nodeAgg fetches by computed
+				 * attribute number; don't try to enumerate those.
+				 */
+				if (agg->inputHasGrouping)
+					ctx.fail = true;
+			}
+			break;
+		case T_Sort:
+		case T_Unique:
+		case T_Limit:
+			/* targetlist and qual cover all column references */
+			break;
+		case T_NestLoop:
+			material_needed_cols_walker((Node *) ((Join *) parent)->joinqual, &ctx);
+			break;
+		case T_MergeJoin:
+			material_needed_cols_walker((Node *) ((Join *) parent)->joinqual, &ctx);
+			material_needed_cols_walker((Node *) ((MergeJoin *) parent)->mergeclauses, &ctx);
+			break;
+		case T_HashJoin:
+			material_needed_cols_walker((Node *) ((Join *) parent)->joinqual, &ctx);
+			material_needed_cols_walker((Node *) ((HashJoin *) parent)->hashclauses, &ctx);
+			material_needed_cols_walker((Node *) ((HashJoin *) parent)->hashqualclauses, &ctx);
+			break;
+		default:
+			ctx.fail = true;
+			break;
+	}
+
+	if (ctx.fail || ctx.cols == NULL ||
+		bms_num_members(ctx.cols) >= list_length(ma->targetlist))
+	{
+		bms_free(ctx.cols);
+		return NULL;
+	}
+
+	return ctx.cols;
+}
 
 
 /* ----------------------------------------------------------------
@@ -101,10 +328,45 @@ ExecMaterial(MaterialState *node)
 		else
 		{
 			/* Non-shared Materialize node */
-			workfile_set *work_set =  workfile_mgr_create_set(BUFFILE, false /* can_reuse */, &node->ss.ps);
+			bool		can_reuse = ExecMaterialCanReuseWorkfiles(ma);
+			workfile_set *work_set = NULL;
+
+			if (can_reuse)
+				work_set = workfile_mgr_attach_set(BUFFILE, &node->ss.ps);
 
-			ts = ntuplestore_create_workset(work_set, PlanStateOperatorMemKB((PlanState *) node) * 1024);
-			tsa = ntuplestore_create_accessor(ts, true /* isWriter */);
+			if (work_set != NULL)
+			{
+				/*
+				 * A previous query published its complete result under our
+				 * fingerprint. Read it back instead of re-executing the
+				 * subplan.
+				 */
+				ts = ntuplestore_create_workset_reader(work_set, PlanStateOperatorMemKB((PlanState *) node) * 1024);
+				tsa = ntuplestore_create_accessor(ts, false /* isWriter */);
+				node->eof_underlying = true;
+			}
+			else
+			{
+				work_set = workfile_mgr_create_set(BUFFILE, can_reuse, &node->ss.ps);
+				if (can_reuse)
+					workfile_mgr_mark_reusable(work_set, &node->ss.ps);
+
+				ts = ntuplestore_create_workset(work_set, PlanStateOperatorMemKB((PlanState *) node) * 1024);
+				tsa = ntuplestore_create_accessor(ts, true /* isWriter */);
+
+				/*
+				 * If the stored tuples can never be seen by another query
+				 * (the set is not published for reuse), columns the parent
+				 * never references may be stored as NULLs.
+				 */
+				if (!can_reuse && gp_enable_material_pruning)
+				{
+					Bitmapset  *needed = ExecMaterialNeededColumns(node);
+
+					if (needed != NULL)
+						ntuplestore_set_needed_columns(ts, needed);
+				}
+			}
 		}
 
 		Assert(ts && tsa);
@@ -220,6 +482,16 @@ ExecMaterial(MaterialState *node)
 		if (TupIsNull(outerslot))
 		{
 			node->eof_underlying = true;
+
+			/*
+			 * The subplan's complete result is now in the tuplestore. If it
+			 * belongs to a reusable workfile set and has spilled, flush it
+			 * and mark it complete; closing the set will then publish it
+			 * for other queries instead of deleting it.
+			 */
+			if (ts != NULL)
+				ntuplestore_workset_complete(ts);
+
 			if (!node->ss.ps.delayEagerFree)
 			{
 				ExecEagerFreeMaterial(node);
@@ -23,10 +23,21 @@
 
 #include "postgres.h"
 
+#include "cdb/cdbvars.h"
 #include "executor/execdebug.h"
 #include "executor/nodeNestloop.h"
+#include "optimizer/walkers.h"
 #include "utils/memutils.h"
 
+/*
+ * Number of outer tuples buffered per inner pass in block nested-loop
+ * mode.  Large enough to amortize inner-scan startup, small enough that
+ * the batch stays cache resident.
+ */
+#define BLOCK_NL_BATCH_SIZE 64
+
+static TupleTableSlot *ExecBlockNestLoop(NestLoopState *node);
+static bool nestloop_inner_is_uncorrelated(Plan *innerPlan, EState *estate);
 static void splitJoinQualExpr(NestLoopState *nlstate);
 static void extractFuncExprArgs(FuncExprState *fstate, List **lclauses, List **rclauses);
 
@@ -142,6 +153,12 @@ ExecNestLoop(NestLoopState *node)
 		node->reset_inner = false;
 	}
 
+	/*
+	 * In block mode, hand off to the batching loop.
+	 */
+	if (node->nl_useBlockJoin)
+		return ExecBlockNestLoop(node);
+
 	/*
 	 * Ok, everything is setup for the join so now loop until we return a
 	 * qualifying join tuple.
@@ -340,6 +357,216 @@ ExecNestLoop(NestLoopState *node)
 	}
 }
 
+/* ----------------------------------------------------------------
+ *		ExecBlockNestLoop
+ *
+ *		Block nested-loop variant of the main loop: buffer up to
+ *		BLOCK_NL_BATCH_SIZE outer tuples, then run one pass over the
+ *		inner plan probing every buffered outer tuple with each inner
+ *		tuple.  This amortizes the inner rescan cost across the batch,
+ *		which matters when the inner side is an uncorrelated scan whose
+ *		startup cost dwarfs the per-tuple work.
+ *
+ *		Only reached when ExecInitNestLoop has verified that the inner
+ *		subtree does not reference the current outer tuple, so a single
+ *		inner pass produces the same rows for every batch entry.
+ * ----------------------------------------------------------------
+ */
+static TupleTableSlot *
+ExecBlockNestLoop(NestLoopState *node)
+{
+	PlanState  *innerPlan = innerPlanState(node);
+	PlanState  *outerPlan = outerPlanState(node);
+	List	   *joinqual = node->js.joinqual;
+	List	   *otherqual = node->js.ps.qual;
+	ExprContext *econtext = node->js.ps.ps_ExprContext;
+	TupleTableSlot *innerTupleSlot;
+
+	for (;;)
+	{
+		/*
+		 * After a full inner pass over a batch, emit null-extended results
+		 * for the entries that never found a match (left and anti joins).
+		 */
+		if (node->nl_emittingUnmatched)
+		{
+			while (node->nl_emitIndex < node->nl_batchCount)
+			{
+				int			i = node->nl_emitIndex++;
+
+				if (node->nl_BatchMatched[i])
+					continue;
+
+				econtext->ecxt_outertuple = node->nl_BatchSlots[i];
+				econtext->ecxt_innertuple = node->nl_NullInnerTupleSlot;
+
+				if (otherqual == NIL || ExecQual(otherqual, econtext, false))
+					return ExecProject(node->js.ps.ps_ProjInfo, NULL);
+
+				ResetExprContext(econtext);
+			}
+			node->nl_emittingUnmatched = false;
+			node->nl_needNewBatch = true;
+		}
+
+		/*
+		 * Refill the batch from the outer plan.
+		 */
+		if (node->nl_needNewBatch)
+		{
+			int			i;
+
+			for (i = 0; i < node->nl_batchCount; i++)
+				ExecClearTuple(node->nl_BatchSlots[i]);
+			node->nl_batchCount = 0;
+
+			while (!node->nl_outerDone &&
+				   node->nl_batchCount < BLOCK_NL_BATCH_SIZE)
+			{
+				TupleTableSlot *outerTupleSlot = ExecProcNode(outerPlan);
+
+				if (TupIsNull(outerTupleSlot))
+				{
+					node->nl_outerDone = true;
+					break;
+				}
+
+				ExecCopySlot(node->nl_BatchSlots[node->nl_batchCount],
+							 outerTupleSlot);
+				node->nl_BatchMatched[node->nl_batchCount] = false;
+				node->nl_batchCount++;
+			}
+
+			if (node->nl_batchCount == 0)
+			{
+				ENL1_printf("no outer tuple, ending join");
+
+				/* Same end-of-join handling as the tuple-at-a-time loop. */
+				if (node->nl_innerSquelchNeeded)
+					ExecSquelchNode(innerPlan);
+
+				if (!node->js.ps.delayEagerFree)
+					ExecEagerFreeChildNodes((PlanState *) node, false);
+
+				return NULL;
+			}
+
+			node->nl_needNewBatch = false;
+			node->nl_probeIndex = node->nl_batchCount;	/* force inner fetch */
+
+			/*
+			 * One inner pass serves the whole batch.
+			 */
+			if (node->require_inner_reset || node->reset_inner)
+			{
+				ExecReScan(innerPlan, econtext);
+				node->reset_inner = false;
+			}
+		}
+
+		/*
+		 * Once the current inner tuple has been probed against the whole
+		 * batch, advance the inner plan.
+		 */
+		if (node->nl_probeIndex >= node->nl_batchCount)
+		{
+			ENL1_printf("getting new inner tuple");
+
+			innerTupleSlot = ExecProcNode(innerPlan);
+			node->reset_inner = true;
+			econtext->ecxt_innertuple = innerTupleSlot;
+
+			if (TupIsNull(innerTupleSlot))
+			{
+				/* Finished one complete scan of the inner side. */
+				node->nl_innerSideScanned = true;
+				node->nl_innerSquelchNeeded = false;
+
+				if (node->js.jointype == JOIN_LEFT ||
+					node->js.jointype == JOIN_ANTI)
+				{
+					node->nl_emittingUnmatched = true;
+					node->nl_emitIndex = 0;
+				}
+				else
+					node->nl_needNewBatch = true;
+				continue;
+			}
+
+			node->nl_probeIndex = 0;
+		}
+
+		/*
+		 * Probe the batch with the current inner tuple.
+		 */
+		while (node->nl_probeIndex < node->nl_batchCount)
+		{
+			int			i = node->nl_probeIndex++;
+
+			/* semi and anti joins are done with an entry after one match */
+			if (node->nl_BatchMatched[i] &&
+				(node->js.jointype == JOIN_SEMI ||
+				 node->js.jointype == JOIN_ANTI))
+				continue;
+
+			econtext->ecxt_outertuple = node->nl_BatchSlots[i];
+
+			if (ExecQual(joinqual, econtext, node->nl_qualResultForNull))
+			{
+				node->nl_BatchMatched[i] = true;
+
+				/* In an antijoin, we never return a matched tuple */
+				if (node->js.jointype == JOIN_ANTI)
+					continue;
+
+				if (otherqual == NIL || ExecQual(otherqual, econtext, false))
+					return ExecProject(node->js.ps.ps_ProjInfo, NULL);
+			}
+
+			/*
+			 * Tuple pair fails qual, so free per-tuple memory and try the
+			 * next batch entry.
+			 */
+			ResetExprContext(econtext);
+		}
+	}
+}
+
+/*
+ * Walker for nestloop_inner_is_uncorrelated: look for any Var that
+ * references the nestloop's outer side.
+ */
+typedef struct BlockNestLoopWalkerContext
+{
+	plan_tree_base_prefix base; /* Required prefix for plan_tree_walker/mutator */
+} BlockNestLoopWalkerContext;
+
+static bool
+block_nestloop_outer_var_walker(Node *node, BlockNestLoopWalkerContext *ctx)
+{
+	if (node == NULL)
+		return false;
+	if (IsA(node, Var))
+		return ((Var *) node)->varno == OUTER;
+	return plan_tree_walker(node, block_nestloop_outer_var_walker, ctx);
+}
+
+/*
+ * Does the inner subtree of a nestloop produce the same rows regardless of
+ * the current outer tuple?  Correlation shows up as OUTER Vars inside the
+ * inner plan tree (e.g. run-time index keys), so block mode is safe exactly
+ * when none are present.
+ */
+static bool
+nestloop_inner_is_uncorrelated(Plan *innerPlan, EState *estate)
+{
+	BlockNestLoopWalkerContext ctx;
+
+	exec_init_plan_tree_base(&ctx.base, estate->es_plannedstmt);
+
+	return !block_nestloop_outer_var_walker((Node *) innerPlan, &ctx);
+}
+
 /* ----------------------------------------------------------------
  *		ExecInitNestLoop
  * ----------------------------------------------------------------
@@ -486,6 +713,35 @@ ExecInitNestLoop(NestLoop *node, EState *estate, int eflags)
         nlstate->nl_qualResultForNull = false;
     }
 
+	/*
+	 * Engage block mode if enabled and applicable: the join types below are
+	 * the ones the batching loop understands, and the inner plan must not
+	 * reference the current outer tuple, since one inner pass serves a whole
+	 * batch of outer tuples.  (LASJ_NOTIN is excluded because its NULL
+	 * detection is wired into the tuple-at-a-time loop.)
+	 */
+	if (gp_enable_block_nestloop &&
+		nlstate->require_inner_reset &&
+		!node->shared_outer &&
+		(node->join.jointype == JOIN_INNER ||
+		 node->join.jointype == JOIN_LEFT ||
+		 node->join.jointype == JOIN_SEMI ||
+		 node->join.jointype == JOIN_ANTI) &&
+		nestloop_inner_is_uncorrelated(innerPlan(node), estate))
+	{
+		TupleDesc	outerDesc = ExecGetResultType(outerPlanState(nlstate));
+		int			i;
+
+		nlstate->nl_useBlockJoin = true;
+		nlstate->nl_BatchSlots = (TupleTableSlot **)
+			palloc(BLOCK_NL_BATCH_SIZE * sizeof(TupleTableSlot *));
+		for (i = 0; i < BLOCK_NL_BATCH_SIZE; i++)
+			nlstate->nl_BatchSlots[i] = MakeSingleTupleTableSlot(outerDesc);
+		nlstate->nl_BatchMatched = (bool *)
+			palloc0(BLOCK_NL_BATCH_SIZE * sizeof(bool));
+		nlstate->nl_needNewBatch = true;
+	}
+
 	NL1_printf("ExecInitNestLoop: %s\n",
 			   "node initialized");
 
@@ -514,6 +770,14 @@ ExecEndNestLoop(NestLoopState *node)
 	 */
 	ExecClearTuple(node->js.ps.ps_ResultTupleSlot);
 
+	if (node->nl_BatchSlots)
+	{
+		int			i;
+
+		for (i = 0; i < BLOCK_NL_BATCH_SIZE; i++)
+			ExecDropSingleTupleTableSlot(node->nl_BatchSlots[i]);
+	}
+
 	/*
 	 * close down subplans
 	 */
@@ -549,6 +813,18 @@ ExecReScanNestLoop(NestLoopState *node, ExprContext *exprCtxt)
 	node->nl_MatchedOuter = false;
 	node->nl_innerSideScanned = false;
 	/* CDB: We intentionally leave node->nl_innerSquelchNeeded unchanged on ReScan */
+
+	if (node->nl_useBlockJoin)
+	{
+		int			i;
+
+		for (i = 0; i < node->nl_batchCount; i++)
+			ExecClearTuple(node->nl_BatchSlots[i]);
+		node->nl_batchCount = 0;
+		node->nl_outerDone = false;
+		node->nl_needNewBatch = true;
+		node->nl_emittingUnmatched = false;
+	}
 }
 
 /* ----------------------------------------------------------------
@@ -32,6 +32,10 @@
 #include "executor/executor.h"
 #include "executor/nodeShareInputScan.h"
 #include "miscadmin.h"
+#include "storage/latch.h"
+#include "storage/proc.h"
+#include "storage/shmem.h"
+#include "storage/spin.h"
 #include "utils/faultinjector.h"
 #include "utils/gp_alloc.h"
 #include "utils/tuplesort.h"
@@ -39,6 +43,7 @@
 
 typedef struct ShareInput_Lk_Context
 {
+	bool use_shmem;		/* always false; tells the two context types apart */
 	int readyfd;
 	int donefd;
 	int  zcnt;
@@ -50,6 +55,26 @@ typedef struct ShareInput_Lk_Context
 
 static void writer_wait_for_acks(ShareInput_Lk_Context *pctxt, int share_id, int xslice);
 
+/*
+ * Shared memory based synchronization (see the comment above the FIFO
+ * section for why an IPC mechanism is needed at all).  One sync slot per
+ * share, keyed by (session id, command count, share id).
+ */
+typedef struct ShareInputSyncSlot ShareInputSyncSlot;
+
+typedef struct ShareInput_Shm_Context
+{
+	bool use_shmem;		/* always true; tells the two context types apart */
+	bool is_writer;
+	bool latch_registered;
+	ShareInputSyncSlot *slot;
+} ShareInput_Shm_Context;
+
+static void *shareinput_shm_reader_waitready(int share_id, PlanGenerator planGen);
+static void *shareinput_shm_writer_notifyready(int share_id, int xslice, PlanGenerator planGen);
+static void shareinput_shm_reader_notifydone(ShareInput_Shm_Context *pctxt, int share_id);
+static void shareinput_shm_writer_waitdone(ShareInput_Shm_Context *pctxt, int share_id, int nsharer_xslice);
+
 
 /*
  * init_tuplestore_state
@@ -390,7 +415,428 @@ void shareinput_create_bufname_prefix(char* p, int size, int share_id)
             gp_session_id, gp_command_count, share_id);
 }
 
-/* Here we use the absolute path name as the lock name.  See fd.c 
+/*************************************************************************
+ * Shared memory state machine.
+ *
+ * The FIFO handshake below works, but it costs two fifo files per share
+ * plus a select() poll loop with a one second timeout on every wait.  When
+ * gp_shareinput_shmem_sync is on (the default) we instead keep the
+ * handshake state in a small array of slots in shared memory: the writer
+ * flips a ready flag and wakes the waiting readers through their process
+ * latches, so readers start scanning as soon as the store is written
+ * instead of after the next poll tick.  The ack ('b') and done ('z')
+ * bytes of the FIFO protocol become plain counters, bumped under the
+ * slot spinlock with a latch kick to the writer.
+ *
+ * Slots are keyed by (session id, command count, share id); session and
+ * command id are needed because all backends of a segment share the same
+ * slot array.  If the array is ever full we fall back to the FIFO
+ * handshake for that share, so slot exhaustion costs latency, not
+ * correctness.  As with the FIFOs, an xact callback releases the slot if
+ * the transaction aborts mid-handshake.
+ *************************************************************************/
+
+/*
+ * Max number of reader latches registered per slot.  A reader that cannot
+ * register (more cross-slice readers than this on one segment) still works:
+ * it rechecks the ready flag on the wait loop timeout, like the old FIFO
+ * poll did.
+ */
+#define SISC_MAX_SYNC_WAITERS 16
+
+struct ShareInputSyncSlot
+{
+	int32		session_id;
+	int32		command_count;
+	int32		share_id;
+	bool		inuse;
+	int			refcount;		/* attached readers and writer */
+
+	bool		ready;			/* writer has finished writing the store */
+	int			nready_acks;	/* readiness acks received from readers */
+	int			ndone;			/* done notifications received from readers */
+
+	Latch	   *writer_latch;	/* writer's proc latch, while attached */
+	int			nwaiters;
+	Latch	   *waiter_latches[SISC_MAX_SYNC_WAITERS];
+};
+
+typedef struct ShareInputSyncCtl
+{
+	slock_t		mutex;			/* protects all slots */
+	int			numslots;
+	ShareInputSyncSlot slots[1];	/* VARIABLE LENGTH ARRAY */
+} ShareInputSyncCtl;
+
+static ShareInputSyncCtl *shareinput_sync_ctl = NULL;
+
+static int
+shareinput_sync_numslots(void)
+{
+	/*
+	 * Each backend participates in at most a handful of cross-slice shares
+	 * at a time, so two slots per backend leaves plenty of headroom.
+	 */
+	return 2 * MaxBackends;
+}
+
+/*
+ * ShareInputShmemSize
+ *
+ * Size of the ShareInputScan synchronization slot array.
+ */
+Size
+ShareInputShmemSize(void)
+{
+	Size		size;
+
+	size = offsetof(ShareInputSyncCtl, slots);
+	size = add_size(size, mul_size(shareinput_sync_numslots(),
+								   sizeof(ShareInputSyncSlot)));
+	return size;
+}
+
+/*
+ * ShareInputShmemInit
+ *
+ * Allocate and initialize ShareInputScan-related shared memory.
+ */
+void
+ShareInputShmemInit(void)
+{
+	bool		found;
+
+	shareinput_sync_ctl = (ShareInputSyncCtl *)
+		ShmemInitStruct("ShareInputScan Sync", ShareInputShmemSize(), &found);
+
+	if (!found)
+	{
+		int			i;
+
+		SpinLockInit(&shareinput_sync_ctl->mutex);
+		shareinput_sync_ctl->numslots = shareinput_sync_numslots();
+		for (i = 0; i < shareinput_sync_ctl->numslots; i++)
+			shareinput_sync_ctl->slots[i].inuse = false;
+	}
+}
+
+/*
+ * Find the sync slot of the given share, or claim a free one if this is the
+ * first participant to arrive.  Bumps the slot refcount.  Returns NULL if
+ * the slot array is full (caller falls back to the FIFO handshake).
+ */
+static ShareInputSyncSlot *
+shareinput_shm_attach_slot(int share_id)
+{
+	ShareInputSyncSlot *slot = NULL;
+	ShareInputSyncSlot *freeslot = NULL;
+	int			i;
+
+	SpinLockAcquire(&shareinput_sync_ctl->mutex);
+	for (i = 0; i < shareinput_sync_ctl->numslots; i++)
+	{
+		ShareInputSyncSlot *s = &shareinput_sync_ctl->slots[i];
+
+		if (s->inuse)
+		{
+			if (s->session_id == gp_session_id &&
+				s->command_count == gp_command_count &&
+				s->share_id == share_id)
+			{
+				slot = s;
+				break;
+			}
+		}
+		else if (freeslot == NULL)
+			freeslot = s;
+	}
+
+	if (slot == NULL && freeslot != NULL)
+	{
+		slot = freeslot;
+		slot->inuse = true;
+		slot->session_id = gp_session_id;
+		slot->command_count = gp_command_count;
+		slot->share_id = share_id;
+		slot->refcount = 0;
+		slot->ready = false;
+		slot->nready_acks = 0;
+		slot->ndone = 0;
+		slot->writer_latch = NULL;
+		slot->nwaiters = 0;
+	}
+
+	if (slot != NULL)
+		slot->refcount++;
+	SpinLockRelease(&shareinput_sync_ctl->mutex);
+
+	return slot;
+}
+
+/* Drop one latch registration.  Caller must hold the slot array mutex. */
+static void
+shareinput_shm_remove_waiter(ShareInputSyncSlot *slot, Latch *latch)
+{
+	int			i;
+
+	for (i = 0; i < slot->nwaiters; i++)
+	{
+		if (slot->waiter_latches[i] == latch)
+		{
+			slot->waiter_latches[i] = slot->waiter_latches[--slot->nwaiters];
+			break;
+		}
+	}
+}
+
+/*
+ * Detach from the sync slot, releasing it when the last participant leaves,
+ * and free the context.  Safe to call mid-handshake (xact abort): any latch
+ * registration of ours is removed so the other participants never touch a
+ * dead process's latch.
+ */
+static void
+shareinput_shm_detach(ShareInput_Shm_Context *pctxt)
+{
+	ShareInputSyncSlot *slot = pctxt->slot;
+
+	if (slot != NULL)
+	{
+		SpinLockAcquire(&shareinput_sync_ctl->mutex);
+		if (pctxt->latch_registered)
+			shareinput_shm_remove_waiter(slot, &MyProc->procLatch);
+		if (pctxt->is_writer && slot->writer_latch == &MyProc->procLatch)
+			slot->writer_latch = NULL;
+		if (--slot->refcount <= 0)
+			slot->inuse = false;
+		SpinLockRelease(&shareinput_sync_ctl->mutex);
+		pctxt->slot = NULL;
+	}
+
+	gp_free(pctxt);
+}
+
+static void XCallBack_ShareInput_Shm(XactEvent ev, void *vp)
+{
+	shareinput_shm_detach((ShareInput_Shm_Context *) vp);
+}
+
+/*
+ * Shared memory version of shareinput_reader_waitready.  Returns NULL if no
+ * sync slot is available.
+ */
+static void *
+shareinput_shm_reader_waitready(int share_id, PlanGenerator planGen)
+{
+	ShareInput_Shm_Context *pctxt;
+	ShareInputSyncSlot *slot;
+	Latch	   *writer_latch = NULL;
+
+	pctxt = gp_malloc(sizeof(ShareInput_Shm_Context));
+	if (!pctxt)
+		ereport(ERROR, (errcode(ERRCODE_OUT_OF_MEMORY),
+			errmsg("Share input reader failed: out of memory")));
+
+	slot = shareinput_shm_attach_slot(share_id);
+	if (slot == NULL)
+	{
+		gp_free(pctxt);
+		elog(LOG, "SISC READER (shareid=%d, slice=%d): no sync slot available, "
+			 "falling back to fifo handshake", share_id, currentSliceId);
+		return NULL;
+	}
+
+	pctxt->use_shmem = true;
+	pctxt->is_writer = false;
+	pctxt->latch_registered = false;
+	pctxt->slot = slot;
+
+	RegisterXactCallbackOnce(XCallBack_ShareInput_Shm, pctxt);
+
+	for (;;)
+	{
+		bool		ready;
+
+		CHECK_FOR_INTERRUPTS();
+
+		SpinLockAcquire(&shareinput_sync_ctl->mutex);
+		ready = slot->ready;
+		if (!ready && !pctxt->latch_registered &&
+			slot->nwaiters < SISC_MAX_SYNC_WAITERS)
+		{
+			slot->waiter_latches[slot->nwaiters++] = &MyProc->procLatch;
+			pctxt->latch_registered = true;
+		}
+		SpinLockRelease(&shareinput_sync_ctl->mutex);
+
+		if (ready)
+			break;
+
+		/*
+		 * The timeout only matters if we could not register our latch
+		 * above; a registered reader is woken by the writer's SetLatch.
+		 */
+		(void) WaitLatch(&MyProc->procLatch, WL_LATCH_SET | WL_TIMEOUT, 1000L);
+		ResetLatch(&MyProc->procLatch);
+	}
+
+	elog(DEBUG1, "SISC READER (shareid=%d, slice=%d): Wait ready got writer's handshake",
+			share_id, currentSliceId);
+
+	SpinLockAcquire(&shareinput_sync_ctl->mutex);
+	if (pctxt->latch_registered)
+	{
+		shareinput_shm_remove_waiter(slot, &MyProc->procLatch);
+		pctxt->latch_registered = false;
+	}
+	if (planGen == PLANGEN_PLANNER)
+	{
+		/* For planner-generated plans, we send ack back after receiving the handshake */
+		slot->nready_acks++;
+		writer_latch = slot->writer_latch;
+	}
+	SpinLockRelease(&shareinput_sync_ctl->mutex);
+
+	if (writer_latch != NULL)
+		SetLatch(writer_latch);
+
+	return (void *) pctxt;
+}
+
+/*
+ * Shared memory version of shareinput_writer_notifyready.  Returns NULL if
+ * no sync slot is available.
+ */
+static void *
+shareinput_shm_writer_notifyready(int share_id, int xslice, PlanGenerator planGen)
+{
+	ShareInput_Shm_Context *pctxt;
+	ShareInputSyncSlot *slot;
+	Latch	   *waiters[SISC_MAX_SYNC_WAITERS];
+	int			nwaiters;
+	int			i;
+
+	pctxt = gp_malloc(sizeof(ShareInput_Shm_Context));
+	if (!pctxt)
+		ereport(ERROR, (errcode(ERRCODE_OUT_OF_MEMORY),
+			errmsg("Shareinput Writer failed: out of memory")));
+
+	slot = shareinput_shm_attach_slot(share_id);
+	if (slot == NULL)
+	{
+		gp_free(pctxt);
+		elog(LOG, "SISC WRITER (shareid=%d, slice=%d): no sync slot available, "
+			 "falling back to fifo handshake", share_id, currentSliceId);
+		return NULL;
+	}
+
+	pctxt->use_shmem = true;
+	pctxt->is_writer = true;
+	pctxt->latch_registered = false;
+	pctxt->slot = slot;
+
+	RegisterXactCallbackOnce(XCallBack_ShareInput_Shm, pctxt);
+
+	SpinLockAcquire(&shareinput_sync_ctl->mutex);
+	slot->ready = true;
+	slot->writer_latch = &MyProc->procLatch;
+	nwaiters = slot->nwaiters;
+	for (i = 0; i < nwaiters; i++)
+		waiters[i] = slot->waiter_latches[i];
+	SpinLockRelease(&shareinput_sync_ctl->mutex);
+
+	for (i = 0; i < nwaiters; i++)
+		SetLatch(waiters[i]);
+
+	elog(DEBUG1, "SISC WRITER (shareid=%d, slice=%d): set ready, woke %d waiting readers",
+			share_id, currentSliceId, nwaiters);
+
+	if (planGen == PLANGEN_PLANNER)
+	{
+		/* For planner-generated plans, we wait for acks from all the readers */
+		for (;;)
+		{
+			int			nready_acks;
+
+			CHECK_FOR_INTERRUPTS();
+
+			SpinLockAcquire(&shareinput_sync_ctl->mutex);
+			nready_acks = slot->nready_acks;
+			SpinLockRelease(&shareinput_sync_ctl->mutex);
+
+			if (nready_acks >= xslice)
+				break;
+
+			(void) WaitLatch(&MyProc->procLatch, WL_LATCH_SET | WL_TIMEOUT, 1000L);
+			ResetLatch(&MyProc->procLatch);
+		}
+		elog(DEBUG1, "SISC WRITER (shareid=%d, slice=%d): got acks from %d xslice readers",
+				share_id, currentSliceId, xslice);
+	}
+
+	return (void *) pctxt;
+}
+
+/*
+ * Shared memory version of shareinput_reader_notifydone.
+ */
+static void
+shareinput_shm_reader_notifydone(ShareInput_Shm_Context *pctxt, int share_id)
+{
+	Latch	   *writer_latch;
+
+	SpinLockAcquire(&shareinput_sync_ctl->mutex);
+	pctxt->slot->ndone++;
+	writer_latch = pctxt->slot->writer_latch;
+	SpinLockRelease(&shareinput_sync_ctl->mutex);
+
+	if (writer_latch != NULL)
+		SetLatch(writer_latch);
+
+	UnregisterXactCallbackOnce(XCallBack_ShareInput_Shm, (void *) pctxt);
+	shareinput_shm_detach(pctxt);
+}
+
+/*
+ * Shared memory version of shareinput_writer_waitdone.
+ *
+ * Unlike the FIFO protocol there is no 'z' before 'b' problem: done
+ * notifications go to their own counter, so none can be mistaken for an
+ * ack during notifyready.
+ */
+static void
+shareinput_shm_writer_waitdone(ShareInput_Shm_Context *pctxt, int share_id, int nsharer_xslice)
+{
+	ShareInputSyncSlot *slot = pctxt->slot;
+
+	elog(DEBUG1, "SISC WRITER (shareid=%d, slice=%d): waiting for DONE message from %d readers",
+							share_id, currentSliceId, nsharer_xslice);
+
+	for (;;)
+	{
+		int			ndone;
+
+		CHECK_FOR_INTERRUPTS();
+
+		SpinLockAcquire(&shareinput_sync_ctl->mutex);
+		ndone = slot->ndone;
+		SpinLockRelease(&shareinput_sync_ctl->mutex);
+
+		if (ndone >= nsharer_xslice)
+			break;
+
+		(void) WaitLatch(&MyProc->procLatch, WL_LATCH_SET | WL_TIMEOUT, 1000L);
+		ResetLatch(&MyProc->procLatch);
+	}
+
+	elog(DEBUG1, "SISC WRITER (shareid=%d, slice=%d): Writer received all %d reader done notifications",
+			share_id, currentSliceId, nsharer_xslice);
+
+	UnregisterXactCallbackOnce(XCallBack_ShareInput_Shm, (void *) pctxt);
+	shareinput_shm_detach(pctxt);
+}
+
+/* Here we use the absolute path name as the lock name.  See fd.c
  * for how the name is created (GP_TEMP_FILE_DIR and make_database_relative).
  */
 static void
@@ -553,12 +999,23 @@ shareinput_reader_waitready(int share_id, PlanGenerator planGen)
 	struct timeval tval;
 	int n;
 	char a;
-	ShareInput_Lk_Context *pctxt = gp_malloc(sizeof(ShareInput_Lk_Context));
+	ShareInput_Lk_Context *pctxt;
+
+	if (gp_shareinput_shmem_sync)
+	{
+		void *shm_ctxt = shareinput_shm_reader_waitready(share_id, planGen);
+		if (shm_ctxt != NULL)
+			return shm_ctxt;
+		/* no slot available, fall through to the FIFO handshake */
+	}
+
+	pctxt = gp_malloc(sizeof(ShareInput_Lk_Context));
 
 	if(!pctxt)
 		ereport(ERROR, (errcode(ERRCODE_OUT_OF_MEMORY),
 			errmsg("Share input reader failed: out of memory")));
 
+	pctxt->use_shmem = false;
 	pctxt->readyfd = -1;
 	pctxt->donefd = -1;
 	pctxt->zcnt = 0;
@@ -651,13 +1108,23 @@ void *
 shareinput_writer_notifyready(int share_id, int xslice, PlanGenerator planGen)
 {
 	int n;
+	ShareInput_Lk_Context *pctxt;
+
+	if (gp_shareinput_shmem_sync)
+	{
+		void *shm_ctxt = shareinput_shm_writer_notifyready(share_id, xslice, planGen);
+		if (shm_ctxt != NULL)
+			return shm_ctxt;
+		/* no slot available, fall through to the FIFO handshake */
+	}
 
-	ShareInput_Lk_Context *pctxt = gp_malloc(sizeof(ShareInput_Lk_Context));
+	pctxt = gp_malloc(sizeof(ShareInput_Lk_Context));
 
 	if(!pctxt)
 		ereport(ERROR, (errcode(ERRCODE_OUT_OF_MEMORY),
 			errmsg("Shareinput Writer failed: out of memory")));
 
+	pctxt->use_shmem = false;
 	pctxt->readyfd = -1;
 	pctxt->donefd = -1;
 	pctxt->zcnt = 0;
@@ -775,6 +1242,13 @@ void
 shareinput_reader_notifydone(void *ctxt, int share_id)
 {
 	ShareInput_Lk_Context *pctxt = (ShareInput_Lk_Context *) ctxt;
+
+	if (pctxt->use_shmem)
+	{
+		shareinput_shm_reader_notifydone((ShareInput_Shm_Context *) ctxt, share_id);
+		return;
+	}
+
 #if USE_ASSERT_CHECKING
 	int rwsize  =
 #endif
@@ -801,7 +1275,15 @@ shareinput_writer_waitdone(void *ctxt, int share_id, int nsharer_xslice)
 	struct timeval tval;
 	int numReady;
 	char z;
-	int ack_needed = nsharer_xslice - pctxt->zcnt;
+	int ack_needed;
+
+	if (pctxt->use_shmem)
+	{
+		shareinput_shm_writer_waitdone((ShareInput_Shm_Context *) ctxt, share_id, nsharer_xslice);
+		return;
+	}
+
+	ack_needed = nsharer_xslice - pctxt->zcnt;
 
 	elog(DEBUG1, "SISC WRITER (shareid=%d, slice=%d): waiting for DONE message from %d readers",
 							share_id, currentSliceId, ack_needed);
@@ -327,16 +327,15 @@ ExecScanSubPlan(SubPlanState *node,
 			 * pass-by-ref type --- our return value will point into this
 			 * copied tuple!  Can't use the subplan's instance of the tuple
 			 * since it won't still be valid after next ExecProcNode() call.
-			 * node->curTuple keeps track of the copied tuple for eventual
-			 * freeing.
+			 * node->curTuple keeps track of the copied tuple; its buffer is
+			 * reused from one execution to the next, so a correlated subplan
+			 * stops allocating per outer row once the buffer has grown to
+			 * the widest result seen.
 			 */
-			MemoryContextSwitchTo(econtext->ecxt_per_query_memory);
-
-			if (node->curTuple)
-				pfree(node->curTuple);
-			node->curTuple = ExecCopySlotMemTuple(slot);
-
-			MemoryContextSwitchTo(econtext->ecxt_per_query_memory);
+			node->curTuple = ExecCopySlotMemTupleToBuffer(slot,
+														  econtext->ecxt_per_query_memory,
+														  (char **) &node->curTuple,
+														  &node->curTupleBufLen);
 
 			result = memtuple_getattr(node->curTuple, slot->tts_mt_bind, 1, isNull);
 			/* keep scanning subplan to make sure there's only one tuple */
@@ -697,6 +696,7 @@ ExecInitSubPlan(SubPlan *subplan, PlanState *parent)
 	 * initialize my state
 	 */
 	sstate->curTuple = NULL;
+	sstate->curTupleBufLen = 0;
 	sstate->curArray = PointerGetDatum(NULL);
 	sstate->projLeft = NULL;
 	sstate->projRight = NULL;
@@ -1087,11 +1087,13 @@ PG_TRY();
 		 * We need to copy the subplan's tuple into our own context, in case
 		 * any of the params are pass-by-ref type --- the pointers stored in
 		 * the param structs will point at this copied tuple! node->curTuple
-		 * keeps track of the copied tuple for eventual freeing.
+		 * keeps track of the copied tuple; its buffer is reused from one
+		 * execution to the next.
 		 */
-		if (node->curTuple)
-			pfree(node->curTuple);
-		node->curTuple = ExecCopySlotMemTuple(slot);
+		node->curTuple = ExecCopySlotMemTupleToBuffer(slot,
+													  econtext->ecxt_per_query_memory,
+													  (char **) &node->curTuple,
+													  &node->curTupleBufLen);
 
 		/*
 		 * Now set all the setParam params from the columns of the tuple
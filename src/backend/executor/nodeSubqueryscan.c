@@ -182,6 +182,20 @@ ExecInitSubqueryScan(SubqueryScan *node, EState *estate, int eflags)
 	ExecAssignResultTypeFromTL(&subquerystate->ss.ps);
 	ExecAssignScanProjectionInfo(&subquerystate->ss);
 
+	/*
+	 * A SubqueryScan with no qual, a one-to-one Var targetlist over the
+	 * subplan's output (ExecAssignScanProjectionInfo left ps_ProjInfo NULL
+	 * for that case) and no synthetic ctid labeling does nothing but relay
+	 * the subplan's result slot.  Mark it as a pass-through stage so that
+	 * ExecProcNode can fetch from the subplan directly; stacks of such
+	 * nodes, which ORCA plans produce in numbers, collapse one hop per
+	 * layer down to the real producer.
+	 */
+	if (node->scan.plan.qual == NIL &&
+		subquerystate->ss.ps.ps_ProjInfo == NULL &&
+		!subquerystate->cdb_want_ctid)
+		subquerystate->ss.ps.ps_ProxyTarget = subquerystate->subplan;
+
 	return subquerystate;
 }
 
@@ -45,6 +45,7 @@
 #include "parser/parse_agg.h"
 #include "parser/parse_coerce.h"
 #include "parser/parse_oper.h"
+#include "catalog/pg_type.h"
 #include "utils/acl.h"
 #include "utils/builtins.h"
 #include "utils/datum.h"
@@ -105,6 +106,7 @@ typedef struct WindowStatePerAggData
 {
 	/* Oids of transfer functions */
 	Oid			transfn_oid;
+	Oid			invtransfn_oid; /* may be InvalidOid */
 	Oid			finalfn_oid;	/* may be InvalidOid */
 
 	/*
@@ -113,8 +115,21 @@ typedef struct WindowStatePerAggData
 	 * flags are kept here.
 	 */
 	FmgrInfo	transfn;
+	FmgrInfo	invtransfn;
 	FmgrInfo	finalfn;
 
+	bool		invertible;		/* can exiting rows be removed with the
+								 * inverse transition function? */
+
+	/*
+	 * Number of accumulated rows whose arguments were all non-null.  Rows
+	 * with null arguments never change the transition value, so when inverse
+	 * transitions bring this count back to zero we simply re-initialize the
+	 * aggregate; the inverse function alone could not restore e.g. SUM's
+	 * NULL result over an empty or all-NULL frame.
+	 */
+	int64		notNullCount;
+
 	int			numFinalArgs;	/* number of arguments to pass to finalfn */
 
 	/*
@@ -155,6 +170,9 @@ static void initialize_windowaggregate(WindowAggState *winstate,
 static void advance_windowaggregate(WindowAggState *winstate,
 						WindowStatePerFunc perfuncstate,
 						WindowStatePerAgg peraggstate);
+static void invert_windowaggregate(WindowAggState *winstate,
+					   WindowStatePerFunc perfuncstate,
+					   WindowStatePerAgg peraggstate);
 static void finalize_windowaggregate(WindowAggState *winstate,
 						 WindowStatePerFunc perfuncstate,
 						 WindowStatePerAgg peraggstate,
@@ -219,6 +237,7 @@ initialize_windowaggregate(WindowAggState *winstate,
 	peraggstate->transValueIsNull = peraggstate->initValueIsNull;
 	peraggstate->noTransValue = peraggstate->initValueIsNull;
 	peraggstate->resultValueIsNull = true;
+	peraggstate->notNullCount = 0;
 }
 
 /*
@@ -237,6 +256,7 @@ advance_windowaggregate(WindowAggState *winstate,
 	Datum		newVal;
 	ListCell   *arg;
 	int			i;
+	bool		anynull;
 	MemoryContext oldContext;
 	ExprContext *econtext = winstate->tmpcontext;
 	ExprState  *filter = wfuncstate->aggfilter;
@@ -258,28 +278,34 @@ advance_windowaggregate(WindowAggState *winstate,
 
 	/* We start from 1, since the 0th arg will be the transition value */
 	i = 1;
+	anynull = false;
 	foreach(arg, wfuncstate->args)
 	{
 		ExprState  *argstate = (ExprState *) lfirst(arg);
 
 		fcinfo->arg[i] = ExecEvalExpr(argstate, econtext,
 									  &fcinfo->argnull[i], NULL);
+		anynull |= fcinfo->argnull[i];
 		i++;
 	}
 
+	/*
+	 * Count rows with wholly non-null arguments, so inverse transitions know
+	 * when the frame no longer contributes to the transition value.
+	 */
+	if (!anynull)
+		peraggstate->notNullCount++;
+
 	if (peraggstate->transfn.fn_strict)
 	{
 		/*
 		 * For a strict transfn, nothing happens when there's a NULL input; we
 		 * just keep the prior transValue.
 		 */
-		for (i = 1; i <= numArguments; i++)
+		if (anynull)
 		{
-			if (fcinfo->argnull[i])
-			{
-				MemoryContextSwitchTo(oldContext);
-				return;
-			}
+			MemoryContextSwitchTo(oldContext);
+			return;
 		}
 		if (peraggstate->noTransValue)
 		{
@@ -348,6 +374,134 @@ advance_windowaggregate(WindowAggState *winstate,
 	peraggstate->transValueIsNull = fcinfo->isnull;
 }
 
+/*
+ * invert_windowaggregate
+ * remove a row that has exited the frame from the transition value, using
+ * the aggregate's inverse transition function (pg_aggregate.agginvtransfn)
+ *
+ * The row to remove must be in tmpcontext's ecxt_outertuple, and its
+ * arguments are re-evaluated from there; eval_windowaggregates only uses
+ * this path when the aggregate's arguments and filter are non-volatile, so
+ * we remove exactly what advance_windowaggregate added.
+ */
+static void
+invert_windowaggregate(WindowAggState *winstate,
+					   WindowStatePerFunc perfuncstate,
+					   WindowStatePerAgg peraggstate)
+{
+	WindowFuncExprState *wfuncstate = perfuncstate->wfuncstate;
+	int			numArguments = perfuncstate->numArguments;
+	FunctionCallInfoData fcinfodata;
+	FunctionCallInfo fcinfo = &fcinfodata;
+	Datum		newVal;
+	ListCell   *arg;
+	int			i;
+	bool		anynull;
+	MemoryContext oldContext;
+	ExprContext *econtext = winstate->tmpcontext;
+	ExprState  *filter = wfuncstate->aggfilter;
+
+	oldContext = MemoryContextSwitchTo(econtext->ecxt_per_tuple_memory);
+
+	/* Anything FILTERed out was never accumulated */
+	if (filter)
+	{
+		bool		isnull;
+		Datum		res = ExecEvalExpr(filter, econtext, &isnull, NULL);
+
+		if (isnull || !DatumGetBool(res))
+		{
+			MemoryContextSwitchTo(oldContext);
+			return;
+		}
+	}
+
+	/* We start from 1, since the 0th arg will be the transition value */
+	i = 1;
+	anynull = false;
+	foreach(arg, wfuncstate->args)
+	{
+		ExprState  *argstate = (ExprState *) lfirst(arg);
+
+		fcinfo->arg[i] = ExecEvalExpr(argstate, econtext,
+									  &fcinfo->argnull[i], NULL);
+		anynull |= fcinfo->argnull[i];
+		i++;
+	}
+
+	/*
+	 * Rows with null arguments never changed the transition value (strict
+	 * transfns skipped them, and the non-strict invertible transfns ignore
+	 * null inputs), so there is nothing to remove.
+	 */
+	if (anynull)
+	{
+		MemoryContextSwitchTo(oldContext);
+		return;
+	}
+
+	MemoryContextSwitchTo(oldContext);
+
+	Assert(peraggstate->notNullCount > 0);
+	if (--peraggstate->notNullCount == 0)
+	{
+		/*
+		 * The remaining frame no longer contributes anything: reset to the
+		 * initial state rather than relying on the inverse function to find
+		 * its way back to it (SUM's transition value cannot return to NULL
+		 * by subtraction).  Free the old values by hand since we don't get
+		 * the aggcontext reset that the restart path does.
+		 */
+		if (!peraggstate->transtypeByVal && !peraggstate->transValueIsNull)
+			pfree(DatumGetPointer(peraggstate->transValue));
+		if (!peraggstate->resulttypeByVal && !peraggstate->resultValueIsNull)
+			pfree(DatumGetPointer(peraggstate->resultValue));
+		initialize_windowaggregate(winstate, perfuncstate, peraggstate);
+		return;
+	}
+
+	if (peraggstate->invtransfn.fn_strict && peraggstate->transValueIsNull)
+	{
+		/* don't call a strict function with NULL inputs */
+		return;
+	}
+
+	/*
+	 * OK to call the inverse transition function
+	 */
+	InitFunctionCallInfoData(*fcinfo, &(peraggstate->invtransfn),
+							 numArguments + 1,
+							 (void *) winstate, NULL);
+	fcinfo->arg[0] = peraggstate->transValue;
+	fcinfo->argnull[0] = peraggstate->transValueIsNull;
+
+	oldContext = MemoryContextSwitchTo(econtext->ecxt_per_tuple_memory);
+	newVal = FunctionCallInvoke(fcinfo);
+
+	/*
+	 * Same pass-by-ref handling as advance_windowaggregate: if the inverse
+	 * function didn't update the value in place, copy the result into
+	 * aggcontext and free the prior transValue.
+	 */
+	if (!peraggstate->transtypeByVal &&
+		DatumGetPointer(newVal) != DatumGetPointer(peraggstate->transValue))
+	{
+		if (!fcinfo->isnull)
+		{
+			MemoryContextSwitchTo(winstate->aggcontext);
+			newVal = datumCopy(newVal,
+							   peraggstate->transtypeByVal,
+							   peraggstate->transtypeLen);
+		}
+		if (!peraggstate->transValueIsNull)
+			pfree(DatumGetPointer(peraggstate->transValue));
+	}
+
+	MemoryContextSwitchTo(oldContext);
+	peraggstate->transValue = newVal;
+	peraggstate->transValueIsNull = fcinfo->isnull;
+}
+
 /*
  * finalize_windowaggregate
  * parallel to finalize_aggregate in nodeAgg.c
@@ -478,11 +632,12 @@ eval_windowaggregates(WindowAggState *winstate)
 	 * accumulated into the aggregate transition values.  Whenever we start a
 	 * new peer group, we accumulate forward to the end of the peer group.
 	 *
-	 * TODO: Rerunning aggregates from the frame start can be pretty slow. For
-	 * some aggregates like SUM and COUNT we could avoid that by implementing
-	 * a "negative transition function" that would be called for each row as
-	 * it exits the frame.	We'd have to think about avoiding recalculation of
-	 * volatile arguments of aggregate functions, too.
+	 * When every aggregate has an inverse transition function in the catalog
+	 * (pg_aggregate.agginvtransfn, e.g. SUM, COUNT, AVG) and its arguments
+	 * are non-volatile, we avoid rerunning the aggregates from the frame
+	 * start: rows that exited the frame are removed from the transition
+	 * values by invert_windowaggregate, turning sliding-window aggregation
+	 * (ROWS BETWEEN n PRECEDING ...) from O(n * frame) into O(n).
 	 */
 
 	/*
@@ -490,9 +645,59 @@ eval_windowaggregates(WindowAggState *winstate)
 	 */
 	update_frameheadpos(agg_winobj, winstate->temp_slot_1);
 
+	/*
+	 * If the frame head advanced and every aggregate is invertible, remove
+	 * the rows that exited the frame from the transition values instead of
+	 * rebuilding them from scratch.  Only worthwhile when the old and new
+	 * frames overlap; otherwise fall through to the restart path, which
+	 * re-aggregates no more rows than inversion would have removed.
+	 */
+	if (winstate->agg_inverse_ok &&
+		winstate->currentpos > 0 &&
+		winstate->start_offset_var_free &&
+		winstate->end_offset_var_free &&
+		winstate->aggregatedbase < winstate->frameheadpos &&
+		winstate->frameheadpos < winstate->aggregatedupto)
+	{
+		TupleTableSlot *inv_slot = winstate->temp_slot_2;
+		int64		pos;
+
+		for (pos = winstate->aggregatedbase; pos < winstate->frameheadpos; pos++)
+		{
+			if (!window_gettupleslot(agg_winobj, pos, inv_slot))
+				elog(ERROR, "could not re-fetch previously fetched frame row");
+
+			/* Set tuple context for evaluation of aggregate arguments */
+			winstate->tmpcontext->ecxt_outertuple = inv_slot;
+
+			/* Remove the row from the aggregates */
+			for (i = 0; i < numaggs; i++)
+			{
+				peraggstate = &winstate->peragg[i];
+				wfuncno = peraggstate->wfuncno;
+				invert_windowaggregate(winstate,
+									   &winstate->perfunc[wfuncno],
+									   peraggstate);
+			}
+
+			/* Reset per-input-tuple context after each tuple */
+			ResetExprContext(winstate->tmpcontext);
+		}
+		ExecClearTuple(inv_slot);
+
+		winstate->aggregatedbase = winstate->frameheadpos;
+
+		/*
+		 * The inverted rows are no longer needed, so let the tuplestore
+		 * discard them.
+		 */
+		if (agg_winobj->markptr >= 0)
+			WinSetMarkPosition(agg_winobj, winstate->frameheadpos);
+	}
+
 	/*
 	 * Initialize aggregates on first call for partition, or if the frame head
-	 * position moved since last time.
+	 * position moved since last time and could not be handled by inversion.
 	 */
 	if (winstate->currentpos == 0 ||
 		winstate->frameheadpos != winstate->aggregatedbase ||
@@ -1759,6 +1964,17 @@ ExecInitWindowAgg(WindowAgg *node, EState *estate, int eflags)
 	winstate->numfuncs = wfuncno + 1;
 	winstate->numaggs = aggno + 1;
 
+	/*
+	 * Aggregates can be advanced incrementally as rows exit the frame only
+	 * if every one of them is invertible.
+	 */
+	winstate->agg_inverse_ok = (winstate->numaggs > 0);
+	for (aggno = 0; aggno < winstate->numaggs; aggno++)
+	{
+		if (!winstate->peragg[aggno].invertible)
+			winstate->agg_inverse_ok = false;
+	}
+
 	/* Set up WindowObject for aggregates, if needed */
 	if (winstate->numaggs > 0)
 	{
@@ -2068,9 +2284,11 @@ initialize_peragg(WindowAggState *winstate, WindowFunc *wfunc,
 	Oid			aggtranstype;
 	AclResult	aclresult;
 	Oid			transfn_oid,
+				invtransfn_oid,
 				finalfn_oid;
 	bool		finalextra;
 	Expr	   *transfnexpr,
+			   *invtransfnexpr,
 			   *finalfnexpr;
 	Datum		textInitVal;
 	int			i;
@@ -2096,9 +2314,32 @@ initialize_peragg(WindowAggState *winstate, WindowFunc *wfunc,
 	 */
 
 	peraggstate->transfn_oid = transfn_oid = aggform->aggtransfn;
+	peraggstate->invtransfn_oid = invtransfn_oid = aggform->agginvtransfn;
 	peraggstate->finalfn_oid = finalfn_oid = aggform->aggfinalfn;
 	finalextra = aggform->aggfinalextra;
 
+	/*
+	 * An aggregate can be advanced incrementally as rows exit the frame if
+	 * it has an inverse transition function and its arguments (and filter)
+	 * can be re-evaluated deterministically for the exiting rows.
+	 *
+	 * Aggregates over inexact types are excluded even though the catalog
+	 * carries inverse transition functions for them (float4mi, float8mi,
+	 * float8_stat_decum): float addition does not invert losslessly, so
+	 * removing exited rows by subtraction drifts away from what a frame
+	 * restart computes, and a non-finite value entering and then leaving
+	 * the frame would leave inf - inf = NaN in the transition state for
+	 * every later frame in the partition.  Those aggregates keep using the
+	 * restart path.
+	 */
+	peraggstate->invertible = OidIsValid(invtransfn_oid) &&
+		!contain_volatile_functions((Node *) wfunc);
+	for (i = 0; i < numArguments; i++)
+	{
+		if (inputTypes[i] == FLOAT4OID || inputTypes[i] == FLOAT8OID)
+			peraggstate->invertible = false;
+	}
+
 	/* Check that aggregate owner has permission to call component fns */
 	{
 		HeapTuple	procTuple;
@@ -2117,6 +2358,14 @@ initialize_peragg(WindowAggState *winstate, WindowFunc *wfunc,
 		if (aclresult != ACLCHECK_OK)
 			aclcheck_error(aclresult, ACL_KIND_PROC,
 						   get_func_name(transfn_oid));
+		if (OidIsValid(invtransfn_oid))
+		{
+			aclresult = pg_proc_aclcheck(invtransfn_oid, aggOwner,
+										 ACL_EXECUTE);
+			if (aclresult != ACLCHECK_OK)
+				aclcheck_error(aclresult, ACL_KIND_PROC,
+							   get_func_name(invtransfn_oid));
+		}
 		if (OidIsValid(finalfn_oid))
 		{
 			aclresult = pg_proc_aclcheck(finalfn_oid, aggOwner,
@@ -2140,6 +2389,7 @@ initialize_peragg(WindowAggState *winstate, WindowFunc *wfunc,
 											   numArguments);
 
 	/* build expression trees using actual argument & result types */
+	invtransfnexpr = NULL;
 	build_aggregate_fnexprs(inputTypes,
 							numArguments,
 							0,	/* no ordered-set window functions yet */
@@ -2150,18 +2400,24 @@ initialize_peragg(WindowAggState *winstate, WindowFunc *wfunc,
 							transfn_oid,
 							finalfn_oid,
 							InvalidOid,             /* prelim */
-							InvalidOid,             /* invtrans */
+							invtransfn_oid,
 							InvalidOid,             /* invprelim */
 							&transfnexpr,
 							&finalfnexpr,
 							NULL,
-							NULL,
+							&invtransfnexpr,
 							NULL);
 
 	/* set up infrastructure for calling the transfn(s) and finalfn */
 	fmgr_info(transfn_oid, &peraggstate->transfn);
 	peraggstate->transfn.fn_expr = (Node *) transfnexpr;
 
+	if (OidIsValid(invtransfn_oid))
+	{
+		fmgr_info(invtransfn_oid, &peraggstate->invtransfn);
+		peraggstate->invtransfn.fn_expr = (Node *) invtransfnexpr;
+	}
+
 	if (OidIsValid(finalfn_oid))
 	{
 		fmgr_info(finalfn_oid, &peraggstate->finalfn);
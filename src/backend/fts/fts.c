@@ -502,6 +502,8 @@ void FtsLoop()
 	while (!shutdown_requested)
 	{
 		bool		has_mirrors;
+		bool		found_suspects = false;
+		time_t		timeout;
 
 		/* no need to live on if postmaster has died */
 		if (!PostmasterIsAlive(true))
@@ -562,6 +564,15 @@ void FtsLoop()
 
 			updated_probe_state = FtsWalRepMessageSegments(cdbs);
 
+			/*
+			 * If any probe failed, had to be retried or changed the
+			 * configuration, the cluster state is suspect: re-probe after a
+			 * shortened interval so that a fault is confirmed (or an
+			 * in-flight failover is followed up on) without waiting a full
+			 * gp_fts_probe_interval.
+			 */
+			found_suspects = updated_probe_state || FtsProbeCycleHadSuspects();
+
 			MemoryContextSwitchTo(oldContext);
 
 			/* free any pallocs we made inside probeSegments() */
@@ -576,11 +587,14 @@ void FtsLoop()
 		ftsProbeInfo->probeTick++;
 
 		/* check if we need to sleep before starting next iteration */
+		timeout = found_suspects ?
+			Min(gp_fts_probe_interval, gp_fts_probe_timeout) :
+			gp_fts_probe_interval;
 		elapsed = time(NULL) - probe_start_time;
-		if (elapsed < gp_fts_probe_interval && !shutdown_requested)
+		if (elapsed < timeout && !shutdown_requested)
 		{
 			if (!probe_requested)
-				pg_usleep((gp_fts_probe_interval - elapsed) * USECS_PER_SEC);
+				pg_usleep((timeout - elapsed) * USECS_PER_SEC);
 
 			CHECK_FOR_INTERRUPTS();
 		}
@@ -32,6 +32,14 @@
 
 static struct pollfd *PollFds;
 
+/*
+ * True when the current probe cycle had to retry a segment or saw a probe
+ * fail outright.  FtsLoop() consults this through FtsProbeCycleHadSuspects()
+ * to shorten the wait before the next cycle, so that a suspected fault is
+ * confirmed (or cleared) without waiting a full gp_fts_probe_interval.
+ */
+static bool probeCycleHadSuspects = false;
+
 static CdbComponentDatabaseInfo *
 FtsGetPeerSegment(CdbComponentDatabases *cdbs,
 				  int content, int dbid)
@@ -546,7 +554,8 @@ probeRecordResponse(fts_segment_info *ftsInfo, PGresult *result)
 	elogif(gp_log_fts >= GPVARS_VERBOSITY_TERSE, LOG,
 		   "FTS: segment (content=%d, dbid=%d, role=%c) reported "
 		   "isMirrorUp %d, isInSync %d, isSyncRepEnabled %d, "
-		   "isRoleMirror %d, and retryRequested %d to the prober.",
+		   "isRoleMirror %d, and retryRequested %d to the prober, "
+		   "%d seconds after the connection was started.",
 		   ftsInfo->primary_cdbinfo->segindex,
 		   ftsInfo->primary_cdbinfo->dbid,
 		   ftsInfo->primary_cdbinfo->role,
@@ -554,7 +563,8 @@ probeRecordResponse(fts_segment_info *ftsInfo, PGresult *result)
 		   ftsInfo->result.isInSync,
 		   ftsInfo->result.isSyncRepEnabled,
 		   ftsInfo->result.isRoleMirror,
-		   ftsInfo->result.retryRequested);
+		   ftsInfo->result.retryRequested,
+		   (int) ((pg_time_t) time(NULL) - ftsInfo->startTime));
 }
 
 /*
@@ -724,6 +734,7 @@ processRetry(fts_context *context)
 			case FTS_PROBE_FAILED:
 			case FTS_SYNCREP_OFF_FAILED:
 			case FTS_PROMOTE_FAILED:
+				probeCycleHadSuspects = true;
 				if (ftsInfo->retry_count == gp_fts_probe_retries)
 				{
 					elog(LOG, "FTS max (%d) retries exhausted "
@@ -1157,12 +1168,23 @@ InitPollFds(size_t size)
 	PollFds = (struct pollfd *) palloc0(size * sizeof(struct pollfd));
 }
 
+/*
+ * Did the most recent probe cycle have to retry a segment or record a
+ * failure?
+ */
+bool
+FtsProbeCycleHadSuspects(void)
+{
+	return probeCycleHadSuspects;
+}
+
 bool
 FtsWalRepMessageSegments(CdbComponentDatabases *cdbs)
 {
 	bool is_updated = false;
 	fts_context context;
 
+	probeCycleHadSuspects = false;
 	FtsWalRepInitProbeContext(cdbs, &context);
 	InitPollFds(cdbs->total_segments);
 
@@ -34,6 +34,15 @@ extern MemoryContext MessageContext;
 //	@doc:
 //		Optimize given query using GP optimizer
 //
+//		Note on caching: we deliberately do not cache translated plans here
+//		keyed on a constants-normalized DXL hash.  ORCA bakes constant
+//		values into the plan (static partition selection, motion decisions,
+//		cost-based alternatives), so re-binding different constants into a
+//		cached PlannedStmt can produce a plan that is wrong for the new
+//		values, not merely suboptimal.  Callers that want plan reuse for
+//		repeated query shapes should use prepared statements, where the
+//		plan cache invalidation machinery handles this at the proper level.
+//
 //---------------------------------------------------------------------------
 PlannedStmt *
 CGPOptimizer::PplstmtOptimize
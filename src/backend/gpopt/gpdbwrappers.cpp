@@ -1012,6 +1012,21 @@ gpdb::PnodePartConstraintRel
 	return NULL;
 }
 
+List *
+gpdb::PlPartitionDefaultLevelsRel
+	(
+	Oid oidRel
+	)
+{
+	GP_WRAP_START;
+	{
+		/* catalog tables: pg_partition, pg_partition_rule */
+		return get_relation_part_defaults(oidRel);
+	}
+	GP_WRAP_END;
+	return NIL;
+}
+
 bool
 gpdb::FHasExternalPartition
 	(
@@ -162,15 +162,14 @@ CQueryMutators::PqueryNormalizeGrpByPrL
 	const Query *pquery
 	)
 {
-	Query *pqueryCopy = (Query *) gpdb::PvCopyObject(const_cast<Query*>(pquery));
-
-	if (!FNeedsPrLNormalization(pqueryCopy))
+	// return the query unchanged when the project list is already flat;
+	// the caller owns the query, so no copy is needed for the no-op case
+	if (!FNeedsPrLNormalization(pquery))
 	{
-		return pqueryCopy;
+		return const_cast<Query*>(pquery);
 	}
 
-	Query *pqueryNew = PqueryConvertToDerivedTable(pqueryCopy, false /*fFixTargetList*/, true /*fFixHavingQual*/);
-	gpdb::GPDBFree(pqueryCopy);
+	Query *pqueryNew = PqueryConvertToDerivedTable(pquery, false /*fFixTargetList*/, true /*fFixHavingQual*/);
 
 	GPOS_ASSERT(1 == gpdb::UlListLength(pqueryNew->rtable));
 	Query *pqueryDrdTbl = (Query *) ((RangeTblEntry *) gpdb::PvListNth(pqueryNew->rtable, 0))->subquery;
@@ -1196,15 +1195,13 @@ CQueryMutators::PqueryNormalizeHaving
 	const Query *pquery
 	)
 {
-	Query *pqueryCopy = (Query *) gpdb::PvCopyObject(const_cast<Query*>(pquery));
-
+	// no having qual to pull up; return the caller-owned query unchanged
 	if (NULL == pquery->havingQual)
 	{
-		return pqueryCopy;
+		return const_cast<Query*>(pquery);
 	}
 
-	Query *pqueryNew = PqueryConvertToDerivedTable(pqueryCopy, true /*fFixTargetList*/, false /*fFixHavingQual*/);
-	gpdb::GPDBFree(pqueryCopy);
+	Query *pqueryNew = PqueryConvertToDerivedTable(pquery, true /*fFixTargetList*/, false /*fFixHavingQual*/);
 
 	RangeTblEntry *prte = ((RangeTblEntry *) gpdb::PvListNth(pqueryNew->rtable, 0));
 	Query *pqueryDrdTbl = (Query *) prte->subquery;
@@ -1309,26 +1306,46 @@ CQueryMutators::PqueryNormalize
 	ULONG ulQueryLevel
 	)
 {
-	// flatten join alias vars defined at the current level of the query
-	Query *pqueryResolveJoinVarReferences = gpdb::PqueryFlattenJoinAliasVar(const_cast<Query*>(pquery), ulQueryLevel);
+	// Copy the query tree once up front. Each pass below returns its input
+	// unchanged when it has nothing to do, so this is the only whole-tree
+	// copy on the common path; previously every pass made its own full copy
+	// of the query, which on large queries (e.g. wide UNIONs over hundreds
+	// of relations) dominated normalization time and memory.
+	Query *pqueryCopy = (Query *) gpdb::PvCopyObject(const_cast<Query*>(pquery));
+
+	// flatten join alias vars defined at the current level of the query;
+	// this mutates the copy in place
+	Query *pqueryResolveJoinVarReferences = gpdb::PqueryFlattenJoinAliasVar(pqueryCopy, ulQueryLevel);
 
 	// eliminate distinct clause
 	Query *pqueryEliminateDistinct = CQueryMutators::PqueryEliminateDistinctClause(pqueryResolveJoinVarReferences);
 	GPOS_ASSERT(NULL == pqueryEliminateDistinct->distinctClause);
-	gpdb::GPDBFree(pqueryResolveJoinVarReferences);
+	if (pqueryEliminateDistinct != pqueryResolveJoinVarReferences)
+	{
+		gpdb::GPDBFree(pqueryResolveJoinVarReferences);
+	}
 
 	// normalize window operator's project list
 	Query *pqueryWindowPlNormalized = CQueryMutators::PqueryNormalizeWindowPrL(pmp, pmda, pqueryEliminateDistinct);
-	gpdb::GPDBFree(pqueryEliminateDistinct);
+	if (pqueryWindowPlNormalized != pqueryEliminateDistinct)
+	{
+		gpdb::GPDBFree(pqueryEliminateDistinct);
+	}
 
 	// pull-up having quals into a select
 	Query *pqueryHavingNormalized = CQueryMutators::PqueryNormalizeHaving(pmp, pmda, pqueryWindowPlNormalized);
 	GPOS_ASSERT(NULL == pqueryHavingNormalized->havingQual);
-	gpdb::GPDBFree(pqueryWindowPlNormalized);
+	if (pqueryHavingNormalized != pqueryWindowPlNormalized)
+	{
+		gpdb::GPDBFree(pqueryWindowPlNormalized);
+	}
 
 	// normalize the group by project list
 	Query *pqueryNew = CQueryMutators::PqueryNormalizeGrpByPrL(pmp, pmda, pqueryHavingNormalized);
-	gpdb::GPDBFree(pqueryHavingNormalized);
+	if (pqueryNew != pqueryHavingNormalized)
+	{
+		gpdb::GPDBFree(pqueryHavingNormalized);
+	}
 
 	return pqueryNew;
 }
@@ -1487,9 +1504,10 @@ CQueryMutators::PqueryEliminateDistinctClause
 	const Query *pquery
 	)
 {
+	// no distinct clause to eliminate; return the caller-owned query unchanged
 	if (0 == gpdb::UlListLength(pquery->distinctClause))
 	{
-		return (Query*) gpdb::PvCopyObject(const_cast<Query*>(pquery));
+		return const_cast<Query*>(pquery);
 	}
 
 	// create a derived table out of the previous query
@@ -1618,17 +1636,16 @@ CQueryMutators::PqueryNormalizeWindowPrL
 	const Query *pquery
 	)
 {
-	Query *pqueryCopy = (Query *) gpdb::PvCopyObject(const_cast<Query*>(pquery));
-
+	// return the query unchanged when the window project list is already
+	// flat; the caller owns the query, so no copy is needed for the no-op case
 	if (!FNeedsWindowPrLNormalization(pquery))
 	{
-		return pqueryCopy;
+		return const_cast<Query*>(pquery);
 	}
 
 	// we do not fix target list of the derived table since we will be mutating it below
 	// to ensure that it does not have operations with window function
-	Query *pqueryNew = PqueryConvertToDerivedTable(pqueryCopy, false /*fFixTargetList*/, true /*fFixHavingQual*/);
-	gpdb::GPDBFree(pqueryCopy);
+	Query *pqueryNew = PqueryConvertToDerivedTable(pquery, false /*fFixTargetList*/, true /*fFixHavingQual*/);
 
 	GPOS_ASSERT(1 == gpdb::UlListLength(pqueryNew->rtable));
 	Query *pqueryDrdTbl = (Query *) ((RangeTblEntry *) gpdb::PvListNth(pqueryNew->rtable, 0))->subquery;
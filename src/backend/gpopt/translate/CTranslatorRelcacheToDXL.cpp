@@ -778,12 +778,14 @@ CTranslatorRelcacheToDXL::Pdrgpmdcol
 
 			if (!att->attisdropped)
 			{
-				IMDType *pmdtype = CTranslatorRelcacheToDXL::Pmdtype(pmp, pmdidCol);
+				// resolve the type through the accessor, so that repeated
+				// column types come out of the metadata cache instead of
+				// being rebuilt from the catalog for every column
+				const IMDType *pmdtype = pmda->Pmdtype(pmdidCol);
 				if(pmdtype->FFixedLength())
 				{
 					ulColLen = pmdtype->UlLength();
 				}
-				pmdtype->Release();
 			}
 		}
 
@@ -2319,6 +2321,14 @@ CTranslatorRelcacheToDXL::PimdobjRelStats
 //	@doc:
 //		Retrieve column statistics from relcache
 //
+//		This runs only on a metadata cache miss; the translated stats object
+//		then stays resident in CMDCache (keyed by an mdid that carries the
+//		relation's metadata version, so ANALYZE invalidates it) and repeated
+//		optimizations of the same tables reuse it without touching
+//		pg_statistic. Caching of *derived* statistics -- histogram joins and
+//		filter selectivities computed during the search -- happens inside
+//		the optimizer library and is outside the scope of this translator.
+//
 //---------------------------------------------------------------------------
 IMDCacheObject *
 CTranslatorRelcacheToDXL::PimdobjColStats
@@ -2383,9 +2393,10 @@ CTranslatorRelcacheToDXL::PimdobjColStats
 		if (!pmdcol->FDropped())
 		{
 			CMDIdGPDB *pmdidAttType = GPOS_NEW(pmp) CMDIdGPDB(oidAttType);
-			IMDType *pmdtype = Pmdtype(pmp, pmdidAttType);
+			// lookup the type through the accessor so we hit the metadata
+			// cache instead of rebuilding the type object from the relcache
+			const IMDType *pmdtype = pmda->Pmdtype(pmdidAttType);
 			dWidth = CStatisticsUtils::DDefaultColumnWidth(pmdtype);
-			pmdtype->Release();
 			pmdidAttType->Release();
 		}
 
@@ -3438,9 +3449,13 @@ CTranslatorRelcacheToDXL::PmdpartcnstrRelation
 	bool fhasIndex
 	)
 {
-	// get the part constraints
-	List *plDefaultLevelsRel = NIL;
-	Node *pnode = gpdb::PnodePartConstraintRel(oidRel, &plDefaultLevelsRel);
+	// Get the partitioning levels that have default partitions. This only
+	// inspects the partition rules; the per-part constraint expressions are
+	// fetched further below, and only when the relation has indexes -- that
+	// is the only case in which ORCA consumes them. Materializing the
+	// constraints of every part up front is prohibitively expensive for
+	// tables with many thousands of leaf partitions.
+	List *plDefaultLevelsRel = gpdb::PlPartitionDefaultLevelsRel(oidRel);
 
 	// don't retrieve part constraints if there are no indices
 	// and no default partitions at any level
@@ -3479,6 +3494,12 @@ CTranslatorRelcacheToDXL::PmdpartcnstrRelation
 	}
 	else
 	{
+		// the relation has indexes, so ORCA needs the part constraint
+		// expression; fetch and merge the constraints of all parts
+		List *plDefaultLevelsIgnored = NIL;
+		Node *pnode = gpdb::PnodePartConstraintRel(oidRel, &plDefaultLevelsIgnored);
+		gpdb::FreeList(plDefaultLevelsIgnored);
+
 		DrgPdxlcd *pdrgpdxlcd = GPOS_NEW(pmp) DrgPdxlcd(pmp);
 		const ULONG ulColumns = pdrgpmdcol->UlLength();
 		for (ULONG ul = 0; ul < ulColumns; ul++)
@@ -487,6 +487,18 @@ COptTasks::PvMDScCmp
 //		Execute a task using GPOS. TODO extend gpos to provide
 //		this functionality
 //
+//		The task runs single-threaded, and the memory pool below is created
+//		with fThreadSafe = false on purpose. Multi-threaded memo exploration
+//		cannot be driven from here: optimization calls back into the backend
+//		through gpdbwrappers.cpp for every catalog lookup, and the backend
+//		(syscache/relcache, palloc, elog/longjmp error handling, signal
+//		state) is single-threaded by design. Making that safe would require
+//		snapshotting all metadata a query can touch before the search
+//		starts, which the relcache translator cannot guarantee (stats and
+//		partition metadata are fetched lazily as the memo grows). Worker
+//		parallelism was removed from the optimizer library itself for the
+//		same reason.
+//
 //---------------------------------------------------------------------------
 void
 COptTasks::Execute
@@ -1097,7 +1109,15 @@ COptTasks::PvOptimizeTask
 		CRefCount::SafeRelease(pbsDisabled);
 		CRefCount::SafeRelease(pbsTraceFlags);
 		CRefCount::SafeRelease(pdxlnPlan);
-		CMDCache::Shutdown();
+
+		// Keep the metadata cache alive across optimizer exceptions when
+		// caching is enabled: falling back to the planner is routine, and
+		// the cache contents are still valid.  Invalidation of stale
+		// entries is handled by FMDCacheNeedsReset() on the next call.
+		if (!optimizer_metadata_caching)
+		{
+			CMDCache::Shutdown();
+		}
 
 		if (GPOS_MATCH_EX(ex, gpdxl::ExmaGPDB, gpdxl::ExmiGPDBError))
 		{
@@ -111,8 +111,9 @@ static char sock_path[MAXPGPATH];
 /*
  * Buffers for low-level I/O.
  *
- * The receive buffer is fixed size. Send buffer is usually 8k, but can be
- * enlarged by pq_putmessage_noblock() if the message doesn't fit otherwise.
+ * The receive buffer is fixed size. Send buffer starts out at 8k or at
+ * gp_client_send_buffer_size if that is set larger, and can still be
+ * enlarged by pq_putmessage_noblock() if a message doesn't fit otherwise.
  */
 
 #define PQ_SEND_BUFFER_SIZE 8192
@@ -138,6 +139,7 @@ static bool DoingCopyOut;
 static void pq_close(int code, Datum arg);
 static int	internal_putbytes(const char *s, size_t len);
 static int	internal_flush(void);
+static int	internal_flush_buffer(const char *buf, int *start, int *end);
 static void pq_set_nonblocking(bool nonblocking);
 static bool pq_send_mutex_lock();
 
@@ -154,7 +156,7 @@ static int	Setup_AF_UNIX(void);
 void
 pq_init(void)
 {
-	PqSendBufferSize = PQ_SEND_BUFFER_SIZE;
+	PqSendBufferSize = Max(gp_client_send_buffer_size, PQ_SEND_BUFFER_SIZE);
 	PqSendBuffer = MemoryContextAlloc(TopMemoryContext, PqSendBufferSize);
 	PqSendPointer = PqSendStart = PqRecvPointer = PqRecvLength = 0;
 	DoingCopyOut = false;
@@ -993,6 +995,21 @@ pq_peekbyte(void)
 	return (unsigned char) PqRecvBuffer[PqRecvPointer];
 }
 
+/* --------------------------------
+ *		pq_buffer_has_data - is any input already sitting in the
+ *			receive buffer?
+ *
+ * This lets the main command loop detect a pipelining client: when more
+ * input has already arrived, the next ReadCommand will not block, so
+ * going-idle bookkeeping can be skipped between batched messages.
+ * --------------------------------
+ */
+bool
+pq_buffer_has_data(void)
+{
+	return (PqRecvPointer < PqRecvLength);
+}
+
 /* --------------------------------
  *		pq_getbyte_if_available - get a single byte from connection,
  *			if available
@@ -1349,6 +1366,26 @@ internal_putbytes(const char *s, size_t len)
 			if (internal_flush())
 				return EOF;
 		}
+
+		/*
+		 * If the data doesn't fit in the buffer even when empty, send it
+		 * straight from the caller's memory. Copying it through PqSendBuffer
+		 * one buffer-load at a time would cost an extra memcpy per chunk
+		 * without saving any system calls.
+		 */
+		if (len >= (size_t) PqSendBufferSize)
+		{
+			int			sendstart = 0;
+			int			sendend = (int) len;
+
+			pq_set_nonblocking(false);
+			if (internal_flush())
+				return EOF;
+			if (internal_flush_buffer(s, &sendstart, &sendend))
+				return EOF;
+			return 0;
+		}
+
 		amount = PqSendBufferSize - PqSendPointer;
 		if (amount > len)
 			amount = len;
@@ -1395,11 +1432,28 @@ pq_flush(void)
  */
 static int
 internal_flush(void)
+{
+	return internal_flush_buffer(PqSendBuffer, &PqSendStart, &PqSendPointer);
+}
+
+/* --------------------------------
+ *		internal_flush_buffer - flush the given range of a buffer
+ *
+ * internal_flush() works on the usual send buffer; internal_putbytes()
+ * also uses this directly to send oversized payloads from the caller's
+ * memory without copying them into PqSendBuffer first.
+ *
+ * Returns 0 if OK (meaning everything was sent, or operation would block
+ * and the socket is in non-blocking mode), or EOF if trouble.
+ * --------------------------------
+ */
+static int
+internal_flush_buffer(const char *buf, int *start, int *end)
 {
 	static int	last_reported_send_errno = 0;
 
-	char	   *bufptr = PqSendBuffer + PqSendStart;
-	char	   *bufend = PqSendBuffer + PqSendPointer;
+	char	   *bufptr = (char *) buf + *start;
+	char	   *bufend = (char *) buf + *end;
 
 	while (bufptr < bufend)
 	{
@@ -1450,7 +1504,7 @@ internal_flush(void)
 			 * flag that'll cause the next CHECK_FOR_INTERRUPTS to terminate
 			 * the connection.
 			 */
-			PqSendStart = PqSendPointer = 0;
+			*start = *end = 0;
 			ClientConnectionLost = 1;
 			InterruptPending = 1;
 			return EOF;
@@ -1458,10 +1512,10 @@ internal_flush(void)
 
 		last_reported_send_errno = 0;	/* reset after any successful send */
 		bufptr += r;
-		PqSendStart += r;
+		*start += r;
 	}
 
-	PqSendStart = PqSendPointer = 0;
+	*start = *end = 0;
 	return 0;
 }
 
@@ -133,6 +133,44 @@ test__internal_flush_failedSendEPIPE(void **state)
 	assert_int_equal(InterruptPending, 1);
 }
 
+/*
+ *  Test for internal_putbytes() for the case when:
+ *    - the payload is at least PqSendBufferSize bytes long
+ *    - nothing is buffered yet
+ *  In that case the payload must be sent straight from the caller's
+ *  memory instead of being copied through PqSendBuffer.
+ */
+void
+test__internal_putbytes_direct_send(void **state)
+{
+	int			result;
+	char	   *payload;
+
+	/* pq_set_nonblocking() consults MyProcPort; blocking mode is a no-op */
+	MyProcPort = (Port *) calloc(1, sizeof(Port));
+	MyProcPort->noblock = false;
+
+	PqSendBufferSize = TEST_NUM_BYTES;
+	PqSendStart = PqSendPointer = 0;
+	payload = (char *) calloc(1, TEST_NUM_BYTES);
+
+	/* Expect exactly one send, from the payload itself */
+	expect_any(secure_write, port);
+	expect_value(secure_write, ptr, payload);
+	expect_value(secure_write, len, TEST_NUM_BYTES);
+	will_return(secure_write, TEST_NUM_BYTES);
+
+	result = internal_putbytes(payload, TEST_NUM_BYTES);
+
+	assert_int_equal(result, 0);
+	/* Nothing may be left behind in the send buffer */
+	assert_int_equal(PqSendPointer, 0);
+
+	free(payload);
+	free(MyProcPort);
+	MyProcPort = NULL;
+}
+
 /*
  * This is a mocked version of the accept() system call
  * We don't actually accept an incoming connection, but we just return
@@ -242,6 +280,7 @@ main(int argc, char* argv[])
 		unit_test(test__internal_flush_succesfulSend),
 		unit_test(test__internal_flush_failedSendEINTR),
 		unit_test(test__internal_flush_failedSendEPIPE),
+		unit_test(test__internal_putbytes_direct_send),
 		unit_test(test__StreamConnection_set_SNDTIMEO_AF_INET),
 		unit_test(test__StreamConnection_set_SNDTIMEO_AF_UNIX),
 		unit_test(test__StreamConnection_set_SNDTIMEO_segment)
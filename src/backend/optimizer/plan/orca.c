@@ -76,6 +76,52 @@ log_optimizer(PlannedStmt *plan, bool fUnexpectedFailure)
 }
 
 
+/*
+ * simple_query_bypass
+ *		Is this query simple enough that invoking ORCA is not worthwhile?
+ *
+ * ORCA pays a fixed startup cost per statement (metadata translation,
+ * exploration, DXL round trip) that dwarfs the execution time of a short
+ * single-table lookup. For such queries the plan space is small enough
+ * that the Postgres planner produces an equivalent plan in a fraction of
+ * the time, so when optimizer_bypass_simple_queries is set we skip ORCA
+ * and fall through to the planner immediately. Anything with joins,
+ * aggregation, subqueries, windowing, set operations or DML still goes
+ * through the full ORCA search.
+ */
+static bool
+simple_query_bypass(Query *parse)
+{
+	ListCell   *lc;
+	int			nrels = 0;
+
+	if (parse->commandType != CMD_SELECT)
+		return false;
+
+	if (parse->hasAggs ||
+		parse->hasWindowFuncs ||
+		parse->hasSubLinks ||
+		parse->intoClause != NULL ||
+		parse->cteList != NIL ||
+		parse->groupClause != NIL ||
+		parse->havingQual != NULL ||
+		parse->distinctClause != NIL ||
+		parse->setOperations != NULL)
+		return false;
+
+	foreach(lc, parse->rtable)
+	{
+		RangeTblEntry *rte = (RangeTblEntry *) lfirst(lc);
+
+		if (rte->rtekind != RTE_RELATION)
+			return false;
+		nrels++;
+	}
+
+	/* with a join there may be real plan alternatives; let ORCA at it */
+	return nrels <= 1;
+}
+
 /*
  * optimize_query
  *		Plan the query using the GPORCA planner
@@ -95,6 +141,18 @@ optimize_query(Query *parse, ParamListInfo boundParams)
 	ListCell	   *lc;
 	ListCell	   *lp;
 
+	/*
+	 * Hand trivially simple queries straight to the Postgres planner; the
+	 * NULL return makes standard_planner() fall back, exactly as if ORCA
+	 * had declined to produce a plan.
+	 */
+	if (optimizer_bypass_simple_queries && simple_query_bypass(parse))
+	{
+		if (optimizer_log)
+			elog(DEBUG1, "GPORCA bypassed for simple query");
+		return NULL;
+	}
+
 	/*
 	 * Initialize a dummy PlannerGlobal struct. ORCA doesn't use it, but the
 	 * pre- and post-processing steps do.
@@ -4747,11 +4747,33 @@ substitute_actual_srf_parameters_mutator(Node *node,
  * flatten_join_alias_var_optimizer
  *	  Replace Vars that reference JOIN outputs with references to the original
  *	  relation variables instead.
+ *
+ * The query is modified in place and also returned; when the range table
+ * contains no join entries there is nothing to flatten, and the query is
+ * returned untouched.  The caller must therefore own the passed-in query.
  */
 Query *
 flatten_join_alias_var_optimizer(Query *query, int queryLevel)
 {
-	Query *queryNew = (Query *) copyObject(query);
+	bool		hasJoinRTEs = false;
+	ListCell   *plc;
+
+	foreach(plc, query->rtable)
+	{
+		RangeTblEntry *rte = (RangeTblEntry *) lfirst(plc);
+
+		if (rte->rtekind == RTE_JOIN)
+		{
+			hasJoinRTEs = true;
+			break;
+		}
+	}
+
+	/* no join aliases anywhere in this query level; nothing to do */
+	if (!hasJoinRTEs)
+		return query;
+
+	Query *queryNew = query;
 
 	/* Create a PlannerInfo data structure for this subquery */
 	PlannerInfo *root = makeNode(PlannerInfo);
@@ -4778,22 +4800,7 @@ flatten_join_alias_var_optimizer(Query *query, int queryLevel)
 	root->join_info_list = NIL;
 	root->append_rel_list = NIL;
 
-	root->hasJoinRTEs = false;
-
-	ListCell *plc = NULL;
-	foreach(plc, queryNew->rtable)
-	{
-		RangeTblEntry *rte = (RangeTblEntry *) lfirst(plc);
-
-		if (rte->rtekind == RTE_JOIN)
-		{
-			root->hasJoinRTEs = true;
-			if (IS_OUTER_JOIN(rte->jointype))
-			{
-				break;
-			}
-		}
-	}
+	root->hasJoinRTEs = true;
 
 	/*
 	 * Flatten join alias for expression in
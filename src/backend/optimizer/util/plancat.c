@@ -460,7 +460,7 @@ cdb_estimate_rel_size(RelOptInfo   *relOptInfo,
 		 * If GUC gp_enable_relsize_collection is on, get the size of the table to derive curpages
 		 * else use the default value
 		 */
-		curpages = gp_enable_relsize_collection ? cdbRelMaxSegSize(rel) / BLCKSZ : DEFAULT_INTERNAL_TABLE_PAGES;
+		curpages = gp_enable_relsize_collection ? cdbRelMaxSegSizeCached(rel) / BLCKSZ : DEFAULT_INTERNAL_TABLE_PAGES;
 	}
 
 	/* report estimated # pages */
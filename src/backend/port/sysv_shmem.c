@@ -30,6 +30,12 @@
 #include <kernel/OS.h>
 #endif
 
+#ifdef HAVE_NUMA_H
+#define NUMA_VERSION1_COMPATIBILITY 1
+#include <numa.h>
+#endif
+
+#include "cdb/cdbvars.h"
 #include "miscadmin.h"
 #include "storage/ipc.h"
 #include "storage/pg_shmem.h"
@@ -345,6 +351,41 @@ PGSharedMemoryIsInUse(unsigned long id1, unsigned long id2)
  * it to generate the starting shmem key).	In a standalone backend,
  * zero will be passed.
  */
+#if defined(HAVE_NUMA_H) && defined(HAVE_LIBNUMA)
+/* LINUX */
+static void
+InterleaveSharedMemory(void *memAddress, Size size)
+{
+	if (numa_available() < 0)
+	{
+		elog(LOG, "Numa unavailable, shared memory will remain unbound.");
+		return;
+	}
+
+	if (numa_max_node() == 0)
+		return;					/* single node, nothing to spread */
+
+	/*
+	 * All shared memory regions are carved out of this one segment, so an
+	 * interleaved policy on the whole segment spreads shared buffers and
+	 * the interconnect receive buffers evenly over the nodes.  The policy
+	 * applies to pages not yet faulted in, which at this point is all of
+	 * the segment except its header page.
+	 */
+	numa_interleave_memory(memAddress, size, &numa_all_nodes);
+
+	elog(LOG, "Numa interleaving shared memory segment across %d nodes",
+		 numa_max_node() + 1);
+}
+#else
+/* UNSUPPORTED */
+static void
+InterleaveSharedMemory(void *memAddress, Size size)
+{
+	elog(LOG, "gp_numa_interleave_shared_memory setting ignored; feature not configured");
+}
+#endif
+
 PGShmemHeader *
 PGSharedMemoryCreate(Size size, bool makePrivate, int port)
 {
@@ -416,6 +457,14 @@ PGSharedMemoryCreate(Size size, bool makePrivate, int port)
 		 */
 	}
 
+	/*
+	 * Apply the NUMA placement policy before anything beyond the header
+	 * page is touched; an interleave policy only affects pages that have
+	 * not been faulted in yet.
+	 */
+	if (gp_numa_interleave_shared_memory)
+		InterleaveSharedMemory(memAddress, size);
+
 	/*
 	 * OK, we created a new segment.  Mark it as created by this process. The
 	 * order of assignments here is critical so that another Postgres process
@@ -18,6 +18,10 @@
  */
 #include "postgres.h"
 
+#include <math.h>
+
+#include "access/heapam.h"
+#include "access/transam.h"
 #include "catalog/catalog.h"
 #include "cdb/cdbvars.h"
 #include "cdb/cdbpartition.h"
@@ -37,6 +41,8 @@
  * Forward declarations.
  */
 static void autostats_issue_analyze(Oid relationOid);
+static bool autostats_incremental_update(AutoStatsCmdType cmdType, Oid relationOid,
+							 uint64 ntuples);
 static bool autostats_on_change_check(AutoStatsCmdType cmdType, uint64 ntuples);
 static bool autostats_on_no_stats_check(AutoStatsCmdType cmdType, Oid relationOid);
 
@@ -73,6 +79,98 @@ autostats_issue_analyze(Oid relationOid)
 	pfree(analyzeStmt);
 }
 
+/*
+ * Auto-stats employs this sub-routine to merge the row count of a completed
+ * command into the existing optimizer statistics of a relation, instead of
+ * issuing a full ANALYZE. Only the table-level counts in pg_class are
+ * adjusted; the per-column contents of pg_statistic are fractions of the
+ * table (most-common-value frequencies, distinct ratios, histogram bin
+ * boundaries) and remain usable as the table grows, so a load followed by
+ * this merge leaves the planner with an accurate cardinality immediately.
+ *
+ * Returns false if the relation has no statistics to merge into (or cannot
+ * be opened), in which case the caller should fall back to a full ANALYZE.
+ */
+static bool
+autostats_incremental_update(AutoStatsCmdType cmdType, Oid relationOid,
+							 uint64 ntuples)
+{
+	Relation	rel;
+	float4		oldtuples;
+	BlockNumber oldpages;
+	double		newtuples;
+	BlockNumber newpages;
+
+	switch (cmdType)
+	{
+		case AUTOSTATS_CMDTYPE_INSERT:
+		case AUTOSTATS_CMDTYPE_DELETE:
+		case AUTOSTATS_CMDTYPE_UPDATE:
+		case AUTOSTATS_CMDTYPE_COPY:
+			break;
+		default:
+			/* a CTAS target starts out with no statistics to merge into */
+			return false;
+	}
+
+	/*
+	 * Apply the same permission check as autostats_issue_analyze; without
+	 * table-owner level permissions we must not touch the statistics.
+	 */
+	if (!(pg_class_ownercheck(relationOid, GetUserId()) ||
+		  (pg_database_ownercheck(MyDatabaseId, GetUserId()) && !IsSharedRelation(relationOid))))
+		return false;
+
+	rel = try_relation_open(relationOid, ShareUpdateExclusiveLock, false);
+	if (rel == NULL)
+		return false;
+
+	oldtuples = rel->rd_rel->reltuples;
+	oldpages = rel->rd_rel->relpages;
+
+	/*
+	 * A relation that was never analyzed has relpages = 0, reltuples = 0.
+	 * There is nothing to merge into; a full ANALYZE is required.
+	 */
+	if (oldpages == 0 && oldtuples < 1)
+	{
+		relation_close(rel, ShareUpdateExclusiveLock);
+		return false;
+	}
+
+	switch (cmdType)
+	{
+		case AUTOSTATS_CMDTYPE_DELETE:
+			newtuples = Max((double) oldtuples - (double) ntuples, 0.0);
+			/* deleted tuples do not give pages back */
+			newpages = oldpages;
+			break;
+		case AUTOSTATS_CMDTYPE_UPDATE:
+			/*
+			 * The live tuple count is unchanged, but the table grows by the
+			 * new tuple versions.
+			 */
+			newtuples = oldtuples;
+			newpages = (BlockNumber) ceil(oldpages *
+										  ((double) oldtuples + (double) ntuples) /
+										  Max((double) oldtuples, 1.0));
+			break;
+		default:
+			/* INSERT and COPY: scale pages by the observed tuple density */
+			newtuples = (double) oldtuples + (double) ntuples;
+			newpages = (BlockNumber) ceil(oldpages * newtuples /
+										  Max((double) oldtuples, 1.0));
+			break;
+	}
+
+	vac_update_relstats(rel, newpages, newtuples,
+						rel->rd_rel->relhasindex, InvalidTransactionId,
+						false /* isvacuum */ );
+
+	relation_close(rel, ShareUpdateExclusiveLock);
+	return true;
+}
+
 /*
  * Method determines if auto-stats should run as per onchange auto-stats policy. This policy
  * enables auto-analyze if the command was a CTAS, INSERT, DELETE, UPDATE or COPY
@@ -295,6 +393,29 @@ auto_stats(AutoStatsCmdType cmdType, Oid relationOid, uint64 ntuples, bool inFun
 		return;
 	}
 
+	/*
+	 * If enabled, merge the command's row count into the existing statistics
+	 * instead of re-sampling the whole table, so that the load window does
+	 * not pay for a full ANALYZE. When the table has no statistics yet (the
+	 * on_no_stats case, and loads into never-analyzed tables), this falls
+	 * through to a regular auto-analyze.
+	 */
+	if (gp_autostats_incremental &&
+		autostats_incremental_update(cmdType, relationOid, ntuples))
+	{
+		if (log_autostats)
+		{
+			elog(LOG, "In mode %s, command %s on (dboid,tableoid)=(%d,%d) modifying " UINT64_FORMAT " tuples caused an incremental stats update.",
+				 lookup_autostats_mode_by_value(actual_gp_autostats_mode),
+				 autostats_cmdtype_to_string(cmdType),
+				 MyDatabaseId,
+				 relationOid,
+				 ntuples);
+		}
+
+		return;
+	}
+
 	if (log_autostats)
 	{
 		elog(LOG, "In mode %s, command %s on (dboid,tableoid)=(%d,%d) modifying " UINT64_FORMAT " tuples caused Auto-ANALYZE.",
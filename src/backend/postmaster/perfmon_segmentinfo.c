@@ -41,6 +41,7 @@
 #include "libpq/pqsignal.h"
 #include "tcop/tcopprot.h"
 #include "cdb/cdbvars.h"
+#include "gpmon/gpmon.h"
 #include "utils/vmem_tracker.h"
 
 /* Sender-related routines */
@@ -227,6 +228,10 @@ SegmentInfoSenderLoop(void)
 		if (cluster_state_collect_hook)
 			cluster_state_collect_hook();
 
+		/* Forward any telemetry queued in the shared-memory ring */
+		if (gp_enable_gpperfmon)
+			gpmon_ring_drain();
+
 		if (gp_enable_gpperfmon && counter >= gp_perfmon_segment_interval)
 		{
 			SegmentInfoSender();
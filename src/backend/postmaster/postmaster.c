@@ -123,6 +123,7 @@
 #include "postmaster/backoff.h"
 #include "postmaster/perfmon_segmentinfo.h"
 #include "replication/walsender.h"
+#include "storage/buf_internals.h"
 #include "storage/fd.h"
 #include "storage/ipc.h"
 #include "storage/pg_shmem.h"
@@ -479,6 +480,7 @@ static pid_t StartChildProcess(AuxProcType type);
 static void StartAutovacuumWorker(void);
 
 static void setProcAffinity(int id);
+static void setBackendNodeAffinity(void);
 
 #ifdef EXEC_BACKEND
 
@@ -4012,6 +4014,13 @@ BackendInitialize(Port *port)
 	/* Save port etc. for ps status */
 	MyProcPort = port;
 
+	/*
+	 * Bind this backend to the NUMA node of its buffer freelist partition,
+	 * before any significant memory is allocated in its name.
+	 */
+	if (gp_numa_backend_affinity)
+		setBackendNodeAffinity();
+
 	/*
 	 * PreAuthDelay is a debugging aid for investigating problems in the
 	 * authentication cycle: it can be set in postgresql.conf to allow time to
@@ -5832,6 +5841,32 @@ setProcAffinity(int id)
 
 	return;
 }
+
+/*
+ * Bind this backend to one NUMA node, chosen from the buffer freelist
+ * partition the backend hashes to, so that backends sharing a freelist
+ * partition also share a socket and allocate buffer memory locally.
+ */
+static void
+setBackendNodeAffinity(void)
+{
+	int			limit;
+	int			node;
+
+	if (numa_available() < 0)
+		return;
+
+	limit = numa_max_node() + 1;
+	if (limit <= 1)
+		return;
+
+	node = BufFreelistHomePartition(MyProcPid) % limit;
+
+	numa_run_on_node(node);
+	numa_set_preferred(node);
+
+	elog(DEBUG1, "Numa binding backend to numa-node %d", node);
+}
 #else
 /* UNSUPPORTED */
 static void
@@ -5839,4 +5874,10 @@ setProcAffinity(int id)
 {
 	elog(LOG, "gp_set_proc_affinity setting ignored; feature not configured");
 }
+
+static void
+setBackendNodeAffinity(void)
+{
+	elog(LOG, "gp_numa_backend_affinity setting ignored; feature not configured");
+}
 #endif
@@ -17,6 +17,10 @@
 #include <unistd.h>
 #include <time.h>
 
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
+
 #include "miscadmin.h"
 #include "access/genam.h"
 #include "access/xact.h"
@@ -54,11 +58,13 @@ typedef struct
 	bool		fastcheckpoint;
 	bool		nowait;
 	bool		includewal;
+	int			compression;
 	List	   *exclude;
 } basebackup_options;
 
 
 static bool match_exclude_list(char *path, List *exclude);
+static void sendBackupData(const char *data, int len);
 static int64 sendDir(char *path, int basepathlen, bool sizeonly, List *tablespaces, List *exclude);
 static int64 sendTablespace(char *path, bool sizeonly);
 static bool sendFile(char *readfilename, char *tarfilename,
@@ -88,6 +94,81 @@ typedef struct
 	int64		size;
 } tablespaceinfo;
 
+/* Compression level requested with the COMPRESSION option, 0 = none */
+static int	bb_compression = 0;
+
+#ifdef HAVE_LIBZ
+static z_stream bb_zstream;
+static bool bb_zstream_inited = false;
+static char *bb_zbuf = NULL;
+static uLong bb_zbufsize = 0;
+#endif
+
+/*
+ * Send one CopyData message containing the given bytes, deflating them
+ * first when the COMPRESSION option was given.
+ *
+ * Each message is compressed independently, as a self-contained gzip
+ * member, rather than as one continuous stream.  That preserves the
+ * message framing of the uncompressed protocol -- one tar header per
+ * message, file data in message-sized chunks -- which pg_basebackup's
+ * unpacking code relies on: the client just inflates each message and
+ * processes the result exactly as before.
+ */
+static void
+sendBackupData(const char *data, int len)
+{
+#ifdef HAVE_LIBZ
+	if (bb_compression > 0)
+	{
+		uLong		bound;
+
+		if (!bb_zstream_inited)
+		{
+			MemSet(&bb_zstream, 0, sizeof(bb_zstream));
+			if (deflateInit2(&bb_zstream, bb_compression, Z_DEFLATED,
+							 MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+				ereport(ERROR,
+						(errmsg("could not initialize compression library: %s",
+								bb_zstream.msg ? bb_zstream.msg : "")));
+			bb_zstream_inited = true;
+		}
+		else if (deflateReset(&bb_zstream) != Z_OK)
+			ereport(ERROR,
+					(errmsg("could not reset compression stream: %s",
+							bb_zstream.msg ? bb_zstream.msg : "")));
+
+		bound = deflateBound(&bb_zstream, (uLong) len);
+		if (bb_zbuf == NULL || bound > bb_zbufsize)
+		{
+			if (bb_zbuf)
+				pfree(bb_zbuf);
+			bb_zbuf = MemoryContextAlloc(TopMemoryContext, bound);
+			bb_zbufsize = bound;
+		}
+
+		bb_zstream.next_in = (Bytef *) data;
+		bb_zstream.avail_in = len;
+		bb_zstream.next_out = (Bytef *) bb_zbuf;
+		bb_zstream.avail_out = bb_zbufsize;
+
+		if (deflate(&bb_zstream, Z_FINISH) != Z_STREAM_END)
+			ereport(ERROR,
+					(errmsg("could not compress base backup data: %s",
+							bb_zstream.msg ? bb_zstream.msg : "")));
+
+		if (pq_putmessage('d', bb_zbuf, bb_zbufsize - bb_zstream.avail_out))
+			ereport(ERROR,
+					(errmsg("base backup could not send data, aborting backup")));
+		return;
+	}
+#endif
+
+	if (pq_putmessage('d', data, len))
+		ereport(ERROR,
+				(errmsg("base backup could not send data, aborting backup")));
+}
+
 
 /*
  * Called when ERROR or FATAL happens in perform_base_backup() after
@@ -317,9 +398,7 @@ perform_base_backup(basebackup_options *opt, DIR *tblspcdir)
 				 * 51.html
 				 */
 				XLogRead(buf, ptr, TAR_SEND_SIZE);
-				if (pq_putmessage('d', buf, TAR_SEND_SIZE))
-					ereport(ERROR,
-							(errmsg("base backup could not send data, aborting backup")));
+				sendBackupData(buf, TAR_SEND_SIZE);
 			}
 
 			elogif(debug_basebackup, LOG,
@@ -356,6 +435,7 @@ parse_basebackup_options(List *options, basebackup_options *opt)
 	bool		o_fast = false;
 	bool		o_nowait = false;
 	bool		o_wal = false;
+	bool		o_compression = false;
 
 	MemSet(opt, 0, sizeof(*opt));
 	opt->exclude = NIL;
@@ -408,6 +488,26 @@ parse_basebackup_options(List *options, basebackup_options *opt)
 			opt->includewal = true;
 			o_wal = true;
 		}
+		else if (strcmp(defel->defname, "compression") == 0)
+		{
+			if (o_compression)
+				ereport(ERROR,
+						(errcode(ERRCODE_SYNTAX_ERROR),
+						 errmsg("duplicate option \"%s\"", defel->defname)));
+			opt->compression = atoi(strVal(defel->arg));
+			if (opt->compression < 0 || opt->compression > 9)
+				ereport(ERROR,
+						(errcode(ERRCODE_SYNTAX_ERROR),
+						 errmsg("invalid compression level \"%s\"",
+								strVal(defel->arg))));
+#ifndef HAVE_LIBZ
+			if (opt->compression > 0)
+				ereport(ERROR,
+						(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+						 errmsg("COMPRESSION is not supported by this build")));
+#endif
+			o_compression = true;
+		}
 		else if (strcmp(defel->defname, "exclude") == 0)
 		{
 			/* EXCLUDE option can be specified multiple times */
@@ -426,12 +526,14 @@ parse_basebackup_options(List *options, basebackup_options *opt)
 			"progress = %s, "
 			"fastcheckpoint = %s, "
 			"nowait = %s, "
-			"wal = %s",
+			"wal = %s, "
+			"compression = %d",
 			opt->label,
 			opt->progress ? "true" : "false",
 			opt->fastcheckpoint ? "true" : "false",
 			opt->nowait ? "true" : "false",
-			opt->includewal ? "true" : "false");
+			opt->includewal ? "true" : "false",
+			opt->compression);
 }
 
 
@@ -450,6 +552,8 @@ SendBaseBackup(BaseBackupCmd *cmd)
 
 	parse_basebackup_options(cmd->options, &opt);
 
+	bb_compression = opt.compression;
+
 	WalSndSetState(WALSNDSTATE_BACKUP);
 
 	if (update_process_title)
@@ -619,7 +723,7 @@ sendFileWithContent(const char *filename, const char *content)
 
 	_tarWriteHeader(filename, NULL, &statbuf);
 	/* Send the contents as a CopyData message */
-	pq_putmessage('d', content, len);
+	sendBackupData(content, len);
 
 	/* Pad to 512 byte boundary, per tar format requirements */
 	pad = ((len + 511) & ~511) - len;
@@ -628,7 +732,7 @@ sendFileWithContent(const char *filename, const char *content)
 		char		buf[512];
 
 		MemSet(buf, 0, pad);
-		pq_putmessage('d', buf, pad);
+		sendBackupData(buf, pad);
 	}
 
 	elogif(debug_basebackup, LOG,
@@ -993,9 +1097,7 @@ sendFile(char *readfilename, char *tarfilename, struct stat *statbuf,
 	while ((cnt = fread(buf, 1, Min(sizeof(buf), statbuf->st_size - len), fp)) > 0)
 	{
 		/* Send the chunk as a CopyData message */
-		if (pq_putmessage('d', buf, cnt))
-			ereport(ERROR,
-			   (errmsg("base backup could not send data, aborting backup")));
+		sendBackupData(buf, cnt);
 
 		len += cnt;
 
@@ -1017,7 +1119,7 @@ sendFile(char *readfilename, char *tarfilename, struct stat *statbuf,
 		while (len < statbuf->st_size)
 		{
 			cnt = Min(sizeof(buf), statbuf->st_size - len);
-			pq_putmessage('d', buf, cnt);
+			sendBackupData(buf, cnt);
 			len += cnt;
 		}
 	}
@@ -1027,7 +1129,7 @@ sendFile(char *readfilename, char *tarfilename, struct stat *statbuf,
 	if (pad > 0)
 	{
 		MemSet(buf, 0, pad);
-		pq_putmessage('d', buf, pad);
+		sendBackupData(buf, pad);
 	}
 
 	FreeFile(fp);
@@ -1120,5 +1222,5 @@ _tarWriteHeader(const char *filename, const char *linktarget,
 		lastSum = sum;
 	}
 
-	pq_putmessage('d', h, 512);
+	sendBackupData(h, 512);
 }
@@ -51,7 +51,8 @@ static PGresult *libpqrcv_PQexec(const char *query);
 bool
 walrcv_connect(char *conninfo, XLogRecPtr startpoint)
 {
-	char		conninfo_repl[MAXCONNINFO + 75];
+	char		conninfo_repl[MAXCONNINFO + 128];
+	const char *compress_opt = "";
 	char	   *primary_sysid;
 	char		standby_sysid[32];
 	TimeLineID	primary_tli;
@@ -59,14 +60,26 @@ walrcv_connect(char *conninfo, XLogRecPtr startpoint)
 	PGresult   *res;
 	char		cmd[64];
 
+	/*
+	 * If WAL compression is enabled here (and we can decompress), ask the
+	 * walsender to compress.  gp_walrepl_compress is PGC_BACKEND, so passing
+	 * it as a startup option makes it take effect in the walsender backend
+	 * for this connection; a sender built without LZ4 support simply keeps
+	 * streaming uncompressed 'w' messages.
+	 */
+#ifdef HAVE_LIBLZ4
+	if (gp_walrepl_compress)
+		compress_opt = " options='-c gp_walrepl_compress=on'";
+#endif
+
 	/*
 	 * Connect using deliberately undocumented parameter: replication. The
 	 * database name is ignored by the server in replication mode, but specify
 	 * "replication" for .pgpass lookup.
 	 */
 	snprintf(conninfo_repl, sizeof(conninfo_repl),
-			 "%s dbname=replication replication=true fallback_application_name=walreceiver",
-			 conninfo);
+			 "%s dbname=replication replication=true fallback_application_name=walreceiver%s",
+			 conninfo, compress_opt);
 
 	streamConn = PQconnectdb(conninfo_repl);
 	if (PQstatus(streamConn) != CONNECTION_OK)
@@ -76,6 +76,7 @@ Node *replication_parse_result;
 %token K_NOWAIT
 %token K_EXCLUDE
 %token K_WAL
+%token K_COMPRESSION
 %token K_START_REPLICATION
 %token K_SYNC
 
@@ -158,6 +159,11 @@ base_backup_opt:
 				  $$ = makeDefElem("exclude",
 						  (Node *)makeString($2));
 				}
+			| K_COMPRESSION SCONST
+				{
+				  $$ = makeDefElem("compression",
+						  (Node *)makeString($2));
+				}
 			;
 
 /*
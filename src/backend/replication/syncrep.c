@@ -549,6 +549,31 @@ SyncRepReleaseWaiters(void)
 	}
 }
 
+/*
+ * Report whether any backend is currently queued waiting for a
+ * synchronous-replication acknowledgment.  Used by the walsender to decide
+ * whether to ask the standby for an immediate status reply.
+ */
+bool
+SyncRepHaveWaiters(void)
+{
+	bool		result = false;
+	int			i;
+
+	LWLockAcquire(SyncRepLock, LW_SHARED);
+	for (i = 0; i < NUM_SYNC_REP_WAIT_MODE; i++)
+	{
+		if (!SHMQueueEmpty(&(WalSndCtl->SyncRepQueue[i])))
+		{
+			result = true;
+			break;
+		}
+	}
+	LWLockRelease(SyncRepLock);
+
+	return result;
+}
+
 /*
  * Check if we are in the list of sync standbys, and if so, determine
  * priority sequence. Return priority if set, or zero to indicate that
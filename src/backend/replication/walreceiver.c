@@ -36,6 +36,10 @@
 #include <signal.h>
 #include <unistd.h>
 
+#ifdef HAVE_LIBLZ4
+#include <lz4.h>
+#endif
+
 #include "access/xlog_internal.h"
 #include "libpq/pqsignal.h"
 #include "miscadmin.h"
@@ -46,6 +50,7 @@
 #include "storage/pmsignal.h"
 #include "storage/procarray.h"
 #include "utils/guc.h"
+#include "utils/memutils.h"
 #include "utils/ps_status.h"
 #include "utils/resowner.h"
 #include "utils/timestamp.h"
@@ -93,6 +98,22 @@ static struct
 
 static StandbyReplyMessage reply_message;
 
+/*
+ * Buffer used to coalesce the WAL payload of consecutive stream messages
+ * into large sequential writes.  The sender chops the stream into
+ * protocol-message-sized pieces; writing each piece individually throttles
+ * the mirror to small-write speed during bulk loads.  Data is accumulated
+ * here as long as it is contiguous, and written out in one go when the
+ * buffer fills up, when a message arrives out of line, or before each
+ * flush/acknowledgment cycle, so batching never delays the reply to the
+ * primary beyond the existing receive loop.
+ */
+#define WALRCV_WRITE_BUF_SIZE	(XLOG_BLCKSZ * 64)
+
+static char *recvWriteBuf = NULL;
+static Size recvWriteBufLen = 0;		/* valid bytes in recvWriteBuf */
+static XLogRecPtr recvWriteBufStart;	/* WAL location of first byte */
+
 /*
  * About SIGTERM handling:
  *
@@ -117,9 +138,11 @@ static void EnableWalRcvImmediateExit(void);
 static void DisableWalRcvImmediateExit(void);
 static void WalRcvDie(int code, Datum arg);
 static void XLogWalRcvProcessMsg(unsigned char type, char *buf, Size len);
+static void XLogWalRcvQueueWrite(char *buf, Size nbytes, XLogRecPtr recptr);
+static void XLogWalRcvDrainBuffer(void);
 static void XLogWalRcvWrite(char *buf, Size nbytes, XLogRecPtr recptr);
 static void XLogWalRcvFlush(bool dying);
-static void XLogWalRcvSendReply(void);
+static void XLogWalRcvSendReply(bool force);
 static void ProcessWalSndrMessage(XLogRecPtr walEnd, TimestampTz sendTime);
 
 /* Signal handlers */
@@ -327,6 +350,10 @@ WalReceiverMain(void)
 	LogstreamResult.Write = LogstreamResult.Flush = GetXLogReplayRecPtr(NULL);
 	MemSet(&reply_message, 0, sizeof(reply_message));
 
+	/* Set up the write-coalescing buffer */
+	recvWriteBuf = MemoryContextAlloc(TopMemoryContext, WALRCV_WRITE_BUF_SIZE);
+	recvWriteBufLen = 0;
+
 	/* Loop until end-of-streaming or error */
 	for (;;)
 	{
@@ -384,8 +411,11 @@ WalReceiverMain(void)
 			while (walrcv_receive(0, &type, &buf, &len))
 				XLogWalRcvProcessMsg(type, buf, len);
 
+			/* The socket is dry; write out whatever we have coalesced. */
+			XLogWalRcvDrainBuffer();
+
 			/* Let the master know that we received some data. */
-			XLogWalRcvSendReply();
+			XLogWalRcvSendReply(false);
 
 			/*
 			 * If we've written some records, flush them to disk and let the
@@ -399,7 +429,7 @@ WalReceiverMain(void)
 			 * We didn't receive anything new, but send a status update to the
 			 * master anyway, to report any progress in applying WAL.
 			 */
-			XLogWalRcvSendReply();
+			XLogWalRcvSendReply(false);
 		}
 	}
 }
@@ -463,6 +493,7 @@ WalRcvDie(int code, Datum arg)
 	volatile WalRcvData *walrcv = WalRcv;
 
 	/* Ensure that all WAL records received are flushed to disk */
+	XLogWalRcvDrainBuffer();
 	XLogWalRcvFlush(true);
 
 	SpinLockAcquire(&walrcv->mutex);
@@ -566,9 +597,67 @@ XLogWalRcvProcessMsg(unsigned char type, char *buf, Size len)
 				buf += sizeof(WalDataMessageHeader);
 				len -= sizeof(WalDataMessageHeader);
 
-				XLogWalRcvWrite(buf, len, msghdr.dataStart);
+				XLogWalRcvQueueWrite(buf, len, msghdr.dataStart);
 				break;
 			}
+		case 'z':				/* Compressed WAL records */
+			{
+#ifdef HAVE_LIBLZ4
+				WalCompressedDataMessageHeader msghdr;
+				static char *decompress_buf = NULL;
+				static Size decompress_buf_size = 0;
+				int			rawlen;
+
+				if (len < sizeof(WalCompressedDataMessageHeader))
+					ereport(ERROR,
+							(errcode(ERRCODE_PROTOCOL_VIOLATION),
+							 errmsg_internal("invalid compressed WAL message received from primary"),
+							 errSendAlert(true)));
+				/* memcpy is required here for alignment reasons */
+				memcpy(&msghdr, buf, sizeof(WalCompressedDataMessageHeader));
+
+				ProcessWalSndrMessage(msghdr.wal.walEnd, msghdr.wal.sendTime);
+
+				buf += sizeof(WalCompressedDataMessageHeader);
+				len -= sizeof(WalCompressedDataMessageHeader);
+
+				/*
+				 * The decompression buffer is kept across messages; grow it
+				 * if the sender's batch size exceeds what we have seen so
+				 * far.  It must not go away when per-message memory is
+				 * reset, hence TopMemoryContext.
+				 */
+				if (decompress_buf_size < msghdr.rawlen)
+				{
+					if (decompress_buf != NULL)
+						pfree(decompress_buf);
+					decompress_buf = MemoryContextAlloc(TopMemoryContext,
+														msghdr.rawlen);
+					decompress_buf_size = msghdr.rawlen;
+				}
+
+				rawlen = LZ4_decompress_safe(buf, decompress_buf,
+											 (int) len, (int) msghdr.rawlen);
+				if (rawlen < 0 || (uint32) rawlen != msghdr.rawlen)
+					ereport(ERROR,
+							(errcode(ERRCODE_PROTOCOL_VIOLATION),
+							 errmsg_internal("could not decompress WAL message received from primary"),
+							 errSendAlert(true)));
+
+				elogif(debug_walrepl_rcv, LOG,
+					   "walrcv msg metadata -- datastart %s, buflen %d, rawlen %d",
+						XLogLocationToString(&(msghdr.wal.dataStart)), (int) len, rawlen);
+
+				XLogWalRcvQueueWrite(decompress_buf, (Size) rawlen, msghdr.wal.dataStart);
+				break;
+#else
+				ereport(ERROR,
+						(errcode(ERRCODE_PROTOCOL_VIOLATION),
+						 errmsg("received compressed WAL data, but this server was not built with LZ4 support"),
+						 errSendAlert(true)));
+				break;
+#endif
+			}
 		case 'k':				/* Keepalive */
 			{
 				PrimaryKeepaliveMessage keepalive;
@@ -582,6 +671,18 @@ XLogWalRcvProcessMsg(unsigned char type, char *buf, Size len)
 				memcpy(&keepalive, buf, sizeof(PrimaryKeepaliveMessage));
 
 				ProcessWalSndrMessage(keepalive.walEnd, keepalive.sendTime);
+
+				/*
+				 * The primary has sync-rep waiters queued; answer with our
+				 * current positions right away.  Write out any coalesced WAL
+				 * first so the reply carries the newest flush location.
+				 */
+				if (keepalive.replyRequested)
+				{
+					XLogWalRcvDrainBuffer();
+					XLogWalRcvFlush(false);
+					XLogWalRcvSendReply(true);
+				}
 				break;
 			}
 		default:
@@ -592,6 +693,71 @@ XLogWalRcvProcessMsg(unsigned char type, char *buf, Size len)
 	}
 }
 
+/*
+ * Queue XLOG data for writing, coalescing consecutive stream messages
+ * into large sequential writes.  The data is guaranteed to be on disk
+ * only after the next XLogWalRcvDrainBuffer() + XLogWalRcvFlush() cycle.
+ */
+static void
+XLogWalRcvQueueWrite(char *buf, Size nbytes, XLogRecPtr recptr)
+{
+	/*
+	 * If the new data doesn't append to what we have buffered, write out
+	 * the old data first.  (With a well-behaved sender the stream position
+	 * only ever moves forward, but a reconnect can legitimately resend.)
+	 */
+	if (recvWriteBufLen > 0)
+	{
+		XLogRecPtr	expected = recvWriteBufStart;
+
+		XLByteAdvance(expected, recvWriteBufLen);
+		if (!XLByteEQ(recptr, expected))
+			XLogWalRcvDrainBuffer();
+	}
+
+	while (nbytes > 0)
+	{
+		Size		freespace = WALRCV_WRITE_BUF_SIZE - recvWriteBufLen;
+		Size		chunk;
+
+		/*
+		 * Don't bother staging data that already amounts to a full-sized
+		 * write; pass it to the kernel directly and skip the copy.
+		 */
+		if (recvWriteBufLen == 0 && nbytes >= WALRCV_WRITE_BUF_SIZE)
+		{
+			XLogWalRcvWrite(buf, nbytes, recptr);
+			return;
+		}
+
+		chunk = Min(nbytes, freespace);
+		if (recvWriteBufLen == 0)
+			recvWriteBufStart = recptr;
+		memcpy(recvWriteBuf + recvWriteBufLen, buf, chunk);
+		recvWriteBufLen += chunk;
+
+		XLByteAdvance(recptr, chunk);
+		buf += chunk;
+		nbytes -= chunk;
+
+		if (recvWriteBufLen == WALRCV_WRITE_BUF_SIZE)
+			XLogWalRcvDrainBuffer();
+	}
+}
+
+/*
+ * Write out any coalesced XLOG data.
+ */
+static void
+XLogWalRcvDrainBuffer(void)
+{
+	if (recvWriteBufLen > 0)
+	{
+		XLogWalRcvWrite(recvWriteBuf, recvWriteBufLen, recvWriteBufStart);
+		recvWriteBufLen = 0;
+	}
+}
+
 /*
  * Write XLOG data to disk.
  */
@@ -761,7 +927,7 @@ XLogWalRcvFlush(bool dying)
 				}
 				wait_before_send_ack = false;
 			}
-			XLogWalRcvSendReply();
+			XLogWalRcvSendReply(false);
 		}
 
 		elogif(debug_walrepl_rcv, LOG,
@@ -777,9 +943,13 @@ XLogWalRcvFlush(bool dying)
 /*
  * Send reply message to primary, indicating our current XLOG positions and
  * the current time.
+ *
+ * If "force" is set, a reply is sent even if nothing has changed since the
+ * last one and regardless of wal_receiver_status_interval; the primary asked
+ * for it because sync-rep waiters are blocked on our acknowledgment.
  */
 static void
-XLogWalRcvSendReply(void)
+XLogWalRcvSendReply(bool force)
 {
 	char		buf[sizeof(StandbyReplyMessage) + 1];
 	TimestampTz now;
@@ -788,7 +958,7 @@ XLogWalRcvSendReply(void)
 	 * If the user doesn't want status to be reported to the master, be sure
 	 * to exit before doing anything at all.
 	 */
-	if (wal_receiver_status_interval <= 0)
+	if (!force && wal_receiver_status_interval <= 0)
 		return;
 
 	/* Get current timestamp. */
@@ -803,7 +973,8 @@ XLogWalRcvSendReply(void)
 	 * this is only for reporting purposes and only on idle systems, that's
 	 * probably OK.
 	 */
-	if (XLByteEQ(reply_message.write, LogstreamResult.Write)
+	if (!force
+		&& XLByteEQ(reply_message.write, LogstreamResult.Write)
 		&& XLByteEQ(reply_message.flush, LogstreamResult.Flush)
 		&& !TimestampDifferenceExceeds(reply_message.sendTime, now,
 									   wal_receiver_status_interval * 1000))
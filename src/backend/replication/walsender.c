@@ -41,6 +41,10 @@
 #include <signal.h>
 #include <unistd.h>
 
+#ifdef HAVE_LIBLZ4
+#include <lz4.h>
+#endif
+
 #include "access/transam.h"
 #include "access/xlog_internal.h"
 #include "catalog/pg_type.h"
@@ -105,6 +109,15 @@ static uint32 sendOff = 0;
  */
 static XLogRecPtr sentPtr = {0, 0};
 
+#ifdef HAVE_LIBLZ4
+/*
+ * Buffer for building compressed 'z' messages when the walreceiver asked
+ * for WAL compression (gp_walrepl_compress).  Allocated once in WalSndLoop,
+ * like output_message.
+ */
+static char *compress_message = NULL;
+#endif
+
 /*
  * Buffer for processing reply messages.
  */
@@ -135,7 +148,7 @@ static void ProcessStandbyMessage(void);
 static void ProcessStandbyReplyMessage(void);
 static void ProcessRepliesIfAny(void);
 static const char *WalSndGetStateString(WalSndState state);
-static void WalSndKeepalive(char *msgbuf);
+static void WalSndKeepalive(char *msgbuf, bool requestReply);
 static void WalSndSetSync(bool sync);
 static void WalSndSetCaughtupWithinRange(bool catchup_within_range);
 static bool WalSndIsCatchupWithinRange(XLogRecPtr currRecPtr, XLogRecPtr catchupRecPtr);
@@ -544,6 +557,12 @@ WalSndLoop(void)
 	 */
 	output_message = palloc(1 + sizeof(WalDataMessageHeader) + MAX_SEND_SIZE);
 
+#ifdef HAVE_LIBLZ4
+	if (gp_walrepl_compress)
+		compress_message = palloc(1 + sizeof(WalCompressedDataMessageHeader) +
+								  LZ4_COMPRESSBOUND(MAX_SEND_SIZE));
+#endif
+
 	/*
 	 * Allocate buffer that will be used for processing reply messages.  As
 	 * above, do this just once to reduce palloc overhead.
@@ -608,6 +627,26 @@ WalSndLoop(void)
 		/* If nothing remains to be sent right now ... */
 		if (caughtup && !pq_is_send_pending())
 		{
+			static XLogRecPtr replyRequestedUpto = {0, 0};
+
+			/*
+			 * If backends are queued waiting for synchronous-replication
+			 * acknowledgment of WAL we have fully sent, ask the standby to
+			 * report its positions right away rather than at its own leisure.
+			 * The standby acknowledges everything it has flushed in a single
+			 * reply, and SyncRepReleaseWaiters() releases all eligible
+			 * waiters off that one reply, so one round trip drains the whole
+			 * queue up to that point.  Request at most once per sent
+			 * position so an unresponsive standby isn't flooded.
+			 */
+			if (!XLByteEQ(replyRequestedUpto, sentPtr) && SyncRepHaveWaiters())
+			{
+				WalSndKeepalive(output_message, true);
+				replyRequestedUpto = sentPtr;
+				if (pq_flush_if_writable() != 0)
+					break;
+			}
+
 			/*
 			 * If we're in catchup state, move to streaming.  This is an
 			 * important state change for users to know about, since before
@@ -670,7 +709,7 @@ WalSndLoop(void)
 				wakeEvents |= WL_SOCKET_WRITEABLE;
 			else if (MyWalSnd->sendKeepalive)
 			{
-				WalSndKeepalive(output_message);
+				WalSndKeepalive(output_message, false);
 				/* Try to flush pending output to the client */
 				if (pq_flush_if_writable() != 0)
 					break;
@@ -1009,6 +1048,8 @@ XLogSend(char *msgbuf, bool *caughtup, bool *caughtup_within_range)
 	XLogRecPtr	endptr;
 	Size		nbytes;
 	WalDataMessageHeader msghdr;
+	char	   *sendbuf;
+	Size		sendlen;
 
 	SendRqstPtr = GetFlushRecPtr();
 
@@ -1096,7 +1137,45 @@ XLogSend(char *msgbuf, bool *caughtup, bool *caughtup_within_range)
 
 	memcpy(msgbuf + 1, &msghdr, sizeof(WalDataMessageHeader));
 
-	pq_putmessage_noblock('d', msgbuf, 1 + sizeof(WalDataMessageHeader) + nbytes);
+	sendbuf = msgbuf;
+	sendlen = 1 + sizeof(WalDataMessageHeader) + nbytes;
+
+#ifdef HAVE_LIBLZ4
+	/*
+	 * If the walreceiver asked for compression, try to ship this batch as a
+	 * 'z' message instead.  Batches that don't shrink (already-compressed
+	 * data, tiny tails) go out as plain 'w' messages.
+	 */
+	if (compress_message != NULL)
+	{
+		int			clen;
+
+		clen = LZ4_compress_default(msgbuf + 1 + sizeof(WalDataMessageHeader),
+									compress_message + 1 + sizeof(WalCompressedDataMessageHeader),
+									(int) nbytes,
+									LZ4_COMPRESSBOUND(MAX_SEND_SIZE));
+		if (clen > 0 && (Size) clen < nbytes)
+		{
+			WalCompressedDataMessageHeader cmsghdr;
+
+			cmsghdr.wal = msghdr;
+			cmsghdr.rawlen = (uint32) nbytes;
+
+			compress_message[0] = 'z';
+			memcpy(compress_message + 1, &cmsghdr,
+				   sizeof(WalCompressedDataMessageHeader));
+
+			sendbuf = compress_message;
+			sendlen = 1 + sizeof(WalCompressedDataMessageHeader) + clen;
+
+			elogif(debug_walrepl_snd, LOG,
+					"walsnd xlogSend -- compressed %d bytes of WAL to %d bytes.",
+					(int) nbytes, clen);
+		}
+	}
+#endif
+
+	pq_putmessage_noblock('d', sendbuf, sendlen);
 
 	sentPtr = endptr;
 
@@ -1669,13 +1748,14 @@ pg_stat_get_wal_senders(PG_FUNCTION_ARGS)
 }
 
 static void
-WalSndKeepalive(char *msgbuf)
+WalSndKeepalive(char *msgbuf, bool requestReply)
 {
 	PrimaryKeepaliveMessage keepalive_message;
 
 	/* Construct a new message */
 	keepalive_message.walEnd = sentPtr;
 	keepalive_message.sendTime = GetCurrentTimestamp();
+	keepalive_message.replyRequested = requestReply;
 
 	elog(DEBUG2, "sending replication keepalive");
 
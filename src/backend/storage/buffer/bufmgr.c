@@ -94,6 +94,56 @@ static volatile BufferDesc *PinCountWaitBuf = NULL;
 
 static XLogRecPtr InvalidXLogRecPtr = {0, 0};
 
+/*
+ * Backend-local cache of recent buffer lookups.
+ *
+ * The buffer mapping table is one of the hottest lock acquisitions in the
+ * system, and the overwhelming majority of lookups hit the same small set
+ * of blocks again and again (btree roots and inner pages, catalog pages).
+ * We remember the result of recent lookups here, in a small direct-mapped
+ * table indexed by the tag's hash code, and re-validate a remembered
+ * mapping under the buffer header spinlock alone; a hit therefore never
+ * touches the mapping partition LWLock.  Stale entries are harmless: the
+ * validation simply fails and we fall back to the locked lookup.
+ */
+#define NUM_RECENT_BUFFERS	8
+
+typedef struct RecentBufferEnt
+{
+	BufferTag	tag;			/* tag of remembered disk page */
+	int			buf_id;			/* buffer it was in when last seen */
+} RecentBufferEnt;
+
+static RecentBufferEnt RecentBuffers[NUM_RECENT_BUFFERS];
+
+/*
+ * Remember where a block was found, for RecentBuffers validation later.
+ * A zeroed entry can never match a real tag, since relNode is never 0.
+ */
+static inline void
+RecentBufferRemember(BufferTag *tag, uint32 hashcode, int buf_id)
+{
+	RecentBufferEnt *ent = &RecentBuffers[hashcode % NUM_RECENT_BUFFERS];
+
+	ent->tag = *tag;
+	ent->buf_id = buf_id;
+}
+
+/*
+ * Checkpoint writes are issued in file order rather than buffer-id order,
+ * so that what reaches the kernel is mostly sequential I/O that it can
+ * coalesce.  This is the sort key; one item per dirty buffer found at the
+ * start of the checkpoint.
+ */
+typedef struct CkptSortItem
+{
+	Oid			tsId;
+	Oid			relNode;
+	ForkNumber	forkNum;
+	BlockNumber blockNum;
+	int			buf_id;
+} CkptSortItem;
+
 static Buffer ReadBuffer_common(SMgrRelation reln, bool isLocalBuf,
 				  ForkNumber forkNum, BlockNumber blockNum,
 				  ReadBufferMode mode, BufferAccessStrategy strategy,
@@ -102,6 +152,7 @@ static bool PinBuffer(volatile BufferDesc *buf, BufferAccessStrategy strategy);
 static void PinBuffer_Locked(volatile BufferDesc *buf);
 static void UnpinBuffer(volatile BufferDesc *buf, bool fixOwner);
 static void BufferSync(int flags);
+static int	ckpt_buforder_comparator(const void *pa, const void *pb);
 static int	SyncOneBuffer(int buf_id, bool skip_recently_used);
 static void WaitIO(volatile BufferDesc *buf);
 static bool StartBufferIO(volatile BufferDesc *buf, bool forInput);
@@ -594,6 +645,55 @@ BufferAlloc(SMgrRelation smgr, ForkNumber forkNum,
 	newHash = BufTableHashCode(&newTag);
 	newPartitionLock = BufMappingPartitionLock(newHash);
 
+	/*
+	 * Before touching the mapping table, check whether we remember where
+	 * this block was from a recent lookup.  The remembered mapping may be
+	 * arbitrarily stale, so it must be re-validated under the buffer header
+	 * spinlock, which is what serializes against the buffer being renamed
+	 * to another tag.  On a hit we pin the buffer without ever taking the
+	 * mapping partition lock.
+	 */
+	{
+		RecentBufferEnt *ent = &RecentBuffers[newHash % NUM_RECENT_BUFFERS];
+
+		if (BUFFERTAGS_EQUAL(ent->tag, newTag))
+		{
+			buf = &BufferDescriptors[ent->buf_id];
+
+			LockBufHdr(buf);
+			if (BUFFERTAGS_EQUAL(buf->tag, newTag) &&
+				(buf->flags & BM_VALID) != 0)
+			{
+				/*
+				 * Adjust the usage count the way PinBuffer would have;
+				 * PinBuffer_Locked doesn't touch it.
+				 */
+				if (PrivateRefCount[buf->buf_id] == 0)
+				{
+					if (strategy == NULL)
+					{
+						if (buf->usage_count < BM_MAX_USAGE_COUNT)
+							buf->usage_count++;
+					}
+					else
+					{
+						if (buf->usage_count == 0)
+							buf->usage_count = 1;
+					}
+				}
+
+				/* Releases the header spinlock */
+				PinBuffer_Locked(buf);
+
+				*foundPtr = TRUE;
+				return buf;
+			}
+			UnlockBufHdr(buf);
+
+			/* Stale entry; fall through to the locked lookup */
+		}
+	}
+
 	/* see if the block is in the buffer pool already */
 	LWLockAcquire(newPartitionLock, LW_SHARED);
 	buf_id = BufTableLookup(&newTag, newHash);
@@ -606,6 +706,8 @@ BufferAlloc(SMgrRelation smgr, ForkNumber forkNum,
 		 */
 		buf = &BufferDescriptors[buf_id];
 
+		RecentBufferRemember(&newTag, newHash, buf_id);
+
 		valid = PinBuffer(buf, strategy);
 
 		/* Can release the mapping lock as soon as we've pinned it */
@@ -648,9 +750,9 @@ BufferAlloc(SMgrRelation smgr, ForkNumber forkNum,
 
 		/*
 		 * Select a victim buffer.	The buffer is returned with its header
-		 * spinlock still held!  Also (in most cases) the BufFreelistLock is
-		 * still held, since it would be bad to hold the spinlock while
-		 * possibly waking up other processes.
+		 * spinlock still held!  lock_held tells us whether the BufFreelistLock
+		 * is also still held; the current strategy never returns holding it,
+		 * but we keep the release here in case that changes.
 		 */
 		buf = StrategyGetBuffer(strategy, &lock_held);
 
@@ -815,6 +917,8 @@ BufferAlloc(SMgrRelation smgr, ForkNumber forkNum,
 
 			buf = &BufferDescriptors[buf_id];
 
+			RecentBufferRemember(&newTag, newHash, buf_id);
+
 			valid = PinBuffer(buf, strategy);
 
 			/* Can release the mapping lock as soon as we've pinned it */
@@ -892,6 +996,8 @@ BufferAlloc(SMgrRelation smgr, ForkNumber forkNum,
 
 	LWLockRelease(newPartitionLock);
 
+	RecentBufferRemember(&newTag, newHash, buf->buf_id);
+
 	/*
 	 * Buffer contents are currently invalid.  Try to get the io_in_progress
 	 * lock.  If StartBufferIO returns false, then someone else managed to
@@ -1248,13 +1354,16 @@ static void
 BufferSync(int flags)
 {
 	int			buf_id;
-	int			num_to_scan;
 	int			num_to_write;
 	int			num_written;
+	int			i;
+	CkptSortItem *items;
 
 	/* Make sure we can handle the pin inside SyncOneBuffer */
 	ResourceOwnerEnlargeBuffers(CurrentResourceOwner);
 
+	items = (CkptSortItem *) palloc(NBuffers * sizeof(CkptSortItem));
+
 	/*
 	 * Loop over all buffers, and mark the ones that need to be written with
 	 * BM_CHECKPOINT_NEEDED.  Count them as we go (num_to_write), so that we
@@ -1284,7 +1393,14 @@ BufferSync(int flags)
 
 		if (bufHdr->flags & BM_DIRTY)
 		{
+			CkptSortItem *item = &items[num_to_write];
+
 			bufHdr->flags |= BM_CHECKPOINT_NEEDED;
+			item->tsId = bufHdr->tag.rnode.spcNode;
+			item->relNode = bufHdr->tag.rnode.relNode;
+			item->forkNum = bufHdr->tag.forkNum;
+			item->blockNum = bufHdr->tag.blockNum;
+			item->buf_id = buf_id;
 			num_to_write++;
 		}
 
@@ -1292,24 +1408,38 @@ BufferSync(int flags)
 	}
 
 	if (num_to_write == 0)
+	{
+		pfree(items);
 		return;					/* nothing to do */
+	}
 
 	TRACE_POSTGRESQL_BUFFER_SYNC_START(NBuffers, num_to_write);
 
 	/*
-	 * Loop over all buffers again, and write the ones (still) marked with
-	 * BM_CHECKPOINT_NEEDED.  In this loop, we start at the clock sweep point
-	 * since we might as well dump soon-to-be-recycled buffers first.
+	 * Sort the buffers we need to write by (tablespace, relation, fork,
+	 * block), so the writes reach the kernel in file order and it can
+	 * merge them into large sequential I/Os, instead of the random storm
+	 * a buffer-id-order scan produces.
 	 *
-	 * Note that we don't read the buffer alloc count here --- that should be
-	 * left untouched till the next BgBufferSync() call.
+	 * The tags were copied under the header spinlock above, but a buffer
+	 * may be written and recycled for another page before we get to it;
+	 * that only means its BM_CHECKPOINT_NEEDED flag is clear by then and
+	 * we skip it below, same as in the unsorted scheme.
+	 */
+	qsort(items, num_to_write, sizeof(CkptSortItem),
+		  ckpt_buforder_comparator);
+
+	/*
+	 * Loop over the sorted items, and write the buffers (still) marked
+	 * with BM_CHECKPOINT_NEEDED.
 	 */
-	buf_id = StrategySyncStart(NULL, NULL);
-	num_to_scan = NBuffers;
 	num_written = 0;
-	while (num_to_scan-- > 0)
+	for (i = 0; i < num_to_write; i++)
 	{
-		volatile BufferDesc *bufHdr = &BufferDescriptors[buf_id];
+		volatile BufferDesc *bufHdr;
+
+		buf_id = items[i].buf_id;
+		bufHdr = &BufferDescriptors[buf_id];
 
 		/*
 		 * We don't need to acquire the lock here, because we're only looking
@@ -1331,33 +1461,22 @@ BufferSync(int flags)
 				BgWriterStats.m_buf_written_checkpoints++;
 				num_written++;
 
-				/*
-				 * We know there are at most num_to_write buffers with
-				 * BM_CHECKPOINT_NEEDED set; so we can stop scanning if
-				 * num_written reaches num_to_write.
-				 *
-				 * Note that num_written doesn't include buffers written by
-				 * other backends, or by the bgwriter cleaning scan. That
-				 * means that the estimate of how much progress we've made is
-				 * conservative, and also that this test will often fail to
-				 * trigger.  But it seems worth making anyway.
-				 */
-				if (num_written >= num_to_write)
-					break;
-
 				/*
 				 * Perform normal bgwriter duties and sleep to throttle our
 				 * I/O rate.
+				 *
+				 * Note that num_written doesn't include buffers written by
+				 * other backends, or by the bgwriter cleaning scan, so the
+				 * progress estimate is conservative.
 				 */
 				CheckpointWriteDelay(flags,
 									 (double) num_written / num_to_write);
 			}
 		}
-
-		if (++buf_id >= NBuffers)
-			buf_id = 0;
 	}
 
+	pfree(items);
+
 	/*
 	 * Update checkpoint statistics. As noted above, this doesn't include
 	 * buffers written by other backends or bgwriter scan.
@@ -1367,6 +1486,37 @@ BufferSync(int flags)
 	TRACE_POSTGRESQL_BUFFER_SYNC_DONE(NBuffers, num_written, num_to_write);
 }
 
+/*
+ * Comparator for CkptSortItem: order by tablespace, relation, fork, block.
+ */
+static int
+ckpt_buforder_comparator(const void *pa, const void *pb)
+{
+	const CkptSortItem *a = (const CkptSortItem *) pa;
+	const CkptSortItem *b = (const CkptSortItem *) pb;
+
+	/* compare tablespace */
+	if (a->tsId < b->tsId)
+		return -1;
+	else if (a->tsId > b->tsId)
+		return 1;
+	/* compare relation */
+	if (a->relNode < b->relNode)
+		return -1;
+	else if (a->relNode > b->relNode)
+		return 1;
+	/* compare fork */
+	else if (a->forkNum < b->forkNum)
+		return -1;
+	else if (a->forkNum > b->forkNum)
+		return 1;
+	/* compare block number */
+	else if (a->blockNum < b->blockNum)
+		return -1;
+	else	/* should not be the same block ... */
+		return 1;
+}
+
 /*
  * BgBufferSync -- Write out some dirty buffers in the pool.
  *
@@ -15,17 +15,18 @@
  */
 #include "postgres.h"
 
+#include "miscadmin.h"
 #include "storage/buf_internals.h"
 #include "storage/bufmgr.h"
-
+#include "storage/spin.h"
 
 /*
- * The shared freelist control information.
+ * One partition of the list of unused buffers.  NUM_FREELIST_PARTITIONS
+ * and the partition mapping macros live in buf_internals.h.
  */
-typedef struct
+typedef struct BufferFreelistPartition
 {
-	/* Clock sweep hand: index of next buffer to consider grabbing */
-	int			nextVictimBuffer;
+	slock_t		lock;			/* protects the fields below */
 
 	int			firstFreeBuffer;	/* Head of list of unused buffers */
 	int			lastFreeBuffer; /* Tail of list of unused buffers */
@@ -34,6 +35,18 @@ typedef struct
 	 * NOTE: lastFreeBuffer is undefined when firstFreeBuffer is -1 (that is,
 	 * when the list is empty)
 	 */
+} BufferFreelistPartition;
+
+/*
+ * The shared freelist control information.
+ */
+typedef struct
+{
+	/* Protects the clock sweep hand and the statistics counters. */
+	slock_t		victim_lock;
+
+	/* Clock sweep hand: index of next buffer to consider grabbing */
+	int			nextVictimBuffer;
 
 	/*
 	 * Statistics.	These counters should be wide enough that they can't
@@ -41,6 +54,14 @@ typedef struct
 	 */
 	uint32		completePasses; /* Complete cycles of the clock sweep */
 	uint32		numBufferAllocs;	/* Buffers allocated since last reset */
+
+	/*
+	 * The list of unused buffers, partitioned so that backends freeing
+	 * and grabbing buffers spread across NUM_FREELIST_PARTITIONS
+	 * spinlocks. A backend starts with the partition it hashes to and
+	 * steals from the others when its own runs dry.
+	 */
+	BufferFreelistPartition freelists[NUM_FREELIST_PARTITIONS];
 } BufferStrategyControl;
 
 /* Pointers to shared state */
@@ -96,80 +117,106 @@ static void AddBufferToRing(BufferAccessStrategy strategy,
  *	strategy is a BufferAccessStrategy object, or NULL for default strategy.
  *
  *	To ensure that no one else can pin the buffer before we do, we must
- *	return the buffer with the buffer header spinlock still held.  If
- *	*lock_held is set on exit, we have returned with the BufFreelistLock
- *	still held, as well; the caller must release that lock once the spinlock
- *	is dropped.  We do it that way because releasing the BufFreelistLock
- *	might awaken other processes, and it would be bad to do the associated
- *	kernel calls while holding the buffer header spinlock.
+ *	return the buffer with the buffer header spinlock still held.  *lock_held
+ *	is always set false on exit: the freelist and the clock sweep hand are
+ *	now protected by spinlocks held only momentarily, so we never return
+ *	holding the (historical) BufFreelistLock.  The out parameter is kept so
+ *	the caller's contract need not change.
  */
 volatile BufferDesc *
 StrategyGetBuffer(BufferAccessStrategy strategy, bool *lock_held)
 {
 	volatile BufferDesc *buf;
 	int			trycounter;
+	int			homePartition;
+	int			i;
+
+	*lock_held = false;
 
 	/*
 	 * If given a strategy object, see whether it can select a buffer. We
-	 * assume strategy objects don't need the BufFreelistLock.
+	 * assume strategy objects don't need the freelist.
 	 */
 	if (strategy != NULL)
 	{
 		buf = GetBufferFromRing(strategy);
 		if (buf != NULL)
-		{
-			*lock_held = false;
 			return buf;
-		}
 	}
 
-	/* Nope, so lock the freelist */
-	*lock_held = true;
-	LWLockAcquire(BufFreelistLock, LW_EXCLUSIVE);
-
 	/*
 	 * We count buffer allocation requests so that the bgwriter can estimate
 	 * the rate of buffer consumption.	Note that buffers recycled by a
 	 * strategy object are intentionally not counted here.
 	 */
+	SpinLockAcquire(&StrategyControl->victim_lock);
 	StrategyControl->numBufferAllocs++;
+	SpinLockRelease(&StrategyControl->victim_lock);
 
 	/*
-	 * Try to get a buffer from the freelist.  Note that the freeNext fields
-	 * are considered to be protected by the BufFreelistLock not the
-	 * individual buffer spinlocks, so it's OK to manipulate them without
-	 * holding the spinlock.
+	 * Try to get a buffer from the freelist.  Start with the partition this
+	 * backend hashes to and steal from the others when it is empty, so that
+	 * concurrent allocators usually contend on different spinlocks.
+	 *
+	 * The freeNext fields are considered to be protected by the owning
+	 * partition's spinlock, not the individual buffer header spinlocks, so
+	 * it's OK to manipulate them without holding the header spinlock.
 	 */
-	while (StrategyControl->firstFreeBuffer >= 0)
+	homePartition = BufFreelistHomePartition(MyProcPid);
+	for (i = 0; i < NUM_FREELIST_PARTITIONS; i++)
 	{
-		buf = &BufferDescriptors[StrategyControl->firstFreeBuffer];
-		Assert(buf->freeNext != FREENEXT_NOT_IN_LIST);
+		BufferFreelistPartition *freelist;
 
-		/* Unconditionally remove buffer from freelist */
-		StrategyControl->firstFreeBuffer = buf->freeNext;
-		buf->freeNext = FREENEXT_NOT_IN_LIST;
+		freelist = &StrategyControl->freelists[(homePartition + i) %
+											   NUM_FREELIST_PARTITIONS];
 
-		/*
-		 * If the buffer is pinned or has a nonzero usage_count, we cannot use
-		 * it; discard it and retry.  (This can only happen if VACUUM put a
-		 * valid buffer in the freelist and then someone else used it before
-		 * we got to it.  It's probably impossible altogether as of 8.3, but
-		 * we'd better check anyway.)
-		 */
-		LockBufHdr(buf);
-		if (buf->refcount == 0 && buf->usage_count == 0)
+		SpinLockAcquire(&freelist->lock);
+		while (freelist->firstFreeBuffer >= 0)
 		{
-			if (strategy != NULL)
-				AddBufferToRing(strategy, buf);
-			return buf;
+			buf = &BufferDescriptors[freelist->firstFreeBuffer];
+			Assert(buf->freeNext != FREENEXT_NOT_IN_LIST);
+
+			/* Unconditionally remove buffer from freelist */
+			freelist->firstFreeBuffer = buf->freeNext;
+			buf->freeNext = FREENEXT_NOT_IN_LIST;
+
+			/*
+			 * Drop the partition lock before touching the buffer header; we
+			 * must never hold two spinlocks at once.
+			 */
+			SpinLockRelease(&freelist->lock);
+
+			/*
+			 * If the buffer is pinned or has a nonzero usage_count, we cannot
+			 * use it; discard it and retry.  (This can only happen if VACUUM
+			 * put a valid buffer in the freelist and then someone else used
+			 * it before we got to it.	It's probably impossible altogether as
+			 * of 8.3, but we'd better check anyway.)
+			 */
+			LockBufHdr(buf);
+			if (buf->refcount == 0 && buf->usage_count == 0)
+			{
+				if (strategy != NULL)
+					AddBufferToRing(strategy, buf);
+				return buf;
+			}
+			UnlockBufHdr(buf);
+
+			SpinLockAcquire(&freelist->lock);
 		}
-		UnlockBufHdr(buf);
+		SpinLockRelease(&freelist->lock);
 	}
 
-	/* Nothing on the freelist, so run the "clock sweep" algorithm */
+	/*
+	 * Nothing on the freelist, so run the "clock sweep" algorithm.  Only the
+	 * advancement of the shared clock hand is done under the spinlock; the
+	 * buffer header inspection happens with no global lock held, so
+	 * concurrent backends can examine different victims in parallel.
+	 */
 	trycounter = NBuffers;
 	for (;;)
 	{
+		SpinLockAcquire(&StrategyControl->victim_lock);
 		buf = &BufferDescriptors[StrategyControl->nextVictimBuffer];
 
 		if (++StrategyControl->nextVictimBuffer >= NBuffers)
@@ -177,6 +224,7 @@ StrategyGetBuffer(BufferAccessStrategy strategy, bool *lock_held)
 			StrategyControl->nextVictimBuffer = 0;
 			StrategyControl->completePasses++;
 		}
+		SpinLockRelease(&StrategyControl->victim_lock);
 
 		/*
 		 * If the buffer is pinned or has a nonzero usage_count, we cannot use
@@ -229,7 +277,11 @@ StrategyGetBuffer(BufferAccessStrategy strategy, bool *lock_held)
 void
 StrategyFreeBuffer(volatile BufferDesc *buf)
 {
-	LWLockAcquire(BufFreelistLock, LW_EXCLUSIVE);
+	BufferFreelistPartition *freelist;
+
+	freelist = &StrategyControl->freelists[BufFreelistPartition(buf->buf_id)];
+
+	SpinLockAcquire(&freelist->lock);
 
 	/*
 	 * It is possible that we are told to put something in the freelist that
@@ -237,13 +289,13 @@ StrategyFreeBuffer(volatile BufferDesc *buf)
 	 */
 	if (buf->freeNext == FREENEXT_NOT_IN_LIST)
 	{
-		buf->freeNext = StrategyControl->firstFreeBuffer;
+		buf->freeNext = freelist->firstFreeBuffer;
 		if (buf->freeNext < 0)
-			StrategyControl->lastFreeBuffer = buf->buf_id;
-		StrategyControl->firstFreeBuffer = buf->buf_id;
+			freelist->lastFreeBuffer = buf->buf_id;
+		freelist->firstFreeBuffer = buf->buf_id;
 	}
 
-	LWLockRelease(BufFreelistLock);
+	SpinLockRelease(&freelist->lock);
 }
 
 /*
@@ -262,7 +314,7 @@ StrategySyncStart(uint32 *complete_passes, uint32 *num_buf_alloc)
 {
 	int			result;
 
-	LWLockAcquire(BufFreelistLock, LW_EXCLUSIVE);
+	SpinLockAcquire(&StrategyControl->victim_lock);
 	result = StrategyControl->nextVictimBuffer;
 	if (complete_passes)
 		*complete_passes = StrategyControl->completePasses;
@@ -271,7 +323,7 @@ StrategySyncStart(uint32 *complete_passes, uint32 *num_buf_alloc)
 		*num_buf_alloc = StrategyControl->numBufferAllocs;
 		StrategyControl->numBufferAllocs = 0;
 	}
-	LWLockRelease(BufFreelistLock);
+	SpinLockRelease(&StrategyControl->victim_lock);
 	return result;
 }
 
@@ -332,17 +384,14 @@ StrategyInitialize(bool init)
 
 	if (!found)
 	{
+		int			i;
+
 		/*
 		 * Only done once, usually in postmaster
 		 */
 		Assert(init);
 
-		/*
-		 * Grab the whole linked list of free buffers for our strategy. We
-		 * assume it was previously set up by InitBufferPool().
-		 */
-		StrategyControl->firstFreeBuffer = 0;
-		StrategyControl->lastFreeBuffer = NBuffers - 1;
+		SpinLockInit(&StrategyControl->victim_lock);
 
 		/* Initialize the clock sweep pointer */
 		StrategyControl->nextVictimBuffer = 0;
@@ -350,6 +399,32 @@ StrategyInitialize(bool init)
 		/* Clear statistics */
 		StrategyControl->completePasses = 0;
 		StrategyControl->numBufferAllocs = 0;
+
+		/*
+		 * Distribute the whole pool of free buffers across the freelist
+		 * partitions.	InitBufferPool() chained all buffers into a single
+		 * list; re-chain them here by partition.  We are still in the
+		 * postmaster, so no lock is needed.
+		 */
+		for (i = 0; i < NUM_FREELIST_PARTITIONS; i++)
+		{
+			BufferFreelistPartition *freelist = &StrategyControl->freelists[i];
+
+			SpinLockInit(&freelist->lock);
+			freelist->firstFreeBuffer = FREENEXT_END_OF_LIST;
+			freelist->lastFreeBuffer = FREENEXT_END_OF_LIST;
+		}
+		for (i = NBuffers - 1; i >= 0; i--)
+		{
+			BufferFreelistPartition *freelist;
+			volatile BufferDesc *buf = &BufferDescriptors[i];
+
+			freelist = &StrategyControl->freelists[BufFreelistPartition(i)];
+			buf->freeNext = freelist->firstFreeBuffer;
+			if (buf->freeNext < 0)
+				freelist->lastFreeBuffer = i;
+			freelist->firstFreeBuffer = i;
+		}
 	}
 	else
 		Assert(!init);
@@ -32,6 +32,8 @@ static const struct{
 {
     {{"none", "false", "no", "off", "0", 0}, bfz_nothing_init},
     {{"zlib", 0}, bfz_zlib_init},
+    {{"zstd", 0}, bfz_zstd_init},
+    {{"lz4", 0}, bfz_lz4_init},
     {{0}}
 };
 
@@ -59,11 +59,18 @@ struct BufFile
 	int			nbytes;			/* total # of valid bytes in buffer */
 	int64		maxoffset;		/* maximum offset that this file has reached, for disk usage */
 
+	int64		flush_mark;		/* end of spill data advised for writeback */
+	int64		discard_mark;	/* end of spill data advised for discard */
+
 	char	   *buffer;			/* CDB: -> buffer */
 };
 
+/* Granularity of the page cache discard advice for large spill streams */
+#define BUFFILE_DISCARD_WINDOW	(1024 * 1024)
+
 static BufFile *makeBufFile(File firstfile);
 static void BufFileUpdateSize(BufFile *buffile);
+static void BufFileDiscardBehind(BufFile *file);
 
 
 /*
@@ -88,6 +95,8 @@ makeBufFile(File firstfile)
 	file->pos = 0;
 	file->nbytes = 0;
 	file->maxoffset = 0L;
+	file->flush_mark = 0L;
+	file->discard_mark = 0L;
 	file->buffer = palloc(BLCKSZ);
 
 	return file;
@@ -294,6 +303,8 @@ BufFileDumpBuffer(BufFile *file, const void* buffer, Size nbytes)
 	}
 	file->dirty = false;
 
+	BufFileDiscardBehind(file);
+
 	/*
 	 * Now we can set the buffer empty without changing the logical position
 	 */
@@ -301,6 +312,40 @@ BufFileDumpBuffer(BufFile *file, const void* buffer, Size nbytes)
 	file->nbytes = 0;
 }
 
+/*
+ * BufFileDiscardBehind
+ *
+ * Once a spill file grows beyond gp_workfile_discard_threshold, advise the
+ * kernel to write back and drop the cached pages of the data we have
+ * finished writing, one window at a time, so that very large spill streams
+ * stop evicting the page cache that concurrent scans depend on.
+ *
+ * posix_fadvise(DONTNEED) only drops clean pages; for dirty pages it merely
+ * initiates writeback. Each window is therefore advised twice: once when it
+ * is first left behind, and once more a full window later, by which time
+ * its pages have normally reached disk and can actually be dropped.
+ */
+static void
+BufFileDiscardBehind(BufFile *file)
+{
+	if (gp_workfile_discard_threshold <= 0 ||
+		file->offset < (int64) gp_workfile_discard_threshold * 1024)
+		return;
+
+	if (file->offset - file->flush_mark < BUFFILE_DISCARD_WINDOW)
+		return;
+
+	FileDiscardData(file->file, (off_t) file->flush_mark,
+					(off_t) (file->offset - file->flush_mark));
+
+	if (file->flush_mark > file->discard_mark)
+		FileDiscardData(file->file, (off_t) file->discard_mark,
+						(off_t) (file->flush_mark - file->discard_mark));
+
+	file->discard_mark = file->flush_mark;
+	file->flush_mark = file->offset;
+}
+
 /*
  * BufFileRead
  *
@@ -599,6 +644,32 @@ BufFileGetSize(BufFile *buffile)
 	return buffile->maxoffset;
 }
 
+/*
+ * Returns the kernel file descriptor of the underlying physical file.
+ *
+ * See FileGetRawDesc for the caveats on its lifetime.
+ */
+int
+BufFileGetRawDesc(BufFile *buffile)
+{
+	Assert(NULL != buffile);
+
+	return FileGetRawDesc(buffile->file);
+}
+
+/*
+ * Advise the OS to initiate an asynchronous read of the given range of the
+ * underlying physical file.  The logical read/write position is unaffected.
+ * This is a hint only; on platforms without posix_fadvise it is a no-op.
+ */
+int
+BufFilePrefetch(BufFile *buffile, int64 offset, int amount)
+{
+	Assert(NULL != buffile);
+
+	return FilePrefetch(buffile->file, (off_t) offset, amount);
+}
+
 /*
  * Mark this file as being managed by the workfile manager
  */
@@ -0,0 +1,197 @@
+/* compress_lz4.c */
+#include "postgres.h"
+
+#ifdef HAVE_LIBLZ4
+#include <lz4.h>
+#endif
+
+#include "storage/bfz.h"
+
+/*
+ * This file implements bfz compression algorithm "lz4".
+ *
+ * Framing is the same per-block scheme as the zstd codec: every write_ex
+ * call becomes one block with a header carrying the compressed and
+ * uncompressed lengths, so reads line up one frame per read_ex call and
+ * bfz.c's checksum accounting is unaffected.  A block that does not
+ * shrink is stored raw (clen == rawlen).  LZ4 is fast enough that
+ * compressed spills are expected to beat uncompressed ones on disk
+ * bandwidth alone.
+ */
+
+#ifdef HAVE_LIBLZ4
+
+typedef struct bfz_block_header
+{
+	uint32		clen;			/* compressed length of the block */
+	uint32		rawlen;			/* uncompressed length; == clen if stored raw */
+} bfz_block_header;
+
+struct bfz_lz4_freeable_stuff
+{
+	struct bfz_freeable_stuff super;
+
+	char		cbuf[LZ4_COMPRESSBOUND(BFZ_BUFFER_SIZE)];
+};
+
+/*
+ * Write a byte range to the underlying file, looping until it is all out.
+ */
+static void
+bfz_block_write_all(bfz_t *thiz, const char *buffer, int size)
+{
+	int			written = 0;
+
+	while (written < size)
+	{
+		int			n = FileWrite(thiz->file, (char *) buffer + written, size - written);
+
+		if (n < 0)
+			ereport(ERROR,
+					(errcode_for_file_access(),
+					 errmsg("could not write to temporary file: %m")));
+		written += n;
+	}
+}
+
+/*
+ * Read exactly size bytes from the underlying file.  Returns false on a
+ * clean end-of-file at a block boundary (nothing read), errors out on a
+ * short or failed read.
+ */
+static bool
+bfz_block_read_all(bfz_t *thiz, char *buffer, int size)
+{
+	int			nread = 0;
+
+	while (nread < size)
+	{
+		int			n = FileRead(thiz->file, buffer + nread, size - nread);
+
+		if (n < 0)
+			ereport(ERROR,
+					(errcode_for_file_access(),
+					 errmsg("could not read from temporary file: %m")));
+		if (n == 0)
+		{
+			if (nread == 0)
+				return false;
+			ereport(ERROR,
+					(errcode_for_file_access(),
+					 errmsg("unexpected end of temporary file")));
+		}
+		nread += n;
+	}
+
+	return true;
+}
+
+static void
+bfz_lz4_close_ex(bfz_t *thiz)
+{
+	struct bfz_lz4_freeable_stuff *fs = (void *) thiz->freeable_stuff;
+
+	if (NULL != fs)
+	{
+		pfree(fs);
+		thiz->freeable_stuff = NULL;
+	}
+}
+
+static void
+bfz_lz4_write_ex(bfz_t *thiz, const char *buffer, int size)
+{
+	struct bfz_lz4_freeable_stuff *fs = (void *) thiz->freeable_stuff;
+	bfz_block_header hdr;
+	int			clen;
+
+	clen = LZ4_compress_default(buffer, fs->cbuf, size, sizeof(fs->cbuf));
+	if (clen <= 0)
+		ereport(ERROR,
+				(errmsg("lz4 compression failed")));
+
+	hdr.rawlen = size;
+	if (clen >= size)
+	{
+		/* incompressible; store the block raw */
+		hdr.clen = size;
+		bfz_block_write_all(thiz, (char *) &hdr, sizeof(hdr));
+		bfz_block_write_all(thiz, buffer, size);
+	}
+	else
+	{
+		hdr.clen = clen;
+		bfz_block_write_all(thiz, (char *) &hdr, sizeof(hdr));
+		bfz_block_write_all(thiz, fs->cbuf, clen);
+	}
+}
+
+static int
+bfz_lz4_read_ex(bfz_t *thiz, char *buffer, int size)
+{
+	struct bfz_lz4_freeable_stuff *fs = (void *) thiz->freeable_stuff;
+	bfz_block_header hdr;
+	int			rawlen;
+
+	if (!bfz_block_read_all(thiz, (char *) &hdr, sizeof(hdr)))
+		return 0;
+
+	if (hdr.rawlen > (uint32) size || hdr.clen > sizeof(fs->cbuf))
+		ereport(ERROR,
+				(errcode(ERRCODE_IO_ERROR),
+				 errmsg("corrupted block header in temporary file")));
+
+	if (hdr.clen == hdr.rawlen)
+	{
+		/* block was stored raw */
+		if (!bfz_block_read_all(thiz, buffer, hdr.rawlen))
+			ereport(ERROR,
+					(errcode_for_file_access(),
+					 errmsg("unexpected end of temporary file")));
+		return hdr.rawlen;
+	}
+
+	if (!bfz_block_read_all(thiz, fs->cbuf, hdr.clen))
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("unexpected end of temporary file")));
+
+	rawlen = LZ4_decompress_safe(fs->cbuf, buffer, hdr.clen, size);
+	if (rawlen < 0 || (uint32) rawlen != hdr.rawlen)
+		ereport(ERROR,
+				(errcode(ERRCODE_IO_ERROR),
+				 errmsg("could not uncompress data from temporary file")));
+
+	return rawlen;
+}
+
+/*
+ * bfz_lz4_init
+ *	Initialize the lz4 subsystem for a file.
+ *
+ *	The underlying file descriptor fd should already be opened
+ *	and valid. Memory is allocated in the current memory context.
+ */
+void
+bfz_lz4_init(bfz_t *thiz)
+{
+	struct bfz_lz4_freeable_stuff *fs = palloc(sizeof *fs);
+
+	thiz->freeable_stuff = &fs->super;
+	fs->super.read_ex = bfz_lz4_read_ex;
+	fs->super.write_ex = bfz_lz4_write_ex;
+	fs->super.close_ex = bfz_lz4_close_ex;
+}
+
+#else							/* !HAVE_LIBLZ4 */
+
+void
+bfz_lz4_init(bfz_t *thiz)
+{
+	ereport(ERROR,
+			(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			 errmsg("lz4 workfile compression is not supported by this build"),
+			 errhint("Rebuild with --with-lz4.")));
+}
+
+#endif							/* HAVE_LIBLZ4 */
@@ -0,0 +1,229 @@
+/* compress_zstd.c */
+#include "postgres.h"
+
+#ifdef HAVE_LIBZSTD
+#include <zstd.h>
+#endif
+
+#include "storage/bfz.h"
+
+/*
+ * This file implements bfz compression algorithm "zstd".
+ *
+ * Unlike the zlib codec, which runs one deflate stream over the whole
+ * file, each write_ex call is compressed into its own framed block:
+ * a header carrying the compressed and uncompressed lengths, followed
+ * by the compressed bytes.  bfz always writes full BFZ_BUFFER_SIZE
+ * buffers (except the last), so reads line up one frame per read_ex
+ * call and the block-level checksum accounting in bfz.c is unaffected.
+ * A block that does not shrink is stored raw (clen == rawlen).
+ */
+
+#ifdef HAVE_LIBZSTD
+
+/* Compression level; zstd's own default trades well for spill files */
+#define BFZ_ZSTD_LEVEL			1
+
+typedef struct bfz_block_header
+{
+	uint32		clen;			/* compressed length of the block */
+	uint32		rawlen;			/* uncompressed length; == clen if stored raw */
+} bfz_block_header;
+
+struct bfz_zstd_freeable_stuff
+{
+	struct bfz_freeable_stuff super;
+
+	ZSTD_CCtx  *cctx;			/* non-NULL when compressing */
+	ZSTD_DCtx  *dctx;			/* non-NULL when decompressing */
+
+	char		cbuf[ZSTD_COMPRESSBOUND(BFZ_BUFFER_SIZE)];
+};
+
+/*
+ * Write a byte range to the underlying file, looping until it is all out.
+ */
+static void
+bfz_block_write_all(bfz_t *thiz, const char *buffer, int size)
+{
+	int			written = 0;
+
+	while (written < size)
+	{
+		int			n = FileWrite(thiz->file, (char *) buffer + written, size - written);
+
+		if (n < 0)
+			ereport(ERROR,
+					(errcode_for_file_access(),
+					 errmsg("could not write to temporary file: %m")));
+		written += n;
+	}
+}
+
+/*
+ * Read exactly size bytes from the underlying file.  Returns false on a
+ * clean end-of-file at a block boundary (nothing read), errors out on a
+ * short or failed read.
+ */
+static bool
+bfz_block_read_all(bfz_t *thiz, char *buffer, int size)
+{
+	int			nread = 0;
+
+	while (nread < size)
+	{
+		int			n = FileRead(thiz->file, buffer + nread, size - nread);
+
+		if (n < 0)
+			ereport(ERROR,
+					(errcode_for_file_access(),
+					 errmsg("could not read from temporary file: %m")));
+		if (n == 0)
+		{
+			if (nread == 0)
+				return false;
+			ereport(ERROR,
+					(errcode_for_file_access(),
+					 errmsg("unexpected end of temporary file")));
+		}
+		nread += n;
+	}
+
+	return true;
+}
+
+static void
+bfz_zstd_close_ex(bfz_t *thiz)
+{
+	struct bfz_zstd_freeable_stuff *fs = (void *) thiz->freeable_stuff;
+
+	if (NULL != fs)
+	{
+		if (fs->cctx)
+			ZSTD_freeCCtx(fs->cctx);
+		if (fs->dctx)
+			ZSTD_freeDCtx(fs->dctx);
+
+		pfree(fs);
+		thiz->freeable_stuff = NULL;
+	}
+}
+
+static void
+bfz_zstd_write_ex(bfz_t *thiz, const char *buffer, int size)
+{
+	struct bfz_zstd_freeable_stuff *fs = (void *) thiz->freeable_stuff;
+	bfz_block_header hdr;
+	size_t		clen;
+
+	clen = ZSTD_compressCCtx(fs->cctx, fs->cbuf, sizeof(fs->cbuf),
+							 buffer, size, BFZ_ZSTD_LEVEL);
+	if (ZSTD_isError(clen))
+		ereport(ERROR,
+				(errmsg("zstd compression failed"),
+				 errdetail("%s", ZSTD_getErrorName(clen))));
+
+	hdr.rawlen = size;
+	if (clen >= (size_t) size)
+	{
+		/* incompressible; store the block raw */
+		hdr.clen = size;
+		bfz_block_write_all(thiz, (char *) &hdr, sizeof(hdr));
+		bfz_block_write_all(thiz, buffer, size);
+	}
+	else
+	{
+		hdr.clen = clen;
+		bfz_block_write_all(thiz, (char *) &hdr, sizeof(hdr));
+		bfz_block_write_all(thiz, fs->cbuf, clen);
+	}
+}
+
+static int
+bfz_zstd_read_ex(bfz_t *thiz, char *buffer, int size)
+{
+	struct bfz_zstd_freeable_stuff *fs = (void *) thiz->freeable_stuff;
+	bfz_block_header hdr;
+	size_t		rawlen;
+
+	if (!bfz_block_read_all(thiz, (char *) &hdr, sizeof(hdr)))
+		return 0;
+
+	if (hdr.rawlen > (uint32) size || hdr.clen > sizeof(fs->cbuf))
+		ereport(ERROR,
+				(errcode(ERRCODE_IO_ERROR),
+				 errmsg("corrupted block header in temporary file")));
+
+	if (hdr.clen == hdr.rawlen)
+	{
+		/* block was stored raw */
+		if (!bfz_block_read_all(thiz, buffer, hdr.rawlen))
+			ereport(ERROR,
+					(errcode_for_file_access(),
+					 errmsg("unexpected end of temporary file")));
+		return hdr.rawlen;
+	}
+
+	if (!bfz_block_read_all(thiz, fs->cbuf, hdr.clen))
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("unexpected end of temporary file")));
+
+	rawlen = ZSTD_decompressDCtx(fs->dctx, buffer, size, fs->cbuf, hdr.clen);
+	if (ZSTD_isError(rawlen))
+		ereport(ERROR,
+				(errmsg("could not uncompress data from temporary file"),
+				 errdetail("%s", ZSTD_getErrorName(rawlen))));
+	if (rawlen != hdr.rawlen)
+		ereport(ERROR,
+				(errcode(ERRCODE_IO_ERROR),
+				 errmsg("corrupted block in temporary file")));
+
+	return rawlen;
+}
+
+/*
+ * bfz_zstd_init
+ *	Initialize the zstd subsystem for a file.
+ *
+ *	The underlying file descriptor fd should already be opened
+ *	and valid. Memory is allocated in the current memory context.
+ */
+void
+bfz_zstd_init(bfz_t *thiz)
+{
+	struct bfz_zstd_freeable_stuff *fs = palloc0(sizeof *fs);
+
+	if (thiz->mode == BFZ_MODE_APPEND)
+	{
+		fs->cctx = ZSTD_createCCtx();
+		if (fs->cctx == NULL)
+			ereport(ERROR,
+					(errmsg("could not create zstd compression context")));
+	}
+	else
+	{
+		fs->dctx = ZSTD_createDCtx();
+		if (fs->dctx == NULL)
+			ereport(ERROR,
+					(errmsg("could not create zstd decompression context")));
+	}
+
+	thiz->freeable_stuff = &fs->super;
+	fs->super.read_ex = bfz_zstd_read_ex;
+	fs->super.write_ex = bfz_zstd_write_ex;
+	fs->super.close_ex = bfz_zstd_close_ex;
+}
+
+#else							/* !HAVE_LIBZSTD */
+
+void
+bfz_zstd_init(bfz_t *thiz)
+{
+	ereport(ERROR,
+			(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			 errmsg("zstd workfile compression is not supported by this build"),
+			 errhint("Rebuild with --with-zstd.")));
+}
+
+#endif							/* HAVE_LIBZSTD */
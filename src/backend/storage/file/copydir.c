@@ -22,6 +22,12 @@
 #include <unistd.h>
 #include <sys/stat.h>
 
+#if defined(__linux__)
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/fs.h>
+#endif
+
 #include "storage/fd.h"
 #include "miscadmin.h"
 
@@ -144,17 +150,16 @@ copydir(char *fromdir, char *todir, bool recurse)
 static void
 copy_file(char *fromfile, char *tofile)
 {
-	char	   *buffer;
+	char	   *buffer = NULL;
 	int			srcfd;
 	int			dstfd;
 	int			nbytes;
 	off_t		offset;
+	bool		done = false;
 
 	/* Use palloc to ensure we get a maxaligned buffer */
 #define COPY_BUF_SIZE (8 * BLCKSZ)
 
-	buffer = palloc(COPY_BUF_SIZE);
-
 	/*
 	 * Open the files
 	 */
@@ -171,14 +176,57 @@ copy_file(char *fromfile, char *tofile)
 				(errcode_for_file_access(),
 				 errmsg("could not create file \"%s\": %m", tofile)));
 
+#if defined(__linux__) && defined(FICLONE)
+
+	/*
+	 * On filesystems that support reflinks (XFS with reflink enabled,
+	 * btrfs), clone the file instead of copying it: the new file shares the
+	 * source's extents and the "copy" costs metadata only, which makes
+	 * CREATE DATABASE from a big template near-instant.  Where cloning is
+	 * not supported the ioctl fails cheaply and we fall through to the
+	 * ordinary copy loop.  The fsync pass in copydir() still covers cloned
+	 * files.
+	 */
+	if (ioctl(dstfd, FICLONE, srcfd) == 0)
+		done = true;
+#endif
+
 	/*
 	 * Do the data copying.
 	 */
-	for (offset = 0;; offset += nbytes)
+	for (offset = 0; !done; offset += nbytes)
 	{
 		/* If we got a cancel signal during the copy of the file, quit */
 		CHECK_FOR_INTERRUPTS();
 
+#if defined(__linux__) && defined(__NR_copy_file_range)
+
+		/*
+		 * Let the kernel move the data without bouncing it through user
+		 * space, where it can.  The syscall advances both file offsets, so
+		 * falling back to read/write mid-file continues at the right spot.
+		 * Called directly since the C library of our oldest supported
+		 * platforms does not wrap it; an ENOSYS kernel just sends us to the
+		 * fallback below.
+		 */
+		if (buffer == NULL)
+		{
+			nbytes = syscall(__NR_copy_file_range, srcfd, NULL, dstfd, NULL,
+							 (size_t) COPY_BUF_SIZE, 0);
+			if (nbytes > 0)
+			{
+				pg_flush_data(dstfd, offset, nbytes);
+				continue;
+			}
+			if (nbytes == 0)
+				break;
+			/* Not supported here; switch to the read/write loop. */
+		}
+#endif
+
+		if (buffer == NULL)
+			buffer = palloc(COPY_BUF_SIZE);
+
 		nbytes = read(srcfd, buffer, COPY_BUF_SIZE);
 		if (nbytes < 0)
 			ereport(ERROR,
@@ -212,7 +260,8 @@ copy_file(char *fromfile, char *tofile)
 
 	close(srcfd);
 
-	pfree(buffer);
+	if (buffer != NULL)
+		pfree(buffer);
 }
 
 
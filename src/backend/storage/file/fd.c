@@ -73,8 +73,10 @@
 #include "access/xact.h"
 #include "catalog/catalog.h"
 #include "catalog/pg_tablespace.h"
+#include "funcapi.h"
 #include "storage/fd.h"
 #include "storage/ipc.h"
+#include "utils/builtins.h"
 #include "utils/guc.h"
 #include "utils/resowner.h"
 #include "utils/workfile_mgr.h"
@@ -130,6 +132,18 @@ int			max_files_per_process = 1000;
  */
 static int	max_safe_fds = 32;	/* default if not changed */
 
+/*
+ * Per-backend VFD cache counters, exposed through the gp_vfd_stats view.
+ * A wide partition scan that keeps more files active than max_safe_fds
+ * shows up here as evictions and a depressed hit rate: every eviction is
+ * an extra close and a later reopen on the thrashing path.
+ */
+static uint64 vfdNOpens = 0;	/* kernel open()s, including LRU reopens */
+static uint64 vfdNCloses = 0;	/* kernel close()s, including evictions */
+static uint64 vfdNEvictions = 0;	/* closes forced by descriptor pressure */
+static uint64 vfdNAccesses = 0; /* FileAccess() calls */
+static uint64 vfdNHits = 0;		/* ... that found the file already open */
+
 
 /* Debugging.... */
 
@@ -511,6 +525,31 @@ set_max_safe_fds(void)
 	int			usable_fds;
 	int			already_open;
 
+#if defined(HAVE_GETRLIMIT) && defined(RLIMIT_NOFILE)
+	struct rlimit rlim;
+
+	/*
+	 * If the soft descriptor limit is below what max_files_per_process asks
+	 * for but the hard limit has room, raise the soft limit first; otherwise
+	 * the probe below silently settles for whatever the soft limit allows.
+	 * Children inherit the raised limit from the postmaster.
+	 */
+	if (getrlimit(RLIMIT_NOFILE, &rlim) == 0 &&
+		rlim.rlim_cur != RLIM_INFINITY &&
+		rlim.rlim_cur < (rlim_t) (max_files_per_process + NUM_RESERVED_FDS) &&
+		(rlim.rlim_max == RLIM_INFINITY || rlim.rlim_max > rlim.rlim_cur))
+	{
+		rlim_t		newlimit = (rlim_t) (max_files_per_process + NUM_RESERVED_FDS);
+
+		if (rlim.rlim_max != RLIM_INFINITY && newlimit > rlim.rlim_max)
+			newlimit = rlim.rlim_max;
+		rlim.rlim_cur = newlimit;
+		if (setrlimit(RLIMIT_NOFILE, &rlim) == 0)
+			elog(DEBUG2, "raised open file soft limit to %ld",
+				 (long) rlim.rlim_cur);
+	}
+#endif
+
 	/*----------
 	 * We want to set max_safe_fds to
 	 *			MIN(usable_fds, max_files_per_process - already_open)
@@ -651,6 +690,7 @@ LruDelete(File file)
 		elog(ERROR, "could not close file \"%s\": %m", vfdP->fileName);
 
 	--nfile;
+	vfdNCloses++;
 	vfdP->fd = VFD_CLOSED;
 }
 
@@ -712,6 +752,7 @@ LruInsert(File file)
 		{
 			DO_DB(elog(LOG, "RE_OPEN SUCCESS"));
 			++nfile;
+			vfdNOpens++;
 		}
 
 		/* seek to the right position */
@@ -746,6 +787,7 @@ ReleaseLruFile(void)
 		 */
 		Assert(VfdCache[0].lruMoreRecently != 0);
 		LruDelete(VfdCache[0].lruMoreRecently);
+		vfdNEvictions++;
 		return true;			/* freed a file */
 	}
 	return false;				/* no files available to free */
@@ -841,6 +883,7 @@ FileAccess(File file)
 	 * Is the file open?  If not, open it and put it at the head of the LRU
 	 * ring (possibly closing the least recently used file to get an FD).
 	 */
+	vfdNAccesses++;
 
 	if (FileIsNotOpen(file))
 	{
@@ -848,15 +891,20 @@ FileAccess(File file)
 		if (returnValue != 0)
 			return returnValue;
 	}
-	else if (VfdCache[0].lruLessRecently != file)
+	else
 	{
-		/*
-		 * We now know that the file is open and that it is not the last one
-		 * accessed, so we need to move it to the head of the Lru ring.
-		 */
+		vfdNHits++;
 
-		Delete(file);
-		Insert(file);
+		if (VfdCache[0].lruLessRecently != file)
+		{
+			/*
+			 * We now know that the file is open and that it is not the last
+			 * one accessed, so we need to move it to the head of the Lru
+			 * ring.
+			 */
+			Delete(file);
+			Insert(file);
+		}
 	}
 
 	return 0;
@@ -919,6 +967,7 @@ PathNameOpenFile(FileName fileName, int fileFlags, int fileMode)
 		return -1;
 	}
 	++nfile;
+	vfdNOpens++;
 	DO_DB(elog(LOG, "PathNameOpenFile: success %d",
 			   vfdP->fd));
 
@@ -1256,6 +1305,7 @@ FileClose(File file)
 			elog(ERROR, "could not close file \"%s\": %m", vfdP->fileName);
 
 		--nfile;
+		vfdNCloses++;
 		vfdP->fd = VFD_CLOSED;
 	}
 
@@ -1356,6 +1406,82 @@ FilePrefetch(File file, off_t offset, int amount)
 #endif
 }
 
+/*
+ * FileDiscardData - advise the OS that a range of the file won't be needed.
+ * The logical seek position is unaffected.
+ *
+ * For dirty pages this merely initiates writeback; only clean pages are
+ * dropped from the page cache. Callers that want a range actually dropped
+ * should advise it again once it has had time to reach disk.
+ */
+int
+FileDiscardData(File file, off_t offset, off_t amount)
+{
+#if defined(USE_POSIX_FADVISE) && defined(POSIX_FADV_DONTNEED)
+	int			returnCode;
+
+	Assert(FileIsValid(file));
+
+	DO_DB(elog(LOG, "FileDiscardData: %d (%s) " INT64_FORMAT " " INT64_FORMAT,
+			   file, VfdCache[file].fileName,
+			   (int64) offset, (int64) amount));
+
+	returnCode = FileAccess(file);
+	if (returnCode < 0)
+		return returnCode;
+
+	returnCode = pg_flush_data(VfdCache[file].fd, offset, amount);
+
+	return returnCode;
+#else
+	Assert(FileIsValid(file));
+	return 0;
+#endif
+}
+
+/*
+ * FileAllocate - preallocate disk space for a range of the file.
+ *
+ * Uses posix_fallocate(), which lets the filesystem reserve the whole
+ * range in large contiguous extents rather than allocating piecemeal as
+ * each write lands.  Note that the file size grows to cover the range, so
+ * callers that track a logical EOF below the allocated length should
+ * truncate the excess away when done appending.  The logical seek position
+ * is unaffected.
+ *
+ * Returns 0 on success; on failure returns -1 with errno set.
+ */
+int
+FileAllocate(File file, off_t offset, off_t amount)
+{
+#ifdef USE_POSIX_FALLOCATE
+	int			returnCode;
+
+	Assert(FileIsValid(file));
+
+	DO_DB(elog(LOG, "FileAllocate: %d (%s) " INT64_FORMAT " " INT64_FORMAT,
+			   file, VfdCache[file].fileName,
+			   (int64) offset, (int64) amount));
+
+	returnCode = FileAccess(file);
+	if (returnCode < 0)
+		return returnCode;
+
+	/* Unlike most syscalls, posix_fallocate returns the error directly */
+	returnCode = posix_fallocate(VfdCache[file].fd, offset, amount);
+	if (returnCode != 0)
+	{
+		errno = returnCode;
+		return -1;
+	}
+
+	return 0;
+#else
+	Assert(FileIsValid(file));
+	return 0;
+#endif
+}
+
 int
 FileRead(File file, char *buffer, int amount)
 {
@@ -1659,6 +1785,28 @@ FileTruncate(File file, int64 offset)
 	return returnCode;
 }
 
+/*
+ * Return the kernel file descriptor backing a virtual File, forcing the
+ * file open if necessary.
+ *
+ * The descriptor is owned by fd.c and may be closed whenever the LRU pool
+ * needs the slot, so the caller must consume it immediately (e.g. to hand
+ * it to mmap, which keeps its own reference) and must not close it.
+ */
+int
+FileGetRawDesc(File file)
+{
+	Assert(FileIsValid(file));
+
+	DO_DB(elog(LOG, "FileGetRawDesc %d (%s)",
+			   file, VfdCache[file].fileName));
+
+	if (FileAccess(file) < 0)
+		return -1;
+
+	return VfdCache[file].fd;
+}
+
 /*
  * Return the pathname associated with an open file.
  *
@@ -2325,3 +2473,34 @@ RemovePgTempFilesInDir(const char *tmpdirname)
 
 	FreeDir(temp_dir);
 }
+
+/*
+ * gp_vfd_stats - SQL-callable VFD cache statistics.
+ *
+ * Underlies the gp_vfd_stats view.  The counters are per-backend, so the
+ * view reports the activity of the backend that evaluates it.
+ */
+Datum
+gp_vfd_stats(PG_FUNCTION_ARGS)
+{
+	TupleDesc	tupdesc;
+	Datum		values[7];
+	bool		nulls[7];
+	HeapTuple	tuple;
+
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	MemSet(nulls, false, sizeof(nulls));
+	values[0] = Int64GetDatum((int64) vfdNOpens);
+	values[1] = Int64GetDatum((int64) vfdNCloses);
+	values[2] = Int64GetDatum((int64) vfdNEvictions);
+	values[3] = Int64GetDatum((int64) vfdNAccesses);
+	values[4] = Int64GetDatum((int64) vfdNHits);
+	values[5] = Int32GetDatum(nfile);
+	values[6] = Int32GetDatum(max_safe_fds);
+
+	tuple = heap_form_tuple(tupdesc, values, nulls);
+
+	PG_RETURN_DATUM(HeapTupleGetDatum(tuple));
+}
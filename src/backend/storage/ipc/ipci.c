@@ -43,6 +43,7 @@
 #include "storage/procsignal.h"
 #include "storage/sinvaladt.h"
 #include "storage/spin.h"
+#include "storage/waitevent.h"
 #include "utils/backend_cancel.h"
 #include "utils/resource_manager.h"
 #include "utils/faultinjector.h"
@@ -50,13 +51,20 @@
 
 #include "libpq-fe.h"
 #include "libpq-int.h"
+#include "cdb/cdbdispatchstats.h"
+#include "cdb/cdbrelsize.h"
+#include "cdb/cdbresusage.h"
 #include "cdb/cdbfts.h"
 #include "cdb/cdbtm.h"
+#include "cdb/ml_ipc.h"
 #include "utils/tqual.h"
 #include "postmaster/backoff.h"
 #include "cdb/memquota.h"
 #include "executor/instrument.h"
+#include "gpmon/gpmon.h"
+#include "executor/nodeShareInputScan.h"
 #include "executor/spi.h"
+#include "utils/memsnapshot.h"
 #include "utils/workfile_mgr.h"
 #include "utils/session_state.h"
 
@@ -129,7 +137,11 @@ CreateSharedMemoryAndSemaphores(bool makePrivate, int port)
 		size = add_size(size, LockShmemSize());
 		size = add_size(size, workfile_mgr_shmem_size());
 		if (Gp_role == GP_ROLE_DISPATCH)
+		{
 			size = add_size(size, AppendOnlyWriterShmemSize());
+			size = add_size(size, DispatchStatsShmemSize());
+			size = add_size(size, CdbRelSizeCacheShmemSize());
+		}
 
 		if (IsResQueueEnabled() && Gp_role == GP_ROLE_DISPATCH)
 		{
@@ -166,8 +178,11 @@ CreateSharedMemoryAndSemaphores(bool makePrivate, int port)
 		size = add_size(size, FtsShmemSize());
 		size = add_size(size, tmShmemSize());
 		size = add_size(size, SeqServerShmemSize());
+		size = add_size(size, ICStatsShmemSize());
 		size = add_size(size, CheckpointerShmemSize());
 		size = add_size(size, CancelBackendMsgShmemSize());
+		size = add_size(size, ShareInputShmemSize());
+		size = add_size(size, MemSnapshotShmemSize());
 
 #ifdef FAULT_INJECTOR
 		size = add_size(size, FaultInjector_ShmemSize());
@@ -190,6 +205,15 @@ CreateSharedMemoryAndSemaphores(bool makePrivate, int port)
 		/* size of Instrumentation slots */
 		size = add_size(size, InstrShmemSize());
 
+		/* size of the gpmon telemetry ring */
+		size = add_size(size, GpmonShmemSize());
+
+		/* size of the wait-event counters */
+		size = add_size(size, WaitEventShmemSize());
+
+		/* size of the per-query resource usage ring */
+		size = add_size(size, ResUsageShmemSize());
+
 		/*
 		 * Create the shmem segment
 		 */
@@ -261,7 +285,11 @@ CreateSharedMemoryAndSemaphores(bool makePrivate, int port)
 	 * Set up append only writer
 	 */
 	if (Gp_role == GP_ROLE_DISPATCH)
+	{
 		InitAppendOnlyWriter();
+		DispatchStatsShmemInit();
+		CdbRelSizeCacheShmemInit();
+	}
 
 	/*
 	 * Set up resource manager 
@@ -307,6 +335,9 @@ CreateSharedMemoryAndSemaphores(bool makePrivate, int port)
 	WalRcvShmemInit();
 	AutoVacuumShmemInit();
 	SeqServerShmemInit();
+	ICStatsShmemInit();
+	ShareInputShmemInit();
+	MemSnapshotShmemInit();
 
 #ifdef FAULT_INJECTOR
 	FaultInjector_ShmemInit();
@@ -327,6 +358,24 @@ CreateSharedMemoryAndSemaphores(bool makePrivate, int port)
 	if (!IsUnderPostmaster)
 		InstrShmemInit();
 
+	/*
+	 * Set up the gpmon telemetry ring
+	 */
+	if (!IsUnderPostmaster)
+		GpmonShmemInit();
+
+	/*
+	 * Set up the wait-event counters
+	 */
+	if (!IsUnderPostmaster)
+		WaitEventShmemInit();
+
+	/*
+	 * Set up the per-query resource usage ring
+	 */
+	if (!IsUnderPostmaster)
+		ResUsageShmemInit();
+
 #ifdef EXEC_BACKEND
 
 	/*
@@ -94,6 +94,18 @@ typedef struct ProcArrayStruct
 	 */
 	TransactionId lastOverflowedXid;
 
+	/*
+	 * Counter of events that can change the contents of an MVCC snapshot:
+	 * bumped whenever an xid leaves the set of running transactions
+	 * (commit or abort, including the deferred distributed-commit clearing
+	 * and removal of a prepared transaction's dummy PGPROC).  Incremented
+	 * and read only while holding ProcArrayLock, so no atomics are needed.
+	 * GetSnapshotData() uses it to skip rescanning the proc array when
+	 * nothing has completed since the snapshot it is asked to fill was last
+	 * filled; see comments there.
+	 */
+	uint64		stateChangeCount;
+
 	/*
 	 * We declare procs[] as 1 entry because C wants a fixed-size array, but
 	 * actually it is maxProcs entries long.
@@ -241,6 +253,8 @@ CreateSharedProcArray(void)
 		procArray->headKnownAssignedXids = 0;
 		SpinLockInit(&procArray->known_assigned_xids_lck);
 		procArray->lastOverflowedXid = InvalidTransactionId;
+		/* start at 1 so that a zeroed SnapshotData can never match */
+		procArray->stateChangeCount = 1;
 	}
 
 	/* Create or attach to the KnownAssignedXids arrays too, if needed */
@@ -321,6 +335,9 @@ ProcArrayRemove(PGPROC *proc, TransactionId latestXid)
 		if (TransactionIdPrecedes(ShmemVariableCache->latestCompletedXid,
 								  latestXid))
 			ShmemVariableCache->latestCompletedXid = latestXid;
+
+		/* The xid is no longer running; invalidate cached snapshots. */
+		arrayP->stateChangeCount++;
 	}
 	else
 	{
@@ -460,6 +477,13 @@ ProcArrayEndTransaction(PGPROC *proc, TransactionId latestXid, bool isCommit)
 								  latestXid))
 			ShmemVariableCache->latestCompletedXid = latestXid;
 
+		/*
+		 * Snapshot contents change both when the xid entry is cleared and
+		 * when latestCompletedXid advances, so bump the change counter even
+		 * if we deferred clearing the entry.
+		 */
+		procArray->stateChangeCount++;
+
 		LWLockRelease(ProcArrayLock);
 	}
 	else
@@ -546,6 +570,14 @@ ClearTransactionFromPgProc_UnderLock(PGPROC *proc, bool commit)
 	 * directly.
 	 */
 	ProcArrayClearTransaction(proc, commit);
+
+	/*
+	 * For the deferred distributed-commit case this is the moment the xid
+	 * stops being seen as running, so cached snapshots must be invalidated.
+	 * (For the prepare case this is redundant but harmless: the xid remains
+	 * running via the gxact's dummy PGPROC.)
+	 */
+	procArray->stateChangeCount++;
 }
 
 /*
@@ -1931,6 +1963,8 @@ GetSnapshotData(Snapshot snapshot)
 	int			count = 0;
 	int			subcount = 0;
 	bool		suboverflowed = false;
+	uint64		stateCount = 0;
+	TransactionId scanGlobalXmin;
 
 	Assert(snapshot != NULL);
 
@@ -2037,6 +2071,13 @@ GetSnapshotData(Snapshot snapshot)
 		 */
 		FillInDistributedSnapshot(snapshot);
 
+		/*
+		 * The reader paths below overwrite the local fields from the shared
+		 * snapshot slot, so whatever this struct cached from a proc array
+		 * scan is gone.
+		 */
+		snapshot->procArrayStateCount = 0;
+
 		/*
 		 * If we're a cursor-reader, we get out snapshot from the
 		 * writer via a tempfile in the filesystem. Otherwise it is
@@ -2289,8 +2330,37 @@ GetSnapshotData(Snapshot snapshot)
 	 */
 	snapshot->takenDuringRecovery = RecoveryInProgress();
 
-	if (!snapshot->takenDuringRecovery)
+	/*
+	 * If no transaction has committed, aborted or otherwise left the set of
+	 * running xids since this snapshot struct was last filled, its local
+	 * fields (xmin, xmax, xip, subxip) are still an accurate picture of the
+	 * proc array and we can skip the O(numProcs) scan below.  The change
+	 * counter is maintained under exclusive ProcArrayLock and we hold the
+	 * lock shared, so the comparison is stable for as long as we hold it.
+	 * Note that assignment of new xids (including subxids) never requires a
+	 * counter bump: new xids are always >= our unchanged xmax and hence seen
+	 * as running regardless.  Similarly, other backends setting or clearing
+	 * proc->xmin can only move the true global xmin forward, so the cached
+	 * procArrayGlobalXmin remains a conservative value to compute
+	 * RecentGlobalXmin from.
+	 */
+	if (!snapshot->takenDuringRecovery &&
+		snapshot->procArrayStateCount != 0 &&
+		snapshot->procArrayStateCount == arrayP->stateChangeCount)
 	{
+		Assert(TransactionIdEquals(xmax, snapshot->xmax));
+		xmin = snapshot->xmin;
+		globalxmin = snapshot->procArrayGlobalXmin;
+		count = snapshot->xcnt;
+		subcount = snapshot->subxcnt;
+		suboverflowed = snapshot->suboverflowed;
+		stateCount = snapshot->procArrayStateCount;
+	}
+	else if (!snapshot->takenDuringRecovery)
+	{
+		/* The scan below overwrites the arrays; drop the cached validity. */
+		snapshot->procArrayStateCount = 0;
+
 		/*
 		 * Spin over procArray checking xid, xmin, and subxids.  The goal is
 		 * to gather all active xids, find the lowest xmin, and try to record
@@ -2371,6 +2441,14 @@ GetSnapshotData(Snapshot snapshot)
 				}
 			}
 		}
+
+		/*
+		 * Remember the counter we scanned under, so that the scan can be
+		 * skipped next time if nothing completes in between.  The snapshot
+		 * struct is only stamped with it once all its fields are filled in
+		 * consistently, at the bottom of this function.
+		 */
+		stateCount = arrayP->stateChangeCount;
 	}
 	else
 	{
@@ -2397,6 +2475,9 @@ GetSnapshotData(Snapshot snapshot)
 		 * depending upon when the snapshot was taken, or change normal
 		 * snapshot processing so it matches.
 		 */
+		/* Recovery-shaped snapshots are never reused. */
+		snapshot->procArrayStateCount = 0;
+
 		subcount = KnownAssignedXidsGetAndSetXmin(snapshot->subxip, &xmin,
 												  xmax);
 
@@ -2419,6 +2500,9 @@ GetSnapshotData(Snapshot snapshot)
 						MyProc->databaseId, MyProc->pid, MyProc->xid, MyProc->xmin)));
 	}
 
+	/* Capture the scan-derived globalxmin before it gets adjusted below. */
+	scanGlobalXmin = globalxmin;
+
 	LWLockRelease(ProcArrayLock);
 
 	/*
@@ -2467,6 +2551,13 @@ GetSnapshotData(Snapshot snapshot)
 	snapshot->subxcnt = subcount;
 	snapshot->suboverflowed = suboverflowed;
 
+	/*
+	 * All local fields are consistent now, so stamp the snapshot as
+	 * reusable.  (stateCount is 0 for recovery-shaped snapshots.)
+	 */
+	snapshot->procArrayStateCount = stateCount;
+	snapshot->procArrayGlobalXmin = scanGlobalXmin;
+
 	snapshot->curcid = GetCurrentCommandId(false);
 
 	/*
@@ -3408,6 +3499,15 @@ XidCacheRemoveRunningXids(TransactionId xid,
 							  latestXid))
 		ShmemVariableCache->latestCompletedXid = latestXid;
 
+	/*
+	 * Snapshot contents change here too: the aborted subxids vanish from the
+	 * subxids cache and latestCompletedXid (hence xmax) may advance, so bump
+	 * the change counter like the other places that complete xids.  Without
+	 * this, GetSnapshotData's skip path would reuse a cached snapshot whose
+	 * xmax no longer matches a freshly computed one.
+	 */
+	procArray->stateChangeCount++;
+
 	LWLockRelease(ProcArrayLock);
 }
 
@@ -27,6 +27,7 @@
 #include "storage/sinval.h"
 #include "storage/standby.h"
 #include "tcop/tcopprot.h"
+#include "utils/memsnapshot.h"
 
 
 /*
@@ -288,6 +289,9 @@ procsignal_sigusr1_handler(SIGNAL_ARGS)
 		if (CheckProcSignal(PROCSIG_QUERY_FINISH))
 			QueryFinishHandler();
 
+		if (CheckProcSignal(PROCSIG_DUMP_MEMORY_CONTEXTS))
+			HandleMemSnapshotInterrupt();
+
 		latch_sigusr1_handler();
 		InSIGUSR1Handler = false;
 	}
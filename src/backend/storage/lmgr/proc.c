@@ -54,6 +54,7 @@
 #include "storage/proc.h"
 #include "storage/procarray.h"
 #include "storage/procsignal.h"
+#include "storage/waitevent.h"
 #include "executor/execdesc.h"
 #include "utils/resscheduler.h"
 #include "utils/timestamp.h"
@@ -394,7 +395,9 @@ InitProcess(void)
 		MyProc->vacuumFlags |= PROC_IS_AUTOVACUUM;
 	MyProc->lwWaiting = false;
 	MyProc->lwExclusive = false;
+	MyProc->lwWaitUntilFree = false;
 	MyProc->lwWaitLink = NULL;
+	MyProc->waitEventInfo = 0;
 	MyProc->waitLock = NULL;
 	MyProc->waitProcLock = NULL;
 	MyProc->resSlot = NULL;
@@ -591,7 +594,9 @@ InitAuxiliaryProcess(void)
 	MyProc->vacuumFlags = 0;
 	MyProc->lwWaiting = false;
 	MyProc->lwExclusive = false;
+	MyProc->lwWaitUntilFree = false;
 	MyProc->lwWaitLink = NULL;
+	MyProc->waitEventInfo = 0;
 	MyProc->waitLock = NULL;
 	MyProc->waitProcLock = NULL;
 	for (i = 0; i < NUM_LOCK_PARTITIONS; i++)
@@ -713,6 +718,9 @@ LockWaitCancel(void)
 	/* Turn off the deadlock timer, if it's still running (see ProcSleep) */
 	disable_sig_alarm(false);
 
+	/* Account the aborted wait (ProcSleep never got to do so) */
+	WaitEventEndWait();
+
 	/* Unlink myself from the wait queue, if on it (might not be anymore!) */
 	partitionLock = LockHashPartitionLock(lockAwaited->hashcode);
 	LWLockAcquire(partitionLock, LW_EXCLUSIVE);
@@ -1178,6 +1186,9 @@ ProcSleep(LOCALLOCK *locallock, LockMethod lockMethodTable)
 	 * updating the locallock table, but if we lose control to an error,
 	 * LockWaitCancel will fix that up.
 	 */
+	WaitEventStartWait(WAIT_EVENT_CLASS_LOCK,
+					   locallock->tag.lock.locktag_type);
+
 	do
 	{
 		PGSemaphoreLock(&MyProc->sem, true);
@@ -1323,6 +1334,8 @@ ProcSleep(LOCALLOCK *locallock, LockMethod lockMethodTable)
 		}
 	} while (myWaitStatus == STATUS_WAITING);
 
+	WaitEventEndWait();
+
 	/*
 	 * Disable the timer, if it's still running
 	 */
@@ -2100,6 +2113,9 @@ ResLockWaitCancel(void)
 
 		lockAwaited = NULL;
 
+		/* Account the abandoned wait into the queue's statistics. */
+		ResQueueWaitStatsEndWait(false);
+
 		LWLockRelease(partitionLock);
 	}
 
@@ -0,0 +1,306 @@
+/*-------------------------------------------------------------------------
+ *
+ * waitevent.c
+ *	  Lightweight wait-event accounting for blocking lock acquisitions.
+ *
+ * lwlock.c and proc.c call WaitEventStartWait() right before going to
+ * sleep on the process semaphore and WaitEventEndWait() right after
+ * waking up.  Start is deliberately minimal -- one store into MyProc --
+ * so the block path pays essentially nothing extra; the counter update
+ * happens on the wakeup side, where we have already paid for a full
+ * semaphore round trip.  The counters live in shared memory and are
+ * cluster-lifetime; gp_wait_event_counters() reads them out.
+ *
+ * Portions Copyright (c) 2012-Present Pivotal Software, Inc.
+ *
+ * IDENTIFICATION
+ *	    src/backend/storage/lmgr/waitevent.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "cdb/cdbvars.h"
+#include "funcapi.h"
+#include "miscadmin.h"
+#include "storage/lock.h"
+#include "storage/lwlock.h"
+#include "storage/proc.h"
+#include "storage/shmem.h"
+#include "storage/spin.h"
+#include "storage/waitevent.h"
+#include "utils/builtins.h"
+
+/*
+ * Shared wait counters.  LWLock waits are counted per predefined lock id,
+ * with one extra slot (index NumFixedLWLocks) that pools all dynamically
+ * assigned LWLocks (buffer content/io locks and the like).  Heavyweight
+ * lock waits are counted per locktag type.
+ */
+typedef struct WaitEventCounters
+{
+	slock_t		lock;			/* protects the counters */
+	uint64		lwlock[NumFixedLWLocks + 1];
+	uint64		heavylock[LOCKTAG_LAST_TYPE + 1];
+} WaitEventCounters;
+
+static WaitEventCounters *WaitEventCtr = NULL;
+
+/*
+ * Names of the individually declared LWLocks, indexed by LWLockId.  Must
+ * match the head of the LWLockId enum in lwlock.h, up to FirstAOSegFileLock
+ * where the partitioned ranges begin.
+ */
+static const char *const FixedLWLockNames[] = {
+	"NullLock",
+	"BufFreelistLock",
+	"ShmemIndexLock",
+	"OidGenLock",
+	"XidGenLock",
+	"ProcArrayLock",
+	"SInvalReadLock",
+	"SInvalWriteLock",
+	"WALInsertLock",
+	"WALWriteLock",
+	"ControlFileLock",
+	"CheckpointLock",
+	"CLogControlLock",
+	"SubtransControlLock",
+	"MultiXactGenLock",
+	"MultiXactOffsetControlLock",
+	"MultiXactMemberControlLock",
+	"RelCacheInitLock",
+	"CheckpointerCommLock",
+	"TwoPhaseStateLock",
+	"TablespaceCreateLock",
+	"BtreeVacuumLock",
+	"AddinShmemInitLock",
+	"AutovacuumLock",
+	"AutovacuumScheduleLock",
+	"SyncScanLock",
+	"RelationMappingLock",
+	"AsyncCtlLock",
+	"AsyncQueueLock",
+	"SharedSnapshotLock",
+	"DistributedLogControlLock",
+	"SeqServerControlLock"
+};
+
+/*
+ * WaitEventShmemSize --- report space needed for the shared counters
+ */
+Size
+WaitEventShmemSize(void)
+{
+	return MAXALIGN(sizeof(WaitEventCounters));
+}
+
+/*
+ * WaitEventShmemInit --- allocate and zero the shared counters
+ */
+void
+WaitEventShmemInit(void)
+{
+	WaitEventCtr = (WaitEventCounters *) ShmemAlloc(WaitEventShmemSize());
+	MemSet(WaitEventCtr, 0, sizeof(WaitEventCounters));
+	SpinLockInit(&WaitEventCtr->lock);
+}
+
+/*
+ * WaitEventStartWait --- tag MyProc as blocked on the given event
+ *
+ * Called on the block path, just before sleeping on the process semaphore,
+ * so this must stay a single store.  The tag is live in PGPROC for as long
+ * as the wait lasts, which also makes it readable by an observer walking
+ * the proc array.
+ */
+void
+WaitEventStartWait(uint8 classId, uint32 eventId)
+{
+	if (MyProc != NULL)
+		MyProc->waitEventInfo = WaitEventEncode(classId, eventId);
+}
+
+/*
+ * WaitEventEndWait --- clear the PGPROC tag and account the finished wait
+ *
+ * Called once per blocked acquisition after wakeup, not per bogus-wakeup
+ * iteration, so the spinlock here is taken at most once per real block.
+ */
+void
+WaitEventEndWait(void)
+{
+	volatile WaitEventCounters *counters = WaitEventCtr;
+	uint32		info;
+	uint32		eventId;
+
+	if (MyProc == NULL)
+		return;
+
+	info = MyProc->waitEventInfo;
+	MyProc->waitEventInfo = 0;
+
+	if (counters == NULL || info == 0)
+		return;
+
+	eventId = WaitEventId(info);
+
+	SpinLockAcquire(&counters->lock);
+	switch (WaitEventClass(info))
+	{
+		case WAIT_EVENT_CLASS_LWLOCK:
+			if (eventId >= NumFixedLWLocks)
+				eventId = NumFixedLWLocks;	/* dynamic-lock pool slot */
+			counters->lwlock[eventId]++;
+			break;
+		case WAIT_EVENT_CLASS_LOCK:
+			if (eventId <= LOCKTAG_LAST_TYPE)
+				counters->heavylock[eventId]++;
+			break;
+		default:
+			break;
+	}
+	SpinLockRelease(&counters->lock);
+}
+
+/*
+ * WaitEventLWLockName --- printable name for an LWLock wait event
+ *
+ * The partitioned ranges share one name each; anything past the predefined
+ * locks is a dynamically assigned lock and is pooled under one name.
+ */
+static const char *
+WaitEventLWLockName(uint32 eventId)
+{
+	if (eventId < FirstAOSegFileLock)
+		return FixedLWLockNames[eventId];
+	if (eventId < ResQueueLock)
+		return "AOSegFileLock";
+	if (eventId >= FirstWorkfileMgrLock && eventId < FirstWorkfileQuerySpaceLock)
+		return "WorkfileMgrLock";
+	if (eventId >= FirstWorkfileQuerySpaceLock && eventId < FirstBufMappingLock)
+		return "WorkfileQuerySpaceLock";
+	if (eventId >= FirstBufMappingLock && eventId < FirstLockMgrLock)
+		return "BufMappingLock";
+	if (eventId >= FirstLockMgrLock && eventId < SessionStateLock)
+		return "LockMgrLock";
+
+	switch (eventId)
+	{
+		case ResQueueLock:
+			return "ResQueueLock";
+		case ResGroupLock:
+			return "ResGroupLock";
+		case SyncRepLock:
+			return "SyncRepLock";
+		case ErrorLogLock:
+			return "ErrorLogLock";
+		case SessionStateLock:
+			return "SessionStateLock";
+		case RelfilenodeGenLock:
+			return "RelfilenodeGenLock";
+		case FilespaceHashLock:
+			return "FilespaceHashLock";
+		case TablespaceHashLock:
+			return "TablespaceHashLock";
+		case GpReplicationConfigFileLock:
+			return "GpReplicationConfigFileLock";
+		case RelSizeCacheLock:
+			return "RelSizeCacheLock";
+		default:
+			break;
+	}
+	return "DynamicLWLock";
+}
+
+/*
+ * gp_wait_event_counters - one row per wait event with a nonzero count.
+ */
+Datum
+gp_wait_event_counters(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+	WaitEventCounters *snapshot;
+	int			index;
+	int			nlwlocks = NumFixedLWLocks + 1;
+	int			nevents = nlwlocks + LOCKTAG_LAST_TYPE + 1;
+
+	if (SRF_IS_FIRSTCALL())
+	{
+		TupleDesc	tupdesc;
+		MemoryContext oldcontext;
+
+		funcctx = SRF_FIRSTCALL_INIT();
+
+		oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+		tupdesc = CreateTemplateTupleDesc(4, false);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 1, "segid",
+						   INT4OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 2, "wait_class",
+						   TEXTOID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 3, "wait_event",
+						   TEXTOID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 4, "wait_count",
+						   INT8OID, -1, 0);
+
+		funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+
+		/* copy the counters so each call iterates over a stable image */
+		snapshot = (WaitEventCounters *) palloc(sizeof(WaitEventCounters));
+		if (WaitEventCtr != NULL)
+		{
+			SpinLockAcquire(&WaitEventCtr->lock);
+			memcpy(snapshot, WaitEventCtr, sizeof(WaitEventCounters));
+			SpinLockRelease(&WaitEventCtr->lock);
+		}
+		else
+			MemSet(snapshot, 0, sizeof(WaitEventCounters));
+
+		funcctx->user_fctx = (void *) snapshot;
+		funcctx->call_cntr = 0;
+		funcctx->max_calls = nevents;
+
+		MemoryContextSwitchTo(oldcontext);
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+	snapshot = (WaitEventCounters *) funcctx->user_fctx;
+
+	for (index = funcctx->call_cntr; index < funcctx->max_calls; index++)
+	{
+		Datum		values[4];
+		bool		nulls[4];
+		HeapTuple	tuple;
+		uint64		count;
+
+		if (index < nlwlocks)
+		{
+			count = snapshot->lwlock[index];
+			if (count == 0)
+				continue;
+			values[1] = CStringGetTextDatum("LWLock");
+			values[2] = CStringGetTextDatum(WaitEventLWLockName(index));
+		}
+		else
+		{
+			count = snapshot->heavylock[index - nlwlocks];
+			if (count == 0)
+				continue;
+			values[1] = CStringGetTextDatum("Lock");
+			values[2] = CStringGetTextDatum(LockTagTypeNames[index - nlwlocks]);
+		}
+		values[0] = Int32GetDatum(GpIdentity.segindex);
+		values[3] = Int64GetDatum((int64) count);
+		MemSet(nulls, false, sizeof(nulls));
+
+		tuple = heap_form_tuple(funcctx->tuple_desc, values, nulls);
+
+		/* skip the entries consumed by this scan, including this one */
+		funcctx->call_cntr = index;
+
+		SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+	}
+
+	SRF_RETURN_DONE(funcctx);
+}
@@ -78,6 +78,7 @@
 #include "utils/backend_cancel.h"
 #include "utils/faultinjector.h"
 #include "utils/lsyscache.h"
+#include "utils/memsnapshot.h"
 #include "utils/memutils.h"
 #include "utils/ps_status.h"
 #include "utils/datum.h"
@@ -190,6 +191,12 @@ bool DoingCommandRead = false;
 static bool doing_extended_query_message = false;
 static bool ignore_till_sync = false;
 
+/*
+ * Flag to remember that this session already tried to pre-create its
+ * primary writer gang (see gp_eager_writer_gang).
+ */
+static bool writer_gang_warmed = false;
+
 /*
  * If an unnamed prepared statement exists, it's stored here.
  * We keep it separate from the hashtable kept by commands/prepare.c
@@ -1027,6 +1034,71 @@ pg_plan_queries(List *querytrees, int cursorOptions, ParamListInfo boundParams)
 	return stmt_list;
 }
 
+/*
+ * QE-side cache for the cached plan dispatch protocol.
+ *
+ * When the QD sets MPP_QUERY_FLAG_PLAN_CACHE_STORE on a dispatched query
+ * message, we keep a copy of the serialized plan tree under the hash that
+ * accompanied it; when a later message carries MPP_QUERY_FLAG_PLAN_CACHE_USE
+ * with no plan body, we execute the cached copy instead.  The ring has the
+ * same capacity and FIFO eviction order as the QD's mirror of it (see
+ * buildGpQueryString in cdbdisp_query.c), so both sides always agree on
+ * which plans are cached.  Looking entries up by (hash, len) is safe
+ * because the QD keeps the plan bytes in its mirror, sends USE only after
+ * comparing them, and never stores two different plans under the same key.
+ */
+typedef struct
+{
+	uint32		hash;
+	int			len;
+	char	   *plan;
+} CachedDispatchedPlan;
+
+static CachedDispatchedPlan cachedDispatchedPlanRing[CACHED_PLAN_DISPATCH_SLOTS];
+static int	cachedDispatchedPlanCount = 0;
+static int	cachedDispatchedPlanNext = 0;
+
+static void
+mpp_cached_plan_store(uint32 planHash, const char *plan, int len)
+{
+	CachedDispatchedPlan *slot = &cachedDispatchedPlanRing[cachedDispatchedPlanNext];
+
+	if (cachedDispatchedPlanCount == CACHED_PLAN_DISPATCH_SLOTS)
+		pfree(slot->plan);
+
+	slot->hash = planHash;
+	slot->len = len;
+	slot->plan = MemoryContextAlloc(TopMemoryContext, len);
+	memcpy(slot->plan, plan, len);
+
+	cachedDispatchedPlanNext = (cachedDispatchedPlanNext + 1) % CACHED_PLAN_DISPATCH_SLOTS;
+	if (cachedDispatchedPlanCount < CACHED_PLAN_DISPATCH_SLOTS)
+		cachedDispatchedPlanCount++;
+}
+
+static const char *
+mpp_cached_plan_fetch(uint32 planHash, int len, int *plan_len)
+{
+	int			i;
+
+	for (i = 0; i < cachedDispatchedPlanCount; i++)
+	{
+		CachedDispatchedPlan *slot = &cachedDispatchedPlanRing[i];
+
+		if (slot->hash == planHash && slot->len == len)
+		{
+			*plan_len = slot->len;
+			return slot->plan;
+		}
+	}
+
+	ereport(ERROR,
+			(errcode(ERRCODE_PROTOCOL_VIOLATION),
+			 errmsg("dispatched plan with hash %u not found in the plan cache",
+					planHash)));
+	return NULL;				/* keep compiler quiet */
+}
+
 /*
  * exec_mpp_query
  *
@@ -3798,6 +3870,15 @@ ProcessInterrupts(const char* filename, int lineno)
 		return;
 
 	InterruptPending = false;
+
+	/*
+	 * Service a pending memory context snapshot request first; the dump is
+	 * cheap and must not be skipped because a cancel or die interrupt is
+	 * about to throw.
+	 */
+	if (MemSnapshotDumpPending)
+		ProcessMemSnapshotRequest();
+
 	if (ProcDiePending)
 	{
 		ProcDiePending = false;
@@ -4598,6 +4679,7 @@ PostgresMain(int argc, char *argv[],
 	StringInfoData input_message;
 	sigjmp_buf	local_sigjmp_buf;
 	volatile bool send_ready_for_query = true;
+	volatile bool batched_input = false;
 
 	MemoryAccountIdType postgresMainMemoryAccountId = MEMORY_OWNER_TYPE_Undefined;
 
@@ -5072,12 +5154,40 @@ PostgresMain(int argc, char *argv[],
         if (Gp_role == GP_ROLE_EXECUTE)
             gp_command_count = 0;
 
+		/*
+		 * Pre-create the primary writer gang once per session, so the first
+		 * query does not pay segment connection setup in its own latency.
+		 * Runs under the exception stack: if a segment cannot be reached the
+		 * error is reported and the session carries on, and the gang gets
+		 * created at dispatch time as usual.
+		 */
+		if (Gp_role == GP_ROLE_DISPATCH && gp_eager_writer_gang &&
+			!writer_gang_warmed && !IsTransactionOrTransactionBlock())
+		{
+			writer_gang_warmed = true;
+			start_xact_command();
+			(void) AllocateWriterGang();
+			finish_xact_command();
+		}
+
+		/*
+		 * If the client has already sent more input (a pipelined batch of
+		 * extended-query messages, typically), we are not actually going
+		 * idle: the next ReadCommand returns without blocking. Skip the
+		 * going-idle bookkeeping below in that case, so batched messages
+		 * are consumed without paying an itimer arm/disarm and an idle
+		 * tracker transition per message.
+		 */
+		batched_input = (whereToSendOutput == DestRemote &&
+						 pq_buffer_has_data());
+
 		/*
 		 * Do deactiving and runaway detecting before ReadyForQuery(),
 		 * so any OOM errors of current query will not muddle following
 		 * queries
 		 */
-		IdleTracker_DeactivateProcess();
+		if (!batched_input)
+			IdleTracker_DeactivateProcess();
 
 		/*
 		 * (1) If we've reached idle state, tell the frontend we're ready for
@@ -5135,7 +5245,7 @@ PostgresMain(int argc, char *argv[],
 		 * (2b) Check for temp table delete reset session work.
 		 * Also clean up idle resources.
 		 */
-		if (Gp_role == GP_ROLE_DISPATCH)
+		if (Gp_role == GP_ROLE_DISPATCH && !batched_input)
 		{
 			CheckForResetSession();
 			StartIdleResourceCleanupTimers();
@@ -5154,7 +5264,8 @@ PostgresMain(int argc, char *argv[],
 		 */
 		QueryFinishPending = false;
 
-		IdleTracker_ActivateProcess();
+		if (!batched_input)
+			IdleTracker_ActivateProcess();
 
 		/*
 		 * (4) disable async signal conditions again.
@@ -5248,6 +5359,8 @@ PostgresMain(int argc, char *argv[],
 					bool ouid_is_super = false;
 
 					int unusedFlags;
+					uint32 planHash = 0;
+					int planCacheLen = 0;
 
 					if (Gp_role != GP_ROLE_EXECUTE)
 						ereport(ERROR,
@@ -5290,9 +5403,13 @@ PostgresMain(int argc, char *argv[],
 
 					DtxContextInfo_Deserialize(serializedDtxContextInfo, serializedDtxContextInfolen, &TempDtxContextInfo);
 
-					/* get the transaction options */
+					/* get the MPP_QUERY_FLAG_XXX bits */
 					unusedFlags = pq_getmsgint(&input_message, 4);
 
+					/* cached plan dispatch: hash and length of the plan tree */
+					planHash = (uint32) pq_getmsgint(&input_message, 4);
+					planCacheLen = pq_getmsgint(&input_message, 4);
+
 					seqServerHostlen = pq_getmsgint(&input_message, 4);
 					seqServerPort = pq_getmsgint(&input_message, 4);
 
@@ -5339,6 +5456,20 @@ PostgresMain(int argc, char *argv[],
 
 					pq_getmsgend(&input_message);
 
+					/*
+					 * Cached plan dispatch: remember this plan for later
+					 * executions, or substitute a previously cached plan for
+					 * the one the QD omitted from the message.
+					 */
+					if ((unusedFlags & MPP_QUERY_FLAG_PLAN_CACHE_STORE) &&
+						serializedPlantreelen > 0)
+						mpp_cached_plan_store(planHash, serializedPlantree,
+											  serializedPlantreelen);
+					else if (unusedFlags & MPP_QUERY_FLAG_PLAN_CACHE_USE)
+						serializedPlantree = mpp_cached_plan_fetch(planHash,
+																   planCacheLen,
+																   &serializedPlantreelen);
+
 					elog((Debug_print_full_dtm ? LOG : DEBUG5), "MPP dispatched stmt from QD: %s.",query_string);
 
 					if (IsResGroupActivated() && resgroupInfoLen > 0)
@@ -168,16 +168,24 @@ foreach my $s (sort {$a->{oid} <=> $b->{oid}} @fmgr)
     print T "extern Datum $s->{prosrc} (PG_FUNCTION_ARGS);\n";
 }
 
-# Create the fmgr_builtins table
+# Create the fmgr_builtins table, collecting the Oid => table position
+# mapping for the lookup index as we go.
 print T "\nconst FmgrBuiltin fmgr_builtins[] = {\n";
 my %bmap;
 $bmap{'t'} = 'true';
 $bmap{'f'} = 'false';
+my %oid_index;
+my $last_builtin_oid = 0;
+my $fmgr_count = 0;
 foreach my $s (sort {$a->{oid} <=> $b->{oid}} @fmgr)
 {
     print T
 	"  { $s->{oid}, \"$s->{prosrc}\", $s->{nargs}, $bmap{$s->{strict}}, $bmap{$s->{retset}}, $s->{prosrc} },\n";
+    $oid_index{$s->{oid}} = $fmgr_count++;
+    $last_builtin_oid = $s->{oid};
 }
+die "fmgr_builtin_oid_index entries overflow uint16"
+  if $fmgr_count >= 0xFFFF;
 
 # And add the file footers.
 print H "\n#endif /* FMGROIDS_H */\n";
@@ -193,6 +201,22 @@ qq|  /* dummy entry is easier than getting rid of comma after last real one */
 const int fmgr_nbuiltins = (sizeof(fmgr_builtins) / sizeof(FmgrBuiltin)) - 1;
 |;
 
+# Create the direct lookup index: for each Oid up to the highest builtin
+# Oid, the position of that function in fmgr_builtins, or
+# InvalidFmgrBuiltinIndex for Oids that are not builtin functions.
+print T "\n/* Position in fmgr_builtins for each Oid, see fmgrtab.h */\n";
+print T "const Oid fmgr_last_builtin_oid = $last_builtin_oid;\n\n";
+print T "const uint16 fmgr_builtin_oid_index[$last_builtin_oid + 1] = {\n";
+for (my $oid = 0; $oid <= $last_builtin_oid; $oid++)
+{
+    my $entry = defined $oid_index{$oid}
+      ? $oid_index{$oid} : 'InvalidFmgrBuiltinIndex';
+    print T "  $entry";
+    print T "," if $oid < $last_builtin_oid;
+    print T (($oid % 8 == 7 || $oid == $last_builtin_oid) ? "\n" : "");
+}
+print T "};\n";
+
 close(H);
 close(T);
 
@@ -2101,6 +2101,241 @@ float8_stddev_samp(PG_FUNCTION_ARGS)
 	PG_RETURN_FLOAT8(sqrt(numerator / (N * (N - 1.0))));
 }
 
+/*
+ * Bytea-packed counterparts of the aggregates above, used by the float
+ * variance/stddev aggregates in pg_aggregate.
+ *
+ * In multi-stage plans the transition state travels across motions.  As a
+ * float8[3] it drags the full array representation (header, dimensions,
+ * element type) along with the three numbers that matter; packing
+ * {N, sum(X), sum(X*X)} into a plain bytea roughly halves the bytes on the
+ * wire.  This follows the same scheme as the *_avg_accum family in
+ * numeric.c: a first call (or the "" initval) is detected by VARSIZE not
+ * matching, and the state is modified in place thereafter.
+ */
+
+typedef struct FloatStatTransdata
+{
+	int32		_len;		/* len for varattrib, do not touch directly */
+	int32		pad;		/* pad so the float8 members are 8 bytes aligned */
+	float8		N;
+	float8		sumX;
+	float8		sumX2;
+} FloatStatTransdata;
+
+static inline Datum
+float8_stat_accum_decum(FloatStatTransdata *transdata, float8 newval, bool acc)
+{
+	if (transdata == NULL || VARSIZE(transdata) != sizeof(FloatStatTransdata))
+	{
+		/* If first time execution, need to allocate memory for this */
+		Assert(acc);
+		transdata = (FloatStatTransdata *) palloc(sizeof(FloatStatTransdata));
+		SET_VARSIZE(transdata, sizeof(FloatStatTransdata));
+		transdata->N = 0;
+		transdata->sumX = 0;
+		transdata->sumX2 = 0;
+	}
+
+	if (acc)
+	{
+		float8		oldsumX = transdata->sumX;
+		float8		oldsumX2 = transdata->sumX2;
+
+		transdata->N += 1.0;
+		transdata->sumX = oldsumX + newval;
+		CHECKFLOATVAL(transdata->sumX, isinf(oldsumX) || isinf(newval), true);
+		transdata->sumX2 = oldsumX2 + newval * newval;
+		CHECKFLOATVAL(transdata->sumX2, isinf(oldsumX2) || isinf(newval), true);
+	}
+	else
+	{
+		transdata->N -= 1.0;
+		transdata->sumX -= newval;
+		transdata->sumX2 -= newval * newval;
+	}
+
+	return PointerGetDatum(transdata);
+}
+
+static inline Datum
+float8_stat_amalg_demalg(FloatStatTransdata *tr0, FloatStatTransdata *tr1,
+						 bool amalg)
+{
+	if (tr0 == NULL || VARSIZE(tr0) != sizeof(FloatStatTransdata))
+	{
+		tr0 = (FloatStatTransdata *) palloc(sizeof(FloatStatTransdata));
+		SET_VARSIZE(tr0, sizeof(FloatStatTransdata));
+		tr0->N = 0;
+		tr0->sumX = 0;
+		tr0->sumX2 = 0;
+	}
+
+	if (tr1 == NULL || VARSIZE(tr1) != sizeof(FloatStatTransdata))
+		return PointerGetDatum(tr0);
+
+	if (amalg)
+	{
+		float8		oldsumX = tr0->sumX;
+		float8		oldsumX2 = tr0->sumX2;
+
+		tr0->N += tr1->N;
+		tr0->sumX = oldsumX + tr1->sumX;
+		CHECKFLOATVAL(tr0->sumX, isinf(oldsumX) || isinf(tr1->sumX), true);
+		tr0->sumX2 = oldsumX2 + tr1->sumX2;
+		CHECKFLOATVAL(tr0->sumX2, isinf(oldsumX2) || isinf(tr1->sumX2), true);
+	}
+	else
+	{
+		tr0->N -= tr1->N;
+		tr0->sumX -= tr1->sumX;
+		tr0->sumX2 -= tr1->sumX2;
+	}
+
+	return PointerGetDatum(tr0);
+}
+
+Datum
+float4_stat_accum(PG_FUNCTION_ARGS)
+{
+	FloatStatTransdata *tr = (FloatStatTransdata *) PG_GETARG_BYTEA_P(0);
+	float4		newval = PG_GETARG_FLOAT4(1);
+
+	Assert(fcinfo->context && IS_AGG_EXECUTION_NODE(fcinfo->context));
+	/* do computations as float8 */
+	return float8_stat_accum_decum(tr, newval, true);
+}
+
+Datum
+float8_stat_accum(PG_FUNCTION_ARGS)
+{
+	FloatStatTransdata *tr = (FloatStatTransdata *) PG_GETARG_BYTEA_P(0);
+	float8		newval = PG_GETARG_FLOAT8(1);
+
+	Assert(fcinfo->context && IS_AGG_EXECUTION_NODE(fcinfo->context));
+	return float8_stat_accum_decum(tr, newval, true);
+}
+
+Datum
+float4_stat_decum(PG_FUNCTION_ARGS)
+{
+	FloatStatTransdata *tr = (FloatStatTransdata *) PG_GETARG_BYTEA_P(0);
+	float4		newval = PG_GETARG_FLOAT4(1);
+
+	Assert(fcinfo->context && IS_AGG_EXECUTION_NODE(fcinfo->context));
+	return float8_stat_accum_decum(tr, newval, false);
+}
+
+Datum
+float8_stat_decum(PG_FUNCTION_ARGS)
+{
+	FloatStatTransdata *tr = (FloatStatTransdata *) PG_GETARG_BYTEA_P(0);
+	float8		newval = PG_GETARG_FLOAT8(1);
+
+	Assert(fcinfo->context && IS_AGG_EXECUTION_NODE(fcinfo->context));
+	return float8_stat_accum_decum(tr, newval, false);
+}
+
+Datum
+float8_stat_amalg(PG_FUNCTION_ARGS)
+{
+	FloatStatTransdata *d0 = (FloatStatTransdata *) PG_GETARG_BYTEA_P(0);
+	FloatStatTransdata *d1 = (FloatStatTransdata *) PG_GETARG_BYTEA_P(1);
+
+	Assert(fcinfo->context && IS_AGG_EXECUTION_NODE(fcinfo->context));
+	return float8_stat_amalg_demalg(d0, d1, true);
+}
+
+Datum
+float8_stat_demalg(PG_FUNCTION_ARGS)
+{
+	FloatStatTransdata *d0 = (FloatStatTransdata *) PG_GETARG_BYTEA_P(0);
+	FloatStatTransdata *d1 = (FloatStatTransdata *) PG_GETARG_BYTEA_P(1);
+
+	Assert(fcinfo->context && IS_AGG_EXECUTION_NODE(fcinfo->context));
+	return float8_stat_amalg_demalg(d0, d1, false);
+}
+
+Datum
+float8_stat_var_pop(PG_FUNCTION_ARGS)
+{
+	FloatStatTransdata *tr = (FloatStatTransdata *) PG_GETARG_BYTEA_P(0);
+	float8		numerator;
+
+	/* Population variance is undefined when N is 0, so return NULL */
+	if (tr == NULL || VARSIZE(tr) < sizeof(FloatStatTransdata) || tr->N == 0.0)
+		PG_RETURN_NULL();
+
+	numerator = tr->N * tr->sumX2 - tr->sumX * tr->sumX;
+	CHECKFLOATVAL(numerator, isinf(tr->sumX2) || isinf(tr->sumX), true);
+
+	/* Watch out for roundoff error producing a negative numerator */
+	if (numerator <= 0.0)
+		PG_RETURN_FLOAT8(0.0);
+
+	PG_RETURN_FLOAT8(numerator / (tr->N * tr->N));
+}
+
+Datum
+float8_stat_var_samp(PG_FUNCTION_ARGS)
+{
+	FloatStatTransdata *tr = (FloatStatTransdata *) PG_GETARG_BYTEA_P(0);
+	float8		numerator;
+
+	/* Sample variance is undefined when N is 0 or 1, so return NULL */
+	if (tr == NULL || VARSIZE(tr) < sizeof(FloatStatTransdata) || tr->N <= 1.0)
+		PG_RETURN_NULL();
+
+	numerator = tr->N * tr->sumX2 - tr->sumX * tr->sumX;
+	CHECKFLOATVAL(numerator, isinf(tr->sumX2) || isinf(tr->sumX), true);
+
+	/* Watch out for roundoff error producing a negative numerator */
+	if (numerator <= 0.0)
+		PG_RETURN_FLOAT8(0.0);
+
+	PG_RETURN_FLOAT8(numerator / (tr->N * (tr->N - 1.0)));
+}
+
+Datum
+float8_stat_stddev_pop(PG_FUNCTION_ARGS)
+{
+	FloatStatTransdata *tr = (FloatStatTransdata *) PG_GETARG_BYTEA_P(0);
+	float8		numerator;
+
+	/* Population stddev is undefined when N is 0, so return NULL */
+	if (tr == NULL || VARSIZE(tr) < sizeof(FloatStatTransdata) || tr->N == 0.0)
+		PG_RETURN_NULL();
+
+	numerator = tr->N * tr->sumX2 - tr->sumX * tr->sumX;
+	CHECKFLOATVAL(numerator, isinf(tr->sumX2) || isinf(tr->sumX), true);
+
+	/* Watch out for roundoff error producing a negative numerator */
+	if (numerator <= 0.0)
+		PG_RETURN_FLOAT8(0.0);
+
+	PG_RETURN_FLOAT8(sqrt(numerator / (tr->N * tr->N)));
+}
+
+Datum
+float8_stat_stddev_samp(PG_FUNCTION_ARGS)
+{
+	FloatStatTransdata *tr = (FloatStatTransdata *) PG_GETARG_BYTEA_P(0);
+	float8		numerator;
+
+	/* Sample stddev is undefined when N is 0 or 1, so return NULL */
+	if (tr == NULL || VARSIZE(tr) < sizeof(FloatStatTransdata) || tr->N <= 1.0)
+		PG_RETURN_NULL();
+
+	numerator = tr->N * tr->sumX2 - tr->sumX * tr->sumX;
+	CHECKFLOATVAL(numerator, isinf(tr->sumX2) || isinf(tr->sumX), true);
+
+	/* Watch out for roundoff error producing a negative numerator */
+	if (numerator <= 0.0)
+		PG_RETURN_FLOAT8(0.0);
+
+	PG_RETURN_FLOAT8(sqrt(numerator / (tr->N * (tr->N - 1.0))));
+}
+
 /*
  *		=========================
  *		SQL2003 BINARY AGGREGATES
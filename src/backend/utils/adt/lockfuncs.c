@@ -24,7 +24,7 @@
 #include "cdb/cdbvars.h"
 
 /* This must match enum LockTagType! */
-static const char *const LockTagTypeNames[] = {
+const char *const LockTagTypeNames[] = {
 	"relation",
 	"extend",
 	"page",
@@ -34,6 +34,8 @@
 #include "storage/procarray.h"
 #include "utils/backend_cancel.h"
 #include "utils/builtins.h"
+#include "utils/catcache.h"
+#include "utils/relcache.h"
 #include "tcop/tcopprot.h"
 
 #define atooid(x)  ((Oid) strtoul((x), NULL, 10))
@@ -526,3 +528,49 @@ pg_typeof(PG_FUNCTION_ARGS)
 {
 	PG_RETURN_OID(get_fn_expr_argtype(fcinfo->flinfo, 0));
 }
+
+/*
+ * Report this session's catalog cache size and eviction counters, for
+ * tuning gp_catcache_memory_limit_kb and gp_catcache_negative_entry_limit.
+ */
+Datum
+gp_catcache_statistics(PG_FUNCTION_ARGS)
+{
+	CatCacheStats stats;
+	TupleDesc	tupdesc;
+	Datum		values[5];
+	bool		nulls[5];
+	HeapTuple	tuple;
+
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	GetCatCacheStatistics(&stats);
+
+	MemSet(nulls, false, sizeof(nulls));
+	values[0] = Int64GetDatum((int64) stats.entries);
+	values[1] = Int64GetDatum((int64) stats.negative_entries);
+	values[2] = Int64GetDatum((int64) stats.bytes);
+	values[3] = Int64GetDatum((int64) stats.evictions);
+	values[4] = Int64GetDatum((int64) stats.negative_prunes);
+
+	tuple = heap_form_tuple(BlessTupleDesc(tupdesc), values, nulls);
+
+	PG_RETURN_DATUM(HeapTupleGetDatum(tuple));
+}
+
+/*
+ * Snapshot the user relations in this session's relcache into the database's
+ * user-relation init file, so that future backends preload them at startup.
+ * Returns the number of relcache entries written.
+ */
+Datum
+gp_relcache_write_user_init_file(PG_FUNCTION_ARGS)
+{
+	if (!superuser())
+		ereport(ERROR,
+				(errcode(ERRCODE_INSUFFICIENT_PRIVILEGE),
+				 (errmsg("must be superuser to write the relation cache init file"))));
+
+	PG_RETURN_INT32(RelationCacheWriteUserInitFile());
+}
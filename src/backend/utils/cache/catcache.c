@@ -72,6 +72,14 @@
 /* Cache management header --- pointer is NULL until created */
 static CatCacheHeader *CacheHdr = NULL;
 
+/*
+ * Bounds for the catalog caches; 0 means unbounded (the historical
+ * behavior).  Sessions that touch many temp tables or wide partition
+ * hierarchies otherwise accumulate cache entries without limit.
+ */
+int			gp_catcache_memory_limit_kb = 0;
+int			gp_catcache_negative_entry_limit = 0;
+
 
 static uint32 CatalogCacheComputeHashValue(CatCache *cache, int nkeys,
 							 ScanKey cur_skey);
@@ -82,12 +90,17 @@ static uint32 CatalogCacheComputeTupleHashValue(CatCache *cache,
 static void CatCachePrintStats(int code, Datum arg);
 #endif
 static void CatCacheRemoveCTup(CatCache *cache, CatCTup *ct);
+static void CatCacheEnforceLimits(CatCTup *protect);
 static void CatCacheRemoveCList(CatCache *cache, CatCList *cl);
 static void CatalogCacheInitializeCache(CatCache *cache);
 static CatCTup *CatalogCacheCreateEntry(CatCache *cache, HeapTuple ntp,
 						uint32 hashValue, Index hashIndex,
 						bool negative);
 static HeapTuple build_dummy_tuple(CatCache *cache, int nkeys, ScanKey skeys);
+static CatCTup *SearchCatCacheBucket(CatCache *cache, ScanKey cur_skey,
+					 uint32 hashValue, Index hashIndex);
+static CatCTup *SearchCatCacheMiss(CatCache *cache, Relation relation,
+				   ScanKey cur_skey, uint32 hashValue, Index hashIndex);
 
 
 /*
@@ -369,8 +382,13 @@ CatCacheRemoveCTup(CatCache *cache, CatCTup *ct)
 		return;					/* nothing left to do */
 	}
 
-	/* delink from linked list */
+	/* delink from linked lists */
 	DLRemove(&ct->cache_elem);
+	DLRemove(&ct->lru_elem);
+
+	CacheHdr->ch_nbytes -= ct->size;
+	if (ct->negative)
+		--CacheHdr->ch_negtup;
 
 	/* free associated tuple data */
 	if (ct->tuple.t_data != NULL)
@@ -789,6 +807,11 @@ InitCatCache(int id,
 		CacheHdr = (CatCacheHeader *) palloc(sizeof(CatCacheHeader));
 		CacheHdr->ch_caches = NULL;
 		CacheHdr->ch_ntup = 0;
+		CacheHdr->ch_negtup = 0;
+		CacheHdr->ch_nbytes = 0;
+		DLInitList(&CacheHdr->ch_lrulist);
+		CacheHdr->ch_evictions = 0;
+		CacheHdr->ch_negprunes = 0;
 #ifdef CATCACHE_STATS
 		/* set up to dump stats at backend exit */
 		on_proc_exit(CatCachePrintStats, 0);
@@ -1133,11 +1156,8 @@ SearchCatCache(CatCache *cache,
 	ScanKeyData cur_skey[CATCACHE_MAXKEYS];
 	uint32		hashValue;
 	Index		hashIndex;
-	Dlelem	   *elt;
 	CatCTup    *ct;
 	Relation	relation;
-	SysScanDesc scandesc;
-	HeapTuple	ntp;
 
 	/*
 	 * one-time startup overhead for each cache
@@ -1164,6 +1184,39 @@ SearchCatCache(CatCache *cache,
 	hashValue = CatalogCacheComputeHashValue(cache, cache->cc_nkeys, cur_skey);
 	hashIndex = HASH_INDEX(hashValue, cache->cc_nbuckets);
 
+	ct = SearchCatCacheBucket(cache, cur_skey, hashValue, hashIndex);
+	if (ct != NULL)
+		return ct->negative ? NULL : &ct->tuple;
+
+	/*
+	 * Tuple was not found in cache, so we have to try to retrieve it directly
+	 * from the relation.  If found, we will add it to the cache; if not
+	 * found, we will add a negative cache entry instead.
+	 */
+	relation = heap_open(cache->cc_reloid, AccessShareLock);
+
+	ct = SearchCatCacheMiss(cache, relation, cur_skey, hashValue, hashIndex);
+
+	heap_close(relation, AccessShareLock);
+
+	return ct ? &ct->tuple : NULL;
+}
+
+/*
+ * Scan one hash bucket for a live entry matching the given key.
+ *
+ * On a hit the entry is moved to the front of its lists; if it is a
+ * positive entry its refcount is bumped on behalf of the caller.  Returns
+ * the entry (positive or negative -- check ct->negative) or NULL if the
+ * key is not in the cache at all.
+ */
+static CatCTup *
+SearchCatCacheBucket(CatCache *cache, ScanKey cur_skey,
+					 uint32 hashValue, Index hashIndex)
+{
+	Dlelem	   *elt;
+	CatCTup    *ct;
+
 	/*
 	 * scan the hash bucket until we find a match or exhaust our tuples
 	 */
@@ -1199,10 +1252,12 @@ SearchCatCache(CatCache *cache,
 		 * near the front of the hashbucket's list.)
 		 */
 		DLMoveToFront(&ct->cache_elem);
+		DLMoveToFront(&ct->lru_elem);
 
 		/*
-		 * If it's a positive entry, bump its refcount and return it. If it's
-		 * negative, we can report failure to the caller.
+		 * If it's a positive entry, bump its refcount on behalf of the
+		 * caller.	Negative entries are returned as-is so the caller can
+		 * distinguish "cached as nonexistent" from a cache miss.
 		 */
 		if (!ct->negative)
 		{
@@ -1216,8 +1271,6 @@ SearchCatCache(CatCache *cache,
 #ifdef CATCACHE_STATS
 			cache->cc_hits++;
 #endif
-
-			return &ct->tuple;
 		}
 		else
 		{
@@ -1227,27 +1280,37 @@ SearchCatCache(CatCache *cache,
 #ifdef CATCACHE_STATS
 			cache->cc_neg_hits++;
 #endif
-
-			return NULL;
 		}
+
+		return ct;
 	}
 
-	/*
-	 * Tuple was not found in cache, so we have to try to retrieve it directly
-	 * from the relation.  If found, we will add it to the cache; if not
-	 * found, we will add a negative cache entry instead.
-	 *
-	 * NOTE: it is possible for recursive cache lookups to occur while reading
-	 * the relation --- for example, due to shared-cache-inval messages being
-	 * processed during heap_open().  This is OK.  It's even possible for one
-	 * of those lookups to find and enter the very same tuple we are trying to
-	 * fetch here.	If that happens, we will enter a second copy of the tuple
-	 * into the cache.	The first copy will never be referenced again, and
-	 * will eventually age out of the cache, so there's no functional problem.
-	 * This case is rare enough that it's not worth expending extra cycles to
-	 * detect.
-	 */
-	relation = heap_open(cache->cc_reloid, AccessShareLock);
+	return NULL;
+}
+
+/*
+ * Fetch a tuple that was not found in the cache from the (already open)
+ * catalog relation, and enter it into the cache.  If the tuple does not
+ * exist, a negative cache entry is entered instead and NULL is returned.
+ * A positive entry is returned with its refcount already bumped.
+ *
+ * NOTE: it is possible for recursive cache lookups to occur while reading
+ * the relation --- for example, due to shared-cache-inval messages being
+ * processed during heap_open().  This is OK.  It's even possible for one
+ * of those lookups to find and enter the very same tuple we are trying to
+ * fetch here.	If that happens, we will enter a second copy of the tuple
+ * into the cache.	The first copy will never be referenced again, and
+ * will eventually age out of the cache, so there's no functional problem.
+ * This case is rare enough that it's not worth expending extra cycles to
+ * detect.
+ */
+static CatCTup *
+SearchCatCacheMiss(CatCache *cache, Relation relation, ScanKey cur_skey,
+				   uint32 hashValue, Index hashIndex)
+{
+	SysScanDesc scandesc;
+	HeapTuple	ntp;
+	CatCTup    *ct;
 
 	scandesc = systable_beginscan(relation,
 								  cache->cc_indexoid,
@@ -1268,7 +1331,12 @@ SearchCatCache(CatCache *cache,
 		 */
 		if (scandesc->irel)
 		{
-			CrossCheckTuple(cache->id, v1, v2, v3, v4, ntp);
+			CrossCheckTuple(cache->id,
+							cur_skey[0].sk_argument,
+							cur_skey[1].sk_argument,
+							cur_skey[2].sk_argument,
+							cur_skey[3].sk_argument,
+							ntp);
 		}
 
 		ct = CatalogCacheCreateEntry(cache, ntp,
@@ -1283,8 +1351,6 @@ SearchCatCache(CatCache *cache,
 
 	systable_endscan(scandesc);
 
-	heap_close(relation, AccessShareLock);
-
 	/*
 	 * If tuple was not found, we need to build a negative cache entry
 	 * containing a fake tuple.  The fake tuple has the correct key columns,
@@ -1328,7 +1394,78 @@ SearchCatCache(CatCache *cache,
 	cache->cc_newloads++;
 #endif
 
-	return &ct->tuple;
+	return ct;
+}
+
+/*
+ *	SearchCatCacheBatch
+ *
+ *		Look up a whole vector of keys in one call.  Each key behaves as in
+ *		SearchCatCache: tuples[i] receives the cached tuple (which must be
+ *		released with ReleaseCatCache) or NULL if key i has no match.  The
+ *		key arrays may be NULL for key columns the cache does not use.
+ *
+ *		The win over calling SearchCatCache in a loop is that all cache
+ *		misses share a single open/lock/close of the catalog relation,
+ *		instead of paying for one per missing key.
+ */
+void
+SearchCatCacheBatch(CatCache *cache,
+					int nitems,
+					const Datum *v1,
+					const Datum *v2,
+					const Datum *v3,
+					const Datum *v4,
+					HeapTuple *tuples)
+{
+	Relation	relation = NULL;
+	int			i;
+
+	/*
+	 * one-time startup overhead for each cache
+	 */
+	if (cache->cc_tupdesc == NULL)
+		CatalogCacheInitializeCache(cache);
+
+	for (i = 0; i < nitems; i++)
+	{
+		ScanKeyData cur_skey[CATCACHE_MAXKEYS];
+		uint32		hashValue;
+		Index		hashIndex;
+		CatCTup    *ct;
+
+#ifdef CATCACHE_STATS
+		cache->cc_searches++;
+#endif
+
+		memcpy(cur_skey, cache->cc_skey, sizeof(cur_skey));
+		cur_skey[0].sk_argument = v1 ? v1[i] : 0;
+		cur_skey[1].sk_argument = v2 ? v2[i] : 0;
+		cur_skey[2].sk_argument = v3 ? v3[i] : 0;
+		cur_skey[3].sk_argument = v4 ? v4[i] : 0;
+
+		hashValue = CatalogCacheComputeHashValue(cache, cache->cc_nkeys,
+												 cur_skey);
+		hashIndex = HASH_INDEX(hashValue, cache->cc_nbuckets);
+
+		ct = SearchCatCacheBucket(cache, cur_skey, hashValue, hashIndex);
+		if (ct != NULL)
+		{
+			tuples[i] = ct->negative ? NULL : &ct->tuple;
+			continue;
+		}
+
+		/* first miss of the batch opens the catalog for all of them */
+		if (relation == NULL)
+			relation = heap_open(cache->cc_reloid, AccessShareLock);
+
+		ct = SearchCatCacheMiss(cache, relation, cur_skey,
+								hashValue, hashIndex);
+		tuples[i] = ct ? &ct->tuple : NULL;
+	}
+
+	if (relation != NULL)
+		heap_close(relation, AccessShareLock);
 }
 
 /*
@@ -1709,20 +1846,107 @@ CatalogCacheCreateEntry(CatCache *cache, HeapTuple ntp,
 	ct->ct_magic = CT_MAGIC;
 	ct->my_cache = cache;
 	DLInitElem(&ct->cache_elem, (void *) ct);
+	DLInitElem(&ct->lru_elem, (void *) ct);
 	ct->c_list = NULL;
 	ct->refcount = 0;			/* for the moment */
 	ct->dead = false;
 	ct->negative = negative;
 	ct->hash_value = hashValue;
+	ct->size = sizeof(CatCTup) + ct->tuple.t_len;
 
 	DLAddHead(&cache->cc_bucket[hashIndex], &ct->cache_elem);
+	DLAddHead(&CacheHdr->ch_lrulist, &ct->lru_elem);
 
 	cache->cc_ntup++;
 	CacheHdr->ch_ntup++;
+	CacheHdr->ch_nbytes += ct->size;
+	if (negative)
+		CacheHdr->ch_negtup++;
+
+	CatCacheEnforceLimits(ct);
 
 	return ct;
 }
 
+/*
+ * CatCacheEnforceLimits
+ *		Evict cold entries when a cache bound is configured.
+ *
+ * Called after adding an entry.  Walks the global LRU list from the cold
+ * end, removing unreferenced entries until the configured memory budget is
+ * met, and pruning negative entries beyond their own limit.  The entry
+ * just added is never touched, so callers can keep using it even when its
+ * refcount is still zero (negative entries).
+ */
+static void
+CatCacheEnforceLimits(CatCTup *protect)
+{
+	long		byte_limit = (long) gp_catcache_memory_limit_kb * 1024L;
+	Dlelem	   *elt;
+	Dlelem	   *prev;
+
+	if (gp_catcache_memory_limit_kb <= 0 &&
+		gp_catcache_negative_entry_limit <= 0)
+		return;
+
+	for (elt = DLGetTail(&CacheHdr->ch_lrulist); elt != NULL; elt = prev)
+	{
+		CatCTup    *ct = (CatCTup *) DLE_VAL(elt);
+		bool		evict = false;
+
+		prev = DLGetPred(elt);
+
+		if (gp_catcache_memory_limit_kb > 0 &&
+			CacheHdr->ch_nbytes > byte_limit)
+			evict = true;
+		else if (gp_catcache_negative_entry_limit > 0 &&
+				 CacheHdr->ch_negtup > gp_catcache_negative_entry_limit)
+		{
+			if (!ct->negative)
+				continue;
+			evict = true;
+		}
+		else
+			break;				/* both limits satisfied */
+
+		if (!evict)
+			break;
+
+		/*
+		 * Skip entries that are in use, members of a CatCList, or already
+		 * dead (those are removed when their refcount drops), and the
+		 * entry we were called for.
+		 */
+		if (ct == protect || ct->refcount != 0 || ct->c_list != NULL ||
+			ct->dead)
+			continue;
+
+		if (ct->negative)
+			CacheHdr->ch_negprunes++;
+		CacheHdr->ch_evictions++;
+		CatCacheRemoveCTup(ct->my_cache, ct);
+	}
+}
+
+/*
+ * GetCatCacheStatistics
+ *		Report the session's catalog cache size and eviction counters.
+ */
+void
+GetCatCacheStatistics(CatCacheStats *stats)
+{
+	MemSet(stats, 0, sizeof(CatCacheStats));
+
+	if (CacheHdr == NULL)
+		return;
+
+	stats->entries = CacheHdr->ch_ntup;
+	stats->negative_entries = CacheHdr->ch_negtup;
+	stats->bytes = CacheHdr->ch_nbytes;
+	stats->evictions = CacheHdr->ch_evictions;
+	stats->negative_prunes = CacheHdr->ch_negprunes;
+}
+
 /*
  * build_dummy_tuple
  *		Generate a palloc'd HeapTuple that contains the specified key
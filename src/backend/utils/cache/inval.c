@@ -754,6 +754,31 @@ AcceptInvalidationMessages(void)
 #endif
 }
 
+/*
+ * xactHasInvalidationMessages
+ *		Detect whether the current transaction (at any nesting level) has
+ *		registered any invalidation messages, i.e. has modified catalogs.
+ *
+ * Used by callers that must not proceed on the basis of relcache entries
+ * that may reflect uncommitted catalog state.
+ */
+bool
+xactHasInvalidationMessages(void)
+{
+	TransInvalidationInfo *myInfo;
+
+	for (myInfo = transInvalInfo; myInfo != NULL; myInfo = myInfo->parent)
+	{
+		if (myInfo->CurrentCmdInvalidMsgs.cclist != NULL ||
+			myInfo->CurrentCmdInvalidMsgs.rclist != NULL ||
+			myInfo->PriorCmdInvalidMsgs.cclist != NULL ||
+			myInfo->PriorCmdInvalidMsgs.rclist != NULL)
+			return true;
+	}
+
+	return false;
+}
+
 /*
  * AtStart_Inval
  *		Initialize inval lists at start of a main transaction.
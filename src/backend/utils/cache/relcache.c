@@ -29,6 +29,7 @@
 #include "postgres.h"
 
 #include <sys/file.h>
+#include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
 
@@ -97,6 +98,15 @@
 
 #define RELCACHE_INIT_FILEMAGIC		0x773265	/* version ID value */
 
+/*
+ *		name of the optional per-database user-relation init file, written
+ *		on request by gp_relcache_write_user_init_file() and loaded (if
+ *		present) at backend startup; see write_relcache_init_file
+ */
+#define RELCACHE_USER_INIT_FILENAME	"pg_internal.usr.init"
+
+#define RELCACHE_USER_INIT_FILEMAGIC	0x773266	/* version ID value */
+
 /*
  *		hardcoded tuple descriptors, generated by genbki.pl
  */
@@ -152,6 +162,14 @@ static long relcacheInvalsReceived = 0L;
  */
 static List *initFileRelationIds = NIL;
 
+/*
+ * Ditto for the non-shared relations cached in the database's user-relation
+ * init file, if one has been written.  Kept separate from the list above so
+ * that loading the user file cannot upset the nailed-entry cross-checks on
+ * the regular file.
+ */
+static List *userInitFileRelationIds = NIL;
+
 /*
  * This flag lets us optimize away work in AtEO(Sub)Xact_RelationCache().
  */
@@ -222,8 +240,8 @@ static void RelationClearRelation(Relation relation, bool rebuild);
 
 static void RelationReloadIndexInfo(Relation relation);
 static void RelationFlushRelation(Relation relation);
-static bool load_relcache_init_file(bool shared);
-static void write_relcache_init_file(bool shared);
+static bool load_relcache_init_file(bool shared, bool user);
+static int	write_relcache_init_file(bool shared, bool user);
 static void write_item(const void *data, Size len, FILE *fp);
 
 static void formrdesc(const char *relationName, Oid relationReltype,
@@ -3002,7 +3020,7 @@ RelationCacheInitializePhase2(void)
 	 * Try to load the shared relcache cache file.	If unsuccessful, bootstrap
 	 * the cache with pre-made descriptors for the critical shared catalogs.
 	 */
-	if (!load_relcache_init_file(true))
+	if (!load_relcache_init_file(true, false))
 	{
 		formrdesc("pg_database", DatabaseRelation_Rowtype_Id, true,
 				  true, Natts_pg_database, Desc_pg_database);
@@ -3064,7 +3082,7 @@ RelationCacheInitializePhase3(void)
 	 * catalogs.
 	 */
 	if (IsBootstrapProcessingMode() ||
-		!load_relcache_init_file(false))
+		!load_relcache_init_file(false, false))
 	{
 		needNewCacheFile = true;
 
@@ -3169,6 +3187,20 @@ RelationCacheInitializePhase3(void)
 		criticalSharedRelcachesBuilt = true;
 	}
 
+	/*
+	 * If an administrator has snapshotted frequently used user relations
+	 * into this database's user-relation init file (see
+	 * gp_relcache_write_user_init_file), preload those entries too, so that
+	 * the first queries of a fresh pooled connection need not rebuild them
+	 * the hard way.  A missing or broken file is harmless; the entries are
+	 * simply built on first use as usual.  Entries with rules or triggers
+	 * get those rebuilt by the fixup scan below, just like entries from the
+	 * regular init file.
+	 */
+	oldcxt = MemoryContextSwitchTo(CacheMemoryContext);
+	load_relcache_init_file(false, true);
+	MemoryContextSwitchTo(oldcxt);
+
 	/*
 	 * Now, scan all the relcache entries and update anything that might be
 	 * wrong in the results from formrdesc or the relcache cache file. If we
@@ -3295,8 +3327,8 @@ RelationCacheInitializePhase3(void)
 		initFileRelationIds = NIL;
 
 		/* now write the files */
-		write_relcache_init_file(true);
-		write_relcache_init_file(false);
+		(void) write_relcache_init_file(true, false);
+		(void) write_relcache_init_file(false, false);
 	}
 }
 
@@ -4148,10 +4180,16 @@ RelationGetExclusionInfo(Relation indexRelation,
  * criticalSharedRelcachesBuilt to true.
  * If not successful, return FALSE.
  *
+ * If 'user' is true, load the optional user-relation init file instead
+ * (shared must be false).  That file carries ordinary user relations, so
+ * each record additionally includes the constraint/default info, the GpPolicy,
+ * and the pg_appendonly tuple that RelationBuildDesc would have fetched; no
+ * nailed entries are expected and the critical-relcache flags are untouched.
+ *
  * NOTE: we assume we are already switched into CacheMemoryContext.
  */
 static bool
-load_relcache_init_file(bool shared)
+load_relcache_init_file(bool shared, bool user)
 {
 	FILE	   *fp;
 	char		initfilename[MAXPGPATH];
@@ -4164,7 +4202,12 @@ load_relcache_init_file(bool shared)
 				magic;
 	int			i;
 
-	if (shared)
+	Assert(!(shared && user));
+
+	if (user)
+		snprintf(initfilename, sizeof(initfilename), "%s/%s",
+				 DatabasePath, RELCACHE_USER_INIT_FILENAME);
+	else if (shared)
 		snprintf(initfilename, sizeof(initfilename), "global/%s",
 				 RELCACHE_INIT_FILENAME);
 	else
@@ -4188,7 +4231,7 @@ load_relcache_init_file(bool shared)
 	/* check for correct magic number (compatible version) */
 	if (fread(&magic, 1, sizeof(magic), fp) != sizeof(magic))
 		goto read_failed;
-	if (magic != RELCACHE_INIT_FILEMAGIC)
+	if (magic != (user ? RELCACHE_USER_INIT_FILEMAGIC : RELCACHE_INIT_FILEMAGIC))
 		goto read_failed;
 
 	for (relno = 0;; relno++)
@@ -4198,6 +4241,12 @@ load_relcache_init_file(bool shared)
 		Relation	rel;
 		Form_pg_class relform;
 		bool		has_not_null;
+		uint16		ndef = 0;
+		uint16		ncheck = 0;
+		AttrDefault *defval = NULL;
+		ConstrCheck *check = NULL;
+		GpPolicy   *policy = NULL;
+		HeapTuple	aotuple = NULL;
 
 		/* first read the relation descriptor length */
 		nread = fread(&len, 1, sizeof(len), fp);
@@ -4225,6 +4274,10 @@ load_relcache_init_file(bool shared)
 		if (fread(rel, 1, len, fp) != len)
 			goto read_failed;
 
+		/* user files must contain only ordinary, non-nailed relations */
+		if (user && (rel->rd_id < FirstNormalObjectId || rel->rd_isnailed))
+			goto read_failed;
+
 		/* next read the relation tuple form */
 		if (fread(&len, 1, sizeof(len), fp) != sizeof(len))
 			goto read_failed;
@@ -4273,12 +4326,69 @@ load_relcache_init_file(bool shared)
 			rel->rd_options = NULL;
 		}
 
-		/* mark not-null status */
-		if (has_not_null)
+		/*
+		 * User-relation files additionally carry the column defaults and
+		 * check constraints that RelationBuildTupleDesc would have fetched
+		 * from pg_attrdef and pg_constraint.
+		 */
+		if (user)
+		{
+			if (fread(&len, 1, sizeof(len), fp) != sizeof(len))
+				goto read_failed;
+			if (len != sizeof(ndef))
+				goto read_failed;
+			if (fread(&ndef, 1, len, fp) != len)
+				goto read_failed;
+			if (ndef > 0)
+				defval = (AttrDefault *) palloc(ndef * sizeof(AttrDefault));
+			for (i = 0; i < ndef; i++)
+			{
+				if (fread(&len, 1, sizeof(len), fp) != sizeof(len))
+					goto read_failed;
+				if (len != sizeof(AttrNumber))
+					goto read_failed;
+				if (fread(&defval[i].adnum, 1, len, fp) != len)
+					goto read_failed;
+				if (fread(&len, 1, sizeof(len), fp) != sizeof(len))
+					goto read_failed;
+				defval[i].adbin = (char *) palloc(len);
+				if (fread(defval[i].adbin, 1, len, fp) != len)
+					goto read_failed;
+			}
+
+			if (fread(&len, 1, sizeof(len), fp) != sizeof(len))
+				goto read_failed;
+			if (len != sizeof(ncheck))
+				goto read_failed;
+			if (fread(&ncheck, 1, len, fp) != len)
+				goto read_failed;
+			if (ncheck > 0)
+				check = (ConstrCheck *) palloc(ncheck * sizeof(ConstrCheck));
+			for (i = 0; i < ncheck; i++)
+			{
+				if (fread(&len, 1, sizeof(len), fp) != sizeof(len))
+					goto read_failed;
+				check[i].ccname = (char *) palloc(len);
+				if (fread(check[i].ccname, 1, len, fp) != len)
+					goto read_failed;
+				if (fread(&len, 1, sizeof(len), fp) != sizeof(len))
+					goto read_failed;
+				check[i].ccbin = (char *) palloc(len);
+				if (fread(check[i].ccbin, 1, len, fp) != len)
+					goto read_failed;
+			}
+		}
+
+		/* mark not-null/constraint status */
+		if (has_not_null || ndef > 0 || ncheck > 0)
 		{
 			TupleConstr *constr = (TupleConstr *) palloc0(sizeof(TupleConstr));
 
-			constr->has_not_null = true;
+			constr->has_not_null = has_not_null;
+			constr->defval = defval;
+			constr->num_defval = ndef;
+			constr->check = check;
+			constr->num_check = ncheck;
 			rel->rd_att->constr = constr;
 		}
 
@@ -4405,6 +4515,42 @@ load_relcache_init_file(bool shared)
 			Assert(rel->rd_indoption == NULL);
 		}
 
+		/*
+		 * User-relation files also carry the GpPolicy (zero length if none)
+		 * and, for append-only relations, the pg_appendonly tuple, since
+		 * both are fetched eagerly by RelationBuildDesc and consulted
+		 * directly by callers.
+		 */
+		if (user)
+		{
+			if (fread(&len, 1, sizeof(len), fp) != sizeof(len))
+				goto read_failed;
+			if (len > 0)
+			{
+				if (len < sizeof(GpPolicy))
+					goto read_failed;
+				policy = (GpPolicy *) palloc(len);
+				if (fread(policy, 1, len, fp) != len)
+					goto read_failed;
+				/* fix up internal pointer into the trailing attr array */
+				if (policy->nattrs > 0)
+					policy->attrs = (AttrNumber *) ((char *) policy + sizeof(GpPolicy));
+				else
+					policy->attrs = NULL;
+			}
+
+			if (fread(&len, 1, sizeof(len), fp) != sizeof(len))
+				goto read_failed;
+			if (len > 0)
+			{
+				aotuple = (HeapTuple) palloc(len);
+				if (fread(aotuple, 1, len, fp) != len)
+					goto read_failed;
+				/* Fix up internal pointers in the tuple -- see heap_copytuple */
+				aotuple->t_data = (HeapTupleHeader) ((char *) aotuple + HEAPTUPLESIZE);
+			}
+		}
+
 		/*
 		 * Rules and triggers are not saved (mainly because the internal
 		 * format is complex and subject to change).  They must be rebuilt if
@@ -4437,8 +4583,13 @@ load_relcache_init_file(bool shared)
 		rel->rd_newRelfilenodeSubid = InvalidSubTransactionId;
 		rel->rd_amcache = NULL;
 		MemSet(&rel->pgstat_info, 0, sizeof(rel->pgstat_info));
-        rel->rd_cdbpolicy = NULL;
+        rel->rd_cdbpolicy = policy;
         rel->rd_cdbDefaultStatsWarningIssued = false;
+		rel->rd_aotuple = aotuple;
+		if (aotuple != NULL)
+			rel->rd_appendonly = (Form_pg_appendonly) GETSTRUCT(aotuple);
+		else
+			rel->rd_appendonly = NULL;
 
 		/*
 		 * Recompute lock and physical addressing info.  This is needed in
@@ -4454,7 +4605,12 @@ load_relcache_init_file(bool shared)
 	 * get the right number of nailed items?  (This is a useful crosscheck in
 	 * case the set of critical rels or indexes changes.)
 	 */
-	if (shared)
+	if (user)
+	{
+		if (nailed_rels != 0 || nailed_indexes != 0)
+			goto read_failed;
+	}
+	else if (shared)
 	{
 		if (nailed_rels != NUM_CRITICAL_SHARED_RELS ||
 			nailed_indexes != NUM_CRITICAL_SHARED_INDEXES)
@@ -4476,7 +4632,10 @@ load_relcache_init_file(bool shared)
 	{
 		RelationCacheInsert(rels[relno]);
 		/* also make a list of their OIDs, for RelationIdIsInInitFile */
-		if (!shared)
+		if (user)
+			userInitFileRelationIds = lcons_oid(RelationGetRelid(rels[relno]),
+												userInitFileRelationIds);
+		else if (!shared)
 			initFileRelationIds = lcons_oid(RelationGetRelid(rels[relno]),
 											initFileRelationIds);
 	}
@@ -4486,7 +4645,7 @@ load_relcache_init_file(bool shared)
 
 	if (shared)
 		criticalSharedRelcachesBuilt = true;
-	else
+	else if (!user)
 		criticalRelcachesBuilt = true;
 	return true;
 
@@ -4505,9 +4664,21 @@ read_failed:
 /*
  * Write out a new initialization file with the current contents
  * of the relcache (either shared rels or local rels, as indicated).
+ *
+ * If 'user' is true, write the user-relation init file instead: ordinary
+ * non-temp user relations currently in the relcache, together with the
+ * constraint, GpPolicy and pg_appendonly info the regular file omits.
+ * Unlike the regular files, which are written during backend startup before
+ * any commands have run, the user file is written mid-session on request,
+ * so we hold RelCacheInitLock across the whole dump: after
+ * AcceptInvalidationMessages our entries are current, and any catalog
+ * change committed after we release the lock will unlink the file again
+ * via RelationCacheInitFilePreInvalidate.
+ *
+ * Returns the number of relcache entries written.
  */
-static void
-write_relcache_init_file(bool shared)
+static int
+write_relcache_init_file(bool shared, bool user)
 {
 	FILE	   *fp;
 	char		tempfilename[MAXPGPATH];
@@ -4517,13 +4688,24 @@ write_relcache_init_file(bool shared)
 	RelIdCacheEnt *idhentry;
 	MemoryContext oldcxt;
 	int			i;
+	int			count = 0;
+	List	   *newUserIds = NIL;
+
+	Assert(!(shared && user));
 
 	/*
 	 * We must write a temporary file and rename it into place. Otherwise,
 	 * another backend starting at about the same time might crash trying to
 	 * read the partially-complete file.
 	 */
-	if (shared)
+	if (user)
+	{
+		snprintf(tempfilename, sizeof(tempfilename), "%s/%s.%d",
+				 DatabasePath, RELCACHE_USER_INIT_FILENAME, MyProcPid);
+		snprintf(finalfilename, sizeof(finalfilename), "%s/%s",
+				 DatabasePath, RELCACHE_USER_INIT_FILENAME);
+	}
+	else if (shared)
 	{
 		snprintf(tempfilename, sizeof(tempfilename), "global/%s.%d",
 				 RELCACHE_INIT_FILENAME, MyProcPid);
@@ -4538,6 +4720,13 @@ write_relcache_init_file(bool shared)
 				 DatabasePath, RELCACHE_INIT_FILENAME);
 	}
 
+	if (user)
+	{
+		/* serialize against init file removal, and bring entries up to date */
+		LWLockAcquire(RelCacheInitLock, LW_EXCLUSIVE);
+		AcceptInvalidationMessages();
+	}
+
 	unlink(tempfilename);		/* in case it exists w/wrong permissions */
 
 	fp = AllocateFile(tempfilename, PG_BINARY_W);
@@ -4547,19 +4736,21 @@ write_relcache_init_file(bool shared)
 		 * We used to consider this a fatal error, but we might as well
 		 * continue with backend startup ...
 		 */
+		if (user)
+			LWLockRelease(RelCacheInitLock);
 		ereport(WARNING,
 				(errcode_for_file_access(),
 				 errmsg("could not create relation-cache initialization file \"%s\": %m",
 						tempfilename),
 			  errdetail("Continuing anyway, but there's something wrong.")));
-		return;
+		return 0;
 	}
 
 	/*
 	 * Write a magic number to serve as a file version identifier.	We can
 	 * change the magic number whenever the relcache layout changes.
 	 */
-	magic = RELCACHE_INIT_FILEMAGIC;
+	magic = user ? RELCACHE_USER_INIT_FILEMAGIC : RELCACHE_INIT_FILEMAGIC;
 	if (fwrite(&magic, 1, sizeof(magic), fp) != sizeof(magic))
 		elog(FATAL, "could not write init file");
 
@@ -4577,6 +4768,40 @@ write_relcache_init_file(bool shared)
 		if (relform->relisshared != shared)
 			continue;
 
+		if (user)
+		{
+			/*
+			 * Only ordinary, valid, non-temp user relations with storage
+			 * qualify; anything created or rewritten by the current
+			 * transaction reflects uncommitted state and must be skipped.
+			 */
+			if (RelationGetRelid(rel) < FirstNormalObjectId)
+				continue;
+			if (rel->rd_istemp || !rel->rd_isvalid)
+				continue;
+			if (rel->rd_createSubid != InvalidSubTransactionId ||
+				rel->rd_newRelfilenodeSubid != InvalidSubTransactionId)
+				continue;
+			switch (relform->relkind)
+			{
+				case RELKIND_RELATION:
+				case RELKIND_INDEX:
+				case RELKIND_TOASTVALUE:
+				case RELKIND_AOSEGMENTS:
+				case RELKIND_AOBLOCKDIR:
+				case RELKIND_AOVISIMAP:
+					break;
+				default:
+					continue;
+			}
+		}
+		else
+		{
+			/* the regular files carry system catalogs only */
+			if (RelationGetRelid(rel) >= FirstNormalObjectId)
+				continue;
+		}
+
 		/* first write the relcache entry proper */
 		write_item(rel, sizeof(RelationData), fp);
 
@@ -4594,6 +4819,30 @@ write_relcache_init_file(bool shared)
 				   (rel->rd_options ? VARSIZE(rel->rd_options) : 0),
 				   fp);
 
+		/* for user relations, the column defaults and check constraints */
+		if (user)
+		{
+			TupleConstr *constr = rel->rd_att->constr;
+			uint16		ndef = constr ? constr->num_defval : 0;
+			uint16		ncheck = constr ? constr->num_check : 0;
+
+			write_item(&ndef, sizeof(ndef), fp);
+			for (i = 0; i < ndef; i++)
+			{
+				write_item(&constr->defval[i].adnum, sizeof(AttrNumber), fp);
+				write_item(constr->defval[i].adbin,
+						   strlen(constr->defval[i].adbin) + 1, fp);
+			}
+			write_item(&ncheck, sizeof(ncheck), fp);
+			for (i = 0; i < ncheck; i++)
+			{
+				write_item(constr->check[i].ccname,
+						   strlen(constr->check[i].ccname) + 1, fp);
+				write_item(constr->check[i].ccbin,
+						   strlen(constr->check[i].ccbin) + 1, fp);
+			}
+		}
+
 		/* If it's an index, there's more to do */
 		if (rel->rd_rel->relkind == RELKIND_INDEX)
 		{
@@ -4634,19 +4883,67 @@ write_relcache_init_file(bool shared)
 					   fp);
 		}
 
+		/* for user relations, the GpPolicy and the pg_appendonly tuple */
+		if (user)
+		{
+			write_item(rel->rd_cdbpolicy,
+					   (rel->rd_cdbpolicy ?
+						sizeof(GpPolicy) +
+						rel->rd_cdbpolicy->nattrs * sizeof(AttrNumber) : 0),
+					   fp);
+
+			/* we assume this was created by heap_copytuple! */
+			write_item(rel->rd_aotuple,
+					   (rel->rd_aotuple ?
+						HEAPTUPLESIZE + rel->rd_aotuple->t_len : 0),
+					   fp);
+		}
+
 		/* also make a list of their OIDs, for RelationIdIsInInitFile */
-		if (!shared)
+		if (user)
+		{
+			oldcxt = MemoryContextSwitchTo(CacheMemoryContext);
+			newUserIds = lcons_oid(RelationGetRelid(rel), newUserIds);
+			MemoryContextSwitchTo(oldcxt);
+		}
+		else if (!shared)
 		{
 			oldcxt = MemoryContextSwitchTo(CacheMemoryContext);
 			initFileRelationIds = lcons_oid(RelationGetRelid(rel),
 											initFileRelationIds);
 			MemoryContextSwitchTo(oldcxt);
 		}
+
+		count++;
 	}
 
 	if (FreeFile(fp))
 		elog(FATAL, "could not write init file");
 
+	if (user)
+	{
+		/*
+		 * We have held RelCacheInitLock since before the scan, so what we
+		 * wrote cannot be stale: our entries were current as of the
+		 * AcceptInvalidationMessages above, and nobody can have unlinked
+		 * the file underneath us in the meantime.
+		 */
+		if (rename(tempfilename, finalfilename) < 0)
+		{
+			unlink(tempfilename);
+			list_free(newUserIds);
+		}
+		else
+		{
+			list_free(userInitFileRelationIds);
+			userInitFileRelationIds = newUserIds;
+		}
+
+		LWLockRelease(RelCacheInitLock);
+
+		return count;
+	}
+
 	/*
 	 * Now we have to check whether the data we've so painstakingly
 	 * accumulated is already obsolete due to someone else's just-committed
@@ -4688,6 +4985,34 @@ write_relcache_init_file(bool shared)
 	}
 
 	LWLockRelease(RelCacheInitLock);
+
+	return count;
+}
+
+/*
+ * RelationCacheWriteUserInitFile
+ *
+ * Snapshot the user relations currently in this backend's relcache into the
+ * database's user-relation init file, to be preloaded by future backends at
+ * startup.  An administrator warms a session with a representative workload
+ * (or simply opens the hot relations) and then calls
+ * gp_relcache_write_user_init_file(), which lands here.
+ *
+ * We refuse to run in a transaction that has already modified catalogs: such
+ * relcache entries may reflect uncommitted state, and an abort would leave
+ * the file stale with no invalidation to unlink it.
+ *
+ * Returns the number of relcache entries written.
+ */
+int
+RelationCacheWriteUserInitFile(void)
+{
+	if (xactHasInvalidationMessages())
+		ereport(ERROR,
+				(errcode(ERRCODE_ACTIVE_SQL_TRANSACTION),
+				 errmsg("cannot write relation cache user init file in a transaction that has modified catalogs")));
+
+	return write_relcache_init_file(false, true);
 }
 
 /* write a chunk of data preceded by its length */
@@ -4708,11 +5033,39 @@ write_item(const void *data, Size len, FILE *fp)
  * would choose to store the same set of relations in the init file;
  * otherwise there are cases where we'd fail to detect the need for an init
  * file invalidation.  This does not seem likely to be a problem in practice.
+ *
+ * That assumption does NOT hold for the user-relation init file: its
+ * contents are whatever relcache entries the snapshotting session happened
+ * to hold, and a backend that started before the snapshot was taken (or
+ * that simply never loaded it) has an empty userInitFileRelationIds list.
+ * If such a backend commits DDL against a snapshotted relation and we
+ * answered from the local list alone, the file would never be unlinked and
+ * every later backend would preload a stale entry with no sinval message
+ * to correct it.  So for user relations not found in the lists, be
+ * conservative: report true whenever the user init file exists on disk.
+ * The cost of a false positive is unlinking a file the relation isn't in,
+ * which is harmless (the administrator re-snapshots to get it back).
  */
 bool
 RelationIdIsInInitFile(Oid relationId)
 {
-	return list_member_oid(initFileRelationIds, relationId);
+	if (list_member_oid(initFileRelationIds, relationId) ||
+		list_member_oid(userInitFileRelationIds, relationId))
+		return true;
+
+	if (relationId >= FirstNormalObjectId)
+	{
+		char		initfilename[MAXPGPATH];
+		struct stat st;
+
+		snprintf(initfilename, sizeof(initfilename), "%s/%s",
+				 DatabasePath, RELCACHE_USER_INIT_FILENAME);
+
+		if (stat(initfilename, &st) == 0)
+			return true;
+	}
+
+	return false;
 }
 
 /*
@@ -4768,6 +5121,25 @@ RelationCacheInitFilePreInvalidate(void)
 					 errmsg("could not remove cache file \"%s\": %m",
 							initfilename)));
 	}
+
+	/*
+	 * Zap the user-relation init file too.  We cannot tell here which of the
+	 * two files the invalidated relation belongs to, so remove both; the
+	 * regular file is rebuilt automatically by the next backend to start,
+	 * while the user file stays gone until an administrator snapshots it
+	 * again.
+	 */
+	snprintf(initfilename, sizeof(initfilename), "%s/%s",
+			 DatabasePath, RELCACHE_USER_INIT_FILENAME);
+
+	if (unlink(initfilename) < 0)
+	{
+		if (errno != ENOENT)
+			ereport(ERROR,
+					(errcode_for_file_access(),
+					 errmsg("could not remove cache file \"%s\": %m",
+							initfilename)));
+	}
 }
 
 void
@@ -4848,10 +5220,13 @@ RelationCacheInitFileRemoveInDir(const char *tblspcpath)
 	{
 		if (strspn(de->d_name, "0123456789") == strlen(de->d_name))
 		{
-			/* Try to remove the init file in each database */
+			/* Try to remove the init files in each database */
 			snprintf(initfilename, sizeof(initfilename), "%s/%s/%s",
 					 tblspcpath, de->d_name, RELCACHE_INIT_FILENAME);
 			unlink_initfile(initfilename);
+			snprintf(initfilename, sizeof(initfilename), "%s/%s/%s",
+					 tblspcpath, de->d_name, RELCACHE_USER_INIT_FILENAME);
+			unlink_initfile(initfilename);
 		}
 	}
 
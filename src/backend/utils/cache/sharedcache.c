@@ -641,6 +641,102 @@ Cache_Insert(Cache *cache, CacheEntry *entry)
 			&cacheStats->maxTimeInsert);
 }
 
+/*
+ * Look up a cached entry by key.
+ *
+ * key points to a client key of keySize bytes, as configured at cache
+ * creation time. If an entry with a matching key is found in state CACHED,
+ * it is pinned, registered for cleanup and returned. The caller must
+ * release it with Cache_Release when done.
+ *
+ * Returns NULL if no matching cached entry exists.
+ */
+CacheEntry *
+Cache_Lookup(Cache *cache, const void *key)
+{
+	Assert(NULL != cache);
+	Assert(NULL != key);
+
+	Cache_Stats *cacheStats = &cache->cacheHdr->cacheStats;
+	Cache_AddPerfCounter(&cacheStats->noLookups, 1 /* delta */);
+
+	uint32 hashvalue = cache->hash((void *) key, cache->cacheHdr->keySize);
+
+	volatile CacheAnchor *anchor = SyncHTLookup(cache->syncHashtable, &hashvalue);
+	if (NULL == anchor)
+	{
+		/* No cached entries with this hashvalue */
+		return NULL;
+	}
+
+	/* Acquire anchor lock to touch the chain */
+	SpinLockAcquire(&anchor->spinlock);
+
+	CacheEntry *crtEntry = anchor->firstEntry;
+	while (NULL != crtEntry)
+	{
+		if (crtEntry->state == CACHE_ENTRY_CACHED &&
+			crtEntry->hashvalue == hashvalue)
+		{
+			Cache_AddPerfCounter(&cacheStats->noCompares, 1 /* delta */);
+
+			void *payload = CACHE_ENTRY_PAYLOAD(crtEntry);
+			void *entryKey = (void *) ((char *) payload + cache->cacheHdr->keyOffset);
+
+			if (cache->match(entryKey, (void *) key, cache->cacheHdr->keySize) == 0)
+			{
+				Cache_EntryAddRef(cache, crtEntry);
+				break;
+			}
+		}
+		crtEntry = crtEntry->nextEntry;
+	}
+
+	SpinLockRelease(&anchor->spinlock);
+
+	/*
+	 * Releasing anchor to hashtable.
+	 * Ignoring 'removed' return value, both values are valid
+	 */
+	SyncHTRelease(cache->syncHashtable, (void *) anchor);
+
+	if (NULL != crtEntry)
+	{
+		Cache_AddPerfCounter(&cacheStats->noCacheHits, 1 /* delta */);
+		Cache_RegisterCleanup(cache, crtEntry, true /* isCachedEntry */);
+	}
+
+	return crtEntry;
+}
+
+/*
+ * Synchronized version of Cache_Remove for concurrent eviction.
+ *
+ * Atomically transitions the entry from CACHED to DELETED. Returns false
+ * if another client already marked the entry deleted, in which case the
+ * caller must not count the eviction as its own.
+ */
+bool
+Cache_TryRemove(Cache *cache, CacheEntry *entry)
+{
+	Assert(NULL != entry);
+
+	uint32 expected = CACHE_ENTRY_CACHED;
+	int32 casResult =
+	pg_atomic_compare_exchange_u32((pg_atomic_uint32 *)&entry->state, &expected, CACHE_ENTRY_DELETED);
+
+	if (casResult != 1)
+	{
+		return false;
+	}
+
+	Cache_AddPerfCounter(&cache->cacheHdr->cacheStats.noEvicts, 1 /* delta */);
+	Cache_DecPerfCounter(&cache->cacheHdr->cacheStats.noCachedEntries, 1 /* delta */);
+	Cache_AddPerfCounter(&cache->cacheHdr->cacheStats.noDeletedEntries, 1 /* delta */);
+
+	return true;
+}
+
 /*
  * Unlink a cache entry from the chain anchored at a CacheAnchor.
  *
@@ -874,6 +874,35 @@ SearchSysCache(int cacheId,
 	return SearchCatCache(SysCache[cacheId], key1, key2, key3, key4);
 }
 
+/*
+ * SearchSysCacheBatch
+ *
+ *	Look up a whole vector of keys in one call.  Each key behaves as in
+ *	SearchSysCache: tuples[i] is set to the cache copy of the tuple for
+ *	key i, or NULL if there is no match.  Pass NULL for key columns the
+ *	cache does not use.  Every non-NULL result must be released with
+ *	ReleaseSysCache().
+ *
+ *	Cheaper than a SearchSysCache loop because all cache misses share a
+ *	single open/lock/close of the underlying catalog relation.
+ */
+void
+SearchSysCacheBatch(int cacheId,
+					int nitems,
+					const Datum *key1,
+					const Datum *key2,
+					const Datum *key3,
+					const Datum *key4,
+					HeapTuple *tuples)
+{
+	if (cacheId < 0 || cacheId >= SysCacheSize ||
+		!PointerIsValid(SysCache[cacheId]))
+		elog(ERROR, "invalid cache id: %d", cacheId);
+
+	SearchCatCacheBatch(SysCache[cacheId], nitems,
+						key1, key2, key3, key4, tuples);
+}
+
 /*
  * ReleaseSysCache
  *		Release previously grabbed reference count on a tuple
@@ -99,26 +99,17 @@ static Datum fmgr_security_definer(PG_FUNCTION_ARGS);
 static const FmgrBuiltin *
 fmgr_isbuiltin(Oid id)
 {
-	int			low = 0;
-	int			high = fmgr_nbuiltins - 1;
+	uint16		index;
 
-	/*
-	 * Loop invariant: low is the first index that could contain target entry,
-	 * and high is the last index that could contain it.
-	 */
-	while (low <= high)
-	{
-		int			i = (high + low) / 2;
-		const FmgrBuiltin *ptr = &fmgr_builtins[i];
-
-		if (id == ptr->foid)
-			return ptr;
-		else if (id > ptr->foid)
-			low = i + 1;
-		else
-			high = i - 1;
-	}
-	return NULL;
+	/* fast lookup via the Oid index generated along with fmgr_builtins */
+	if (id > fmgr_last_builtin_oid)
+		return NULL;
+
+	index = fmgr_builtin_oid_index[id];
+	if (index == InvalidFmgrBuiltinIndex)
+		return NULL;
+
+	return &fmgr_builtins[index];
 }
 
 /*
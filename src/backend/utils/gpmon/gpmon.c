@@ -19,6 +19,8 @@
 #include "cdb/cdbtm.h"
 #include "cdb/cdbvars.h"
 #include "miscadmin.h"
+#include "storage/shmem.h"
+#include "storage/spin.h"
 
 /* Extern stuff */
 extern const char * show_session_authorization(void);
@@ -41,6 +43,34 @@ struct  {
 
 int64 gpmon_tick = 0;
 
+/*
+ * Shared-memory telemetry ring.
+ *
+ * When gp_gpperfmon_queue_size > 0, backends do not send their gpmon
+ * packets over UDP themselves; gpmon_send() appends them to this ring
+ * (a spinlock-protected memcpy) and the per-host stats sender process
+ * (perfmon_segmentinfo.c) drains the ring and forwards the packets to
+ * the collector in batches.  When the ring is full, packets are dropped
+ * and counted rather than blocking the query.
+ */
+typedef struct GpmonPacketRing
+{
+	slock_t		lock;
+	int			size;			/* number of packet slots */
+	int			head;			/* next slot to write */
+	int			count;			/* packets currently queued */
+	uint64		accepted;		/* packets ever enqueued */
+	uint64		dropped;		/* packets dropped because the ring was full */
+	gpmon_packet_t packets[1];	/* actually 'size' entries */
+} GpmonPacketRing;
+
+static GpmonPacketRing *GpmonRing = NULL;
+
+/* How many packets to copy out of the ring per spinlock acquisition */
+#define GPMON_RING_DRAIN_BATCH 32
+
+static void gpmon_send_udp(gpmon_packet_t *p);
+
 void gpmon_sig_handler(int sig);
 
 void gpmon_sig_handler(int sig) 
@@ -185,16 +215,136 @@ void gpmon_send(gpmon_packet_t* p)
 		}
 	}
 	
+	/*
+	 * If the shared-memory ring is configured, enqueue the packet for the
+	 * stats sender process instead of paying for a sendto() here.
+	 */
+	if (GpmonRing != NULL)
+	{
+		GpmonPacketRing *ring = GpmonRing;
+
+		SpinLockAcquire(&ring->lock);
+		if (ring->count < ring->size)
+		{
+			memcpy(&ring->packets[ring->head], p, sizeof(*p));
+			ring->head = (ring->head + 1) % ring->size;
+			ring->count++;
+			ring->accepted++;
+		}
+		else
+			ring->dropped++;
+		SpinLockRelease(&ring->lock);
+
+		return;
+	}
+
+	gpmon_send_udp(p);
+}
+
+/* Send one packet to the collector over UDP. */
+static void
+gpmon_send_udp(gpmon_packet_t *p)
+{
 	if (gpmon.gxsock > 0) {
 		int n = sizeof(*p);
-		if (n != sendto(gpmon.gxsock, (const char *)p, n, 0, 
-						(struct sockaddr*) &gpmon.gxaddr, 
+		if (n != sendto(gpmon.gxsock, (const char *)p, n, 0,
+						(struct sockaddr*) &gpmon.gxaddr,
 						sizeof(gpmon.gxaddr))) {
 			elog(LOG, "gpmon: cannot send (%m socket %d)", gpmon.gxsock);
 		}
 	}
 }
 
+/* Space needed for the shared-memory telemetry ring, if configured */
+Size
+GpmonShmemSize(void)
+{
+	Size		size = 0;
+
+	if (!gp_enable_gpperfmon || gp_gpperfmon_queue_size <= 0)
+		return size;
+
+	size = add_size(size, offsetof(GpmonPacketRing, packets));
+	size = add_size(size, mul_size(gp_gpperfmon_queue_size,
+								   sizeof(gpmon_packet_t)));
+
+	return size;
+}
+
+/* Allocate and initialize the shared-memory telemetry ring */
+void
+GpmonShmemInit(void)
+{
+	GpmonPacketRing *ring;
+	Size		size = GpmonShmemSize();
+
+	if (size <= 0)
+		return;
+
+	ring = (GpmonPacketRing *) ShmemAlloc(size);
+	if (!ring)
+		ereport(FATAL,
+				(errcode(ERRCODE_OUT_OF_MEMORY),
+				 errmsg("out of shared memory")));
+
+	MemSet(ring, 0, size);
+	SpinLockInit(&ring->lock);
+	ring->size = gp_gpperfmon_queue_size;
+
+	GpmonRing = ring;
+}
+
+/*
+ * Drain the shared-memory telemetry ring, forwarding the queued packets to
+ * the collector over UDP.  Called periodically by the stats sender process;
+ * packets are copied out of the ring in batches so the spinlock is not held
+ * across sendto() calls.  Logs whenever new packets have been lost since
+ * the last drain.
+ */
+void
+gpmon_ring_drain(void)
+{
+	static uint64 dropped_reported = 0;
+	gpmon_packet_t batch[GPMON_RING_DRAIN_BATCH];
+	GpmonPacketRing *ring = GpmonRing;
+	uint64		dropped;
+	int			n;
+	int			i;
+
+	if (ring == NULL)
+		return;
+
+	for (;;)
+	{
+		SpinLockAcquire(&ring->lock);
+		n = Min(ring->count, GPMON_RING_DRAIN_BATCH);
+		for (i = 0; i < n; i++)
+		{
+			int			tail = (ring->head - ring->count + ring->size) % ring->size;
+
+			memcpy(&batch[i], &ring->packets[tail], sizeof(gpmon_packet_t));
+			ring->count--;
+		}
+		dropped = ring->dropped;
+		SpinLockRelease(&ring->lock);
+
+		if (n == 0)
+			break;
+
+		for (i = 0; i < n; i++)
+			gpmon_send_udp(&batch[i]);
+	}
+
+	if (dropped > dropped_reported)
+	{
+		elog(LOG, "gpmon: dropped " UINT64_FORMAT " telemetry packets since start "
+			 "because the shared-memory ring was full; "
+			 "consider raising gp_gpperfmon_queue_size",
+			 dropped);
+		dropped_reported = dropped;
+	}
+}
+
 #define GPMON_QLOG_PACKET_ASSERTS(gpmonPacket) \
 		Assert(gp_enable_gpperfmon && Gp_role == GP_ROLE_DISPATCH); \
 		Assert(gpmonPacket); \
@@ -26,6 +26,7 @@
 #include <fstream/gfile.h>
 #ifdef GPFXDIST
 #include <gpfxdist.h>
+#include <apr_portable.h>
 #endif
 
 #include <errno.h>
@@ -521,7 +522,29 @@ subprocess_open_failed(int* response_code, const char** response_string, char* r
 	return 1;
 }
 
-static int 
+/*
+ * Enlarge the kernel pipe between gpfdist and the transform subprocess
+ * where the platform allows it (Linux pipes default to 64KB). The pipe
+ * is the bounded buffer between the transform stage and the network
+ * stage: with more capacity the transform can run ahead while gpfdist
+ * is busy draining sockets for other sessions, instead of the two
+ * running in blocking lockstep. Failure to resize is not an error, we
+ * simply keep the default capacity.
+ */
+#define SUBPROCESS_PIPE_SIZE	(1 << 20)
+
+static void
+subprocess_set_pipe_size(apr_file_t* pipe)
+{
+#ifdef F_SETPIPE_SZ
+	apr_os_file_t osfd;
+
+	if (pipe && apr_os_file_get(&osfd, pipe) == APR_SUCCESS)
+		(void) fcntl(osfd, F_SETPIPE_SZ, SUBPROCESS_PIPE_SIZE);
+#endif
+}
+
+static int
 subprocess_open(gfile_t* fd, const char* fpath, int for_write, int* rcode, const char** rstring)
 {
 	apr_pool_t*     mp     = fd->transform->mp;
@@ -606,6 +629,11 @@ subprocess_open(gfile_t* fd, const char* fpath, int for_write, int* rcode, const
 		return subprocess_open_failed(rcode, rstring, "subprocess_open: apr_proc_create failed");
 	}
 
+	/* give the pipe room for the child to run ahead of the relay */
+	subprocess_set_pipe_size(fd->transform->for_write ?
+							 fd->transform->proc.in :
+							 fd->transform->proc.out);
+
 	return 0;
 }
 
@@ -3061,6 +3061,14 @@ static int	size_guc_variables;
 
 static bool guc_dirty;			/* TRUE if need to do commit/abort work */
 
+/*
+ * Bumped whenever a GUC value may have changed in this backend.  Lets
+ * consumers that derive state from the full GUC set (such as the QE
+ * connect-option string built by makeOptions()) cache their result and
+ * rebuild it only when something actually moved.
+ */
+int			gp_guc_generation = 0;
+
 static bool reporting_enabled;	/* TRUE to enable GUC_REPORT */
 
 static int	GUCNestLevel = 0;	/* 1 when in main transaction */
@@ -4039,6 +4047,8 @@ ResetAllOptions(void)
 {
 	int			i;
 
+	gp_guc_generation++;
+
 	for (i = 0; i < num_guc_variables; i++)
 	{
 		struct config_generic *gconf = guc_variables[i];
@@ -4284,6 +4294,9 @@ AtEOXact_GUC(bool isCommit, int nestLevel)
 		return;
 	}
 
+	/* values may be restored below */
+	gp_guc_generation++;
+
 	still_dirty = false;
 	for (i = 0; i < num_guc_variables; i++)
 	{
@@ -5015,6 +5028,13 @@ set_config_option(const char *name, const char *value,
 		return false;
 	}
 
+	/*
+	 * Conservatively assume the value will move.  Over-counting (e.g. on a
+	 * failed or no-op assignment) merely costs a cache rebuild.
+	 */
+	if (changeVal)
+		gp_guc_generation++;
+
         /*
          * Check if option can be set by the user.
          */
@@ -6385,6 +6405,9 @@ define_custom_variable(struct config_generic * variable)
 	GucContext	phcontext;
 	struct config_generic **res;
 
+	/* a new variable invalidates anything derived from the full GUC set */
+	gp_guc_generation++;
+
 	/*
 	 * See if there's a placeholder by the same name.
 	 */
@@ -24,6 +24,8 @@
 #include "access/xlog_internal.h"
 #include "cdb/cdbappendonlyam.h"
 #include "cdb/cdbdisp.h"
+#include "cdb/cdbdisp_query.h"
+#include "cdb/cdbrelsize.h"
 #include "cdb/cdbsreh.h"
 #include "cdb/cdbvars.h"
 #include "cdb/memquota.h"
@@ -41,8 +43,10 @@
 #include "storage/proc.h"
 #include "tcop/idle_resource_cleaner.h"
 #include "utils/builtins.h"
+#include "utils/catcache.h"
 #include "utils/guc_tables.h"
 #include "utils/inval.h"
+#include "utils/memaccounting.h"
 #include "utils/resscheduler.h"
 #include "utils/resgroup.h"
 #include "utils/resource_manager.h"
@@ -76,6 +80,7 @@ static const char *assign_optimizer_minidump(const char *newval,
 static bool assign_optimizer(bool newval, bool doit, GucSource source);
 static bool assign_dispatch_log_stats(bool newval, bool doit, GucSource source);
 static bool assign_gp_hashagg_default_nbatches(int newval, bool doit, GucSource source);
+static bool assign_gp_memory_accounting_sample_interval(int newval, bool doit, GucSource source);
 
 /* Helper function for guc setter */
 extern const char *gpvars_assign_gp_resqueue_priority_default_value(const char *newval,
@@ -138,8 +143,11 @@ int			Test_safefswritesize_override = 0;
 int			gp_max_local_distributed_cache = 1024;
 bool		gp_appendonly_verify_block_checksums = true;
 bool		gp_appendonly_verify_write_block = false;
+bool		gp_appendonly_read_prefetch = true;
+int			gp_appendonly_preallocate_len = 8192;
 bool		gp_appendonly_compaction = true;
 int			gp_appendonly_compaction_threshold = 0;
+int			gp_appendonly_compaction_segfile_limit = 0;
 bool		gp_heap_require_relhasoids_match = true;
 bool		Debug_appendonly_rezero_quicklz_compress_scratch = false;
 bool		Debug_appendonly_rezero_quicklz_decompress_scratch = false;
@@ -158,11 +166,13 @@ bool		Debug_datumstream_write_use_small_initial_buffers = false;
 bool		gp_create_table_random_default_distribution = true;
 bool		gp_allow_non_uniform_partitioning_ddl = true;
 bool		gp_enable_exchange_default_partition = false;
+bool		gp_enable_partition_node_cache = true;
 int			dtx_phase2_retry_count = 0;
 
 bool		log_dispatch_stats = false;
 
 int			explain_memory_verbosity = 0;
+int			gp_memory_accounting_sample_interval = 1;
 char	   *memory_profiler_run_id = "none";
 char	   *memory_profiler_dataset_id = "none";
 char	   *memory_profiler_query_id = "none";
@@ -179,6 +189,9 @@ bool		debug_walrepl_syncrep = false;
 bool		debug_walrepl_rcv = false;
 bool		debug_basebackup = false;
 
+/* WAL based replication compression (Master Mirroring) */
+bool		gp_walrepl_compress = false;
+
 /* Latch mechanism debug GUCs */
 bool		debug_latch = false;
 
@@ -216,6 +229,8 @@ bool		gp_encoding_check_locale_compatibility;
 
 int			gp_connection_send_timeout;
 
+int			gp_client_send_buffer_size;
+
 int			WalSendClientTimeout = 30000;		/* 30 seconds. */
 
 char	   *gp_replication_config_filename = NULL;
@@ -282,6 +297,8 @@ int			gp_test_deadlock_hazard_report_level = ERROR;
 bool		gp_cancel_query_print_log;
 int			gp_cancel_query_delay_time;
 bool		vmem_process_interrupt = false;
+int			gp_vmem_lease_chunks = 0;
+int			gp_huge_page_alloc_threshold_mb = 0;
 bool		execute_pruned_plan = false;
 
 /* partitioning GUC */
@@ -330,6 +347,7 @@ bool		gp_enable_multiphase_agg = true;
 bool		gp_enable_preunique = TRUE;
 bool		gp_eager_preunique = FALSE;
 bool		gp_hashagg_streambottom = true;
+bool		gp_enable_block_nestloop = false;
 bool		gp_enable_agg_distinct = true;
 bool		gp_enable_dqa_pruning = true;
 bool		gp_eager_dqa_pruning = FALSE;
@@ -427,6 +445,7 @@ double		optimizer_nestloop_factor;
 double		optimizer_sort_factor;
 
 /* Optimizer hints */
+bool		optimizer_bypass_simple_queries;
 int			optimizer_join_arity_for_associativity_commutativity;
 int         optimizer_array_expansion_threshold;
 int         optimizer_join_order_threshold;
@@ -462,6 +481,8 @@ static char *gp_server_version_string;
 /* Query Metrics */
 bool		gp_enable_query_metrics = false;
 int			gp_instrument_shmem_size = 5120;
+bool		gp_instrument_rdtsc = false;
+int			gp_instrument_timing_interval = 1;
 
 /* Security */
 bool		gp_reject_internal_tcp_conn = true;
@@ -478,7 +499,15 @@ int			writable_external_table_bufsize = 64;
 
 /* Executor */
 bool		gp_enable_mk_sort = true;
+bool		gp_enable_mk_loser_tree = true;
+bool		gp_enable_material_pruning = true;
+bool		gp_enable_mk_radix_sort = true;
+bool		gp_enable_ao_zonemaps = true;
+bool		gp_enable_aocs_batch_read = true;
 bool		gp_enable_motion_mk_sort = true;
+int			gp_mk_sort_threads = 0;
+bool		gp_enable_expr_bytecode = true;
+bool		gp_enable_adaptive_quals = true;
 
 static const struct config_enum_entry gp_log_format_options[] = {
 	{"text", 0},
@@ -686,6 +715,26 @@ struct config_bool ConfigureNamesBool_gp[] =
 		&gp_enable_direct_dispatch,
 		true, NULL, NULL
 	},
+	{
+		{"gp_eager_writer_gang", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Pre-create the writer gang when a session first becomes idle."),
+			gettext_noop("Moves segment connection setup out of the first query's latency."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE
+		},
+		&gp_eager_writer_gang,
+		false, NULL, NULL
+	},
+	{
+		{"gp_hashjoin_bloom_filter", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("In hash joins, filter probe-side tuples through a "
+						 "Bloom filter built over the hash table."),
+			gettext_noop("Only applies to joins that emit no output for "
+						 "unmatched probe-side tuples."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+		},
+		&gp_hashjoin_bloom_filter,
+		true, NULL, NULL
+	},
 	{
 		{"gp_enable_predicate_propagation", PGC_USERSET, QUERY_TUNING_OTHER,
 			gettext_noop("When two expressions are equivalent (such as with "
@@ -706,6 +755,37 @@ struct config_bool ConfigureNamesBool_gp[] =
 		&gp_workfile_checksumming,
 		true, NULL, NULL
 	},
+	{
+		{"gp_workfile_caching", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Allow complete materialized results to be cached as workfile "
+				"sets and reused by later queries with the same plan fingerprint."),
+			gettext_noop("Cached results are invalidated on relation-level changes "
+				"(DDL, truncate, rewrite), not on every DML; intended for static data."),
+			GUC_GPDB_ADDOPT | GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE
+		},
+		&gp_workfile_caching,
+		false, NULL, NULL
+	},
+	{
+		{"gp_workfile_mmap_read", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Serve re-reads of spilled tuplestore files from a memory "
+				"mapping of the file instead of buffered reads."),
+			NULL,
+			GUC_GPDB_ADDOPT | GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE
+		},
+		&gp_workfile_mmap_read,
+		true, NULL, NULL
+	},
+	{
+		{"gp_shareinput_shmem_sync", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Synchronize ShareInputScan slices through shared memory "
+				"and latches instead of fifo files."),
+			NULL,
+			GUC_GPDB_ADDOPT | GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE
+		},
+		&gp_shareinput_shmem_sync,
+		true, NULL, NULL
+	},
 	{
 		{"force_bitmap_table_scan", PGC_USERSET, DEVELOPER_OPTIONS,
 			gettext_noop("Forces bitmap table scan instead of bitmap heap/ao/aoco scan."),
@@ -818,6 +898,16 @@ struct config_bool ConfigureNamesBool_gp[] =
 		true, NULL, NULL
 	},
 
+	{
+		{"gp_enable_block_nestloop", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enable block mode for nested loop joins with an uncorrelated inner plan."),
+			gettext_noop("Batches outer tuples so one inner pass probes the whole batch; "
+						 "the join output order within a batch is not preserved."),
+		},
+		&gp_enable_block_nestloop,
+		false, NULL, NULL
+	},
+
 	{
 		{"gp_enable_groupext_distinct_pruning", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("Enable 3-phase aggregation and join to compute distinct-qualified aggregates"
@@ -921,6 +1011,94 @@ struct config_bool ConfigureNamesBool_gp[] =
 		true, NULL, NULL
 	},
 
+	{
+		{"gp_enable_mk_loser_tree", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Use a loser tree for eligible multi-key merges."),
+			gettext_noop("Applies to reader-backed merges whose keys are all "
+						 "pass-by-value; other merges use the sift-down heap."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+
+		},
+		&gp_enable_mk_loser_tree,
+		true, NULL, NULL
+	},
+
+	{
+		{"gp_enable_mk_radix_sort", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Use a radix sort for single fixed-width integer sort keys."),
+			gettext_noop("Applies to int2, int4, int8 and date keys; other sorts "
+						 "use the comparison-based kernel."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+
+		},
+		&gp_enable_mk_radix_sort,
+		true, NULL, NULL
+	},
+
+	{
+		{"gp_enable_material_pruning", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Store only the columns the consumer references when "
+						 "materializing wide rows."),
+			gettext_noop("Columns not referenced by the parent node are stored "
+						 "as NULLs, cutting spill volume and rescan bandwidth."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+
+		},
+		&gp_enable_material_pruning,
+		true, NULL, NULL
+	},
+
+	{
+		{"gp_enable_ao_zonemaps", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Collect and use per-varblock min/max zone maps for "
+						 "append-only tables with a block directory."),
+			gettext_noop("Zone maps cover the leading column and let scans skip "
+						 "varblocks whose value range excludes the scan quals."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+
+		},
+		&gp_enable_ao_zonemaps,
+		true, NULL, NULL
+	},
+
+	{
+		{"gp_enable_aocs_batch_read", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Read append-only columnar scans through per-column "
+						 "row batches."),
+			gettext_noop("Fills one values vector per projected column in a "
+						 "single pass over its datum stream instead of "
+						 "fetching every column for every row."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+
+		},
+		&gp_enable_aocs_batch_read,
+		true, NULL, NULL
+	},
+
+	{
+		{"gp_enable_expr_bytecode", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Compile expressions into flat bytecode programs."),
+			gettext_noop("Replaces recursive expression tree walking with a "
+						 "linear pass over opcodes for supported node types."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+
+		},
+		&gp_enable_expr_bytecode,
+		true, NULL, NULL
+	},
+
+	{
+		{"gp_enable_adaptive_quals", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Reorder scan quals at runtime by measured cost and selectivity."),
+			gettext_noop("Makes scans robust against planner misestimation; "
+						 "clauses with volatile functions are never reordered."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+
+		},
+		&gp_enable_adaptive_quals,
+		true, NULL, NULL
+	},
+
 	{
 		{"gp_enable_motion_mk_sort", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("Enable multi-key sort in sorted motion recv."),
@@ -1075,6 +1253,16 @@ struct config_bool ConfigureNamesBool_gp[] =
 		false, NULL, NULL
 	},
 
+	{
+		{"gp_appendonly_read_prefetch", PGC_USERSET, APPENDONLY_TABLES,
+			gettext_noop("Hint the kernel to read ahead the next append-only large-read window."),
+			NULL,
+			GUC_NOT_IN_SAMPLE | GUC_NO_SHOW_ALL
+		},
+		&gp_appendonly_read_prefetch,
+		true, NULL, NULL
+	},
+
 	{
 		{"gp_appendonly_compaction", PGC_SUSET, APPENDONLY_TABLES,
 			gettext_noop("Perform append-only compaction instead of eof truncation on vacuum."),
@@ -1154,6 +1342,27 @@ struct config_bool ConfigureNamesBool_gp[] =
 		false, NULL, NULL
 	},
 
+	{
+		{"gp_numa_interleave_shared_memory", PGC_POSTMASTER, RESOURCES_KERNEL,
+			gettext_noop("Interleave the shared memory segment across all NUMA nodes."),
+			gettext_noop("Spreads shared buffers and interconnect receive buffers evenly "
+						 "over the sockets of a multi-node host instead of leaving them "
+						 "on the node the postmaster started on.")
+		},
+		&gp_numa_interleave_shared_memory,
+		false, NULL, NULL
+	},
+
+	{
+		{"gp_numa_backend_affinity", PGC_POSTMASTER, RESOURCES_KERNEL,
+			gettext_noop("Bind each backend to the NUMA node of its buffer freelist partition."),
+			gettext_noop("Backends that allocate from the same buffer freelist partition "
+						 "run on the same socket and prefer memory local to it.")
+		},
+		&gp_numa_backend_affinity,
+		false, NULL, NULL
+	},
+
 	{
 		{"gp_is_writer", PGC_BACKEND, GP_WORKER_IDENTITY,
 			gettext_noop("True in a worker process which can directly update its local database segment."),
@@ -1193,6 +1402,16 @@ struct config_bool ConfigureNamesBool_gp[] =
 		true, NULL, NULL
 	},
 
+	{
+		{"gp_external_chain_urls", PGC_USERSET, EXTERNAL_TABLES,
+			gettext_noop("Each segment drains every gpfdist URL of an external table in turn."),
+			gettext_noop("Levels out completion times when the data is skewed across the URLs."),
+			GUC_GPDB_ADDOPT
+		},
+		&gp_external_chain_urls,
+		false, NULL, NULL
+	},
+
 	{
 		{"gp_enable_fast_sri", PGC_USERSET, QUERY_TUNING_OTHER,
 			gettext_noop("Enable single-slice single-row inserts."),
@@ -1212,6 +1431,16 @@ struct config_bool ConfigureNamesBool_gp[] =
 		false, NULL, NULL
 	},
 
+	{
+		{"gp_interconnect_compress_chunks", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Compress serialized tuple chunk lists before transmission."),
+			NULL,
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+		},
+		&gp_interconnect_compress_chunks,
+		false, NULL, NULL
+	},
+
 	{
 		{"gp_interconnect_log_stats", PGC_USERSET, QUERY_TUNING_OTHER,
 			gettext_noop("Emit statistics from the UDP-IC at the end of every statement."),
@@ -1704,6 +1933,16 @@ struct config_bool ConfigureNamesBool_gp[] =
 		false, NULL, NULL
 	},
 
+	{
+		{"gp_instrument_rdtsc", PGC_USERSET, DEVELOPER_OPTIONS,
+			gettext_noop("Time instrumented plan nodes with the CPU timestamp counter."),
+			gettext_noop("The TSC is calibrated against the system clock once per backend; "
+						 "has no effect on platforms without a usable TSC.")
+		},
+		&gp_instrument_rdtsc,
+		false, NULL, NULL
+	},
+
 	{
 		{"gp_mapreduce_define", PGC_USERSET, DEVELOPER_OPTIONS,
 			gettext_noop("Prepare mapreduce object creation"),	/* turn off statement
@@ -1732,6 +1971,22 @@ struct config_bool ConfigureNamesBool_gp[] =
 		&log_autostats,
 		true, NULL, NULL
 	},
+	{
+		{"gp_autostats_incremental", PGC_USERSET, DEVELOPER_OPTIONS,
+			gettext_noop("Merge the row counts of a completed command into existing statistics instead of issuing a full auto-stats ANALYZE."),
+			gettext_noop("A full ANALYZE is still issued when the target table has no statistics. See gp_autostats_mode.")
+		},
+		&gp_autostats_incremental,
+		false, NULL, NULL
+	},
+	{
+		{"gp_cached_plan_dispatch", PGC_USERSET, DEVELOPER_OPTIONS,
+			gettext_noop("Cache dispatched plans on the QEs of the writer gang and resend only a plan hash on later executions."),
+			gettext_noop("Only plans whose slices all run on the writer gang are eligible.")
+		},
+		&gp_cached_plan_dispatch,
+		false, NULL, NULL
+	},
 	{
 		{"gp_statistics_pullup_from_child_partition", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("This guc enables the planner to utilize statistics from partitions in planning queries on the parent."),
@@ -1807,6 +2062,18 @@ struct config_bool ConfigureNamesBool_gp[] =
 		false, NULL, NULL
 	},
 
+	{
+		{"gp_walrepl_compress", PGC_BACKEND, WAL_REPLICATION,
+			gettext_noop("Compress WAL data streamed to the mirror in WAL based replication (Master Mirroring)."),
+			gettext_noop("Enable on the mirror: the WAL receiver requests compression "
+						 "from the WAL sender at connect time. Requires a server "
+						 "built with LZ4 support; otherwise WAL is sent uncompressed."),
+			GUC_NOT_IN_SAMPLE
+		},
+		&gp_walrepl_compress,
+		false, NULL, NULL
+	},
+
 	{
 		{"debug_basebackup", PGC_SUSET, DEVELOPER_OPTIONS,
 			gettext_noop("Print debug messages for basebackup mechanism (Master Mirroring)."),
@@ -2059,6 +2326,18 @@ struct config_bool ConfigureNamesBool_gp[] =
 		false, NULL, NULL
 	},
 
+	{
+		{"gp_enable_partition_node_cache", PGC_USERSET, DEVELOPER_OPTIONS,
+			gettext_noop("Cache partition descriptor trees across statements."),
+			gettext_noop("Rebuilding the descriptor of a heavily partitioned table from "
+						 "the pg_partition catalogs is expensive; the cache hands out "
+						 "copies of a prebuilt tree until partition DDL invalidates it."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+		},
+		&gp_enable_partition_node_cache,
+		true, NULL, NULL
+	},
+
 	{
 		{"optimizer", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("Enable Pivotal Query Optimizer."),
@@ -2465,6 +2744,17 @@ struct config_bool ConfigureNamesBool_gp[] =
 		false, NULL, NULL
 	},
 
+	{
+		{"optimizer_bypass_simple_queries", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Plan trivially simple queries with the Postgres planner instead of the optimizer."),
+			gettext_noop("A query qualifies if it selects from at most one plain relation, "
+						 "with no joins, aggregates, subqueries or window functions."),
+			GUC_NOT_IN_SAMPLE
+		},
+		&optimizer_bypass_simple_queries,
+		false, NULL, NULL
+	},
+
 	{
 		{"optimizer_force_multistage_agg", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("Force optimizer to always pick multistage aggregates when such a plan alternative is generated."),
@@ -2849,6 +3139,27 @@ struct config_bool ConfigureNamesBool_gp[] =
 
 struct config_int ConfigureNamesInt_gp[] =
 {
+	{
+		{"gp_recovery_prefetch_distance", PGC_POSTMASTER, WAL_SETTINGS,
+			gettext_noop("How far past the replay position recovery scans WAL to prefetch data blocks."),
+			gettext_noop("A value of 0 keeps the lookahead within the WAL page being replayed. "
+						 "Takes effect only when effective_io_concurrency is set."),
+			GUC_UNIT_KB | GUC_NOT_IN_SAMPLE
+		},
+		&gp_recovery_prefetch_distance,
+		0, 0, MAX_KILOBYTES, NULL, NULL
+	},
+
+	{
+		{"gp_appendonly_preallocate_len", PGC_USERSET, APPENDONLY_TABLES,
+			gettext_noop("Preallocate file space this far ahead of the append-only write position."),
+			gettext_noop("A value of 0 turns off preallocation."),
+			GUC_UNIT_KB | GUC_NOT_IN_SAMPLE
+		},
+		&gp_appendonly_preallocate_len,
+		8192, 0, MAX_KILOBYTES, NULL, NULL
+	},
+
 	{
 		{"readable_external_table_timeout", PGC_USERSET, EXTERNAL_TABLES,
 			gettext_noop("Cancel the query if no data read within N seconds."),
@@ -3023,6 +3334,16 @@ struct config_int ConfigureNamesInt_gp[] =
 		10, 0, 100, NULL, NULL
 	},
 
+	{
+		{"gp_appendonly_compaction_segfile_limit", PGC_USERSET, APPENDONLY_TABLES,
+			gettext_noop("Maximum number of segment files compacted per append-only relation"
+						 " during a lazy vacuum."),
+			gettext_noop("Use 0 for no limit.")
+		},
+		&gp_appendonly_compaction_segfile_limit,
+		0, 0, INT_MAX, NULL, NULL
+	},
+
 	{
 		{"gp_workfile_max_entries", PGC_POSTMASTER, RESOURCES,
 			gettext_noop("Sets the maximum number of entries that can be stored in the workfile directory"),
@@ -3128,6 +3449,17 @@ struct config_int ConfigureNamesInt_gp[] =
 		3600, 0, INT_MAX, NULL, NULL
 	},
 
+	{
+		{"gp_client_send_buffer_size", PGC_POSTMASTER, CLIENT_CONN_OTHER,
+			gettext_noop("Sets the size of the buffer used to send results to the client (bytes)."),
+			gettext_noop("A larger buffer batches more row messages into each send system call, "
+						 "which helps sessions that stream large result sets."),
+			GUC_NOT_IN_SAMPLE
+		},
+		&gp_client_send_buffer_size,
+		8192, 8192, 16777216, NULL, NULL
+	},
+
 	{
 		{"max_resource_queues", PGC_POSTMASTER, RESOURCES_MGM,
 			gettext_noop("Maximum number of resource queues."),
@@ -3184,6 +3516,36 @@ struct config_int ConfigureNamesInt_gp[] =
 		4, 1, 4096, NULL, NULL
 	},
 
+	{
+		{"gp_interconnect_compress_threshold", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Sets the minimum serialized size (in bytes) of a chunk list worth compressing."),
+			NULL,
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+		},
+		&gp_interconnect_compress_threshold,
+		1024, 64, INT_MAX, NULL, NULL
+	},
+
+	{
+		{"gp_interconnect_busy_poll_us", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Sets the adaptive busy-poll window ceiling (in us) for the UDP interconnect receive thread."),
+			gettext_noop("Zero disables busy-polling; the receive thread then always sleeps in poll()."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+		},
+		&gp_interconnect_busy_poll_us,
+		0, 0, 1000000, NULL, NULL
+	},
+
+	{
+		{"gp_motion_batch_size", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Sets the number of tuples the motion sender batches per route before sending their chunks."),
+			gettext_noop("Zero disables batching; each tuple's chunks are sent as soon as it is serialized."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+		},
+		&gp_motion_batch_size,
+		0, 0, 4096, NULL, NULL
+	},
+
 	{
 		{"gp_interconnect_snd_queue_depth", PGC_USERSET, GP_ARRAY_TUNING,
 			gettext_noop("Sets the maximum size of the send queue for each connection in the UDP interconnect"),
@@ -3365,6 +3727,39 @@ struct config_int ConfigureNamesInt_gp[] =
 		0, 0, INT_MAX, assign_gp_connections_per_thread, show_gp_connections_per_thread
 	},
 
+	{
+		{"gp_mk_sort_threads", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Number of threads used to sort an in-memory run in mk sort."),
+			gettext_noop("0 or 1 disables threading. Only sorts whose comparators "
+						 "are safe to run outside the main thread are parallelized."),
+			GUC_GPDB_ADDOPT | GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE
+		},
+		&gp_mk_sort_threads,
+		0, 0, 32, NULL, NULL
+	},
+
+	{
+		{"gp_logtape_prefetch_blocks", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Number of blocks of read-ahead advised per logical tape during external merge."),
+			gettext_noop("0 disables the read-ahead hints."),
+			GUC_GPDB_ADDOPT | GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE
+		},
+		&gp_logtape_prefetch_blocks,
+		4, 0, 256, NULL, NULL
+	},
+
+	{
+		{"gp_workfile_discard_threshold", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Size in kilobytes a spill file must reach before its written "
+				"data is discarded from the OS page cache behind the writer."),
+			gettext_noop("Keeps very large spills from evicting the page cache that "
+				"concurrent scans depend on. 0 disables the discard advice."),
+			GUC_GPDB_ADDOPT | GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_UNIT_KB
+		},
+		&gp_workfile_discard_threshold,
+		0, 0, INT_MAX, NULL, NULL
+	},
+
 	{
 		{"gp_subtrans_warn_limit", PGC_POSTMASTER, RESOURCES,
 			gettext_noop("Sets the warning limit on number of subtransactions in a transaction."),
@@ -3547,6 +3942,16 @@ struct config_int ConfigureNamesInt_gp[] =
 		2000, 100, 120000, NULL, NULL
 	},
 
+	{
+		{"gp_gang_max_parallel_connects", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Limits how many segment connect attempts a gang keeps in flight at once."),
+			gettext_noop("A value of zero launches all connections immediately."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE
+		},
+		&gp_gang_max_parallel_connects,
+		0, 0, 1024, NULL, NULL
+	},
+
 	{
 		{"gp_session_id", PGC_BACKEND, CLIENT_CONN_OTHER,
 			gettext_noop("Global ID used to uniquely identify a particular session in an Greenplum Database array"),
@@ -3566,6 +3971,16 @@ struct config_int ConfigureNamesInt_gp[] =
 		0, 0, INT_MAX, NULL, NULL
 	},
 
+	{
+		{"gp_relsize_cache_timeout", PGC_USERSET, QUERY_TUNING_COST,
+			gettext_noop("Seconds a dispatched relation size may be served from the coordinator's shared cache."),
+			gettext_noop("If 0, every relation size request with gp_enable_relsize_collection dispatches to the segments."),
+			GUC_UNIT_S
+		},
+		&gp_relsize_cache_timeout,
+		0, 0, INT_MAX / 1000, NULL, NULL
+	},
+
 	{
 		{"gp_hashjoin_tuples_per_bucket", PGC_USERSET, GP_ARRAY_TUNING,
 			gettext_noop("Target density of hashtable used by Hashjoin during execution"),
@@ -3576,6 +3991,16 @@ struct config_int ConfigureNamesInt_gp[] =
 		5, 1, 25, NULL, NULL
 	},
 
+	{
+		{"gp_hashjoin_spill_batch_size", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Size of the write staging buffer, in kilobytes, for each hash join batch spill file."),
+			gettext_noop("Spilled tuples are accumulated and written in chunks of this size; 0 writes each tuple through individually."),
+			GUC_NOT_IN_SAMPLE | GUC_NO_SHOW_ALL | GUC_GPDB_ADDOPT | GUC_UNIT_KB
+		},
+		&gp_hashjoin_spill_batch_size,
+		64, 0, 16384, NULL, NULL
+	},
+
 	{
 		{"gp_hashagg_groups_per_bucket", PGC_USERSET, GP_ARRAY_TUNING,
 			gettext_noop("Target density of hashtable used by Hashagg during execution"),
@@ -3627,6 +4052,17 @@ struct config_int ConfigureNamesInt_gp[] =
 		1, 1, 3600, gpvars_assign_gp_gpperfmon_send_interval, NULL
 	},
 
+	{
+		{"gp_gpperfmon_queue_size", PGC_POSTMASTER, LOGGING_WHAT,
+			gettext_noop("Sets the number of packet slots in the shared-memory telemetry ring."),
+			gettext_noop("When > 0, backends queue gpmon packets in shared memory and the "
+						 "stats sender process forwards them to the collector in batches; "
+						 "0 sends each packet over UDP directly.")
+		},
+		&gp_gpperfmon_queue_size,
+		0, 0, 1048576, NULL, NULL
+	},
+
 	{
 		{"wal_send_client_timeout", PGC_SIGHUP, GP_ARRAY_TUNING,
 			gettext_noop("The time in milliseconds for a backend process to wait on the WAL Send server to finish a request to the QD mirroring standby."),
@@ -3656,6 +4092,15 @@ struct config_int ConfigureNamesInt_gp[] =
 		5120, 0, 131072, NULL, NULL
 	},
 
+	{
+		{"gp_instrument_timing_interval", PGC_USERSET, DEVELOPER_OPTIONS,
+			gettext_noop("Time only every Nth invocation of an instrumented plan node."),
+			gettext_noop("The total runtime is extrapolated from the timed sample; 1 times every invocation.")
+		},
+		&gp_instrument_timing_interval,
+		1, 1, INT_MAX, NULL, NULL
+	},
+
 	{
 		{"gp_vmem_protect_limit", PGC_POSTMASTER, RESOURCES_MEM,
 			gettext_noop("Virtual memory limit (in MB) of Greenplum memory protection."),
@@ -3679,6 +4124,15 @@ struct config_int ConfigureNamesInt_gp[] =
 		90, 0, 100, NULL, NULL
 	},
 
+	{
+		{"runaway_detector_prespill_percent", PGC_POSTMASTER, RESOURCES_MEM,
+			gettext_noop("Memory-intensive operators are asked to spill cooperatively if the used vmem exceeds this percentage of the vmem quota. Set to 0 to disable pre-spill requests."),
+			NULL,
+		},
+		&runaway_detector_prespill_percent,
+		0, 0, 100, NULL, NULL
+	},
+
 	{
 		{"gp_vmem_protect_segworker_cache_limit", PGC_POSTMASTER, RESOURCES_MEM,
 			gettext_noop("Max virtual memory limit (in MB) for a segworker to be cachable."),
@@ -3727,6 +4181,14 @@ struct config_int ConfigureNamesInt_gp[] =
 		&gp_resqueue_priority_local_interval,
 		100000, 500, INT_MAX, NULL, NULL
 	},
+	{
+		{"gp_resqueue_wait_warning_time", PGC_SUSET, RESOURCES_MGM,
+			gettext_noop("Log statements that waited in their resource queue longer than this (in ms)."),
+			gettext_noop("Zero disables the warning.")
+		},
+		&gp_resqueue_wait_warning_time,
+		0, 0, INT_MAX, NULL, NULL
+	},
 	{
 		{"gp_resqueue_priority_sweeper_interval", PGC_POSTMASTER, RESOURCES_MGM,
 			gettext_noop("Frequency (in ms) at which sweeper process re-evaluates CPU shares."),
@@ -3973,6 +4435,65 @@ struct config_int ConfigureNamesInt_gp[] =
 		&memory_profiler_dataset_size,
 		0, 0, INT_MAX, NULL, NULL
 	},
+
+	{
+		{"gp_vmem_lease_chunks", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Number of extra vmem chunks a backend reserves as a local lease."),
+			gettext_noop("0 charges the shared vmem counters on every chunk boundary; larger "
+						 "values let backends grow within the lease without touching the shared "
+						 "counters, at the cost of idle backends holding up to that many chunks."),
+			GUC_GPDB_ADDOPT | GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE
+		},
+		&gp_vmem_lease_chunks,
+		0, 0, 1024, NULL, NULL
+	},
+
+	{
+		{"gp_huge_page_alloc_threshold_mb", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Back allocations of at least this many MB with explicit huge pages."),
+			gettext_noop("0 disables huge-page backing. Requires huge pages to be provisioned "
+						 "on the host (vm.nr_hugepages); falls back to malloc when none are "
+						 "available."),
+			GUC_GPDB_ADDOPT | GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE
+		},
+		&gp_huge_page_alloc_threshold_mb,
+		0, 0, MAX_KILOBYTES / 1024, NULL, NULL
+	},
+
+	{
+		{"gp_catcache_memory_limit_kb", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Evict cold catalog cache entries above this many kilobytes."),
+			gettext_noop("0 leaves the catalog caches unbounded. Long-lived sessions that "
+						 "touch many objects otherwise grow their caches without limit."),
+			GUC_GPDB_ADDOPT | GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE
+		},
+		&gp_catcache_memory_limit_kb,
+		0, 0, MAX_KILOBYTES, NULL, NULL
+	},
+
+	{
+		{"gp_catcache_negative_entry_limit", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Prune the oldest negative catalog cache entries above this count."),
+			gettext_noop("0 leaves negative entries unbounded."),
+			GUC_GPDB_ADDOPT | GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE
+		},
+		&gp_catcache_negative_entry_limit,
+		0, 0, INT_MAX, NULL, NULL
+	},
+
+	{
+		{"gp_memory_accounting_sample_interval", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Fold allocations into the memory accounting counters only every Nth call."),
+			gettext_noop("1 accounts every allocation exactly; larger values batch consecutive "
+						 "allocations against the same account and reconcile the counters periodically."),
+			GUC_GPDB_ADDOPT | GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE
+		},
+		&gp_memory_accounting_sample_interval,
+		1, 1, 10000,
+		assign_gp_memory_accounting_sample_interval,
+		NULL
+	},
+
 	{
 		{"repl_catchup_within_range", PGC_SUSET, WAL_REPLICATION,
 			gettext_noop("Sets the maximum number of xlog segments allowed to lag"
@@ -4864,6 +5385,22 @@ assign_gp_hashagg_default_nbatches(int newval, bool doit, GucSource source)
 	return true; /* OK */
 }
 
+static bool
+assign_gp_memory_accounting_sample_interval(int newval, bool doit, GucSource source)
+{
+	if (doit)
+	{
+		/*
+		 * Fold any batched deltas into the accounts before the sampling
+		 * interval changes, so that switching back to exact accounting
+		 * never leaves stale pending counters behind.
+		 */
+		MemoryAccounting_Reconcile();
+		gp_memory_accounting_sample_interval = newval;
+	}
+	return true;
+}
+
 /*
  * Malloc a new string representing current storage_opts.
  */
@@ -26,6 +26,58 @@
  */
 uint64 OptimizerOutstandingMemoryBalance = 0;
 
+/*
+ * Cache of recently freed optimizer blocks, retained across optimization
+ * calls.
+ *
+ * ORCA's memory pools obtain their underlying storage through
+ * Ext_OptimizerAlloc in a small number of repeated block sizes, and tear
+ * everything down again when the optimization task finishes.  Short queries
+ * therefore pay the full malloc/free round trip for every pool on every
+ * statement.  We keep a bounded set of freed blocks here, bucketed by exact
+ * size, and satisfy later requests of the same size from the cache.
+ *
+ * Cached blocks remain charged against the vmem tracker (the memory is
+ * still held by this process); memory accounting, in contrast, sees them
+ * as freed and charges the reusing optimizer account again on reuse, so
+ * per-account numbers stay truthful.
+ */
+#define EXT_ALLOC_CACHE_BUCKETS			8
+#define EXT_ALLOC_CACHE_MAX_BLOCK_SIZE	(64 * 1024)
+#define EXT_ALLOC_CACHE_MAX_TOTAL		(1024 * 1024)
+
+typedef struct ExtAllocCachedBlock
+{
+	struct ExtAllocCachedBlock *next;
+} ExtAllocCachedBlock;
+
+typedef struct ExtAllocBucket
+{
+	size_t		size;			/* user size of the blocks held here */
+	ExtAllocCachedBlock *blocks;
+} ExtAllocBucket;
+
+static ExtAllocBucket ExtAllocCache[EXT_ALLOC_CACHE_BUCKETS];
+static size_t ExtAllocCacheTotal = 0;
+
+/*
+ * Batched vmem charging.
+ *
+ * ORCA's pools allocate and free through this module often enough that a
+ * vmem tracker round trip per pointer rivals the cost of the allocation
+ * itself.  Instead of letting gp_malloc charge every pointer, we reserve
+ * vmem ahead in multi-MB leases and sub-allocate from the lease with
+ * gp_malloc_prereserved.  ExtAllocVmemUsed is the vmem actually backing
+ * live blocks (including the cache above, whose blocks stay charged);
+ * ExtAllocVmemReserved is what we have charged to the tracker.  The
+ * surplus is trimmed as blocks are freed and returned wholesale when the
+ * optimizer balance drops to zero, i.e. at optimization task teardown.
+ */
+#define EXT_ALLOC_VMEM_LEASE_BYTES ((int64) (4 * 1024 * 1024))
+
+static int64 ExtAllocVmemUsed = 0;
+static int64 ExtAllocVmemReserved = 0;
+
 /*
  * Allocation & Deallocation functions for GPOS
  *
@@ -35,6 +87,10 @@ uint64 OptimizerOutstandingMemoryBalance = 0;
 void*
 Ext_OptimizerAlloc(size_t size)
 {
+	int			i;
+	int64		vmem_size;
+	void	   *ptr;
+
 #ifdef USE_ASSERT_CHECKING
 	MemoryAccount *account = MemoryAccounting_ConvertIdToAccount(ActiveMemoryAccountId);
 	Assert(account->ownerType == MEMORY_OWNER_TYPE_Optimizer);
@@ -42,7 +98,56 @@ Ext_OptimizerAlloc(size_t size)
 
 	MemoryAccounting_Allocate(ActiveMemoryAccountId, size);
 	OptimizerOutstandingMemoryBalance += size;
-	return gp_malloc(size);
+
+	/* can we reuse a cached block of exactly this size? */
+	for (i = 0; i < EXT_ALLOC_CACHE_BUCKETS; i++)
+	{
+		ExtAllocBucket *bucket = &ExtAllocCache[i];
+
+		if (bucket->size == size && bucket->blocks != NULL)
+		{
+			ExtAllocCachedBlock *block = bucket->blocks;
+
+			bucket->blocks = block->next;
+			ExtAllocCacheTotal -= size;
+			return (void *) block;
+		}
+	}
+
+	/* Top up the vmem lease if this allocation does not fit in it */
+	vmem_size = (int64) UserPtrSize_GetVmemPtrSize(size);
+
+	if (ExtAllocVmemUsed + vmem_size > ExtAllocVmemReserved)
+	{
+		int64		leaseSize = Max(vmem_size, EXT_ALLOC_VMEM_LEASE_BYTES);
+		MemoryAllocationStatus status = VmemTracker_ReserveVmem(leaseSize);
+
+		if (MemoryAllocation_Success != status && leaseSize > vmem_size)
+		{
+			/* Near the limit; retry with just what this allocation needs */
+			leaseSize = vmem_size;
+			status = VmemTracker_ReserveVmem(leaseSize);
+		}
+
+		if (MemoryAllocation_Success != status)
+		{
+			gp_failed_to_alloc(status, 0, vmem_size);
+			return NULL;
+		}
+
+		ExtAllocVmemReserved += leaseSize;
+	}
+
+	ptr = gp_malloc_prereserved(size);
+
+	if (NULL == ptr)
+	{
+		gp_failed_to_alloc(MemoryFailure_SystemMemoryExhausted, 0, vmem_size);
+		return NULL;
+	}
+
+	ExtAllocVmemUsed += vmem_size;
+	return ptr;
 }
 
 void
@@ -50,9 +155,73 @@ Ext_OptimizerFree(void *ptr)
 {
 	void *malloc_pointer = UserPtr_GetVmemPtr(ptr);
 	size_t freed_size = VmemPtr_GetUserPtrSize((VmemHeader*) malloc_pointer);
+	int			i;
+
 	MemoryAccounting_Free(ActiveMemoryAccountId, freed_size);
 	OptimizerOutstandingMemoryBalance -= freed_size;
-	gp_free(ptr);
+
+	/*
+	 * Retain the block for reuse if it is a cacheable size and the cache
+	 * has room.  A bucket is bound to the first size stored in it; with
+	 * the few distinct block sizes ORCA's pools use, the small bucket
+	 * array is enough.
+	 */
+	if (freed_size >= sizeof(ExtAllocCachedBlock) &&
+		freed_size <= EXT_ALLOC_CACHE_MAX_BLOCK_SIZE &&
+		ExtAllocCacheTotal + freed_size <= EXT_ALLOC_CACHE_MAX_TOTAL)
+	{
+		ExtAllocBucket *bucket = NULL;
+
+		for (i = 0; i < EXT_ALLOC_CACHE_BUCKETS; i++)
+		{
+			if (ExtAllocCache[i].size == freed_size)
+			{
+				bucket = &ExtAllocCache[i];
+				break;
+			}
+			if (bucket == NULL && ExtAllocCache[i].blocks == NULL)
+				bucket = &ExtAllocCache[i];
+		}
+
+		if (bucket != NULL)
+		{
+			ExtAllocCachedBlock *block = (ExtAllocCachedBlock *) ptr;
+
+			bucket->size = freed_size;
+			block->next = bucket->blocks;
+			bucket->blocks = block;
+			ExtAllocCacheTotal += freed_size;
+			return;
+		}
+	}
+
+	gp_free_prereserved(ptr);
+	ExtAllocVmemUsed -= (int64) UserPtrSize_GetVmemPtrSize(freed_size);
+	Assert(ExtAllocVmemUsed >= 0);
+
+	if (0 == OptimizerOutstandingMemoryBalance)
+	{
+		/*
+		 * The optimization task has torn down its pools; reconcile by
+		 * returning the whole surplus (everything but the still-charged
+		 * cached blocks) to the tracker.
+		 */
+		int64		surplus = ExtAllocVmemReserved - ExtAllocVmemUsed;
+
+		if (surplus > 0)
+		{
+			VmemTracker_ReleaseVmem(surplus);
+			ExtAllocVmemReserved -= surplus;
+		}
+	}
+	else if (ExtAllocVmemReserved - ExtAllocVmemUsed > 2 * EXT_ALLOC_VMEM_LEASE_BYTES)
+	{
+		/* Mid-task, keep one lease worth of headroom and trim the rest */
+		int64		surplus = ExtAllocVmemReserved - ExtAllocVmemUsed - EXT_ALLOC_VMEM_LEASE_BYTES;
+
+		VmemTracker_ReleaseVmem(surplus);
+		ExtAllocVmemReserved -= surplus;
+	}
 }
 
 uint64
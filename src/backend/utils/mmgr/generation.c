@@ -0,0 +1,877 @@
+/*-------------------------------------------------------------------------
+ *
+ * generation.c
+ *	  Generational allocator definitions.
+ *
+ * Generation is a MemoryContext implementation designed for cases where
+ * chunks are allocated in more or less FIFO order: the per-tuple contexts
+ * of the executor, where everything palloc'd while processing one tuple
+ * dies together at the next ResetExprContext().  AllocSet (aset.c) serves
+ * that pattern through its general machinery -- power-of-2 rounding,
+ * freelist binning, block size doubling -- none of which buys anything
+ * when chunks are never (or almost never) freed individually.
+ *
+ * Generation simply appends each chunk at the current block's free pointer,
+ * so allocation is a bounds check and a pointer increment.  There are no
+ * chunk freelists and no power-of-2 rounding (chunks are just MAXALIGN'ed).
+ * Each block counts the chunks carved from it; pfree() only marks the chunk
+ * dead, and a block is returned to the host memory manager once every chunk
+ * in it has died.  With FIFO-ish lifetimes the blocks therefore retire in
+ * roughly the order they were created.  The first block is kept across
+ * resets (like aset.c's keeper block), so the reset-per-tuple cycle does
+ * not go back to the host memory manager at all in the common case.
+ *
+ * repalloc() is supported by allocating a new chunk and abandoning the old
+ * one; the space is wasted until the block dies, which is acceptable for
+ * the short-lived contexts this allocator is meant for.
+ *
+ * Like aset.c, each allocated chunk carries a StandardChunkHeader so that
+ * pfree() and the memory accounting framework treat these chunks exactly
+ * like AllocSet chunks.  The shared-header management mirrors
+ * AllocAllocInfo/AllocFreeInfo in aset.c, except that the SharedChunkHeader
+ * structs are obtained directly from the host memory manager, as in slab.c.
+ *
+ *
+ * Portions Copyright (c) 2017-Present Pivotal Software, Inc.
+ * Portions Copyright (c) 1996-2010, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *	  src/backend/utils/mmgr/generation.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "utils/memutils.h"
+#include "utils/memaccounting.h"
+#include "utils/gp_alloc.h"
+
+#include "miscadmin.h"
+
+#include "utils/memaccounting_private.h"
+
+#ifdef CDB_PALLOC_CALLER_ID
+#define CDB_MCXT_WHERE(context) (context)->callerFile, (context)->callerLine
+#else
+#define CDB_MCXT_WHERE(context) __FILE__, __LINE__
+#endif
+
+typedef GenerationContext *Generation;
+
+/*
+ * GenerationBlockData
+ *		Header of a single generation block; chunks are carved sequentially
+ *		from the space between the header and endptr.
+ *
+ * nchunks counts the chunks carved from this block so far and nfree the
+ * ones among them that have been pfree'd; the block can be recycled when
+ * they become equal.  freeptr is where the next chunk will be placed.
+ */
+typedef struct GenerationBlockData
+{
+	GenerationBlock prev;		/* doubly-linked list of all blocks in the */
+	GenerationBlock next;		/* context, newest first */
+	Size		blksize;		/* allocated size of this block */
+	int			nchunks;		/* number of chunks carved from this block */
+	int			nfree;			/* number of those chunks freed so far */
+	char	   *freeptr;		/* start of free space in this block */
+	char	   *endptr;			/* end of space in this block */
+} GenerationBlockData;
+
+#define GENERATION_BLOCKHDRSZ	MAXALIGN(sizeof(GenerationBlockData))
+
+/*
+ * Each chunk is laid out as a maxaligned back-pointer to the owning block,
+ * followed by a StandardChunkHeader, followed by the data area.  The
+ * StandardChunkHeader must end exactly at the data area so that pfree()
+ * finds it at the usual offset.
+ */
+#define GENERATION_CHUNKHDRSZ \
+	(MAXALIGN(sizeof(GenerationBlock)) + STANDARDCHUNKHEADERSIZE)
+
+#define GenerationPointerGetHeader(ptr) \
+	((StandardChunkHeader *) (((char *) (ptr)) - STANDARDCHUNKHEADERSIZE))
+#define GenerationPointerGetBlockPtr(ptr) \
+	((GenerationBlock *) (((char *) (ptr)) - GENERATION_CHUNKHDRSZ))
+
+/*
+ * These functions implement the MemoryContext API for Generation contexts.
+ */
+static void *GenerationAlloc(MemoryContext context, Size size);
+static void GenerationFree(MemoryContext context, void *pointer);
+static void *GenerationRealloc(MemoryContext context, void *pointer, Size size);
+static void GenerationInit(MemoryContext context);
+static void GenerationReset(MemoryContext context);
+static void GenerationDelete(MemoryContext context);
+static Size GenerationGetChunkSpace(MemoryContext context, void *pointer);
+static bool GenerationIsEmpty(MemoryContext context);
+static void Generation_GetStats(MemoryContext context, uint64 *nBlocks, uint64 *nChunks,
+		uint64 *currentAvailable, uint64 *allAllocated, uint64 *allFreed, uint64 *maxHeld);
+static void GenerationReleaseAccountingForAllAllocatedChunks(MemoryContext context);
+
+#ifdef MEMORY_CONTEXT_CHECKING
+static void GenerationCheck(MemoryContext context);
+#endif
+
+/*
+ * This is the virtual function table for Generation contexts.
+ */
+static MemoryContextMethods GenerationMethods = {
+	GenerationAlloc,
+	GenerationFree,
+	GenerationRealloc,
+	GenerationInit,
+	GenerationReset,
+	GenerationDelete,
+	GenerationGetChunkSpace,
+	GenerationIsEmpty,
+	Generation_GetStats,
+	GenerationReleaseAccountingForAllAllocatedChunks
+#ifdef MEMORY_CONTEXT_CHECKING
+	,GenerationCheck
+#endif
+};
+
+
+/*
+ * GenerationAllocInfo
+ *		Assign a shared header to a newly allocated chunk and update the
+ *		memory accounting.  This mirrors AllocAllocInfo() in aset.c, except
+ *		that shared headers come straight from the host memory manager.
+ */
+static void
+GenerationAllocInfo(Generation gen, StandardChunkHeader *header)
+{
+	Size		chunkSpace = GENERATION_CHUNKHDRSZ + header->size;
+
+	if (ActiveMemoryAccountId != MEMORY_OWNER_TYPE_Undefined)
+	{
+		SharedChunkHeader *desiredHeader = gen->sharedHeaderList;
+
+		/* Try to look-ahead in the sharedHeaderList to find the desiredHeader */
+		if (gen->sharedHeaderList != NULL &&
+			gen->sharedHeaderList->memoryAccountId == ActiveMemoryAccountId)
+		{
+			/* Do nothing, we already assigned sharedHeaderList to desiredHeader */
+		}
+		else if (gen->sharedHeaderList != NULL && gen->sharedHeaderList->next != NULL &&
+				 gen->sharedHeaderList->next->memoryAccountId == ActiveMemoryAccountId)
+		{
+			desiredHeader = gen->sharedHeaderList->next;
+		}
+		else if (gen->sharedHeaderList != NULL && gen->sharedHeaderList->next != NULL &&
+				 gen->sharedHeaderList->next->next != NULL &&
+				 gen->sharedHeaderList->next->next->memoryAccountId == ActiveMemoryAccountId)
+		{
+			desiredHeader = gen->sharedHeaderList->next->next;
+		}
+		else
+		{
+			/* The last 3 headers are not suitable for next chunk, so we need a new shared header */
+			desiredHeader = gp_malloc(sizeof(SharedChunkHeader));
+			if (desiredHeader == NULL)
+				MemoryContextError(ERRCODE_OUT_OF_MEMORY,
+								   &gen->header, CDB_MCXT_WHERE(&gen->header),
+								   "Out of memory.  Failed on request of size %lu bytes.",
+								   (unsigned long) sizeof(SharedChunkHeader));
+
+			desiredHeader->context = (MemoryContext) gen;
+			desiredHeader->memoryAccountId = ActiveMemoryAccountId;
+			desiredHeader->balance = 0;
+
+			desiredHeader->next = gen->sharedHeaderList;
+			if (desiredHeader->next != NULL)
+				desiredHeader->next->prev = desiredHeader;
+			desiredHeader->prev = NULL;
+
+			gen->sharedHeaderList = desiredHeader;
+
+			MemoryContextNoteAlloc(&gen->header, sizeof(SharedChunkHeader));
+			if (SharedChunkHeadersMemoryAccount != NULL)
+				MemoryAccounting_Allocate(MEMORY_OWNER_TYPE_SharedChunkHeader,
+										  sizeof(SharedChunkHeader));
+		}
+
+		desiredHeader->balance += chunkSpace;
+		header->sharedHeader = desiredHeader;
+
+		MemoryAccounting_Allocate(ActiveMemoryAccountId, chunkSpace);
+	}
+	else
+	{
+		/* We have NULL ActiveMemoryAccount, so use nullAccountHeader */
+		if (gen->nullAccountHeader == NULL)
+		{
+			SharedChunkHeader *desiredHeader = gp_malloc(sizeof(SharedChunkHeader));
+
+			if (desiredHeader == NULL)
+				MemoryContextError(ERRCODE_OUT_OF_MEMORY,
+								   &gen->header, CDB_MCXT_WHERE(&gen->header),
+								   "Out of memory.  Failed on request of size %lu bytes.",
+								   (unsigned long) sizeof(SharedChunkHeader));
+
+			desiredHeader->context = (MemoryContext) gen;
+			desiredHeader->memoryAccountId = MEMORY_OWNER_TYPE_Undefined;
+			desiredHeader->balance = 0;
+			desiredHeader->prev = NULL;
+			desiredHeader->next = NULL;
+
+			gen->nullAccountHeader = desiredHeader;
+
+			MemoryContextNoteAlloc(&gen->header, sizeof(SharedChunkHeader));
+		}
+
+		header->sharedHeader = gen->nullAccountHeader;
+		gen->nullAccountHeader->balance += chunkSpace;
+	}
+
+#ifdef CDB_PALLOC_TAGS
+	header->prev_chunk = NULL;
+	header->next_chunk = gen->allocList;
+	if (gen->allocList)
+		gen->allocList->prev_chunk = header;
+	gen->allocList = header;
+
+	header->alloc_tag = gen->header.callerFile;
+	header->alloc_n = gen->header.callerLine;
+#endif
+}
+
+/*
+ * GenerationFreeInfo
+ *		Release the shared header linkage and memory accounting of a chunk
+ *		that is being freed.  Mirrors AllocFreeInfo() in aset.c.
+ */
+static void
+GenerationFreeInfo(Generation gen, StandardChunkHeader *header)
+{
+	SharedChunkHeader *sharedHeader = header->sharedHeader;
+	Size		chunkSpace = GENERATION_CHUNKHDRSZ + header->size;
+
+	Assert(sharedHeader != NULL);
+
+	sharedHeader->balance -= chunkSpace;
+	Assert(sharedHeader->balance >= 0);
+
+	if (sharedHeader->memoryAccountId != MEMORY_OWNER_TYPE_Undefined)
+	{
+		MemoryAccounting_Free(sharedHeader->memoryAccountId, chunkSpace);
+
+		if (sharedHeader->balance == 0)
+		{
+			/* No chunk is sharing this header, so remove it from the sharedHeaderList */
+			Assert(gen->sharedHeaderList != NULL &&
+				   (gen->sharedHeaderList->next != NULL || gen->sharedHeaderList == sharedHeader));
+
+			if (sharedHeader->prev != NULL)
+				sharedHeader->prev->next = sharedHeader->next;
+			else
+			{
+				Assert(gen->sharedHeaderList == sharedHeader);
+				gen->sharedHeaderList = sharedHeader->next;
+			}
+			if (sharedHeader->next != NULL)
+				sharedHeader->next->prev = sharedHeader->prev;
+
+			if (SharedChunkHeadersMemoryAccount != NULL)
+				MemoryAccounting_Free(MEMORY_OWNER_TYPE_SharedChunkHeader,
+									  sizeof(SharedChunkHeader));
+			MemoryContextNoteFree(&gen->header, sizeof(SharedChunkHeader));
+			gp_free(sharedHeader);
+		}
+	}
+	else
+	{
+		/*
+		 * As in aset.c, we don't try to free the nullAccountHeader, even if
+		 * its balance reaches 0 (MPP-22566).
+		 */
+		Assert(sharedHeader == gen->nullAccountHeader);
+	}
+
+#ifdef CDB_PALLOC_TAGS
+	{
+		StandardChunkHeader *prev = header->prev_chunk;
+		StandardChunkHeader *next = header->next_chunk;
+
+		if (prev != NULL)
+			prev->next_chunk = next;
+		else
+		{
+			Assert(gen->allocList == header);
+			gen->allocList = next;
+		}
+		if (next != NULL)
+			next->prev_chunk = prev;
+	}
+#endif
+}
+
+/*
+ * Public routines
+ */
+
+
+/*
+ * GenerationContextCreate
+ *		Create a new Generation context.
+ *
+ * parent: parent context, or NULL if top-level context
+ * name: name of context (for debugging --- string will be copied)
+ * blockSize: block size; requests too large for a shared block get a
+ *		dedicated block of their own
+ */
+MemoryContext
+GenerationContextCreate(MemoryContext parent,
+						const char *name,
+						Size blockSize)
+{
+	Generation	gen;
+
+	/* the block header must leave room for at least one ordinary chunk */
+	Assert(blockSize > GENERATION_BLOCKHDRSZ + GENERATION_CHUNKHDRSZ);
+
+	/* Do the type-independent part of context creation */
+	gen = (Generation) MemoryContextCreate(T_GenerationContext,
+										   sizeof(GenerationContext),
+										   &GenerationMethods,
+										   parent,
+										   name);
+
+	gen->blockSize = blockSize;
+	gen->block = NULL;
+	gen->blocks = NULL;
+	gen->keeper = NULL;
+	gen->isReset = true;
+	gen->sharedHeaderList = NULL;
+	gen->nullAccountHeader = NULL;
+#ifdef CDB_PALLOC_TAGS
+	gen->allocList = NULL;
+#endif
+
+	return (MemoryContext) gen;
+}
+
+/*
+ * GenerationInit
+ *		Context-type-specific initialization routine.
+ */
+static void
+GenerationInit(MemoryContext context)
+{
+	/*
+	 * Since MemoryContextCreate already zeroed the context node, we don't
+	 * have to do anything here.
+	 */
+}
+
+/*
+ * GenerationReleaseAccountingForAllAllocatedChunks
+ *		Releases the memory accounting of all the shared headers in the
+ *		sharedHeaderList, and frees the headers themselves.
+ *
+ * This is called by GenerationReset() and GenerationDelete(), which release
+ * all the in-use chunks in bulk.  Unlike aset.c, the headers are not hosted
+ * inside the context's own blocks, so they must be freed here; afterwards
+ * any surviving chunk pointers into this context are invalid, which is fine
+ * because the callers are about to release all the blocks too.
+ */
+static void
+GenerationReleaseAccountingForAllAllocatedChunks(MemoryContext context)
+{
+	Generation	gen = (Generation) context;
+	SharedChunkHeader *curHeader = gen->sharedHeaderList;
+
+	/* The memory consumed by the shared headers themselves */
+	uint64		sharedHeaderMemoryOverhead = 0;
+
+	while (curHeader != NULL)
+	{
+		SharedChunkHeader *nextHeader = curHeader->next;
+
+		Assert(curHeader->balance > 0);
+		MemoryAccounting_Free(curHeader->memoryAccountId, curHeader->balance);
+
+		sharedHeaderMemoryOverhead += sizeof(SharedChunkHeader);
+		MemoryContextNoteFree(&gen->header, sizeof(SharedChunkHeader));
+		gp_free(curHeader);
+
+		curHeader = nextHeader;
+	}
+
+	/*
+	 * In addition to releasing accounting for the chunks, we also need
+	 * to release accounting for the shared headers
+	 */
+	MemoryAccounting_Free(MEMORY_OWNER_TYPE_SharedChunkHeader,
+						  sharedHeaderMemoryOverhead);
+
+	gen->sharedHeaderList = NULL;
+
+	if (gen->nullAccountHeader != NULL)
+	{
+		MemoryContextNoteFree(&gen->header, sizeof(SharedChunkHeader));
+		gp_free(gen->nullAccountHeader);
+		gen->nullAccountHeader = NULL;
+	}
+
+#ifdef CDB_PALLOC_TAGS
+	gen->allocList = NULL;
+#endif
+}
+
+/*
+ * GenerationReset
+ *		Frees all memory which is allocated in the given context.
+ *
+ * The keeper block (the first ordinary block ever allocated) is rewound
+ * rather than freed, so that a context which is reset once per tuple does
+ * not go back to the host memory manager on every cycle.
+ */
+static void
+GenerationReset(MemoryContext context)
+{
+	Generation	gen = (Generation) context;
+	GenerationBlock block;
+
+	AssertArg(gen != NULL);
+
+	/* Nothing to do if no pallocs since startup or last reset */
+	if (gen->isReset)
+		return;
+
+#ifdef MEMORY_CONTEXT_CHECKING
+	/* Check for corruption and leaks before freeing */
+	GenerationCheck(context);
+#endif
+
+	GenerationReleaseAccountingForAllAllocatedChunks(context);
+
+	block = gen->blocks;
+	while (block != NULL)
+	{
+		GenerationBlock next = block->next;
+
+		if (block == gen->keeper)
+		{
+			/* rewind the keeper block for reuse */
+			block->nchunks = 0;
+			block->nfree = 0;
+			block->freeptr = ((char *) block) + GENERATION_BLOCKHDRSZ;
+		}
+		else
+		{
+			Size		freesz = block->blksize;
+
+			MemoryContextNoteFree(&gen->header, freesz);
+
+#ifdef CLOBBER_FREED_MEMORY
+			/* Wipe freed memory for debugging purposes */
+			memset(block, 0x7F, freesz);
+#endif
+			gp_free(block);
+		}
+		block = next;
+	}
+
+	/* Re-install the keeper block (if any) as the only block */
+	gen->blocks = gen->keeper;
+	gen->block = gen->keeper;
+	if (gen->keeper != NULL)
+	{
+		gen->keeper->prev = NULL;
+		gen->keeper->next = NULL;
+	}
+
+	gen->isReset = true;
+}
+
+/*
+ * GenerationDelete
+ *		Frees all memory which is allocated in the given context, in
+ *		preparation for deletion of the context.
+ *
+ * Unlike GenerationReset, this also gives back the keeper block.
+ */
+static void
+GenerationDelete(MemoryContext context)
+{
+	Generation	gen = (Generation) context;
+	GenerationBlock block;
+
+	AssertArg(gen != NULL);
+
+#ifdef MEMORY_CONTEXT_CHECKING
+	if (!gen->isReset)
+		GenerationCheck(context);
+#endif
+
+	GenerationReleaseAccountingForAllAllocatedChunks(context);
+
+	block = gen->blocks;
+	gen->blocks = NULL;
+	gen->block = NULL;
+	gen->keeper = NULL;
+
+	while (block != NULL)
+	{
+		GenerationBlock next = block->next;
+		Size		freesz = block->blksize;
+
+		MemoryContextNoteFree(&gen->header, freesz);
+
+#ifdef CLOBBER_FREED_MEMORY
+		memset(block, 0x7F, freesz);
+#endif
+		gp_free(block);
+		block = next;
+	}
+
+	gen->isReset = true;
+}
+
+/*
+ * GenerationAlloc
+ *		Returns pointer to an allocated chunk of at least the given size;
+ *		the chunk is appended at the current block's free pointer, or a new
+ *		block is grabbed if there isn't enough room.
+ */
+static void *
+GenerationAlloc(MemoryContext context, Size size)
+{
+	Generation	gen = (Generation) context;
+	GenerationBlock block;
+	StandardChunkHeader *header;
+	char	   *pointer;
+	Size		chunk_size = MAXALIGN(size);
+	Size		total_size = GENERATION_CHUNKHDRSZ + chunk_size;
+
+	AssertArg(gen != NULL);
+
+	if (!AllocSizeIsValid(size))
+		MemoryContextError(ERRCODE_INTERNAL_ERROR,
+						   &gen->header, CDB_MCXT_WHERE(&gen->header),
+						   "invalid memory alloc request size %lu",
+						   (unsigned long) size);
+
+	if (total_size > gen->blockSize - GENERATION_BLOCKHDRSZ)
+	{
+		/* An oversized request gets a dedicated block of its own. */
+		Size		blksize = GENERATION_BLOCKHDRSZ + total_size;
+
+		block = (GenerationBlock) gp_malloc(blksize);
+		if (block == NULL)
+			MemoryContextError(ERRCODE_OUT_OF_MEMORY,
+							   &gen->header, CDB_MCXT_WHERE(&gen->header),
+							   "Out of memory.  Failed on request of size %lu bytes.",
+							   (unsigned long) size);
+
+		block->blksize = blksize;
+		block->nchunks = 1;
+		block->nfree = 0;
+		block->freeptr = block->endptr = ((char *) block) + blksize;
+
+		/*
+		 * Add to the head of the block list, but leave the current block
+		 * alone: it may still have plenty of room for ordinary requests.
+		 */
+		block->prev = NULL;
+		block->next = gen->blocks;
+		if (block->next != NULL)
+			block->next->prev = block;
+		gen->blocks = block;
+		if (gen->block == NULL)
+			gen->block = block;
+
+		MemoryContextNoteAlloc(&gen->header, blksize);
+
+		pointer = ((char *) block) + GENERATION_BLOCKHDRSZ + GENERATION_CHUNKHDRSZ;
+	}
+	else
+	{
+		block = gen->block;
+
+		if (block == NULL ||
+			(Size) (block->endptr - block->freeptr) < total_size)
+		{
+			/* Current block is full (or doesn't exist); grab a fresh one. */
+			Size		blksize = gen->blockSize;
+
+			block = (GenerationBlock) gp_malloc(blksize);
+			if (block == NULL)
+				MemoryContextError(ERRCODE_OUT_OF_MEMORY,
+								   &gen->header, CDB_MCXT_WHERE(&gen->header),
+								   "Out of memory.  Failed on request of size %lu bytes.",
+								   (unsigned long) size);
+
+			block->blksize = blksize;
+			block->nchunks = 0;
+			block->nfree = 0;
+			block->freeptr = ((char *) block) + GENERATION_BLOCKHDRSZ;
+			block->endptr = ((char *) block) + blksize;
+
+			block->prev = NULL;
+			block->next = gen->blocks;
+			if (block->next != NULL)
+				block->next->prev = block;
+			gen->blocks = block;
+			gen->block = block;
+
+			/* the first ordinary block becomes the keeper block */
+			if (gen->keeper == NULL)
+				gen->keeper = block;
+
+			MemoryContextNoteAlloc(&gen->header, blksize);
+		}
+
+		pointer = block->freeptr + GENERATION_CHUNKHDRSZ;
+		block->freeptr += total_size;
+		block->nchunks++;
+		Assert(block->freeptr <= block->endptr);
+	}
+
+	/* set up the chunk headers */
+	*GenerationPointerGetBlockPtr(pointer) = block;
+	header = GenerationPointerGetHeader(pointer);
+	header->size = chunk_size;
+#ifdef MEMORY_CONTEXT_CHECKING
+	header->requested_size = size;
+	/* set mark to catch clobber of "unused" space */
+	if (size < chunk_size)
+		pointer[size] = 0x7E;
+#endif
+
+	gen->isReset = false;
+
+	GenerationAllocInfo(gen, header);
+
+	return (void *) pointer;
+}
+
+/*
+ * GenerationFree
+ *		Marks a chunk as dead; the owning block is given back to the host
+ *		memory manager once all of its chunks are dead.
+ */
+static void
+GenerationFree(MemoryContext context, void *pointer)
+{
+	Generation	gen = (Generation) context;
+	StandardChunkHeader *header = GenerationPointerGetHeader(pointer);
+	GenerationBlock block = *GenerationPointerGetBlockPtr(pointer);
+
+	GenerationFreeInfo(gen, header);
+
+#ifdef MEMORY_CONTEXT_CHECKING
+	Assert(header->requested_size != 0xFFFFFFFF);
+	/* Test for someone scribbling on unused space in chunk */
+	if (header->requested_size < header->size)
+	{
+		if (((char *) pointer)[header->requested_size] != 0x7E)
+		{
+			Assert(!"Memory error");
+			elog(WARNING, "detected write past chunk end in %s %p (%s:%d)",
+				 gen->header.name, pointer, CDB_MCXT_WHERE(&gen->header));
+		}
+	}
+	header->requested_size = 0xFFFFFFFF;
+#endif
+
+#ifdef CLOBBER_FREED_MEMORY
+	/* Wipe freed memory for debugging purposes */
+	memset(pointer, 0x7F, header->size);
+#endif
+
+	block->nfree++;
+	Assert(block->nfree <= block->nchunks);
+
+	if (block->nfree < block->nchunks)
+		return;
+
+	/*
+	 * All chunks in the block are dead.  Rewind the current block and the
+	 * keeper block for reuse; return any other block to the host memory
+	 * manager.
+	 */
+	if (block == gen->block || block == gen->keeper)
+	{
+		block->nchunks = 0;
+		block->nfree = 0;
+		block->freeptr = ((char *) block) + GENERATION_BLOCKHDRSZ;
+	}
+	else
+	{
+		Size		freesz = block->blksize;
+
+		if (block->prev != NULL)
+			block->prev->next = block->next;
+		else
+		{
+			Assert(gen->blocks == block);
+			gen->blocks = block->next;
+		}
+		if (block->next != NULL)
+			block->next->prev = block->prev;
+
+		MemoryContextNoteFree(&gen->header, freesz);
+#ifdef CLOBBER_FREED_MEMORY
+		memset(block, 0x7F, freesz);
+#endif
+		gp_free(block);
+	}
+}
+
+/*
+ * GenerationRealloc
+ *		When the request still fits in the chunk, adjust it in place;
+ *		otherwise allocate a new chunk, copy the data over, and abandon
+ *		the old chunk.
+ */
+static void *
+GenerationRealloc(MemoryContext context, void *pointer, Size size)
+{
+	StandardChunkHeader *header = GenerationPointerGetHeader(pointer);
+	Size		oldsize = header->size;
+	void	   *newPointer;
+
+	if (MAXALIGN(size) <= oldsize)
+	{
+#ifdef MEMORY_CONTEXT_CHECKING
+		header->requested_size = size;
+		/* set mark to catch clobber of "unused" space */
+		if (size < oldsize)
+			((char *) pointer)[size] = 0x7E;
+#endif
+		return pointer;
+	}
+
+	/* allocate new chunk; this also handles the memory accounting */
+	newPointer = GenerationAlloc(context, size);
+
+	memcpy(newPointer, pointer, oldsize);
+
+	GenerationFree(context, pointer);
+
+	return newPointer;
+}
+
+/*
+ * GenerationGetChunkSpace
+ *		Given a currently-allocated chunk, determine the total space it
+ *		uses (including all memory-allocation overhead).
+ */
+static Size
+GenerationGetChunkSpace(MemoryContext context, void *pointer)
+{
+	StandardChunkHeader *header = GenerationPointerGetHeader(pointer);
+
+	return GENERATION_CHUNKHDRSZ + header->size;
+}
+
+/*
+ * GenerationIsEmpty
+ *		Is a Generation context empty of any allocated space?
+ */
+static bool
+GenerationIsEmpty(MemoryContext context)
+{
+	Generation	gen = (Generation) context;
+
+	return gen->isReset;
+}
+
+/*
+ * Generation_GetStats
+ *		Returns stats about memory consumption of a Generation context, in
+ *		the same terms as AllocSet_GetStats.
+ */
+static void
+Generation_GetStats(MemoryContext context, uint64 *nBlocks, uint64 *nChunks,
+		uint64 *currentAvailable, uint64 *allAllocated, uint64 *allFreed, uint64 *maxHeld)
+{
+	Generation	gen = (Generation) context;
+	GenerationBlock block;
+	uint64		blockCount = 0;
+	uint64		chunkCount = 0;
+	uint64		available = 0;
+
+	for (block = gen->blocks; block != NULL; block = block->next)
+	{
+		blockCount++;
+		chunkCount += block->nchunks;
+		available += block->endptr - block->freeptr;
+	}
+
+	*nBlocks = blockCount;
+	*nChunks = chunkCount;
+	*currentAvailable = available;
+	*allAllocated = gen->header.allBytesAlloc;
+	*allFreed = gen->header.allBytesFreed;
+	*maxHeld = gen->header.maxBytesHeld;
+}
+
+#ifdef MEMORY_CONTEXT_CHECKING
+
+/*
+ * GenerationCheck
+ *		Walk through chunks and check consistency of memory.
+ *
+ * NOTE: report errors as WARNING, *not* ERROR or FATAL.  Otherwise you'll
+ * find yourself in an infinite loop when trouble occurs, because this
+ * routine will be entered again when elog cleanup tries to release memory!
+ */
+static void
+GenerationCheck(MemoryContext context)
+{
+	Generation	gen = (Generation) context;
+	const char *name = gen->header.name;
+	GenerationBlock block;
+
+	for (block = gen->blocks; block != NULL; block = block->next)
+	{
+		char	   *ptr = ((char *) block) + GENERATION_BLOCKHDRSZ;
+		int			nchunks = 0;
+		int			nfree = 0;
+
+		if (block->nfree > block->nchunks)
+			elog(WARNING, "problem in Generation %s: number of free chunks %d in block %p exceeds %d allocated",
+				 name, block->nfree, block, block->nchunks);
+
+		/* walk all the chunks that were carved from this block */
+		while (ptr < block->freeptr)
+		{
+			char	   *chunkdata = ptr + GENERATION_CHUNKHDRSZ;
+			StandardChunkHeader *header = GenerationPointerGetHeader(chunkdata);
+
+			nchunks++;
+
+			if (*GenerationPointerGetBlockPtr(chunkdata) != block)
+				elog(WARNING, "problem in Generation %s: bogus block link in chunk %p",
+					 name, chunkdata);
+
+			if (header->requested_size == 0xFFFFFFFF)
+				nfree++;
+			else if (header->requested_size > header->size)
+				elog(WARNING, "problem in Generation %s: req size > alloc size for chunk %p in block %p",
+					 name, chunkdata, block);
+			else if (header->requested_size < header->size &&
+					 chunkdata[header->requested_size] != 0x7E)
+				elog(WARNING, "problem in Generation %s: detected write past chunk end in block %p, chunk %p",
+					 name, block, chunkdata);
+
+			ptr += GENERATION_CHUNKHDRSZ + header->size;
+		}
+
+		if (nchunks != block->nchunks)
+			elog(WARNING, "problem in Generation %s: found %d chunks in block %p but nchunks is %d",
+				 name, nchunks, block, block->nchunks);
+
+		if (nfree != block->nfree)
+			elog(WARNING, "problem in Generation %s: found %d free chunks in block %p but nfree is %d",
+				 name, nfree, block, block->nfree);
+	}
+}
+
+#endif   /* MEMORY_CONTEXT_CHECKING */
@@ -158,6 +158,12 @@ IdleTracker_DeactivateProcess()
 		Assert(isProcessActive);
 		Assert(deactivationVersion <= activationVersion);
 
+		/*
+		 * An idle process should not sit on an unused vmem lease; return it
+		 * so other backends can reserve that memory.
+		 */
+		VmemTracker_ReturnLease();
+
 		/* No new runaway event can come in */
 		SpinLockAcquire(&MySessionState->spinLock);
 
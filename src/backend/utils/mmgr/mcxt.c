@@ -896,6 +896,7 @@ bool
 MemoryContextContainsGenericAllocation(MemoryContext context, void *pointer)
 {
 	StandardChunkHeader *header;
+	SharedChunkHeader *sharedHeaderList;
 
 	/*
 	 * Try to detect bogus pointers handed to us, poorly though we can.
@@ -913,17 +914,26 @@ MemoryContextContainsGenericAllocation(MemoryContext context, void *pointer)
 	header = (StandardChunkHeader *)
 		((char *) pointer - STANDARDCHUNKHEADERSIZE);
 
-	AllocSet set = (AllocSet)context;
+	/*
+	 * The sharedHeaderList lives at a type-specific offset, so fetch it
+	 * according to the context's actual type.  (The executor calls this
+	 * with CurrentMemoryContext, which can be a per-tuple Generation
+	 * context these days, not just an AllocSet.)
+	 */
+	if (IsA(context, GenerationContext))
+		sharedHeaderList = ((GenerationContext *) context)->sharedHeaderList;
+	else
+		sharedHeaderList = ((AllocSet) context)->sharedHeaderList;
 
-	if (header->sharedHeader == set->sharedHeaderList ||
-			(set->sharedHeaderList != NULL && set->sharedHeaderList->next == header->sharedHeader) ||
-			(set->sharedHeaderList != NULL && set->sharedHeaderList->next != NULL && set->sharedHeaderList->next->next == header->sharedHeader))
+	if (header->sharedHeader == sharedHeaderList ||
+			(sharedHeaderList != NULL && sharedHeaderList->next == header->sharedHeader) ||
+			(sharedHeaderList != NULL && sharedHeaderList->next != NULL && sharedHeaderList->next->next == header->sharedHeader))
 	{
 		/*
 		 * At this point we know that one of the sharedHeader pointers of the
-		 * provided context (AllocSet) is the same as the sharedHeader
+		 * provided context is the same as the sharedHeader
 		 * pointer of the provided chunk. Therefore, the chunk should
-		 * belong to the AllocSet (with a false positive chance coming
+		 * belong to the context (with a false positive chance coming
 		 * from some third party allocated memory region having the
 		 * same value as the sharedHeaderList pointer address
 		 */
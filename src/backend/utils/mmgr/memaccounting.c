@@ -196,6 +196,16 @@ uint64 MemoryAccountingOutstandingBalance = 0;
  */
 uint64 MemoryAccountingPeakBalance = 0;
 
+/*
+ * Sampling mode state: deltas accumulated against the most recently charged
+ * account that have not yet been folded into its counters.  See
+ * MemoryAccounting_Allocate() in memaccounting_private.h.
+ */
+MemoryAccountIdType MemoryAccountingPendingAccountId = MEMORY_OWNER_TYPE_Undefined;
+uint64 MemoryAccountingPendingAllocated = 0;
+uint64 MemoryAccountingPendingFreed = 0;
+uint32 MemoryAccountingPendingCalls = 0;
+
 /******************************************/
 /********** Public interface **************/
 
@@ -205,9 +215,50 @@ uint64 MemoryAccountingPeakBalance = 0;
  *		off all the accounts' balance clean, and transferring the ownership
  *		of all live allocations to the "rollover" account.
  */
+/*
+ * MemoryAccounting_Reconcile
+ *		Folds the deltas that sampling mode has accumulated into the pending
+ *		account's counters and the global balance.  Called from the allocation
+ *		fast path on every Nth call or on a change of the charged account, and
+ *		from every function that reads or resets the counters.
+ */
+void
+MemoryAccounting_Reconcile(void)
+{
+	MemoryAccount *memoryAccount;
+	Size		held;
+
+	if (MemoryAccountingPendingAccountId == MEMORY_OWNER_TYPE_Undefined)
+		return;
+
+	memoryAccount = MemoryAccounting_ConvertIdToAccount(MemoryAccountingPendingAccountId);
+
+	Assert(memoryAccount->allocated + MemoryAccountingPendingAllocated >=
+			memoryAccount->allocated);
+
+	memoryAccount->allocated += MemoryAccountingPendingAllocated;
+	MemoryAccountingOutstandingBalance += MemoryAccountingPendingAllocated;
+	MemoryAccountingPeakBalance = Max(MemoryAccountingPeakBalance, MemoryAccountingOutstandingBalance);
+
+	held = memoryAccount->allocated - memoryAccount->freed;
+	memoryAccount->peak = Max(memoryAccount->peak, held);
+
+	memoryAccount->freed += MemoryAccountingPendingFreed;
+	MemoryAccountingOutstandingBalance -= MemoryAccountingPendingFreed;
+
+	Assert(memoryAccount->allocated >= memoryAccount->freed);
+
+	MemoryAccountingPendingAccountId = MEMORY_OWNER_TYPE_Undefined;
+	MemoryAccountingPendingAllocated = 0;
+	MemoryAccountingPendingFreed = 0;
+	MemoryAccountingPendingCalls = 0;
+}
+
 void
 MemoryAccounting_Reset()
 {
+	MemoryAccounting_Reconcile();
+
 	/*
 	 * Attempt to reset only if we already have setup memory accounting
 	 * and the memory monitoring is ON
@@ -241,6 +292,8 @@ MemoryAccounting_Reset()
 uint64
 MemoryAccounting_DeclareDone()
 {
+	MemoryAccounting_Reconcile();
+
 	MemoryAccount *currentAccount = MemoryAccounting_ConvertIdToAccount(ActiveMemoryAccountId);
 	uint64 relinquished = 0;
 	if (currentAccount->maxLimit > 0 && currentAccount->maxLimit > currentAccount->allocated)
@@ -257,6 +310,8 @@ MemoryAccounting_DeclareDone()
 uint64
 MemoryAccounting_RequestQuotaIncrease()
 {
+	MemoryAccounting_Reconcile();
+
 	MemoryAccount *currentAccount = MemoryAccounting_ConvertIdToAccount(ActiveMemoryAccountId);
 
 	uint64 result = RelinquishedPoolMemoryAccount->allocated;
@@ -346,6 +401,8 @@ MemoryAccounting_SizeOfAccountInBytes()
 uint64
 MemoryAccounting_GetAccountPeakBalance(MemoryAccountIdType memoryAccountId)
 {
+	MemoryAccounting_Reconcile();
+
 	return MemoryAccounting_ConvertIdToAccount(memoryAccountId)->peak;
 }
 
@@ -358,6 +415,8 @@ MemoryAccounting_GetAccountPeakBalance(MemoryAccountIdType memoryAccountId)
 uint64
 MemoryAccounting_GetAccountCurrentBalance(MemoryAccountIdType memoryAccountId)
 {
+	MemoryAccounting_Reconcile();
+
 	MemoryAccount *account = MemoryAccounting_ConvertIdToAccount(memoryAccountId);
 	return account->allocated - account->freed;
 }
@@ -381,6 +440,8 @@ MemoryAccounting_GetBalance(MemoryAccount* memoryAccount)
 uint64
 MemoryAccounting_GetGlobalPeak()
 {
+	MemoryAccounting_Reconcile();
+
 	return MemoryAccountingPeakBalance;
 }
 
@@ -391,6 +452,8 @@ MemoryAccounting_GetGlobalPeak()
 uint32
 MemoryAccounting_Serialize(StringInfoData *buffer)
 {
+	MemoryAccounting_Reconcile();
+
 	START_MEMORY_ACCOUNT(MEMORY_OWNER_TYPE_MemAccount);
 	{
 		/* Ignore undefined account */
@@ -418,6 +481,8 @@ MemoryAccounting_Serialize(StringInfoData *buffer)
 void
 MemoryAccounting_PrettyPrint()
 {
+	MemoryAccounting_Reconcile();
+
 	StringInfoData memBuf;
 	initStringInfo(&memBuf);
 
@@ -466,6 +531,8 @@ MemoryAccounting_CombinedAccountArrayToString(void *accountArrayBytes,
 void
 MemoryAccounting_SaveToFile(int currentSliceId)
 {
+	MemoryAccounting_Reconcile();
+
 	StringInfoData prefix;
 	StringInfoData memBuf;
 	initStringInfo(&prefix);
@@ -503,6 +570,8 @@ MemoryAccounting_SaveToFile(int currentSliceId)
 void
 MemoryAccounting_SaveToLog()
 {
+	MemoryAccounting_Reconcile();
+
 	int64 vmem_reserved = VmemTracker_GetMaxReservedVmemBytes();
 
 	/* Write the header for the subsequent lines of memory usage information */
@@ -553,6 +622,8 @@ MemoryAccounting_SaveToLog()
 MemoryAccountExplain *
 MemoryAccounting_ExplainCurrentOptimizerAccountInfo(void)
 {
+	MemoryAccounting_Reconcile();
+
 	MemoryAccountIdType		shortLivingCount = shortLivingMemoryAccountArray->accountCount;
 	MemoryAccountIdType		shortLivingArrayIdx;
 	MemoryAccountExplain   *exp = NULL;
@@ -14,6 +14,7 @@
 #include <signal.h>
 #include <unistd.h>
 #include <sys/file.h>
+#include <sys/mman.h>
 #include <sys/time.h>
 
 #ifdef HAVE_SYS_IPC_H
@@ -225,7 +226,7 @@ MemoryProtection_IsOwnerThread()
  * 		en: the last seen error number as retrieved by calling __error() or similar function
  * 		sz: the requested allocation size for which we reached OOM
  */
-static void gp_failed_to_alloc(MemoryAllocationStatus ec, int en, int sz)
+void gp_failed_to_alloc(MemoryAllocationStatus ec, int en, int sz)
 {
 	/*
 	 * A per-query vmem overflow shouldn't trigger a segment-wide
@@ -327,6 +328,43 @@ static void gp_failed_to_alloc(MemoryAllocationStatus ec, int en, int sz)
 	}
 }
 
+#ifdef MAP_HUGETLB
+
+/* Explicit huge pages are 2 MB on the platforms that offer MAP_HUGETLB */
+#define GP_HUGE_PAGE_SIZE ((size_t) (2 * 1024 * 1024))
+
+/*
+ * The mapping size of a huge-page backed allocation: the allocation size
+ * including our metadata, rounded up to whole huge pages.  Recomputed from
+ * the stored user size at munmap time.
+ */
+static size_t
+huge_page_mapping_size(size_t usable_size)
+{
+	return TYPEALIGN(GP_HUGE_PAGE_SIZE, UserPtrSize_GetVmemPtrSize(usable_size));
+}
+
+/*
+ * Tries to back the requested "size" with an explicit huge-page mapping.
+ * Returns NULL if no huge pages are available; the caller is expected to
+ * fall back to the regular allocator.
+ */
+static void *huge_mmap_and_store_metadata(size_t size)
+{
+	void *mapping = mmap(NULL, huge_page_mapping_size(size),
+						 PROT_READ | PROT_WRITE,
+						 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+	if (MAP_FAILED == mapping)
+		return NULL;
+
+	VmemPtr_Initialize((VmemHeader*) mapping, size);
+	VmemPtr_SetIsHuge((VmemHeader*) mapping);
+	return VmemPtrToUserPtr((VmemHeader*) mapping);
+}
+
+#endif   /* MAP_HUGETLB */
+
 /*
  * malloc the requested "size" and additional memory for metadata and store header and/or
  * footer metadata information. Caller is in charge to update Vmem counter accordingly.
@@ -334,6 +372,24 @@ static void gp_failed_to_alloc(MemoryAllocationStatus ec, int en, int sz)
 static void *malloc_and_store_metadata(size_t size)
 {
 	size_t malloc_size = UserPtrSize_GetVmemPtrSize(size);
+
+#ifdef MAP_HUGETLB
+	/*
+	 * Back sufficiently large allocations with explicit huge pages, so that
+	 * operators that walk a lot of memory (hash joins, sorts) need far fewer
+	 * TLB entries.  If the kernel has no huge pages available, fall through
+	 * to the regular allocator.
+	 */
+	if (gp_huge_page_alloc_threshold_mb > 0 &&
+		malloc_size >= ((size_t) gp_huge_page_alloc_threshold_mb) * 1024 * 1024)
+	{
+		void *huge_pointer = huge_mmap_and_store_metadata(size);
+
+		if (NULL != huge_pointer)
+			return huge_pointer;
+	}
+#endif
+
 	void *malloc_pointer = malloc(malloc_size);
 	if (NULL == malloc_pointer)
 	{
@@ -357,6 +413,26 @@ static void *realloc_and_store_metadata(void *usable_pointer, size_t new_usable_
 	Assert(UserPtr_GetVmemPtr(usable_pointer)->checksum == VMEM_HEADER_CHECKSUM);
 	Assert(*VmemPtr_GetPointerToFooterChecksum(UserPtr_GetVmemPtr(usable_pointer)) == VMEM_FOOTER_CHECKSUM);
 
+#ifdef MAP_HUGETLB
+	if (VmemPtr_IsHuge(UserPtr_GetVmemPtr(usable_pointer)))
+	{
+		/*
+		 * realloc() must not be called on a huge-page mapping; allocate a new
+		 * pointer (which may or may not be huge-page backed, depending on the
+		 * new size), copy the payload over and unmap the old mapping.
+		 */
+		size_t old_usable_size = UserPtr_GetUserPtrSize(usable_pointer);
+		void *new_pointer = malloc_and_store_metadata(new_usable_size);
+
+		if (NULL == new_pointer)
+			return NULL;
+
+		memcpy(new_pointer, usable_pointer, Min(old_usable_size, new_usable_size));
+		munmap(UserPtr_GetVmemPtr(usable_pointer), huge_page_mapping_size(old_usable_size));
+		return new_pointer;
+	}
+#endif
+
 	void *realloc_pointer = realloc(UserPtr_GetVmemPtr(usable_pointer), UserPtrSize_GetVmemPtrSize(new_usable_size));
 
 	if (NULL == realloc_pointer)
@@ -418,6 +494,19 @@ void *gp_malloc(int64 sz)
 	return ret;
 }
 
+/*
+ * Allocates sz bytes whose vmem the caller has already reserved in bulk
+ * through VmemTracker_ReserveVmem (see ext_alloc.c). The pointer carries the
+ * usual Vmem metadata, but no vmem is charged here, and it must be freed
+ * with gp_free_prereserved so that none is released either.
+ */
+void *gp_malloc_prereserved(int64 sz)
+{
+	Assert(!gp_mp_inited || MemoryProtection_IsOwnerThread());
+
+	return malloc_and_store_metadata(sz);
+}
+
 /* Reallocates memory, respecting vmem protection, if enabled */
 void *gp_realloc(void *ptr, int64 new_size)
 {
@@ -470,16 +559,31 @@ void *gp_realloc(void *ptr, int64 new_size)
 	return NULL; 
 }
 
-/* Frees memory and releases vmem accordingly */
-void gp_free(void *user_pointer)
+/*
+ * Frees memory allocated with gp_malloc_prereserved. The caller remains in
+ * charge of the vmem reservation backing it.
+ */
+void gp_free_prereserved(void *user_pointer)
 {
 	Assert(!gp_mp_inited || MemoryProtection_IsOwnerThread());
 	Assert(NULL != user_pointer);
 
 	void *malloc_pointer = UserPtr_GetVmemPtr(user_pointer);
-	size_t usable_size = VmemPtr_GetUserPtrSize((VmemHeader*) malloc_pointer);
-	Assert(usable_size > 0);
+	Assert(VmemPtr_GetUserPtrSize((VmemHeader*) malloc_pointer) > 0);
 	UserPtr_VerifyChecksum(user_pointer);
-	free(malloc_pointer);
+#ifdef MAP_HUGETLB
+	if (VmemPtr_IsHuge((VmemHeader*) malloc_pointer))
+		munmap(malloc_pointer, huge_page_mapping_size(VmemPtr_GetUserPtrSize((VmemHeader*) malloc_pointer)));
+	else
+#endif
+		free(malloc_pointer);
+}
+
+/* Frees memory and releases vmem accordingly */
+void gp_free(void *user_pointer)
+{
+	size_t usable_size = UserPtr_GetUserPtrSize(user_pointer);
+
+	gp_free_prereserved(user_pointer);
 	VmemTracker_ReleaseVmem(UserPtrSize_GetVmemPtrSize(usable_size));
 }
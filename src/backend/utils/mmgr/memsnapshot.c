@@ -0,0 +1,399 @@
+/*-------------------------------------------------------------------------
+ *
+ * memsnapshot.c
+ *	  On-demand memory context snapshots of live backends.
+ *
+ * Diagnosing a bloated backend used to require attaching a debugger and
+ * calling MemoryContextStats(), which writes to stderr and stops the
+ * process.  This module lets any superuser run
+ *
+ *		SELECT * FROM gp_backend_memory_contexts(pid);
+ *
+ * instead.  The requesting backend claims the single shared snapshot
+ * buffer, signals the target with PROCSIG_DUMP_MEMORY_CONTEXTS and polls
+ * for completion.  The target serializes its context tree (name, level and
+ * the per-allocator totals reported by the stats() method) into the buffer
+ * at its next CHECK_FOR_INTERRUPTS(), so the walk runs at a safe point and
+ * never inside the signal handler.  A backend that is never asked for a
+ * snapshot pays nothing beyond one pending-flag test per interrupt check.
+ *
+ * Portions Copyright (c) 2016-Present Pivotal Software, Inc.
+ *
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "funcapi.h"
+#include "miscadmin.h"
+#include "catalog/pg_type.h"
+#include "nodes/memnodes.h"
+#include "storage/ipc.h"
+#include "storage/procarray.h"
+#include "storage/procsignal.h"
+#include "storage/shmem.h"
+#include "storage/spin.h"
+#include "utils/builtins.h"
+#include "utils/memsnapshot.h"
+#include "utils/memutils.h"
+
+/* Maximum number of contexts one snapshot can report */
+#define MEMSNAPSHOT_MAX_CONTEXTS 1024
+/* Maximum length of a reported context name, including the terminator */
+#define MEMSNAPSHOT_NAME_SIZE 64
+
+/* How long the requester waits for the target, and how often it polls */
+#define MEMSNAPSHOT_TIMEOUT_USEC (5 * 1000000L)
+#define MEMSNAPSHOT_POLL_USEC 50000L
+
+/*
+ * The shared buffer is a simple single-request state machine: a requester
+ * moves it IDLE -> REQUESTED, the target fills it and moves it
+ * REQUESTED -> DONE, and the requester copies the entries out and returns
+ * it to IDLE.  Concurrent requesters get an error instead of queueing;
+ * this is a diagnostic facility, not a hot path.
+ */
+typedef enum MemSnapshotState
+{
+	MEMSNAPSHOT_IDLE = 0,
+	MEMSNAPSHOT_REQUESTED,
+	MEMSNAPSHOT_DONE
+} MemSnapshotState;
+
+typedef struct MemSnapshotEntry
+{
+	char		name[MEMSNAPSHOT_NAME_SIZE];
+	int32		level;
+	uint64		nBlocks;
+	uint64		nChunks;
+	uint64		allocatedBytes;
+	uint64		availableBytes;
+} MemSnapshotEntry;
+
+typedef struct MemSnapshotShmem
+{
+	slock_t		lock;
+	int			state;			/* MemSnapshotState */
+
+	/*
+	 * Bumped for every new request.  A target that finds the generation
+	 * changed mid-walk knows the requester gave up (timed out or was
+	 * cancelled) and the buffer may already belong to someone else, so it
+	 * abandons the dump instead of publishing into a recycled slot.
+	 */
+	volatile uint32 generation;
+
+	int			targetPid;
+	uint32		numEntries;
+	bool		truncated;		/* context tree exceeded the entry array? */
+	MemSnapshotEntry entries[MEMSNAPSHOT_MAX_CONTEXTS];
+} MemSnapshotShmem;
+
+static MemSnapshotShmem *memSnapshotShmem = NULL;
+
+volatile bool MemSnapshotDumpPending = false;
+
+static void MemSnapshotRecordContext(MemoryContext context, int level,
+						 uint32 generation);
+
+/*
+ * Size of the shared snapshot buffer.
+ */
+Size
+MemSnapshotShmemSize(void)
+{
+	return sizeof(MemSnapshotShmem);
+}
+
+/*
+ * Allocate and initialize the shared snapshot buffer.
+ */
+void
+MemSnapshotShmemInit(void)
+{
+	bool		found;
+
+	memSnapshotShmem = (MemSnapshotShmem *)
+		ShmemInitStruct("Memory Context Snapshot",
+						MemSnapshotShmemSize(), &found);
+
+	if (!found)
+	{
+		MemSet(memSnapshotShmem, 0, sizeof(MemSnapshotShmem));
+		SpinLockInit(&memSnapshotShmem->lock);
+		memSnapshotShmem->state = MEMSNAPSHOT_IDLE;
+	}
+}
+
+/*
+ * PROCSIG_DUMP_MEMORY_CONTEXTS handler.  Runs inside the SIGUSR1 handler,
+ * so it only latches a flag; the actual context walk happens at the next
+ * CHECK_FOR_INTERRUPTS().
+ */
+void
+HandleMemSnapshotInterrupt(void)
+{
+	if (!proc_exit_inprogress)
+	{
+		MemSnapshotDumpPending = true;
+		InterruptPending = true;
+	}
+}
+
+/*
+ * Record one context and recurse into its children, depth-first, matching
+ * the traversal order of MemoryContextStats().
+ */
+static void
+MemSnapshotRecordContext(MemoryContext context, int level, uint32 generation)
+{
+	MemoryContext child;
+	MemSnapshotEntry *entry;
+	uint64		nBlocks = 0;
+	uint64		nChunks = 0;
+	uint64		currentAvailable = 0;
+	uint64		allAllocated = 0;
+	uint64		allFreed = 0;
+	uint64		maxHeld = 0;
+
+	AssertArg(MemoryContextIsValid(context));
+
+	/* Stop if the requester gave up and the buffer was recycled */
+	if (memSnapshotShmem->generation != generation)
+		return;
+
+	if (memSnapshotShmem->numEntries >= MEMSNAPSHOT_MAX_CONTEXTS)
+	{
+		memSnapshotShmem->truncated = true;
+		return;
+	}
+
+	(*context->methods.stats)(context, &nBlocks, &nChunks, &currentAvailable,
+							  &allAllocated, &allFreed, &maxHeld);
+
+	entry = &memSnapshotShmem->entries[memSnapshotShmem->numEntries];
+	strlcpy(entry->name, context->name != NULL ? context->name : "",
+			MEMSNAPSHOT_NAME_SIZE);
+	entry->level = level;
+	entry->nBlocks = nBlocks;
+	entry->nChunks = nChunks;
+	entry->allocatedBytes = allAllocated - allFreed;
+	entry->availableBytes = currentAvailable;
+	memSnapshotShmem->numEntries++;
+
+	for (child = context->firstchild; child != NULL; child = child->nextchild)
+		MemSnapshotRecordContext(child, level + 1, generation);
+}
+
+/*
+ * Service a pending snapshot request.  Called from ProcessInterrupts(),
+ * i.e. at a point where the context tree is consistent.
+ */
+void
+ProcessMemSnapshotRequest(void)
+{
+	uint32		generation = 0;
+	bool		ours = false;
+
+	MemSnapshotDumpPending = false;
+
+	if (memSnapshotShmem == NULL)
+		return;
+
+	SpinLockAcquire(&memSnapshotShmem->lock);
+	if (memSnapshotShmem->state == MEMSNAPSHOT_REQUESTED &&
+		memSnapshotShmem->targetPid == MyProcPid)
+	{
+		generation = memSnapshotShmem->generation;
+		memSnapshotShmem->numEntries = 0;
+		memSnapshotShmem->truncated = false;
+		ours = true;
+	}
+	SpinLockRelease(&memSnapshotShmem->lock);
+
+	if (!ours)
+		return;
+
+	MemSnapshotRecordContext(TopMemoryContext, 0, generation);
+
+	SpinLockAcquire(&memSnapshotShmem->lock);
+	if (memSnapshotShmem->state == MEMSNAPSHOT_REQUESTED &&
+		memSnapshotShmem->generation == generation)
+		memSnapshotShmem->state = MEMSNAPSHOT_DONE;
+	SpinLockRelease(&memSnapshotShmem->lock);
+}
+
+/*
+ * Return the buffer to IDLE if it still belongs to our request.
+ */
+static void
+MemSnapshotReleaseRequest(uint32 generation)
+{
+	SpinLockAcquire(&memSnapshotShmem->lock);
+	if (memSnapshotShmem->generation == generation)
+		memSnapshotShmem->state = MEMSNAPSHOT_IDLE;
+	SpinLockRelease(&memSnapshotShmem->lock);
+}
+
+/*
+ * Requester side: claim the buffer, signal the target, wait for the dump
+ * and copy the entries into the current memory context.
+ */
+static MemSnapshotEntry *
+MemSnapshotCollect(int pid, uint32 *numEntries, bool *truncated)
+{
+	MemSnapshotEntry *result = NULL;
+	uint32		generation;
+	long		waited;
+
+	if (!superuser())
+		ereport(ERROR,
+				(errcode(ERRCODE_INSUFFICIENT_PRIVILEGE),
+			(errmsg("must be superuser to inspect memory of other server processes"))));
+
+	if (!IsBackendPid(pid))
+		ereport(ERROR,
+				(errmsg("PID %d is not a PostgreSQL server process", pid)));
+
+	SpinLockAcquire(&memSnapshotShmem->lock);
+	if (memSnapshotShmem->state != MEMSNAPSHOT_IDLE)
+	{
+		SpinLockRelease(&memSnapshotShmem->lock);
+		ereport(ERROR,
+				(errmsg("another memory context snapshot is already in progress")));
+	}
+	memSnapshotShmem->state = MEMSNAPSHOT_REQUESTED;
+	memSnapshotShmem->generation++;
+	memSnapshotShmem->targetPid = pid;
+	memSnapshotShmem->numEntries = 0;
+	memSnapshotShmem->truncated = false;
+	generation = memSnapshotShmem->generation;
+	SpinLockRelease(&memSnapshotShmem->lock);
+
+	if (SendProcSignal(pid, PROCSIG_DUMP_MEMORY_CONTEXTS, InvalidBackendId) != 0)
+	{
+		MemSnapshotReleaseRequest(generation);
+		ereport(ERROR,
+				(errmsg("could not signal process %d: %m", pid)));
+	}
+
+	PG_TRY();
+	{
+		for (waited = 0; waited < MEMSNAPSHOT_TIMEOUT_USEC;
+			 waited += MEMSNAPSHOT_POLL_USEC)
+		{
+			bool		done;
+
+			/*
+			 * If the target is this very backend, the request is serviced
+			 * right here, from the interrupt check.
+			 */
+			CHECK_FOR_INTERRUPTS();
+
+			SpinLockAcquire(&memSnapshotShmem->lock);
+			done = (memSnapshotShmem->state == MEMSNAPSHOT_DONE &&
+					memSnapshotShmem->generation == generation);
+			SpinLockRelease(&memSnapshotShmem->lock);
+
+			if (done)
+			{
+				uint32		n = memSnapshotShmem->numEntries;
+
+				if (n > 0)
+				{
+					result = (MemSnapshotEntry *)
+						palloc(n * sizeof(MemSnapshotEntry));
+					memcpy(result, memSnapshotShmem->entries,
+						   n * sizeof(MemSnapshotEntry));
+				}
+				*numEntries = n;
+				*truncated = memSnapshotShmem->truncated;
+				break;
+			}
+
+			pg_usleep(MEMSNAPSHOT_POLL_USEC);
+		}
+	}
+	PG_CATCH();
+	{
+		MemSnapshotReleaseRequest(generation);
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+
+	MemSnapshotReleaseRequest(generation);
+
+	if (result == NULL && *numEntries == 0 && waited >= MEMSNAPSHOT_TIMEOUT_USEC)
+		ereport(ERROR,
+				(errmsg("timed out waiting for process %d to report its memory contexts", pid)));
+
+	if (*truncated)
+		ereport(WARNING,
+				(errmsg("memory context tree of process %d has more than %d contexts; result is truncated",
+						pid, MEMSNAPSHOT_MAX_CONTEXTS)));
+
+	return result;
+}
+
+/*
+ * gp_backend_memory_contexts(pid) - set-returning wrapper around the
+ * snapshot machinery; one row per memory context of the target backend.
+ */
+Datum
+gp_backend_memory_contexts(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+	MemSnapshotEntry *entries;
+
+	if (SRF_IS_FIRSTCALL())
+	{
+		MemoryContext oldcontext;
+		TupleDesc	tupdesc;
+		uint32		numEntries = 0;
+		bool		truncated = false;
+
+		funcctx = SRF_FIRSTCALL_INIT();
+
+		oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+		tupdesc = CreateTemplateTupleDesc(6, false);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 1, "context_name", TEXTOID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 2, "level", INT4OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 3, "nblocks", INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 4, "nchunks", INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 5, "allocated_bytes", INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 6, "available_bytes", INT8OID, -1, 0);
+
+		funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+
+		funcctx->user_fctx =
+			MemSnapshotCollect(PG_GETARG_INT32(0), &numEntries, &truncated);
+		funcctx->max_calls = numEntries;
+
+		MemoryContextSwitchTo(oldcontext);
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+	entries = (MemSnapshotEntry *) funcctx->user_fctx;
+
+	if (funcctx->call_cntr < funcctx->max_calls)
+	{
+		MemSnapshotEntry *entry = &entries[funcctx->call_cntr];
+		Datum		values[6];
+		bool		nulls[6];
+		HeapTuple	tuple;
+
+		MemSet(nulls, false, sizeof(nulls));
+		values[0] = CStringGetTextDatum(entry->name);
+		values[1] = Int32GetDatum(entry->level);
+		values[2] = Int64GetDatum((int64) entry->nBlocks);
+		values[3] = Int64GetDatum((int64) entry->nChunks);
+		values[4] = Int64GetDatum((int64) entry->allocatedBytes);
+		values[5] = Int64GetDatum((int64) entry->availableBytes);
+
+		tuple = heap_form_tuple(funcctx->tuple_desc, values, nulls);
+		SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+	}
+
+	SRF_RETURN_DONE(funcctx);
+}
@@ -38,12 +38,42 @@ extern int32 VmemTracker_ConvertVmemMBToChunks(int mb);
 /* The runaway detector activates if the used vmem exceeds this percentage of the vmem quota */
 int	runaway_detector_activation_percent = 80;
 
+/*
+ * Memory-intensive operators are asked to pre-spill if the used vmem exceeds
+ * this percentage of the vmem quota. 0 disables pre-spill requests.
+ */
+int	runaway_detector_prespill_percent = 0;
+
 /*
  * Number of VMEM chunks at which we consider the VMEM level critical.
  * Derived from chunk size, gp_vmem_protect_limit and RED_ZONE_RATIO.
  */
 static int32 redZoneChunks = 0;
 
+/*
+ * Number of VMEM chunks at which we start asking memory-intensive operators
+ * to spill cooperatively, before the red-zone terminates anyone. Derived from
+ * chunk size, gp_vmem_protect_limit and runaway_detector_prespill_percent.
+ */
+static int32 spillZoneChunks = 0;
+
+/*
+ * Per-process count of pre-spill requests. Incremented each time the segment
+ * vmem usage crosses the pre-spill watermark anew; memory-intensive operators
+ * poll it at tuple boundaries via RedZoneHandler_PreSpillRequested() and
+ * spill incrementally when it has advanced. Polling a counter (instead of
+ * registering callbacks) keeps the protocol safe on error paths: an operator
+ * that is destroyed by a transaction abort leaves nothing behind to clean up.
+ */
+static uint32 preSpillRequestCount = 0;
+
+/*
+ * Re-armed once the segment drops back below the pre-spill watermark, so that
+ * a sustained stay above the watermark generates a single request rather than
+ * one per allocation.
+ */
+static bool preSpillArmed = true;
+
 /*
  * A shared memory binary flag (0 or 1) that identifies one process at-a-time as runaway
  * detector. At red-zone each process tries to determine runaway query, but only the first
@@ -93,6 +123,7 @@ RedZoneHandler_ShmemInit()
 	if(!IsUnderPostmaster)
 	{
 		redZoneChunks = 0;
+		spillZoneChunks = 0;
 
 		/*
 		 * runaway_detector_activation_percent = 100% is reserved for not enforcing runaway
@@ -110,6 +141,11 @@ RedZoneHandler_ShmemInit()
 			redZoneChunks = VmemTracker_ConvertVmemMBToChunks(gp_vmem_protect_limit * (((float) runaway_detector_activation_percent) / 100.0));
 		}
 
+		if (runaway_detector_prespill_percent != 0)
+		{
+			spillZoneChunks = VmemTracker_ConvertVmemMBToChunks(gp_vmem_protect_limit * (((float) runaway_detector_prespill_percent) / 100.0));
+		}
+
 		/*
 		 * 0 means disable red-zone completely
 		 * we also disable red-zone for resource group
@@ -119,6 +155,12 @@ RedZoneHandler_ShmemInit()
 			redZoneChunks = INT32_MAX;
 		}
 
+		/* 0 means pre-spill requests are disabled; same for resource group */
+		if (spillZoneChunks == 0 || IsResGroupEnabled())
+		{
+			spillZoneChunks = INT32_MAX;
+		}
+
 		*isRunawayDetector = 0;
 	}
 }
@@ -139,6 +181,78 @@ RedZoneHandler_IsVmemRedZone()
 	return false;
 }
 
+/*
+ * Returns true if the system has crossed the pre-spill watermark (but is
+ * possibly still below the red-zone)
+ */
+bool
+RedZoneHandler_IsVmemSpillZone()
+{
+	if (vmemTrackerInited)
+	{
+		return *segmentVmemChunks > spillZoneChunks;
+	}
+
+	return false;
+}
+
+/*
+ * Returns the current pre-spill request count, for operators to initialize
+ * the serial they later pass to RedZoneHandler_PreSpillRequested(). A newly
+ * built operator has nothing to spill yet, so it should not react to requests
+ * that predate it.
+ */
+uint32
+RedZoneHandler_GetPreSpillRequestCount()
+{
+	return preSpillRequestCount;
+}
+
+/*
+ * Polled by memory-intensive operators at tuple boundaries. Returns true if
+ * a pre-spill request arrived since the serial was last updated, and catches
+ * the serial up so that one request triggers one spill per operator.
+ */
+bool
+RedZoneHandler_PreSpillRequested(uint32 *lastServedRequestCount)
+{
+	if (*lastServedRequestCount == preSpillRequestCount)
+	{
+		return false;
+	}
+
+	*lastServedRequestCount = preSpillRequestCount;
+	return true;
+}
+
+/*
+ * Publishes a pre-spill request when the segment crosses the pre-spill
+ * watermark anew. Merely advances a counter; the actual spilling happens
+ * at the operators' next safe point (a tuple boundary), so this is safe to
+ * call from any allocation path.
+ */
+static void
+RedZoneHandler_RequestPreSpillIfNeeded()
+{
+	if (!vmemTrackerInited)
+	{
+		return;
+	}
+
+	if (*segmentVmemChunks > spillZoneChunks)
+	{
+		if (preSpillArmed)
+		{
+			preSpillRequestCount++;
+			preSpillArmed = false;
+		}
+	}
+	else
+	{
+		preSpillArmed = true;
+	}
+}
+
 /*
  * Finds and notifies the top vmem consuming session.
  */
@@ -307,6 +421,13 @@ RedZoneHandler_DetectRunawaySession()
 	if (IsResGroupEnabled())
 		return;
 
+	/*
+	 * Before resorting to termination, give cooperating memory-intensive
+	 * operators a chance to spill and bring the segment back out of the
+	 * approaching red-zone.
+	 */
+	RedZoneHandler_RequestPreSpillIfNeeded();
+
 	/*
 	 * InterruptHoldoffCount > 0 indicates we are in a sensitive code path that doesn't
 	 * like a control flow disruption as may happen from a pending die/cancel interrupt.
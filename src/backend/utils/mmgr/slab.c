@@ -0,0 +1,900 @@
+/*-------------------------------------------------------------------------
+ *
+ * slab.c
+ *	  SLAB allocator definitions.
+ *
+ * SLAB is a MemoryContext implementation designed for cases where large
+ * numbers of equally-sized objects are allocated and freed individually.
+ * AllocSet (aset.c) handles such workloads through its power-of-2 chunk
+ * freelists, paying both a space penalty (request rounded up to the next
+ * power of 2) and a time penalty (freelist binning) on every call.  Slab
+ * exploits the fixed chunk size instead: blocks are carved into an array
+ * of equal chunks up front, allocation pops a chunk off the owning
+ * block's free list, and free pushes it back, both in constant time.
+ *
+ * Blocks are kept on freelists indexed by the number of free chunks they
+ * contain, and allocations are always served from the fullest block with
+ * free space.  That way mostly-empty blocks drain out over time and can
+ * be returned to the host memory manager, so long-lived contexts with
+ * alloc/free churn do not accumulate sparsely-used blocks.
+ *
+ * Repalloc is not supported; the context holds objects of one size only.
+ *
+ * Like aset.c, each allocated chunk carries a StandardChunkHeader so that
+ * pfree() and the memory accounting framework treat slab chunks exactly
+ * like AllocSet chunks.  The shared-header management mirrors
+ * AllocAllocInfo/AllocFreeInfo in aset.c, except that the SharedChunkHeader
+ * structs are obtained directly from the host memory manager (a slab can
+ * only hand out fixed-size chunks, so it cannot host them itself).
+ *
+ *
+ * Portions Copyright (c) 2017-Present Pivotal Software, Inc.
+ * Portions Copyright (c) 1996-2010, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *	  src/backend/utils/mmgr/slab.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "utils/memutils.h"
+#include "utils/memaccounting.h"
+#include "utils/gp_alloc.h"
+
+#include "miscadmin.h"
+
+#include "utils/memaccounting_private.h"
+
+#ifdef CDB_PALLOC_CALLER_ID
+#define CDB_MCXT_WHERE(context) (context)->callerFile, (context)->callerLine
+#else
+#define CDB_MCXT_WHERE(context) __FILE__, __LINE__
+#endif
+
+typedef struct SlabBlockData *SlabBlock;
+
+/*
+ * SlabContext is a specialized implementation of MemoryContext.
+ *
+ * All blocks have the same size, blockSize, and hold chunksPerBlock chunks
+ * of fullChunkSize bytes each.  freelist[i] is a doubly-linked list of the
+ * blocks that currently have exactly i free chunks; freelist[0] thus holds
+ * the completely full blocks.  minFreeChunks is the smallest i > 0 with a
+ * non-empty freelist, or 0 if no block has any free chunk; keeping it
+ * up-to-date lets SlabAlloc find the fullest usable block in O(1).
+ */
+typedef struct SlabContext
+{
+	MemoryContextData header;	/* Standard memory-context fields */
+	/* Allocation parameters for this context: */
+	Size		chunkSize;		/* usable space per chunk */
+	Size		fullChunkSize;	/* chunk size including headers */
+	Size		blockSize;		/* block size as passed to gp_malloc */
+	int			chunksPerBlock; /* number of chunks per block */
+	/* Info about storage allocated in this context: */
+	int			minFreeChunks;	/* min number of free chunks in any block */
+	int			nblocks;		/* number of blocks allocated */
+	bool		isReset;		/* T = no space alloced since last reset */
+
+	/* Points to the head of the sharedHeaderList */
+	SharedChunkHeader *sharedHeaderList;
+	/* The memory account of this SharedChunkHeader is NULL */
+	SharedChunkHeader *nullAccountHeader;
+
+#ifdef CDB_PALLOC_TAGS
+	/* Doubly-linked list of currently allocated chunk headers */
+	StandardChunkHeader *allocList;
+#endif
+
+	/* blocks with exactly i free chunks; chunksPerBlock + 1 entries */
+	SlabBlock	freelist[1];	/* VARIABLE LENGTH ARRAY */
+} SlabContext;
+
+typedef SlabContext *Slab;
+
+/*
+ * SlabBlockData
+ *		Header of a single slab block; the chunk array begins at the next
+ *		maxaligned boundary.
+ *
+ * Free chunks within a block are a singly-linked list: firstFreeChunk is
+ * the index of the first free chunk (or chunksPerBlock if none), and each
+ * free chunk stores the index of the next free one in the first bytes of
+ * its data area.
+ */
+typedef struct SlabBlockData
+{
+	SlabBlock	prev;			/* doubly-linked list of blocks in the */
+	SlabBlock	next;			/* freelist for their current nfree */
+	int			nfree;			/* number of free chunks */
+	int			firstFreeChunk; /* index of the first free chunk */
+} SlabBlockData;
+
+#define SLAB_BLOCKHDRSZ		MAXALIGN(sizeof(SlabBlockData))
+
+/*
+ * Each chunk is laid out as a maxaligned back-pointer to the owning block,
+ * followed by a StandardChunkHeader, followed by the data area.  The
+ * StandardChunkHeader must end exactly at the data area so that pfree()
+ * finds it at the usual offset.
+ */
+#define SLAB_CHUNKHDRSZ		(MAXALIGN(sizeof(SlabBlock)) + STANDARDCHUNKHEADERSIZE)
+
+#define SlabPointerGetHeader(ptr) \
+	((StandardChunkHeader *) (((char *) (ptr)) - STANDARDCHUNKHEADERSIZE))
+#define SlabPointerGetBlockPtr(ptr) \
+	((SlabBlock *) (((char *) (ptr)) - SLAB_CHUNKHDRSZ))
+#define SlabBlockGetChunkPointer(slab, block, idx) \
+	((void *) (((char *) (block)) + SLAB_BLOCKHDRSZ + \
+			   (slab)->fullChunkSize * (idx) + SLAB_CHUNKHDRSZ))
+#define SlabPointerGetChunkIndex(slab, block, ptr) \
+	((int) ((((char *) (ptr)) - SLAB_CHUNKHDRSZ - \
+			 (((char *) (block)) + SLAB_BLOCKHDRSZ)) / (slab)->fullChunkSize))
+
+/*
+ * These functions implement the MemoryContext API for Slab contexts.
+ */
+static void *SlabAlloc(MemoryContext context, Size size);
+static void SlabFree(MemoryContext context, void *pointer);
+static void *SlabRealloc(MemoryContext context, void *pointer, Size size);
+static void SlabInit(MemoryContext context);
+static void SlabReset(MemoryContext context);
+static void SlabDelete(MemoryContext context);
+static Size SlabGetChunkSpace(MemoryContext context, void *pointer);
+static bool SlabIsEmpty(MemoryContext context);
+static void Slab_GetStats(MemoryContext context, uint64 *nBlocks, uint64 *nChunks,
+		uint64 *currentAvailable, uint64 *allAllocated, uint64 *allFreed, uint64 *maxHeld);
+static void SlabReleaseAccountingForAllAllocatedChunks(MemoryContext context);
+
+#ifdef MEMORY_CONTEXT_CHECKING
+static void SlabCheck(MemoryContext context);
+#endif
+
+/*
+ * This is the virtual function table for Slab contexts.
+ */
+static MemoryContextMethods SlabMethods = {
+	SlabAlloc,
+	SlabFree,
+	SlabRealloc,
+	SlabInit,
+	SlabReset,
+	SlabDelete,
+	SlabGetChunkSpace,
+	SlabIsEmpty,
+	Slab_GetStats,
+	SlabReleaseAccountingForAllAllocatedChunks
+#ifdef MEMORY_CONTEXT_CHECKING
+	,SlabCheck
+#endif
+};
+
+
+/*
+ * SlabFreelistRemove
+ *		Unlink a block from the freelist it currently resides in, which is
+ *		the one indexed by its current nfree count.
+ */
+static inline void
+SlabFreelistRemove(Slab slab, SlabBlock block)
+{
+	if (block->prev != NULL)
+		block->prev->next = block->next;
+	else
+	{
+		Assert(slab->freelist[block->nfree] == block);
+		slab->freelist[block->nfree] = block->next;
+	}
+	if (block->next != NULL)
+		block->next->prev = block->prev;
+	block->prev = NULL;
+	block->next = NULL;
+}
+
+/*
+ * SlabFreelistPush
+ *		Put a block at the head of the freelist matching its nfree count.
+ */
+static inline void
+SlabFreelistPush(Slab slab, SlabBlock block)
+{
+	block->prev = NULL;
+	block->next = slab->freelist[block->nfree];
+	if (block->next != NULL)
+		block->next->prev = block;
+	slab->freelist[block->nfree] = block;
+}
+
+/*
+ * SlabUpdateMinFreeChunks
+ *		Recompute minFreeChunks by scanning upward from the given index.
+ *		Called after the freelist that defined the old minimum was emptied.
+ */
+static void
+SlabUpdateMinFreeChunks(Slab slab, int from)
+{
+	int			i;
+
+	for (i = from; i <= slab->chunksPerBlock; i++)
+	{
+		if (slab->freelist[i] != NULL)
+		{
+			slab->minFreeChunks = i;
+			return;
+		}
+	}
+	slab->minFreeChunks = 0;
+}
+
+/*
+ * SlabAllocInfo
+ *		Assign a shared header to a newly allocated chunk and update the
+ *		memory accounting.  This mirrors AllocAllocInfo() in aset.c, except
+ *		that shared headers come straight from the host memory manager.
+ */
+static void
+SlabAllocInfo(Slab slab, StandardChunkHeader *header)
+{
+	if (ActiveMemoryAccountId != MEMORY_OWNER_TYPE_Undefined)
+	{
+		SharedChunkHeader *desiredHeader = slab->sharedHeaderList;
+
+		/* Try to look-ahead in the sharedHeaderList to find the desiredHeader */
+		if (slab->sharedHeaderList != NULL &&
+			slab->sharedHeaderList->memoryAccountId == ActiveMemoryAccountId)
+		{
+			/* Do nothing, we already assigned sharedHeaderList to desiredHeader */
+		}
+		else if (slab->sharedHeaderList != NULL && slab->sharedHeaderList->next != NULL &&
+				 slab->sharedHeaderList->next->memoryAccountId == ActiveMemoryAccountId)
+		{
+			desiredHeader = slab->sharedHeaderList->next;
+		}
+		else if (slab->sharedHeaderList != NULL && slab->sharedHeaderList->next != NULL &&
+				 slab->sharedHeaderList->next->next != NULL &&
+				 slab->sharedHeaderList->next->next->memoryAccountId == ActiveMemoryAccountId)
+		{
+			desiredHeader = slab->sharedHeaderList->next->next;
+		}
+		else
+		{
+			/* The last 3 headers are not suitable for next chunk, so we need a new shared header */
+			desiredHeader = gp_malloc(sizeof(SharedChunkHeader));
+			if (desiredHeader == NULL)
+				MemoryContextError(ERRCODE_OUT_OF_MEMORY,
+								   &slab->header, CDB_MCXT_WHERE(&slab->header),
+								   "Out of memory.  Failed on request of size %lu bytes.",
+								   (unsigned long) sizeof(SharedChunkHeader));
+
+			desiredHeader->context = (MemoryContext) slab;
+			desiredHeader->memoryAccountId = ActiveMemoryAccountId;
+			desiredHeader->balance = 0;
+
+			desiredHeader->next = slab->sharedHeaderList;
+			if (desiredHeader->next != NULL)
+				desiredHeader->next->prev = desiredHeader;
+			desiredHeader->prev = NULL;
+
+			slab->sharedHeaderList = desiredHeader;
+
+			MemoryContextNoteAlloc(&slab->header, sizeof(SharedChunkHeader));
+			if (SharedChunkHeadersMemoryAccount != NULL)
+				MemoryAccounting_Allocate(MEMORY_OWNER_TYPE_SharedChunkHeader,
+										  sizeof(SharedChunkHeader));
+		}
+
+		desiredHeader->balance += slab->fullChunkSize;
+		header->sharedHeader = desiredHeader;
+
+		MemoryAccounting_Allocate(ActiveMemoryAccountId, slab->fullChunkSize);
+	}
+	else
+	{
+		/* We have NULL ActiveMemoryAccount, so use nullAccountHeader */
+		if (slab->nullAccountHeader == NULL)
+		{
+			SharedChunkHeader *desiredHeader = gp_malloc(sizeof(SharedChunkHeader));
+
+			if (desiredHeader == NULL)
+				MemoryContextError(ERRCODE_OUT_OF_MEMORY,
+								   &slab->header, CDB_MCXT_WHERE(&slab->header),
+								   "Out of memory.  Failed on request of size %lu bytes.",
+								   (unsigned long) sizeof(SharedChunkHeader));
+
+			desiredHeader->context = (MemoryContext) slab;
+			desiredHeader->memoryAccountId = MEMORY_OWNER_TYPE_Undefined;
+			desiredHeader->balance = 0;
+			desiredHeader->prev = NULL;
+			desiredHeader->next = NULL;
+
+			slab->nullAccountHeader = desiredHeader;
+
+			MemoryContextNoteAlloc(&slab->header, sizeof(SharedChunkHeader));
+		}
+
+		header->sharedHeader = slab->nullAccountHeader;
+		slab->nullAccountHeader->balance += slab->fullChunkSize;
+	}
+
+#ifdef CDB_PALLOC_TAGS
+	header->prev_chunk = NULL;
+	header->next_chunk = slab->allocList;
+	if (slab->allocList)
+		slab->allocList->prev_chunk = header;
+	slab->allocList = header;
+
+	header->alloc_tag = slab->header.callerFile;
+	header->alloc_n = slab->header.callerLine;
+#endif
+}
+
+/*
+ * SlabFreeInfo
+ *		Release the shared header linkage and memory accounting of a chunk
+ *		that is being freed.  Mirrors AllocFreeInfo() in aset.c.
+ */
+static void
+SlabFreeInfo(Slab slab, StandardChunkHeader *header)
+{
+	SharedChunkHeader *sharedHeader = header->sharedHeader;
+
+	Assert(sharedHeader != NULL);
+
+	sharedHeader->balance -= slab->fullChunkSize;
+	Assert(sharedHeader->balance >= 0);
+
+	if (sharedHeader->memoryAccountId != MEMORY_OWNER_TYPE_Undefined)
+	{
+		MemoryAccounting_Free(sharedHeader->memoryAccountId, slab->fullChunkSize);
+
+		if (sharedHeader->balance == 0)
+		{
+			/* No chunk is sharing this header, so remove it from the sharedHeaderList */
+			Assert(slab->sharedHeaderList != NULL &&
+				   (slab->sharedHeaderList->next != NULL || slab->sharedHeaderList == sharedHeader));
+
+			if (sharedHeader->prev != NULL)
+				sharedHeader->prev->next = sharedHeader->next;
+			else
+			{
+				Assert(slab->sharedHeaderList == sharedHeader);
+				slab->sharedHeaderList = sharedHeader->next;
+			}
+			if (sharedHeader->next != NULL)
+				sharedHeader->next->prev = sharedHeader->prev;
+
+			if (SharedChunkHeadersMemoryAccount != NULL)
+				MemoryAccounting_Free(MEMORY_OWNER_TYPE_SharedChunkHeader,
+									  sizeof(SharedChunkHeader));
+			MemoryContextNoteFree(&slab->header, sizeof(SharedChunkHeader));
+			gp_free(sharedHeader);
+		}
+	}
+	else
+	{
+		/*
+		 * As in aset.c, we don't try to free the nullAccountHeader, even if
+		 * its balance reaches 0 (MPP-22566).
+		 */
+		Assert(sharedHeader == slab->nullAccountHeader);
+	}
+
+#ifdef CDB_PALLOC_TAGS
+	{
+		StandardChunkHeader *prev = header->prev_chunk;
+		StandardChunkHeader *next = header->next_chunk;
+
+		if (prev != NULL)
+			prev->next_chunk = next;
+		else
+		{
+			Assert(slab->allocList == header);
+			slab->allocList = next;
+		}
+		if (next != NULL)
+			next->prev_chunk = prev;
+	}
+#endif
+}
+
+/*
+ * Public routines
+ */
+
+
+/*
+ * SlabContextCreate
+ *		Create a new Slab context.
+ *
+ * parent: parent context, or NULL if top-level context
+ * name: name of context (for debugging --- string will be copied)
+ * blockSize: allocation block size
+ * chunkSize: allocation chunk size
+ *
+ * Unlike AllocSet, all allocations from a Slab context must fit in
+ * chunkSize; requests for exactly chunkSize bytes are the intended use.
+ */
+MemoryContext
+SlabContextCreate(MemoryContext parent,
+				  const char *name,
+				  Size blockSize,
+				  Size chunkSize)
+{
+	Slab		slab;
+	int			chunksPerBlock;
+	Size		fullChunkSize;
+
+	/* chunk, including header, must be maxaligned to keep callers happy */
+	chunkSize = MAXALIGN(chunkSize);
+	fullChunkSize = SLAB_CHUNKHDRSZ + chunkSize;
+
+	/* make sure the block can hold at least one chunk */
+	if (blockSize < SLAB_BLOCKHDRSZ + fullChunkSize)
+		elog(ERROR, "block size %lu for slab is too small for chunks %lu",
+			 (unsigned long) blockSize, (unsigned long) chunkSize);
+
+	chunksPerBlock = (blockSize - SLAB_BLOCKHDRSZ) / fullChunkSize;
+
+	/* Do the type-independent part of context creation */
+	slab = (Slab) MemoryContextCreate(T_SlabContext,
+									  offsetof(SlabContext, freelist) +
+									  sizeof(SlabBlock) * (chunksPerBlock + 1),
+									  &SlabMethods,
+									  parent,
+									  name);
+
+	slab->chunkSize = chunkSize;
+	slab->fullChunkSize = fullChunkSize;
+	slab->blockSize = blockSize;
+	slab->chunksPerBlock = chunksPerBlock;
+	slab->minFreeChunks = 0;
+	slab->nblocks = 0;
+	slab->isReset = true;
+	slab->sharedHeaderList = NULL;
+	slab->nullAccountHeader = NULL;
+#ifdef CDB_PALLOC_TAGS
+	slab->allocList = NULL;
+#endif
+
+	return (MemoryContext) slab;
+}
+
+/*
+ * SlabInit
+ *		Context-type-specific initialization routine.
+ */
+static void
+SlabInit(MemoryContext context)
+{
+	/*
+	 * Since MemoryContextCreate already zeroed the context node (including
+	 * the freelist array), we don't have to do anything here.
+	 */
+}
+
+/*
+ * SlabReleaseAccountingForAllAllocatedChunks
+ *		Releases the memory accounting of all the shared headers in the
+ *		sharedHeaderList, and frees the headers themselves.
+ *
+ * This is called by SlabReset() and SlabDelete(), which release all the
+ * in-use chunks in bulk.  Unlike aset.c, the headers are not hosted inside
+ * the context's own blocks, so they must be freed here; afterwards any
+ * surviving chunk pointers into this context are invalid, which is fine
+ * because the callers are about to release all the blocks too.
+ */
+static void
+SlabReleaseAccountingForAllAllocatedChunks(MemoryContext context)
+{
+	Slab		slab = (Slab) context;
+	SharedChunkHeader *curHeader = slab->sharedHeaderList;
+
+	/* The memory consumed by the shared headers themselves */
+	uint64		sharedHeaderMemoryOverhead = 0;
+
+	while (curHeader != NULL)
+	{
+		SharedChunkHeader *nextHeader = curHeader->next;
+
+		Assert(curHeader->balance > 0);
+		MemoryAccounting_Free(curHeader->memoryAccountId, curHeader->balance);
+
+		sharedHeaderMemoryOverhead += sizeof(SharedChunkHeader);
+		MemoryContextNoteFree(&slab->header, sizeof(SharedChunkHeader));
+		gp_free(curHeader);
+
+		curHeader = nextHeader;
+	}
+
+	/*
+	 * In addition to releasing accounting for the chunks, we also need
+	 * to release accounting for the shared headers
+	 */
+	MemoryAccounting_Free(MEMORY_OWNER_TYPE_SharedChunkHeader,
+						  sharedHeaderMemoryOverhead);
+
+	slab->sharedHeaderList = NULL;
+
+	if (slab->nullAccountHeader != NULL)
+	{
+		MemoryContextNoteFree(&slab->header, sizeof(SharedChunkHeader));
+		gp_free(slab->nullAccountHeader);
+		slab->nullAccountHeader = NULL;
+	}
+
+#ifdef CDB_PALLOC_TAGS
+	slab->allocList = NULL;
+#endif
+}
+
+/*
+ * SlabReset
+ *		Frees all memory which is allocated in the given slab.
+ *
+ * The code simply frees all the blocks in the context; we don't keep any
+ * keeper block, since a fresh block is cheap to set up and the typical
+ * use (per-batch executor state) resets only when it is about to refill.
+ */
+static void
+SlabReset(MemoryContext context)
+{
+	Slab		slab = (Slab) context;
+	int			i;
+
+	AssertArg(slab != NULL);
+
+	/* Nothing to do if no pallocs since startup or last reset */
+	if (slab->isReset)
+		return;
+
+#ifdef MEMORY_CONTEXT_CHECKING
+	/* Check for corruption and leaks before freeing */
+	SlabCheck(context);
+#endif
+
+	SlabReleaseAccountingForAllAllocatedChunks(context);
+
+	/* walk over freelists and free the blocks */
+	for (i = 0; i <= slab->chunksPerBlock; i++)
+	{
+		SlabBlock	block = slab->freelist[i];
+
+		slab->freelist[i] = NULL;
+
+		while (block != NULL)
+		{
+			SlabBlock	next = block->next;
+			size_t		freesz = UserPtr_GetUserPtrSize(block);
+
+			MemoryContextNoteFree(&slab->header, freesz);
+
+#ifdef CLOBBER_FREED_MEMORY
+			/* Wipe freed memory for debugging purposes */
+			memset(block, 0x7F, slab->blockSize);
+#endif
+			gp_free(block);
+			slab->nblocks--;
+			block = next;
+		}
+	}
+
+	Assert(slab->nblocks == 0);
+	slab->minFreeChunks = 0;
+	slab->isReset = true;
+}
+
+/*
+ * SlabDelete
+ *		Frees all memory which is allocated in the given slab, in
+ *		preparation for deletion of the slab.
+ */
+static void
+SlabDelete(MemoryContext context)
+{
+	/* just reset the context; we don't hold onto any resource across resets */
+	SlabReset(context);
+}
+
+/*
+ * SlabAlloc
+ *		Returns pointer to an allocated chunk of at least the given size;
+ *		sizes exceeding the context's chunkSize are not supported.
+ */
+static void *
+SlabAlloc(MemoryContext context, Size size)
+{
+	Slab		slab = (Slab) context;
+	SlabBlock	block;
+	StandardChunkHeader *header;
+	void	   *pointer;
+	int			idx;
+
+	AssertArg(slab != NULL);
+
+	if (size > slab->chunkSize)
+		MemoryContextError(ERRCODE_INTERNAL_ERROR,
+						   &slab->header, CDB_MCXT_WHERE(&slab->header),
+						   "unexpected slab allocation size %lu (chunk size %lu)",
+						   (unsigned long) size, (unsigned long) slab->chunkSize);
+
+	/*
+	 * If there are no blocks with free chunks, allocate a new block and
+	 * build its free chunk list.
+	 */
+	if (slab->minFreeChunks == 0)
+	{
+		int			i;
+
+		block = (SlabBlock) gp_malloc(slab->blockSize);
+		if (block == NULL)
+			MemoryContextError(ERRCODE_OUT_OF_MEMORY,
+							   &slab->header, CDB_MCXT_WHERE(&slab->header),
+							   "Out of memory.  Failed on request of size %lu bytes.",
+							   (unsigned long) size);
+
+		block->nfree = slab->chunksPerBlock;
+		block->firstFreeChunk = 0;
+
+		/* chain all chunks into the block's free list */
+		for (i = 0; i < slab->chunksPerBlock; i++)
+		{
+			int32	   *nextidx = (int32 *) SlabBlockGetChunkPointer(slab, block, i);
+
+			*nextidx = i + 1;
+#ifdef MEMORY_CONTEXT_CHECKING
+			SlabPointerGetHeader(nextidx)->requested_size = 0xFFFFFFFF;
+#endif
+		}
+
+		slab->nblocks++;
+		slab->minFreeChunks = slab->chunksPerBlock;
+		SlabFreelistPush(slab, block);
+
+		MemoryContextNoteAlloc(&slab->header, slab->blockSize);
+	}
+
+	/* grab the fullest block that has free chunks */
+	block = slab->freelist[slab->minFreeChunks];
+	Assert(block != NULL && block->nfree > 0);
+
+	/* pop the first free chunk */
+	idx = block->firstFreeChunk;
+	Assert(idx >= 0 && idx < slab->chunksPerBlock);
+	pointer = SlabBlockGetChunkPointer(slab, block, idx);
+	block->firstFreeChunk = *(int32 *) pointer;
+
+	/* move the block to the freelist matching its new free count */
+	SlabFreelistRemove(slab, block);
+	block->nfree--;
+	SlabFreelistPush(slab, block);
+
+	/*
+	 * Maintain minFreeChunks: the block either still defines a new, smaller
+	 * minimum, or (if it just became full) the old list must be rescanned.
+	 */
+	if (block->nfree > 0)
+		slab->minFreeChunks = block->nfree;
+	else if (slab->freelist[slab->minFreeChunks] == NULL)
+		SlabUpdateMinFreeChunks(slab, slab->minFreeChunks);
+
+	/* set up the chunk headers */
+	*SlabPointerGetBlockPtr(pointer) = block;
+	header = SlabPointerGetHeader(pointer);
+	header->size = slab->chunkSize;
+#ifdef MEMORY_CONTEXT_CHECKING
+	header->requested_size = size;
+	/* set mark to catch clobber of "unused" space */
+	if (size < slab->chunkSize)
+		((char *) pointer)[size] = 0x7E;
+#endif
+
+	slab->isReset = false;
+
+	SlabAllocInfo(slab, header);
+
+	return pointer;
+}
+
+/*
+ * SlabFree
+ *		Frees an allocated chunk; the chunk is pushed back on its block's
+ *		free list, and a fully-free block is returned to the host memory
+ *		manager.
+ */
+static void
+SlabFree(MemoryContext context, void *pointer)
+{
+	Slab		slab = (Slab) context;
+	StandardChunkHeader *header = SlabPointerGetHeader(pointer);
+	SlabBlock	block = *SlabPointerGetBlockPtr(pointer);
+	int			idx = SlabPointerGetChunkIndex(slab, block, pointer);
+	int			oldnfree;
+
+	Assert(idx >= 0 && idx < slab->chunksPerBlock);
+
+	SlabFreeInfo(slab, header);
+
+#ifdef MEMORY_CONTEXT_CHECKING
+	Assert(header->requested_size != 0xFFFFFFFF);
+	/* Test for someone scribbling on unused space in chunk */
+	if (header->requested_size < slab->chunkSize)
+	{
+		if (((char *) pointer)[header->requested_size] != 0x7E)
+		{
+			Assert(!"Memory error");
+			elog(WARNING, "detected write past chunk end in %s %p (%s:%d)",
+				 slab->header.name, pointer, CDB_MCXT_WHERE(&slab->header));
+		}
+	}
+	header->requested_size = 0xFFFFFFFF;
+#endif
+
+#ifdef CLOBBER_FREED_MEMORY
+	/* Wipe freed memory for debugging purposes */
+	memset(pointer, 0x7F, slab->chunkSize);
+#endif
+
+	/* push the chunk onto the block's free list */
+	*(int32 *) pointer = block->firstFreeChunk;
+	block->firstFreeChunk = idx;
+
+	oldnfree = block->nfree;	/* index of the freelist the block leaves */
+
+	SlabFreelistRemove(slab, block);
+	block->nfree++;
+
+	if (block->nfree == slab->chunksPerBlock)
+	{
+		/* Block is entirely free, so return it to the host memory manager. */
+		size_t		freesz = UserPtr_GetUserPtrSize(block);
+
+		MemoryContextNoteFree(&slab->header, freesz);
+#ifdef CLOBBER_FREED_MEMORY
+		memset(block, 0x7F, slab->blockSize);
+#endif
+		gp_free(block);
+		slab->nblocks--;
+	}
+	else
+		SlabFreelistPush(slab, block);
+
+	/*
+	 * Maintain minFreeChunks.  It can only move up here: the freed chunk
+	 * moved the block onto a higher freelist (or out of the context).  A
+	 * rescan is needed if there previously was no block with free chunks,
+	 * or if the block left the freelist that defined the minimum and that
+	 * list is now empty.
+	 */
+	if (slab->minFreeChunks == 0 ||
+		(slab->minFreeChunks == oldnfree && slab->freelist[oldnfree] == NULL))
+		SlabUpdateMinFreeChunks(slab, Max(oldnfree, 1));
+}
+
+/*
+ * SlabRealloc
+ *		Slab contexts hold objects of a single size, so realloc makes no
+ *		sense here; always throws error.
+ */
+static void *
+SlabRealloc(MemoryContext context, void *pointer, Size size)
+{
+	Slab		slab = (Slab) context;
+
+	MemoryContextError(ERRCODE_INTERNAL_ERROR,
+					   &slab->header, CDB_MCXT_WHERE(&slab->header),
+					   "slab allocator does not support realloc()");
+	return NULL;				/* keep compiler quiet */
+}
+
+/*
+ * SlabGetChunkSpace
+ *		Given a currently-allocated chunk, determine the total space it
+ *		uses (including all memory-allocation overhead).
+ */
+static Size
+SlabGetChunkSpace(MemoryContext context, void *pointer)
+{
+	Slab		slab = (Slab) context;
+
+	return slab->fullChunkSize;
+}
+
+/*
+ * SlabIsEmpty
+ *		Is a slab empty of any allocated space?
+ */
+static bool
+SlabIsEmpty(MemoryContext context)
+{
+	Slab		slab = (Slab) context;
+
+	return slab->isReset;
+}
+
+/*
+ * Slab_GetStats
+ *		Returns stats about memory consumption of a Slab context, in the
+ *		same terms as AllocSet_GetStats.
+ */
+static void
+Slab_GetStats(MemoryContext context, uint64 *nBlocks, uint64 *nChunks,
+		uint64 *currentAvailable, uint64 *allAllocated, uint64 *allFreed, uint64 *maxHeld)
+{
+	Slab		slab = (Slab) context;
+	int			i;
+	uint64		nFreeChunks = 0;
+
+	for (i = 1; i <= slab->chunksPerBlock; i++)
+	{
+		SlabBlock	block;
+
+		for (block = slab->freelist[i]; block != NULL; block = block->next)
+			nFreeChunks += block->nfree;
+	}
+
+	*nBlocks = slab->nblocks;
+	*nChunks = (uint64) slab->nblocks * slab->chunksPerBlock;
+	*currentAvailable = nFreeChunks * slab->fullChunkSize;
+	*allAllocated = slab->header.allBytesAlloc;
+	*allFreed = slab->header.allBytesFreed;
+	*maxHeld = slab->header.maxBytesHeld;
+}
+
+#ifdef MEMORY_CONTEXT_CHECKING
+
+/*
+ * SlabCheck
+ *		Walk through all blocks and cross-check the free chunk lists
+ *		against the per-block free counts.
+ */
+static void
+SlabCheck(MemoryContext context)
+{
+	Slab		slab = (Slab) context;
+	const char *name = slab->header.name;
+	int			i;
+	int			nblocks = 0;
+
+	for (i = 0; i <= slab->chunksPerBlock; i++)
+	{
+		SlabBlock	block;
+
+		for (block = slab->freelist[i]; block != NULL; block = block->next)
+		{
+			int			nfree = 0;
+			int			idx = block->firstFreeChunk;
+
+			nblocks++;
+
+			if (block->nfree != i)
+				elog(WARNING, "problem in slab %s: block %p in freelist %d has %d free chunks",
+					 name, block, i, block->nfree);
+
+			/* walk the free chunk list and count its length */
+			while (idx < slab->chunksPerBlock)
+			{
+				void	   *pointer = SlabBlockGetChunkPointer(slab, block, idx);
+
+				if (SlabPointerGetHeader(pointer)->requested_size != 0xFFFFFFFF)
+					elog(WARNING, "problem in slab %s: free chunk %d of block %p is marked in-use",
+						 name, idx, block);
+
+				nfree++;
+				idx = *(int32 *) pointer;
+			}
+
+			if (nfree != block->nfree)
+				elog(WARNING, "problem in slab %s: block %p has nfree %d but %d chunks on free list",
+					 name, block, block->nfree, nfree);
+		}
+	}
+
+	if (nblocks != slab->nblocks)
+		elog(WARNING, "problem in slab %s: found %d blocks but nblocks is %d",
+			 name, nblocks, slab->nblocks);
+}
+
+#endif   /* MEMORY_CONTEXT_CHECKING */
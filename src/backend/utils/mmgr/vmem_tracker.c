@@ -45,6 +45,13 @@ extern void IdleTracker_Shutdown(void);
 
 /* Number of Vmem chunks tracked by this process */
 static int32 trackedVmemChunks = 0;
+/*
+ * Number of chunks this process has charged to the shared session/segment
+ * counters beyond trackedVmemChunks (gp_vmem_lease_chunks > 0).  Growth
+ * covered by the lease is accounted purely locally, so the shared counters
+ * are touched once per lease instead of once per chunk.
+ */
+static int32 leasedVmemChunks = 0;
 /* Maximum number of vmem chunks tracked by this process */
 static int32 maxVmemChunksTracked = 0;
 /* Number of bytes tracked (i.e., allocated under the tutelage of vmem tracker) */
@@ -191,17 +198,22 @@ VmemTracker_ResetMaxVmemReserved()
 }
 
 /*
- * Reserve 'num_chunks_to_reserve' number of chunks for current process. The
- * reservation is validated against segment level vmem quota.
+ * Reserve 'num_chunks_to_reserve' number of chunks for current process, plus
+ * 'numLeaseChunks' additional chunks that are charged to the shared counters
+ * but kept as a local lease for future growth.  The reservation is validated
+ * against segment level vmem quota.
  */
 static MemoryAllocationStatus
-VmemTracker_ReserveVmemChunks(int32 numChunksToReserve)
+VmemTracker_ReserveVmemChunks(int32 numChunksToReserve, int32 numLeaseChunks)
 {
 	Assert(vmemTrackerInited);
 	Assert(NULL != MySessionState);
 
 	Assert(0 < numChunksToReserve);
-	int32 total = pg_atomic_add_fetch_u32((pg_atomic_uint32 *)&MySessionState->sessionVmem, numChunksToReserve);
+	Assert(0 <= numLeaseChunks);
+
+	int32 numChunksToCharge = numChunksToReserve + numLeaseChunks;
+	int32 total = pg_atomic_add_fetch_u32((pg_atomic_uint32 *)&MySessionState->sessionVmem, numChunksToCharge);
 	Assert(total > (int32) 0);
 
 
@@ -210,9 +222,9 @@ VmemTracker_ReserveVmemChunks(int32 numChunksToReserve)
 
 	bool waiverUsed = false;
 
-	if (!ResGroupReserveMemory(numChunksToReserve, waivedChunks, &waiverUsed))
+	if (!ResGroupReserveMemory(numChunksToCharge, waivedChunks, &waiverUsed))
 	{
-		pg_atomic_sub_fetch_u32((pg_atomic_uint32 *)&MySessionState->sessionVmem, numChunksToReserve);
+		pg_atomic_sub_fetch_u32((pg_atomic_uint32 *)&MySessionState->sessionVmem, numChunksToCharge);
 		return MemoryFailure_ResourceGroupMemoryExhausted;
 	}
 
@@ -229,16 +241,16 @@ VmemTracker_ReserveVmemChunks(int32 numChunksToReserve)
 		if (total > memLimitPerQuery + waivedChunks)
 		{
 			/* Revert the reserved space, but don't revert the prev_alloc as we have already set the firstTime to false */
-			pg_atomic_sub_fetch_u32((pg_atomic_uint32 *)&MySessionState->sessionVmem, numChunksToReserve);
+			pg_atomic_sub_fetch_u32((pg_atomic_uint32 *)&MySessionState->sessionVmem, numChunksToCharge);
 			/* Revert resgroup memory reservation */
-			ResGroupReleaseMemory(numChunksToReserve);
+			ResGroupReleaseMemory(numChunksToCharge);
 			return MemoryFailure_QueryMemoryExhausted;
 		}
 		waiverUsed = true;
 	}
 
 	/* Now reserve vmem at segment level */
-	int32 new_vmem = pg_atomic_add_fetch_u32((pg_atomic_uint32 *)segmentVmemChunks, numChunksToReserve);
+	int32 new_vmem = pg_atomic_add_fetch_u32((pg_atomic_uint32 *)segmentVmemChunks, numChunksToCharge);
 	int32 vmemLimitChunks = VmemTracker_GetVmemLimitChunks();
 
 	/*
@@ -252,11 +264,11 @@ VmemTracker_ReserveVmemChunks(int32 numChunksToReserve)
 		if (new_vmem > vmemLimitChunks + waivedChunks)
 		{
 			/* Revert query memory reservation */
-			pg_atomic_sub_fetch_u32((pg_atomic_uint32 *)&MySessionState->sessionVmem, numChunksToReserve);
+			pg_atomic_sub_fetch_u32((pg_atomic_uint32 *)&MySessionState->sessionVmem, numChunksToCharge);
 			/* Revert vmem reservation */
-			pg_atomic_sub_fetch_u32((pg_atomic_uint32 *)segmentVmemChunks, numChunksToReserve);
+			pg_atomic_sub_fetch_u32((pg_atomic_uint32 *)segmentVmemChunks, numChunksToCharge);
 			/* Revert resgroup memory reservation */
-			ResGroupReleaseMemory(numChunksToReserve);
+			ResGroupReleaseMemory(numChunksToCharge);
 
 			return MemoryFailure_VmemExhausted;
 		}
@@ -265,6 +277,7 @@ VmemTracker_ReserveVmemChunks(int32 numChunksToReserve)
 
 	/* The current process now owns additional vmem in this segment */
 	trackedVmemChunks += numChunksToReserve;
+	leasedVmemChunks += numLeaseChunks;
 
 	maxVmemChunksTracked = Max(maxVmemChunksTracked, trackedVmemChunks);
 
@@ -281,10 +294,11 @@ VmemTracker_ReserveVmemChunks(int32 numChunksToReserve)
 }
 
 /*
- * Releases "reduction" number of chunks to the session and segment vmem counter.
+ * Releases "reduction" number of chunks to the session and segment vmem
+ * counter, without touching this process' local bookkeeping.
  */
 static void
-VmemTracker_ReleaseVmemChunks(int reduction)
+VmemTracker_ReleaseSharedChunks(int reduction)
 {
 	Assert(0 <= reduction);
 	/* We don't support vmem usage from non-owner thread */
@@ -297,17 +311,33 @@ VmemTracker_ReleaseVmemChunks(int reduction)
 	pg_atomic_sub_fetch_u32((pg_atomic_uint32 *)&MySessionState->sessionVmem, reduction);
 	ResGroupReleaseMemory(reduction);
 	Assert(0 <= MySessionState->sessionVmem);
+}
+
+/*
+ * Releases "reduction" number of chunks to the session and segment vmem counter.
+ */
+static void
+VmemTracker_ReleaseVmemChunks(int reduction)
+{
+	VmemTracker_ReleaseSharedChunks(reduction);
 	trackedVmemChunks -= reduction;
 }
 
 /*
- * Releases all vmem reserved by this process.
+ * Releases all vmem reserved by this process, including any unused lease.
  */
 static void
 ReleaseAllVmemChunks()
 {
 	VmemTracker_ReleaseVmemChunks(trackedVmemChunks);
 	Assert(0 == trackedVmemChunks);
+
+	if (leasedVmemChunks > 0)
+	{
+		VmemTracker_ReleaseSharedChunks(leasedVmemChunks);
+		leasedVmemChunks = 0;
+	}
+
 	trackedBytes = 0;
 }
 
@@ -576,7 +606,41 @@ VmemTracker_ReserveVmem(int64 newlyRequestedBytes)
 		ReportOOMConsumption();
 
 		int32 needChunk = newszChunk - trackedVmemChunks;
-		status = VmemTracker_ReserveVmemChunks(needChunk);
+
+		/* Serve as much of the growth as possible from the local lease */
+		int32 fromLease = Min(needChunk, leasedVmemChunks);
+
+		if (fromLease > 0)
+		{
+			leasedVmemChunks -= fromLease;
+			trackedVmemChunks += fromLease;
+			needChunk -= fromLease;
+		}
+
+		if (needChunk > 0)
+		{
+			/*
+			 * We have to touch the shared counters anyway, so top up the
+			 * lease to its target size in the same operation.  The lease is
+			 * opportunistic: if the enlarged reservation doesn't fit under
+			 * the limits, retry with just what the caller needs.
+			 */
+			int32 leaseChunk = Max(gp_vmem_lease_chunks - leasedVmemChunks, 0);
+
+			status = VmemTracker_ReserveVmemChunks(needChunk, leaseChunk);
+
+			if (MemoryAllocation_Success != status && leaseChunk > 0)
+				status = VmemTracker_ReserveVmemChunks(needChunk, 0);
+
+			if (MemoryAllocation_Success != status && fromLease > 0)
+			{
+				/* Undo the part of the growth we took from the lease */
+				leasedVmemChunks += fromLease;
+				trackedVmemChunks -= fromLease;
+			}
+		}
+		else
+			maxVmemChunksTracked = Max(maxVmemChunksTracked, trackedVmemChunks);
 	}
 
 	/* Failed to reserve vmem chunks. Revert changes to trackedBytes */
@@ -627,10 +691,44 @@ VmemTracker_ReleaseVmem(int64 toBeFreedRequested)
 	{
 		int reduction = trackedVmemChunks - newszChunk;
 
-		VmemTracker_ReleaseVmemChunks(reduction);
+		if (gp_vmem_lease_chunks > 0)
+		{
+			/*
+			 * Keep the released chunks as a local lease so the next
+			 * reservation doesn't have to go to the shared counters, but
+			 * trim the lease back to its target once it doubles.
+			 */
+			trackedVmemChunks -= reduction;
+			leasedVmemChunks += reduction;
+
+			if (leasedVmemChunks > 2 * gp_vmem_lease_chunks)
+			{
+				int32 surplus = leasedVmemChunks - gp_vmem_lease_chunks;
+
+				leasedVmemChunks -= surplus;
+				VmemTracker_ReleaseSharedChunks(surplus);
+			}
+		}
+		else
+			VmemTracker_ReleaseVmemChunks(reduction);
 	}
 }
 
+/*
+ * Returns any unused vmem lease to the shared counters.  Called when the
+ * process goes idle, so that idle backends don't sit on memory that other
+ * backends could reserve.
+ */
+void
+VmemTracker_ReturnLease(void)
+{
+	if (!vmemTrackerInited || 0 == leasedVmemChunks)
+		return;
+
+	VmemTracker_ReleaseSharedChunks(leasedVmemChunks);
+	leasedVmemChunks = 0;
+}
+
 /*
  * Request additional VMEM bytes beyond per-session or system vmem limit for
  * OOM error handling.
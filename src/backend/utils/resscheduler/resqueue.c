@@ -32,6 +32,7 @@
 #include "funcapi.h"
 #include "miscadmin.h"
 #include "pgstat.h"
+#include "portability/instr_time.h"
 #include "storage/lock.h"
 #include "storage/lmgr.h"
 #include "utils/builtins.h"
@@ -63,6 +64,10 @@ static uint64 ResourceQueueGetSuperuserQueryMemoryLimit(void);
 static HTAB *ResPortalIncrementHash;	/* Hash of resource increments. */
 static HTAB *ResQueueHash;		/* Hash of resource queues. */
 
+/* Queue this process is currently waiting in, for the wait statistics. */
+static Oid	resWaitQueueId = InvalidOid;
+static instr_time resWaitStartTime;
+
 
 /*
  * Record structure holding the to be exposed per queue data, used by
@@ -313,6 +318,8 @@ ResLockAcquire(LOCKTAG *locktag, ResPortalIncrement *incrementSet)
 	 */
 	if (incrementSet->increments[RES_COST_LIMIT] < queue->ignorecostlimit)
 	{
+		queue->stats.ignored++;
+
 		/* Decrement requested. */
 		lock->nRequested--;
 		lock->requested[lockmode]--;
@@ -381,6 +388,8 @@ ResLockAcquire(LOCKTAG *locktag, ResPortalIncrement *incrementSet)
 
 		ResIncrementRemove(&portalTag);
 
+		queue->stats.rejected++;
+
 		LWLockRelease(ResQueueLock);
 		LWLockRelease(partitionLock);
 		ereport(ERROR,
@@ -396,6 +405,8 @@ ResLockAcquire(LOCKTAG *locktag, ResPortalIncrement *incrementSet)
 		ResGrantLock(lock, proclock);
 		ResLockUpdateLimit(lock, proclock, incrementSet, true, false);
 
+		queue->stats.admitted++;
+
 		LWLockRelease(ResQueueLock);
 
 		/* Note the start time for queue statistics. */
@@ -420,6 +431,13 @@ ResLockAcquire(LOCKTAG *locktag, ResPortalIncrement *incrementSet)
 		 */
 		MyProc->waitPortalId = incrementSet->portalId;
 
+		/* Note queue depth and wait start for the wait statistics. */
+		queue->stats.nwaiters++;
+		if (queue->stats.nwaiters > queue->stats.nwaiters_max)
+			queue->stats.nwaiters_max = queue->stats.nwaiters;
+		resWaitQueueId = queue->queueid;
+		INSTR_TIME_SET_CURRENT(resWaitStartTime);
+
 		LWLockRelease(ResQueueLock);
 
 		/* Note count and wait time for queue statistics. */
@@ -458,6 +476,9 @@ ResLockAcquire(LOCKTAG *locktag, ResPortalIncrement *incrementSet)
 									 locktag->locktag_field1);
 		pgstat_record_start_queue_exec(incrementSet->portalId,
 									   locktag->locktag_field1);
+
+		/* Account the wait into the queue's shared statistics. */
+		ResQueueWaitStatsEndWait(true);
 	}
 
 	/* Release the	partition lock. */
@@ -1044,6 +1065,7 @@ ResWaitOnLock(LOCALLOCK *locallock, ResourceOwner owner, ResPortalIncrement *inc
 		/*
 		 * We failed as a result of a deadlock, see CheckDeadLock(). Quit now.
 		 */
+		ResQueueWaitStatsEndWait(false);
 		LWLockRelease(partitionLock);
 		DeadLockReport();
 	}
@@ -1062,6 +1084,70 @@ ResWaitOnLock(LOCALLOCK *locallock, ResourceOwner owner, ResPortalIncrement *inc
 }
 
 
+/*
+ * ResQueueWaitStatsEndWait -- account a finished queue wait.
+ *
+ * Called with 'granted' true on the normal wakeup path in ResLockAcquire,
+ * and with 'granted' false when the wait is abandoned (transaction abort,
+ * see ResLockWaitCancel, or deadlock).  A no-op if no wait was started, so
+ * it is safe to call from cleanup paths unconditionally.
+ *
+ * The caller may hold the lock table partition lock; we take ResQueueLock
+ * after it, which is the lock order used throughout this file.
+ */
+void
+ResQueueWaitStatsEndWait(bool granted)
+{
+	instr_time	elapsed;
+	uint64		us;
+	Oid			queueid = resWaitQueueId;
+	ResQueue	queue;
+
+	if (queueid == InvalidOid)
+		return;
+	resWaitQueueId = InvalidOid;
+
+	INSTR_TIME_SET_CURRENT(elapsed);
+	INSTR_TIME_SUBTRACT(elapsed, resWaitStartTime);
+	us = (uint64) (INSTR_TIME_GET_DOUBLE(elapsed) * 1000000.0);
+
+	LWLockAcquire(ResQueueLock, LW_EXCLUSIVE);
+	queue = ResQueueHashFind(queueid);
+	if (queue != NULL)
+	{
+		ResQueueStatsData *stats = &queue->stats;
+		uint64		bucket_top = 1000;	/* first bucket: < 1ms */
+		int			bucket;
+
+		stats->nwaiters--;
+		if (granted)
+			stats->admitted_after_wait++;
+		else
+			stats->wait_canceled++;
+
+		stats->wait_total_us += us;
+		if (us > stats->wait_max_us)
+			stats->wait_max_us = us;
+
+		for (bucket = 0; bucket < RES_QUEUE_WAIT_NBUCKETS - 1; bucket++)
+		{
+			if (us < bucket_top)
+				break;
+			bucket_top *= 4;
+		}
+		stats->wait_hist[bucket]++;
+	}
+	LWLockRelease(ResQueueLock);
+
+	/* The lock-wait deadline alarm: complain about long queue waits. */
+	if (gp_resqueue_wait_warning_time > 0 &&
+		us / 1000 >= (uint64) gp_resqueue_wait_warning_time)
+		ereport(LOG,
+				(errmsg("statement waited " UINT64_FORMAT " ms in resource queue %u",
+						us / 1000, queueid),
+				 errhint("See gp_resqueue_stats for accumulated wait statistics.")));
+}
+
 /*
  * ResProcLockRemoveSelfAndWakeup -- awaken any processses waiting on a resource lock.
  *
@@ -1588,6 +1674,9 @@ ResQueueHashNew(Oid queueid)
 	if (!queue)
 		return NULL;
 
+	/* Fresh queues start with zeroed statistics. */
+	MemSet(&queue->stats, 0, sizeof(queue->stats));
+
 	return (ResQueue) queue;
 }
 
@@ -1884,6 +1973,135 @@ BuildQueueStatusContext(QueueStatusContext *fctx)
 	return;
 }
 
+/* Number of columns produced by gp_resqueue_stats() */
+#define GP_RESQUEUE_STATS_COLUMNS (10 + RES_QUEUE_WAIT_NBUCKETS)
+
+/*
+ * Record structure holding one queue's statistics, used by
+ * gp_resqueue_stats().
+ */
+typedef struct
+{
+	Oid			queueid;
+	ResQueueStatsData stats;
+}	QueueStatsRec;
+
+/*
+ * gp_resqueue_stats - produce a view with one row per resource queue
+ *	showing accumulated admission and wait statistics.
+ */
+Datum
+gp_resqueue_stats(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx = NULL;
+	MemoryContext oldcontext = NULL;
+	QueueStatsRec *records;
+
+	if (SRF_IS_FIRSTCALL())
+	{
+		TupleDesc	tupledesc;
+
+		funcctx = SRF_FIRSTCALL_INIT();
+
+		/* Switch context when allocating stuff to be used in later calls */
+		oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+		/*
+		 * Allocate space for the per-call area - this overestimates, but
+		 * means we can take the queue lock after our memory context
+		 * switching.
+		 */
+		records = (QueueStatsRec *) palloc(sizeof(QueueStatsRec) * MaxResourceQueues);
+		funcctx->user_fctx = records;
+
+		/* Construct a tuple descriptor for the result rows. */
+		tupledesc = CreateTemplateTupleDesc(GP_RESQUEUE_STATS_COLUMNS, false);
+
+		TupleDescInitEntry(tupledesc, (AttrNumber) 1, "queueid", OIDOID, -1, 0);
+		TupleDescInitEntry(tupledesc, (AttrNumber) 2, "n_admitted", INT8OID, -1, 0);
+		TupleDescInitEntry(tupledesc, (AttrNumber) 3, "n_admitted_after_wait", INT8OID, -1, 0);
+		TupleDescInitEntry(tupledesc, (AttrNumber) 4, "n_rejected", INT8OID, -1, 0);
+		TupleDescInitEntry(tupledesc, (AttrNumber) 5, "n_ignored", INT8OID, -1, 0);
+		TupleDescInitEntry(tupledesc, (AttrNumber) 6, "n_wait_canceled", INT8OID, -1, 0);
+		TupleDescInitEntry(tupledesc, (AttrNumber) 7, "wait_total_us", INT8OID, -1, 0);
+		TupleDescInitEntry(tupledesc, (AttrNumber) 8, "wait_max_us", INT8OID, -1, 0);
+		TupleDescInitEntry(tupledesc, (AttrNumber) 9, "waiters", INT4OID, -1, 0);
+		TupleDescInitEntry(tupledesc, (AttrNumber) 10, "waiters_max", INT4OID, -1, 0);
+		TupleDescInitEntry(tupledesc, (AttrNumber) 11, "under_1ms", INT8OID, -1, 0);
+		TupleDescInitEntry(tupledesc, (AttrNumber) 12, "under_4ms", INT8OID, -1, 0);
+		TupleDescInitEntry(tupledesc, (AttrNumber) 13, "under_16ms", INT8OID, -1, 0);
+		TupleDescInitEntry(tupledesc, (AttrNumber) 14, "under_64ms", INT8OID, -1, 0);
+		TupleDescInitEntry(tupledesc, (AttrNumber) 15, "under_256ms", INT8OID, -1, 0);
+		TupleDescInitEntry(tupledesc, (AttrNumber) 16, "under_1s", INT8OID, -1, 0);
+		TupleDescInitEntry(tupledesc, (AttrNumber) 17, "under_4s", INT8OID, -1, 0);
+		TupleDescInitEntry(tupledesc, (AttrNumber) 18, "over_4s", INT8OID, -1, 0);
+
+		funcctx->tuple_desc = BlessTupleDesc(tupledesc);
+
+		/* Return to original context when allocating transient memory */
+		MemoryContextSwitchTo(oldcontext);
+
+		funcctx->max_calls = 0;
+
+		if (IsResQueueEnabled())
+		{
+			HASH_SEQ_STATUS hstatus;
+			ResQueueData *queue;
+			int			i = 0;
+
+			/* Copy out a stable image of every queue's statistics. */
+			LWLockAcquire(ResQueueLock, LW_SHARED);
+
+			hash_seq_init(&hstatus, ResQueueHash);
+			while ((queue = (ResQueueData *) hash_seq_search(&hstatus)) != NULL)
+			{
+				records[i].queueid = queue->queueid;
+				records[i].stats = queue->stats;
+				i++;
+				Assert(i <= MaxResourceQueues);
+			}
+
+			LWLockRelease(ResQueueLock);
+
+			funcctx->max_calls = i;
+		}
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+	records = (QueueStatsRec *) funcctx->user_fctx;
+
+	if (funcctx->call_cntr < funcctx->max_calls)
+	{
+		QueueStatsRec *record = &records[funcctx->call_cntr];
+		Datum		values[GP_RESQUEUE_STATS_COLUMNS];
+		bool		nulls[GP_RESQUEUE_STATS_COLUMNS];
+		HeapTuple	tuple;
+		int			bucket;
+
+		values[0] = ObjectIdGetDatum(record->queueid);
+		values[1] = Int64GetDatum((int64) record->stats.admitted);
+		values[2] = Int64GetDatum((int64) record->stats.admitted_after_wait);
+		values[3] = Int64GetDatum((int64) record->stats.rejected);
+		values[4] = Int64GetDatum((int64) record->stats.ignored);
+		values[5] = Int64GetDatum((int64) record->stats.wait_canceled);
+		values[6] = Int64GetDatum((int64) record->stats.wait_total_us);
+		values[7] = Int64GetDatum((int64) record->stats.wait_max_us);
+		values[8] = Int32GetDatum(record->stats.nwaiters);
+		values[9] = Int32GetDatum(record->stats.nwaiters_max);
+		for (bucket = 0; bucket < RES_QUEUE_WAIT_NBUCKETS; bucket++)
+			values[10 + bucket] = Int64GetDatum((int64) record->stats.wait_hist[bucket]);
+
+		MemSet(nulls, false, sizeof(nulls));
+
+		/* Build and return the tuple. */
+		tuple = heap_form_tuple(funcctx->tuple_desc, values, nulls);
+
+		SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+	}
+	else
+		SRF_RETURN_DONE(funcctx);
+}
+
 /* Number of records produced per queue. */
 #define PG_RESQUEUE_STATUS_KV_RECORDS_PER_QUEUE 8
 
@@ -61,6 +61,8 @@ int		MaxResourcePortalsPerXact;				/* Max # tracked portals -
 												 * per backend . */
 bool	ResourceSelectOnly;						/* Only lock SELECT/DECLARE? */
 bool	ResourceCleanupIdleGangs;				/* Cleanup idle gangs? */
+int		gp_resqueue_wait_warning_time;			/* Log waits longer than
+												 * this many ms; 0 is off. */
 
 
 /*
@@ -100,6 +100,8 @@
 
 #include "postgres.h"
 
+#include <math.h>
+
 #include "access/heapam.h"
 #include "access/nbtree.h"
 #include "access/tuptoaster.h"
@@ -125,7 +127,9 @@
 #include "utils/tuplesort_mk_details.h"
 #include "utils/string_wrapper.h"
 #include "utils/faultinjector.h"
+#include "utils/vmem_tracker.h"
 
+#include "cdb/cdbgang.h"		/* gp_pthread_create */
 #include "cdb/cdbvars.h"
 
 /*
@@ -283,6 +287,9 @@ struct Tuplesortstate_mk
 	 */
 	bool		statsFinalized;
 
+	/* Last red-zone pre-spill request we served */
+	uint32		prespill_serial;
+
 	int			currentRun;
 
 	/*
@@ -588,6 +595,9 @@ tuplesort_begin_common(ScanState *ss, int workMem, bool randomAccess, bool alloc
 
 	state->sortcontext = sortcontext;
 
+	/* Nothing to spill yet; ignore pre-spill requests that predate us */
+	state->prespill_serial = RedZoneHandler_GetPreSpillRequestCount();
+
 	if (allocmemtuple)
 	{
 		int			i;
@@ -683,6 +693,7 @@ create_mksort_context(
 	mkctxt->cpfr = tupsort_cpfr;
 	mkctxt->freeTup = freeTupleFn;
 	mkctxt->estimatedExtraForPrep = 0;
+	mkctxt->inThreadedSort = false;
 
 	lc_guess_strxfrm_scaling_factor(&mkctxt->strxfrmScaleFactor, &mkctxt->strxfrmConstantFactor);
 
@@ -743,6 +754,22 @@ create_mksort_context(
 				else if (sinfo->scanKey.sk_func.fn_addr == bttextcmp)
 					sinfo->lvtype = MKLV_TYPE_TEXT;
 			}
+
+			/*
+			 * Levels whose prepared form lends itself to an abbreviated key:
+			 * CHAR/TEXT keep a strxfrm'd copy whose first bytes we can pack
+			 * into an integer, and numeric keys abbreviate to an
+			 * order-preserving encoding of their double approximation.
+			 * Abbreviations are computed in tupsort_prepare, so they need
+			 * the prepare callback.
+			 */
+			if (fetchForPrep != NULL)
+			{
+				if (sinfo->lvtype == MKLV_TYPE_CHAR ||
+					sinfo->lvtype == MKLV_TYPE_TEXT ||
+					sinfo->scanKey.sk_func.fn_addr == numeric_cmp)
+					sinfo->useAbbrev = true;
+			}
 		}
 		else
 		{
@@ -1277,6 +1304,17 @@ puttuple_common(Tuplesortstate_mk *state, MKEntry *e)
 				tuplesort_inmem_limit_insert(state, e);
 			}
 
+			/*
+			 * Cooperative pre-spill: treat a vmem pressure signal from the
+			 * red-zone handler like running out of work_mem, and switch to
+			 * tape-based operation early to release memory. A bounded sort
+			 * that already built its in-memory heap holds little memory and
+			 * is left alone.
+			 */
+			if (growSucceed && state->mkheap == NULL && state->entry_count > 0 &&
+				RedZoneHandler_PreSpillRequested(&state->prespill_serial))
+				growSucceed = false;
+
 			/* If out of work_mem, switch to diskmode */
 			if (!growSucceed)
 			{
@@ -1323,6 +1361,249 @@ puttuple_common(Tuplesortstate_mk *state, MKEntry *e)
 	}
 }
 
+/*
+ * Multi-threaded in-memory sort.
+ *
+ * When gp_mk_sort_threads > 1, the in-memory entry array is partitioned
+ * across a small pool of worker threads, each partition is sorted with the
+ * ordinary mk_qsort kernel, and the sorted partitions are merged by the
+ * main thread.
+ *
+ * Backend code is not generally thread-safe, so this only runs for sorts
+ * whose entire comparison and preparation path is free of palloc, elog and
+ * catalog access: levels holding pass-by-value datums compared by one of
+ * the known side-effect-free btree comparators.  Text/char levels are out
+ * (preparing them allocates strxfrm buffers), as are unique sorts (the
+ * duplicate handling in the kernel pfrees and ereports).  The kernel also
+ * skips its interrupt checks while in a worker (see inThreadedSort); the
+ * main thread catches up on interrupts once the workers are joined.
+ */
+
+/* don't bother spinning up a thread for less than this many tuples */
+#define MKSORT_MIN_TUPLES_PER_THREAD 32768
+
+typedef struct MKSortChunkArg
+{
+	MKEntry    *a;
+	int			n;
+	MKContext  *ctxt;
+} MKSortChunkArg;
+
+static void *
+mksort_chunk_worker(void *arg)
+{
+	MKSortChunkArg *chunk = (MKSortChunkArg *) arg;
+
+	mk_qsort(chunk->a, chunk->n, chunk->ctxt);
+	return NULL;
+}
+
+/*
+ * Can this sort's compare/prepare path run outside the main thread?
+ */
+static bool
+mksort_parallel_safe(MKContext *ctxt)
+{
+	int			lv;
+
+	if (ctxt->unique || ctxt->enforceUnique)
+		return false;
+
+	for (lv = 0; lv < ctxt->total_lv; lv++)
+	{
+		MKLvContext *sinfo = ctxt->lvctxt + lv;
+		PGFunction	cmpfn = sinfo->scanKey.sk_func.fn_addr;
+
+		if (sinfo->lvtype == MKLV_TYPE_INT32)
+			continue;
+
+		if (sinfo->lvtype == MKLV_TYPE_NONE &&
+			sinfo->typByVal &&
+			(cmpfn == btint2cmp ||
+			 cmpfn == btint4cmp ||
+			 cmpfn == btint8cmp ||
+			 cmpfn == btoidcmp ||
+			 cmpfn == btfloat4cmp ||
+			 cmpfn == btfloat8cmp))
+			continue;
+
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * Compare two entries over all levels, preparing them as we go.  Used for
+ * merging sorted partitions, whose entries are prepared at arbitrary
+ * levels.  Only called for parallel-safe sorts, so preparation is cheap
+ * (pass-by-value fetch, nothing to free).
+ */
+static int32
+mksort_entry_full_compare(MKEntry *v1, MKEntry *v2, MKContext *ctxt)
+{
+	int			lv;
+	int32		ret;
+
+	for (lv = 0; lv < ctxt->total_lv; lv++)
+	{
+		if (ctxt->fetchForPrep)
+		{
+			tupsort_prepare(v1, ctxt, lv);
+			tupsort_prepare(v2, ctxt, lv);
+		}
+
+		ret = mke_get_nullbits(v1) - mke_get_nullbits(v2);
+		if (ret != 0)
+			return ret;
+
+		if (mke_is_null(v1))
+			continue;			/* both null at this level; try the next */
+
+		ret = tupsort_compare_datum(v1, v2, ctxt->lvctxt + lv, ctxt);
+		if (ret != 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+/*
+ * Merge two adjacent sorted runs of the entry array into dst.
+ */
+static void
+mksort_merge_two(MKEntry *a, int lo, int mid, int hi, MKEntry *dst,
+				 MKContext *ctxt)
+{
+	int			i = lo;
+	int			j = mid;
+	int			k = lo;
+
+	while (i < mid && j < hi)
+	{
+		if (mksort_entry_full_compare(a + i, a + j, ctxt) <= 0)
+			dst[k++] = a[i++];
+		else
+			dst[k++] = a[j++];
+	}
+	while (i < mid)
+		dst[k++] = a[i++];
+	while (j < hi)
+		dst[k++] = a[j++];
+}
+
+/*
+ * Sort an in-memory entry array, using worker threads when allowed and
+ * worthwhile, else the plain single-threaded kernel.
+ */
+static void
+mk_qsort_maybe_parallel(MKEntry *a, int n, MKContext *ctxt)
+{
+	int			nthreads;
+	int			nchunks;
+	int			i;
+	int			bounds[1 + 32];	/* chunk boundaries; nthreads is capped */
+	MKSortChunkArg chunks[32];
+	pthread_t	threads[32];
+	bool		started[32];
+	MKEntry    *scratch;
+	MKEntry    *src;
+	MKEntry    *dst;
+
+	/* Single fixed-width integer keys can skip comparison sorting. */
+	if (mk_radix_sort(a, n, ctxt))
+		return;
+
+	nthreads = gp_mk_sort_threads;
+	if (nthreads > n / MKSORT_MIN_TUPLES_PER_THREAD)
+		nthreads = n / MKSORT_MIN_TUPLES_PER_THREAD;
+	if (nthreads > 32)
+		nthreads = 32;
+
+	if (nthreads < 2 || !mksort_parallel_safe(ctxt))
+	{
+		mk_qsort(a, n, ctxt);
+		return;
+	}
+
+	/* carve the array into nthreads nearly-equal chunks */
+	for (i = 0; i <= nthreads; i++)
+		bounds[i] = (int) (((int64) n * i) / nthreads);
+
+	ctxt->inThreadedSort = true;
+
+	for (i = 1; i < nthreads; i++)
+	{
+		chunks[i].a = a + bounds[i];
+		chunks[i].n = bounds[i + 1] - bounds[i];
+		chunks[i].ctxt = ctxt;
+		started[i] = (gp_pthread_create(&threads[i], mksort_chunk_worker,
+										&chunks[i], "mksortWorker") == 0);
+	}
+
+	/* the main thread takes the first chunk */
+	mk_qsort(a + bounds[0], bounds[1] - bounds[0], ctxt);
+
+	/* sort any chunk whose thread failed to start, then join the rest */
+	for (i = 1; i < nthreads; i++)
+	{
+		if (started[i])
+			pthread_join(threads[i], NULL);
+		else
+			mk_qsort(chunks[i].a, chunks[i].n, ctxt);
+	}
+
+	ctxt->inThreadedSort = false;
+
+	/* catch up on interrupts deferred while the workers ran */
+	CHECK_FOR_INTERRUPTS();
+
+	if (QueryFinishPending)
+		return;
+
+	/*
+	 * Iterative pairwise merge of the sorted chunks, ping-ponging between
+	 * the array and a scratch buffer.
+	 */
+	scratch = (MKEntry *) palloc(n * sizeof(MKEntry));
+	src = a;
+	dst = scratch;
+	nchunks = nthreads;
+	while (nchunks > 1)
+	{
+		int			newchunks = 0;
+
+		for (i = 0; i + 1 < nchunks; i += 2)
+		{
+			CHECK_FOR_INTERRUPTS();
+			mksort_merge_two(src, bounds[i], bounds[i + 1], bounds[i + 2],
+							 dst, ctxt);
+			bounds[newchunks + 1] = bounds[i + 2];
+			newchunks++;
+		}
+		if (i < nchunks)
+		{
+			/* odd chunk out; carry it over */
+			memcpy(dst + bounds[i], src + bounds[i],
+				   (bounds[i + 1] - bounds[i]) * sizeof(MKEntry));
+			bounds[newchunks + 1] = bounds[i + 1];
+			newchunks++;
+		}
+		nchunks = newchunks;
+
+		{
+			MKEntry    *tmp = src;
+
+			src = dst;
+			dst = tmp;
+		}
+	}
+
+	if (src != a)
+		memcpy(a, src, n * sizeof(MKEntry));
+	pfree(scratch);
+}
+
 /*
  * All tuples have been provided; finish the sort.
  */
@@ -1342,7 +1623,8 @@ tuplesort_performsort_mk(Tuplesortstate_mk *state)
 			 * amount of memory.  Just qsort 'em and we're done.
 			 */
 			if (!state->mkctxt.bounded)
-				mk_qsort(state->entries, state->entry_count, &state->mkctxt);
+				mk_qsort_maybe_parallel(state->entries, state->entry_count,
+										&state->mkctxt);
 			else
 				tuplesort_limit_sort(state);
 
@@ -3085,6 +3367,50 @@ typedef struct refcnt_locale_str_k
 	char		data[16000];
 } refcnt_locale_str_k;
 
+/*
+ * Pack the leading bytes of a NUL-terminated string (here: strxfrm output)
+ * into an integer whose unsigned comparison agrees with strcmp on the
+ * packed prefix.  Strings sharing the first 8 bytes pack equally, which the
+ * abbreviated compare treats as "don't know".
+ */
+static inline uint64
+tupsort_abbrev_pack_str(const char *s)
+{
+	uint64		key = 0;
+	int			i;
+
+	for (i = 0; i < 8 && s[i] != '\0'; i++)
+		key |= ((uint64) (unsigned char) s[i]) << (56 - 8 * i);
+	return key;
+}
+
+/*
+ * Abbreviate a numeric datum: take its double approximation (monotonic, so
+ * strict double inequality implies the same numeric inequality) and map the
+ * IEEE bit pattern to an unsigned integer that sorts in value order.  NaN
+ * maps above everything, matching numeric_cmp; ties, including rounding
+ * collisions, fall back to the authoritative comparator.
+ */
+static uint64
+tupsort_abbrev_numeric(Datum d)
+{
+	union
+	{
+		double		d;
+		uint64		u;
+	}			conv;
+
+	conv.d = DatumGetFloat8(DirectFunctionCall1(numeric_float8_no_overflow, d));
+
+	if (isnan(conv.d))
+		return ~(uint64) 0;
+
+	if (conv.u & ((uint64) 1 << 63))
+		return ~conv.u;			/* negative: reverse the magnitude order */
+	else
+		return conv.u | ((uint64) 1 << 63);		/* positive: above negatives */
+}
+
 /**
  * Compare the datums for the given level.  It is assumed that each entry has been prepared
  *	 for the given level.
@@ -3095,6 +3421,18 @@ tupsort_compare_datum(MKEntry *v1, MKEntry *v2, MKLvContext *lvctxt, MKContext *
 	Assert(!mke_is_null(v1));
 	Assert(!mke_is_null(v2));
 
+	/*
+	 * Abbreviated-key fast path: if the abbreviations differ they decide
+	 * the comparison on a register-width compare; equal abbreviations
+	 * prove nothing and drop through to the full comparator.
+	 */
+	if (lvctxt->useAbbrev && v1->abbrev != v2->abbrev)
+	{
+		int			result = (v1->abbrev < v2->abbrev) ? -1 : 1;
+
+		return ((lvctxt->scanKey.sk_flags & SK_BT_DESC) != 0) ? -result : result;
+	}
+
 	switch (lvctxt->lvtype)
 	{
 		case MKLV_TYPE_NONE:
@@ -3324,6 +3662,7 @@ tupsort_prepare(MKEntry *a, MKContext *mkctxt, int lv)
 	tupsort_cpfr(a, NULL, lvctxt);
 
 	a->d = (mkctxt->fetchForPrep) (a, mkctxt, lvctxt, &isnull);
+	a->abbrev = 0;
 
 	if (!isnull)
 		mke_set_not_null(a);
@@ -3334,6 +3673,8 @@ tupsort_prepare(MKEntry *a, MKContext *mkctxt, int lv)
 		tupsort_prepare_char(a, true);
 	else if (lvctxt->lvtype == MKLV_TYPE_TEXT)
 		tupsort_prepare_char(a, false);
+	else if (lvctxt->useAbbrev && !isnull)
+		a->abbrev = tupsort_abbrev_numeric(a->d);
 }
 
 /* "True" length (not counting trailing blanks) of a BpChar */
@@ -3562,6 +3903,7 @@ tupsort_prepare_char(MKEntry *a, bool isCHAR)
 	 * finalize result
 	 */
 	a->d = PointerGetDatum(ret);
+	a->abbrev = tupsort_abbrev_pack_str(ret->data + ret->xfrm_pos);
 	mke_set_refc(a);
 }
 
@@ -3693,7 +4035,8 @@ tuplesort_limit_sort(Tuplesortstate_mk *state)
 	if (!state->mkheap)
 	{
 		Assert(state->entry_count <= state->mkctxt.bound);
-		mk_qsort(state->entries, state->entry_count, &state->mkctxt);
+		mk_qsort_maybe_parallel(state->entries, state->entry_count,
+								&state->mkctxt);
 		return;
 	}
 	else
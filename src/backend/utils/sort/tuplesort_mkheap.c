@@ -87,6 +87,11 @@ static uint32 compare_count = 0;
 static void mkheap_heapify(MKHeap *mkheap, bool doLv0);
 static bool mke_has_duplicates_with_root(MKHeap *mkheap);
 
+static bool mkls_usable(MKContext *ctxt, int nreader);
+static void mkls_build(MKHeap *heap);
+static void mkls_adjust(MKHeap *heap, int s);
+static int	mkls_putAndGet(MKHeap *mkheap, MKEntry *out);
+
 static inline int
 LEFT(int n)
 {
@@ -222,6 +227,7 @@ mkheap_from_array(MKEntry *entries, int alloc_sz, int cnt, MKContext *mkctxt)
 
 	heap->readers = NULL;
 	heap->nreader = 0;
+	heap->lsnodes = NULL;
 
 	AssertImply(alloc_sz == 0, !entries);
 	Assert(cnt >= 0 && cnt <= alloc_sz);
@@ -273,6 +279,13 @@ mkheap_from_reader(MKHeapReader *readers, int nreader, MKContext *ctxt)
 	heap->lvtops = palloc0(ctxt->total_lv * sizeof(MKEntry));
 	heap->readers = readers;
 	heap->nreader = nreader;
+	heap->lsnodes = NULL;
+
+	if (gp_enable_mk_loser_tree && mkls_usable(ctxt, nreader))
+	{
+		mkls_build(heap);
+		return heap;
+	}
 
 	/* Create initial heap. */
 	heap->p = palloc0(sizeof(MKEntry) * (nreader + 1));
@@ -303,6 +316,211 @@ mkheap_from_reader(MKHeapReader *readers, int nreader, MKContext *ctxt)
 	return heap;
 }
 
+/*
+ * Loser-tree merge.
+ *
+ * For a k-way reader-backed merge the sift-down heap costs up to two
+ * comparisons per level per output tuple.  A loser tree caches at each
+ * internal node the loser of the comparison between its subtrees, so
+ * replacing the winner replays exactly one leaf-to-root path of
+ * ceil(log2(k)) comparisons with no sibling lookups.
+ *
+ * The tree bypasses the heap's lazy level expansion: every comparison runs
+ * over all levels, re-fetching each level's datum as it goes.  That is only
+ * a good trade when preparation is a pass-by-value fetch with nothing to
+ * free, so mkls_usable() restricts the tree to such sorts; everything else
+ * (byref keys, uniqueness enforcement, limit sorts whose comparisons are
+ * reversed) stays on the heap.
+ *
+ * lsnodes[1 .. nreader-1] hold the loser reader index at each internal
+ * node; lsnodes[0] holds the overall winner.  Leaf i (entry p[i]) always
+ * belongs to reader i, and its parent node is (i + nreader) / 2.
+ */
+static bool
+mkls_usable(MKContext *ctxt, int nreader)
+{
+	int			lv;
+
+	if (nreader < 2)
+		return false;
+
+	if (ctxt->unique || ctxt->enforceUnique)
+		return false;
+
+	if (ctxt->limitmask != 0)
+		return false;
+
+	for (lv = 0; lv < ctxt->total_lv; lv++)
+	{
+		MKLvContext *sinfo = ctxt->lvctxt + lv;
+
+		if (sinfo->lvtype == MKLV_TYPE_INT32)
+			continue;
+
+		if (sinfo->lvtype == MKLV_TYPE_NONE && sinfo->typByVal)
+			continue;
+
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * Compare the current entries of readers x and y over all levels.
+ * Exhausted readers (empty entries) sort after everything so they sink to
+ * the bottom of the tree as their tapes run out.
+ */
+static int32
+mkls_compare(MKHeap *heap, int x, int y)
+{
+	MKContext  *ctxt = heap->mkctxt;
+	MKEntry    *a = heap->p + x;
+	MKEntry    *b = heap->p + y;
+	int			lv;
+	int32		ret;
+
+	if (compare_count++ % COMPARES_BETWEEN_INTERRUPT_CHECKS == 0)
+	{
+		CHECK_FOR_INTERRUPTS();
+	}
+
+	if (mke_is_empty(a))
+		return mke_is_empty(b) ? 0 : 1;
+	if (mke_is_empty(b))
+		return -1;
+
+	for (lv = 0; lv < ctxt->total_lv; lv++)
+	{
+		if (ctxt->fetchForPrep)
+		{
+			tupsort_prepare(a, ctxt, lv);
+			tupsort_prepare(b, ctxt, lv);
+		}
+
+		ret = mke_get_nullbits(a) - mke_get_nullbits(b);
+		if (ret != 0)
+			return ret;
+
+		if (mke_is_null(a))
+			continue;			/* both null at this level; try the next */
+
+		ret = tupsort_compare_datum(a, b, ctxt->lvctxt + lv, ctxt);
+		if (ret != 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+/*
+ * Replay the path from leaf s to the root, leaving the loser of each
+ * comparison at the internal node and the winner in lsnodes[0].  During the
+ * initial build, a node still holding the -1 sentinel parks the contender
+ * there; once built, every node holds a valid reader index.
+ */
+static void
+mkls_adjust(MKHeap *heap, int s)
+{
+	int			parent = (s + heap->nreader) / 2;
+
+	while (parent > 0)
+	{
+		if (heap->lsnodes[parent] < 0)
+		{
+			heap->lsnodes[parent] = s;
+			return;
+		}
+
+		if (mkls_compare(heap, s, heap->lsnodes[parent]) > 0)
+		{
+			int			t = heap->lsnodes[parent];
+
+			heap->lsnodes[parent] = s;
+			s = t;
+		}
+
+		parent /= 2;
+	}
+
+	heap->lsnodes[0] = s;
+}
+
+/*
+ * Read the first entry of every reader and build the tree over them.
+ */
+static void
+mkls_build(MKHeap *heap)
+{
+	int			i;
+
+	heap->p = palloc0(sizeof(MKEntry) * heap->nreader);
+	heap->alloc_size = heap->nreader;
+	heap->count = 0;
+
+	heap->lsnodes = (int *) palloc(sizeof(int) * heap->nreader);
+	for (i = 0; i < heap->nreader; ++i)
+		heap->lsnodes[i] = -1;
+
+	for (i = 0; i < heap->nreader; ++i)
+	{
+		MKEntry    *e = heap->p + i;
+
+		if (heap->readers[i].reader(heap->readers[i].mkhr_ctxt, e))
+		{
+			mke_set_reader(e, i);
+			mke_set_lv(e, 0);
+			++heap->count;
+		}
+		else
+			mke_set_empty(e);
+	}
+
+	heap->maxentry = heap->count;
+
+	for (i = 0; i < heap->nreader; ++i)
+		mkls_adjust(heap, i);
+}
+
+/*
+ * Loser-tree counterpart of mkheap_putAndGet_reader: emit the winner,
+ * replenish its leaf from the same reader and replay that one path.
+ */
+static int
+mkls_putAndGet(MKHeap *mkheap, MKEntry *out)
+{
+	int			w = mkheap->lsnodes[0];
+	MKEntry    *we;
+
+	if (mkheap->count == 0)
+	{
+		mke_set_empty(out);
+		return -1;
+	}
+
+	we = mkheap->p + w;
+	Assert(!mke_is_empty(we));
+	Assert(mke_get_reader(we) == w);
+	Assert(mke_get_run(we) == 0);
+
+	*out = *we;
+
+	if (mkheap->readers[w].reader(mkheap->readers[w].mkhr_ctxt, we))
+	{
+		mke_set_reader(we, w);
+		mke_set_lv(we, 0);
+	}
+	else
+	{
+		mke_set_empty(we);
+		--mkheap->count;
+	}
+
+	mkls_adjust(mkheap, w);
+
+	return 1;
+}
+
 /*
  * Destroy mkheap.  Free entry arrays at each level.
  *
@@ -314,6 +532,9 @@ mkheap_destroy(MKHeap *mkheap)
 	if (mkheap->p)
 		pfree(mkheap->p);
 
+	if (mkheap->lsnodes)
+		pfree(mkheap->lsnodes);
+
 	if (mkheap->lvtops)
 		pfree(mkheap->lvtops);
 
@@ -821,9 +1042,13 @@ mkheap_putAndGet_reader(MKHeap *mkheap, MKEntry *out)
 	int			n;
 	bool		fOK;
 	int			ins;
+	MKEntry    *e;
+
+	if (mkheap->lsnodes)
+		return mkls_putAndGet(mkheap, out);
 
 	/* First, check to see if the heap is empty */
-	MKEntry    *e = mkheap_peek(mkheap);
+	e = mkheap_peek(mkheap);
 
 	if (!e)
 	{
@@ -914,6 +1139,12 @@ mkheap_peek(MKHeap *mkheap)
 	if (mkheap->count == 0)
 		return NULL;
 
+	if (mkheap->lsnodes)
+	{
+		Assert(!mke_is_empty(mkheap->p + mkheap->lsnodes[0]));
+		return mkheap->p + mkheap->lsnodes[0];
+	}
+
 	Assert(!mke_is_empty(mkheap->p));
 	return mkheap->p;
 }
@@ -20,6 +20,10 @@
 
 #include "postgres.h"
 #include "access/genam.h"
+#include "access/nbtree.h"
+#include "cdb/cdbvars.h"
+#include "utils/builtins.h"
+#include "utils/date.h"
 #include "utils/tuplesort.h"
 #include "utils/tuplesort_mk.h"
 #include "utils/tuplesort_mk_details.h"
@@ -269,10 +273,18 @@ void mk_qsort_impl(MKEntry *a, int left, int right, int lv, bool lvdown, MKConte
 	Assert(ctxt);
 	Assert(lv < ctxt->total_lv);
 
-	CHECK_FOR_INTERRUPTS();
+	/*
+	 * When partitions of the array are being sorted by worker threads, the
+	 * interrupt machinery must only be exercised by the main thread; it
+	 * catches up on interrupts after the workers are joined.
+	 */
+	if (!ctxt->inThreadedSort)
+	{
+		CHECK_FOR_INTERRUPTS();
 
-	if (QueryFinishPending)
-		return;
+		if (QueryFinishPending)
+			return;
+	}
 
 	if(right <= left)
 		return;
@@ -348,6 +360,185 @@ void mk_qsort_impl(MKEntry *a, int left, int right, int lv, bool lvdown, MKConte
 #endif
 }
 
+
+/*
+ * LSD radix sort fast path for single fixed-width integer sort keys.
+ *
+ * When the sort has exactly one key and that key compares with one of the
+ * integer btree comparators (int2/int4/int8/date), ordering is decided by
+ * an order-preserving unsigned encoding of the key value, so the array can
+ * be sorted with counting passes instead of comparisons.  NULL keys are
+ * moved to their sorted position first, then the non-NULL range is sorted
+ * least-significant byte first, ping-ponging between the array and a
+ * scratch copy.  Passes in which every key has the same byte are skipped,
+ * so an int8 column holding small values costs about as much as an int4.
+ *
+ * Uniqueness checking and duplicate elimination still rely on the qsort
+ * kernel's equal-partition bookkeeping, so those sorts are left to it.
+ */
+
+#define MK_RADIX_MIN_TUPLES 1024
+
+/*
+ * Unsigned encoding of the key of a prepared, non-NULL entry, such that
+ * encodings compare the way the values sort.  'inv' is all-ones within the
+ * key width for descending sorts, zero otherwise.
+ */
+static inline uint64
+mk_radix_rank(MKEntry *e, int width, uint64 inv)
+{
+	uint64		r;
+
+	if (width == 8)
+		r = (uint64) DatumGetInt64(e->d) ^ UINT64CONST(0x8000000000000000);
+	else if (width == 4)
+		r = (uint32) (DatumGetInt32(e->d) ^ INT_MIN);
+	else
+		r = (uint16) (DatumGetInt16(e->d) ^ 0x8000);
+
+	return r ^ inv;
+}
+
+/*
+ * Sort the array with an LSD radix sort if the sort key qualifies.
+ * Returns false, leaving the array untouched, when it does not; the caller
+ * falls back to the comparison sort.
+ */
+bool
+mk_radix_sort(MKEntry *a, int n, MKContext *ctxt)
+{
+	MKLvContext *lvctxt;
+	PGFunction	cmpfn;
+	int			width;
+	uint64		inv = 0;
+	MKEntry    *scratch;
+	MKEntry    *src;
+	MKEntry    *dst;
+	uint32		count[8][256];
+	int			nnulls;
+	int			lo;
+	int			hi;
+	int			m;
+	int			b;
+	int			i;
+
+	if (!gp_enable_mk_radix_sort || n < MK_RADIX_MIN_TUPLES)
+		return false;
+
+	if (ctxt->total_lv != 1 || ctxt->unique || ctxt->enforceUnique ||
+		ctxt->fetchForPrep == NULL)
+		return false;
+
+	lvctxt = &ctxt->lvctxt[0];
+	cmpfn = lvctxt->scanKey.sk_func.fn_addr;
+
+	if (cmpfn == btint2cmp)
+		width = 2;
+	else if (cmpfn == btint4cmp || cmpfn == date_cmp)
+		width = 4;
+	else if (cmpfn == btint8cmp)
+		width = 8;
+	else
+		return false;
+
+	if (lvctxt->scanKey.sk_flags & SK_BT_DESC)
+		inv = (width == 8) ? ~UINT64CONST(0) :
+			(UINT64CONST(1) << (width * 8)) - 1;
+
+	mk_prepare_array(a, 0, n - 1, 0, ctxt);
+
+	scratch = (MKEntry *) palloc(n * sizeof(MKEntry));
+
+	/*
+	 * Move NULL keys to their sorted position; the counting passes handle
+	 * only the non-NULL range.  All NULL keys compare equal, so their
+	 * relative order does not matter (the qsort kernel is unstable too).
+	 */
+	nnulls = 0;
+	for (i = 0; i < n; i++)
+	{
+		if (mke_is_null(a + i))
+			nnulls++;
+	}
+
+	lo = 0;
+	hi = n;
+	if (nnulls > 0)
+	{
+		bool		nulls_first =
+			(lvctxt->scanKey.sk_flags & SK_BT_NULLS_FIRST) != 0;
+		int			nextval = nulls_first ? nnulls : 0;
+		int			nextnull = nulls_first ? 0 : n - nnulls;
+
+		for (i = 0; i < n; i++)
+			scratch[mke_is_null(a + i) ? nextnull++ : nextval++] = a[i];
+		memcpy(a, scratch, n * sizeof(MKEntry));
+
+		if (nulls_first)
+			lo = nnulls;
+		else
+			hi = n - nnulls;
+	}
+
+	m = hi - lo;
+	if (m > 1)
+	{
+		memset(count, 0, width * sizeof(count[0]));
+		for (i = lo; i < hi; i++)
+		{
+			uint64		r = mk_radix_rank(a + i, width, inv);
+
+			for (b = 0; b < width; b++)
+				count[b][(r >> (b * 8)) & 0xFF]++;
+		}
+
+		src = a + lo;
+		dst = scratch;
+		for (b = 0; b < width; b++)
+		{
+			uint32		pos[256];
+			uint32		accum;
+			MKEntry    *swap;
+
+			/* a pass in which every key has the same byte reorders nothing */
+			if (count[b][mk_radix_rank(src, width, inv) >> (b * 8) & 0xFF] == (uint32) m)
+				continue;
+
+			accum = 0;
+			for (i = 0; i < 256; i++)
+			{
+				pos[i] = accum;
+				accum += count[b][i];
+			}
+
+			for (i = 0; i < m; i++)
+			{
+				uint64		r = mk_radix_rank(src + i, width, inv);
+
+				dst[pos[(r >> (b * 8)) & 0xFF]++] = src[i];
+			}
+
+			swap = src;
+			src = dst;
+			dst = swap;
+
+			if (!ctxt->inThreadedSort)
+			{
+				CHECK_FOR_INTERRUPTS();
+
+				if (QueryFinishPending)
+					break;
+			}
+		}
+
+		if (src != a + lo)
+			memcpy(a + lo, src, m * sizeof(MKEntry));
+	}
+
+	pfree(scratch);
+	return true;
+}
+
 #ifdef MKQSORT_VERIFY 
 static int mkqsort_comp_entry_all_lv(MKEntry *a, MKEntry *b, MKContext *mkctxt)
 {
@@ -252,6 +252,25 @@ struct NTupleStore
 	ExecWorkFile *plobfile;  /* underlying backed file for lobs (entries does not fit one page) */
 	int64     lobbytes;  /* number of bytes written to lob file */
 
+	/*
+	 * Read-only mapping of pfile, so rescans copy pages straight out of the
+	 * OS page cache instead of going through read().  Established lazily on
+	 * the first read, dropped whenever a block is (re)written so a stale
+	 * view is never served, and re-established on the next read.
+	 */
+	void *mmap_addr;	/* mapped region, or NULL */
+	int64 mmap_len; 	/* length of the mapped region */
+	bool  mmap_failed;	/* mmap didn't work; don't keep retrying */
+
+	/*
+	 * Column pruning.  When needed_cols is set, tuples are stored with all
+	 * other columns replaced by NULL.  The stored tuples keep the full
+	 * tuple descriptor, so readers need no changes; the pruned columns
+	 * simply read back as NULL and must not be referenced by any consumer.
+	 */
+	Bitmapset *needed_cols;	/* attnos to retain, or NULL to store all */
+	bool *prune_isnull; 	/* scratch isnull array for pruned writes */
+
 	List *accessors;    /* all current accessors of the store */
 	bool fwacc; 		/* if I had already has a write acc */
 
@@ -389,17 +408,59 @@ static void nts_remove_page_from_dlist(NTupleStorePage *page, void **prev, void
 }
 #define NTS_REMOVE_1(page) (nts_remove_page_from_dlist((page), &((page)->header.prev_1), &((page)->header.next_1)))
 
+/* drop the read mapping of the backed file, if any */
+static void ntsDropMmap(NTupleStore *ts)
+{
+	if(ts->mmap_addr)
+	{
+		ExecWorkFile_Munmap(ts->mmap_addr, ts->mmap_len);
+		ts->mmap_addr = NULL;
+		ts->mmap_len = 0;
+	}
+}
+
 /* read a page by blockn.  After read the page in not pined and not in any list */
 static bool ntsReadBlock(NTupleStore *ts, int blockn, NTupleStorePage *page)
 {
 	long diskblockn = blockn - ts->first_ondisk_blockn;
+	int64 diskoffset = (int64) diskblockn * BLCKSZ;
 
 	if(!ts->pfile)
 		return false;
-	
+
 	Assert(ts->first_ondisk_blockn >= 0);
 	Assert(ts && diskblockn >= 0 && page);
-	if(ExecWorkFile_Seek(ts->pfile, diskblockn * BLCKSZ, SEEK_SET) != 0 ||
+
+	/*
+	 * Serve the page from the file mapping if we have (or can get) one that
+	 * covers it; otherwise fall through to seek and read.
+	 */
+	if(gp_workfile_mmap_read && !ts->mmap_failed)
+	{
+		if(ts->mmap_addr == NULL &&
+				diskoffset + BLCKSZ <= ExecWorkFile_GetSize(ts->pfile))
+		{
+			ts->mmap_addr = ExecWorkFile_Mmap(ts->pfile, &ts->mmap_len);
+			if(ts->mmap_addr == NULL)
+				ts->mmap_failed = true;
+		}
+
+		if(ts->mmap_addr && diskoffset + BLCKSZ <= ts->mmap_len)
+		{
+			memcpy(page, (char *) ts->mmap_addr + diskoffset, BLCKSZ);
+
+			Assert(nts_page_blockn(page) == blockn);
+			Assert(!nts_page_is_dirty(page));
+
+			nts_page_set_pin_cnt(page, 0);
+			nts_page_set_prev(page, NULL);
+			nts_page_set_next(page, NULL);
+
+			return true;
+		}
+	}
+
+	if(ExecWorkFile_Seek(ts->pfile, diskoffset, SEEK_SET) != 0 ||
 			ExecWorkFile_Read(ts->pfile, page, BLCKSZ) != BLCKSZ)
 	{
 		return false;
@@ -432,6 +493,13 @@ static bool ntsWriteBlock(NTupleStore *ts, NTupleStorePage *page)
 
 	nts_page_set_dirty(page, false);
 
+	/*
+	 * The mapping no longer reflects the file once we overwrite a block
+	 * (the write may also sit in the BufFile buffer for a while).  Drop it;
+	 * the next read re-establishes a fresh one after a flush.
+	 */
+	ntsDropMmap(ts);
+
 	if(ExecWorkFile_Seek(ts->pfile, (nts_page_blockn(page) - ts->first_ondisk_blockn) * BLCKSZ, SEEK_SET) != 0 ||
 			!ExecWorkFile_Write(ts->pfile, page, BLCKSZ))
 	{
@@ -696,6 +764,8 @@ ntuplestore_destroy(NTupleStore *ts)
 		p = pnext;
 	}
 
+	ntsDropMmap(ts);
+
 	if(ts->pfile)
 	{
 		workfile_mgr_close_file(ts->work_set, ts->pfile);
@@ -728,9 +798,16 @@ ntuplestore_create(int64 maxBytes)
 	store->plobfile = NULL;
 	store->lobbytes = 0;
 
+	store->mmap_addr = NULL;
+	store->mmap_len = 0;
+	store->mmap_failed = false;
+
 	store->work_set = NULL;
 	store->workfiles_created = false;
 
+	store->needed_cols = NULL;
+	store->prune_isnull = NULL;
+
 	Assert(maxBytes >= 0);
 	store->page_max = maxBytes / BLCKSZ;
 	/* give me at least 16 pages */
@@ -791,6 +868,13 @@ ntuplestore_create_readerwriter(const char *filename, int64 maxBytes, bool isWri
 		store->work_set = NULL;
 		store->workfiles_created = false;
 
+		store->needed_cols = NULL;
+		store->prune_isnull = NULL;
+
+		store->mmap_addr = NULL;
+		store->mmap_len = 0;
+		store->mmap_failed = false;
+
 		store->pfile = ExecWorkFile_Open(filename, BUFFILE,
 				false /* delOnClose */,
 				0 /* compressType */);
@@ -869,6 +953,63 @@ ntuplestore_create_workset(workfile_set *workSet, int64 maxBytes)
 	return store;
 }
 
+/*
+ * Create a read-only tuple store over the spill files of a cached workfile
+ * set that was published by a previous query. The caller must have attached
+ * to the set through workfile_mgr_attach_set().
+ */
+NTupleStore *
+ntuplestore_create_workset_reader(workfile_set *workSet, int64 maxBytes)
+{
+	elog(gp_workfile_caching_loglevel, "Creating tuplestore reader for cached workset in directory %s", workSet->path);
+
+	NTupleStore *store = (NTupleStore *) palloc(sizeof(NTupleStore));
+	store->mcxt = CurrentMemoryContext;
+	store->work_set = workSet;
+	store->workfiles_created = false;
+
+	store->needed_cols = NULL;
+	store->prune_isnull = NULL;
+
+	store->mmap_addr = NULL;
+	store->mmap_len = 0;
+	store->mmap_failed = false;
+
+	store->pfile = workfile_mgr_open_fileno(workSet, WORKFILE_NUM_TUPLESTORE_DATA);
+	store->plobfile = workfile_mgr_open_fileno(workSet, WORKFILE_NUM_TUPLESTORE_LOB);
+
+	ntuplestore_init_reader(store, maxBytes);
+
+	return store;
+}
+
+/*
+ * Declare that the full result of the operator has been written to this
+ * tuple store.  If the store belongs to a reusable workfile set and has
+ * spilled to disk, flush it and mark the set complete so it is published
+ * for reuse when closed. A store that never spilled has nothing on disk
+ * worth publishing and is left unmarked.
+ */
+void
+ntuplestore_workset_complete(NTupleStore *ts)
+{
+	if (ts->work_set == NULL ||
+		!ts->work_set->reusable ||
+		ts->work_set->complete ||
+		ts->rwflag == NTS_IS_READER)
+	{
+		return;
+	}
+
+	if (ts->pfile == NULL)
+	{
+		return;
+	}
+
+	ntuplestore_flush(ts);
+	workfile_mgr_mark_complete(ts->work_set);
+}
+
 void 
 ntuplestore_flush(NTupleStore *ts)
 {
@@ -1006,6 +1147,58 @@ static long ntuplestore_get_lob(NTupleStore *nts, void *data, NTupleStoreLobRef
 	return ret;
 }
 
+/*
+ * Restrict the store to the given set of columns (by attno).
+ *
+ * Tuples written afterwards have every other column replaced by NULL
+ * before they are stored, cutting the spilled and cached volume of wide
+ * rows whose consumer only references a few columns. The stored tuples
+ * keep the full tuple descriptor, so the read side is unchanged; the
+ * caller asserts that no consumer references the pruned columns.
+ *
+ * Must be called before any tuple is written to the store.
+ */
+void
+ntuplestore_set_needed_columns(NTupleStore *ts, Bitmapset *needed_cols)
+{
+	Assert(ts->rwflag != NTS_IS_READER);
+	Assert(nts_page_slot_cnt(ts->first_page) == 0);
+
+	MemoryContext oldcxt = MemoryContextSwitchTo(ts->mcxt);
+	ts->needed_cols = bms_copy(needed_cols);
+	MemoryContextSwitchTo(oldcxt);
+}
+
+/*
+ * Form the memtuple to be stored for a slot, into dest if it fits.
+ * Applies the column pruning configured on the store, if any.
+ */
+static MemTuple
+ntuplestore_form_memtuple(NTupleStoreAccessor *tsa, TupleTableSlot *slot,
+						  char *dest, unsigned int *destlen)
+{
+	NTupleStore *nts = tsa->store;
+	int			natts;
+	bool	   *isnull;
+	int			i;
+
+	if (nts->needed_cols == NULL)
+		return ExecCopySlotMemTupleTo(slot, NULL, dest, destlen);
+
+	natts = slot->tts_tupleDescriptor->natts;
+	if (nts->prune_isnull == NULL)
+		nts->prune_isnull = (bool *) MemoryContextAlloc(nts->mcxt, natts * sizeof(bool));
+
+	slot_getallattrs(slot);
+	isnull = slot_get_isnull(slot);
+
+	for (i = 0; i < natts; i++)
+		nts->prune_isnull[i] = isnull[i] || !bms_is_member(i + 1, nts->needed_cols);
+
+	return memtuple_form_to(slot->tts_mt_bind, slot_get_values(slot),
+							nts->prune_isnull, (MemTuple) dest, destlen, false);
+}
+
 void ntuplestore_acc_put_tupleslot(NTupleStoreAccessor *tsa, TupleTableSlot *slot)
 {
 	char *dest_ptr;
@@ -1028,7 +1221,7 @@ void ntuplestore_acc_put_tupleslot(NTupleStoreAccessor *tsa, TupleTableSlot *slo
 	dest_len = (uint32) nts_page_avail_bytes(tsa->page); 
 
 	Assert(dest_len <= NTS_MAX_ENTRY_SIZE);
-	mtup = ExecCopySlotMemTupleTo(slot, NULL, dest_ptr, &dest_len);
+	mtup = ntuplestore_form_memtuple(tsa, slot, dest_ptr, &dest_len);
 
 	if(mtup != NULL) 
 		update_page_slot_entry(tsa->page, (int) dest_len);
@@ -1042,7 +1235,7 @@ void ntuplestore_acc_put_tupleslot(NTupleStoreAccessor *tsa, TupleTableSlot *slo
 
 		dest_ptr = nts_page_next_slot_data_ptr(page);
 		dest_len = (unsigned int) nts_page_avail_bytes(page);
-		mtup = ExecCopySlotMemTupleTo(slot, NULL, dest_ptr, &dest_len);
+		mtup = ntuplestore_form_memtuple(tsa, slot, dest_ptr, &dest_len);
 		Assert(mtup!=NULL);
 
 		update_page_slot_entry(page, (int) dest_len);
@@ -1064,7 +1257,7 @@ void ntuplestore_acc_put_tupleslot(NTupleStoreAccessor *tsa, TupleTableSlot *slo
 
 		lobref.size = dest_len;
 
-		mtup = ExecCopySlotMemTupleTo(slot, NULL, lob, &dest_len);
+		mtup = ntuplestore_form_memtuple(tsa, slot, lob, &dest_len);
 		Assert(mtup != NULL && dest_len == lobref.size);
 
 		ntuplestore_put_lob(tsa->store, lob, &lobref);
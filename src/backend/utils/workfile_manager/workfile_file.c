@@ -53,9 +53,14 @@ workfile_mgr_create_fileno(workfile_set *work_set, uint32 file_no)
 	char file_name[MAXPGPATH];
 	retrieve_file_no(work_set, file_no, file_name, sizeof(file_name));
 
+	/*
+	 * Files in a reusable set must survive the closing of the file handle,
+	 * since the set is published in the cache afterwards. They are deleted
+	 * when the set is evicted from the cache.
+	 */
 	ExecWorkFile *ewfile = ExecWorkFile_Create(file_name,
 			work_set->metadata.type,
-			true /* del_on_close */,
+			!work_set->reusable /* del_on_close */,
 			work_set->metadata.bfz_compress_type);
 
 	SIMPLE_FAULT_INJECTOR(WorkfileCreationFail);
@@ -65,6 +70,30 @@ workfile_mgr_create_fileno(workfile_set *work_set, uint32 file_no)
 	return ewfile;
 }
 
+/*
+ * Opens an existing numbered workfile in a given set for reading
+ *
+ *  Used to read back the files of a cached workfile set that was created
+ *  by a previous query.
+ */
+ExecWorkFile *
+workfile_mgr_open_fileno(workfile_set *work_set, uint32 file_no)
+{
+	Assert(NULL != work_set);
+
+	char file_name[MAXPGPATH];
+	retrieve_file_no(work_set, file_no, file_name, sizeof(file_name));
+
+	ExecWorkFile *ewfile = ExecWorkFile_Open(file_name,
+			work_set->metadata.type,
+			false /* delOnClose */,
+			work_set->metadata.bfz_compress_type);
+
+	ExecWorkfile_SetWorkset(ewfile, work_set);
+
+	return ewfile;
+}
+
 /*
  * Closes a given workfile and updates the diskspace accordingly
  *
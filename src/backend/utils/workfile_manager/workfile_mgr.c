@@ -20,9 +20,11 @@
 
 #include "utils/workfile_mgr.h"
 #include "miscadmin.h"
+#include "access/hash.h"
 #include "cdb/cdbvars.h"
 #include "nodes/print.h"
 #include "utils/builtins.h"
+#include "utils/inval.h"
 #include "utils/memutils.h"
 
 #define WORKFILE_SET_MASK  "XXXXXXXXXX"
@@ -51,9 +53,16 @@ static void workfile_mgr_unlink_directory(const char *dirpath);
 static const char *get_name_from_nodeType(const NodeTag node_type);
 static uint64 get_operator_work_mem(PlanState *ps);
 static char *create_workset_directory(NodeTag node_type, int slice_id);
+static bool workfile_mgr_fingerprint(PlanState *ps, workfile_set_hashkey_t *fingerprint,
+		Oid *reuse_rels, int *n_reuse_rels);
+static bool workfile_mgr_evict_entry(CacheEntry *entry);
+static bool workfile_mgr_evict_any(void);
+static void workfile_mgr_relcache_callback(Datum arg, Oid relid);
+static void workfile_mgr_register_inval_callback(void);
 
 static workfile_set *open_workfile_sets = NULL;
 static bool workfile_sets_resowner_callback_registered = false;
+static bool workfile_inval_callback_registered = false;
 
 
 static void
@@ -222,6 +231,15 @@ workfile_mgr_create_set(enum ExecWorkFileType type, bool can_be_reused, PlanStat
 
 	CacheEntry *newEntry = Cache_AcquireEntry(workfile_mgr_cache, &set_info);
 
+	/*
+	 * If all entries are in use, try to make room by evicting published
+	 * reusable sets before giving up.
+	 */
+	while (NULL == newEntry && gp_workfile_caching && workfile_mgr_evict_any())
+	{
+		newEntry = Cache_AcquireEntry(workfile_mgr_cache, &set_info);
+	}
+
 	if (NULL == newEntry)
 	{
 		/* Clean up the directory we created. */
@@ -322,6 +340,11 @@ workfile_mgr_populate_set(const void *resource, const void *param)
 	work_set->command_count = gp_command_count;
 	work_set->session_start_time = set_info->session_start_time;
 
+	work_set->key = 0;
+	work_set->reusable = false;
+	work_set->complete = false;
+	work_set->n_reuse_rels = 0;
+
 	work_set->owner = CurrentResourceOwner;
 	work_set->next = open_workfile_sets;
 	work_set->prev = NULL;
@@ -440,23 +463,317 @@ void
 workfile_mgr_close_set(workfile_set *work_set)
 {
 	Assert(work_set!=NULL);
-	/* Although work_set is in shared memory only this process has access to it */
-	if (work_set->prev)
-		work_set->prev->next = work_set->next;
-	else
-		open_workfile_sets = work_set->next;
-	if (work_set->next)
-		work_set->next->prev = work_set->prev;
+
+	CacheEntry *cache_entry = CACHE_ENTRY_HEADER(work_set);
+
+	if (cache_entry->state == CACHE_ENTRY_ACQUIRED)
+	{
+		/* We created this set; unlink it from the per-backend open list */
+		if (work_set->prev)
+			work_set->prev->next = work_set->next;
+		else
+			open_workfile_sets = work_set->next;
+		if (work_set->next)
+			work_set->next->prev = work_set->prev;
+
+		/*
+		 * If the complete result of a reusable operator made it to disk,
+		 * publish the set in the cache instead of letting the release
+		 * delete it. Subsequent queries with the same fingerprint attach
+		 * to it through workfile_mgr_attach_set().
+		 */
+		if (gp_workfile_caching && work_set->reusable && work_set->complete)
+		{
+			work_set->owner = NULL;
+			work_set->next = NULL;
+			work_set->prev = NULL;
+
+			elog(gp_workfile_caching_loglevel, "publishing workfile set for reuse: key=0x%x path=%s size=" INT64_FORMAT,
+					work_set->key, work_set->path, work_set->size);
+
+			Cache_Insert(workfile_mgr_cache, cache_entry);
+		}
+	}
 
 	elog(gp_workfile_caching_loglevel, "closing workfile set: location: %s, size=" INT64_FORMAT
 			" in_progress_size=" INT64_FORMAT,
 		 work_set->path,
 		 work_set->size, work_set->in_progress_size);
 
-	CacheEntry *cache_entry = CACHE_ENTRY_HEADER(work_set);
 	Cache_Release(workfile_mgr_cache, cache_entry);
 }
 
+/*
+ * Compute the reuse fingerprint for the operator rooted at ps.
+ *
+ * The fingerprint hashes the serialized plan subtree and folds in the OID
+ * of every relation in the range table, so that two queries only match if
+ * they run the same subplan against the same relations. The relations are
+ * also recorded in reuse_rels to drive invalidation when one of them
+ * changes.
+ *
+ * Returns false if the subtree does not qualify for reuse, e.g. if it
+ * depends on more relations than we can track.
+ */
+static bool
+workfile_mgr_fingerprint(PlanState *ps, workfile_set_hashkey_t *fingerprint,
+		Oid *reuse_rels, int *n_reuse_rels)
+{
+	Assert(NULL != ps);
+
+	if (NULL == ps->plan || NULL == ps->state)
+	{
+		return false;
+	}
+
+	char *serialized_plan = nodeToString(ps->plan);
+	uint32 hash = DatumGetUInt32(hash_any((const unsigned char *) serialized_plan,
+				strlen(serialized_plan)));
+	pfree(serialized_plan);
+
+	*n_reuse_rels = 0;
+
+	ListCell *lc;
+	foreach(lc, ps->state->es_range_table)
+	{
+		RangeTblEntry *rte = (RangeTblEntry *) lfirst(lc);
+
+		if (rte->rtekind != RTE_RELATION)
+		{
+			continue;
+		}
+
+		if (*n_reuse_rels >= WORKFILE_SET_MAX_REUSE_RELS)
+		{
+			/* Too many relations to track for invalidation. Don't reuse */
+			return false;
+		}
+
+		reuse_rels[(*n_reuse_rels)++] = rte->relid;
+		hash = (hash << 1) | (hash >> 31);
+		hash ^= DatumGetUInt32(hash_uint32((uint32) rte->relid));
+	}
+
+	*fingerprint = hash;
+
+	return true;
+}
+
+/*
+ * Mark a newly created workfile set as a candidate for cross-query reuse.
+ *
+ * Must be called before any file in the set is created, so that the files
+ * are created as persistent instead of delete-on-close. The set is only
+ * published if workfile_mgr_mark_complete() is called before closing it.
+ */
+void
+workfile_mgr_mark_reusable(workfile_set *work_set, PlanState *ps)
+{
+	Assert(NULL != work_set);
+	Assert(CACHE_ENTRY_HEADER(work_set)->state == CACHE_ENTRY_ACQUIRED);
+	Assert(work_set->no_files == 0);
+
+	workfile_set_hashkey_t fingerprint;
+	Oid reuse_rels[WORKFILE_SET_MAX_REUSE_RELS];
+	int n_reuse_rels = 0;
+
+	if (!workfile_mgr_fingerprint(ps, &fingerprint, reuse_rels, &n_reuse_rels))
+	{
+		return;
+	}
+
+	work_set->key = fingerprint;
+	work_set->n_reuse_rels = n_reuse_rels;
+	memcpy(work_set->reuse_rels, reuse_rels, n_reuse_rels * sizeof(Oid));
+	work_set->reusable = true;
+
+	workfile_mgr_register_inval_callback();
+
+	elog(gp_workfile_caching_loglevel, "marked workfile set as reusable: key=0x%x path=%s",
+			work_set->key, work_set->path);
+}
+
+/*
+ * Mark a reusable workfile set as containing the complete result of its
+ * operator. The caller must have flushed all files in the set to disk.
+ */
+void
+workfile_mgr_mark_complete(workfile_set *work_set)
+{
+	Assert(NULL != work_set);
+	Assert(work_set->reusable);
+
+	work_set->complete = true;
+}
+
+/*
+ * Attach to a published workfile set holding the result of an operator with
+ * the same fingerprint as the one rooted at ps.
+ *
+ * On success the returned set is pinned in the cache and must be released
+ * with workfile_mgr_close_set() when the caller is done reading from it.
+ * Returns NULL if no matching set is cached.
+ */
+workfile_set *
+workfile_mgr_attach_set(enum ExecWorkFileType type, PlanState *ps)
+{
+	Assert(NULL != workfile_mgr_cache);
+	Assert(NULL != ps);
+
+	workfile_set_hashkey_t fingerprint;
+	Oid reuse_rels[WORKFILE_SET_MAX_REUSE_RELS];
+	int n_reuse_rels = 0;
+
+	if (!workfile_mgr_fingerprint(ps, &fingerprint, reuse_rels, &n_reuse_rels))
+	{
+		return NULL;
+	}
+
+	workfile_mgr_register_inval_callback();
+
+	CacheEntry *entry = Cache_Lookup(workfile_mgr_cache, &fingerprint);
+	if (NULL == entry)
+	{
+		return NULL;
+	}
+
+	workfile_set *work_set = CACHE_ENTRY_PAYLOAD(entry);
+
+	/*
+	 * The fingerprint is only a 32-bit hash. Cross-check the metadata that
+	 * we store in the set to protect against hash collisions.
+	 */
+	if (!work_set->complete ||
+			work_set->metadata.type != type ||
+			work_set->node_type != ps->type ||
+			work_set->n_reuse_rels != n_reuse_rels ||
+			memcmp(work_set->reuse_rels, reuse_rels, n_reuse_rels * sizeof(Oid)) != 0)
+	{
+		Cache_Release(workfile_mgr_cache, entry);
+		return NULL;
+	}
+
+	elog(gp_workfile_caching_loglevel, "attached to cached workfile set: key=0x%x path=%s size=" INT64_FORMAT,
+			work_set->key, work_set->path, work_set->size);
+
+	return work_set;
+}
+
+/*
+ * Evict one published workfile set from the cache.
+ *
+ * entry must be in state CACHED. The entry is looked up again by key to
+ * pin it, so a concurrent eviction of the same entry is safe. The files
+ * of the set are deleted once the last reader releases its pin.
+ *
+ * Returns true if this backend marked the entry for deletion.
+ */
+static bool
+workfile_mgr_evict_entry(CacheEntry *entry)
+{
+	workfile_set *work_set = CACHE_ENTRY_PAYLOAD(entry);
+
+	/*
+	 * Unsynchronized read of the key. Cache_Lookup re-validates state and
+	 * key under the anchor lock, so the worst case is pinning a different
+	 * set with the same fingerprint, which is an equally valid victim.
+	 */
+	workfile_set_hashkey_t key = work_set->key;
+
+	CacheEntry *pinned = Cache_Lookup(workfile_mgr_cache, &key);
+	if (NULL == pinned)
+	{
+		return false;
+	}
+
+	bool removed = Cache_TryRemove(workfile_mgr_cache, pinned);
+	Cache_Release(workfile_mgr_cache, pinned);
+
+	return removed;
+}
+
+/*
+ * Evict any one published workfile set to make room for a new one.
+ * Returns false if no evictable entry was found.
+ */
+static bool
+workfile_mgr_evict_any(void)
+{
+	CacheHdr *cacheHdr = workfile_mgr_cache->cacheHdr;
+
+	for (int32 i = 0; i < (int32) cacheHdr->nEntries; i++)
+	{
+		CacheEntry *entry = Cache_GetEntryByIndex(cacheHdr, i);
+
+		if (entry->state != CACHE_ENTRY_CACHED)
+		{
+			continue;
+		}
+
+		if (workfile_mgr_evict_entry(entry))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+ * Relcache invalidation callback.
+ *
+ * Evicts every published workfile set that depends on the invalidated
+ * relation. This catches DDL, truncation and relation rewrites; plain DML
+ * does not invalidate the relcache, which is why workfile reuse is opt-in
+ * and intended for static data.
+ */
+static void
+workfile_mgr_relcache_callback(Datum arg, Oid relid)
+{
+	if (NULL == workfile_mgr_cache)
+	{
+		return;
+	}
+
+	CacheHdr *cacheHdr = workfile_mgr_cache->cacheHdr;
+
+	for (int32 i = 0; i < (int32) cacheHdr->nEntries; i++)
+	{
+		CacheEntry *entry = Cache_GetEntryByIndex(cacheHdr, i);
+
+		if (entry->state != CACHE_ENTRY_CACHED)
+		{
+			continue;
+		}
+
+		workfile_set *work_set = CACHE_ENTRY_PAYLOAD(entry);
+		bool matches = (InvalidOid == relid);
+
+		for (int j = 0; j < work_set->n_reuse_rels && !matches; j++)
+		{
+			matches = (work_set->reuse_rels[j] == relid);
+		}
+
+		if (matches)
+		{
+			(void) workfile_mgr_evict_entry(entry);
+		}
+	}
+}
+
+/*
+ * Register the relcache invalidation callback for this backend, once.
+ */
+static void
+workfile_mgr_register_inval_callback(void)
+{
+	if (!workfile_inval_callback_registered)
+	{
+		CacheRegisterRelcacheCallback(workfile_mgr_relcache_callback, (Datum) 0);
+		workfile_inval_callback_registered = true;
+	}
+}
+
 /*
  * This function is called at transaction commit or abort to delete closed
  * workfiles.
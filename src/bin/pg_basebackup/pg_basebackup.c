@@ -45,6 +45,7 @@ char	   *label = "pg_basebackup base backup";
 bool		showprogress = false;
 int			verbose = 0;
 int			compresslevel = 0;
+int			servercompression = 0;	/* server-side compression level, 0 = off */
 bool		includewal = false;
 bool		streamwal = false;
 bool		fastcheckpoint = false;
@@ -106,6 +107,82 @@ get_gz_error(gzFile gzf)
 	else
 		return errmsg;
 }
+
+/*
+ * Inflate one CopyData message received from a server that compresses the
+ * backup stream (--server-compression).  Each message is a self-contained
+ * gzip member, so inflating message by message recovers the stream with
+ * its original framing -- one tar header per message, file data in
+ * message-sized chunks -- which the tar processing below relies on.
+ *
+ * Replaces *copybuf with a malloc'd buffer holding the decompressed data
+ * (still freed with PQfreemem by the caller) and returns its length.
+ */
+static int
+DecompressCopyData(char **copybuf, int r)
+{
+	z_stream	zs;
+	char	   *outbuf;
+	size_t		outbufsize;
+
+	outbufsize = Max((size_t) r * 4, (size_t) 65536);
+	outbuf = malloc(outbufsize);
+	if (outbuf == NULL)
+	{
+		fprintf(stderr, _("%s: out of memory\n"), progname);
+		disconnect_and_exit(1);
+	}
+
+	MemSet(&zs, 0, sizeof(zs));
+	zs.next_in = (Bytef *) *copybuf;
+	zs.avail_in = r;
+
+	if (inflateInit2(&zs, MAX_WBITS + 16) != Z_OK)
+	{
+		fprintf(stderr, _("%s: could not initialize compression library: %s\n"),
+				progname, zs.msg ? zs.msg : "");
+		disconnect_and_exit(1);
+	}
+
+	for (;;)
+	{
+		int			status;
+
+		zs.next_out = (Bytef *) (outbuf + zs.total_out);
+		zs.avail_out = outbufsize - zs.total_out;
+
+		status = inflate(&zs, Z_NO_FLUSH);
+		if (status == Z_STREAM_END)
+			break;
+		if (status == Z_OK || status == Z_BUF_ERROR)
+		{
+			if (zs.avail_out == 0)
+			{
+				outbufsize *= 2;
+				outbuf = realloc(outbuf, outbufsize);
+				if (outbuf == NULL)
+				{
+					fprintf(stderr, _("%s: out of memory\n"), progname);
+					disconnect_and_exit(1);
+				}
+				continue;
+			}
+			if (status == Z_OK)
+				continue;
+		}
+
+		fprintf(stderr, _("%s: could not decompress COPY data: %s\n"),
+				progname, zs.msg ? zs.msg : "");
+		disconnect_and_exit(1);
+	}
+
+	r = zs.total_out;
+	inflateEnd(&zs);
+	PQfreemem(*copybuf);
+	*copybuf = outbuf;
+
+	return r;
+}
 #endif
 
 static void
@@ -125,6 +202,9 @@ usage(void)
 			 "                         include required WAL files with specified method\n"));
 	printf(_("  -z, --gzip             compress tar output\n"));
 	printf(_("  -Z, --compress=0-9     compress tar output with given compression level\n"));
+	printf(_("      --server-compression=1-9\n"
+			 "                         compress the backup stream on the server with the\n"
+			 "                         given level, decompressing it on arrival\n"));
 	printf(_("\nGeneral options:\n"));
 	printf(_("  -c, --checkpoint=fast|spread\n"
 			 "                         set fast or spread checkpointing\n"));
@@ -721,6 +801,11 @@ ReceiveTarFile(PGconn *conn, PGresult *res, int rownum)
 			disconnect_and_exit(1);
 		}
 
+#ifdef HAVE_LIBZ
+		if (servercompression > 0)
+			r = DecompressCopyData(&copybuf, r);
+#endif
+
 		if (!writerecoveryconf || !basetablespace)
 		{
 			/*
@@ -912,6 +997,11 @@ ReceiveAndUnpackTarFile(PGconn *conn, PGresult *res, int rownum)
 			disconnect_and_exit(1);
 		}
 
+#ifdef HAVE_LIBZ
+		if (servercompression > 0)
+			r = DecompressCopyData(&copybuf, r);
+#endif
+
 		if (file == NULL)
 		{
 			int			filemode;
@@ -1326,6 +1416,7 @@ BaseBackup(void)
 	uint32		timeline;
 	char		current_path[MAXPGPATH];
 	char		escaped_label[MAXPGPATH];
+	char		compression_opt[32];
 	int			i;
 	char		xlogstart[64];
 	char		xlogend[64];
@@ -1370,13 +1461,19 @@ BaseBackup(void)
 	 * Start the actual backup
 	 */
 	PQescapeStringConn(conn, escaped_label, label, sizeof(escaped_label), &i);
+	if (servercompression > 0)
+		snprintf(compression_opt, sizeof(compression_opt),
+				 "COMPRESSION '%d'", servercompression);
+	else
+		compression_opt[0] = '\0';
 	snprintf(current_path, sizeof(current_path),
-			 "BASE_BACKUP LABEL '%s' %s %s %s %s",
+			 "BASE_BACKUP LABEL '%s' %s %s %s %s %s",
 			 escaped_label,
 			 showprogress ? "PROGRESS" : "",
 			 includewal && !streamwal ? "WAL" : "",
 			 fastcheckpoint ? "FAST" : "",
-			 includewal ? "NOWAIT" : "");
+			 includewal ? "NOWAIT" : "",
+			 compression_opt);
 	exclude_list = build_exclude_list(excludes, num_exclude);
 	if (strlcat(current_path, exclude_list, sizeof(current_path)) >= sizeof(current_path))
 	{
@@ -1643,6 +1740,7 @@ main(int argc, char **argv)
 		{"xlog-method", required_argument, NULL, 'X'},
 		{"gzip", no_argument, NULL, 'z'},
 		{"compress", required_argument, NULL, 'Z'},
+		{"server-compression", required_argument, NULL, 1},
 		{"label", required_argument, NULL, 'l'},
 		{"dbname", required_argument, NULL, 'd'},
 		{"host", required_argument, NULL, 'h'},
@@ -1758,6 +1856,15 @@ main(int argc, char **argv)
 					exit(1);
 				}
 				break;
+			case 1:				/* --server-compression */
+				servercompression = atoi(optarg);
+				if (servercompression <= 0 || servercompression > 9)
+				{
+					fprintf(stderr, _("%s: invalid compression level \"%s\"\n"),
+							progname, optarg);
+					exit(1);
+				}
+				break;
 			case 'c':
 				if (pg_strcasecmp(optarg, "fast") == 0)
 					fastcheckpoint = true;
@@ -1872,7 +1979,7 @@ main(int argc, char **argv)
 	}
 
 #ifndef HAVE_LIBZ
-	if (compresslevel != 0)
+	if (compresslevel != 0 || servercompression != 0)
 	{
 		fprintf(stderr,
 				_("%s: this build does not support compression\n"),
@@ -144,6 +144,13 @@ static int	disable_dollar_quoting = 0;
 static int	dump_inserts = 0;
 static int	column_inserts = 0;
 
+/*
+ * If set, table data is not streamed through the dump; instead each segment
+ * writes its own slice of every table into a file under this directory using
+ * COPY ... ON SEGMENT.  The directory must exist on every segment host.
+ */
+static char *on_segment_dir = NULL;
+
 /* flag indicating whether or not this GP database supports partitioning */
 static bool gp_partitioning_available = false;
 
@@ -473,6 +480,7 @@ main(int argc, char **argv)
 		{"post-data-schema-only", no_argument, &postDataSchemaOnly, 1},
 		{"function-oids", required_argument, NULL, 1002},
 		{"relation-oids", required_argument, NULL, 1003},
+		{"on-segment-dir", required_argument, NULL, 1004},
 		/* END MPP ADDITION */
 		{NULL, 0, NULL, 0}
 	};
@@ -681,6 +689,10 @@ main(int argc, char **argv)
 				include_everything = false;
 				break;
 
+			case 1004:				/* on-segment-dir */
+				on_segment_dir = optarg;
+				break;
+
 			default:
 				fprintf(stderr, _("Try \"%s --help\" for more information.\n"), progname);
 				exit(1);
@@ -732,6 +744,12 @@ main(int argc, char **argv)
 		exit(1);
 	}
 
+	if (on_segment_dir && dump_inserts)
+	{
+		write_msg(NULL, "options --inserts/--column-inserts and --on-segment-dir cannot be used together\n");
+		exit(1);
+	}
+
 	/* open the output file */
 	if (pg_strcasecmp(format, "a") == 0 || pg_strcasecmp(format, "append") == 0)
 	{
@@ -768,6 +786,16 @@ main(int argc, char **argv)
 		exit(1);
 	}
 
+	/*
+	 * The ON SEGMENT data files live on the segment hosts, outside the
+	 * archive, so only the plain-text format can reference them.
+	 */
+	if (on_segment_dir && !plainText)
+	{
+		write_msg(NULL, "option --on-segment-dir can only be used with the plain-text format\n");
+		exit(1);
+	}
+
 	/* Let the archiver know how noisy to be */
 	g_fout->verbose = g_verbose;
 
@@ -1090,6 +1118,8 @@ help(const char *progname)
 	printf(_("  --no-gp-syntax              dump without Greenplum Database syntax (default if postgresql)\n"));
 	printf(_("  --function-oids             dump only function(s) of given list of oids\n"));
 	printf(_("  --relation-oids             dump only relation(s) of given list of oids\n"));
+	printf(_("  --on-segment-dir=DIR        dump table data in parallel on the segments into\n"
+			 "                              per-segment files under DIR (plain text only)\n"));
 	/* END MPP ADDITION */
 
 	printf(_("\nConnection options:\n"));
@@ -1672,6 +1702,94 @@ dumpTableData_copy(Archive *fout, void *dcontext)
 	return 1;
 }
 
+/*
+ *	Dump a table's contents into per-segment files using COPY ... ON SEGMENT
+ *	- this routine is called by the Archiver when it wants the table
+ *	  to be dumped.
+ *
+ * Rather than funneling every row through the QD and this process, each
+ * segment writes its own slice of the table to a local file, so the data
+ * dump runs in parallel across the whole cluster.  All that goes into the
+ * archive is the matching COPY ... FROM ... ON SEGMENT command; the
+ * plain-text dump thereby doubles as the manifest tying each table to its
+ * per-segment data files.  Restoring requires a cluster with the same
+ * number of segments (the server validates row distribution on load when
+ * gp_enable_segment_copy_checking is set).
+ */
+static int
+dumpTableData_onSegment(Archive *fout, void *dcontext)
+{
+	TableDataInfo *tdinfo = (TableDataInfo *) dcontext;
+	TableInfo  *tbinfo = tdinfo->tdtable;
+	const char *classname = tbinfo->dobj.name;
+	PQExpBuffer q = createPQExpBuffer();
+	PQExpBuffer path = createPQExpBuffer();
+	PGresult   *res;
+	const char *column_list;
+
+	if (g_verbose)
+		write_msg(NULL, "dumping contents of table %s to per-segment files\n",
+				  classname);
+
+	/*
+	 * Make sure we are in proper schema.  We will qualify the table name
+	 * below anyway (in case its name conflicts with a pg_catalog table); but
+	 * this ensures reproducible results in case the table contains regproc,
+	 * regclass, etc columns.
+	 */
+	selectSourceSchema(tbinfo->dobj.namespace->dobj.name);
+
+	/*
+	 * If possible, specify the column list explicitly so that we have no
+	 * possibility of retrieving data in the wrong column order.  (The default
+	 * column ordering of COPY will not be what we want in certain corner
+	 * cases involving ADD COLUMN and inheritance.)
+	 */
+	if (g_fout->remoteVersion >= 70300)
+		column_list = fmtCopyColumnList(tbinfo);
+	else
+		error_unsupported_server_version();
+
+	/*
+	 * Name the data files after the table's OID, which is unique within the
+	 * source cluster; the server replaces <SEGID> with each segment's
+	 * content id.
+	 */
+	appendPQExpBuffer(path, "%s/%u_<SEGID>.dat",
+					  on_segment_dir, tbinfo->dobj.catId.oid);
+
+	appendPQExpBuffer(q, "COPY %s %s %sTO ",
+					  fmtQualifiedId(tbinfo->dobj.namespace->dobj.name,
+									 classname),
+					  column_list,
+					  (tdinfo->oids && tbinfo->hasoids) ? "WITH OIDS " : "");
+	appendStringLiteralConn(q, path->data, g_conn);
+	appendPQExpBuffer(q, " ON SEGMENT IGNORE EXTERNAL PARTITIONS;");
+
+	res = PQexec(g_conn, q->data);
+	check_sql_result(res, g_conn, q->data, PGRES_COMMAND_OK);
+	PQclear(res);
+
+	/*
+	 * Emit the command that loads the per-segment files back; this is what
+	 * the restore script executes in place of inline data.  The table name
+	 * is left unqualified because the script sets search_path, same as the
+	 * COPY FROM stdin statements of a regular dump.
+	 */
+	resetPQExpBuffer(q);
+	appendPQExpBuffer(q, "COPY %s ", fmtId(classname));
+	appendPQExpBuffer(q, "%s %sFROM ",
+					  column_list,
+					  (tdinfo->oids && tbinfo->hasoids) ? "WITH OIDS " : "");
+	appendStringLiteralAH(q, path->data, fout);
+	appendPQExpBuffer(q, " ON SEGMENT;");
+	archprintf(fout, "%s\n\n\n", q->data);
+
+	destroyPQExpBuffer(q);
+	destroyPQExpBuffer(path);
+	return 1;
+}
+
 /*
  * Dump table data using INSERT commands.
  *
@@ -1839,7 +1957,17 @@ dumpTableData(Archive *fout, TableDataInfo *tdinfo)
 	DataDumperPtr dumpFn;
 	char	   *copyStmt;
 
-	if (!dump_inserts)
+	if (on_segment_dir)
+	{
+		/*
+		 * Dump/restore using COPY ... ON SEGMENT.  The dumper itself emits
+		 * the COPY FROM command referencing the per-segment files, so no
+		 * copyStmt is needed (as with INSERT mode).
+		 */
+		dumpFn = dumpTableData_onSegment;
+		copyStmt = NULL;
+	}
+	else if (!dump_inserts)
 	{
 		/* Dump/restore using COPY */
 		dumpFn = dumpTableData_copy;
@@ -13,17 +13,41 @@
 #include "postgres_fe.h"
 #include "common.h"
 
+#ifdef HAVE_SYS_SELECT_H
+#include <sys/select.h>
+#endif
+
+
+/* A connection slot of the parallel vacuum worker pool */
+typedef struct
+{
+	PGconn	   *connection;
+	bool		isFree;
+} ParallelSlot;
 
 static void vacuum_one_database(const char *dbname, bool full, bool verbose,
 					bool and_analyze, bool analyze_only, bool freeze,
-					const char *table, const char *host, const char *port,
+					const char *table, int jobs,
+					const char *host, const char *port,
 					const char *username, enum trivalue prompt_password,
 					const char *progname, bool echo);
 static void vacuum_all_databases(bool full, bool verbose, bool and_analyze,
-					 bool analyze_only, bool freeze,
+					 bool analyze_only, bool freeze, int jobs,
 					 const char *host, const char *port,
 					 const char *username, enum trivalue prompt_password,
 					 const char *progname, bool echo, bool quiet);
+static void prepare_vacuum_command(PQExpBuffer sql, PGconn *conn,
+					   bool full, bool verbose, bool and_analyze,
+					   bool analyze_only, bool freeze);
+static void run_parallel_vacuum(PGresult *tables, const char *prefix,
+					const char *dbname, int jobs,
+					const char *host, const char *port,
+					const char *username, enum trivalue prompt_password,
+					const char *progname, bool echo);
+static bool consume_query_result(PGconn *conn, const char *dbname,
+					 const char *progname);
+static ParallelSlot *get_idle_slot(ParallelSlot *slots, int numslots,
+			  const char *dbname, const char *progname, bool *failed);
 
 static void help(const char *progname);
 
@@ -47,6 +71,7 @@ main(int argc, char *argv[])
 		{"table", required_argument, NULL, 't'},
 		{"full", no_argument, NULL, 'f'},
 		{"verbose", no_argument, NULL, 'v'},
+		{"jobs", required_argument, NULL, 'j'},
 		{NULL, 0, NULL, 0}
 	};
 
@@ -68,13 +93,14 @@ main(int argc, char *argv[])
 	char	   *table = NULL;
 	bool		full = false;
 	bool		verbose = false;
+	int			jobs = 1;
 
 	progname = get_progname(argv[0]);
 	set_pglocale_pgservice(argv[0], PG_TEXTDOMAIN("pgscripts"));
 
 	handle_help_version_opts(argc, argv, "vacuumdb", help);
 
-	while ((c = getopt_long(argc, argv, "h:p:U:wWeqd:zZFat:fv", long_options, &optindex)) != -1)
+	while ((c = getopt_long(argc, argv, "h:p:U:wWeqd:zZFat:fvj:", long_options, &optindex)) != -1)
 	{
 		switch (c)
 		{
@@ -123,6 +149,21 @@ main(int argc, char *argv[])
 			case 'v':
 				verbose = true;
 				break;
+			case 'j':
+				jobs = atoi(optarg);
+				if (jobs <= 0)
+				{
+					fprintf(stderr, _("%s: number of parallel \"jobs\" must be at least 1\n"),
+							progname);
+					exit(1);
+				}
+				if (jobs > FD_SETSIZE - 1)
+				{
+					fprintf(stderr, _("%s: too many parallel jobs requested (maximum: %d)\n"),
+							progname, FD_SETSIZE - 1);
+					exit(1);
+				}
+				break;
 			default:
 				fprintf(stderr, _("Try \"%s --help\" for more information.\n"), progname);
 				exit(1);
@@ -178,7 +219,7 @@ main(int argc, char *argv[])
 		}
 
 		vacuum_all_databases(full, verbose, and_analyze, analyze_only, freeze,
-							 host, port, username, prompt_password,
+							 jobs, host, port, username, prompt_password,
 							 progname, echo, quiet);
 	}
 	else
@@ -194,7 +235,7 @@ main(int argc, char *argv[])
 		}
 
 		vacuum_one_database(dbname, full, verbose, and_analyze, analyze_only,
-							freeze, table,
+							freeze, table, jobs,
 							host, port, username, prompt_password,
 							progname, echo);
 	}
@@ -205,7 +246,7 @@ main(int argc, char *argv[])
 
 static void
 vacuum_one_database(const char *dbname, bool full, bool verbose, bool and_analyze,
-					bool analyze_only, bool freeze, const char *table,
+					bool analyze_only, bool freeze, const char *table, int jobs,
 					const char *host, const char *port,
 					const char *username, enum trivalue prompt_password,
 					const char *progname, bool echo)
@@ -218,15 +259,119 @@ vacuum_one_database(const char *dbname, bool full, bool verbose, bool and_analyz
 
 	conn = connectDatabase(dbname, host, port, username, prompt_password, progname);
 
+	prepare_vacuum_command(&sql, conn, full, verbose, and_analyze,
+						   analyze_only, freeze);
+
+	/*
+	 * With --jobs, fan the work out across multiple sessions.  The unit of
+	 * parallelism is one relation as the server sees it: for a whole-database
+	 * run, every table that is not a partition child (a partitioned root
+	 * expands to its whole hierarchy server-side, so listing the children too
+	 * would process them twice); for -t on a partitioned table, its leaf
+	 * partitions.
+	 */
+	if (jobs > 1 && !(table && strchr(table, '(')))
+	{
+		PQExpBufferData tablesql;
+		PGresult   *tables;
+
+		initPQExpBuffer(&tablesql);
+
+		if (table)
+		{
+			/*
+			 * Fetch the table's leaf partitions, biggest first so the long
+			 * jobs start early.  An empty result means the table is not
+			 * partitioned and we fall through to the plain code path.
+			 */
+			appendPQExpBuffer(&tablesql,
+							  "SELECT pg_catalog.quote_ident(n.nspname) || '.' || pg_catalog.quote_ident(c.relname) "
+							  "FROM pg_catalog.pg_partition p "
+							  "JOIN pg_catalog.pg_partition_rule r ON r.paroid = p.oid "
+							  "JOIN pg_catalog.pg_class c ON c.oid = r.parchildrelid "
+							  "JOIN pg_catalog.pg_namespace n ON n.oid = c.relnamespace "
+							  "WHERE p.parrelid = '%s'::pg_catalog.regclass "
+							  "AND NOT p.paristemplate "
+							  "AND c.oid NOT IN (SELECT inhparent FROM pg_catalog.pg_inherits) "
+							  "ORDER BY c.relpages DESC;",
+							  table);
+		}
+		else
+		{
+			appendPQExpBuffer(&tablesql,
+							  "SELECT pg_catalog.quote_ident(n.nspname) || '.' || pg_catalog.quote_ident(c.relname) "
+							  "FROM pg_catalog.pg_class c "
+							  "JOIN pg_catalog.pg_namespace n ON n.oid = c.relnamespace "
+							  "WHERE c.relkind = 'r' AND NOT c.relistemp "
+							  "AND c.relstorage IN ('h', 'a', 'c') "
+							  "AND c.oid NOT IN (SELECT parchildrelid FROM pg_catalog.pg_partition_rule) "
+							  "ORDER BY c.relpages DESC;");
+		}
+
+		tables = executeQuery(conn, tablesql.data, progname, echo);
+		termPQExpBuffer(&tablesql);
+
+		if (PQntuples(tables) > 0)
+		{
+			run_parallel_vacuum(tables, sql.data, dbname, jobs,
+								host, port, username, prompt_password,
+								progname, echo);
+			PQclear(tables);
+
+			/*
+			 * For -t on a partitioned table, finish with one ordinary pass
+			 * over the whole hierarchy to cover the root and any interior
+			 * partitions, which cannot be vacuumed on their own.  They hold
+			 * no data, and the just-vacuumed leaves are skipped cheaply via
+			 * the visibility map, so this pass is quick.
+			 */
+			if (!table)
+			{
+				PQfinish(conn);
+				termPQExpBuffer(&sql);
+				return;
+			}
+		}
+		else
+			PQclear(tables);
+	}
+
+	if (table)
+		appendPQExpBuffer(&sql, " %s", table);
+	appendPQExpBuffer(&sql, ";\n");
+
+	if (!executeMaintenanceCommand(conn, sql.data, echo))
+	{
+		if (table)
+			fprintf(stderr, _("%s: vacuuming of table \"%s\" in database \"%s\" failed: %s"),
+					progname, table, dbname, PQerrorMessage(conn));
+		else
+			fprintf(stderr, _("%s: vacuuming of database \"%s\" failed: %s"),
+					progname, dbname, PQerrorMessage(conn));
+		PQfinish(conn);
+		exit(1);
+	}
+	PQfinish(conn);
+	termPQExpBuffer(&sql);
+}
+
+
+/*
+ * Build the VACUUM/ANALYZE command up to, but not including, the table name.
+ */
+static void
+prepare_vacuum_command(PQExpBuffer sql, PGconn *conn, bool full, bool verbose,
+					   bool and_analyze, bool analyze_only, bool freeze)
+{
 	if (analyze_only)
 	{
-		appendPQExpBuffer(&sql, "ANALYZE");
+		appendPQExpBuffer(sql, "ANALYZE");
 		if (verbose)
-			appendPQExpBuffer(&sql, " VERBOSE");
+			appendPQExpBuffer(sql, " VERBOSE");
 	}
 	else
 	{
-		appendPQExpBuffer(&sql, "VACUUM");
+		appendPQExpBuffer(sql, "VACUUM");
 		if (PQserverVersion(conn) >= 90000)
 		{
 			const char *paren = " (";
@@ -235,62 +380,206 @@ vacuum_one_database(const char *dbname, bool full, bool verbose, bool and_analyz
 
 			if (full)
 			{
-				appendPQExpBuffer(&sql, "%sFULL", sep);
+				appendPQExpBuffer(sql, "%sFULL", sep);
 				sep = comma;
 			}
 			if (freeze)
 			{
-				appendPQExpBuffer(&sql, "%sFREEZE", sep);
+				appendPQExpBuffer(sql, "%sFREEZE", sep);
 				sep = comma;
 			}
 			if (verbose)
 			{
-				appendPQExpBuffer(&sql, "%sVERBOSE", sep);
+				appendPQExpBuffer(sql, "%sVERBOSE", sep);
 				sep = comma;
 			}
 			if (and_analyze)
 			{
-				appendPQExpBuffer(&sql, "%sANALYZE", sep);
+				appendPQExpBuffer(sql, "%sANALYZE", sep);
 				sep = comma;
 			}
 			if (sep != paren)
-				appendPQExpBuffer(&sql, ")");
+				appendPQExpBuffer(sql, ")");
 		}
 		else
 		{
 			if (full)
-				appendPQExpBuffer(&sql, " FULL");
+				appendPQExpBuffer(sql, " FULL");
 			if (freeze)
-				appendPQExpBuffer(&sql, " FREEZE");
+				appendPQExpBuffer(sql, " FREEZE");
 			if (verbose)
-				appendPQExpBuffer(&sql, " VERBOSE");
+				appendPQExpBuffer(sql, " VERBOSE");
 			if (and_analyze)
-				appendPQExpBuffer(&sql, " ANALYZE");
+				appendPQExpBuffer(sql, " ANALYZE");
 		}
 	}
-	if (table)
-		appendPQExpBuffer(&sql, " %s", table);
-	appendPQExpBuffer(&sql, ";\n");
+}
 
-	if (!executeMaintenanceCommand(conn, sql.data, echo))
+
+/*
+ * Run the command "<prefix> <table>;" for every table in the given result
+ * set, spread across up to "jobs" concurrent sessions.  Exits on failure,
+ * after letting the commands already in flight finish.
+ */
+static void
+run_parallel_vacuum(PGresult *tables, const char *prefix,
+					const char *dbname, int jobs,
+					const char *host, const char *port,
+					const char *username, enum trivalue prompt_password,
+					const char *progname, bool echo)
+{
+	ParallelSlot *slots;
+	PQExpBufferData sql;
+	bool		failed = false;
+	int			ntables = PQntuples(tables);
+	int			i;
+
+	if (jobs > ntables)
+		jobs = ntables;
+
+	slots = (ParallelSlot *) malloc(jobs * sizeof(ParallelSlot));
+	if (!slots)
 	{
-		if (table)
-			fprintf(stderr, _("%s: vacuuming of table \"%s\" in database \"%s\" failed: %s"),
-					progname, table, dbname, PQerrorMessage(conn));
-		else
-			fprintf(stderr, _("%s: vacuuming of database \"%s\" failed: %s"),
-					progname, dbname, PQerrorMessage(conn));
-		PQfinish(conn);
+		fprintf(stderr, _("%s: out of memory\n"), progname);
 		exit(1);
 	}
-	PQfinish(conn);
+	for (i = 0; i < jobs; i++)
+	{
+		slots[i].connection = connectDatabase(dbname, host, port, username,
+											  prompt_password, progname);
+		slots[i].isFree = true;
+	}
+
+	initPQExpBuffer(&sql);
+
+	for (i = 0; i < ntables; i++)
+	{
+		ParallelSlot *slot;
+
+		slot = get_idle_slot(slots, jobs, dbname, progname, &failed);
+
+		resetPQExpBuffer(&sql);
+		appendPQExpBuffer(&sql, "%s %s;", prefix, PQgetvalue(tables, i, 0));
+
+		if (echo)
+			printf("%s\n", sql.data);
+		if (!PQsendQuery(slot->connection, sql.data))
+		{
+			fprintf(stderr, _("%s: vacuuming of database \"%s\" failed: %s"),
+					progname, dbname, PQerrorMessage(slot->connection));
+			failed = true;
+			break;
+		}
+		slot->isFree = false;
+	}
+
+	/* Wait for the stragglers */
+	for (i = 0; i < jobs; i++)
+	{
+		if (!slots[i].isFree &&
+			!consume_query_result(slots[i].connection, dbname, progname))
+			failed = true;
+		PQfinish(slots[i].connection);
+	}
+
 	termPQExpBuffer(&sql);
+	free(slots);
+
+	if (failed)
+		exit(1);
+}
+
+
+/*
+ * Absorb whatever results are pending on a busy connection; returns false
+ * and reports the error if any command failed.
+ */
+static bool
+consume_query_result(PGconn *conn, const char *dbname, const char *progname)
+{
+	bool		ok = true;
+	PGresult   *result;
+
+	while ((result = PQgetResult(conn)) != NULL)
+	{
+		if (PQresultStatus(result) != PGRES_COMMAND_OK)
+		{
+			fprintf(stderr, _("%s: vacuuming of database \"%s\" failed: %s"),
+					progname, dbname, PQerrorMessage(conn));
+			ok = false;
+		}
+		PQclear(result);
+	}
+
+	return ok;
+}
+
+
+/*
+ * Return a slot whose connection is ready for a new command, waiting for
+ * one of the busy connections to finish if necessary.
+ */
+static ParallelSlot *
+get_idle_slot(ParallelSlot *slots, int numslots,
+			  const char *dbname, const char *progname, bool *failed)
+{
+	for (;;)
+	{
+		fd_set		rfds;
+		int			maxfd = 0;
+		int			i;
+
+		for (i = 0; i < numslots; i++)
+		{
+			if (slots[i].isFree)
+				return &slots[i];
+		}
+
+		FD_ZERO(&rfds);
+		for (i = 0; i < numslots; i++)
+		{
+			int			sock = PQsocket(slots[i].connection);
+
+			FD_SET(sock, &rfds);
+			if (sock > maxfd)
+				maxfd = sock;
+		}
+
+		if (select(maxfd + 1, &rfds, NULL, NULL, NULL) < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			fprintf(stderr, _("%s: could not wait on connections: %s\n"),
+					progname, strerror(errno));
+			exit(1);
+		}
+
+		for (i = 0; i < numslots; i++)
+		{
+			if (!FD_ISSET(PQsocket(slots[i].connection), &rfds))
+				continue;
+
+			if (!PQconsumeInput(slots[i].connection))
+			{
+				fprintf(stderr, _("%s: vacuuming of database \"%s\" failed: %s"),
+						progname, dbname, PQerrorMessage(slots[i].connection));
+				exit(1);
+			}
+
+			if (!PQisBusy(slots[i].connection))
+			{
+				if (!consume_query_result(slots[i].connection, dbname, progname))
+					*failed = true;
+				slots[i].isFree = true;
+			}
+		}
+	}
 }
 
 
 static void
 vacuum_all_databases(bool full, bool verbose, bool and_analyze, bool analyze_only,
-					 bool freeze, const char *host, const char *port,
+					 bool freeze, int jobs, const char *host, const char *port,
 					 const char *username, enum trivalue prompt_password,
 					 const char *progname, bool echo, bool quiet)
 {
@@ -313,7 +602,8 @@ vacuum_all_databases(bool full, bool verbose, bool and_analyze, bool analyze_onl
 		}
 
 		vacuum_one_database(dbname, full, verbose, and_analyze, analyze_only,
-						 freeze, NULL, host, port, username, prompt_password,
+							freeze, NULL, jobs,
+							host, port, username, prompt_password,
 							progname, echo);
 	}
 
@@ -333,6 +623,9 @@ help(const char *progname)
 	printf(_("  -e, --echo                      show the commands being sent to the server\n"));
 	printf(_("  -f, --full                      do full vacuuming\n"));
 	printf(_("  -F, --freeze                    freeze row transaction information\n"));
+	printf(_("  -j, --jobs=NUM                  use this many concurrent connections to vacuum;\n"
+			 "                                  with -t on a partitioned table, its leaf\n"
+			 "                                  partitions are spread across the connections\n"));
 	printf(_("  -q, --quiet                     don't write any messages\n"));
 	printf(_("  -t, --table='TABLE[(COLUMNS)]'  vacuum specific table only\n"));
 	printf(_("  -v, --verbose                   write a lot of output\n"));
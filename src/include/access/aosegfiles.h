@@ -154,6 +154,22 @@ extern FileSegInfo *GetFileSegInfo(Relation parentrel, Snapshot appendOnlyMetaDa
 
 extern FileSegInfo **GetAllFileSegInfo(Relation parentrel, Snapshot appendOnlyMetaDataSnapshot, int *totalsegs);
 
+/*
+ * Transaction-local cache of aoseg catalog contents, shared by the row- and
+ * column-oriented variants of GetAllFileSegInfo. A hit hands back a copy the
+ * caller owns; infoSize is the per-entry allocation size.
+ */
+extern bool AOSegFileInfoCacheLookup(Relation parentrel,
+						 Snapshot appendOnlyMetaDataSnapshot,
+						 Size infoSize,
+						 void ***seginfos,
+						 int *totalsegs);
+extern void AOSegFileInfoCacheStore(Relation parentrel,
+						Snapshot appendOnlyMetaDataSnapshot,
+						void **seginfos,
+						int totalsegs,
+						Size infoSize);
+
 extern FileSegInfo **GetAllFileSegInfo_pg_aoseg_rel(char *relationName, Relation pg_aoseg_rel, Snapshot appendOnlyMetaDataSnapshot, int *totalsegs);
 
 extern void UpdateFileSegInfo(Relation parentrel,
@@ -57,6 +57,21 @@ typedef struct AppendOnlyVisimap
 	 */
 	AppendOnlyVisimapStore visimapStore;
 
+	/*
+	 * Coverage of the current visimap entry, cached for the inline
+	 * visibility fast path.  cacheSegmentFileNum is -1 when nothing is
+	 * cached.  cacheAllVisible is set when the covering entry hides no
+	 * tuples at all; otherwise cacheBitmap points at the entry's decoded
+	 * bitmap and a single bit test decides.  The cache is refreshed
+	 * whenever the entry is repositioned and invalidated whenever the
+	 * entry is changed underneath it (the delete paths).
+	 */
+	int32		cacheSegmentFileNum;
+	int64		cacheFirstRowNum;
+	int64		cacheLastRowNum;
+	bool		cacheAllVisible;
+	Bitmapset  *cacheBitmap;
+
 } AppendOnlyVisimap;
 
 /*
@@ -105,10 +120,44 @@ void AppendOnlyVisimap_Init(
 					   LOCKMODE lockmode,
 					   Snapshot appendonlyMetaDataSnapshot);
 
-bool AppendOnlyVisimap_IsVisible(
+bool AppendOnlyVisimap_IsVisibleInternal(
 							AppendOnlyVisimap *visiMap,
 							AOTupleId *tupleId);
 
+/*
+ * Checks if a tuple is visible according to the visibility map.
+ * A positive result is a necessary but not sufficient condition for
+ * a tuple to be visible to the user.
+ *
+ * The common case during sequential scans -- another tuple from the
+ * range the current visimap entry covers -- is answered from the
+ * coverage cache without leaving the caller: either the whole range is
+ * visible or a single bitmap test decides.  Everything else takes the
+ * out-of-line path, which repositions the entry and refreshes the cache.
+ *
+ * Assumes that the visibility has been initialized and not finished.
+ */
+static inline bool
+AppendOnlyVisimap_IsVisible(
+							AppendOnlyVisimap *visiMap,
+							AOTupleId *tupleId)
+{
+	int64		rowNum = AOTupleIdGet_rowNum(tupleId);
+
+	if (AOTupleIdGet_segmentFileNum(tupleId) == visiMap->cacheSegmentFileNum &&
+		rowNum >= visiMap->cacheFirstRowNum &&
+		rowNum <= visiMap->cacheLastRowNum)
+	{
+		if (visiMap->cacheAllVisible)
+			return true;
+
+		return !bms_is_member((int) (rowNum - visiMap->cacheFirstRowNum),
+							  visiMap->cacheBitmap);
+	}
+
+	return AppendOnlyVisimap_IsVisibleInternal(visiMap, tupleId);
+}
+
 void AppendOnlyVisimap_Finish(
 						 AppendOnlyVisimap *visiMap,
 						 LOCKMODE lockmode);
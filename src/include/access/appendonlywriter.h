@@ -21,6 +21,7 @@
 #include "nodes/plannodes.h"
 #include "nodes/relation.h"
 #include "storage/lock.h"
+#include "storage/spin.h"
 #include "tcop/dest.h"
 
 /*
@@ -199,6 +200,8 @@ typedef AORelHashEntryData *AORelHashEntry;
 
 typedef struct AppendOnlyWriterData
 {
+	slock_t		mutex;			/* protects num_existing_aorels, which is
+								 * shared by all hash table partitions */
 	int			num_existing_aorels;	/* Current # of recorded entries for
 										 * AO relations */
 } AppendOnlyWriterData;
@@ -210,6 +213,7 @@ extern AppendOnlyWriterData *AppendOnlyWriter;
 extern Size AppendOnlyWriterShmemSize(void);
 extern void InitAppendOnlyWriter(void);
 extern Size AppendOnlyWriterShmemSize(void);
+extern LWLockId AORelSegFilePartitionLock(Oid relid);
 extern int	SetSegnoForWrite(Relation rel, int existingsegno);
 extern void RegisterSegnoForCompactionDrop(Oid relid, List *compactedSegmentFileList);
 extern void DeregisterSegnoForCompactionDrop(Oid relid, List *compactedSegmentFileList);
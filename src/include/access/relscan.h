@@ -96,6 +96,8 @@ typedef struct FileScanDescData
 	Relation	fs_rd;			/* target relation descriptor */
 	struct URL_FILE *fs_file;	/* the file pointer to our URI */
 	char	   *fs_uri;			/* the URI string */
+	List	   *fs_morelocs;	/* more URIs to drain after fs_uri (see
+								 * gp_external_chain_urls) */
 	bool		fs_noop;		/* no op. this segdb has no file to scan */
 	uint32      fs_scancounter;	/* copied from struct ExternalScan in plan */
 	
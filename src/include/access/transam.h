@@ -14,6 +14,7 @@
 #ifndef TRANSAM_H
 #define TRANSAM_H
 
+#include "access/clog.h"
 #include "catalog/pg_magic_oid.h"
 #include "access/xlogdefs.h"
 
@@ -124,6 +125,8 @@ extern int xid_warn_limit;
  * prototypes for functions in transam/transam.c
  */
 extern bool TransactionIdDidCommit(TransactionId transactionId);
+extern void TransactionIdFetchStatusBatch(int nxids, const TransactionId *xids,
+							  XidStatus *status);
 extern bool TransactionIdDidAbort(TransactionId transactionId);
 extern bool TransactionIdIsKnownCompleted(TransactionId transactionId);
 extern void TransactionIdAbort(TransactionId transactionId);
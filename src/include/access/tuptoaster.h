@@ -199,13 +199,21 @@ extern HeapTuple toast_flatten_tuple(HeapTuple tup, TupleDesc tupleDesc);
 extern Datum toast_flatten_tuple_attribute(Datum value,
 							  Oid typeId, int32 typeMod);
 
+/*
+ * TOAST compression methods.  PGLZ is the historical default; LZ4 is
+ * available when built with --with-lz4 and selected per column through
+ * the "compresstype" attribute option.
+ */
+#define TOAST_COMPRESSION_PGLZ	0
+#define TOAST_COMPRESSION_LZ4	1
+
 /* ----------
  * toast_compress_datum -
  *
  *	Create a compressed version of a varlena datum, if possible
  * ----------
  */
-extern Datum toast_compress_datum(Datum value);
+extern Datum toast_compress_datum(Datum value, int cmethod);
 
 /* ----------
  * toast_raw_datum_size -
@@ -214,6 +214,7 @@ extern char *XLogArchiveCommand;
 extern bool EnableHotStandby;
 extern bool gp_keep_all_xlog;
 extern int keep_wal_segments;
+extern int	gp_recovery_prefetch_distance;
 
 extern bool *wal_consistency_checking;
 extern char *wal_consistency_checking_string;
@@ -131,7 +131,7 @@ DATA(insert ( 2105	n 0 float8_avg_accum float8_avg_decum float8_avg_amalg float8
 DATA(insert ( 2106	n 0 interval_accum	interval_decum interval_amalg	interval_demalg interval_avg	f 0	1187	"{0 second,0 second}"));
 
 /* sum */
-DATA(insert ( 2107	n 0 int8_sum		int8_invsum 	numeric_add		numeric_sub -				f 0	1700	_null_));
+DATA(insert ( 2107	n 0 int8_sum_accum	int8_sum_decum 	int8_sum_amalg	int8_sum_demalg int8_sum_final	f 0	17		""));
 DATA(insert ( 2108	n 0 int4_sum		int4_invsum 	int8pl			int8mi -				f 0	20		_null_));
 DATA(insert ( 2109	n 0 int2_sum		int2_invsum		int8pl			int8mi -				f 0	20		_null_));
 DATA(insert ( 2110	n 0 float4pl		float4mi float4pl			float4mi -				f 0	700		_null_));
@@ -194,48 +194,48 @@ DATA(insert ( 2803	n 0 int8inc			int8dec	 int8pl	int8mi -				f 0		20		"0"));
 DATA(insert ( 2718	n 0 int8_accum		int8_decum	 numeric_amalg	numeric_demalg numeric_var_pop	f 0	1231	"{0,0,0}"));
 DATA(insert ( 2719	n 0 int4_accum		int4_decum	 numeric_amalg	numeric_demalg numeric_var_pop	f 0	1231	"{0,0,0}"));
 DATA(insert ( 2720	n 0 int2_accum		int2_decum	 numeric_amalg	numeric_demalg numeric_var_pop	f 0	1231	"{0,0,0}"));
-DATA(insert ( 2721	n 0 float4_accum	float4_decum float8_amalg	float8_demalg float8_var_pop	f 0	1022	"{0,0,0}"));
-DATA(insert ( 2722	n 0 float8_accum	float8_decum float8_amalg	float8_demalg float8_var_pop	f 0	1022	"{0,0,0}"));
+DATA(insert ( 2721	n 0 float4_stat_accum	float4_stat_decum float8_stat_amalg	float8_stat_demalg float8_stat_var_pop	f 0	17	""));
+DATA(insert ( 2722	n 0 float8_stat_accum	float8_stat_decum float8_stat_amalg	float8_stat_demalg float8_stat_var_pop	f 0	17	""));
 DATA(insert ( 2723	n 0 numeric_accum	numeric_decum	 numeric_amalg	numeric_demalg numeric_var_pop	f 0	1231	"{0,0,0}"));
 
 /* var_samp */
 DATA(insert ( 2641	n 0 int8_accum		int8_decum	 numeric_amalg	numeric_demalg numeric_var_samp	f 0	1231	"{0,0,0}"));
 DATA(insert ( 2642	n 0 int4_accum		int4_decum	 numeric_amalg	numeric_demalg numeric_var_samp	f 0	1231	"{0,0,0}"));
 DATA(insert ( 2643	n 0 int2_accum		int2_decum	 numeric_amalg	numeric_demalg numeric_var_samp	f 0	1231	"{0,0,0}"));
-DATA(insert ( 2644	n 0 float4_accum	float4_decum float8_amalg	float8_demalg float8_var_samp	f 0	1022	"{0,0,0}"));
-DATA(insert ( 2645	n 0 float8_accum	float8_decum float8_amalg	float8_demalg float8_var_samp	f 0	1022	"{0,0,0}"));
+DATA(insert ( 2644	n 0 float4_stat_accum	float4_stat_decum float8_stat_amalg	float8_stat_demalg float8_stat_var_samp	f 0	17	""));
+DATA(insert ( 2645	n 0 float8_stat_accum	float8_stat_decum float8_stat_amalg	float8_stat_demalg float8_stat_var_samp	f 0	17	""));
 DATA(insert ( 2646	n 0 numeric_accum 	numeric_decum	 numeric_amalg	numeric_demalg numeric_var_samp	f 0	1231	"{0,0,0}"));
 
 /* variance: historical Postgres syntax for var_samp */
 DATA(insert ( 2148	n 0 int8_accum		int8_decum	 numeric_amalg	numeric_demalg numeric_var_samp	f 0	1231	"{0,0,0}"));
 DATA(insert ( 2149	n 0 int4_accum		int4_decum	 numeric_amalg	numeric_demalg numeric_var_samp	f 0	1231	"{0,0,0}"));
 DATA(insert ( 2150	n 0 int2_accum		int2_decum	 numeric_amalg	numeric_demalg numeric_var_samp	f 0	1231	"{0,0,0}"));
-DATA(insert ( 2151	n 0 float4_accum	float4_decum float8_amalg	float8_demalg float8_var_samp	f 0	1022	"{0,0,0}"));
-DATA(insert ( 2152	n 0 float8_accum	float8_decum float8_amalg	float8_demalg float8_var_samp	f 0	1022	"{0,0,0}"));
+DATA(insert ( 2151	n 0 float4_stat_accum	float4_stat_decum float8_stat_amalg	float8_stat_demalg float8_stat_var_samp	f 0	17	""));
+DATA(insert ( 2152	n 0 float8_stat_accum	float8_stat_decum float8_stat_amalg	float8_stat_demalg float8_stat_var_samp	f 0	17	""));
 DATA(insert ( 2153	n 0 numeric_accum	numeric_decum	 numeric_amalg	numeric_demalg numeric_var_samp	f 0	1231	"{0,0,0}"));
 
 /* stddev_pop */
 DATA(insert ( 2724	n 0 int8_accum		int8_decum	 numeric_amalg	numeric_demalg numeric_stddev_pop	f 0	1231	"{0,0,0}"));
 DATA(insert ( 2725	n 0 int4_accum		int4_decum	 numeric_amalg	numeric_demalg numeric_stddev_pop	f 0	1231	"{0,0,0}"));
 DATA(insert ( 2726	n 0 int2_accum		int2_decum	 numeric_amalg	numeric_demalg numeric_stddev_pop	f 0	1231	"{0,0,0}"));
-DATA(insert ( 2727	n 0 float4_accum	float4_decum float8_amalg	float8_demalg float8_stddev_pop		f 0	1022	"{0,0,0}"));
-DATA(insert ( 2728	n 0 float8_accum	float8_decum float8_amalg	float8_demalg float8_stddev_pop		f 0	1022	"{0,0,0}"));
+DATA(insert ( 2727	n 0 float4_stat_accum	float4_stat_decum float8_stat_amalg	float8_stat_demalg float8_stat_stddev_pop		f 0	17	""));
+DATA(insert ( 2728	n 0 float8_stat_accum	float8_stat_decum float8_stat_amalg	float8_stat_demalg float8_stat_stddev_pop		f 0	17	""));
 DATA(insert ( 2729	n 0 numeric_accum	numeric_decum	 numeric_amalg	numeric_demalg numeric_stddev_pop	f 0	1231	"{0,0,0}"));
 
 /* stddev_samp */
 DATA(insert ( 2712	n 0 int8_accum		int8_decum	 numeric_amalg	numeric_demalg numeric_stddev_samp	f 0	1231	"{0,0,0}"));
 DATA(insert ( 2713	n 0 int4_accum		int4_decum	 numeric_amalg	numeric_demalg numeric_stddev_samp	f 0	1231	"{0,0,0}"));
 DATA(insert ( 2714	n 0 int2_accum		int2_decum	 numeric_amalg	numeric_demalg numeric_stddev_samp	f 0	1231	"{0,0,0}"));
-DATA(insert ( 2715	n 0 float4_accum	float4_decum float8_amalg	float8_demalg float8_stddev_samp	f 0	1022	"{0,0,0}"));
-DATA(insert ( 2716	n 0 float8_accum	float8_decum float8_amalg	float8_demalg float8_stddev_samp	f 0	1022	"{0,0,0}"));
+DATA(insert ( 2715	n 0 float4_stat_accum	float4_stat_decum float8_stat_amalg	float8_stat_demalg float8_stat_stddev_samp	f 0	17	""));
+DATA(insert ( 2716	n 0 float8_stat_accum	float8_stat_decum float8_stat_amalg	float8_stat_demalg float8_stat_stddev_samp	f 0	17	""));
 DATA(insert ( 2717	n 0 numeric_accum	numeric_decum	 numeric_amalg	numeric_demalg numeric_stddev_samp	f 0	1231	"{0,0,0}"));
 
 /* stddev: historical Postgres syntax for stddev_samp */
 DATA(insert ( 2154	n 0 int8_accum		int8_decum	 numeric_amalg	numeric_demalg numeric_stddev_samp	f 0	1231	"{0,0,0}"));
 DATA(insert ( 2155	n 0 int4_accum		int4_decum	 numeric_amalg	numeric_demalg numeric_stddev_samp	f 0	1231	"{0,0,0}"));
 DATA(insert ( 2156	n 0 int2_accum		int2_decum numeric_amalg	numeric_demalg numeric_stddev_samp	f 0	1231	"{0,0,0}"));
-DATA(insert ( 2157	n 0 float4_accum	float4_decum float8_amalg	float8_demalg float8_stddev_samp	f 0	1022	"{0,0,0}"));
-DATA(insert ( 2158	n 0 float8_accum	float8_decum float8_amalg	float8_demalg float8_stddev_samp	f 0	1022	"{0,0,0}"));
+DATA(insert ( 2157	n 0 float4_stat_accum	float4_stat_decum float8_stat_amalg	float8_stat_demalg float8_stat_stddev_samp	f 0	17	""));
+DATA(insert ( 2158	n 0 float8_stat_accum	float8_stat_decum float8_stat_amalg	float8_stat_demalg float8_stat_stddev_samp	f 0	17	""));
 DATA(insert ( 2159	n 0 numeric_accum	numeric_decum numeric_amalg	numeric_demalg numeric_stddev_samp	f 0	1231	"{0,0,0}"));
 
 /* SQL2003 binary regression aggregates */
@@ -4997,6 +4997,9 @@ DATA(insert OID = 6130 ( median					PGNSP PGUID 12 1 0 0 t f f f f i 2 0 1184 "7
 DESCR("median");
 #define IS_MEDIAN_OID(x) ((x) == 6127 || (x) == 6128 || (x) == 6129 || (x) == 6130)
 
+DATA(insert OID = 6131 ( gp_vfd_stats			PGNSP PGUID 12 1 0 0 f f f t f v 0 0 2249 "" "{20,20,20,20,20,23,23}" "{o,o,o,o,o,o,o}" "{opens,closes,evictions,accesses,hits,open_files,max_safe_fds}" _null_ gp_vfd_stats _null_ _null_ _null_ ));
+DESCR("virtual file descriptor cache statistics for this backend");
+
 /* hypothetical-set aggregates (and their support functions) */
 DATA(insert OID = 3986 ( rank				PGNSP PGUID 12 1 0 2276 t f f f f i 1 0 20 "2276" "{2276}" "{v}" _null_ _null_	aggregate_dummy _null_ _null_ _null_ n a ));
 DESCR("rank of hypothetical row");
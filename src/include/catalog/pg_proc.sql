@@ -10,6 +10,14 @@
  CREATE FUNCTION float8_decum(_float8, float8) RETURNS _float8 LANGUAGE internal IMMUTABLE STRICT AS 'float8_decum' WITH (OID=6025, DESCRIPTION="aggregate inverse transition function");
  CREATE FUNCTION float8_avg_accum(bytea, float8) RETURNS bytea LANGUAGE internal IMMUTABLE STRICT AS 'float8_avg_accum' WITH (OID=4108, DESCRIPTION="aggregate transition function");
  CREATE FUNCTION float8_avg_decum(bytea, float8) RETURNS bytea LANGUAGE internal IMMUTABLE STRICT AS 'float8_avg_decum' WITH (OID=4109, DESCRIPTION="aggregate inverse transition function");
+ CREATE FUNCTION float4_stat_accum(bytea, float4) RETURNS bytea LANGUAGE internal IMMUTABLE STRICT AS 'float4_stat_accum' WITH (OID=4112, DESCRIPTION="aggregate transition function");
+ CREATE FUNCTION float4_stat_decum(bytea, float4) RETURNS bytea LANGUAGE internal IMMUTABLE STRICT AS 'float4_stat_decum' WITH (OID=4113, DESCRIPTION="aggregate inverse transition function");
+ CREATE FUNCTION float8_stat_accum(bytea, float8) RETURNS bytea LANGUAGE internal IMMUTABLE STRICT AS 'float8_stat_accum' WITH (OID=4114, DESCRIPTION="aggregate transition function");
+ CREATE FUNCTION float8_stat_decum(bytea, float8) RETURNS bytea LANGUAGE internal IMMUTABLE STRICT AS 'float8_stat_decum' WITH (OID=4115, DESCRIPTION="aggregate inverse transition function");
+ CREATE FUNCTION float8_stat_var_pop(bytea) RETURNS float8 LANGUAGE internal IMMUTABLE STRICT AS 'float8_stat_var_pop' WITH (OID=4118, DESCRIPTION="aggregate final function");
+ CREATE FUNCTION float8_stat_var_samp(bytea) RETURNS float8 LANGUAGE internal IMMUTABLE STRICT AS 'float8_stat_var_samp' WITH (OID=4119, DESCRIPTION="aggregate final function");
+ CREATE FUNCTION float8_stat_stddev_pop(bytea) RETURNS float8 LANGUAGE internal IMMUTABLE STRICT AS 'float8_stat_stddev_pop' WITH (OID=4120, DESCRIPTION="aggregate final function");
+ CREATE FUNCTION float8_stat_stddev_samp(bytea) RETURNS float8 LANGUAGE internal IMMUTABLE STRICT AS 'float8_stat_stddev_samp' WITH (OID=4121, DESCRIPTION="aggregate final function");
  CREATE FUNCTION btgpxlogloccmp(gpxlogloc, gpxlogloc) RETURNS int4 LANGUAGE internal IMMUTABLE STRICT AS 'btgpxlogloccmp' WITH (OID=7081, DESCRIPTION="btree less-equal-greater");
 
 -- MPP -- array_add -- special for prospective customer 
@@ -81,6 +89,12 @@
 
  CREATE FUNCTION int8_avg_accum(bytea, int8) RETURNS bytea LANGUAGE internal IMMUTABLE STRICT AS 'int8_avg_accum' WITH (OID=4100, DESCRIPTION="AVG(int8) transition function");
 
+ CREATE FUNCTION int8_sum_accum(bytea, int8) RETURNS bytea LANGUAGE internal IMMUTABLE STRICT AS 'int8_sum_accum' WITH (OID=6099, DESCRIPTION="SUM(int8) transition function");
+
+ CREATE FUNCTION int8_sum_decum(bytea, int8) RETURNS bytea LANGUAGE internal IMMUTABLE STRICT AS 'int8_sum_decum' WITH (OID=6100, DESCRIPTION="SUM(int8) inverse transition function");
+
+ CREATE FUNCTION int8_sum_final(bytea) RETURNS "numeric" LANGUAGE internal IMMUTABLE STRICT AS 'int8_sum_final' WITH (OID=6108, DESCRIPTION="SUM(int8) final function");
+
  CREATE FUNCTION int2_avg_decum(bytea, int2) RETURNS bytea LANGUAGE internal IMMUTABLE STRICT AS 'int2_avg_decum' WITH (OID=6019, DESCRIPTION="AVG(int2) transition function");
 
  CREATE FUNCTION int4_avg_decum(bytea, int4) RETURNS bytea LANGUAGE internal IMMUTABLE STRICT AS 'int4_avg_decum' WITH (OID=6020, DESCRIPTION="AVG(int4) transition function");
@@ -111,10 +125,18 @@
 
  CREATE FUNCTION pg_resgroup_get_status(IN groupid oid, OUT groupid oid, OUT num_running int4, OUT num_queueing int4, OUT num_queued int4, OUT num_executed int4, OUT total_queue_duration interval, OUT cpu_usage json, OUT memory_usage json) RETURNS SETOF pg_catalog.record LANGUAGE internal VOLATILE AS 'pg_resgroup_get_status' WITH (OID=6066, DESCRIPTION="statistics: information about resource groups");
 
+ CREATE FUNCTION gp_backend_memory_contexts(IN pid int4, OUT context_name text, OUT level int4, OUT nblocks int8, OUT nchunks int8, OUT allocated_bytes int8, OUT available_bytes int8) RETURNS SETOF pg_catalog.record LANGUAGE internal VOLATILE STRICT AS 'gp_backend_memory_contexts' WITH (OID=6085, DESCRIPTION="memory context statistics of a live server process");
+
+ CREATE FUNCTION gp_catcache_statistics(OUT entries int8, OUT negative_entries int8, OUT bytes int8, OUT evictions int8, OUT negative_prunes int8) RETURNS pg_catalog.record LANGUAGE internal VOLATILE STRICT AS 'gp_catcache_statistics' WITH (OID=6090, DESCRIPTION="catalog cache size and eviction counters of this session");
+
+ CREATE FUNCTION gp_relcache_write_user_init_file() RETURNS int4 LANGUAGE internal VOLATILE STRICT AS 'gp_relcache_write_user_init_file' WITH (OID=6091, DESCRIPTION="snapshot this session's user relations into the relation cache init file");
+
  CREATE FUNCTION pg_resqueue_status() RETURNS SETOF record LANGUAGE internal VOLATILE STRICT AS 'pg_resqueue_status' WITH (OID=6030, DESCRIPTION="Return resource queue information");
 
  CREATE FUNCTION pg_resqueue_status_kv() RETURNS SETOF record LANGUAGE internal VOLATILE STRICT AS 'pg_resqueue_status_kv' WITH (OID=6069, DESCRIPTION="Return resource queue information");
 
+ CREATE FUNCTION gp_resqueue_stats() RETURNS SETOF record LANGUAGE internal VOLATILE STRICT AS 'gp_resqueue_stats' WITH (OID=6098, DESCRIPTION="Return resource queue admission and wait statistics");
+
  CREATE FUNCTION pg_file_read(text, int8, int8) RETURNS text LANGUAGE internal VOLATILE STRICT AS 'pg_read_file' WITH (OID=6045, DESCRIPTION="Read text from a file");
 
  CREATE FUNCTION pg_logfile_rotate() RETURNS bool LANGUAGE internal VOLATILE STRICT AS 'pg_rotate_logfile' WITH (OID=6046, DESCRIPTION="Rotate log file");
@@ -211,10 +233,14 @@
 
  CREATE FUNCTION int8_avg_amalg(bytea, bytea) RETURNS bytea LANGUAGE internal IMMUTABLE STRICT AS 'int8_avg_amalg' WITH (OID=6009, DESCRIPTION="aggregate preliminary function");
 
+ CREATE FUNCTION int8_sum_amalg(bytea, bytea) RETURNS bytea LANGUAGE internal IMMUTABLE STRICT AS 'int8_sum_amalg' WITH (OID=6101, DESCRIPTION="aggregate preliminary function");
+
  CREATE FUNCTION float8_amalg(_float8, _float8) RETURNS _float8 LANGUAGE internal IMMUTABLE STRICT AS 'float8_amalg' WITH (OID=6010, DESCRIPTION="aggregate preliminary function");
 
  CREATE FUNCTION float8_avg_amalg(bytea, bytea) RETURNS bytea LANGUAGE internal IMMUTABLE STRICT AS 'float8_avg_amalg' WITH (OID=4111, DESCRIPTION="aggregate preliminary function");
 
+ CREATE FUNCTION float8_stat_amalg(bytea, bytea) RETURNS bytea LANGUAGE internal IMMUTABLE STRICT AS 'float8_stat_amalg' WITH (OID=4116, DESCRIPTION="aggregate preliminary function");
+
  CREATE FUNCTION interval_amalg(_interval, _interval) RETURNS _interval LANGUAGE internal IMMUTABLE STRICT AS 'interval_amalg' WITH (OID=6011, DESCRIPTION="aggregate preliminary function");
 
  CREATE FUNCTION numeric_demalg(_numeric, _numeric) RETURNS _numeric LANGUAGE internal IMMUTABLE STRICT AS 'numeric_demalg' WITH (OID=6015, DESCRIPTION="aggregate inverse preliminary function");
@@ -223,10 +249,14 @@
 
  CREATE FUNCTION int8_avg_demalg(bytea, bytea) RETURNS bytea LANGUAGE internal IMMUTABLE STRICT AS 'int8_avg_demalg' WITH (OID=6016, DESCRIPTION="aggregate preliminary function");
 
+ CREATE FUNCTION int8_sum_demalg(bytea, bytea) RETURNS bytea LANGUAGE internal IMMUTABLE STRICT AS 'int8_sum_demalg' WITH (OID=6102, DESCRIPTION="aggregate inverse preliminary function");
+
  CREATE FUNCTION float8_demalg(_float8, _float8) RETURNS _float8 LANGUAGE internal IMMUTABLE STRICT AS 'float8_demalg' WITH (OID=6017);
 
  CREATE FUNCTION float8_avg_demalg(bytea, bytea) RETURNS bytea LANGUAGE internal IMMUTABLE STRICT AS 'float8_avg_demalg' WITH (OID=4110, DESCRIPTION="aggregate inverse preliminary function");
 
+ CREATE FUNCTION float8_stat_demalg(bytea, bytea) RETURNS bytea LANGUAGE internal IMMUTABLE STRICT AS 'float8_stat_demalg' WITH (OID=4117, DESCRIPTION="aggregate inverse preliminary function");
+
  CREATE FUNCTION interval_demalg(_interval, _interval) RETURNS _interval LANGUAGE internal IMMUTABLE STRICT AS 'interval_demalg' WITH (OID=6018, DESCRIPTION="aggregate preliminary function");
 
  CREATE FUNCTION float8_regr_amalg(_float8, _float8) RETURNS _float8 LANGUAGE internal IMMUTABLE STRICT AS 'float8_regr_amalg' WITH (OID=6014);
@@ -244,6 +274,12 @@
 
  CREATE FUNCTION gp_distributed_xid() RETURNS xid LANGUAGE internal VOLATILE STRICT AS 'gp_distributed_xid' WITH (OID=6037, DESCRIPTION="Current distributed transaction id");
 
+ CREATE FUNCTION gp_dispatch_stats() RETURNS SETOF record LANGUAGE internal VOLATILE AS 'gp_dispatch_stats__' WITH (OID=6094, DESCRIPTION="view per-session dispatch latency statistics");
+
+ CREATE FUNCTION gp_wait_event_counters() RETURNS SETOF record LANGUAGE internal VOLATILE EXECUTE ON ALL SEGMENTS AS 'gp_wait_event_counters' WITH (OID=6096, DESCRIPTION="view lock wait-event counters of each segment");
+
+ CREATE FUNCTION gp_query_resource_usage() RETURNS SETOF record LANGUAGE internal VOLATILE EXECUTE ON ALL SEGMENTS AS 'gp_query_resource_usage' WITH (OID=6097, DESCRIPTION="view per-query resource usage of each segment");
+
  CREATE FUNCTION gp_transaction_log() RETURNS SETOF record LANGUAGE internal VOLATILE AS 'gp_transaction_log' WITH (OID=6043, DESCRIPTION="view logged local transaction status");
 
  CREATE FUNCTION gp_distributed_log() RETURNS SETOF record LANGUAGE internal VOLATILE AS 'gp_distributed_log' WITH (OID=6044, DESCRIPTION="view logged distributed transaction status");
@@ -318,6 +354,8 @@
 -- Analyze related
  CREATE FUNCTION gp_statistics_estimate_reltuples_relpages_oid(oid) RETURNS _float4 LANGUAGE internal VOLATILE STRICT AS 'gp_statistics_estimate_reltuples_relpages_oid' WITH (OID=5032, DESCRIPTION="Return reltuples/relpages information for relation.");
 
+ CREATE FUNCTION gp_acquire_sample_rows(oid, int4, _int2) RETURNS SETOF record LANGUAGE internal VOLATILE STRICT EXECUTE ON ALL SEGMENTS AS 'gp_acquire_sample_rows' WITH (OID=6095, DESCRIPTION="Acquire a random sample of rows from a table, for ANALYZE.");
+
 -- Backoff related
  CREATE FUNCTION gp_adjust_priority(int4, int4, int4) RETURNS int4 LANGUAGE internal VOLATILE STRICT AS 'gp_adjust_priority_int' WITH (OID=5040, DESCRIPTION="change weight of all the backends for a given session id");
 
@@ -330,6 +368,9 @@
 
  CREATE FUNCTION gp_truncate_error_log(text) RETURNS bool LANGUAGE INTERNAL STRICT VOLATILE AS 'gp_truncate_error_log' WITH (OID=3069, DESCRIPTION="truncate the error log for the specified external table");
 
+-- interconnect statistics
+ CREATE FUNCTION gp_interconnect_flow_stats(OUT teardowns int8, OUT snd_pkts int8, OUT recv_pkts int8, OUT retransmits int8, OUT crc_errors int8, OUT mismatched_pkts int8, OUT disordered_pkts int8, OUT duplicated_pkts int8, OUT recv_acks int8, OUT status_query_msgs int8, OUT recv_queue_depth_avg float8, OUT capacity_avg float8) RETURNS pg_catalog.record LANGUAGE internal VOLATILE AS 'gp_interconnect_flow_stats' WITH (OID=7178, DESCRIPTION="statistics: cumulative UDP interconnect counters for this segment");
+
 -- elog related
  CREATE FUNCTION gp_elog(text) RETURNS void LANGUAGE internal IMMUTABLE STRICT AS 'gp_elog' WITH (OID=5044, DESCRIPTION="Insert text into the error log");
 
@@ -22,7 +22,7 @@
 
    WARNING: DO NOT MODIFY THE FOLLOWING SECTION: 
    Generated by catullus.pl version 8
-   on Mon Feb 12 17:02:42 2018
+   on Sat Aug 29 16:53:02 2026
 
    Please make your changes in pg_proc.sql
 */
@@ -56,6 +56,38 @@ DESCR("aggregate transition function");
 DATA(insert OID = 4109 ( float8_avg_decum  PGNSP PGUID 12 1 0 0 f f f t f i 2 0 17 "17 701" _null_ _null_ _null_ _null_ float8_avg_decum _null_ _null_ _null_ n a ));
 DESCR("aggregate inverse transition function");
 
+/* float4_stat_accum(bytea, float4) => bytea */
+DATA(insert OID = 4112 ( float4_stat_accum  PGNSP PGUID 12 1 0 0 f f f t f i 2 0 17 "17 700" _null_ _null_ _null_ _null_ float4_stat_accum _null_ _null_ _null_ n a ));
+DESCR("aggregate transition function");
+
+/* float4_stat_decum(bytea, float4) => bytea */
+DATA(insert OID = 4113 ( float4_stat_decum  PGNSP PGUID 12 1 0 0 f f f t f i 2 0 17 "17 700" _null_ _null_ _null_ _null_ float4_stat_decum _null_ _null_ _null_ n a ));
+DESCR("aggregate inverse transition function");
+
+/* float8_stat_accum(bytea, float8) => bytea */
+DATA(insert OID = 4114 ( float8_stat_accum  PGNSP PGUID 12 1 0 0 f f f t f i 2 0 17 "17 701" _null_ _null_ _null_ _null_ float8_stat_accum _null_ _null_ _null_ n a ));
+DESCR("aggregate transition function");
+
+/* float8_stat_decum(bytea, float8) => bytea */
+DATA(insert OID = 4115 ( float8_stat_decum  PGNSP PGUID 12 1 0 0 f f f t f i 2 0 17 "17 701" _null_ _null_ _null_ _null_ float8_stat_decum _null_ _null_ _null_ n a ));
+DESCR("aggregate inverse transition function");
+
+/* float8_stat_var_pop(bytea) => float8 */
+DATA(insert OID = 4118 ( float8_stat_var_pop  PGNSP PGUID 12 1 0 0 f f f t f i 1 0 701 "17" _null_ _null_ _null_ _null_ float8_stat_var_pop _null_ _null_ _null_ n a ));
+DESCR("aggregate final function");
+
+/* float8_stat_var_samp(bytea) => float8 */
+DATA(insert OID = 4119 ( float8_stat_var_samp  PGNSP PGUID 12 1 0 0 f f f t f i 1 0 701 "17" _null_ _null_ _null_ _null_ float8_stat_var_samp _null_ _null_ _null_ n a ));
+DESCR("aggregate final function");
+
+/* float8_stat_stddev_pop(bytea) => float8 */
+DATA(insert OID = 4120 ( float8_stat_stddev_pop  PGNSP PGUID 12 1 0 0 f f f t f i 1 0 701 "17" _null_ _null_ _null_ _null_ float8_stat_stddev_pop _null_ _null_ _null_ n a ));
+DESCR("aggregate final function");
+
+/* float8_stat_stddev_samp(bytea) => float8 */
+DATA(insert OID = 4121 ( float8_stat_stddev_samp  PGNSP PGUID 12 1 0 0 f f f t f i 1 0 701 "17" _null_ _null_ _null_ _null_ float8_stat_stddev_samp _null_ _null_ _null_ n a ));
+DESCR("aggregate final function");
+
 /* btgpxlogloccmp(gpxlogloc, gpxlogloc) => int4 */
 DATA(insert OID = 7081 ( btgpxlogloccmp  PGNSP PGUID 12 1 0 0 f f f t f i 2 0 23 "3310 3310" _null_ _null_ _null_ _null_ btgpxlogloccmp _null_ _null_ _null_ n a ));
 DESCR("btree less-equal-greater");
@@ -189,6 +221,18 @@ DESCR("aggregate inverse transition function");
 DATA(insert OID = 4100 ( int8_avg_accum  PGNSP PGUID 12 1 0 0 f f f t f i 2 0 17 "17 20" _null_ _null_ _null_ _null_ int8_avg_accum _null_ _null_ _null_ n a ));
 DESCR("AVG(int8) transition function");
 
+/* int8_sum_accum(bytea, int8) => bytea */
+DATA(insert OID = 6099 ( int8_sum_accum  PGNSP PGUID 12 1 0 0 f f f t f i 2 0 17 "17 20" _null_ _null_ _null_ _null_ int8_sum_accum _null_ _null_ _null_ n a ));
+DESCR("SUM(int8) transition function");
+
+/* int8_sum_decum(bytea, int8) => bytea */
+DATA(insert OID = 6100 ( int8_sum_decum  PGNSP PGUID 12 1 0 0 f f f t f i 2 0 17 "17 20" _null_ _null_ _null_ _null_ int8_sum_decum _null_ _null_ _null_ n a ));
+DESCR("SUM(int8) inverse transition function");
+
+/* int8_sum_final(bytea) => "numeric" */
+DATA(insert OID = 6108 ( int8_sum_final  PGNSP PGUID 12 1 0 0 f f f t f i 1 0 1700 "17" _null_ _null_ _null_ _null_ int8_sum_final _null_ _null_ _null_ n a ));
+DESCR("SUM(int8) final function");
+
 /* int2_avg_decum(bytea, int2) => bytea */
 DATA(insert OID = 6019 ( int2_avg_decum  PGNSP PGUID 12 1 0 0 f f f t f i 2 0 17 "17 21" _null_ _null_ _null_ _null_ int2_avg_decum _null_ _null_ _null_ n a ));
 DESCR("AVG(int2) transition function");
@@ -249,6 +293,18 @@ DESCR("statistics: information about resource groups in key-value style");
 DATA(insert OID = 6066 ( pg_resgroup_get_status  PGNSP PGUID 12 1 1000 0 f f f f t v 1 0 2249 "26" "{26,26,23,23,23,23,1186,114,114}" "{i,o,o,o,o,o,o,o,o}" "{groupid,groupid,num_running,num_queueing,num_queued,num_executed,total_queue_duration,cpu_usage,memory_usage}" _null_ pg_resgroup_get_status _null_ _null_ _null_ n a ));
 DESCR("statistics: information about resource groups");
 
+/* gp_backend_memory_contexts(IN pid int4, OUT context_name text, OUT level int4, OUT nblocks int8, OUT nchunks int8, OUT allocated_bytes int8, OUT available_bytes int8) => SETOF pg_catalog.record */
+DATA(insert OID = 6085 ( gp_backend_memory_contexts  PGNSP PGUID 12 1 1000 0 f f f t t v 1 0 2249 "23" "{23,25,23,20,20,20,20}" "{i,o,o,o,o,o,o}" "{pid,context_name,level,nblocks,nchunks,allocated_bytes,available_bytes}" _null_ gp_backend_memory_contexts _null_ _null_ _null_ n a ));
+DESCR("memory context statistics of a live server process");
+
+/* gp_catcache_statistics(OUT entries int8, OUT negative_entries int8, OUT bytes int8, OUT evictions int8, OUT negative_prunes int8) => pg_catalog.record */
+DATA(insert OID = 6090 ( gp_catcache_statistics  PGNSP PGUID 12 1 0 0 f f f t f v 0 0 2249 "" "{20,20,20,20,20}" "{o,o,o,o,o}" "{entries,negative_entries,bytes,evictions,negative_prunes}" _null_ gp_catcache_statistics _null_ _null_ _null_ n a ));
+DESCR("catalog cache size and eviction counters of this session");
+
+/* gp_relcache_write_user_init_file() => int4 */
+DATA(insert OID = 6091 ( gp_relcache_write_user_init_file  PGNSP PGUID 12 1 0 0 f f f t f v 0 0 23 "" _null_ _null_ _null_ _null_ gp_relcache_write_user_init_file _null_ _null_ _null_ n a ));
+DESCR("snapshot this session's user relations into the relation cache init file");
+
 /* pg_resqueue_status() => SETOF record */
 DATA(insert OID = 6030 ( pg_resqueue_status  PGNSP PGUID 12 1 1000 0 f f f t t v 0 0 2249 "" _null_ _null_ _null_ _null_ pg_resqueue_status _null_ _null_ _null_ n a ));
 DESCR("Return resource queue information");
@@ -257,6 +313,10 @@ DESCR("Return resource queue information");
 DATA(insert OID = 6069 ( pg_resqueue_status_kv  PGNSP PGUID 12 1 1000 0 f f f t t v 0 0 2249 "" _null_ _null_ _null_ _null_ pg_resqueue_status_kv _null_ _null_ _null_ n a ));
 DESCR("Return resource queue information");
 
+/* gp_resqueue_stats() => SETOF record */
+DATA(insert OID = 6098 ( gp_resqueue_stats  PGNSP PGUID 12 1 1000 0 f f f t t v 0 0 2249 "" _null_ _null_ _null_ _null_ gp_resqueue_stats _null_ _null_ _null_ n a ));
+DESCR("Return resource queue admission and wait statistics");
+
 /* pg_file_read(text, int8, int8) => text */
 DATA(insert OID = 6045 ( pg_file_read  PGNSP PGUID 12 1 0 0 f f f t f v 3 0 25 "25 20 20" _null_ _null_ _null_ _null_ pg_read_file _null_ _null_ _null_ n a ));
 DESCR("Read text from a file");
@@ -432,6 +492,10 @@ DESCR("aggregate preliminary function");
 DATA(insert OID = 6009 ( int8_avg_amalg  PGNSP PGUID 12 1 0 0 f f f t f i 2 0 17 "17 17" _null_ _null_ _null_ _null_ int8_avg_amalg _null_ _null_ _null_ n a ));
 DESCR("aggregate preliminary function");
 
+/* int8_sum_amalg(bytea, bytea) => bytea */
+DATA(insert OID = 6101 ( int8_sum_amalg  PGNSP PGUID 12 1 0 0 f f f t f i 2 0 17 "17 17" _null_ _null_ _null_ _null_ int8_sum_amalg _null_ _null_ _null_ n a ));
+DESCR("aggregate preliminary function");
+
 /* float8_amalg(_float8, _float8) => _float8 */
 DATA(insert OID = 6010 ( float8_amalg  PGNSP PGUID 12 1 0 0 f f f t f i 2 0 1022 "1022 1022" _null_ _null_ _null_ _null_ float8_amalg _null_ _null_ _null_ n a ));
 DESCR("aggregate preliminary function");
@@ -440,6 +504,10 @@ DESCR("aggregate preliminary function");
 DATA(insert OID = 4111 ( float8_avg_amalg  PGNSP PGUID 12 1 0 0 f f f t f i 2 0 17 "17 17" _null_ _null_ _null_ _null_ float8_avg_amalg _null_ _null_ _null_ n a ));
 DESCR("aggregate preliminary function");
 
+/* float8_stat_amalg(bytea, bytea) => bytea */
+DATA(insert OID = 4116 ( float8_stat_amalg  PGNSP PGUID 12 1 0 0 f f f t f i 2 0 17 "17 17" _null_ _null_ _null_ _null_ float8_stat_amalg _null_ _null_ _null_ n a ));
+DESCR("aggregate preliminary function");
+
 /* interval_amalg(_interval, _interval) => _interval */
 DATA(insert OID = 6011 ( interval_amalg  PGNSP PGUID 12 1 0 0 f f f t f i 2 0 1187 "1187 1187" _null_ _null_ _null_ _null_ interval_amalg _null_ _null_ _null_ n a ));
 DESCR("aggregate preliminary function");
@@ -456,6 +524,10 @@ DESCR("aggregate inverse preliminary function");
 DATA(insert OID = 6016 ( int8_avg_demalg  PGNSP PGUID 12 1 0 0 f f f t f i 2 0 17 "17 17" _null_ _null_ _null_ _null_ int8_avg_demalg _null_ _null_ _null_ n a ));
 DESCR("aggregate preliminary function");
 
+/* int8_sum_demalg(bytea, bytea) => bytea */
+DATA(insert OID = 6102 ( int8_sum_demalg  PGNSP PGUID 12 1 0 0 f f f t f i 2 0 17 "17 17" _null_ _null_ _null_ _null_ int8_sum_demalg _null_ _null_ _null_ n a ));
+DESCR("aggregate preliminary function");
+
 /* float8_demalg(_float8, _float8) => _float8 */
 DATA(insert OID = 6017 ( float8_demalg  PGNSP PGUID 12 1 0 0 f f f t f i 2 0 1022 "1022 1022" _null_ _null_ _null_ _null_ float8_demalg _null_ _null_ _null_ n a ));
 
@@ -463,6 +535,10 @@ DATA(insert OID = 6017 ( float8_demalg  PGNSP PGUID 12 1 0 0 f f f t f i 2 0 102
 DATA(insert OID = 4110 ( float8_avg_demalg  PGNSP PGUID 12 1 0 0 f f f t f i 2 0 17 "17 17" _null_ _null_ _null_ _null_ float8_avg_demalg _null_ _null_ _null_ n a ));
 DESCR("aggregate inverse preliminary function");
 
+/* float8_stat_demalg(bytea, bytea) => bytea */
+DATA(insert OID = 4117 ( float8_stat_demalg  PGNSP PGUID 12 1 0 0 f f f t f i 2 0 17 "17 17" _null_ _null_ _null_ _null_ float8_stat_demalg _null_ _null_ _null_ n a ));
+DESCR("aggregate inverse preliminary function");
+
 /* interval_demalg(_interval, _interval) => _interval */
 DATA(insert OID = 6018 ( interval_demalg  PGNSP PGUID 12 1 0 0 f f f t f i 2 0 1187 "1187 1187" _null_ _null_ _null_ _null_ interval_demalg _null_ _null_ _null_ n a ));
 DESCR("aggregate preliminary function");
@@ -495,6 +571,18 @@ DESCR("view mpp distributed transaction state");
 DATA(insert OID = 6037 ( gp_distributed_xid  PGNSP PGUID 12 1 0 0 f f f t f v 0 0 28 "" _null_ _null_ _null_ _null_ gp_distributed_xid _null_ _null_ _null_ n a ));
 DESCR("Current distributed transaction id");
 
+/* gp_dispatch_stats() => SETOF record */
+DATA(insert OID = 6094 ( gp_dispatch_stats  PGNSP PGUID 12 1 1000 0 f f f f t v 0 0 2249 "" _null_ _null_ _null_ _null_ gp_dispatch_stats__ _null_ _null_ _null_ n a ));
+DESCR("view per-session dispatch latency statistics");
+
+/* gp_wait_event_counters() => SETOF record */
+DATA(insert OID = 6096 ( gp_wait_event_counters  PGNSP PGUID 12 1 1000 0 f f f f t v 0 0 2249 "" _null_ _null_ _null_ _null_ gp_wait_event_counters _null_ _null_ _null_ n s ));
+DESCR("view lock wait-event counters of each segment");
+
+/* gp_query_resource_usage() => SETOF record */
+DATA(insert OID = 6097 ( gp_query_resource_usage  PGNSP PGUID 12 1 1000 0 f f f f t v 0 0 2249 "" _null_ _null_ _null_ _null_ gp_query_resource_usage _null_ _null_ _null_ n s ));
+DESCR("view per-query resource usage of each segment");
+
 /* gp_transaction_log() => SETOF record */
 DATA(insert OID = 6043 ( gp_transaction_log  PGNSP PGUID 12 1 1000 0 f f f f t v 0 0 2249 "" _null_ _null_ _null_ _null_ gp_transaction_log _null_ _null_ _null_ n a ));
 DESCR("view logged local transaction status");
@@ -635,6 +723,9 @@ DESCR("Greenplum fault testing only");
 /* Analyze related */
 /* gp_statistics_estimate_reltuples_relpages_oid(oid) => _float4 */
 DATA(insert OID = 5032 ( gp_statistics_estimate_reltuples_relpages_oid  PGNSP PGUID 12 1 0 0 f f f t f v 1 0 1021 "26" _null_ _null_ _null_ _null_ gp_statistics_estimate_reltuples_relpages_oid _null_ _null_ _null_ n a ));
+
+/* gp_acquire_sample_rows(oid, int4, _int2) => SETOF record */
+DATA(insert OID = 6095 ( gp_acquire_sample_rows  PGNSP PGUID 12 1 1000 0 f f f t t v 3 0 2249 "26 23 1005" _null_ _null_ _null_ _null_ gp_acquire_sample_rows _null_ _null_ _null_ n s ));
 DESCR("Return reltuples/relpages information for relation.");
 
 
@@ -662,6 +753,12 @@ DATA(insert OID = 3069 ( gp_truncate_error_log  PGNSP PGUID 12 1 0 0 f f f t f v
 DESCR("truncate the error log for the specified external table");
 
 
+/* interconnect statistics */
+/* gp_interconnect_flow_stats(OUT teardowns int8, OUT snd_pkts int8, OUT recv_pkts int8, OUT retransmits int8, OUT crc_errors int8, OUT mismatched_pkts int8, OUT disordered_pkts int8, OUT duplicated_pkts int8, OUT recv_acks int8, OUT status_query_msgs int8, OUT recv_queue_depth_avg float8, OUT capacity_avg float8) => pg_catalog.record */
+DATA(insert OID = 7178 ( gp_interconnect_flow_stats  PGNSP PGUID 12 1 0 0 f f f f f v 0 0 2249 "" "{20,20,20,20,20,20,20,20,20,20,701,701}" "{o,o,o,o,o,o,o,o,o,o,o,o}" "{teardowns,snd_pkts,recv_pkts,retransmits,crc_errors,mismatched_pkts,disordered_pkts,duplicated_pkts,recv_acks,status_query_msgs,recv_queue_depth_avg,capacity_avg}" _null_ gp_interconnect_flow_stats _null_ _null_ _null_ n a ));
+DESCR("statistics: cumulative UDP interconnect counters for this segment");
+
+
 /* elog related */
 /* gp_elog(text) => void */
 DATA(insert OID = 5044 ( gp_elog  PGNSP PGUID 12 1 0 0 f f f t f i 1 0 2278 "25" _null_ _null_ _null_ _null_ gp_elog _null_ _null_ _null_ n a ));
@@ -71,6 +71,31 @@ typedef struct AOCSInsertDescData
 
 typedef AOCSInsertDescData *AOCSInsertDesc;
 
+/*
+ * A batch of rows bulk-read from an AOCS scan: one values / nulls vector
+ * per projected column, filled a column at a time, plus per-row results
+ * of the visibility map check and the synthetic ctids.  Vector entries
+ * for columns outside the scan's projection are NULL.
+ *
+ * Datums in the vectors point into the datum streams' current block
+ * buffers and stay valid only until the next batch is read from the
+ * same scan.
+ */
+typedef struct AOCSBatchData
+{
+	int			natts;			/* length of the values / nulls arrays */
+	int			maxRows;		/* capacity of the per-column vectors */
+	int			numRows;		/* rows currently in the batch */
+	int			curRow;			/* next row to drain (used by aocs_getnext) */
+
+	Datum	  **values;			/* per-column datum vectors [natts][maxRows] */
+	bool	  **nulls;
+	bool	   *visible;		/* per-row visibility under the scan snapshot */
+	ItemPointerData *ctids;		/* per-row synthetic ctids */
+} AOCSBatchData;
+
+typedef AOCSBatchData *AOCSBatch;
+
 /*
  * used for scan of append only relations using BufferedRead and VarBlocks
  */
@@ -126,6 +151,12 @@ typedef struct AOCSScanDescData
 
 	AppendOnlyVisimap visibilityMap;
 
+	/*
+	 * When gp_enable_aocs_batch_read is on, rows are bulk-read into this
+	 * batch and aocs_getnext drains it one tuple at a time.
+	 */
+	AOCSBatch	batch;
+
 }	AOCSScanDescData;
 
 typedef AOCSScanDescData *AOCSScanDesc;
@@ -212,6 +243,10 @@ extern void aocs_rescan(AOCSScanDesc scan);
 extern void aocs_endscan(AOCSScanDesc scan);
 
 extern void aocs_getnext(AOCSScanDesc scan, ScanDirection direction, TupleTableSlot *slot);
+extern AOCSBatch aocs_batch_init(AOCSScanDesc scan, int maxRows);
+extern void aocs_batch_finish(AOCSBatch batch);
+extern bool aocs_getnext_batch(AOCSScanDesc scan, ScanDirection direction,
+				   AOCSBatch batch);
 extern AOCSInsertDesc aocs_insert_init(Relation rel, int segno, bool update_mode);
 extern Oid aocs_insert_values(AOCSInsertDesc idesc, Datum *d, bool *null, AOTupleId *aoTupleId);
 static inline Oid aocs_insert(AOCSInsertDesc idesc, TupleTableSlot *slot)
@@ -108,6 +108,19 @@ typedef struct AppendOnlyInsertDescData
 	/* The block directory for the appendonly relation. */
 	AppendOnlyBlockDirectory blockDirectory;
 
+	/*
+	 * Zone map collection state for the current varblock. When
+	 * zoneMapCollect is set, the running min/max (encoded as int64) of the
+	 * leading column is maintained as tuples are added and published to
+	 * the block directory when the varblock is finished.
+	 */
+	bool			zoneMapCollect;
+	Oid				zoneMapTypid;
+	bool			blockZoneValid;
+	bool			blockZoneHasNulls;
+	int64			blockZoneMin;
+	int64			blockZoneMax;
+
 	bool update_mode;
 } AppendOnlyInsertDescData;
 
@@ -219,9 +232,17 @@ typedef struct AppendOnlyScanDescData
 	/**
 	 * The visibility map is used during scans
 	 * to check tuple visibility using visi map.
-	 */ 
+	 */
 	AppendOnlyVisimap visibilityMap;
 
+	/*
+	 * Block directory opened for zone map lookups, or NULL when the scan
+	 * has no scan keys on the leading column or the relation has no block
+	 * directory. Used to skip varblocks whose min/max exclude all keys.
+	 */
+	AppendOnlyBlockDirectory *zoneMapDirectory;
+	Oid			zoneMapTypid;
+
 }	AppendOnlyScanDescData;
 
 typedef AppendOnlyScanDescData *AppendOnlyScanDesc;
@@ -326,6 +347,7 @@ typedef struct AppendOnlyDeleteDescData *AppendOnlyDeleteDesc;
  * ----------------
  */
 
+extern bool AppendOnlyZoneMap_TypeEligible(Oid typid);
 extern AppendOnlyScanDesc appendonly_beginscan(Relation relation,
 											   Snapshot snapshot,
 											   Snapshot appendOnlyMetaDataSnapshot,
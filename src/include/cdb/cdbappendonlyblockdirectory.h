@@ -36,6 +36,17 @@ typedef struct AppendOnlyBlockDirectoryEntry
 		int64		lastRowNum;
 	} range;
 
+	/*
+	 * Zone map for the covered range: min/max of the leading column,
+	 * encoded as an order-preserving int64. Only meaningful when
+	 * zoneMapValid is true; entries written by code paths that do not
+	 * collect column values simply leave it invalid.
+	 */
+	bool		zoneMapValid;
+	bool		zoneMapHasNulls;
+	int64		zoneMapMin;
+	int64		zoneMapMax;
+
 } AppendOnlyBlockDirectoryEntry;
 
 /*
@@ -48,6 +59,29 @@ typedef struct MinipageEntry
 	int64 rowCount;
 } MinipageEntry;
 
+/*
+ * The per-entry zone map, stored as a parallel array after the entry
+ * array when the minipage is written with MINIPAGE_VERSION_ZONEMAP.
+ * Values are the leading column's min/max, encoded as int64.
+ */
+typedef struct MinipageZoneMapEntry
+{
+	int64 zoneMin;
+	int64 zoneMax;
+	int64 flags;
+} MinipageZoneMapEntry;
+
+#define MINIPAGE_ZONEMAP_VALID			0x1
+#define MINIPAGE_ZONEMAP_HASNULLS		0x2
+
+/*
+ * Minipage versions. Version 0 minipages carry the entry array only;
+ * MINIPAGE_VERSION_ZONEMAP adds a MinipageZoneMapEntry array of the
+ * same cardinality after the entries.
+ */
+#define MINIPAGE_VERSION_BASE			0
+#define MINIPAGE_VERSION_ZONEMAP		1
+
 /*
  * Define a varlena type for a minipage.
  */
@@ -57,7 +91,7 @@ typedef struct Minipage
 	int32 _len;
 	int32 version;
 	uint32 nEntry;
-	
+
 	/* Varlena array */
 	MinipageEntry entry[1];
 } Minipage;
@@ -71,8 +105,40 @@ typedef struct MinipagePerColumnGroup
 	Minipage *minipage;
 	uint32 numMinipageEntries;
 	ItemPointerData tupleTid;
+
+	/*
+	 * Zone map entries parallel to minipage->entry. Kept outside the
+	 * varlena while in memory; serialized after the entry array when
+	 * the minipage is written out.
+	 */
+	MinipageZoneMapEntry *zoneMapEntries;
+
+	/*
+	 * Segment file the minipage was decoded from, and its file segment
+	 * info (used to clamp ranges to the segment file EOF). Set by
+	 * extract_minipage(); -1/NULL until a minipage has been loaded.
+	 */
+	int segmentFileNum;
+	FileSegInfo *segmentFileInfo;
 } MinipagePerColumnGroup;
 
+/*
+ * A slot in the cache of recently decoded minipages that a search-mode
+ * block directory keeps. The cached minipage is keyed by
+ * (minipageInfo.segmentFileNum, columnGroupNo); a slot with
+ * numMinipageEntries == 0 is free.
+ */
+typedef struct MinipageCacheSlot
+{
+	/* Column group the cached minipage belongs to. */
+	int columnGroupNo;
+
+	/* For choosing the least recently used slot to evict. */
+	uint64 lastUseCount;
+
+	MinipagePerColumnGroup minipageInfo;
+} MinipageCacheSlot;
+
 /*
  * I don't know the ideal value here. But let us put approximate
  * 8 minipages per heap page.
@@ -109,6 +175,18 @@ typedef struct AppendOnlyBlockDirectory
 	 */
 	MinipagePerColumnGroup *minipages;
 
+	/*
+	 * Cache of recently used minipages, consulted by
+	 * AppendOnlyBlockDirectory_GetEntry() before probing the block
+	 * directory btree, so that index- and bitmap-driven fetches whose
+	 * TIDs move back and forth between directory ranges do not decode
+	 * the same minipage over and over. Only allocated for search-mode
+	 * block directories.
+	 */
+	MinipageCacheSlot *minipageCache;
+	int numMinipageCacheSlots;
+	uint64 minipageCacheUseCount;
+
 	/*
 	 * Some temporary space to help form tuples to be inserted into
 	 * the block directory, and to help the index scan.
@@ -199,6 +277,13 @@ extern bool AppendOnlyBlockDirectory_InsertEntry(
 	int64 fileOffset,
 	int64 rowCount,
 	bool addColAction);
+extern void AppendOnlyBlockDirectory_SetLastEntryZoneMap(
+	AppendOnlyBlockDirectory *blockDirectory,
+	int columnGroupNo,
+	int64 firstRowNum,
+	int64 zoneMin,
+	int64 zoneMax,
+	bool hasNulls);
 extern bool AppendOnlyBlockDirectory_addCol_InsertEntry(
 	AppendOnlyBlockDirectory *blockDirectory,
 	int columnGroupNo,
@@ -75,6 +75,12 @@ typedef struct BufferedAppend
     char				 *filePathName;
     int64                fileLen;
     int64				 fileLen_uncompressed; /* for calculating compress ratio */
+    int64				 fileAllocatedLen;
+							/*
+							 * How far the file has been preallocated with
+							 * FileAllocate.  Always >= fileLen; the excess
+							 * is truncated away when the file is completed.
+							 */
 
 } BufferedAppend;
 
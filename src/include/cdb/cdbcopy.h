@@ -59,6 +59,13 @@ typedef struct CdbCopy
 	List		  *ao_segnos;
 	HTAB		  *aotupcounts; /* hash of ao relation id to processed tuple count */
 	bool		hasReplicatedTable;
+
+	/*
+	 * Asynchronous fan-out state for COPY FROM: per-segment accounting of
+	 * data handed to libpq and of backpressure stalls, indexed by segindex.
+	 */
+	uint64		   *seg_bytes_sent;
+	uint64		   *seg_backpressure_waits;
 } CdbCopy;
 
 
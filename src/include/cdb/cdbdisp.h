@@ -39,7 +39,9 @@ typedef struct CdbDispatchDirectDesc
 {
 	bool directed_dispatch;
 	uint16 count;
-	uint16 content[1];
+	uint16 content[1];			/* variable length, 'count' entries; allocate
+								 * with offsetof(CdbDispatchDirectDesc,
+								 * content) + count * sizeof(uint16) */
 } CdbDispatchDirectDesc;
 
 extern CdbDispatchDirectDesc default_dispatch_direct_desc;
@@ -45,6 +45,20 @@ CdbDispatchDtxProtocolCommand(DtxProtocolCommand dtxProtocolCommand,
 							  char *argument, int argumentLength );
 
 
+/*
+ * CdbDispatchDtxProtocolCommandPipelined:
+ * Sends the same non-cancelable DTX protocol command for several gids to
+ * every segment db in one network round trip: all messages are queued on
+ * each connection before any response is read, and the responses are then
+ * matched in send order.  Returns true iff every command succeeded on
+ * every segment.
+ */
+bool
+CdbDispatchDtxProtocolCommandPipelined(DtxProtocolCommand dtxProtocolCommand,
+									   char *dtxProtocolCommandLoggingStr,
+									   char **gids,
+									   int ngids);
+
 /*
  * used to take the current Transaction Snapshot and serialized a version of it
  * into the static variable serializedDtxContextInfo
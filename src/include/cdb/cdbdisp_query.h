@@ -16,10 +16,28 @@
 #define CDBDISP_QUERY_H
 
 #include "lib/stringinfo.h" /* StringInfo */
+#include "cdb/cdbdispatchresult.h"	/* CdbDispatchResultConsumer */
 #include "cdb/cdbtm.h"
 
 #define DF_NONE 0x0
 
+/*
+ * Flag bits in the 'flags' word of the dispatched query message, used by the
+ * cached plan dispatch protocol (see buildGpQueryString): STORE tells the QE
+ * to remember the serialized plan tree in this message under the plan hash
+ * that accompanies it; USE tells the QE that the plan tree was omitted and
+ * must be taken from its cache instead.
+ */
+#define MPP_QUERY_FLAG_PLAN_CACHE_STORE 0x1
+#define MPP_QUERY_FLAG_PLAN_CACHE_USE	0x2
+
+/*
+ * Number of serialized plans kept cached on each QE of the writer gang.
+ * The QD keeps a mirror of the same size and both sides evict in the same
+ * FIFO order, so they always agree on the cache contents.
+ */
+#define CACHED_PLAN_DISPATCH_SLOTS 16
+
 /*
  * indicate whether an error occurring on one of the qExec segdbs should cause all still-executing
  * commands to cancel on other qExecs, normally this would be true.
@@ -84,6 +102,21 @@ CdbDispatchCommand(const char* strCommand,
                     int flags,
                     struct CdbPgResults* cdb_pgresults);
 
+/*
+ * CdbDispatchCommandConsume
+ *
+ * Like CdbDispatchCommand, but streams the PGresults: each one is handed
+ * to 'consumer' as the results are drained and freed as soon as the
+ * callback returns, so the whole result set is never held in memory at
+ * once.  Use for commands that can return a lot of data per QE when the
+ * caller only needs a single pass over the results.
+ */
+void
+CdbDispatchCommandConsume(const char *strCommand,
+						  int flags,
+						  CdbDispatchResultConsumer consumer,
+						  void *context);
+
 /*
  * CdbDispatchUtilityStatement
  *
@@ -109,4 +142,13 @@ CdbDispatchUtilityStatement(struct Node *stmt,
 
 extern ParamListInfo deserializeParamListInfo(const char *str, int slen);
 
+/* GUC */
+extern bool gp_cached_plan_dispatch;
+
+/*
+ * Forget which plans the writer gang QEs have cached; must be called
+ * whenever the writer gang is destroyed or created anew.
+ */
+extern void cdbdisp_invalidateCachedPlans(void);
+
 #endif   /* CDBDISP_QUERY_H */
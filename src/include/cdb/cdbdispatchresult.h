@@ -321,6 +321,28 @@ cdbdisp_resultEnd(CdbDispatchResults *results, int sliceIndex);
 void
 cdbdisp_returnResults(CdbDispatchResults *primaryResults, CdbPgResults *cdb_pgresults);
 
+/*
+ * Callback invoked by cdbdisp_consumeResults() once per PGresult.
+ * The PGresult is owned by the iterator and is PQclear()ed as soon as
+ * the callback returns; the callback must not free it or keep a ptr
+ * to it.  segdbDesc identifies the QE that produced the result.
+ */
+typedef void (*CdbDispatchResultConsumer) (struct pg_result *res,
+										   struct SegmentDatabaseDescriptor *segdbDesc,
+										   void *context);
+
+/*
+ * Hand each PGresult held in a CdbDispatchResults object to 'consumer'
+ * and free it immediately afterwards, one QE at a time, instead of
+ * materializing the whole result set in one big array as
+ * cdbdisp_returnResults() does.  Peak memory on the consumption side
+ * is one QE's results rather than the cluster total.
+ */
+void
+cdbdisp_consumeResults(CdbDispatchResults *primaryResults,
+					   CdbDispatchResultConsumer consumer,
+					   void *context);
+
 /*
  * used in the interconnect on the dispatcher to avoid error-cleanup deadlocks.
  */
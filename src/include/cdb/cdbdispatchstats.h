@@ -0,0 +1,77 @@
+/*-------------------------------------------------------------------------
+ *
+ * cdbdispatchstats.h
+ *	  Per-backend dispatch latency statistics kept in shared memory.
+ *
+ * Portions Copyright (c) 2012-Present Pivotal Software, Inc.
+ *
+ *
+ * IDENTIFICATION
+ *	    src/include/cdb/cdbdispatchstats.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef CDBDISPATCHSTATS_H
+#define CDBDISPATCHSTATS_H
+
+/*
+ * The phases of one dispatch that we time separately:
+ *
+ * SERIALIZE	building the query text (plan/snapshot serialization),
+ * ENQUEUE		queueing the query text onto the gang's libpq connections,
+ * FIRST_RESULT	from enqueue start until the first result bytes arrive
+ *				from any QE,
+ * ACK			from enqueue start until an individual QE completes; this
+ *				phase gets one sample per QE, so its histogram shows the
+ *				spread across segments and exposes stragglers.
+ */
+typedef enum GpDispatchStatsPhase
+{
+	GP_DISPATCH_PHASE_SERIALIZE = 0,
+	GP_DISPATCH_PHASE_ENQUEUE,
+	GP_DISPATCH_PHASE_FIRST_RESULT,
+	GP_DISPATCH_PHASE_ACK,
+
+	GP_DISPATCH_PHASE_COUNT		/* must be last */
+} GpDispatchStatsPhase;
+
+/*
+ * Latency histogram buckets, in microseconds: each bucket covers 4x the
+ * previous one, starting below 256us.  With 8 buckets the last one is a
+ * catch-all for >= 1 second.
+ */
+#define GP_DISPATCH_STATS_NBUCKETS 8
+
+typedef struct GpDispatchPhaseStats
+{
+	uint64		samples;
+	uint64		total_us;
+	uint64		max_us;
+	uint64		hist[GP_DISPATCH_STATS_NBUCKETS];
+} GpDispatchPhaseStats;
+
+/*
+ * One slot per backend, indexed by MyBackendId - 1.  The owning backend is
+ * the only writer; readers (the gp_dispatch_stats view) read without
+ * locking and may see values mid-update, which is acceptable for
+ * monitoring data.
+ */
+typedef struct GpDispatchStatsEntry
+{
+	int			sessionId;		/* 0 if this slot was never used */
+	uint64		nDispatches;	/* number of gang dispatches */
+	GpDispatchPhaseStats phases[GP_DISPATCH_PHASE_COUNT];
+
+	/* slowest per-QE ack seen so far, and which content it came from */
+	int			stragglerContent;
+	uint64		stragglerUs;
+} GpDispatchStatsEntry;
+
+extern Size DispatchStatsShmemSize(void);
+extern void DispatchStatsShmemInit(void);
+
+extern void cdbdisp_stats_countDispatch(void);
+extern void cdbdisp_stats_addSample(GpDispatchStatsPhase phase, uint64 us);
+extern void cdbdisp_stats_addAck(int contentId, uint64 us);
+
+#endif   /* CDBDISPATCHSTATS_H */
@@ -25,6 +25,7 @@ struct QueryDesc;                       /* #include "executor/execdesc.h" */
 struct StringInfoData;                  /* #include "lib/stringinfo.h" */
 
 struct CdbExplain_ShowStatCtx;          /* private, in "cdb/cdbexplain.c" */
+struct ExplainState;                    /* #include "commands/explain.h" */
 struct PlannedStmt;
 
 static inline void
@@ -120,6 +121,18 @@ struct CdbExplain_ShowStatCtx *
 cdbexplain_showExecStatsBegin(struct QueryDesc *queryDesc,
                               instr_time        querystarttime);
 
+/*
+ * cdbexplain_showExecStatsEnd
+ *    Called by qDisp process to format its slice and whole-query statistics
+ *    into the caller's ExplainState output buffer after the per-node stats
+ *    have been collected with cdbexplain_recvExecStats().
+ */
+void
+cdbexplain_showExecStatsEnd(struct PlannedStmt            *stmt,
+                            struct CdbExplain_ShowStatCtx *showstatctx,
+                            struct EState                 *estate,
+                            struct ExplainState           *es);
+
 
 
 #endif   /* CDBEXPLAIN_H */
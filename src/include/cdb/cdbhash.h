@@ -21,7 +21,8 @@
 typedef enum
 {
 	HASH_FNV_1 = 1,
-	HASH_FNV_1A
+	HASH_FNV_1A,
+	HASH_CRC32C					/* CRC-32C, hardware accelerated on SSE4.2 */
 } CdbHashAlg;
 
 /*
@@ -42,6 +43,7 @@ typedef struct CdbHash
 	int			numsegs;		/* number of segments in Greenplum Database used for
 								 * partitioning  */
 	CdbHashReduce reducealg;	/* the algorithm used for reducing to buckets		*/
+	CdbHashAlg	hashalg;		/* the hash family used for the datums				*/
 	uint32		rrindex;		/* round robin index for empty policy tables		*/
 
 } CdbHash;
@@ -55,8 +57,13 @@ extern void hashNullDatum(datumHashFunction hashFn, void *clientData);
 /*
  * Create and initialize a CdbHash in the current memory context.
  * Parameter numsegs - number of segments in Greenplum Database.
+ *
+ * makeCdbHash() uses the legacy FNV-1 family, which determines the
+ * placement of all existing hash-distributed data; makeCdbHashAlg()
+ * lets callers whose hashes never hit disk pick a different family.
  */
 extern CdbHash *makeCdbHash(int numsegs);
+extern CdbHash *makeCdbHashAlg(int numsegs, CdbHashAlg alg);
 
 /*
  * Initialize CdbHash for hashing the next tuple values.
@@ -83,6 +90,19 @@ extern void cdbhashnokey(CdbHash *h);
  */
 extern unsigned int cdbhashreduce(CdbHash *h);
 
+/*
+ * Batched variants: fold one column of values at a time into an array of
+ * per-tuple hash accumulators, so the per-datum type dispatch is hoisted
+ * out of the inner loop.  Initialize the accumulators with
+ * cdbhashbatchinit(), fold each hash-key column in with cdbhashbatch(),
+ * then turn them into segment numbers with cdbhashbatchreduce().
+ */
+extern void cdbhashbatchinit(CdbHash *h, int ntuples, uint32 *hashes);
+extern void cdbhashbatch(CdbHash *h, Oid type, int ntuples,
+			 const Datum *values, const bool *nulls, uint32 *hashes);
+extern void cdbhashbatchreduce(CdbHash *h, int ntuples,
+				   const uint32 *hashes, unsigned int *segs);
+
 /*
  * Return true if Oid is hashable internally in Greenplum Database.
  */
@@ -317,6 +317,12 @@ typedef struct ChunkTransportStateEntry
 	/* highest file descriptor in the readSet. */
 	int			highReadSock;
 
+	/*
+	 * epoll instance mirroring readSet on Linux (TCP interconnect only).
+	 * -1 = not yet created, -2 = unavailable, use select() instead.
+	 */
+	int			epollFd;
+
     int         scanStart;
 
     /* slice table entries */
@@ -386,6 +392,18 @@ typedef struct ChunkSorterEntry
 }	ChunkSorterEntry;
 
 /* This is the entry data-structure for a motion node. */
+/*
+ * A sender-side micro-batch of serialized tuple chunks bound for one
+ * route.  The chunks are spliced onto the list as tuples are serialized
+ * and handed to the transport in one SendTupleChunkToAMS() call when the
+ * batch fills up or an explicit flush is requested.
+ */
+typedef struct MotionRouteBatch
+{
+	TupleChunkListData list;
+	int             ntuples;
+}	MotionRouteBatch;
+
 typedef struct MotionNodeEntry
 {
 	/*
@@ -461,6 +479,14 @@ typedef struct MotionNodeEntry
 	uint64          sel_wr_wait;            /* Total time spent (usec) in select wait trying to write */
 
 	uint64			memKB;	/* How much memory should this motion node use? */
+
+	/*
+	 * Sender-side per-route micro-batches of serialized tuple chunks; only
+	 * allocated (lazily) when gp_motion_batch_size > 0.  The last slot is
+	 * used for broadcast sends.
+	 */
+	MotionRouteBatch *route_batches;
+	int             nroute_batches;
 }       MotionNodeEntry;
 
 
@@ -527,6 +553,7 @@ typedef struct ChunkTransportState
 
 	/* Function pointers to our send/receive functions */
 	bool (*SendChunk)(MotionLayerState *mlStates, struct ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, MotionConn *conn, TupleChunkListItem tcItem, int16 motionId);
+	bool (*FlushBuffer)(MotionLayerState *mlStates, struct ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, MotionConn *conn, int16 motionId);
 	TupleChunkListItem (*RecvTupleChunkFrom)(struct ChunkTransportState *transportStates, int16 motNodeID, int16 srcRoute);
 	TupleChunkListItem (*RecvTupleChunkFromAny)(MotionLayerState *mlStates, struct ChunkTransportState *transportStates, int16 motNodeID, int16 *srcRoute);
 	void (*doSendStopMessage)(struct ChunkTransportState *transportStates, int16 motNodeID);
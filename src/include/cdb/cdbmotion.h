@@ -109,6 +109,15 @@ extern SendReturnCode SendTuple(MotionLayerState *mlStates,
 								int16 targetRoute);
 
 
+/* Flush any tuple chunks still sitting in per-route micro-batches for the
+ * given motion node.  A no-op when gp_motion_batch_size is 0 or nothing is
+ * pending.
+ */
+void
+FlushTupleBatches(MotionLayerState      *mlStates,
+                  ChunkTransportState   *transportStates,
+                  int16                  motNodeID);
+
 /* Send or broadcast an END_OF_STREAM token to the corresponding motion-node
  * on other segments.
  */
@@ -44,11 +44,34 @@ typedef struct PartitionRangeState
 	PartitionRule **rules;
 } PartitionRangeState;
 
+/*
+ * One entry of the single-column list partition lookup table: a list value,
+ * its hash, and the rule it selects.  The array is sorted by hashval so a
+ * probe is a binary search plus an equality check per hash collision.
+ */
+typedef struct PartitionListLookupEntry
+{
+	uint32		hashval;
+	Datum		value;
+	struct PartitionRule *rule;
+} PartitionListLookupEntry;
+
 /* likewise, for list */
 typedef struct PartitionListState
 {
 	FmgrInfo *eqfuncs;
 	bool *eqinit;
+
+	/*
+	 * Fast lookup for single-column list partitions, built once per scan by
+	 * buildListPartitionLookup(); NULL when the partition does not qualify
+	 * (multi-column key, cross-type comparison, or no hash function).
+	 */
+	PartitionListLookupEntry *lookup;	/* sorted by hashval */
+	int			nlookup;
+	FmgrInfo	lookup_hashfunc;
+	struct PartitionRule *lookup_nullrule;	/* rule keyed by NULL, if any */
+	bool		lookup_tried;
 } PartitionListState;
 
 /* likewise, for hash */
@@ -118,6 +141,9 @@ all_partition_relids(PartitionNode *pn);
 extern Node *
 get_relation_part_constraints(Oid rootOid, List **defaultLevels);
 
+extern List *
+get_relation_part_defaults(Oid rootOid);
+
 extern List *
 all_prule_relids(PartitionRule *prule);
 
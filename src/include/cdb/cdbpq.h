@@ -13,4 +13,15 @@ extern int PQsendGpQuery_shared(PGconn       *conn,
 								 int          query_len,
 								 pqbool         nonblock);
 
+/*
+ * Pipelined sending of DTX protocol messages: several preformatted 'T'
+ * messages may be queued on a connection before any response is consumed;
+ * responses are matched in send order.
+ */
+extern int PQsendGpDtxProtocolPipelined(PGconn *conn,
+										const char *dtx_command,
+										int command_len);
+
+extern void PQgpRearmForPipelinedResult(PGconn *conn);
+
 #endif
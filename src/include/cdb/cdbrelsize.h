@@ -17,6 +17,12 @@
 
 #include "utils/relcache.h"
 
+extern int	gp_relsize_cache_timeout;
+
+extern Size CdbRelSizeCacheShmemSize(void);
+extern void CdbRelSizeCacheShmemInit(void);
+
 extern int64 cdbRelMaxSegSize(Relation rel);
+extern int64 cdbRelMaxSegSizeCached(Relation rel);
 
 #endif /* CDBRELSIZE_H_ */
@@ -0,0 +1,49 @@
+/*-------------------------------------------------------------------------
+ *
+ * cdbresusage.h
+ *	  Per-query CPU and I/O accounting kept in shared memory.
+ *
+ * Portions Copyright (c) 2012-Present Pivotal Software, Inc.
+ *
+ *
+ * IDENTIFICATION
+ *	    src/include/cdb/cdbresusage.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef CDBRESUSAGE_H
+#define CDBRESUSAGE_H
+
+#include "utils/timestamp.h"
+
+/*
+ * Number of finished-query entries each segment retains.  The ring is
+ * overwritten oldest-first, so this bounds how far back in time
+ * gp_query_resource_usage() can see on a busy segment.
+ */
+#define GP_RESUSAGE_RING_SIZE 1024
+
+/*
+ * One finished (outermost) executor run.  sessionId is 0 in slots that
+ * were never written.
+ */
+typedef struct GpResUsageEntry
+{
+	int32		sessionId;		/* gp_session_id of the query */
+	int32		commandCount;	/* gp_command_count of the query */
+	TimestampTz endTime;		/* when the executor shut down */
+	int64		elapsedUs;		/* wall clock, executor start to end */
+	int64		cpuUserUs;		/* user CPU consumed by this backend */
+	int64		cpuSysUs;		/* system CPU consumed by this backend */
+	int64		readBytes;		/* block input, from ru_inblock */
+	int64		writeBytes;		/* block output, from ru_oublock */
+	int64		spillBytes;		/* workfile bytes held at executor end */
+} GpResUsageEntry;
+
+extern Size ResUsageShmemSize(void);
+extern void ResUsageShmemInit(void);
+
+extern void ResUsageQueryStart(void);
+extern void ResUsageQueryEnd(void);
+
+#endif   /* CDBRESUSAGE_H */
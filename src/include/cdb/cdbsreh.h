@@ -18,6 +18,7 @@
 
 #include "fmgr.h"
 #include "cdb/cdbcopy.h"
+#include "lib/stringinfo.h"
 #include "utils/memutils.h"
 
 
@@ -84,6 +85,8 @@ typedef struct CdbSreh
 
 	bool	log_to_file;		/* or log into file? */
 	Oid		relid;				/* parent relation id */
+
+	StringInfoData logbuf;		/* error log records buffered for bulk append */
 } CdbSreh;
 
 extern int gp_initial_bad_row_limit;
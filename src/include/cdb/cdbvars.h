@@ -135,6 +135,10 @@ extern bool gp_reraise_signal; /* try to force a core dump ?*/
 
 extern bool gp_set_proc_affinity; /* try to bind postmaster to a processor */
 
+extern bool gp_numa_interleave_shared_memory; /* interleave shmem across NUMA nodes */
+
+extern bool gp_numa_backend_affinity; /* bind backends to a NUMA node */
+
 /* Parameter Gp_is_writer
  *
  * This run_time parameter indicates whether session is a qExec that is a
@@ -163,6 +167,13 @@ extern int qdPostmasterPort;
 /*How many gangs to keep around from stmt to stmt.*/
 extern int			gp_cached_gang_threshold;
 
+/*
+ * Pre-create the primary writer gang when a dispatcher session becomes
+ * idle for the first time, instead of on first dispatch, so the first
+ * query does not pay segment connection setup.
+ */
+extern bool			gp_eager_writer_gang;
+
 /*
  * gp_reject_percent_threshold
  *
@@ -262,6 +273,20 @@ extern bool gp_external_enable_exec;
  */
 extern int gp_external_max_segs;
 
+/*
+ * gp_external_chain_urls
+ *
+ * When set to 'true' each segment scanning a gpfdist (or gpfdists)
+ * external table moves on to the next LOCATION URI after draining its
+ * own, instead of finishing. gpfdist hands out data blocks to whichever
+ * segments are currently asking, so segments that were assigned a small
+ * URI join the sessions of the busier ones and completion times level
+ * out regardless of how the data is laid out across the URIs. Default
+ * is 'false' since the extra connections are wasted effort when the
+ * locations are evenly sized.
+ */
+extern bool gp_external_chain_urls;
+
 /*
  * gp_command_count
  *
@@ -348,6 +373,7 @@ extern int gp_fts_mark_mirror_down_grace_period;
 
 extern int gp_gang_creation_retry_count; /* How many retries ? */
 extern int gp_gang_creation_retry_timer; /* How long between retries */
+extern int gp_gang_max_parallel_connects; /* Connect attempts in flight at once */
 
 /*
  * Parameter Gp_max_packet_size
@@ -448,6 +474,40 @@ extern bool gp_interconnect_aggressive_retry; /* fast-track app-level retry */
  */
 extern bool gp_interconnect_full_crc;
 
+/*
+ * Parameter gp_interconnect_busy_poll_us
+ *
+ * Upper bound (in microseconds) of the adaptive busy-poll window the
+ * UDP interconnect receive thread spins on its socket after traffic,
+ * before falling back to sleeping in poll().  Zero disables spinning.
+ */
+extern int	gp_interconnect_busy_poll_us;
+
+/*
+ * Parameter gp_motion_batch_size
+ *
+ * Number of tuples the motion sender accumulates per destination route
+ * before handing the batched chunk list to the interconnect in a single
+ * call.  Zero (the default) sends each tuple's chunks immediately.
+ */
+extern int	gp_motion_batch_size;
+
+/*
+ * Parameter gp_interconnect_compress_chunks
+ *
+ * Compress serialized tuple chunk lists before transmission, trading
+ * sender/receiver CPU for interconnect bandwidth on motion-bound plans.
+ */
+extern bool gp_interconnect_compress_chunks;
+
+/*
+ * Parameter gp_interconnect_compress_threshold
+ *
+ * Minimum serialized size (in bytes) of a chunk list before we attempt
+ * to compress it; smaller lists are not worth the CPU.
+ */
+extern int	gp_interconnect_compress_threshold;
+
 /*
  * Parameter gp_interconnect_log_stats
  *
@@ -613,6 +673,15 @@ extern bool gp_adjust_selectivity_for_outerjoins;
 extern int gp_hashjoin_tuples_per_bucket;
 extern int gp_hashagg_groups_per_bucket;
 
+/* Write staging size (KB) per hash join batch spill file; 0 = write through */
+extern int gp_hashjoin_spill_batch_size;
+
+/*
+ * Probe-side Bloom filter for hash joins whose unmatched outer tuples
+ * produce no output.
+ */
+extern bool gp_hashjoin_bloom_filter;
+
 /*
  * Damping of selectivities of clauses which pertain to the same base
  * relation; compensates for undetected correlation
@@ -638,6 +707,18 @@ extern bool gp_selectivity_damping_sigsort;
 
 /* ----- Experimental Features ----- */
 
+/*
+ * "gp_enable_block_nestloop"
+ *
+ * May the executor run a nested loop join in block mode, buffering a batch
+ * of outer tuples and probing them all with a single pass over the inner
+ * plan?  Only engaged when the inner subtree does not reference the current
+ * outer tuple, so rescanning it once per outer tuple is pure overhead.
+ * Note that block mode emits join results in inner-major order within each
+ * batch rather than preserving the outer ordering.
+ */
+extern bool gp_enable_block_nestloop;
+
 /*
  * "gp_enable_agg_distinct"
  *
@@ -763,6 +844,30 @@ extern bool gp_enable_sort_distinct;
 extern bool gp_enable_mk_sort;
 extern bool gp_enable_motion_mk_sort;
 
+/* Worker threads for sorting in-memory runs in mk sort; 0/1 = off */
+extern int	gp_mk_sort_threads;
+
+/* Loser-tree merge for eligible reader-backed mk merges */
+extern bool gp_enable_mk_loser_tree;
+
+/* Prune never-referenced columns when materializing tuples (nodeMaterial.c) */
+extern bool gp_enable_material_pruning;
+
+/* Radix sort for single fixed-width integer sort keys (tuplesort_mkqsort.c) */
+extern bool gp_enable_mk_radix_sort;
+
+/* Per-varblock min/max zone maps for append-only scans (appendonlyam.c) */
+extern bool gp_enable_ao_zonemaps;
+
+/* Per-column row batches for append-only columnar scans (aocsam.c) */
+extern bool gp_enable_aocs_batch_read;
+
+/* Flat bytecode programs for expression evaluation (execQual.c) */
+extern bool gp_enable_expr_bytecode;
+
+/* Runtime qual reordering in ExecScan (execScan.c) */
+extern bool gp_enable_adaptive_quals;
+
 #ifdef USE_ASSERT_CHECKING
 extern bool gp_mk_sort_check;
 #endif
@@ -835,8 +940,11 @@ extern bool gpvars_assign_gp_enable_gpperfmon(bool newval, bool doit, GucSource
 extern bool gpvars_assign_gp_gpperfmon_send_interval(int newval, bool doit, GucSource source);
 extern bool gp_enable_gpperfmon;
 extern int gp_gpperfmon_send_interval;
+extern int gp_gpperfmon_queue_size;
 extern bool gp_enable_query_metrics;
 extern int gp_instrument_shmem_size;
+extern bool gp_instrument_rdtsc;
+extern int gp_instrument_timing_interval;
 extern bool force_bitmap_table_scan;
 
 extern bool dml_ignore_target_partition_check;
@@ -855,6 +963,15 @@ extern int gpperfmon_log_alert_level;
 
 extern int gp_workfile_compress_algorithm;
 extern bool gp_workfile_checksumming;
+/* Cross-query reuse of published workfile sets, keyed by plan fingerprint */
+extern bool gp_workfile_caching;
+extern bool gp_workfile_mmap_read;
+extern bool gp_shareinput_shmem_sync;
+
+/* Blocks of read-ahead to advise per logical tape during merge; 0 = off */
+extern int gp_logtape_prefetch_blocks;
+/* Spill file size (KB) beyond which written data is dropped from the page cache; 0 = off */
+extern int gp_workfile_discard_threshold;
 extern double gp_workfile_limit_per_segment;
 extern double gp_workfile_limit_per_query;
 extern int gp_workfile_limit_files_per_query;
@@ -885,6 +1002,7 @@ typedef enum
 extern int	gp_autostats_mode;
 extern int	gp_autostats_mode_in_functions;
 extern int	gp_autostats_on_change_threshold;
+extern bool	gp_autostats_incremental;
 extern bool	log_autostats;
 
 
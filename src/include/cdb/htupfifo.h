@@ -23,16 +23,25 @@
 
 #include "access/htup.h"
 
-/* An entry in the HeapTuple FIFO.	Entries are formed into queues. */
-typedef struct htf_entry_data
+/* Number of tuple pointers held by one FIFO chunk. */
+#define HTF_CHUNK_CAPACITY 64
+
+/*
+ * A chunk of the HeapTuple FIFO.  Chunks are arrays of tuple pointers,
+ * linked into a list; the FIFO consumes from the front of the first chunk
+ * and appends at the end of the last one.  This keeps the per-tuple cost
+ * down to a couple of array-index operations, instead of a list-entry
+ * allocation and a pointer chase per tuple.
+ */
+typedef struct htf_chunk_data
 {
-	/* The tuple itself. */
-	GenericTuple tup;
+	/* The next chunk in the FIFO. */
+	struct htf_chunk_data *p_next;
 
-	/* The next entry in the FIFO. */
-	struct htf_entry_data *p_next;
+	/* The tuples themselves. */
+	GenericTuple tups[HTF_CHUNK_CAPACITY];
 
-}	htf_entry_data, *htf_entry;
+}	htf_chunk_data, *htf_chunk;
 
 
 /* A HeapTuple FIFO.  The FIFO is dynamically sizable, since there is no
@@ -40,11 +49,14 @@ typedef struct htf_entry_data
  */
 typedef struct htup_fifo_state
 {
-	htf_entry	p_first;
-	htf_entry	p_last;
+	htf_chunk	head;			/* chunk we consume from */
+	htf_chunk	tail;			/* chunk we append to */
+
+	int			head_pos;		/* next slot to read in head chunk */
+	int			tail_pos;		/* next free slot in tail chunk */
 
-	htf_entry	freelist;
-	int			freelist_count;
+	/* One empty chunk kept around for reuse, to avoid palloc traffic. */
+	htf_chunk	spare;
 
 	/* A count of HeapTuples in the FIFO. */
 	int			tup_count;
@@ -14,6 +14,8 @@
 #ifndef ML_IPC_H
 #define ML_IPC_H
 
+#include "fmgr.h"
+
 #include "cdb/cdbselect.h"
 #include "cdb/cdbinterconnect.h"
 #include "cdb/cdbmotion.h"
@@ -272,6 +274,15 @@ extern void putTransportDirectBuffer(ChunkTransportState *transportStates,
 									 int16 motNodeID,
 									 int16 targetRoute, int serializedLength);
 
+/*
+ * Flush buffered chunks of one route so the next getTransportDirectBuffer()
+ * call returns an empty transmit buffer.
+ */
+extern bool flushTransportDirectBuffer(MotionLayerState *mlStates,
+									 ChunkTransportState *transportStates,
+									 int16 motNodeID,
+									 int16 targetRoute);
+
 /* doBroadcast() is used to send a TupleChunk to all recipients.
  *
  * PARAMETERS
@@ -304,6 +315,47 @@ extern void putTransportDirectBuffer(ChunkTransportState *transportStates,
 			*p_inactive = (inactive ? 1 : 0);	\
 	} while (0)
 
+/* doBroadcastList() sends an entire chain of TupleChunks to all recipients.
+ *
+ * Like doBroadcast(), but walks the connections once and feeds each one the
+ * whole (already serialized) chain, instead of revisiting every connection
+ * for every chunk.
+ *
+ * PARAMETERS
+ *   mlStates - motion-layer state ptr.
+ *   transportStates - IC-instance ptr.
+ *	 pEntry - ChunkTransportState context that contains everything we need to send.
+ *	 tcList - head of the TupleChunk chain to send.
+ */
+#define doBroadcastList(mlStates, transportStates, pEntry, tcList, inactiveCountPtr) \
+	do { \
+		MotionConn *conn; \
+		TupleChunkListItem bcItem; \
+		int			*p_inactive = inactiveCountPtr; \
+		int			i, index, inactive = 0; \
+		index = Max(0, Gp_segment); /* entry-db has -1 */ \
+		for (i = 0; i < pEntry->numConns; i++, index++) \
+		{ \
+			if (index >= pEntry->numConns) \
+				index = 0; \
+			conn = pEntry->conns + index; \
+			/* only send to still interested receivers. */ \
+			if (!conn->stillActive) \
+				continue; \
+			for (bcItem = (tcList); bcItem != NULL; bcItem = bcItem->p_next) \
+			{ \
+				transportStates->SendChunk(mlStates, transportStates, pEntry, conn, bcItem, pEntry->motNodeId); \
+				if (!conn->stillActive) \
+				{ \
+					inactive++; \
+					break; \
+				} \
+			} \
+		} \
+		if (p_inactive != NULL)					\
+			*p_inactive = (inactive ? 1 : 0);	\
+	} while (0)
+
 
 extern ChunkTransportStateEntry *createChunkTransportState(ChunkTransportState *transportStates,
 														   Slice *sendSlice,
@@ -337,4 +389,9 @@ extern void TeardownUDPIFCInterconnect(ChunkTransportState *transportStates,
 extern uint32 getActiveMotionConns(void);
 extern void adjustMasterRouting(Slice *recvSlice);
 
+/* Shared-memory totals of the UDP interconnect statistics. */
+extern Size ICStatsShmemSize(void);
+extern void ICStatsShmemInit(void);
+extern Datum gp_interconnect_flow_stats(PG_FUNCTION_ARGS);
+
 #endif   /* ML_IPC_H */
@@ -26,6 +26,7 @@ typedef enum TupleChunkType
 	TC_PARTIAL_END,				/* Contains the final portion of a tuple. */
 	TC_END_OF_STREAM,			/* Indicates "end of tuples" from this source. */
 	TC_EMPTY,					/* Empty tuple */
+	TC_COMPRESSED,				/* Carries a compressed sequence of chunks. */
 	TC_MAXVAL					/* For range checks on type values. */
 } TupleChunkType;
 
@@ -85,6 +85,10 @@ extern void SerializeRecordCacheIntoChunks(SerTupInfo *pSerInfo,
 /* Convert a HeapTuple into chunks ready to send out, in one pass */
 extern void SerializeTupleIntoChunks(GenericTuple tuple, SerTupInfo *pSerInfo, TupleChunkList tcList);
 
+/* Convert a batch of tuples for the same motion node into one chunk list */
+extern void SerializeTupleListIntoChunks(GenericTuple *tuples, int ntuples,
+							 SerTupInfo *pSerInfo, TupleChunkList tcList);
+
 /* Convert a HeapTuple into chunks directly in a set of transport buffers */
 extern int SerializeTupleDirect(GenericTuple tuple, SerTupInfo *pSerInfo, struct directTransportBuffer *b);
 
@@ -179,6 +179,9 @@ extern void vacuum_aocs_rel(Relation aorel, void *vacrelstats, bool isVacFull);
 extern void analyze_rel(Oid relid, VacuumStmt *vacstmt,
 			BufferAccessStrategy bstrategy);
 extern void analyzeStatement(VacuumStmt *vacstmt, List *relids, BufferAccessStrategy start, bool isTopLevel);
+extern int gp_acquire_sample_rows_internal(Relation onerel, bool inherited,
+								bool *proj, HeapTuple *rows, int targrows,
+								double *totalrows, double *totaldeadrows);
 //extern void analyzeStmt(VacuumStmt *vacstmt, List *relids);
 
 #endif   /* VACUUM_H */
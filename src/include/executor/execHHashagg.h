@@ -41,13 +41,21 @@ typedef struct BatchFileInfo BatchFileInfo;
  */
 typedef struct HashAggEntry
 {
-	struct HashAggEntry *next; /* Next entry in chain. */
 	void *tuple_and_aggs; /* grouping keys and aggregate values.*/
 	HashKey hashvalue;
 	bool is_primodial; /* indicates if this entry is there before spilling. */
 } HashAggEntry;
 
-typedef HashAggEntry* HashAggBucket;
+/*
+ * One slot of the open-addressing hash table: the full hash value is kept
+ * beside the entry pointer so that probes can reject non-matching slots
+ * without dereferencing the entry.  An empty slot has a NULL entry.
+ */
+typedef struct HashAggSlot
+{
+	HashKey hashvalue;
+	HashAggEntry *entry;
+} HashAggSlot;
 
 /* A SpillFile controls access to a temporary file used to hold  
  * transition tuples spilled from the hash table in order to free 
@@ -154,8 +162,9 @@ typedef struct HashAggTable
 	MemoryContext   entry_cxt;	/* memory context for hash table entries */
 
 	unsigned nbuckets;
-	HashAggBucket  *buckets;
-	uint64 *bloom;
+	HashAggSlot *slots;			/* flat open-addressing slot array;
+								 * entries are found by linear probing
+								 * from their home bucket */
 
 	/* hashkey bitshift amount to determine bucket - used when spilling */
 	unsigned pshift;
@@ -180,7 +189,6 @@ typedef struct HashAggTable
 
 	/* Variables during iteration */
 	int curr_bucket_idx;
-	HashAggEntry *next_entry;
 
 	/* buffer for calculating the hashkey */
 	HashKey *hashkey_buf;
@@ -205,6 +213,7 @@ typedef struct HashAggTable
 
 	bool is_spilling; /* indicate that spilling happened for this batch. */
 	bool expandable;  /* hash table buckets still have space to grow */
+	uint32 prespill_serial; /* last red-zone pre-spill request we served */
 	struct TupleTableSlot *prev_slot; /* a slot that is read previously. */
 
 	/* Statistics used for EXPLAIN ANALYZE */
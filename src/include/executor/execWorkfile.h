@@ -146,6 +146,9 @@ ExecWorkFile_Close(ExecWorkFile *workfile);
 
 int ExecWorkFile_Seek(ExecWorkFile *workfile, uint64 offset, int whence);
 void ExecWorkFile_Flush(ExecWorkFile *workfile);
+void ExecWorkFile_Prefetch(ExecWorkFile *workfile, int64 offset, int amount);
+void *ExecWorkFile_Mmap(ExecWorkFile *workfile, int64 *length);
+void ExecWorkFile_Munmap(void *addr, int64 length);
 int64 ExecWorkFile_GetSize(ExecWorkFile *workfile);
 int64 ExecWorkFile_Suspend(ExecWorkFile *workfile);
 void ExecWorkFile_Restart(ExecWorkFile *workfile);
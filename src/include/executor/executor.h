@@ -350,6 +350,8 @@ typedef struct ScanMethod
 
 extern TupleTableSlot *ExecScan(ScanState *node, ExecScanAccessMtd accessMtd,
 		 ExecScanRecheckMtd recheckMtd);
+extern bool ExecScanSupportsDirectFetch(PlanState *ps);
+extern TupleTableSlot *ExecScanDirectFetch(PlanState *ps);
 extern void ExecAssignScanProjectionInfo(ScanState *node);
 extern void ExecScanReScan(ScanState *node);
 extern void InitScanStateRelationDetails(ScanState *scanState, Plan *plan, EState *estate);
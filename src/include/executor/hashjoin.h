@@ -142,6 +142,20 @@ typedef struct HashJoinTableStats
 /*
  * HashJoinTableData
  */
+/*
+ * Staging buffer for writes to one hash join batch workfile.
+ *
+ * data is allocated lazily, on the first spilled tuple for the batch, and
+ * holds gp_hashjoin_spill_batch_size kilobytes (captured in size, so a
+ * mid-query GUC change cannot overflow an existing buffer).
+ */
+typedef struct HashJoinBatchSpill
+{
+	char	   *data;			/* staged bytes not yet written to the file */
+	int			used;			/* number of valid bytes in data */
+	int			size;			/* allocated size of data */
+} HashJoinBatchSpill;
+
 typedef struct HashJoinTableData
 {
 	int			nbuckets;		/* # buckets in the in-memory hash table */
@@ -152,6 +166,7 @@ typedef struct HashJoinTableData
 	/* buckets array is per-batch storage, as are all the tuples */
 
 	bool		skewEnabled;	/* are we using skew optimization? */
+	MemoryContext skewCxt;		/* slab context for the skew bucket structs */
 	HashSkewBucket **skewBucket;	/* hashtable of skew buckets */
 	int			skewBucketLen;	/* size of skewBucket array (a power of 2!) */
 	int			nSkewBuckets;	/* number of active skew buckets */
@@ -165,6 +180,8 @@ typedef struct HashJoinTableData
 
 	bool		growEnabled;	/* flag to shut off nbatch increases */
 
+	uint32		prespill_serial;	/* last red-zone pre-spill request served */
+
 	uint64		totalTuples;	/* # tuples obtained from inner plan */
 
 	/*
@@ -177,6 +194,14 @@ typedef struct HashJoinTableData
 	ExecWorkFile **innerBatchFile; /* buffered virtual temp file per batch */
 	ExecWorkFile **outerBatchFile; /* buffered virtual temp file per batch */
 
+	/*
+	 * Write staging for the batch files, parallel to the arrays above.
+	 * Spilled tuples accumulate here and are written out in large chunks;
+	 * see ExecHashJoinSaveTuple.  Sized by gp_hashjoin_spill_batch_size.
+	 */
+	HashJoinBatchSpill *innerBatchSpill;
+	HashJoinBatchSpill *outerBatchSpill;
+
 	/* Representation of all spill file names, for spill file reuse */
 	workfile_set * work_set;
 
@@ -201,6 +226,22 @@ typedef struct HashJoinTableData
 	MemoryContext batchCxt;		/* context for this-batch-only storage */
 	MemoryContext bfCxt;		/* CDB */ /* context for temp buf file */
 
+	/*
+	 * Runtime Bloom filter over the hash values of all inner tuples, both
+	 * in-memory and spilled.  It is built while the Hash node loads the
+	 * table and is probed for every outer tuple before the buckets (or the
+	 * outer batch files) are touched, so that outer tuples with no possible
+	 * match are discarded early.  NULL when the join type must emit
+	 * unmatched outer tuples, or when gp_hashjoin_bloom_filter is off.
+	 *
+	 * The filter is blocked: bucket i of the main hash table has a companion
+	 * 64-bit word bloomfilter[i], so a probe costs one cache line beyond the
+	 * work already done to compute the hash value.
+	 */
+	uint64	   *bloomfilter;	/* bit array of nbuckets words, in hashCxt */
+	uint64		bloomchecked;	/* outer tuples tested against the filter */
+	uint64		bloomfiltered;	/* outer tuples rejected by the filter */
+
     HashJoinTableStats *stats;  /* statistics workarea for EXPLAIN ANALYZE */
     bool		eagerlyReleased; /* Has this hash-table been eagerly released? */
 
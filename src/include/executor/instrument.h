@@ -34,6 +34,20 @@ typedef struct BufferUsage
 	long		temp_blks_written;		/* # of temp blocks written */
 } BufferUsage;
 
+/*
+ * Global counters of workfile (spill) I/O performed by this backend, kept by
+ * execWorkfile.c.  Per-node attribution works like BufferUsage: a node
+ * snapshots the counters when it starts and accumulates the delta when it
+ * stops, so a node's numbers include the workfile traffic of its children.
+ */
+typedef struct WorkfileUsage
+{
+	uint64		bytes_written;	/* bytes written to workfiles */
+	uint64		bytes_read;		/* bytes read from workfiles */
+	uint64		files_created;	/* workfiles created */
+	instr_time	io_time;		/* time spent in workfile reads and writes */
+} WorkfileUsage;
+
 /* Flag bits included in InstrAlloc's instrument_options bitmask */
 typedef enum InstrumentOption
 {
@@ -50,12 +64,18 @@ typedef struct Instrumentation
 	/* Parameters set at node creation: */
 	bool		need_timer;		/* TRUE if we need timer data */
 	bool		need_cdb;		/* TRUE if we need cdb statistics */
+	bool		use_tsc;		/* TRUE to time with the calibrated TSC */
+	int			timerinterval;	/* time every Nth invocation; <= 1 times all */
 
 	/* Info about current plan cycle: */
 	bool		running;		/* TRUE if we've completed first tuple */
 	bool		needs_bufusage; /* TRUE if we need buffer usage */
 	instr_time	starttime;		/* Start time of current iteration of node */
 	instr_time	counter;		/* Accumulated runtime for this node */
+	uint64		starttsc;		/* TSC at start of current iteration, or 0 */
+	uint64		tsccounter;		/* Accumulated TSC ticks for this node */
+	uint64		itercount;		/* Node invocations so far this cycle */
+	uint64		timedcount;		/* Invocations actually timed this cycle */
 	double		firsttuple;		/* Time for first tuple of this cycle */
 	uint64		tuplecount;		/* Tuples emitted so far this cycle */
 	BufferUsage	bufusage_start;	/* Buffer usage at start */
@@ -76,15 +96,56 @@ typedef struct Instrumentation
 	const char *sortMethod;		/* CDB: Type of sort */
 	const char *sortSpaceType;	/* CDB: Sort space type (Memory / Disk) */
 	long		sortSpaceUsed;	/* CDB: Memory / Disk used by sort(KBytes) */
+	WorkfileUsage wfusage_start;	/* CDB: workfile I/O counters at node start */
+	WorkfileUsage wfusage;		/* CDB: workfile I/O of node (incl. children) */
 	struct CdbExplain_NodeSummary *cdbNodeSummary;	/* stats from all qExecs */
 } Instrumentation;
 
 extern PGDLLIMPORT BufferUsage pgBufferUsage;
+extern PGDLLIMPORT WorkfileUsage pgWorkfileUsage;
+
+/* True once CDB instrumentation has been requested; enables workfile I/O timing */
+extern PGDLLIMPORT bool workfile_instr_timing;
 
 extern Instrumentation *InstrAlloc(int n, int instrument_options);
 extern void InstrStartNode(Instrumentation *instr);
 extern void InstrStopNode(Instrumentation *instr, uint64 nTuples);
 extern void InstrEndLoop(Instrumentation *instr);
+extern double InstrGetElapsed(Instrumentation *instr);
+
+/*
+ * Read the CPU timestamp counter, for the low-overhead timing mode
+ * (gp_instrument_rdtsc).  Returns 0 on platforms without a TSC; the mode
+ * is then unavailable and the instr_time clock is used as usual.
+ */
+#if defined(__x86_64__) || defined(__i386__)
+#define INSTR_HAVE_TSC 1
+static inline uint64
+instr_read_tsc(void)
+{
+	uint32		lo,
+				hi;
+
+	__asm__ __volatile__("rdtsc" : "=a" (lo), "=d" (hi));
+	return ((uint64) hi << 32) | lo;
+}
+#else
+static inline uint64
+instr_read_tsc(void)
+{
+	return 0;
+}
+#endif
+
+/*
+ * Should the current invocation of this node be timed?  The first
+ * invocation of a cycle is always timed so that the first-tuple (startup)
+ * time stays exact; after that, only every timerinterval'th invocation is
+ * timed and InstrEndLoop extrapolates the total from the timed sample.
+ */
+#define INSTR_SHOULD_TIME(instr) \
+	((instr)->timerinterval <= 1 || !(instr)->running || \
+	 ((instr)->itercount % (instr)->timerinterval) == 0)
 
 /*
  * GPDB Note: Macro INSTR_START_NODE replaces InstrStartNode in ExecProcNode for
@@ -93,11 +154,20 @@ extern void InstrEndLoop(Instrumentation *instr);
  */
 #define INSTR_START_NODE(instr) do {											\
 	if ((instr)->need_timer) {													\
-		if (INSTR_TIME_IS_ZERO((instr)->starttime))								\
-			INSTR_TIME_SET_CURRENT((instr)->starttime);							\
-		else																	\
-			elog(DEBUG2, "INSTR_START_NODE called twice in a row");				\
+		(instr)->itercount++;													\
+		if ((instr)->use_tsc) {													\
+			if (INSTR_SHOULD_TIME(instr))										\
+				(instr)->starttsc = instr_read_tsc();							\
+		}																		\
+		else if (INSTR_SHOULD_TIME(instr)) {									\
+			if (INSTR_TIME_IS_ZERO((instr)->starttime))							\
+				INSTR_TIME_SET_CURRENT((instr)->starttime);						\
+			else																\
+				elog(DEBUG2, "INSTR_START_NODE called twice in a row");			\
+		}																		\
 	}																			\
+	if ((instr)->need_cdb)														\
+		(instr)->wfusage_start = pgWorkfileUsage;								\
 } while(0)
 
 /*
@@ -109,20 +179,50 @@ extern void InstrEndLoop(Instrumentation *instr);
 	(instr)->tuplecount += (nTuples);											\
 	if ((instr)->need_timer)													\
 	{																			\
-		instr_time endtime;														\
-		if (INSTR_TIME_IS_ZERO((instr)->starttime))								\
+		if ((instr)->use_tsc)													\
+		{																		\
+			if ((instr)->starttsc != 0)											\
+			{																	\
+				(instr)->tsccounter += instr_read_tsc() - (instr)->starttsc;	\
+				(instr)->starttsc = 0;											\
+				(instr)->timedcount++;											\
+			}																	\
+			else if ((instr)->timerinterval <= 1)								\
+			{																	\
+				elog(DEBUG2, "INSTR_STOP_NODE called without start");			\
+				break;															\
+			}																	\
+		}																		\
+		else if (!INSTR_TIME_IS_ZERO((instr)->starttime))						\
+		{																		\
+			instr_time endtime;													\
+			INSTR_TIME_SET_CURRENT(endtime);									\
+			INSTR_TIME_ACCUM_DIFF((instr)->counter, endtime, (instr)->starttime); \
+			INSTR_TIME_SET_ZERO((instr)->starttime);							\
+			(instr)->timedcount++;												\
+		}																		\
+		else if ((instr)->timerinterval <= 1)									\
 		{																		\
 			elog(DEBUG2, "INSTR_STOP_NODE called without start");				\
 			break;																\
 		}																		\
-		INSTR_TIME_SET_CURRENT(endtime);										\
-		INSTR_TIME_ACCUM_DIFF((instr)->counter, endtime, (instr)->starttime);	\
-		INSTR_TIME_SET_ZERO((instr)->starttime);								\
+	}																			\
+	if ((instr)->need_cdb)														\
+	{																			\
+		(instr)->wfusage.bytes_written +=										\
+			pgWorkfileUsage.bytes_written - (instr)->wfusage_start.bytes_written; \
+		(instr)->wfusage.bytes_read +=											\
+			pgWorkfileUsage.bytes_read - (instr)->wfusage_start.bytes_read;		\
+		(instr)->wfusage.files_created +=										\
+			pgWorkfileUsage.files_created - (instr)->wfusage_start.files_created; \
+		INSTR_TIME_ACCUM_DIFF((instr)->wfusage.io_time,							\
+							  pgWorkfileUsage.io_time,							\
+							  (instr)->wfusage_start.io_time);					\
 	}																			\
 	if (!(instr)->running)														\
 	{																			\
 		(instr)->running = true;												\
-		(instr)->firsttuple = INSTR_TIME_GET_DOUBLE((instr)->counter);			\
+		(instr)->firsttuple = InstrGetElapsed(instr);							\
 		(instr)->firststart = (instr)->starttime;								\
 	}																			\
 } while(0)
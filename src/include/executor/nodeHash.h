@@ -51,6 +51,8 @@ extern void ExecChooseHashTableSize(double ntuples, int tupwidth, bool useskew,
 						int *numbatches,
 						int *num_skew_mcvs);
 extern int	ExecHashGetSkewBucket(HashJoinTable hashtable, uint32 hashvalue);
+extern void ExecHashBloomAdd(HashJoinTable hashtable, uint32 hashvalue);
+extern bool ExecHashBloomTest(HashJoinTable hashtable, uint32 hashvalue);
 
 extern void ExecHashTableExplainInit(HashState *hashState, HashJoinState *hjstate,
                                      HashJoinTable  hashtable);
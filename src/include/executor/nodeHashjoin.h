@@ -24,6 +24,7 @@ extern void ExecReScanHashJoin(HashJoinState *node, ExprContext *exprCtxt);
 
 extern void ExecHashJoinSaveTuple(PlanState *ps, MemTuple tuple, uint32 hashvalue,
 								  HashJoinTable hashtable, ExecWorkFile **fileptr,
+								  HashJoinBatchSpill *spill,
 								  MemoryContext bfCxt);
 extern void ExecEagerFreeHashJoin(HashJoinState *node);
 
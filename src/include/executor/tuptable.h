@@ -394,6 +394,7 @@ extern TupleTableSlot *ExecStoreAllNullTuple(TupleTableSlot *slot);
 extern HeapTuple ExecCopySlotHeapTuple(TupleTableSlot *slot);
 extern MemTuple ExecCopySlotMemTuple(TupleTableSlot *slot);
 extern MemTuple ExecCopySlotMemTupleTo(TupleTableSlot *slot, MemoryContext pctxt, char *dest, unsigned int *len);
+extern MemTuple ExecCopySlotMemTupleToBuffer(TupleTableSlot *slot, MemoryContext bufcxt, char **buf, unsigned int *buflen);
 
 extern HeapTuple ExecFetchSlotHeapTuple(TupleTableSlot *slot);
 extern MemTuple ExecFetchSlotMemTuple(TupleTableSlot *slot, bool inline_toast);
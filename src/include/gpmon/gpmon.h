@@ -54,6 +54,14 @@ extern void gpmon_qlog_query_canceling(gpmon_packet_t *gpmonPacket);
 extern void gpmon_send(gpmon_packet_t*);
 extern void gpmon_gettmid(int32*);
 
+/*
+ * Shared-memory telemetry ring (see gpmon.c): backends enqueue packets,
+ * the stats sender process drains them to the collector in batches.
+ */
+extern Size GpmonShmemSize(void);
+extern void GpmonShmemInit(void);
+extern void gpmon_ring_drain(void);
+
 /* ------------------------------------------------------------------
          FSINFO
    ------------------------------------------------------------------ */
@@ -246,6 +246,9 @@ namespace gpdb {
 	// part constraint expression tree
 	Node *PnodePartConstraintRel(Oid oidRel, List **pplDefaultLevels);
 
+	// partitioning levels that have a default partition
+	List *PlPartitionDefaultLevelsRel(Oid oidRel);
+
 	// get the cast function for the specified source and destination types
 	bool FCastFunc(Oid oidSrc, Oid oidDest, bool *is_binary_coercible, Oid *oidCastFunc, CoercionPathType *pathtype);
 	
@@ -828,6 +828,13 @@ struct ExprState
 	NodeTag		type;
 	Expr	   *expr;			/* associated Expr node */
 	ExprStateEvalFunc evalfunc; /* routine to run to execute node */
+
+	/*
+	 * If the expression rooted here was compiled into a flat bytecode
+	 * program at ExecInitExpr time, evalfunc runs that program instead of
+	 * walking the state tree, and this points at it.  See execQual.c.
+	 */
+	struct ExprBytecodeProgram *bcprogram;
 };
 
 /* ----------------
@@ -1109,6 +1116,8 @@ typedef struct SubPlanState
 	ExprState  *testexpr;		/* state of combining expression */
 	List	   *args;			/* states of argument expression(s) */
 	struct MemTupleData *curTuple;                /* copy of most recent tuple from subplan */
+	uint32		curTupleBufLen; /* allocated size of the curTuple buffer, which
+								 * is reused across executions */
 	Datum		curArray;		/* most recent array from ARRAY() subplan */
 	/* these are used when hashing the subselect's output: */
 	ProjectionInfo *projLeft;	/* for projecting lefthand exprs */
@@ -1403,6 +1412,16 @@ typedef struct PlanState
 	ExprContext *ps_ExprContext;	/* node's expression-evaluation context */
 	ProjectionInfo *ps_ProjInfo;	/* info for doing tuple projection */
 
+	/*
+	 * If non-NULL, this node is a pure pass-through stage that just relays
+	 * its input's result slot (currently only a trivial SubqueryScan: no
+	 * qual, no projection, no ctid labeling), and ExecProcNode may fetch
+	 * from this input directly, skipping one dispatch layer per tuple.
+	 * See the bypass loop in ExecProcNode for the conditions under which
+	 * the shortcut is actually taken.
+	 */
+	struct PlanState *ps_ProxyTarget;
+
 	/*
 	 * EXPLAIN ANALYZE statistics collection
 	 */
@@ -1659,6 +1678,10 @@ typedef struct ScanState
 
 	/* The type of the table that is being scanned */
 	TableType	tableType;
+
+	/* Runtime qual reordering state, built lazily by ExecScan */
+	struct AdaptiveQualState *ss_aqstate;
+	bool		ss_aqchecked;	/* have we decided whether to build it? */
 } ScanState;
 
 /*
@@ -1898,6 +1921,9 @@ typedef struct BitmapAppendOnlyScanState
  *		recheckTuples		should the tuples be rechecked for eligibility because of visibility issues
  *		needNewBitmapPage	are we done with current bitmap page and therefore need a new one?
  *		iterator			an opaque iterator object to iterate a bitmap page and the corresponding table data
+ *		prefetch_iterator	iterator for prefetching ahead of current page (heap only)
+ *		prefetch_pages		# pages prefetch iterator is ahead of current
+ *		prefetch_target		target prefetch distance
  * ----------------
  */
 typedef struct BitmapTableScanState
@@ -1913,6 +1939,9 @@ typedef struct BitmapTableScanState
 	bool						recheckTuples;
 	bool						needNewBitmapPage;
 	void						*iterator;
+	GenericBMIterator			*prefetch_iterator;
+	int							prefetch_pages;
+	int							prefetch_target;
 } BitmapTableScanState;
 
 /* ----------------
@@ -2194,6 +2223,13 @@ typedef struct DynamicTableScanState
 	 */
 	MemoryContext partitionMemoryContext;
 
+	/*
+	 * The next partition to scan, fetched one step ahead of the scan so
+	 * that its first blocks can be prefetched while the current partition
+	 * is still draining. Only valid when nextPidValid is true.
+	 */
+	Oid nextPid;
+	bool nextPidValid;
 
 } DynamicTableScanState;
 
@@ -2240,6 +2276,23 @@ typedef struct NestLoopState
 	List	   *nl_OuterJoinKeys;        /* list of ExprState nodes */
 	bool		nl_innerSideScanned;      /* set to true once we've scanned all inner tuples the first time */
 	bool		nl_qualResultForNull;     /* the value of the join condition when one of the sides contains a NULL */
+
+	/*
+	 * Block nested-loop state: when nl_useBlockJoin is set we buffer a batch
+	 * of outer tuples and probe them all with a single inner pass, so the
+	 * inner rescan cost is paid once per batch instead of once per outer
+	 * tuple.  Only used when the inner subtree does not depend on the
+	 * current outer tuple.
+	 */
+	bool		nl_useBlockJoin;      /* batch outer tuples, one inner pass per batch */
+	bool		nl_outerDone;         /* no more outer tuples to batch */
+	bool		nl_needNewBatch;      /* current batch fully processed */
+	bool		nl_emittingUnmatched; /* emitting null-extended unmatched entries */
+	int			nl_batchCount;        /* number of tuples in current batch */
+	int			nl_probeIndex;        /* next batch entry to probe with inner tuple */
+	int			nl_emitIndex;         /* next batch entry to check in emit phase */
+	TupleTableSlot **nl_BatchSlots;   /* materialized outer tuples */
+	bool	   *nl_BatchMatched;      /* per-entry join match flags */
 } NestLoopState;
 
 /* ----------------
@@ -2541,6 +2594,7 @@ typedef struct WindowAggState
 												 * fetches */
 	int64		aggregatedbase; /* start row for current aggregates */
 	int64		aggregatedupto; /* rows before this one are aggregated */
+	bool		agg_inverse_ok; /* all aggs have inverse transition fns */
 
 	int			frameOptions;	/* frame_clause options, see WindowDef */
 	ExprState  *startOffset;	/* expression for starting bound offset */
@@ -2709,6 +2763,7 @@ typedef struct LimitState
 	LimitStateCond lstate;		/* state machine status, as above */
 	int64		position;		/* 1-based index of last tuple returned */
 	TupleTableSlot *subSlot;	/* tuple last obtained from subplan */
+	bool		expect_backward;	/* may caller scan backward through us? */
 } LimitState;
 
 /*
@@ -333,6 +333,8 @@ typedef enum NodeTag
 	 */
 	T_MemoryContext = 600,
 	T_AllocSetContext,
+	T_SlabContext,
+	T_GenerationContext,
 	T_MemoryAccount,
 
 	/*
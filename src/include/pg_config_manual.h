@@ -141,6 +141,16 @@
 #define USE_PREFETCH
 #endif
 
+/*
+ * USE_POSIX_FALLOCATE controls whether Postgres will attempt to use the
+ * posix_fallocate() call to preallocate file space.  There is no configure
+ * probe for it; glibc has provided it since 2.1.94, so we simply assume it
+ * on Linux.
+ */
+#if defined(__linux__)
+#define USE_POSIX_FALLOCATE
+#endif
+
 /*
  * This is the default directory in which AF_UNIX socket files are
  * placed.	Caution: changing this risks breaking your existing client
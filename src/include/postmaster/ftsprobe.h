@@ -90,4 +90,5 @@ typedef struct
 } fts_context;
 
 extern bool FtsWalRepMessageSegments(CdbComponentDatabases *context);
+extern bool FtsProbeCycleHadSuspects(void);
 #endif
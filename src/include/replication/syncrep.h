@@ -43,6 +43,7 @@ extern void SyncRepCleanupAtProcExit(void);
 /* called by wal sender */
 extern void SyncRepInitConfig(void);
 extern void SyncRepReleaseWaiters(void);
+extern bool SyncRepHaveWaiters(void);
 
 /* called by checkpointer */
 extern void SyncRepUpdateSyncStandbysDefined(void);
@@ -53,13 +53,46 @@ typedef struct
 	TimestampTz sendTime;
 } WalDataMessageHeader;
 
+/*
+ * Header for a compressed WAL data message (message type 'z').  This is
+ * wrapped within a CopyData message at the FE/BE protocol level.
+ *
+ * The header is followed by one LZ4 block holding rawlen bytes of WAL data
+ * starting at wal.dataStart; the compressed length is whatever remains in
+ * the message.  The sender uses this message type only when the receiver
+ * asked for compression (see gp_walrepl_compress) and the batch actually
+ * shrank; otherwise it falls back to a plain 'w' message, so receivers must
+ * always be prepared to handle both.
+ */
+typedef struct
+{
+	/* Same fields as an uncompressed 'w' message */
+	WalDataMessageHeader wal;
+
+	/* Uncompressed length of the WAL data carried by this message */
+	uint32		rawlen;
+} WalCompressedDataMessageHeader;
+
 /*
  * Keepalive message from primary (message type 'k'). (lowercase k)
  * This is wrapped within a CopyData message at the FE/BE protocol level.
  *
  * Note that the data length is not specified here.
  */
-typedef WalSndrMessage PrimaryKeepaliveMessage;
+typedef struct
+{
+	/* Current end of WAL on the sender */
+	XLogRecPtr	walEnd;
+
+	/* Sender's system clock at the time of transmission */
+	TimestampTz sendTime;
+
+	/*
+	 * If true, the sender wants a status reply as soon as possible; it has
+	 * backends queued waiting for synchronous-replication acknowledgment.
+	 */
+	bool		replyRequested;
+} PrimaryKeepaliveMessage;
 
 /*
  * Reply message from standby (message type 'r').  This is wrapped within
@@ -154,6 +154,23 @@ typedef struct sbufdesc
 #define FREENEXT_END_OF_LIST	(-1)
 #define FREENEXT_NOT_IN_LIST	(-2)
 
+/*
+ * Number of partitions the list of unused buffers is divided into.
+ * Each partition is protected by its own spinlock, so that concurrent
+ * backends allocating buffers do not all serialize on one lock.
+ *
+ * These live here rather than in freelist.c so that the optional NUMA
+ * backend affinity code in postmaster.c can place a backend on the same
+ * node as the freelist partition it hashes to.
+ */
+#define NUM_FREELIST_PARTITIONS  16
+
+/* Partition a buffer belongs to; buffers are striped by buffer id. */
+#define BufFreelistPartition(buf_id) ((buf_id) % NUM_FREELIST_PARTITIONS)
+
+/* Partition a backend starts allocating from */
+#define BufFreelistHomePartition(pid) ((pid) % NUM_FREELIST_PARTITIONS)
+
 /*
  * Macros for acquiring/releasing a shared buffer header's spinlock.
  * Do not apply these to local buffers!
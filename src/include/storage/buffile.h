@@ -48,6 +48,8 @@ extern void BufFileTell(BufFile *file, int *fileno, off_t *offset);
 extern int	BufFileSeekBlock(BufFile *file, int64 blknum);
 extern void BufFileFlush(BufFile *file);
 extern int64 BufFileGetSize(BufFile *buffile);
+extern int BufFileGetRawDesc(BufFile *buffile);
+extern int BufFilePrefetch(BufFile *buffile, int64 offset, int amount);
 extern void BufFileSetWorkfile(BufFile *buffile);
 
 #endif   /* BUFFILE_H */
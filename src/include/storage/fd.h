@@ -72,6 +72,8 @@ extern File OpenTemporaryFile(bool interXact, const char *filePrefix);
 
 extern void FileClose(File file);
 extern int	FilePrefetch(File file, off_t offset, int amount);
+extern int	FileDiscardData(File file, off_t offset, off_t amount);
+extern int	FileAllocate(File file, off_t offset, off_t amount);
 extern int	FileRead(File file, char *buffer, int amount);
 extern int	FileWrite(File file, char *buffer, int amount);
 extern int	FileSync(File file);
@@ -79,6 +81,7 @@ extern int64 FileSeek(File file, int64 offset, int whence);
 extern int64 FileNonVirtualCurSeek(File file);
 extern int	FileTruncate(File file, int64 offset);
 extern char *FilePathName(File file);
+extern int	FileGetRawDesc(File file);
 extern int64 FileDiskSize(File file);
 
 /* Operations that allow use of regular stdio --- USE WITH CAUTION */
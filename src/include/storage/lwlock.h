@@ -34,6 +34,9 @@
 /* Number of partitions of the workfile query diskspace hashtable */
 #define NUM_WORKFILE_QUERYSPACE_PARTITIONS 128
 
+/* Number of partitions of the append-only writer relation hashtable */
+#define NUM_AOSEGFILE_PARTITIONS  16
+
 /*
  * We have a number of predefined LWLocks, plus a bunch of LWLocks that are
  * dynamically assigned (e.g., for shared buffers).  The LWLock structures
@@ -81,8 +84,8 @@ typedef enum LWLockId
 	SharedSnapshotLock,
 	DistributedLogControlLock,
 	SeqServerControlLock,
-	AOSegFileLock,
-	ResQueueLock,
+	FirstAOSegFileLock,
+	ResQueueLock = FirstAOSegFileLock + NUM_AOSEGFILE_PARTITIONS,
 	ResGroupLock,
 	SyncRepLock,
 	ErrorLogLock,
@@ -95,6 +98,7 @@ typedef enum LWLockId
 	FilespaceHashLock,
 	TablespaceHashLock,
 	GpReplicationConfigFileLock,
+	RelSizeCacheLock,
 	/* must be last except for MaxDynamicLWLock: */
 	NumFixedLWLocks,
 
@@ -117,6 +121,7 @@ extern bool Trace_lwlocks;
 extern LWLockId LWLockAssign(void);
 extern void LWLockAcquire(LWLockId lockid, LWLockMode mode);
 extern bool LWLockConditionalAcquire(LWLockId lockid, LWLockMode mode);
+extern bool LWLockAcquireOrWait(LWLockId lockid, LWLockMode mode);
 extern void LWLockRelease(LWLockId lockid);
 extern void LWLockReleaseAll(void);
 extern bool LWLockHeldByMe(LWLockId lockid);
@@ -130,8 +130,18 @@ struct PGPROC
 	/* Info about LWLock the process is currently waiting for, if any. */
 	bool		lwWaiting;		/* true if waiting for an LW lock */
 	bool		lwExclusive;	/* true if waiting for exclusive access */
+	bool		lwWaitUntilFree;	/* true if just waiting for the lock to
+									 * become free, without acquiring it (see
+									 * LWLockAcquireOrWait) */
 	struct PGPROC *lwWaitLink;	/* next waiter for same LW lock */
 
+	/*
+	 * Encoded wait event while blocked on an LWLock or heavyweight lock,
+	 * else 0.  See storage/waitevent.h.  Written only by the owning
+	 * backend; may be read without lock by observers.
+	 */
+	uint32		waitEventInfo;
+
 	/* Info about lock the process is currently waiting for, if any. */
 	/* waitLock and waitProcLock are NULL if not currently waiting. */
 	LOCK	   *waitLock;		/* Lock object we're sleeping on ... */
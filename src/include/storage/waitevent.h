@@ -0,0 +1,43 @@
+/*-------------------------------------------------------------------------
+ *
+ * waitevent.h
+ *	  Lightweight wait-event accounting for blocking lock acquisitions.
+ *
+ * When a backend blocks on an LWLock or a heavyweight lock, it tags its
+ * PGPROC with an encoded wait event (a single store) and, on wakeup,
+ * folds the wait into a small set of shared counters.  The counters are
+ * exposed through the gp_wait_event_counters() function, so lock-wait
+ * distributions can be read with plain SQL instead of profiling the
+ * segment host.
+ *
+ * Portions Copyright (c) 2012-Present Pivotal Software, Inc.
+ *
+ * src/include/storage/waitevent.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef WAITEVENT_H
+#define WAITEVENT_H
+
+/*
+ * Wait-event classes.  The class and the class-specific event id are packed
+ * into one uint32 (class in the high byte) so tagging PGPROC stays a single
+ * store on the block path.  For WAIT_EVENT_CLASS_LWLOCK the id is the
+ * LWLockId; for WAIT_EVENT_CLASS_LOCK it is the LOCKTAG's locktag_type.
+ */
+#define WAIT_EVENT_CLASS_NONE		0
+#define WAIT_EVENT_CLASS_LWLOCK		1
+#define WAIT_EVENT_CLASS_LOCK		2
+
+#define WaitEventEncode(classId, eventId) \
+	(((uint32) (classId) << 24) | ((uint32) (eventId) & 0xFFFFFF))
+#define WaitEventClass(info)	((info) >> 24)
+#define WaitEventId(info)		((info) & 0xFFFFFF)
+
+extern Size WaitEventShmemSize(void);
+extern void WaitEventShmemInit(void);
+
+extern void WaitEventStartWait(uint8 classId, uint32 eventId);
+extern void WaitEventEndWait(void);
+
+#endif   /* WAITEVENT_H */
@@ -441,6 +441,16 @@ extern Datum width_bucket_float8(PG_FUNCTION_ARGS);
 extern Datum float8_amalg(PG_FUNCTION_ARGS); /* MPP */
 extern Datum float8_demalg(PG_FUNCTION_ARGS); /* MPP */
 extern Datum float8_regr_amalg(PG_FUNCTION_ARGS); /* MPP */
+extern Datum float4_stat_accum(PG_FUNCTION_ARGS); /* MPP */
+extern Datum float8_stat_accum(PG_FUNCTION_ARGS); /* MPP */
+extern Datum float4_stat_decum(PG_FUNCTION_ARGS); /* MPP */
+extern Datum float8_stat_decum(PG_FUNCTION_ARGS); /* MPP */
+extern Datum float8_stat_amalg(PG_FUNCTION_ARGS); /* MPP */
+extern Datum float8_stat_demalg(PG_FUNCTION_ARGS); /* MPP */
+extern Datum float8_stat_var_pop(PG_FUNCTION_ARGS); /* MPP */
+extern Datum float8_stat_var_samp(PG_FUNCTION_ARGS); /* MPP */
+extern Datum float8_stat_stddev_pop(PG_FUNCTION_ARGS); /* MPP */
+extern Datum float8_stat_stddev_samp(PG_FUNCTION_ARGS); /* MPP */
 extern Datum pg_highest_oid(PG_FUNCTION_ARGS); /* MPP */
 extern Datum gp_max_distributed_xid(PG_FUNCTION_ARGS); /* MPP */
 extern Datum gp_distributed_xid(PG_FUNCTION_ARGS); /* MPP */
@@ -458,6 +468,16 @@ extern Datum pg_indexes_size(PG_FUNCTION_ARGS);
 extern Datum pg_relation_filenode(PG_FUNCTION_ARGS);
 extern Datum pg_relation_filepath(PG_FUNCTION_ARGS);
 extern Datum gp_statistics_estimate_reltuples_relpages_oid(PG_FUNCTION_ARGS);
+extern Datum gp_acquire_sample_rows(PG_FUNCTION_ARGS);
+
+/* storage/file/fd.c */
+extern Datum gp_vfd_stats(PG_FUNCTION_ARGS);
+
+/* storage/lmgr/waitevent.c */
+extern Datum gp_wait_event_counters(PG_FUNCTION_ARGS);
+
+/* cdb/cdbresusage.c */
+extern Datum gp_query_resource_usage(PG_FUNCTION_ARGS);
 
 /* genfile.c */
 extern bytea *read_binary_file(const char *filename,
@@ -1020,6 +1040,11 @@ extern Datum int8_sum(PG_FUNCTION_ARGS);
 extern Datum int2_invsum(PG_FUNCTION_ARGS);
 extern Datum int4_invsum(PG_FUNCTION_ARGS);
 extern Datum int8_invsum(PG_FUNCTION_ARGS);
+extern Datum int8_sum_accum(PG_FUNCTION_ARGS);
+extern Datum int8_sum_decum(PG_FUNCTION_ARGS);
+extern Datum int8_sum_amalg(PG_FUNCTION_ARGS);
+extern Datum int8_sum_demalg(PG_FUNCTION_ARGS);
+extern Datum int8_sum_final(PG_FUNCTION_ARGS);
 extern Datum int2_avg_accum(PG_FUNCTION_ARGS);
 extern Datum int4_avg_accum(PG_FUNCTION_ARGS);
 extern Datum int8_avg_accum(PG_FUNCTION_ARGS);
@@ -1181,11 +1206,19 @@ extern Datum pg_cursor(PG_FUNCTION_ARGS);
 /* utils/resscheduler/resqueue.c */
 extern Datum pg_resqueue_status(PG_FUNCTION_ARGS);
 extern Datum pg_resqueue_status_kv(PG_FUNCTION_ARGS);
+extern Datum gp_resqueue_stats(PG_FUNCTION_ARGS);
 
 /* utils/resgroup/resgroup.c */
 extern Datum pg_resgroup_get_status(PG_FUNCTION_ARGS);
 extern Datum pg_resgroup_get_status_kv(PG_FUNCTION_ARGS);
 
+/* utils/mmgr/memsnapshot.c */
+extern Datum gp_backend_memory_contexts(PG_FUNCTION_ARGS);
+
+/* utils/adt/misc.c */
+extern Datum gp_catcache_statistics(PG_FUNCTION_ARGS);
+extern Datum gp_relcache_write_user_init_file(PG_FUNCTION_ARGS);
+
 /* utils/adt/matrix.c */
 extern Datum matrix_add(PG_FUNCTION_ARGS);
 
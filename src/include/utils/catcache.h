@@ -83,6 +83,14 @@ typedef struct catctup
 	 */
 	Dlelem		cache_elem;		/* list member of per-bucket list */
 
+	/*
+	 * All tuples of all caches are also chained into one global list in
+	 * recency order, so that a bounded cache (gp_catcache_memory_limit_kb)
+	 * can evict from the cold end.
+	 */
+	Dlelem		lru_elem;		/* list member of global LRU list */
+	int			size;			/* bytes of this entry, header and tuple */
+
 	/*
 	 * The tuple may also be a member of at most one CatCList.	(If a single
 	 * catcache is list-searched with varying numbers of keys, we may have to
@@ -155,12 +163,32 @@ typedef struct catcacheheader
 {
 	CatCache   *ch_caches;		/* head of list of CatCache structs */
 	int			ch_ntup;		/* # of tuples in all caches */
+	int			ch_negtup;		/* # of negative tuples in all caches */
+	long		ch_nbytes;		/* total bytes held by all entries */
+	Dllist		ch_lrulist;		/* all entries, most recently used first */
+	long		ch_evictions;	/* # of entries evicted by the size limit */
+	long		ch_negprunes;	/* # of negative entries pruned */
 } CatCacheHeader;
 
+/* Statistics snapshot returned by GetCatCacheStatistics */
+typedef struct CatCacheStats
+{
+	long		entries;
+	long		negative_entries;
+	long		bytes;
+	long		evictions;
+	long		negative_prunes;
+} CatCacheStats;
+
 
 /* this extern duplicates utils/memutils.h... */
 extern PGDLLIMPORT MemoryContext CacheMemoryContext;
 
+extern int	gp_catcache_memory_limit_kb;
+extern int	gp_catcache_negative_entry_limit;
+
+extern void GetCatCacheStatistics(CatCacheStats *stats);
+
 extern void CreateCacheMemoryContext(void);
 extern void AtEOXact_CatCache(bool isCommit);
 
@@ -172,6 +200,10 @@ extern void InitCatCachePhase2(CatCache *cache, bool touch_index);
 extern HeapTuple SearchCatCache(CatCache *cache,
 			   Datum v1, Datum v2,
 			   Datum v3, Datum v4);
+extern void SearchCatCacheBatch(CatCache *cache, int nitems,
+					const Datum *v1, const Datum *v2,
+					const Datum *v3, const Datum *v4,
+					HeapTuple *tuples);
 extern void ReleaseCatCache(HeapTuple tuple);
 
 extern CatCList *SearchCatCacheList(CatCache *cache, int nkeys,
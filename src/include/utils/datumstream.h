@@ -228,6 +228,48 @@ datumstreamread_nth(DatumStreamRead * acc)
 	}
 }
 
+/*
+ * Number of datums left in the current block after the current position.
+ * A large content object holds exactly one datum, which the scalar
+ * routines above hand out, so it never has datums "left over".
+ */
+inline static int
+datumstreamread_remaining(DatumStreamRead * acc)
+{
+	if (acc->largeObjectState == DatumStreamLargeObjectState_None)
+	{
+		return acc->blockRead.logical_row_count - acc->blockRead.nth - 1;
+	}
+
+	return 0;
+}
+
+/*
+ * Bulk form of datumstreamread_advance + datumstreamread_get: fill the
+ * caller's values / nulls vectors with up to maxDatums datums from the
+ * current block and return the number actually filled.  The fill stops
+ * early when the block is exhausted; the caller is expected to read the
+ * next block before asking for more.  Decoding one column for many rows
+ * in a row keeps the block read state hot in the CPU cache instead of
+ * re-fetching it for every (row, column) pair.
+ */
+inline static int
+datumstreamread_getbatch(DatumStreamRead * acc, int maxDatums,
+						 Datum *values, bool *nulls)
+{
+	int			n = 0;
+
+	while (n < maxDatums)
+	{
+		if (datumstreamread_advance(acc) == 0)
+			break;
+		datumstreamread_get(acc, &values[n], &nulls[n]);
+		n++;
+	}
+
+	return n;
+}
+
 /* ------------------------------------------------------------------------------ */
 
 extern int datumstreamwrite_put(
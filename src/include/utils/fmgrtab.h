@@ -19,7 +19,8 @@
 /*
  * This table stores info about all the built-in functions (ie, functions
  * that are compiled into the Postgres executable).  The table entries are
- * required to appear in Oid order, so that binary search can be used.
+ * required to appear in Oid order, so that the lookup index below can be
+ * generated alongside it.
  */
 
 typedef struct
@@ -36,4 +37,16 @@ extern const FmgrBuiltin fmgr_builtins[];
 
 extern const int fmgr_nbuiltins;	/* number of entries in table */
 
+/*
+ * Direct lookup index, also generated by Gen_fmgrtab.pl: for every Oid up
+ * to fmgr_last_builtin_oid, the array holds that function's position in
+ * fmgr_builtins, or InvalidFmgrBuiltinIndex if the Oid is not a built-in
+ * function.  This makes lookup by Oid a single array reference instead of
+ * a binary search.
+ */
+extern const Oid fmgr_last_builtin_oid; /* highest Oid in fmgr_builtins */
+extern const uint16 fmgr_builtin_oid_index[];
+
+#define InvalidFmgrBuiltinIndex 0xFFFF
+
 #endif   /* FMGRTAB_H */
@@ -16,6 +16,7 @@
 #define GP_ALLOC_H
 
 #include "nodes/nodes.h"
+#include "utils/vmem_tracker.h"
 
 #ifdef USE_ASSERT_CHECKING
 #define GP_ALLOC_DEBUG
@@ -48,12 +49,26 @@ typedef struct VmemHeader
 #endif
 	/* The size of the usable allocation, i.e., without the header/footer overhead */
 	size_t size;
+	/*
+	 * True if this allocation is backed by an explicit huge-page mapping
+	 * instead of malloc; such pointers must be munmap'ed, never free'd or
+	 * realloc'ed (see memprot.c).
+	 */
+	bool ishuge;
 } VmemHeader;
 
 extern void *gp_malloc(int64 sz);
 extern void *gp_realloc(void *ptr, int64 newsz);
 extern void gp_free(void *ptr);
 
+/*
+ * Variants for callers that reserve vmem in bulk themselves instead of
+ * paying a vmem tracker round trip per pointer (see ext_alloc.c).
+ */
+extern void *gp_malloc_prereserved(int64 sz);
+extern void gp_free_prereserved(void *ptr);
+extern void gp_failed_to_alloc(MemoryAllocationStatus ec, int en, int sz);
+
 /* Gets the actual usable payload address of a vmem pointer */
 static inline
 void* VmemPtrToUserPtr(VmemHeader *ptr)
@@ -146,6 +161,20 @@ VmemPtr_VerifyFooterChecksum(VmemHeader *ptr)
 #define VmemPtr_VerifyFooterChecksum(ptr)
 #endif
 
+/* Marks a Vmem pointer as backed by an explicit huge-page mapping */
+static inline void
+VmemPtr_SetIsHuge(VmemHeader *ptr)
+{
+	ptr->ishuge = true;
+}
+
+/* Is this Vmem pointer backed by an explicit huge-page mapping? */
+static inline bool
+VmemPtr_IsHuge(VmemHeader *ptr)
+{
+	return ptr->ishuge;
+}
+
 /* Extracts the size from an user pointer */
 static inline size_t
 UserPtr_GetUserPtrSize(void *ptr)
@@ -172,6 +201,7 @@ static inline void
 VmemPtr_Initialize(VmemHeader *ptr, size_t size)
 {
 	VmemPtr_SetUserPtrSize(ptr, size);
+	ptr->ishuge = false;
 	VmemPtr_SetHeaderChecksum(ptr);
 	VmemPtr_SetFooterChecksum(ptr);
 }
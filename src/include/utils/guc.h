@@ -227,6 +227,8 @@ extern int  gp_max_local_distributed_cache;
 extern bool gp_local_distributed_cache_stats;
 extern bool gp_appendonly_verify_block_checksums;
 extern bool gp_appendonly_verify_write_block;
+extern bool gp_appendonly_read_prefetch;
+extern int	gp_appendonly_preallocate_len;
 extern bool gp_appendonly_compaction;
 
 /*
@@ -238,6 +240,14 @@ extern bool gp_appendonly_compaction;
  * 10% of the tuples are hidden.
  */ 
 extern int  gp_appendonly_compaction_threshold;
+
+/*
+ * Upper bound on the number of segment files of an append-only relation
+ * that a single lazy vacuum run compacts. 0 means no limit. With a limit,
+ * vacuum reclaims the most bloated segment files first and leaves the rest
+ * for the next run, so large relations can be vacuumed incrementally.
+ */
+extern int  gp_appendonly_compaction_segfile_limit;
 extern bool gp_heap_require_relhasoids_match;
 extern bool	Debug_appendonly_rezero_quicklz_compress_scratch;
 extern bool	Debug_appendonly_rezero_quicklz_decompress_scratch;
@@ -259,6 +269,7 @@ extern bool gp_crash_recovery_suppress_ao_eof;
 extern bool gp_create_table_random_default_distribution;
 extern bool gp_allow_non_uniform_partitioning_ddl;
 extern bool gp_enable_exchange_default_partition;
+extern bool gp_enable_partition_node_cache;
 extern int  dtx_phase2_retry_count;
 
 /* WAL replication debug gucs */
@@ -267,6 +278,9 @@ extern bool debug_walrepl_syncrep;
 extern bool debug_walrepl_rcv;
 extern bool debug_basebackup;
 
+/* WAL replication compression (Master Mirroring) */
+extern bool gp_walrepl_compress;
+
 /* Latch mechanism debug GUCs */
 extern bool debug_latch;
 
@@ -309,6 +323,8 @@ extern int	num_temp_buffers;
 extern bool gp_cancel_query_print_log;
 extern int gp_cancel_query_delay_time;
 extern bool vmem_process_interrupt;
+extern int	gp_vmem_lease_chunks;
+extern int	gp_huge_page_alloc_threshold_mb;
 extern bool execute_pruned_plan;
 
 extern bool gp_partitioning_dynamic_selection_log;
@@ -367,6 +383,8 @@ extern int	tcp_keepalives_count;
 
 extern int	gp_connection_send_timeout;
 
+extern int	gp_client_send_buffer_size;
+
 extern int  WalSendClientTimeout;
 
 extern char  *data_directory;
@@ -470,6 +488,7 @@ extern double optimizer_nestloop_factor;
 extern double optimizer_sort_factor;
 
 /* Optimizer hints */
+extern bool optimizer_bypass_simple_queries;
 extern int optimizer_array_expansion_threshold;
 extern int optimizer_join_order_threshold;
 extern int optimizer_join_order;
@@ -638,6 +657,9 @@ extern void AtStart_GUC(void);
 extern int	NewGUCNestLevel(void);
 extern void AtEOXact_GUC(bool isCommit, int nestLevel);
 extern void BeginReportingGUCOptions(void);
+
+/* bumped whenever a GUC value may have changed in this backend */
+extern int	gp_guc_generation;
 extern void ParseLongOption(const char *string, char **name, char **value);
 extern bool parse_int(const char *value, int *result, int flags,
 		  const char **hintmsg);
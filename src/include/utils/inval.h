@@ -25,6 +25,8 @@ typedef void (*RelcacheCallbackFunction) (Datum arg, Oid relid);
 
 extern void AcceptInvalidationMessages(void);
 
+extern bool xactHasInvalidationMessages(void);
+
 extern void AtStart_Inval(void);
 
 extern void AtSubStart_Inval(void);
@@ -43,6 +43,18 @@ typedef struct MemoryAccountExplain {
  */
 extern int explain_memory_verbosity;
 
+/*
+ * Fold allocations into the per-account counters only every Nth call
+ * (1 = account every allocation exactly).
+ */
+extern int gp_memory_accounting_sample_interval;
+
+/*
+ * Applies any allocation/free deltas that sampling mode has not yet folded
+ * into the per-account counters.  A no-op when nothing is pending.
+ */
+extern void MemoryAccounting_Reconcile(void);
+
 /*
  * Unique run id for memory profiling. May be just a start timestamp for a batch of queries such as TPCH
  */
@@ -65,6 +65,20 @@ extern MemoryAccount *SharedChunkHeadersMemoryAccount;
 extern uint64 MemoryAccountingOutstandingBalance;
 extern uint64 MemoryAccountingPeakBalance;
 
+/*
+ * Sampling mode (gp_memory_accounting_sample_interval > 1): allocations and
+ * deallocations against the account that was charged most recently are
+ * accumulated in these pending counters instead of being folded into the
+ * MemoryAccount immediately.  The pending deltas are applied by
+ * MemoryAccounting_Reconcile(), which runs on every Nth call, whenever the
+ * charged account changes, and before anybody reads the counters.  At most
+ * one account has unapplied deltas at any time.
+ */
+extern MemoryAccountIdType MemoryAccountingPendingAccountId;
+extern uint64 MemoryAccountingPendingAllocated;
+extern uint64 MemoryAccountingPendingFreed;
+extern uint32 MemoryAccountingPendingCalls;
+
 /*
  * MemoryAccounting_IsLiveAccount
  *    Checks if an account is live.
@@ -134,6 +148,26 @@ MemoryAccounting_ConvertIdToAccount(MemoryAccountIdType id)
 static inline bool
 MemoryAccounting_Allocate(MemoryAccountIdType memoryAccountId, Size allocatedSize)
 {
+	if (gp_memory_accounting_sample_interval > 1)
+	{
+		/*
+		 * Sampling mode: just accumulate into the pending counters; the
+		 * account itself is updated on every Nth call or when the charged
+		 * account changes.
+		 */
+		if (memoryAccountId != MemoryAccountingPendingAccountId)
+			MemoryAccounting_Reconcile();
+
+		MemoryAccountingPendingAccountId = memoryAccountId;
+		MemoryAccountingPendingAllocated += allocatedSize;
+
+		if (++MemoryAccountingPendingCalls >=
+			(uint32) gp_memory_accounting_sample_interval)
+			MemoryAccounting_Reconcile();
+
+		return true;
+	}
+
 	MemoryAccount* memoryAccount = MemoryAccounting_ConvertIdToAccount(memoryAccountId);
 
 	Assert(memoryAccount->allocated + allocatedSize >=
@@ -175,6 +209,24 @@ MemoryAccounting_Allocate(MemoryAccountIdType memoryAccountId, Size allocatedSiz
 static inline bool
 MemoryAccounting_Free(MemoryAccountIdType memoryAccountId, Size allocatedSize)
 {
+	if (gp_memory_accounting_sample_interval > 1 &&
+		memoryAccountId == MemoryAccountingPendingAccountId)
+	{
+		/*
+		 * Sampling mode, and the freed chunk is charged to the account that
+		 * currently has pending deltas; batch the free with them.  Frees
+		 * against any other account fall through to the exact path below,
+		 * so their counters never go stale.
+		 */
+		MemoryAccountingPendingFreed += allocatedSize;
+
+		if (++MemoryAccountingPendingCalls >=
+			(uint32) gp_memory_accounting_sample_interval)
+			MemoryAccounting_Reconcile();
+
+		return true;
+	}
+
 	MemoryAccount* memoryAccount = MemoryAccounting_ConvertIdToAccount(memoryAccountId);
 
 	Assert(memoryAccount->freed +
@@ -0,0 +1,37 @@
+/*-------------------------------------------------------------------------
+ *
+ * memsnapshot.h
+ *	  On-demand memory context snapshots of live backends.
+ *
+ * A backend can be asked, via PROCSIG_DUMP_MEMORY_CONTEXTS, to publish the
+ * statistics of its memory context tree into a small shared memory buffer,
+ * where the requesting backend picks them up and returns them as the result
+ * of gp_backend_memory_contexts(pid).  This gives the same information as
+ * attaching a debugger and calling MemoryContextStats(), without stopping
+ * the target process.
+ *
+ * Portions Copyright (c) 2016-Present Pivotal Software, Inc.
+ *
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef MEMSNAPSHOT_H
+#define MEMSNAPSHOT_H
+
+#include "fmgr.h"
+
+/*
+ * Set by the SIGUSR1 handler when another backend has requested a memory
+ * context snapshot; serviced at the next CHECK_FOR_INTERRUPTS().
+ */
+extern volatile bool MemSnapshotDumpPending;
+
+extern Size MemSnapshotShmemSize(void);
+extern void MemSnapshotShmemInit(void);
+
+extern void HandleMemSnapshotInterrupt(void);
+extern void ProcessMemSnapshotRequest(void);
+
+extern Datum gp_backend_memory_contexts(PG_FUNCTION_ARGS);
+
+#endif   /* MEMSNAPSHOT_H */
@@ -168,6 +168,37 @@ typedef struct AllocSetContext
 
 typedef AllocSetContext *AllocSet;
 
+typedef struct GenerationBlockData *GenerationBlock;	/* forward reference */
+
+/*
+ * GenerationContext is a MemoryContext implementation for chunks with
+ * roughly FIFO lifetimes (generation.c): allocation just advances a free
+ * pointer in the current block, and a block is recycled once every chunk
+ * carved from it has been freed.  The struct is exposed here (like
+ * AllocSetContext) so that mcxt.c can inspect sharedHeaderList.
+ */
+typedef struct GenerationContext
+{
+	MemoryContextData header;	/* Standard memory-context fields */
+	/* Allocation parameters for this context: */
+	Size		blockSize;		/* standard block size */
+	/* Info about storage allocated in this context: */
+	GenerationBlock block;		/* current block to allocate from */
+	GenerationBlock blocks;		/* head of list of all blocks */
+	GenerationBlock keeper;		/* if not NULL, keep this block over resets */
+	bool		isReset;		/* T = no space alloced since last reset */
+
+	/* Points to the head of the sharedHeaderList */
+	SharedChunkHeader *sharedHeaderList;
+	/* The memory account of this SharedChunkHeader is NULL */
+	SharedChunkHeader *nullAccountHeader;
+
+#ifdef CDB_PALLOC_TAGS
+	/* Doubly-linked list of currently allocated chunk headers */
+	StandardChunkHeader *allocList;
+#endif
+} GenerationContext;
+
 /*
  * Standard top-level memory contexts.
  *
@@ -254,6 +285,17 @@ extern MemoryContext AllocSetContextCreate(MemoryContext parent,
 					  Size initBlockSize,
 					  Size maxBlockSize);
 
+/* slab.c */
+extern MemoryContext SlabContextCreate(MemoryContext parent,
+				  const char *name,
+				  Size blockSize,
+				  Size chunkSize);
+
+/* generation.c */
+extern MemoryContext GenerationContextCreate(MemoryContext parent,
+						const char *name,
+						Size blockSize);
+
 /* mpool.c */
 typedef struct MPool MPool;
 extern MPool *mpool_create(MemoryContext parent,
@@ -280,6 +322,12 @@ extern uint64 mpool_bytes_used(MPool *mpool);
 #define ALLOCSET_SMALL_INITSIZE  (1 * 1024)
 #define ALLOCSET_SMALL_MAXSIZE	 (8 * 1024)
 
+/*
+ * Recommended default block sizes for Slab contexts (slab.c).
+ */
+#define SLAB_DEFAULT_BLOCK_SIZE		(8 * 1024)
+#define SLAB_LARGE_BLOCK_SIZE		(8 * 1024 * 1024)
+
 /*
  * Threshold above which a request in an AllocSet context is certain to be
  * allocated separately (and thereby have constant allocation overhead).
@@ -37,6 +37,7 @@ extern int	MaxResourceQueues;
 extern int	MaxResourcePortalsPerXact;
 extern bool	ResourceSelectOnly;
 extern bool	ResourceCleanupIdleGangs;
+extern int	gp_resqueue_wait_warning_time;
 
 extern Oid MyQueueId; /* resource queue for current role. */
 
@@ -71,6 +72,30 @@ typedef struct ResLimitData
 typedef ResLimitData	*ResLimit;
 
 
+/*
+ * Per-queue admission and wait statistics, updated under ResQueueLock and
+ * exposed by gp_resqueue_stats().
+ *
+ * The wait-time histogram buckets are in microseconds; each bucket covers
+ * 4x the previous one, starting below 1ms, so with 8 buckets the last is
+ * a catch-all for waits of 4 seconds and more.
+ */
+#define RES_QUEUE_WAIT_NBUCKETS			8
+
+typedef struct ResQueueStatsData
+{
+	uint64			admitted;			/* granted without waiting */
+	uint64			admitted_after_wait;	/* granted after queuing */
+	uint64			rejected;			/* over threshold, no overcommit */
+	uint64			ignored;			/* cost below ignorecostlimit */
+	uint64			wait_canceled;		/* waits ended by abort or deadlock */
+	uint64			wait_total_us;		/* total time spent queued */
+	uint64			wait_max_us;		/* longest single wait */
+	uint64			wait_hist[RES_QUEUE_WAIT_NBUCKETS];
+	int				nwaiters;			/* current queue depth */
+	int				nwaiters_max;		/* high-water queue depth */
+} ResQueueStatsData;
+
 /* Resource Queues */
 typedef struct ResQueueData
 {
@@ -79,6 +104,7 @@ typedef struct ResQueueData
 	bool			overcommit;			/* Does queue allow overcommit? */
 	float4			ignorecostlimit;	/* Ignore queries with cost less than.*/
 	ResLimitData	limits[NUM_RES_LIMIT_TYPES];	/* The limits */
+	ResQueueStatsData stats;			/* admission and wait statistics */
 } ResQueueData;
 typedef ResQueueData	*ResQueue;
 
@@ -148,6 +174,7 @@ extern bool 			ResQueueHashTableInit(void);
 extern ResQueue			ResQueueHashNew(Oid queueid);
 extern ResQueue			ResQueueHashFind(Oid queueid);
 extern bool				ResQueueHashRemove(Oid queueid);
+extern void				ResQueueWaitStatsEndWait(bool granted);
 
 
 /*
@@ -262,7 +262,9 @@ Cache *Cache_Create(CacheCtl *cacheCtl);
 Size Cache_SharedMemSize(uint32 nEntries, uint32 cacheEntrySize);
 void Cache_Free(Cache *cache);
 void Cache_Insert(Cache *cache, CacheEntry *entry);
+CacheEntry *Cache_Lookup(Cache *cache, const void *key);
 void Cache_Remove(Cache *cache, CacheEntry *entry);
+bool Cache_TryRemove(Cache *cache, CacheEntry *entry);
 void Cache_Release(Cache *cache, CacheEntry *entry);
 CacheEntry *Cache_AcquireEntry(Cache *cache, void *populate_param);
 bool Cache_IsCached(CacheEntry *entry);
@@ -68,6 +68,16 @@ typedef struct SnapshotData
 
 	bool		haveDistribSnapshot; /* True if this snapshot is distributed. */
 
+	/*
+	 * Cache-validity information maintained by GetSnapshotData() for the
+	 * static snapshots that are refilled over and over: the proc array
+	 * change counter observed when the local fields above were last filled
+	 * (0 if they are not reusable), and the global xmin computed from the
+	 * proc array scan at that time.  See GetSnapshotData().
+	 */
+	uint64		procArrayStateCount;
+	TransactionId procArrayGlobalXmin;
+
 	/*
 	 * GP: Global information about which transactions are visible for a
 	 * distributed transaction, with cached local xids
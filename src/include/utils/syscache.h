@@ -98,6 +98,10 @@ extern void InitCatalogCachePhase2(void);
 
 extern HeapTuple SearchSysCache(int cacheId,
 			   Datum key1, Datum key2, Datum key3, Datum key4);
+extern void SearchSysCacheBatch(int cacheId, int nitems,
+					const Datum *key1, const Datum *key2,
+					const Datum *key3, const Datum *key4,
+					HeapTuple *tuples);
 extern void ReleaseSysCache(HeapTuple tuple);
 
 /* convenience routines */
@@ -53,6 +53,15 @@ typedef struct MKEntry
      */
     Datum d;
 
+    /**
+     * Abbreviated key for this entry at its current level, valid only when
+     * the level's useAbbrev flag is set.  Encoded so that an unsigned
+     * integer compare agrees with the authoritative comparator whenever the
+     * abbreviations differ; equal abbreviations mean "don't know", and the
+     * comparison falls back to the full comparator.
+     */
+    uint64 abbrev;
+
     /**
      * Ptr to the tuple that contains this entry's key.  Is a void * to provide polymorphism: it could be a memtuple, heaptuple, or really anything that has multi-key behavior!
      *   Deciphering of this field is done by the functions that are passed when the multi-key heap is prepared
@@ -145,9 +154,10 @@ static inline void mke_set_lv(MKEntry *e, int32 lv)
 
 static inline void mke_set_empty(MKEntry *e)
 {
-    e->compflags = MKE_CF_Empty; 
+    e->compflags = MKE_CF_Empty;
     e->flags = 0;
 	e->d = 0;
+	e->abbrev = 0;
 	e->ptr = 0;
 }
 static inline bool mke_is_empty(MKEntry *e)
@@ -234,6 +244,9 @@ typedef struct MKLvContext
     /* type of datums in this level, converted to our MKLvType enumeration */
     MKLvType lvtype;
 
+    /* does tupsort_prepare fill in MKEntry.abbrev for this level? */
+    bool useAbbrev;
+
 	ScanKeyData	scanKey;
 
     int16 attno;
@@ -297,6 +310,13 @@ typedef struct MKContext {
 
 	/* Name of the index we're building, if any. Used for error messages. */
 	char	   *indexname;
+
+	/*
+	 * True while worker threads are sorting partitions of the entry array.
+	 * The qsort kernel must not touch the interrupt machinery from a
+	 * thread; checks are deferred until the threads are joined.
+	 */
+	bool inThreadedSort;
 } MKContext;
 
 /**
@@ -327,6 +347,7 @@ extern void create_mksort_context(
 
 /* MK quicksort stuff */
 extern void mk_qsort_impl(MKEntry *a, int left, int right, int lv, bool lvdown, MKContext *ctxt, bool seenNull);
+extern bool mk_radix_sort(MKEntry *a, int n, MKContext *ctxt);
 static inline void mk_qsort(MKEntry* a, int n, MKContext *ctxt)
 {
     mk_qsort_impl(a, 0, n-1, 0, true, ctxt, false);
@@ -374,6 +395,15 @@ typedef struct MKHeap
 
     /* the readers themselves -- see nreader field */
     MKHeapReader *readers;
+
+    /*
+     * When non-NULL, this reader-backed heap is driven by a loser tree
+     * instead of the sift-down heap: p holds one current entry per reader
+     * (leaf i belongs to reader i) and lsnodes holds the tree, with
+     * lsnodes[0] naming the winning reader.  See mkls_* in
+     * tuplesort_mkheap.c.
+     */
+    int *lsnodes;
 } MKHeap;
 
 
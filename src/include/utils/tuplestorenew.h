@@ -28,6 +28,9 @@ void ntuplestore_setinstrument(NTupleStore* ts, struct Instrumentation *ins);
 extern NTupleStore *ntuplestore_create(int64 maxBytes);
 extern NTupleStore *ntuplestore_create_readerwriter(const char* filename, int64 maxBytes, bool isWriter);
 extern NTupleStore *ntuplestore_create_workset(workfile_set *workSet, int64 maxBytes);
+extern NTupleStore *ntuplestore_create_workset_reader(workfile_set *workSet, int64 maxBytes);
+extern void ntuplestore_workset_complete(NTupleStore *ts);
+extern void ntuplestore_set_needed_columns(NTupleStore *ts, Bitmapset *needed_cols);
 extern bool ntuplestore_is_readerwriter_reader(NTupleStore* nts);
 extern void ntuplestore_flush(NTupleStore *ts);
 extern void ntuplestore_destroy(NTupleStore *ts);
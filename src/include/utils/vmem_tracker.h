@@ -39,6 +39,7 @@ typedef enum MemoryAllocationStatus
 typedef int64 EventVersion;
 
 extern int runaway_detector_activation_percent;
+extern int runaway_detector_prespill_percent;
 
 extern int32 VmemTracker_ConvertVmemChunksToMB(int chunks);
 extern int32 VmemTracker_ConvertVmemMBToChunks(int mb);
@@ -61,6 +62,7 @@ extern void VmemTracker_Shutdown(void);
 extern void VmemTracker_ResetMaxVmemReserved(void);
 extern MemoryAllocationStatus VmemTracker_ReserveVmem(int64 newly_requested);
 extern void VmemTracker_ReleaseVmem(int64 to_be_freed_requested);
+extern void VmemTracker_ReturnLease(void);
 extern void VmemTracker_RequestWaiver(int64 waiver_bytes);
 extern void VmemTracker_ResetWaiver(void);
 extern int64 VmemTracker_Fault(int32 reason, int64 arg);
@@ -68,6 +70,9 @@ extern int64 VmemTracker_Fault(int32 reason, int64 arg);
 extern int32 RedZoneHandler_GetRedZoneLimitChunks(void);
 extern int32 RedZoneHandler_GetRedZoneLimitMB(void);
 extern bool RedZoneHandler_IsVmemRedZone(void);
+extern bool RedZoneHandler_IsVmemSpillZone(void);
+extern uint32 RedZoneHandler_GetPreSpillRequestCount(void);
+extern bool RedZoneHandler_PreSpillRequested(uint32 *lastServedRequestCount);
 extern void RedZoneHandler_DetectRunawaySession(void);
 extern void RunawayCleaner_RunawayCleanupDoneForSession(void);
 extern void RunawayCleaner_RunawayCleanupDoneForProcess(bool ignoredCleanup);
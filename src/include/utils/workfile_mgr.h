@@ -39,6 +39,9 @@
 #define WORKFILE_NUM_TUPLESTORE_DATA 1
 #define WORKFILE_NUM_TUPLESTORE_LOB 2
 
+/* Maximum number of relations a reusable workfile set can depend on */
+#define WORKFILE_SET_MAX_REUSE_RELS 8
+
 typedef struct
 {
 	/* type of workfiles used by this operator */
@@ -90,6 +93,16 @@ typedef struct workfile_set
 	/* Operator-specific metadata */
 	workfile_set_op_metadata metadata;
 
+	/* Set to publish this set for cross-query reuse once it is complete */
+	bool reusable;
+
+	/* Set once the complete result has been written and flushed to disk */
+	bool complete;
+
+	/* Relations a reusable result depends on, used for invalidation */
+	int n_reuse_rels;
+	Oid reuse_rels[WORKFILE_SET_MAX_REUSE_RELS];
+
   /*
    * To make sure we don't leak workfile_set handles on abort, we keep them in
    * a linked list. We use the ResourceOwner mechanism to free them on abort.
@@ -131,6 +144,9 @@ typedef struct QueryspaceDesc
 workfile_set *workfile_mgr_create_set(enum ExecWorkFileType type, bool can_be_reused,
 		PlanState *ps);
 void workfile_mgr_close_set(workfile_set *work_set);
+void workfile_mgr_mark_reusable(workfile_set *work_set, PlanState *ps);
+void workfile_mgr_mark_complete(workfile_set *work_set);
+workfile_set *workfile_mgr_attach_set(enum ExecWorkFileType type, PlanState *ps);
 void workfile_mgr_cleanup(void);
 Size workfile_mgr_shmem_size(void);
 void workfile_mgr_cache_init(void);
@@ -140,6 +156,7 @@ void workfile_set_update_in_progress_size(workfile_set *work_set, int64 size);
 /* Workfile File operations */
 ExecWorkFile *workfile_mgr_create_file(workfile_set *work_set);
 ExecWorkFile *workfile_mgr_create_fileno(workfile_set *work_set, uint32 file_no);
+ExecWorkFile *workfile_mgr_open_fileno(workfile_set *work_set, uint32 file_no);
 int64 workfile_mgr_close_file(workfile_set *work_set, ExecWorkFile *file);
 
 /* Workfile diskspace operations */
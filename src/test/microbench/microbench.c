@@ -0,0 +1,382 @@
+/*-------------------------------------------------------------------------
+ *
+ * microbench.c
+ *    In-tree microbenchmark driver for hot backend kernels.
+ *
+ * Exercises a handful of per-tuple kernels in isolation, from inside a
+ * regular backend so the real code paths (fmgr, memory contexts, GUCs)
+ * are in effect:
+ *
+ *    cdbhash     - distribution hashing (cdbhash.c)
+ *    tupser      - motion tuple serialization (tupser.c)
+ *    tuplematch  - grouping tuple comparison (execGrouping.c)
+ *    aset        - palloc/pfree in an AllocSet (aset.c)
+ *    mksort      - in-memory sort, mk_qsort when gp_enable_mk_sort is on
+ *
+ * Each kernel reports wall time from the monotonic clock and raw cycles
+ * from the TSC (zero on platforms without one; see instrument.h).  The
+ * smoke test in sql/ runs tiny iteration counts; for real measurements
+ * use a large count and dump the rows with COPY ... CSV.
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "catalog/pg_operator.h"
+#include "catalog/pg_type.h"
+#include "cdb/cdbhash.h"
+#include "cdb/cdbmotion.h"
+#include "cdb/cdbvars.h"
+#include "cdb/tupchunklist.h"
+#include "cdb/tupser.h"
+#include "executor/executor.h"
+#include "executor/instrument.h"
+#include "funcapi.h"
+#include "utils/builtins.h"
+#include "utils/memutils.h"
+#include "utils/tuplesort.h"
+
+#ifdef PG_MODULE_MAGIC
+PG_MODULE_MAGIC;
+#endif
+
+Datum		microbench(PG_FUNCTION_ARGS);
+
+PG_FUNCTION_INFO_V1(microbench);
+
+/* Accumulator that keeps the compiler from discarding kernel results. */
+static volatile uint64 microbench_sink = 0;
+
+/* Timer covering both the wall clock and the cycle counter. */
+typedef struct BenchTimer
+{
+	instr_time	wall;
+	uint64		tsc;
+} BenchTimer;
+
+typedef struct BenchResult
+{
+	const char *kernel;
+	int64		iters;
+	double		seconds;
+	uint64		cycles;
+} BenchResult;
+
+static void
+bench_start(BenchTimer *t)
+{
+	INSTR_TIME_SET_CURRENT(t->wall);
+	t->tsc = instr_read_tsc();
+}
+
+static void
+bench_stop(BenchTimer *t, BenchResult *r)
+{
+	instr_time	endtime;
+
+	r->cycles = instr_read_tsc() - t->tsc;
+	INSTR_TIME_SET_CURRENT(endtime);
+	INSTR_TIME_SUBTRACT(endtime, t->wall);
+	r->seconds = INSTR_TIME_GET_DOUBLE(endtime);
+}
+
+/*
+ * A synthetic (int4, int8, text) row shared by the tuple-shaped kernels,
+ * so their numbers stay comparable across kernels and across runs.
+ */
+static TupleDesc
+bench_tupdesc(void)
+{
+	TupleDesc	tupdesc = CreateTemplateTupleDesc(3, false);
+
+	TupleDescInitEntry(tupdesc, (AttrNumber) 1, "a", INT4OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 2, "b", INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 3, "c", TEXTOID, -1, 0);
+
+	return tupdesc;
+}
+
+static HeapTuple
+bench_tuple(TupleDesc tupdesc, int32 seed)
+{
+	Datum		values[3];
+	bool		nulls[3] = {false, false, false};
+
+	values[0] = Int32GetDatum(seed);
+	values[1] = Int64GetDatum((int64) seed * 104729);
+	values[2] = CStringGetTextDatum("the quick brown fox jumps over the lazy dog");
+
+	return heap_form_tuple(tupdesc, values, nulls);
+}
+
+/*
+ * cdbhash: hash one int4 and one text datum and reduce, per iteration --
+ * the per-row work of computing a tuple's target segment.
+ */
+static void
+bench_cdbhash(int64 iters, BenchResult *r)
+{
+	CdbHash    *h = makeCdbHash(64);
+	Datum		tdatum = CStringGetTextDatum("the quick brown fox jumps over the lazy dog");
+	BenchTimer	t;
+	int64		i;
+
+	bench_start(&t);
+	for (i = 0; i < iters; i++)
+	{
+		cdbhashinit(h);
+		cdbhash(h, Int32GetDatum((int32) i), INT4OID);
+		cdbhash(h, tdatum, TEXTOID);
+		microbench_sink += cdbhashreduce(h);
+	}
+	bench_stop(&t, r);
+}
+
+/*
+ * tupser: serialize one heap tuple into motion chunks per iteration.
+ */
+static void
+bench_tupser(int64 iters, BenchResult *r)
+{
+	TupleDesc	tupdesc = bench_tupdesc();
+	HeapTuple	tuple = bench_tuple(tupdesc, 42);
+	SerTupInfo	info;
+	TupleChunkListData tclist;
+	BenchTimer	t;
+	int64		i;
+
+	/* the motion layer sets this at IPC setup; cover utility mode too */
+	if (Gp_max_tuple_chunk_size <= 0)
+		Gp_max_tuple_chunk_size = 8192;
+
+	InitSerTupInfo(tupdesc, &info);
+	MemSet(&tclist, 0, sizeof(tclist));
+
+	bench_start(&t);
+	for (i = 0; i < iters; i++)
+	{
+		SerializeTupleIntoChunks((GenericTuple) tuple, &info, &tclist);
+		microbench_sink += tclist.serialized_data_length;
+		clearTCList(&info.chunkCache, &tclist);
+	}
+	bench_stop(&t, r);
+
+	CleanupSerTupInfo(&info);
+}
+
+/*
+ * tuplematch: compare two equal rows on all three columns per iteration --
+ * the worst-case (all columns visited) grouping comparison.
+ */
+static void
+bench_tuplematch(int64 iters, BenchResult *r)
+{
+	TupleDesc	tupdesc = bench_tupdesc();
+	TupleTableSlot *slot1 = MakeSingleTupleTableSlot(tupdesc);
+	TupleTableSlot *slot2 = MakeSingleTupleTableSlot(tupdesc);
+	AttrNumber	cols[3] = {1, 2, 3};
+	Oid			eqops[3] = {Int4EqualOperator, Int8EqualOperator, TextEqualOperator};
+	FmgrInfo   *eqfns;
+	MemoryContext evalctx;
+	BenchTimer	t;
+	int64		i;
+
+	ExecStoreHeapTuple(bench_tuple(tupdesc, 42), slot1, InvalidBuffer, false);
+	ExecStoreHeapTuple(bench_tuple(tupdesc, 42), slot2, InvalidBuffer, false);
+
+	eqfns = execTuplesMatchPrepare(3, eqops);
+	evalctx = AllocSetContextCreate(CurrentMemoryContext,
+									"microbench match context",
+									ALLOCSET_DEFAULT_MINSIZE,
+									ALLOCSET_DEFAULT_INITSIZE,
+									ALLOCSET_DEFAULT_MAXSIZE);
+
+	bench_start(&t);
+	for (i = 0; i < iters; i++)
+		microbench_sink += execTuplesMatch(slot1, slot2, 3, cols,
+										   eqfns, evalctx);
+	bench_stop(&t, r);
+
+	ExecDropSingleTupleTableSlot(slot1);
+	ExecDropSingleTupleTableSlot(slot2);
+	MemoryContextDelete(evalctx);
+}
+
+/*
+ * aset: one palloc per iteration over a mixed size distribution, freed
+ * in batches through a small ring, so both the freelist and the block
+ * allocation paths are visited.
+ */
+static void
+bench_aset(int64 iters, BenchResult *r)
+{
+	static const Size sizes[8] = {16, 24, 40, 64, 128, 300, 1024, 8192};
+	MemoryContext ctx;
+	void	   *ring[64];
+	int			n = 0;
+	BenchTimer	t;
+	int64		i;
+
+	ctx = AllocSetContextCreate(CurrentMemoryContext,
+								"microbench aset context",
+								ALLOCSET_DEFAULT_MINSIZE,
+								ALLOCSET_DEFAULT_INITSIZE,
+								ALLOCSET_DEFAULT_MAXSIZE);
+
+	bench_start(&t);
+	for (i = 0; i < iters; i++)
+	{
+		ring[n++] = MemoryContextAlloc(ctx, sizes[i & 7]);
+		if (n == lengthof(ring))
+		{
+			while (n > 0)
+				pfree(ring[--n]);
+		}
+	}
+	bench_stop(&t, r);
+
+	MemoryContextDelete(ctx);
+}
+
+/*
+ * mksort: in-memory sort of 'iters' single-column rows in pseudo-random
+ * order.  Goes through the tuplesort switcheroo, so with the default
+ * gp_enable_mk_sort=on this measures mk_qsort comparisons; per-op numbers
+ * include the O(log n) factor and the puttuple path.
+ */
+static void
+bench_mksort(int64 iters, BenchResult *r)
+{
+	TupleDesc	tupdesc = CreateTemplateTupleDesc(1, false);
+	TupleTableSlot *slot;
+	AttrNumber	attnums[1] = {1};
+	Oid			sortops[1] = {Int4LessOperator};
+	bool		nullsfirst[1] = {false};
+	Tuplesortstate *state;
+	uint32		lcg = 1;
+	BenchTimer	t;
+	int64		i;
+
+	TupleDescInitEntry(tupdesc, (AttrNumber) 1, "a", INT4OID, -1, 0);
+	slot = MakeSingleTupleTableSlot(tupdesc);
+
+	state = tuplesort_begin_heap(NULL, tupdesc, 1, attnums,
+								 sortops, nullsfirst,
+								 64 * 1024 /* kB */ , false);
+
+	bench_start(&t);
+	for (i = 0; i < iters; i++)
+	{
+		Datum		values[1];
+		bool		nulls[1] = {false};
+
+		lcg = lcg * 1103515245 + 12345;
+		values[0] = Int32GetDatum((int32) lcg);
+		ExecStoreHeapTuple(heap_form_tuple(tupdesc, values, nulls),
+						   slot, InvalidBuffer, true);
+		tuplesort_puttupleslot(state, slot);
+	}
+	tuplesort_performsort(state);
+	bench_stop(&t, r);
+
+	tuplesort_end(state);
+	ExecDropSingleTupleTableSlot(slot);
+}
+
+typedef void (*bench_fn) (int64 iters, BenchResult *r);
+
+static const struct
+{
+	const char *name;
+	bench_fn	fn;
+}			bench_kernels[] =
+
+{
+	{"aset", bench_aset},
+	{"cdbhash", bench_cdbhash},
+	{"mksort", bench_mksort},
+	{"tuplematch", bench_tuplematch},
+	{"tupser", bench_tupser},
+};
+
+/*
+ * microbench(kernel, iterations) - run one kernel, or all of them for
+ * kernel = 'all', and return one result row per kernel run.
+ */
+Datum
+microbench(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+	BenchResult *results;
+
+	if (SRF_IS_FIRSTCALL())
+	{
+		char	   *kernel = text_to_cstring(PG_GETARG_TEXT_P(0));
+		int64		iters = PG_GETARG_INT64(1);
+		TupleDesc	tupdesc;
+		MemoryContext oldcontext;
+		bool		matched = false;
+		int			nresults = 0;
+		int			i;
+
+		if (iters <= 0)
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("iteration count must be positive")));
+
+		funcctx = SRF_FIRSTCALL_INIT();
+		oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+		if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+			elog(ERROR, "return type must be a row type");
+		funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+
+		results = (BenchResult *)
+			palloc0(lengthof(bench_kernels) * sizeof(BenchResult));
+
+		for (i = 0; i < lengthof(bench_kernels); i++)
+		{
+			if (strcmp(kernel, "all") != 0 &&
+				strcmp(kernel, bench_kernels[i].name) != 0)
+				continue;
+			matched = true;
+
+			results[nresults].kernel = bench_kernels[i].name;
+			results[nresults].iters = iters;
+			bench_kernels[i].fn(iters, &results[nresults]);
+			nresults++;
+		}
+
+		if (!matched)
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("unknown microbench kernel \"%s\"", kernel)));
+
+		funcctx->user_fctx = (void *) results;
+		funcctx->max_calls = nresults;
+
+		MemoryContextSwitchTo(oldcontext);
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+	results = (BenchResult *) funcctx->user_fctx;
+
+	if (funcctx->call_cntr < funcctx->max_calls)
+	{
+		BenchResult *res = &results[funcctx->call_cntr];
+		Datum		values[5];
+		bool		nulls[5] = {false, false, false, false, false};
+		HeapTuple	tuple;
+
+		values[0] = CStringGetTextDatum(res->kernel);
+		values[1] = Int64GetDatum(res->iters);
+		values[2] = Float8GetDatum(res->seconds * 1000.0);
+		values[3] = Float8GetDatum(res->seconds * 1e9 / res->iters);
+		values[4] = Float8GetDatum((double) res->cycles / res->iters);
+
+		tuple = heap_form_tuple(funcctx->tuple_desc, values, nulls);
+		SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+	}
+
+	SRF_RETURN_DONE(funcctx);
+}
@@ -0,0 +1,11 @@
+-- Smoke-run every kernel with a small iteration count.  Timings are
+-- nondeterministic, so only the identifying columns are projected; for
+-- real measurements run something like
+--   copy (select * from microbench('all', 1000000)) to stdout with csv;
+select kernel_name, iters from microbench('all', 1000) order by kernel_name;
+
+-- A single kernel can be requested by name.
+select kernel_name, iters from microbench('cdbhash', 1000);
+
+-- Unknown kernels are rejected.
+select kernel_name, iters from microbench('nosuchkernel', 1000);
@@ -0,0 +1,94 @@
+#! /usr/bin/env python
+
+'''
+Compare the timings of a performance schedule run against the recorded
+baseline for this host profile, append the run to the trend file, and
+fail if any test regressed by more than the allowed relative deviation.
+
+usage: check_perf_regression.py [--record] <results_file> <baseline_dir>
+                                <profile> <threshold> <trend_file>
+
+Baselines live in <baseline_dir>/<profile>.baseline as "test|seconds"
+lines, one per test; they are host-profile specific and are (re)written
+from the current run with --record.  The trend file accumulates one
+"timestamp|profile|test|seconds|baseline|deviation" line per test per
+run, for plotting timings over time.
+'''
+import os
+import re
+import sys
+import time
+
+args = sys.argv[1:]
+record = False
+if args and args[0] == '--record':
+    record = True
+    del args[0]
+if len(args) != 5:
+    sys.stderr.write(__doc__)
+    sys.exit(2)
+
+results_file, baseline_dir, profile, threshold, trend_file = args
+threshold = float(threshold)
+baseline_path = os.path.join(baseline_dir, profile + '.baseline')
+
+## Pull "test <name> ... ok (N.NN sec)" timings out of the pg_regress output
+timings = []
+with open(results_file, 'r') as results:
+    for line in results:
+        m = re.match(r'(?:test )?\s*(\w+)\s+\.\.\. ok \((\d+\.\d+) sec\)', line)
+        if m and m.group(1) != 'setup':
+            timings.append((m.group(1), float(m.group(2))))
+
+if not timings:
+    sys.stderr.write('no test timings found in %s\n' % results_file)
+    sys.exit(2)
+
+if record:
+    if not os.path.isdir(baseline_dir):
+        os.makedirs(baseline_dir)
+    with open(baseline_path, 'w') as baseline_write:
+        for name, seconds in timings:
+            baseline_write.write('%s|%.2f\n' % (name, seconds))
+    print('recorded baseline for profile "%s" (%d tests) in %s'
+          % (profile, len(timings), baseline_path))
+    sys.exit(0)
+
+if not os.path.exists(baseline_path):
+    sys.stderr.write('no baseline for profile "%s"; record one first with\n'
+                     '  make perf-query-baseline PERF_PROFILE=%s\n'
+                     % (profile, profile))
+    sys.exit(2)
+
+baseline = {}
+with open(baseline_path, 'r') as baseline_read:
+    for line in baseline_read:
+        name, seconds = line.strip().split('|')
+        baseline[name] = float(seconds)
+
+## Append this run to the trend file and report per-test deviations
+timestamp = time.strftime('%Y-%m-%d %H:%M:%S')
+regressed = []
+with open(trend_file, 'a') as trend:
+    for name, seconds in timings:
+        base = baseline.get(name)
+        if base is None:
+            print('%-20s %8.2f sec  (no baseline)' % (name, seconds))
+            trend.write('%s|%s|%s|%.2f||\n' % (timestamp, profile, name, seconds))
+            continue
+        deviation = (seconds - base) / base if base > 0 else 0.0
+        verdict = 'ok'
+        if deviation > threshold:
+            verdict = 'REGRESSED'
+            regressed.append(name)
+        elif deviation < -threshold:
+            verdict = 'improved (consider re-recording the baseline)'
+        print('%-20s %8.2f sec  baseline %8.2f  %+6.1f%%  %s'
+              % (name, seconds, base, 100.0 * deviation, verdict))
+        trend.write('%s|%s|%s|%.2f|%.2f|%+.3f\n'
+                    % (timestamp, profile, name, seconds, base, deviation))
+
+if regressed:
+    sys.stderr.write('%d test(s) exceeded the %.0f%% threshold: %s\n'
+                     % (len(regressed), 100.0 * threshold, ', '.join(regressed)))
+    sys.exit(1)
@@ -7,12 +7,9 @@ if [ -d $MASTER_DATA_DIRECTORY/perfdataset ]; then
 fi
 mkdir $MASTER_DATA_DIRECTORY/perfdataset
 
-# Generate dataset
-# TODO: this is very slow to generate big datasets (e.g. 500 million
-# rows)... need to replace with something much faster
-for i in $(seq ${1}); do
-  cat dataset/perfdata.csv >> $MASTER_DATA_DIRECTORY/perfdataset/perfdata.csv;
-done
+# Generate dataset deterministically (100 rows per "copy", matching the
+# size of the hand-made sample in dataset/)
+python ./gen_perfdata.py $((${1} * 100)) $MASTER_DATA_DIRECTORY/perfdataset/perfdata.csv
 
 # Kill gpfdist processes and host the dataset
 killall gpfdist
@@ -22,3 +19,7 @@ gpfdist -p $2 -d $MASTER_DATA_DIRECTORY/perfdataset -l $MASTER_DATA_DIRECTORY/pe
 # Update sql and ans file with hostname and gpfdist port
 cat ./sql/setup.sql.template | sed "s/@hostname@:@gpfdist_port@/${HOSTNAME}:${2}/" > ./sql/setup.sql
 cat ./expected/setup.out.template | sed "s/@hostname@:@gpfdist_port@/${HOSTNAME}:${2}/" > ./expected/setup.out
+
+# Update the COPY test with the path of the generated dataset
+cat ./sql/copy_heap.sql.template | sed "s|@perfdata_dir@|${MASTER_DATA_DIRECTORY}/perfdataset|" > ./sql/copy_heap.sql
+cat ./expected/copy_heap.out.template | sed "s|@perfdata_dir@|${MASTER_DATA_DIRECTORY}/perfdataset|" > ./expected/copy_heap.out
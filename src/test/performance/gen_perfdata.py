@@ -0,0 +1,46 @@
+#! /usr/bin/env python
+
+'''
+Generate a deterministic perfdata dataset of a given number of rows.
+
+The rows follow the same 13 column layout as dataset/perfdata.csv (the
+hand-made 100 row sample) so the same table definitions work, but the
+generator is fast enough for the hundreds of millions of rows a real
+load benchmark needs, and two runs with the same row count produce
+byte-identical files.
+'''
+import sys
+
+if len(sys.argv) != 3:
+    sys.stderr.write('usage: gen_perfdata.py <num_rows> <output_file>\n')
+    sys.exit(1)
+
+num_rows = int(sys.argv[1])
+out_path = sys.argv[2]
+
+ARRAY_COL = '{' + ','.join(['1234567890.12'] * 50) + '}'
+A_COL = 'A' * 100
+B_COL = 'B' * 100
+FLUSH_EVERY = 10000
+
+with open(out_path, 'w') as out:
+    buf = []
+    for n in range(num_rows):
+        buf.append('|'.join([str(n),
+                             str(n + 1),
+                             str(n + 2),
+                             '1996-07-08',
+                             'abcdefghij',
+                             A_COL,
+                             str(n + 3),
+                             B_COL,
+                             str(n + 4),
+                             '%d.00' % ((n % 9999) + 1),
+                             str(n + 6),
+                             str(n + 7),
+                             ARRAY_COL]))
+        if len(buf) == FLUSH_EVERY:
+            out.write('\n'.join(buf) + '\n')
+            buf = []
+    if buf:
+        out.write('\n'.join(buf) + '\n')
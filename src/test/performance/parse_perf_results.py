@@ -9,10 +9,24 @@ import re
 
 results_file = sys.argv[1]
 num_copies = sys.argv[2]
+dataset_bytes = int(sys.argv[3]) if len(sys.argv) > 3 else 0
 
 ## Get number of rows
 num_rows = 100 * int(num_copies)
 
+
+def result_row(counter, name, rows, duration):
+    '''Format one result line, deriving rows/s and (when the dataset byte
+    size was passed in) MB/s from the duration.'''
+    duration = float(duration)
+    fields = [str(counter), name, str(rows), str(duration)]
+    if duration > 0:
+        fields.append('%.0f' % (rows / duration))
+        if dataset_bytes:
+            test_bytes = float(dataset_bytes) * rows / num_rows
+            fields.append('%.1f' % (test_bytes / duration / (1024 * 1024)))
+    return '|'.join(fields)
+
 ## Open the perf results file
 with open(results_file, 'r') as perf_results:
     perf_results_lines = perf_results.readlines()
@@ -30,7 +44,7 @@ parallel_group_duration = 0.0
 for line in perf_results_lines:
     if 'test ' in line:
         m = re.match(r'test (\w+)\s+... \w+ \((\d+.\d+) sec\)', line)
-        rows.append('|'.join([str(counter), m.group(1), str(num_rows), m.group(2)]))
+        rows.append(result_row(counter, m.group(1), num_rows, m.group(2)))
         counter += 1
     elif 'parallel group ' in line:
         m = re.match(r'parallel group \((\d+)\s', line)
@@ -43,7 +57,7 @@ for line in perf_results_lines:
             parallel_group_duration = float(m.group(2))
 
         if parallel_group_tests == 1:
-            rows.append('|'.join([str(counter), 'parallel_' + m.group(1), str(parallel_group_num_rows), str(parallel_group_duration)]))
+            rows.append(result_row(counter, 'parallel_' + m.group(1), parallel_group_num_rows, parallel_group_duration))
             parallel_group_tests = 0
             parallel_group_num_rows = 0
             parallel_group_duration = 0.0
@@ -0,0 +1,4 @@
+--
+-- Load via an external scan from gpfdist (segments parse in parallel)
+--
+INSERT INTO external_gpfdist SELECT * FROM ext_base_table;
@@ -0,0 +1,8 @@
+--
+-- Hash aggregation into a fixed number of groups.  b covers every
+-- residue mod 13, so the group count is 13 for any NUM_COPIES >= 1.
+--
+SELECT count(*)
+FROM (SELECT b % 13 AS grp, sum(k) AS sk, avg(j) AS aj, max(l) AS ml
+      FROM base_table
+      GROUP BY 1) g;
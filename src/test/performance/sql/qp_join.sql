@@ -0,0 +1,9 @@
+--
+-- 1:1 self join on a non-distribution key (b = a + 1 in the generated
+-- data), forcing one side to be redistributed in full.  The residual
+-- qual can never hold (e is constant), so the result is independent of
+-- NUM_COPIES.
+--
+SELECT count(*)
+FROM base_table t1 JOIN base_table t2 ON t1.a = t2.b
+WHERE t1.e <> t2.e;
@@ -0,0 +1,8 @@
+--
+-- Full-volume redistribute motion: grouping on (b, c) hashes every row
+-- to its group's segment, and since (b, c) is unique in the generated
+-- data the HAVING clause removes every group, keeping the result
+-- independent of NUM_COPIES.
+--
+SELECT count(*)
+FROM (SELECT b, c FROM base_table GROUP BY b, c HAVING count(*) > 1) s;
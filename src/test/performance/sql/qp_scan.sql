@@ -0,0 +1,6 @@
+--
+-- Sequential scan with a selective filter.  No row matches, so the
+-- result is independent of NUM_COPIES while every tuple is still read
+-- and tested.
+--
+SELECT count(*) FROM base_table WHERE e = 'nomatch';
@@ -0,0 +1,8 @@
+--
+-- Full sort of the table: the window function requires its input in
+-- (j, i) order, and the impossible outer qual keeps the result
+-- independent of NUM_COPIES.
+--
+SELECT count(*)
+FROM (SELECT rank() OVER (ORDER BY j, i) AS r FROM base_table) s
+WHERE s.r < 0;